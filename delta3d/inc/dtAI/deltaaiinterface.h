@@ -25,64 +25,14 @@
 #include <dtAI/aiplugininterface.h>
 #include <dtAI/export.h>
 #include <dtAI/waypointgraphastar.h>
-#include <dtUtil/kdtree.h>
+#include <dtUtil/flatkdtree.h>
 
 namespace dtAI
 {
    //////////////////////////////////////////////////////////////////////////////////
    // This is the default AI plugin interface implementation
    //////////////////////////////////////////////////////////////////////////////////////////
-   struct KDHolder
-   {
-      typedef float value_type;
-
-      KDHolder(const osg::Vec3& pos)
-      {
-         d[0] = pos[0];
-         d[1] = pos[1];
-         d[2] = pos[2];
-      }
-
-      KDHolder(const osg::Vec3& pos, WaypointID id)
-      {
-         d[0] = pos[0];
-         d[1] = pos[1];
-         d[2] = pos[2];
-
-         mID = id;
-      }
-
-      KDHolder(value_type a, value_type b, value_type c)
-      {
-         d[0] = a;
-         d[1] = b;
-         d[2] = c;
-      }
-
-      KDHolder(const KDHolder& x)
-      {
-         d[0] = x.d[0];
-         d[1] = x.d[1];
-         d[2] = x.d[2];
-         mID = x.mID;
-      }
-
-      operator osg::Vec3()
-      {
-         return osg::Vec3(d[0], d[1], d[2]);
-      }
-
-      inline value_type operator[](size_t const N) const { return d[N]; }
-
-      WaypointID mID;
-      value_type d[3];
-   };
-
-   inline float KDHolderIndexFunc(KDHolder t, size_t k ) { return t[k]; }
-
-   typedef std::pointer_to_binary_function<KDHolder, size_t, float> tree_search_func;
-   typedef dtUtil::KDTree<3, KDHolder, tree_search_func> WaypointKDTree;
-   typedef std::pair<WaypointKDTree::const_iterator, float> find_result;
+   typedef dtUtil::FlatKDTree<WaypointInterface*> WaypointTree;
 
    class DT_AI_EXPORT DeltaAIInterface: public AIPluginInterface
    {
@@ -123,6 +73,20 @@ namespace dtAI
       WaypointInterface* GetClosestNamedWaypoint(const std::string& name, const osg::Vec3& pos, float maxRadius);
       bool GetWaypointsAtRadius(const osg::Vec3& pos, float radius, WaypointArray& arrayToFill);
 
+      /// Like GetClosestWaypoint, but only considers waypoints of the given type.
+      WaypointInterface* GetClosestWaypointOfType(const dtCore::ObjectType& type, const osg::Vec3& pos, float maxRadius);
+
+      /// Like GetWaypointsAtRadius, but only returns waypoints of the given type.
+      bool GetWaypointsOfTypeAtRadius(const dtCore::ObjectType& type, const osg::Vec3& pos, float radius, WaypointArray& arrayToFill);
+
+      /**
+       * Finds the closest waypoint to each of the positions in one pass, which is much faster than
+       * calling GetClosestWaypoint in a loop for large batches.
+       * @param arrayToFill gets one entry per position, NULL where nothing was in range.
+       * @return the number of positions that found a waypoint.
+       */
+      unsigned GetClosestWaypoints(const std::vector<osg::Vec3>& positions, float maxRadius, WaypointArray& arrayToFill);
+
    protected:
 
       virtual ~DeltaAIInterface();
@@ -137,8 +101,7 @@ namespace dtAI
       typedef std::vector< dtCore::RefPtr<dtAI::WaypointInterface> > WaypointRefArray;
       WaypointRefArray mWaypoints;
 
-      bool mKDTreeDirty;
-      WaypointKDTree* mKDTree;
+      WaypointTree mWaypointTree;
 
       std::string mLastFileLoaded;
    };
@@ -30,6 +30,7 @@
 
 #include <dtCore/transformable.h>
 #include <dtCore/transform.h>
+#include <dtGame/spatialindexcomponent.h>
 #include <osg/MatrixTransform>
 
 #include <dtUtil/typetraits.h>
@@ -141,6 +142,34 @@ namespace dtAI
       dtCore::Transformable::CoordSysEnum mFrameOfRef;
    };
 
+   /**
+    * Reads the position of an actor out of a dtGame::SpatialIndexComponent, which has already read
+    * the transforms once for the frame, rather than computing the absolute transform on every evaluation.
+    * The vector is left alone if the actor is not in the index.
+    */
+   template <typename VecType = osg::Vec3>
+   class EvaluateIndexedActorPosition
+   {
+   public:
+      EvaluateIndexedActorPosition(const dtGame::SpatialIndexComponent& spatialIndex, const dtCore::UniqueId& actorId)
+         : mSpatialIndex(&spatialIndex)
+         , mActorId(actorId)
+      {}
+
+      void operator()(VecType& vec)
+      {
+         osg::Vec3 pos;
+         if (mSpatialIndex->GetActorPosition(mActorId, pos))
+         {
+            vec = pos;
+         }
+      }
+
+   private:
+      dtCore::RefPtr<const dtGame::SpatialIndexComponent> mSpatialIndex;
+      dtCore::UniqueId mActorId;
+   };
+
    template <typename VecType = osg::Vec3>
    class EvaluateMatrixPosition
    {
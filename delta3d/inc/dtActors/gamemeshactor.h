@@ -48,6 +48,8 @@ namespace dtActors
     * that is intended to respond to message and have behavior, changes to its
     * geometry (damaged states, etc.) should happen to each instances. If you
     * want to share geometry for a static actor, check out StaticMeshActorProxy.
+    * The mesh can be loaded in the background, see the LoadAsynchronously property
+    * and dtCore::AsyncMeshLoader.
     * @see GameActorProxy
     * @see GameMeshActor
     * @see StaticMeshActorProxy
@@ -11,6 +11,8 @@
 #include <dtCore/gameevent.h>
 #include <osg/Geode>
 #include <osg/ShapeDrawable>
+#include <osg/NodeCallback>
+#include <dtCore/observerptr.h>
 
 namespace dtActors
 {
@@ -334,15 +336,98 @@ namespace dtActors
       */
       void SetPointColor(const osg::Vec4& color);
 
+      /**
+      * Enables static batching of the point geometry.  When enabled, the
+      * points are grouped into chunks and the geometry of each chunk is
+      * flattened and merged into as few drawables as the state allows.
+      * Batching is never applied inside STAGE so points remain pickable.
+      *
+      * @param[in]  enabled  True to batch the point geometry.
+      */
+      void SetBatchGeometry(bool enabled);
+      bool GetBatchGeometry() const { return mBatchGeometry; }
+
+      /**
+      * Sets the number of consecutive points that are merged into one batch.
+      * Editing a point only rebuilds the chunks that contain the changed points.
+      *
+      * @param[in]  size  The number of points per chunk, must be at least 1.
+      */
+      void SetBatchChunkSize(int size);
+      int GetBatchChunkSize() const { return mBatchChunkSize; }
+
+      /**
+      * @return true if batching is enabled and allowed in the current context.
+      */
+      bool IsBatching() const;
+
+      /**
+      * @return the number of batch chunks waiting to be rebuilt.
+      */
+      int GetDirtyBatchCount() const;
+
+      /**
+      * Rebuilds every dirty batch chunk.  This is called automatically
+      * during the update traversal but may be called directly to force
+      * the batches to be current, i.e. when no viewer is running.
+      */
+      void UpdateBatches();
+
+      /**
+      * @return the group holding the batched chunk geometry.
+      */
+      osg::Group* GetBatchRoot() { return mBatchRoot.get(); }
+
    protected:
       virtual ~LinkedPointsActor();
 
+      /**
+      * Flags the batch chunk holding the given point to be rebuilt.
+      * Subclasses that override Visualize(int) must call this.
+      *
+      * @param[in]  pointIndex  The point that changed.
+      */
+      void MarkBatchDirty(int pointIndex);
+
+      /**
+      * Flags every batch chunk from the given point to the end of the
+      * point list, used when points are inserted or removed.
+      *
+      * @param[in]  pointIndex  The first point that changed.
+      */
+      void MarkBatchDirtyFrom(int pointIndex);
+
       dtActors::LinkedPointsActorProxy* mProxy;
 
    private:
 
+      /**
+      * Rebuilds the merged geometry of a single chunk.
+      */
+      void RebuildBatchChunk(int chunkIndex);
+
+      /**
+      * Removes all batches and makes the individual points visible again.
+      */
+      void ClearBatches();
+
+      /**
+      * Removes the cull callbacks that hide the points drawn by a chunk.
+      */
+      void ShowBatchedPoints(unsigned chunkIndex);
+
       bool mVisualize;
       std::vector<dtCore::RefPtr<dtCore::Transformable> >  mPointList;
+
+      bool mBatchGeometry;
+      int mBatchChunkSize;
+      dtCore::RefPtr<osg::Group> mBatchRoot;
+      std::vector<dtCore::RefPtr<osg::Node> > mBatchChunks;
+      std::vector<bool> mBatchChunkDirty;
+
+      /// A point node and the cull callback hiding it while its chunk draws it.
+      typedef std::pair<dtCore::ObserverPtr<osg::Node>, dtCore::RefPtr<osg::NodeCallback> > HiddenPoint;
+      std::vector<std::vector<HiddenPoint> > mBatchHiddenPoints;
    };
 
    /////////////////////////////////////////////////////////////////////////////
@@ -24,6 +24,7 @@
 #include <dtCore/plugin_export.h>
 
 #include <dtGame/gameactor.h>
+#include <dtGame/spatialindexcomponent.h>
 #include <dtCore/observerptr.h>
 #include <dtCore/functor.h>
 
@@ -51,6 +52,13 @@ namespace dtActors
       void SetMaxTriggerCount(int maxTriggercount) { mMaxTriggerCount = maxTriggercount; }
       int GetMaxTriggerCount() const               { return mMaxTriggerCount; }
 
+      /**
+       * Half the size of the axis aligned box around the actor's translation that makes up the volume.
+       * Occupancy is computed by the dtGame::SpatialIndexComponent, so that must be in the GM for events to fire.
+       */
+      void SetHalfExtents(const osg::Vec3& halfExtents);
+      osg::Vec3 GetHalfExtents() const             { return mHalfExtents; }
+
       virtual void OnSystem(const dtUtil::RefString& str, double, double)
 ;
 
@@ -97,6 +105,16 @@ namespace dtActors
        */
       const std::set<dtCore::ObserverPtr<dtCore::Transformable> >& GetOccupants() const;
 
+      /// Registers this volume with the spatial index component, if the GM has one.
+      void RegisterWithSpatialIndex();
+
+      /// Removes this volume from the spatial index component.
+      void UnregisterFromSpatialIndex();
+
+      /// The callback from the spatial index component.
+      void OnVolumeEvent(const dtCore::UniqueId& volumeId, dtGame::GameActorProxy& actor,
+               dtGame::SpatialIndexComponent::VolumeEventType eventType);
+
    protected:
 
       virtual ~TriggerVolumeActor() {}
@@ -116,6 +134,9 @@ namespace dtActors
       int mMaxTriggerCount;
       int mTriggerCount;
 
+      osg::Vec3 mHalfExtents;
+      dtCore::ObserverPtr<dtGame::SpatialIndexComponent> mSpatialIndex;
+
       bool IsActorAnOccupant(dtCore::Transformable* actor);
 
       void TriggerEvent(dtCore::Transformable* instigator, TriggerEventType eventType);
@@ -29,6 +29,7 @@ namespace dtActors
    public:
       static const dtUtil::RefString CLASS_NAME;
       static const dtUtil::RefString PROPERTY_MAX_TRIGGER_COUNT;
+      static const dtUtil::RefString PROPERTY_HALF_EXTENTS;
 
       TriggerVolumeActorProxy();
 
@@ -40,6 +41,10 @@ namespace dtActors
 
       virtual dtCore::ActorProxyIcon* GetBillBoardIcon();
 
+      virtual void OnEnteredWorld();
+
+      virtual void OnRemovedFromWorld();
+
    protected:
 
       virtual ~TriggerVolumeActorProxy();
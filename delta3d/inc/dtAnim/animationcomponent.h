@@ -24,6 +24,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include <dtAnim/export.h>
 
@@ -32,7 +33,9 @@
 #include <dtGame/datacentricgmcomponent.h>
 
 #include <dtAnim/animationhelper.h>
+#include <dtAnim/sharedposecache.h>
 #include <dtUtil/threadpool.h>
+#include <osg/Vec3>
 
 
 namespace dtGame
@@ -58,6 +61,25 @@ public:
    ///The default component name, used when looking it up on the GM.
    static const std::string DEFAULT_NAME;
 
+   /**
+    * One tier of skeleton update rate.  Characters at least mDistance from the eye point actor
+    * have their skeletons evaluated every mUpdateInterval seconds, and interpolated in between.
+    */
+   struct SkeletonUpdateLOD
+   {
+      SkeletonUpdateLOD(float distance = 0.0f, float updateInterval = 0.0f)
+      : mDistance(distance)
+      , mUpdateInterval(updateInterval)
+      {
+      }
+
+      bool operator<(const SkeletonUpdateLOD& rhs) const { return mDistance < rhs.mDistance; }
+
+      float mDistance;
+      float mUpdateInterval;
+   };
+   typedef std::vector<SkeletonUpdateLOD> SkeletonUpdateLODVector;
+
    AnimationComponent(dtCore::SystemComponentType& type = *TYPE);
 
    /**
@@ -102,6 +124,25 @@ public:
    dtGame::BaseGroundClamper& GetGroundClamper();
    const dtGame::BaseGroundClamper& GetGroundClamper() const;
 
+   /**
+    * Turns on sharing evaluated skeleton poses between the registered characters.  Characters with the same
+    * model playing the same animations at nearly the same time then only pay for one skeleton evaluation.
+    * @see SharedPoseCache
+    */
+   void SetSharedPosesEnabled(bool enabled);
+   bool GetSharedPosesEnabled() const;
+
+   /// @return the cache used when shared poses are enabled, so its quantization can be tuned.
+   SharedPoseCache& GetSharedPoseCache();
+
+   /**
+    * Sets the tiers used to throttle skeleton updates by distance from the eye point actor.  Characters closer
+    * than the nearest tier update every frame.  Nothing is throttled if this is empty, the default, or if there
+    * is no eye point actor.
+    */
+   void SetSkeletonUpdateLODs(const SkeletonUpdateLODVector& lods);
+   const SkeletonUpdateLODVector& GetSkeletonUpdateLODs() const;
+
    /**
     * Called from helpers when an animatable has reached a point when
     * an event should be fired, if one is specified.
@@ -118,6 +159,8 @@ protected:
    // creates batches of isector queries
    void GroundClamp(BaseClass::ActorCompMapping&);
    void ExecuteCommands(BaseClass::ActorCompMapping&);
+   void UpdateSkeletonLOD(BaseClass::ActorCompMapping&);
+   void ApplySharedPoseCache(BaseClass::ActorCompMapping&);
 
 private:
    AnimationComponent(const AnimationComponent&);               //not implemented
@@ -125,6 +168,13 @@ private:
 
    dtCore::RefPtr<dtGame::BaseGroundClamper> mGroundClamper;
 
+   bool mSharedPosesEnabled;
+   dtCore::RefPtr<SharedPoseCache> mSharedPoseCache;
+   SkeletonUpdateLODVector mSkeletonUpdateLODs;
+   // eye point used by UpdateSkeletonLOD during a tick.
+   osg::Vec3 mLODEyePoint;
+   bool mLODEyePointValid;
+
    // A field used exclusively for the event sending code.
    // This tracks the current actor that whose helper's commands
    // are currently being executed. This information is important
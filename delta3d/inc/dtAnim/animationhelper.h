@@ -27,6 +27,7 @@
 #include <dtAnim/basemodelwrapper.h>
 #include <dtAnim/modelloader.h>
 #include <dtAnim/sequencemixer.h>
+#include <dtAnim/sharedposecache.h>
 #include <dtAnim/animationcomponent.h>
 
 #include <dtGame/datacentricactorcomponent.h>
@@ -263,6 +264,24 @@ namespace dtAnim
       void SetPosesEnabled(bool enabled);
       bool GetPosesEnabled() const;
 
+      /**
+       * Shares skeleton evaluations with other characters using the same cache.  The AnimationComponent
+       * sets this on the helpers registered with it when its shared pose mode is on.
+       * Only Cal3D characters support this; it's ignored for others.
+       * @see Cal3DAnimator::SetSharedPoseCache
+       */
+      void SetSharedPoseCache(SharedPoseCache* cache);
+      SharedPoseCache* GetSharedPoseCache() const;
+
+      /**
+       * Sets how often, in seconds, the skeleton is evaluated, interpolating in between.  0 means every update.
+       * The AnimationComponent sets this from its skeleton update LODs.
+       * Only Cal3D characters support this; it's ignored for others.
+       * @see Cal3DAnimator::SetSkeletonUpdateInterval
+       */
+      void SetSkeletonUpdateInterval(float seconds);
+      float GetSkeletonUpdateInterval() const;
+
       /**
        * Set whether command callbacks should be handled for this helper.
        */
@@ -480,6 +499,9 @@ namespace dtAnim
        */
       unsigned RemoveCommandFromQueue(AnimCommandCallback& commandToRemove);
 
+      /// Passes the shared pose cache and skeleton update interval on to the animator.
+      void ApplySkeletonUpdateSettings();
+
       bool mGroundClamp;
       bool mEnableCommands;
       double mLastUpdateTime;
@@ -489,6 +511,8 @@ namespace dtAnim
       dtCore::RefPtr<AttachmentController> mAttachmentController;
       dtCore::RefPtr<dtAnim::BaseModelWrapper> mModelWrapper;
       dtCore::RefPtr<PoseSequence> mPoseSequence;
+      dtCore::RefPtr<SharedPoseCache> mSharedPoseCache;
+      float mSkeletonUpdateInterval;
 
       typedef std::multimap<std::string, dtCore::RefPtr<TimeOffsetCommand> > CommandMap;
       CommandMap mCommandMap;
@@ -29,6 +29,7 @@
 #include <dtAnim/animationupdaterinterface.h>
 #include <dtAnim/cal3dmodelwrapper.h>
 #include <dtAnim/ical3ddriver.h>
+#include <dtAnim/sharedposecache.h>
 #include <dtCore/observerptr.h>
 #include <osg/Referenced>
 
@@ -89,7 +90,10 @@ namespace dtAnim
       /// Update just the Cal3D's animation using the mixer
       void UpdateAnimation(float deltaTime);
 
-      /// Update just Cal3D's skeleton using the mixer
+      /**
+       * Update just Cal3D's skeleton using the mixer.  If a shared pose cache or a skeleton update
+       * interval is set, the pose may come from the cache or from interpolating between evaluations.
+       */
       void UpdateSkeleton(float deltaTime);
 
       /// Update the CalModel's morph target mixer
@@ -127,6 +131,22 @@ namespace dtAnim
       /*virtual*/ bool BlendPose(dtAnim::AnimationInterface& anim, float weight, float delay);
       /*virtual*/ bool ClearPose(dtAnim::AnimationInterface& anim, float delay);
       
+      /**
+       * Shares skeleton evaluations with other animators that use the same cache.  If another character
+       * with the same core model has already evaluated the same animations at nearly the same time,
+       * its pose is copied instead of running the mixer.  NULL, the default, turns sharing off.
+       */
+      void SetSharedPoseCache(SharedPoseCache* cache);
+      SharedPoseCache* GetSharedPoseCache() const;
+
+      /**
+       * Sets how often, in seconds, the skeleton is evaluated.  Between evaluations the bones are
+       * interpolated from the pose that was showing toward the latest evaluated one, so the skeleton
+       * trails the animation by up to one interval.  0, the default, evaluates on every update.
+       */
+      void SetSkeletonUpdateInterval(float seconds);
+      float GetSkeletonUpdateInterval() const;
+
       /**
        * Globally set whether characters should be allowed to go back to bind pose
        * when animations have completed.
@@ -138,6 +158,14 @@ namespace dtAnim
       virtual ~Cal3DAnimator();
 
    private:
+      /// Fills the key from the animations that are currently on the mixer.
+      void BuildPoseKey(SharedPoseCache::Key& key) const;
+      /// @return the current pose, running the mixer only if the cache doesn't have it.
+      dtCore::RefPtr<const SharedPoseCache::Pose> EvaluatePose(bool& bonesUpdated);
+      dtCore::RefPtr<SharedPoseCache::Pose> CapturePose() const;
+      void ApplyPose(const SharedPoseCache::Pose& pose);
+      void ApplyPose(const SharedPoseCache::Pose& from, const SharedPoseCache::Pose& to, float alpha);
+
       dtCore::ObserverPtr<dtAnim::Cal3DModelWrapper> mWrapper;
       CalModel* mCalModel;
       CalMixer* mMixer;
@@ -151,6 +179,14 @@ namespace dtAnim
       dtCore::RefPtr<ICal3DDriver> mSpringDriver;
       dtCore::RefPtr<ICal3DDriver> mPhysiqueDriver;
 
+      dtCore::RefPtr<SharedPoseCache> mSharedPoseCache;
+      SharedPoseCache::Key mPoseKey;
+      float mSkeletonUpdateInterval;
+      float mTimeSinceSkeletonUpdate;
+      float mPoseBlendAlpha;
+      dtCore::RefPtr<const SharedPoseCache::Pose> mPoseFrom;
+      dtCore::RefPtr<const SharedPoseCache::Pose> mPoseTo;
+
       // Class variables
       static bool sAllowBindPose;
    };
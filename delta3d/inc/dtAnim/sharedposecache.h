@@ -0,0 +1,160 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef __DELTA_SHAREDPOSECACHE_H__
+#define __DELTA_SHAREDPOSECACHE_H__
+
+////////////////////////////////////////////////////////////////////////////////
+// INCLUDE DIRECTIVES
+////////////////////////////////////////////////////////////////////////////////
+#include <dtAnim/export.h>
+#include <dtCore/refptr.h>
+#include <dtUtil/getsetmacros.h>
+#include <dtUtil/hashmap.h>
+#include <osg/Referenced>
+#include <OpenThreads/Atomic>
+#include <OpenThreads/Mutex>
+#include <vector>
+
+
+
+namespace dtAnim
+{
+   /////////////////////////////////////////////////////////////////////////////
+   // CLASS CODE
+   /////////////////////////////////////////////////////////////////////////////
+   /**
+    * Holds evaluated skeleton poses so that characters that share a core model and are
+    * playing the same animations at nearly the same time can share one skeleton evaluation.
+    *
+    * A pose is keyed on the core model and, for each active animation, its id, type, weight,
+    * and time.  Weights and times are quantized, so characters a fraction of a frame apart
+    * get the same pose. The quantization steps trade accuracy for hit rate.
+    *
+    * Find and Insert may be called from the animation update threads.  Poses are immutable once
+    * they are inserted. Poses that are not used for a few frames are dropped in AdvanceFrame.
+    */
+   class DT_ANIM_EXPORT SharedPoseCache : public osg::Referenced
+   {
+   public:
+      /// The relative transform of one bone.
+      struct BoneState
+      {
+         float mRotation[4];
+         float mTranslation[3];
+      };
+
+      /// One evaluated skeleton, indexed the same as the skeleton's bone vector.
+      class DT_ANIM_EXPORT Pose : public osg::Referenced
+      {
+      public:
+         Pose() {}
+
+         std::vector<BoneState> mBones;
+
+      protected:
+         ~Pose() {}
+      };
+
+      /// Identifies a pose.  Fill it with Reset and Add, then use it for Find and Insert.
+      class DT_ANIM_EXPORT Key
+      {
+      public:
+         Key();
+
+         /// Clears the values and starts a key for the given model.
+         void Reset(const void* model);
+
+         void Add(size_t value);
+
+         size_t GetHash() const { return mHash; }
+
+         bool operator==(const Key& rhs) const;
+         bool operator<(const Key& rhs) const;
+
+      private:
+         const void* mModel;
+         std::vector<size_t> mValues;
+         size_t mHash;
+      };
+
+      struct KeyHash
+      {
+         size_t operator()(const Key& key) const { return key.GetHash(); }
+      };
+
+      SharedPoseCache();
+
+      /// The time step, in seconds, that animation times are rounded down to when building keys.  Defaults to 1/30.
+      DT_DECLARE_ACCESSOR(float, TimeQuantum);
+
+      /// The step that animation weights are rounded to when building keys.  Defaults to 1/32.
+      DT_DECLARE_ACCESSOR(float, WeightQuantum);
+
+      /// The number of AdvanceFrame calls a pose may go unused before it is dropped.  Defaults to 4.
+      DT_DECLARE_ACCESSOR(unsigned, MaxIdleFrames);
+
+      /// New poses are not stored once the cache holds this many.  Defaults to 4096.
+      DT_DECLARE_ACCESSOR(unsigned, MaxPoses);
+
+      size_t QuantizeTime(float time) const;
+      size_t QuantizeWeight(float weight) const;
+
+      /// @return the pose for the key, or NULL if it hasn't been inserted.  Thread safe.
+      dtCore::RefPtr<const Pose> Find(const Key& key);
+
+      /// Stores the pose for the key, unless another thread already stored one.  Thread safe.
+      void Insert(const Key& key, const Pose& pose);
+
+      /// Call once per frame, outside of the animation update, to drop stale poses.
+      void AdvanceFrame();
+
+      /// Drops all the poses.
+      void Clear();
+
+      unsigned GetNumPoses() const;
+
+      /// @return the number of Find calls that returned a pose since the counters were last reset.
+      unsigned GetNumHits() const { return mNumHits; }
+      /// @return the number of Find calls that returned NULL since the counters were last reset.
+      unsigned GetNumMisses() const { return mNumMisses; }
+      void ResetCounters();
+
+   protected:
+      virtual ~SharedPoseCache();
+
+   private:
+      struct Entry
+      {
+         dtCore::RefPtr<const Pose> mPose;
+         unsigned mLastUsedFrame;
+      };
+
+      typedef dtUtil::HashMap<Key, Entry, KeyHash> PoseMap;
+
+      mutable OpenThreads::Mutex mMutex;
+      PoseMap mPoses;
+      unsigned mFrame;
+      OpenThreads::Atomic mNumHits;
+      OpenThreads::Atomic mNumMisses;
+   };
+
+} // namespace dtAnim
+
+#endif // __DELTA_SHAREDPOSECACHE_H__
@@ -27,6 +27,7 @@
 #include <dtCore/refptr.h>
 #include <dtUtil/librarysharingmanager.h>
 #include <osg/Referenced>
+#include <OpenThreads/ReentrantMutex>
 #include <dtCore/actorpluginregistry.h>
 #include <dtCore/export.h>
 
@@ -260,6 +261,9 @@ namespace dtCore
          ///List of the currently loaded actor registries.
          RegistryMap mRegistries;
 
+         /// Guards the registries so maps can be parsed on a worker thread.  Reentrant because creating an actor may create others.
+         mutable OpenThreads::ReentrantMutex mMutex;
+
          dtUtil::Log* mLogger;
    };
 
@@ -175,6 +175,17 @@ namespace dtCore
          /// @return true if this property is marked as advanced
          bool GetAdvanced() const { return mAdvanced; }
 
+         /**
+          * @return true if the value has been set through this property since the flag was last cleared.
+          * GenericActorProperty::SetValue, and so FromString, sets it.  Changes made by calling the
+          * actor's setter directly don't.
+          * @see dtGame::GameActorProxy::PropertyPublishPolicy
+          */
+         bool IsDirty() const { return mDirty; }
+
+         /// Sets or clears the dirty flag.
+         void SetDirty(bool dirty) { mDirty = dirty; }
+
          /**
           * Set the group name
           * @param name The desired group name
@@ -250,6 +261,9 @@ namespace dtCore
           */
          ActorProperty& operator=(const ActorProperty&);
 
+         /// Not a bit field so a parallel tick setting it can't clobber the flags below.
+         bool mDirty;
+
          /* **********
           * Flags Section.  Should should remain at the end so that they pack nicely.
           */
@@ -0,0 +1,160 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_ASYNCMESHLOADER_H_
+#define DELTA_ASYNCMESHLOADER_H_
+
+#include <dtCore/export.h>
+#include <dtCore/base.h>
+#include <dtCore/refptr.h>
+#include <dtCore/observerptr.h>
+#include <dtUtil/functor.h>
+#include <dtUtil/getsetmacros.h>
+#include <OpenThreads/Mutex>
+#include <osg/Node>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dtCore
+{
+   class MeshLoadTask;
+
+   /**
+    * Loads meshes on the thread pool IO queue so that spawning actors doesn't stall the frame.
+    *
+    * Each request reads the file with a dtUtil::ReadNodeThreadPoolTask, with the same options as Loadable::LoadFile.
+    * Uncached loads are then post-processed (osgUtil::Optimizer, texture compression hints and computing the bounds)
+    * on the same worker thread.  Cached loads are shared through the osgDB object cache, so they are left as loaded.
+    * The results are handed to the callbacks in the pre-frame of the main thread, stopping once the frame
+    * budget is used up, so a burst of loads finishing at once is spread over several frames.  The shader, if
+    * one is requested, is assigned just before the callback because the ShaderManager is not thread safe.
+    *
+    * Cached requests for a file that is already loading share the load.  Uncached requests each get their own
+    * copy of the mesh, so they always load separately.
+    *
+    * Requests may be made from any thread.  If the thread pool is not initialized, the file is read on the
+    * calling thread, but the callback still happens in the next pre-frame.
+    * @note This class is a singleton.
+    */
+   class DT_CORE_EXPORT AsyncMeshLoader : public dtCore::Base
+   {
+   public:
+      /// Called with the loaded node, or NULL if loading failed, and the file name that was requested.
+      typedef dtUtil::Functor<void, TYPELIST_2(osg::Node*, const std::string&)> LoadCallback;
+
+      static AsyncMeshLoader& GetInstance();
+
+      /// Destroys the singleton.  Pending callbacks are dropped.
+      static void Destroy();
+
+      /// @return true if loads will actually run in the background.
+      static bool IsAvailable();
+
+      /**
+       * Queues a mesh to be loaded.
+       * @param filename the full path to the file.
+       * @param useCache if true, the osgDB object cache is used and duplicate requests share one load.
+       * @param callback called on the main thread when the mesh is ready.
+       * @param owner if not NULL, the callback is skipped if the owner has been deleted by the time the mesh is ready.
+       * @param shaderName if not empty, the name of a ShaderManager prototype to assign to the loaded node.
+       * @param shaderGroup the group to search for the shader, or empty to search all groups.
+       */
+      void RequestLoad(const std::string& filename, bool useCache, const LoadCallback& callback,
+               osg::Referenced* owner = NULL, const std::string& shaderName = "", const std::string& shaderGroup = "");
+
+      /**
+       * Hands completed loads to their callbacks until the frame budget runs out.  This is called automatically
+       * in the system pre-frame.  At least one load is committed per call so the queue always drains.
+       * @param budgetMs the time to spend, or a negative number to commit everything that is ready.
+       * @return the number of callbacks called.
+       */
+      unsigned CommitCompleted(double budgetMs);
+
+      /// Blocks until every queued load is read and committed.  Mostly for tests and loading screens.
+      void WaitForAll();
+
+      /// @return the number of callbacks still waiting, loading or not.
+      unsigned GetNumPending() const;
+
+      /// @return the number of files being read or waiting to be committed.
+      unsigned GetNumLoadsInFlight() const;
+
+      /// @return the number of requests that joined a load already in flight instead of reading the file again.
+      unsigned GetNumSharedLoads() const;
+
+      /// The time in milliseconds spent committing loads each pre-frame.  Defaults to 2.
+      DT_DECLARE_ACCESSOR(double, FrameBudgetMs);
+
+      /**
+       * The osgUtil::Optimizer options to run on newly loaded uncached meshes, or 0 to skip it.  The default only shares
+       * state and merges geometry so that named nodes, like DOFs and hot spots, survive.
+       */
+      DT_DECLARE_ACCESSOR(unsigned, OptimizerOptions);
+
+      /// If true, uncompressed textures on newly loaded uncached meshes are set to be compressed by the driver.  Defaults to false.
+      DT_DECLARE_ACCESSOR(bool, CompressTextures);
+
+      /// Called when system sends out update data.
+      void OnSystem(const dtUtil::RefString& str, double deltaSim, double deltaReal);
+
+   private:
+      struct Request
+      {
+         LoadCallback mCallback;
+         bool mHasOwner;
+         dtCore::ObserverPtr<osg::Referenced> mOwner;
+         std::string mShaderName;
+         std::string mShaderGroup;
+      };
+
+      struct Load
+      {
+         dtCore::RefPtr<MeshLoadTask> mTask;
+         std::vector<Request> mRequests;
+         bool mUseCache;
+      };
+
+      typedef std::list<Load> LoadList;
+      typedef std::map<std::string, LoadList::iterator> SharedLoadMap;
+
+      /// Removes the next request from a completed load.  Call with the mutex locked.
+      bool PopReadyRequest(Request& request, dtCore::RefPtr<osg::Node>& node, std::string& filename);
+
+      void Dispatch(Request& request, osg::Node* node, const std::string& filename);
+
+      AsyncMeshLoader();
+      virtual ~AsyncMeshLoader();
+
+      AsyncMeshLoader(const AsyncMeshLoader&);
+      AsyncMeshLoader& operator=(const AsyncMeshLoader&);
+
+      mutable OpenThreads::Mutex mMutex;
+      LoadList mLoads;
+      SharedLoadMap mSharedLoads;
+      unsigned mNumPending;
+      unsigned mNumSharedLoads;
+
+      static dtCore::RefPtr<AsyncMeshLoader> mInstance;
+      static OpenThreads::Mutex mInstanceMutex;
+   };
+}
+
+#endif /* DELTA_ASYNCMESHLOADER_H_ */
@@ -172,6 +172,18 @@ namespace dtCore
        */
       int GetTraversalMask() const { return mTraversalMask; }
 
+      /**
+       * Sets whether Update splits the enabled isectors across the dtUtil::ThreadPool workers.
+       * Each worker runs its own intersect visitor over the scene, and the hit lists are assigned
+       * in isector order, so the results match a serial update.  If the thread pool isn't initialized,
+       * has no immediate workers, or Update is called from a pool worker, the update runs on the calling
+       * thread.  Don't change the scene while an update is running.
+       */
+      void SetUseThreadPool(bool useThreadPool) { mUseThreadPool = useThreadPool; }
+
+      ///@return true if Update splits the isectors across the thread pool workers.
+      bool GetUseThreadPool() const { return mUseThreadPool; }
+
       ///Sets the scene to use as the base for the scene query.
       void SetScene(Scene* newScene) { mScene = newScene; }
 
@@ -231,6 +243,7 @@ namespace dtCore
       dtCore::RefPtr<SingleISector>       mISectors[32];    // all the isectors to be sent down in one batch call.
       const int                           mFixedArraySize;
       int                                 mTraversalMask;
+      bool                                mUseThreadPool;
    };
 
 } // namespace dtCore
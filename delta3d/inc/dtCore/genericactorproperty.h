@@ -98,13 +98,14 @@ namespace dtCore
 
       /**
        * Sets the value of this property by calling the set functor
-       * assigned to this property.
+       * assigned to this property, and marks the property dirty.
        */
       void SetValue(SetType value)
       {
          if (!IsReadOnly())
          {
             SetPropFunctor(value);
+            SetDirty(true);
          }
          else
          {
@@ -25,15 +25,18 @@
 //
 //////////////////////////////////////////////////////////////////////
 
-#include <set>
+#include <map>
+#include <vector>
 #include <dtCore/transformable.h>
 #include <dtUtil/noiseutility.h>
 #include <osg/Vec3>
 #include <osg/Vec4>
+#include <OpenThreads/Mutex>
 
 namespace dtCore
 {
    class InfiniteTerrainCallback;
+   class InfiniteTerrainSegment;
 
    /**
     * An infinite terrain surface.
@@ -224,16 +227,96 @@ namespace dtCore
           */
          void SetMaxColor(const osg::Vec3& rgb);
 
+         /**
+          * Enables or disables building segments ahead of the eyepoint on the
+          * dtUtil::ThreadPool background queue. (def = false)  Segments inside the
+          * build distance that are not ready yet are still built immediately.
+          * This has no effect unless the thread pool has been initialized.
+          *
+          * @param enable true to enable, false to disable
+          */
+         void SetAsyncBuildEnabled(bool enable);
+
+         /**
+          * @return true if segments are built ahead on background threads.
+          */
+         bool IsAsyncBuildEnabled() const;
+
+         /**
+          * Sets how far ahead, in seconds of eyepoint motion, segments are
+          * queued for background building. (def = 2.0)
+          *
+          * @param seconds the look ahead time
+          */
+         void SetPrefetchTime(float seconds);
+
+         /**
+          * @return the look ahead time in seconds.
+          */
+         float GetPrefetchTime() const;
+
+         /**
+          * Builds the segments around the given eyepoint, queues the segments
+          * ahead of it and swaps in the ones that finished in the background.
+          * This is called from the cull traversal.
+          *
+          * @param eyePoint the eyepoint to build around
+          * @param time the current time in seconds, used to estimate the eyepoint velocity
+          */
+         void UpdateSegments(const osg::Vec3& eyePoint, double time);
+
+         /**
+          * @return the number of segments queued on background threads and not yet in the scene.
+          */
+         unsigned GetNumPendingSegments() const;
+
+         /**
+          * Finishes every queued segment on the calling thread and adds it to the scene.
+          */
+         void FinishPendingSegments();
+
       private:
 
          /**
-          * Builds a single terrain segment.
+          * Builds a single terrain segment, or finishes it if it was queued.
           *
           * @param x the x coordinate at which to build the segment
           * @param y the y coordinate at which to build the segment
           */
          void BuildSegment(int x, int y);
 
+         /**
+          * Queues a single terrain segment to be built on a background thread.
+          *
+          * @param x the x coordinate at which to build the segment
+          * @param y the y coordinate at which to build the segment
+          */
+         void QueueSegment(int x, int y);
+
+         /**
+          * Creates the segment object holding a snapshot of the current settings.
+          */
+         InfiniteTerrainSegment* CreateSegment(int x, int y);
+
+         /**
+          * Drops the built and queued segments and flags the scene for clearing.
+          * Call with mSegmentMutex held.
+          */
+         void ClearSegments();
+
+         /**
+          * Adds the queued segments that have finished building to the scene.
+          */
+         void AttachReadySegments();
+
+         /**
+          * Returns the height of a terrain post, from the built segment if there is one.
+          *
+          * @param gridX the post index along x
+          * @param gridY the post index along y
+          */
+         float GetPostHeight(int gridX, int gridY);
+
 
          //returns an interpolated color based on the height
          osg::Vec4 GetColor(float pHeight);
@@ -295,10 +378,31 @@ namespace dtCore
             }
          };
 
+         typedef std::map<Segment, RefPtr<InfiniteTerrainSegment> > SegmentMap;
+
          /**
-          * The set of constructed segments.
+          * Guards the segments, the settings they are built from and the clear flag.
+          * The segments are updated in the cull traversal and read by height queries on the sim thread.
           */
-         std::set<Segment> mBuiltSegments;
+         mutable OpenThreads::Mutex mSegmentMutex;
+
+         /**
+          * The constructed and queued segments.
+          */
+         SegmentMap mSegments;
+
+         /**
+          * The queued segments that have not been added to the scene yet.
+          */
+         std::vector<RefPtr<InfiniteTerrainSegment> > mPendingSegments;
+
+         bool mAsyncBuildEnabled;
+         float mPrefetchTime;
+
+         /// The eyepoint of the last update, used to estimate its velocity.
+         osg::Vec3 mLastEyePoint;
+         double mLastEyeTime;
+         bool mHasLastEyePoint;
 
          /**
           * Flags the segments as needing to be cleared.
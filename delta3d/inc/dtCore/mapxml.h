@@ -84,6 +84,12 @@ namespace dtCore
          ///@see #GetMapBeingParsed
          const Map* GetMapBeingParsed() const;
 
+         /**
+          * Map files may be parsed on several threads at once, each with its own parser.
+          * @return the parser running Parse on a file on the calling thread, or NULL if there isn't one.
+          */
+         static MapParser* GetParserOnThisThread();
+
          const std::set<std::string>& GetMissingActorTypes();
          const std::vector<std::string>& GetMissingLibraries();
 
@@ -91,6 +91,23 @@ namespace dtCore
           */
          DT_DECLARE_ACCESSOR(bool, GenerateTangents);
 
+         /**
+          * If true, the mesh resource is loaded in the background by the AsyncMeshLoader when the object
+          * is added to the scene or the resource changes.  The current geometry stays until the new one is ready.
+          * This is ignored in edit mode so the editor always sees the mesh right away.  Defaults to false.
+          */
+         DT_DECLARE_ACCESSOR(bool, LoadAsynchronously);
+
+         /**
+          * Loads the file in the background and attaches it in a later frame.  A later call to this or LoadFile
+          * replaces the pending load.  If the thread pool isn't running, the file is read right away,
+          * but still attached in the next frame.
+          */
+         void LoadFileAsync(const std::string& filename, bool useCache = true);
+
+         /// @return true if LoadFileAsync was called and the mesh hasn't been attached yet.
+         bool IsLoadingAsynchronously() const;
+
          /**
           * Sets the scale on this object
           * @param xyz The scale vector
@@ -147,6 +164,16 @@ namespace dtCore
 
          void Ctor();
 
+         /// Replaces the current geometry with the node, or clears it if the node is NULL.
+         void AttachLoadedNode(osg::Node* node);
+
+         /// Loads the mesh resource using async or not depending on the settings.
+         void LoadMeshResource();
+
+         void OnAsyncMeshLoaded(osg::Node* node, const std::string& filename);
+
+         std::string mPendingAsyncFile;
+
          dtCore::RefPtr<Model> mModel;
    };
 }
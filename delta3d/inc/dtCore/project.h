@@ -256,6 +256,39 @@ namespace dtCore
 
       std::vector<Map*> GetOpenMaps();
 
+      /**
+       * Looks up the file for a map so it can be parsed with ParseMapFile.
+       * @param name the name of the map as specified by the getMapNames() vector.
+       * @return the full path to the map file.
+       * @throws FileNotFoundException if the map does not exist.
+       * @throws ProjectInvalidContextException if the context is not set.
+       */
+      std::string GetMapFilePath(const std::string& name);
+
+      /**
+       * Parses a map file into a new map that the project does not know about yet.  It may be called
+       * on a worker thread, which is how the GameManager loads map sets in the background.  Hand the
+       * result to AddParsedMap on the main thread to open it.
+       * The properties being loaded still look up actors and events in the open maps, resource
+       * paths in the contexts, and prefabs through LoadPrefab.  The open maps and the prefab cache are
+       * locked against the main thread, and each prefab is parsed with its own parser.  Resource lookups
+       * don't lock, so don't change the contexts, or close the maps the file refers to, until the parse is done.
+       * @param fullPath the path returned by GetMapFilePath.
+       * @throws MapParsingException if an error occurs reading the map file.
+       * @throws FileNotFoundException if the file does not exist.
+       */
+      static dtCore::RefPtr<Map> ParseMapFile(const std::string& fullPath);
+
+      /**
+       * Opens a map returned by ParseMapFile, just as if GetMap had loaded it.  If a map with the
+       * name is already open, that map is returned and the parsed one is not used.
+       * @param name the name of the map as specified by the getMapNames() vector.
+       * @param map the parsed map.
+       * @return the opened map
+       * @throws FileNotFoundException if the map does not exist.
+       */
+      Map& AddParsedMap(const std::string& name, Map& map);
+
       /**
        * Loads a prefab
        * @param rd Resource pointing to the prefab
@@ -266,6 +299,21 @@ namespace dtCore
        */
       MapPtr LoadPrefab(const dtCore::ResourceDescriptor& rd, dtCore::ActorRefPtrVector& actorsOut);
 
+      /**
+       * Enables or disables the prefab template cache.  When it is enabled, LoadPrefab parses a prefab once, keeps the
+       * parsed actors as templates, and clones them on later loads until the file's modification time or size changes.
+       * The clones get new unique ids just like freshly parsed actors.  It is enabled by default.
+       * Disabling the cache also clears it.
+       */
+      void SetPrefabCacheEnabled(bool enable);
+      bool IsPrefabCacheEnabled() const;
+
+      /// Drops all the cached prefab templates.  Changing the contexts does this automatically.
+      void ClearPrefabCache();
+
+      /// @return the number of prefabs that have a cached template.
+      unsigned GetPrefabCacheSize() const;
+
       /// This does not yes work.
       dtCore::RefPtr<BaseActorObject> LoadPrefab(const dtCore::PrefabActorType& actorType);
 
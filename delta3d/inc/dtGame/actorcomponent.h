@@ -36,6 +36,7 @@ namespace dtGame
 {
    class GameActor;
    class ActorComponentContainer;
+   class ParallelTickTask;
    class MapMessage;
    class TickMessage;
 
@@ -193,11 +194,14 @@ namespace dtGame
 
       /**
        * Registers for tick local or tick remote depending on the actor state.
+       * If ParallelTick is set, the component is registered with GameManager::RegisterForParallelTick
+       * instead of having an invokable added to the owner.
        */
       void RegisterForTick();
 
       /**
-       * Unregisters for tick local or tick remote depending on the actor state.
+       * Undoes RegisterForTick.  It removes the component from the tick it was actually registered for,
+       * even if ParallelTick or the owner's remote state has changed since.
        */
       void UnregisterForTick();
 
@@ -211,6 +215,8 @@ namespace dtGame
       virtual bool IsPlaceable() const /*final*/ { return false; }
 
    private: 
+      friend class ParallelTickTask;
+      friend class GameManager;
 
       /** The ComponentBase this component is a part of */
       ActorComponentContainer* mOwner;
@@ -221,9 +227,31 @@ namespace dtGame
       /// Have we built our property maps, etc.
       bool mInitialized;
 
+      /// Which tick RegisterForTick used, so UnregisterForTick can undo that one.
+      enum TickRegistration
+      {
+         TICK_NOT_REGISTERED,
+         TICK_INVOKABLE_LOCAL,
+         TICK_INVOKABLE_REMOTE,
+         TICK_PARALLEL_LOCAL,
+         TICK_PARALLEL_REMOTE
+      };
+      TickRegistration mTickRegistration;
+
+      /// The position in the game manager's parallel tick list.  Only the GameManager changes this.
+      unsigned mParallelTickIndex;
+
    public:
       /// if this actor component is in the GM.
       DT_DECLARE_ACCESSOR(bool, IsInGM);
+
+      /**
+       * Set this before calling RegisterForTick to have the tick run on the thread pool along with the other
+       * parallel components.  Only set it if OnTickLocal/OnTickRemote touch nothing but the state of this component
+       * and its owner's drawable.  Messages sent from the tick are queued after all the parallel ticks finish.
+       * Creating them with the GM's message factory is safe from the workers, the type registry is locked.
+       */
+      DT_DECLARE_ACCESSOR(bool, ParallelTick);
    };
 }
 #endif // actorcomponent_h__
@@ -133,6 +133,13 @@ namespace dtGame
           */
          const dtCore::NamedParameter* GetUpdateParameter(const std::string &name) const;
 
+         /**
+          * Removes the dtCore::NamedParameter with the given name from this actor update message.
+          * @param name The name of the parameter to remove.
+          * @return true if there was such a parameter.
+          */
+         bool RemoveUpdateParameter(const std::string& name);
+
          /** 
           * Retrieves the MessageParameters that have been previously added to this
           * ActorUpdateMessage internal GroupMessageParameter.
@@ -131,6 +131,22 @@ namespace dtGame
       DECLARE_PARAMETER_INLINE(std::string, RejectionMessage)
    DT_DECLARE_MESSAGE_END()
 
+   /**
+    * Sent from a client to the server to describe the area the client cares about, usually around its camera.
+    * The server sends updates for actors outside the region at a reduced rate.
+    * @see dtNetGM::ServerNetworkComponent
+    */
+   DT_DECLARE_MESSAGE_BEGIN(ClientInterestRegionMessage, Message, DT_GAME_EXPORT)
+      /// The center of the region in world coordinates.
+      DECLARE_PARAMETER_INLINE(osg::Vec3, Position)
+      /// The radius of the region.  A value of 0 or less means the client wants everything.
+      DECLARE_PARAMETER_INLINE(float, Radius)
+      /// The direction the client is looking in.  A zero vector, the default, makes the region the whole sphere.
+      DECLARE_PARAMETER_INLINE(osg::Vec3, ViewDirection)
+      /// Half the angle of the view cone in degrees.  180, the default, makes the region the whole sphere.
+      DECLARE_PARAMETER_INLINE(float, ViewHalfAngle)
+   DT_DECLARE_MESSAGE_END()
+
 
    class DT_GAME_EXPORT RestartMessage : public Message
    {
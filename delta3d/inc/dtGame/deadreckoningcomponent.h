@@ -26,6 +26,7 @@
 
 #include <dtCore/refptr.h>
 #include <dtUtil/nodecollector.h>
+#include <dtUtil/enumeration.h>
 
 #include <dtGame/export.h>
 #include <dtGame/gmcomponent.h>
@@ -51,6 +52,28 @@ namespace dtGame
 
       static const std::string DEFAULT_NAME;
 
+      /**
+       * How often a remote actor is dead reckoned.  Tiers are assigned by distance from the eye point
+       * when update tiers are enabled.
+       * @see SetUpdateTiersEnabled
+       */
+      class DT_GAME_EXPORT UpdateTier : public dtUtil::Enumeration
+      {
+         DECLARE_ENUM(UpdateTier);
+      public:
+         /// Dead reckoned, clamped and articulated every frame.
+         static UpdateTier FULL;
+         /// Dead reckoned every Nth frame, staggered across actors.
+         static UpdateTier REDUCED;
+         /// Dead reckoned only when an update arrives, with coarse clamping.
+         static UpdateTier MINIMAL;
+      private:
+         UpdateTier(const std::string& name) : dtUtil::Enumeration(name)
+         {
+            AddInstance(this);
+         }
+      };
+
       DeadReckoningComponent(dtCore::SystemComponentType& type = *TYPE);
 
       /**
@@ -116,6 +139,45 @@ namespace dtGame
       /// @return the ground clamping utility class
       BaseGroundClamper& GetGroundClamper();
 
+      /**
+       * Enables distance based update tiers for remote actors.  When disabled, the default, every registered
+       * actor is dead reckoned every frame.  Tiers require an eye point actor.
+       */
+      void SetUpdateTiersEnabled(bool enabled);
+      bool GetUpdateTiersEnabled() const;
+
+      /// Remote actors closer than this to the eye point are in the FULL tier.
+      void SetFullTierDistance(float distance);
+      float GetFullTierDistance() const;
+
+      /// Remote actors closer than this, but outside the full tier distance, are in the REDUCED tier.  Others are MINIMAL.
+      void SetReducedTierDistance(float distance);
+      float GetReducedTierDistance() const;
+
+      /// Number of frames between updates of an actor in the REDUCED tier.
+      void SetReducedTierFrameInterval(unsigned frames);
+      unsigned GetReducedTierFrameInterval() const;
+
+      /**
+       * Number of frames between updates of an actor in the MINIMAL tier when no network update arrives.
+       * 0, the default, means they only move when updated.
+       */
+      void SetMinimalTierFrameInterval(unsigned frames);
+      unsigned GetMinimalTierFrameInterval() const;
+
+      /**
+       * Number of actors whose tier is reassigned each frame.  Assignment walks the registered actors round-robin
+       * so the cost is constant per frame no matter how many actors are registered.
+       */
+      void SetTierAssignmentsPerFrame(unsigned count);
+      unsigned GetTierAssignmentsPerFrame() const;
+
+      /// @return the tier currently assigned to the given actor, or FULL if it is not registered.
+      const UpdateTier& GetActorUpdateTier(const dtGame::GameActorProxy& gameActorProxy) const;
+
+      /// @return how many registered actors were actually dead reckoned on the last remote tick.
+      unsigned GetNumActorsUpdatedLastFrame() const { return mNumActorsUpdatedLastFrame; }
+
    protected:
       virtual ~DeadReckoningComponent();
 
@@ -129,6 +191,24 @@ namespace dtGame
             const dtCore::Transformable& xformable,
             const dtGame::TickMessage& tickMessage) const;
 
+      /**
+       * Apply the articulation support
+       * @param helper the instance containing the articulation data.
+       * @param xformable the instance to be articulated.
+       * @param simTimeDelta the sim time since the articulations were last updated.
+       */
+      void DoArticulation(dtGame::DeadReckoningActorComponent& helper,
+            const dtCore::Transformable& xformable,
+            float simTimeDelta) const;
+
+      /**
+       * Picks the update tier of a remote actor.  Override to add visibility checks or other criteria.
+       * @param helper the dead reckoning data for the actor.
+       * @param eyePoint the absolute position of the eye point this frame.
+       */
+      virtual UpdateTier& CalculateUpdateTier(const dtGame::DeadReckoningActorComponent& helper,
+            const osg::Vec3& eyePoint) const;
+
       /**
        * Move the articulation DOF between the current position and next
        * position over a certain time step.
@@ -157,15 +237,54 @@ namespace dtGame
             const osg::Vec3& currLocation, const osg::Vec3& currentRate,
             float simTimeDelta, bool isPositional = false) const;
 
-      std::map<dtCore::UniqueId, dtCore::RefPtr<DeadReckoningActorComponent> > mRegisteredActors;
+      /// The helper for a registered actor along with its update tier bookkeeping.
+      struct RegisteredActorData
+      {
+         RegisteredActorData(DeadReckoningActorComponent& helper, unsigned phase)
+         : mHelper(&helper)
+         , mTier(&UpdateTier::FULL)
+         , mSkippedSimTime(0.0f)
+         , mPhase(phase)
+         {
+         }
+
+         dtCore::RefPtr<DeadReckoningActorComponent> mHelper;
+         UpdateTier* mTier;
+         /// Sim time that has passed since this actor was last dead reckoned.
+         float mSkippedSimTime;
+         /// Frame offset so actors in the same tier don't all update on the same frame.
+         unsigned mPhase;
+      };
+
+      typedef std::map<dtCore::UniqueId, RegisteredActorData> RegisteredActorMap;
+      RegisteredActorMap mRegisteredActors;
       dtCore::RefPtr<dtGame::BaseGroundClamper> mGroundClamper;
 
       dtUtil::Log* mLogger;
 
       float mArticSmoothTime;
 
+      bool mUpdateTiersEnabled;
+      float mFullTierDistance;
+      float mReducedTierDistance;
+      unsigned mReducedTierFrameInterval;
+      unsigned mMinimalTierFrameInterval;
+      unsigned mTierAssignmentsPerFrame;
+
+      unsigned mFrameCount;
+      unsigned mNextPhase;
+      unsigned mNumActorsUpdatedLastFrame;
+      /// Where the round-robin tier assignment picks up next frame.
+      dtCore::UniqueId mNextTierAssignmentId;
+
       void TickRemote(const dtGame::TickMessage& tickMessage);
 
+      /// Reassigns the tiers of the next slice of registered actors.
+      void AssignUpdateTiers();
+
+      /// @return true if the actor should be dead reckoned this frame based on its tier.
+      bool IsUpdateDue(const RegisteredActorData& data) const;
+
    };
 
 }
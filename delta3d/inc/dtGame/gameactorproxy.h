@@ -31,6 +31,7 @@
 #include <dtGame/messagetype.h>
 #include <dtUtil/getsetmacros.h>
 #include <dtUtil/tree.h>
+#include <osg/Vec4d>
 
 namespace dtUtil
 {
@@ -113,6 +114,19 @@ namespace dtGame
          LocalActorUpdatePolicy(const std::string& name);
       };
 
+      /// Internal class to represent how property changes on a local actor are published.
+      class DT_GAME_EXPORT PropertyPublishPolicy : public dtUtil::Enumeration
+      {
+         DECLARE_ENUM(PropertyPublishPolicy);
+      public:
+         /// Updates are only sent when NotifyFullActorUpdate or NotifyPartialActorUpdate is called.
+         static PropertyPublishPolicy MANUAL;
+         /// The dirty properties are sent in one partial update at the end of each tick.
+         static PropertyPublishPolicy DIRTY_PROPERTIES;
+      protected:
+         PropertyPublishPolicy(const std::string& name);
+      };
+
       /// Internal class to iterate over the actor's tree structure.
       class GameActorIterator : public dtCore::ActorComponentContainer::ActorIterator
       {
@@ -376,6 +390,47 @@ namespace dtGame
        */
       void SetLocalActorUpdatePolicy(LocalActorUpdatePolicy& newPolicy);
 
+      /**
+       * @return how property changes are published when this actor is local.
+       * @see dtGame::GameActorProxy::PropertyPublishPolicy
+       */
+      PropertyPublishPolicy& GetPropertyPublishPolicy() const;
+
+      /**
+       * Sets how property changes are published when this actor is local.  With DIRTY_PROPERTIES, the
+       * GameManager calls PublishDirtyProperties at the end of each tick, so everything set during the
+       * tick goes out in one partial update.  Setting the policy clears the dirty flags.
+       * @see dtCore::ActorProperty::IsDirty
+       */
+      void SetPropertyPublishPolicy(PropertyPublishPolicy& newPolicy);
+
+      /**
+       * Sets how far a float, double, or vector property has to move from the value last published before
+       * PublishDirtyProperties sends it again.  The largest change of any one component is compared.
+       * 0 sends any change, and properties of other types ignore the threshold.
+       */
+      void SetPropertyPublishThreshold(const dtUtil::RefString& propName, float epsilon);
+
+      /// @return the publish threshold for the given property, or 0 if it doesn't have one.
+      float GetPropertyPublishThreshold(const dtUtil::RefString& propName) const;
+
+      /**
+       * Marks a property dirty.  Use this when a value is changed by calling the setter on the actor
+       * rather than through the property.
+       */
+      void MarkPropertyDirty(const dtUtil::RefString& propName);
+
+      /// Clears the dirty flag on all the properties and takes the current values as the last published ones.
+      void ClearDirtyProperties();
+
+      /**
+       * Sends the dirty properties that moved past their thresholds in one partial update, then clears the
+       * dirty flags.  The GameManager calls this at the end of the tick for the DIRTY_PROPERTIES policy.
+       * Note - This will do nothing if the actor is Remote.
+       * @return true if an update was sent.
+       */
+      virtual bool PublishDirtyProperties();
+
       /**
        * Registers to receive a specific type of message.  You will receive
        * all instances of this message.  It will create an invokable for you.
@@ -753,6 +808,7 @@ namespace dtGame
       bool DetachDrawableFromParent(dtGame::GameActorProxy& parent);
 
    private:
+      friend class GameManager;
 
       /**
        * Override of the Tree base class.
@@ -768,21 +824,35 @@ namespace dtGame
       void PopulateActorUpdateImpl(ActorUpdateMessage& update,
                                    const std::vector<dtUtil::RefString>& propNames = std::vector<dtUtil::RefString>());
 
+      /// Registers with the GM for the end of tick publish if the policy and ownership call for it.
+      void RegisterForDirtyPropertyPublishing();
+
+      struct PublishThreshold
+      {
+         PublishThreshold() : mEpsilon(0.0f) {}
+         float mEpsilon;
+         osg::Vec4d mLastPublished;
+      };
+
 
       std::string mPrototypeName;
       dtCore::UniqueId mPrototypeID;
       GameManager* mParent;
       Ownership* mOwnership;
       LocalActorUpdatePolicy* mLocalActorUpdatePolicy;
+      PropertyPublishPolicy* mPropertyPublishPolicy;
       dtUtil::Log& mLogger;
       std::map<std::string, dtCore::RefPtr<Invokable> > mInvokables;
       std::multimap<const MessageType*, dtCore::RefPtr<Invokable> > mMessageHandlers;
       std::set<dtUtil::RefString> mLocalUpdatePropertyAcceptList;
+      std::map<dtUtil::RefString, PublishThreshold> mPublishThresholds;
       bool mIsInGM;
       bool mPublished;
       bool mRemote;
       bool mDrawableIsAGameActor;
       bool mDeleted;
+      /// True while the actor is in the GameManager's dirty publish list.  Only the GameManager changes this.
+      bool mInDirtyPublishList;
 
    };
 }
@@ -66,6 +66,7 @@ namespace dtABC
 namespace dtGame
 {
    //class Message;
+   class ActorComponent;
    class GMComponent;
    class MapChangeStateData;
    class TickMessage;
@@ -83,6 +84,7 @@ namespace dtGame
       DECLARE_MANAGEMENT_LAYER(GameManager)
 
       friend class GMStatistics;
+      friend class GMComponent;
 
    public:
       static const std::string CONFIG_STATISTICS_INTERVAL;
@@ -230,6 +232,8 @@ namespace dtGame
 
       /**
        * Create actors from a prefab.  It will use the map loaded in the GM or try to fake something.
+       * After the first call, the actors are cloned from the project's prefab template cache
+       * rather than parsed again, see dtCore::Project::SetPrefabCacheEnabled.
        */
       void CreateActorsFromPrefab(const dtCore::ResourceDescriptor&, dtCore::ActorRefPtrVector& actorsOut, bool isRemote = false);
 
@@ -776,6 +780,21 @@ namespace dtGame
        */
       void ChangeMapSet(const NameVector& mapNames, bool addBillboards = false);
 
+      /**
+       * Works like ChangeMapSet, and sends the same messages in the same order, but the new maps are parsed
+       * and their actors created on a dtUtil::ThreadPool IO worker after the old maps are closed.  Once
+       * they are ready, the actors are added to the GM over several frames, at most
+       * GMSettings::GetMapLoadActorsPerFrame each frame, so the application keeps running during the load.
+       * If the thread pool is not initialized, the maps are parsed on the main thread.
+       * @see #ChangeMapSet
+       * @param mapNames      The list of names of maps to load.
+       * @param addBillboards optional parameter that defaults to false that says whether or not proxy billboards should be
+       *                      added to the scene.  This should only be true for debugging purposes.
+       * @throws ExceptionEnum::INVALID_PARAMETER if no map name is supplied.
+       * @throws ExceptionEnum::GENERAL_GAMEMANAGER_EXCEPTION if map change is already in progress.
+       */
+      void ChangeMapSetAsync(const NameVector& mapNames, bool addBillboards = false);
+
       /**
        * Closes the open maps, if any, being used by the Game Manager.  All actors will be deleted whether maps are closed or not.
        *
@@ -1070,6 +1089,32 @@ namespace dtGame
        */
       void UnregisterAllMessageListenersForActor(GameActorProxy& actor);
 
+      /**
+       * Registers an actor component to have its OnTickLocal or OnTickRemote called on the thread pool.
+       * These are run in batches right after the global tick invokables, and any messages sent from the tick
+       * are held and then queued in the order the components were registered, so the result doesn't depend on the threads.
+       * Call ActorComponent::RegisterForTick rather than calling this directly.
+       * @param remote true to register for tick remote, false for tick local.
+       */
+      void RegisterForParallelTick(ActorComponent& component, bool remote);
+
+      /**
+       * The reverse of RegisterForParallelTick.
+       * @param remote the value that was passed to RegisterForParallelTick.
+       */
+      void UnregisterForParallelTick(ActorComponent& component, bool remote);
+
+      /// @return the number of components registered for parallel tick local and remote.
+      unsigned GetNumParallelTickComponents() const;
+
+      /**
+       * Registers a local actor to have GameActorProxy::PublishDirtyProperties called at the end of each tick,
+       * after tick remote and the actor deletes.  Actors that are deleted, go remote, or switch back to
+       * the MANUAL policy are dropped on their own.
+       * Call GameActorProxy::SetPropertyPublishPolicy rather than calling this directly.
+       */
+      void RegisterForDirtyPropertyPublishing(GameActorProxy& actor);
+
       /**
        * @return true if the GameManager is paused
        */
@@ -1170,6 +1215,10 @@ namespace dtGame
       void InvokeGlobalInvokables(const Message& message);
       void InvokeForActorInvokables(const Message& message, GameActorProxy& aboutActor);
       void InvokeOtherActorInvokables(const Message& message);
+      /// Runs the parallel tick components for a tick local or tick remote and queues the messages they sent.
+      void InvokeParallelTickComponents(const Message& message);
+      /// Sends one partial update for each actor registered for dirty property publishing that has changes.
+      void PublishDirtyActorProperties();
 
       /** Removes all actors from the list of deleted actors and returns true if no actors were deleted by other actors.
        * That is, if an actor deletes another actor, messages will be left sitting in the queue, and these messages 
@@ -1184,6 +1233,12 @@ namespace dtGame
       void SwitchActorToLocalOrRemote(GameActorProxy& gameActorProxy, bool local, bool publish);
 
    private:
+      /// Validates the names and starts the map change for ChangeMapSet and ChangeMapSetAsync.
+      void InternalChangeMapSet(const NameVector& mapNames, bool addBillboards, bool async);
+
+      /// Drops the cached per message type component lists.  Called when components or their subscriptions change.
+      void InvalidateComponentDispatch();
+
       GMImpl* mGMImpl; // Pimple pattern for private data
 
       // -----------------------------------------------------------------------
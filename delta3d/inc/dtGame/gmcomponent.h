@@ -23,6 +23,7 @@
 #define DELTA_GMCOMPONENT
 
 #include <string>
+#include <vector>
 #include <dtGame/gamemanager.h>
 #include <dtCore/systemcomponenttype.h>
 #include <dtCore/base.h>
@@ -31,6 +32,7 @@ namespace dtGame
 {
 
    class Message;
+   class MessageType;
 
    class DT_GAME_EXPORT GMComponent : public dtCore::BaseActorObject
    {
@@ -75,6 +77,33 @@ namespace dtGame
        */
       virtual void ProcessMessage(const Message& message);
 
+      /**
+       * Limits ProcessMessage to the given message type.  Call it once for each type the component handles,
+       * typically in the constructor or OnAddedToGM.  A component that never subscribes keeps getting every
+       * message.  The GM caches a dispatch list per message type, so a component that only cares about a few
+       * types is not called for the rest.  DispatchNetworkMessage is not filtered.
+       */
+      void AddMessageSubscription(const MessageType& type);
+
+      /**
+       * Removes a type added with AddMessageSubscription.  Removing the last one puts the
+       * component back to receiving every message.
+       */
+      void RemoveMessageSubscription(const MessageType& type);
+
+      /// Removes all subscriptions so the component receives every message again.
+      void ClearMessageSubscriptions();
+
+      /// @return true if ProcessMessage will be called for messages of the given type.
+      bool IsSubscribedTo(const MessageType& type) const;
+
+      /// @return true if no subscriptions were added, meaning the component receives every message.
+      bool IsSubscribedToAllMessages() const { return mMessageSubscriptions.empty(); }
+
+      typedef std::vector<const MessageType*> MessageTypeList;
+      /// @return the types passed to AddMessageSubscription.  Empty means all messages.
+      const MessageTypeList& GetMessageSubscriptions() const { return mMessageSubscriptions; }
+
       /**
        * Gets the game manager that owns this component
        * @return The game manager
@@ -122,8 +151,11 @@ namespace dtGame
       dtCore::RefPtr<dtCore::SystemComponentType> mType;
 
       dtCore::ObserverPtr<GameManager> mParent;
+      MessageTypeList mMessageSubscriptions;
       bool mInitialized;
 
+      void OnMessageSubscriptionsChanged();
+
       // -----------------------------------------------------------------------
       //  Unimplemented constructors and operators
       // -----------------------------------------------------------------------
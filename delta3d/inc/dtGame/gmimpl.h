@@ -29,6 +29,7 @@
 #include <map>
 
 #include <dtCore/uniqueid.h>
+#include <dtCore/observerptr.h>
 #include <dtCore/timer.h>
 #include <dtGame/gmstatistics.h>
 #include <dtGame/gmsettings.h>
@@ -39,6 +40,7 @@
 #include <dtGame/mapchangestatedata.h>
 #include <dtGame/gmcomponent.h>
 #include <dtGame/environmentactor.h>
+#include <dtGame/timerwheel.h>
 #include <dtCore/scene.h>
 
 #include <dtUtil/hashmap.h>
@@ -52,6 +54,7 @@ namespace dtCore
 namespace dtGame
 {
    class GameActorProxy;
+   class ActorComponent;
 
    // exception class known only to the GM that fires when shutting down to make the GM exit its tick.
    class GMShutdownException
@@ -69,6 +72,20 @@ namespace dtGame
       ~BatchData() {}
    };
 
+   /**
+    * The components that get a message type, in priority order.  It's reference counted so that a dispatch
+    * in progress keeps its list even if a component changes the cache while handling the message.
+    */
+   class ComponentDispatchList : public osg::Referenced
+   {
+   public:
+      ComponentDispatchList() {}
+
+      std::vector<dtCore::RefPtr<GMComponent> > mComponents;
+   protected:
+      ~ComponentDispatchList() {}
+   };
+
    /// A wrapper for data like stats to prevent includes wherever gamemanager.h is used - uses the pimpl pattern (like system)
    class DT_GAME_EXPORT GMImpl
    {
@@ -80,29 +97,13 @@ namespace dtGame
       {
       }
 
-      struct TimerInfo
-      {
-         std::string name;
-         dtCore::UniqueId aboutActor;
-         dtCore::Timer_t time;
-         bool repeat;
-         dtCore::Timer_t interval;
-
-         bool operator < (const TimerInfo& rhs) const
-         {
-            if (time == rhs.time)
-            {
-               return this <& rhs;
-            }
-            return time < rhs.time;
-         }
-      };
-
-      /// Does the work of ClearTimer for each of the timer info sets.
-      void ClearTimerSingleSet(std::set<TimerInfo>& timerSet,
+      typedef TimerWheel::TimerInfo TimerInfo;
+
+      /// Does the work of ClearTimer for each of the timer wheels.
+      void ClearTimerSingleSet(TimerWheel& timers,
                                const std::string& name, const GameActorProxy* proxy);
 
-      void ClearTimersForActor(std::set<TimerInfo>& timerSet, const GameActorProxy& parent);
+      void ClearTimersForActor(TimerWheel& timers, const GameActorProxy& parent);
 
       /**
        * Helper method to process the timers. This is called from PreFrame
@@ -110,7 +111,7 @@ namespace dtGame
        * @param clockTime The time to use
        * @note The clock time should correspond to the list to be processed
        */
-      void ProcessTimers(GameManager& gm, std::set<TimerInfo>& listToProcess, dtCore::Timer_t clockTime);
+      void ProcessTimers(GameManager& gm, TimerWheel& timersToProcess, dtCore::Timer_t clockTime);
 
       /**
        * Removes the proxy from the scene
@@ -137,6 +138,15 @@ namespace dtGame
 
       void ReparentDanglingDrawables(GameManager& gm, dtCore::DeltaDrawable* dd);
 
+      /**
+       * Returns the components that should get messages of the given type, building and caching the list
+       * the first time it's asked for.  Pass NULL for the list of all components, which network dispatch uses.
+       */
+      ComponentDispatchList& GetComponentDispatchList(const MessageType* type);
+
+      /// Clears the dispatch cache so the lists are rebuilt on the next message.
+      void InvalidateComponentDispatch();
+
       typedef dtUtil::HashMap< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> > GameActorMap;
       typedef dtUtil::HashMap< dtCore::UniqueId, dtCore::RefPtr<dtCore::BaseActorObject> > ActorMap;
 
@@ -153,7 +163,9 @@ namespace dtGame
       // the map code can modify game manager with some control.
       //bool mSendCreatesAndDeletes;
       //bool mAddActorsToScene;
-      std::set<TimerInfo> mSimulationTimers, mRealTimeTimers;
+      TimerWheel mSimulationTimers, mRealTimeTimers;
+      /// Reused by ProcessTimers to avoid allocating every tick.
+      std::vector<TimerInfo> mExpiredTimers;
       MessageFactory mFactory;
 
       typedef std::pair<dtCore::RefPtr<GameActorProxy>, std::string> ProxyInvokablePair;
@@ -167,6 +179,18 @@ namespace dtGame
       typedef std::list<dtCore::RefPtr<dtGame::GMComponent> > GMComponentContainer;
       GMComponentContainer mComponentList;
 
+      typedef dtUtil::HashMap<const MessageType*, dtCore::RefPtr<ComponentDispatchList> > ComponentDispatchMap;
+      ComponentDispatchMap mComponentDispatch;
+      dtCore::RefPtr<ComponentDispatchList> mAllComponentsDispatch;
+
+      /// Actor components that are ticked on the thread pool, in registration order.
+      typedef std::vector<dtCore::ObserverPtr<ActorComponent> > ParallelTickList;
+      ParallelTickList mParallelTickLocal;
+      ParallelTickList mParallelTickRemote;
+
+      /// Local actors using the DIRTY_PROPERTIES publish policy, in registration order.
+      std::vector<dtCore::ObserverPtr<GameActorProxy> > mDirtyPublishActors;
+
       std::queue<dtCore::RefPtr<const Message> > mSendNetworkMessageQueue;
       std::queue<dtCore::RefPtr<const Message> > mSendMessageQueue;
 
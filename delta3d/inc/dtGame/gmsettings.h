@@ -65,6 +65,12 @@ namespace dtGame
        */
       DT_DECLARE_ACCESSOR(bool, EditorMode);
 
+      /**
+       * The most map actors GameManager::ChangeMapSetAsync adds to the GM in one frame once the maps are parsed.
+       * 0 means no limit, so all the actors are added in a single frame.  Defaults to 250.
+       */
+      DT_DECLARE_ACCESSOR(unsigned, MapLoadActorsPerFrame);
+
    private:
    };
 
@@ -27,9 +27,15 @@
 
 #include <dtUtil/enumeration.h>
 #include <dtCore/observerptr.h>
+#include <dtCore/refptr.h>
 #include <dtGame/export.h> 
 #include <dtGame/gamemanager.h>
 
+namespace dtCore
+{
+   class Map;
+}
+
 namespace dtGame
 {
    class MessageType;
@@ -76,9 +82,19 @@ namespace dtGame
          void ChangeState(const MapChangeState& newState) { mCurrentState = &newState; }
 
          /**
+         * @param async true to parse the new maps on a thread pool IO worker once the old ones are closed.  When
+         *              they are parsed, the actors are added to the GM a few at a time over several frames.
+         *              The messages are the same either way.
+         * @see GMSettings::GetMapLoadActorsPerFrame
          * @throws dtUtil::Exception with ExceptionEnum::GENERAL_GAMEMANAGER_EXCEPTION if the GameManager has been deleted.
          */
-         void BeginMapChange(const NameVector& oldMapNames, const NameVector& newMapNames, bool addBillboards);
+         void BeginMapChange(const NameVector& oldMapNames, const NameVector& newMapNames, bool addBillboards, bool async = false);
+
+         /// @return true if the map change in progress is loading asynchronously.
+         bool IsAsync() const { return mAsync; }
+
+         /// @return the number of map actors still waiting to be added to the GM by an asynchronous load.
+         unsigned GetNumPendingActors() const { return unsigned(mPendingActors.size() - mNextPendingActor); }
          
           /**
           * @throws dtUtil::Exception with ExceptionEnum::GENERAL_GAMEMANAGER_EXCEPTION if the GameManager has been deleted.
@@ -107,13 +123,46 @@ namespace dtGame
 
       protected:         
 
+         virtual ~MapChangeStateData();
+
          // Opens all of the new maps in the new map vector. Returns true if successful
          bool OpenNewMaps();
 
          // Closes all of the old maps in the old map vector.
          void CloseOldMaps();         
 
+         /// An actor from a map waiting to be added to the GM.
+         struct PendingActor
+         {
+            dtCore::RefPtr<dtCore::BaseActorObject> mActor;
+            bool mIsEnvironment;
+         };
+         typedef std::vector<PendingActor> PendingActorList;
+
+         /// Adds the map's game events to the main game event manager.
+         void AddMapEventsToGM(dtCore::Map& map);
+
+         /// Appends the actors in the map that need to be added to the GM, environment first.
+         void GetActorsToAdd(dtCore::Map& map, PendingActorList& toFill);
+
+         /// Adds actors [begin, end) from the list to the GM in a single batch.
+         void AddActorsToGM(const PendingActorList& actors, size_t begin, size_t end);
+
+         /// Starts parsing the new maps for an asynchronous load.
+         void StartParsingNewMaps();
+
+         /**
+          * The asynchronous version of OpenNewMaps.  It opens the parsed maps in the project and queues their actors.
+          * @return false if the maps are still being parsed or one of them failed, in which case the state goes to IDLE.
+          */
+         bool OpenParsedMaps();
+
+         /// Adds the next set of queued actors.  @return true once all of them are added.
+         bool AddPendingActors();
+
       private:
+         class MapParseTask;
+
          dtCore::ObserverPtr<GameManager> mGameManager;
 
          NameVector mOldMapNames;
@@ -122,6 +171,13 @@ namespace dtGame
          const MapChangeState* mCurrentState;
          bool mAddBillboards;
 
+         bool mAsync;
+         bool mParsedMapsOpened;
+         bool mParseOnMainThread;
+         std::vector<dtCore::RefPtr<MapParseTask> > mParseTasks;
+         PendingActorList mPendingActors;
+         size_t mNextPendingActor;
+
          //disable copy constructor and operator = 
          MapChangeStateData(const MapChangeStateData&) {}
          MapChangeStateData& operator = (const MapChangeStateData&) { return *this; }
@@ -31,6 +31,8 @@
 #include <dtGame/export.h>
 #include <dtGame/message.h>
 #include <dtGame/machineinfo.h>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
 
 namespace dtGame
 {
@@ -153,6 +155,9 @@ namespace dtGame
       private:
          static void ThrowIdException(const MessageType& type);
 
+         /// Guards the type registry, so messages can be created from thread pool tasks.
+         static OpenThreads::Mutex& GetRegistryMutex();
+
          std::string mName, mDescription;
 
          dtCore::RefPtr<const MachineInfo> mMachine;
@@ -166,7 +171,8 @@ namespace dtGame
    template <typename T>
    void MessageFactory::RegisterMessageType(const MessageType& type)
    {
-      if (IsMessageTypeSupported(type))
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(GetRegistryMutex());
+      if (mMessageFactory->IsTypeSupported(&type))
       {
          ThrowIdException(type);
       }
@@ -139,6 +139,7 @@ namespace dtGame
          static const MessageType NETSERVER_REJECT_CONNECTION;
          static const MessageType NETSERVER_SYNC_CONTROL;
          static const MessageType NETSERVER_FRAME_SYNC;
+         static const MessageType NETCLIENT_INTEREST_REGION;
 
          //LOGGER MESSAGES
          static const MessageType LOG_REQ_CHANGESTATE_PLAYBACK;
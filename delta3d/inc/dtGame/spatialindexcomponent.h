@@ -0,0 +1,229 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_SPATIALINDEXCOMPONENT
+#define DELTA_SPATIALINDEXCOMPONENT
+
+#include <dtGame/gmcomponent.h>
+#include <dtCore/uniqueid.h>
+#include <dtCore/observerptr.h>
+#include <dtUtil/functor.h>
+#include <dtUtil/getsetmacros.h>
+#include <dtUtil/hashmap.h>
+
+#include <osg/Vec3>
+#include <osg/BoundingBox>
+
+#include <vector>
+
+namespace dtCore
+{
+   class Transformable;
+}
+
+namespace dtGame
+{
+   class GameActorProxy;
+
+   /**
+    * A GM level spatial index over the translations of all actors in the world that have
+    * a transformable drawable.  The actors are bucketed into a uniform hash grid that is refreshed
+    * from the actor transforms once per TICK_LOCAL, so only actors that cross a cell boundary cost
+    * more than a transform read.
+    *
+    * It answers radius and box queries, and it evaluates registered volumes (see AddVolume)
+    * against the grid each tick, calling back on enter and leave.  Add it with the default name so that
+    * actors like the dtActors::TriggerVolumeActor can find it.
+    */
+   class DT_GAME_EXPORT SpatialIndexComponent : public GMComponent
+   {
+   public:
+      typedef GMComponent BaseClass;
+
+      static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+      static const std::string DEFAULT_NAME;
+
+      enum VolumeEventType
+      {
+         VOLUME_ENTER,
+         VOLUME_LEAVE
+      };
+
+      /// Called with the volume id, the actor that entered or left, and the event type.
+      typedef dtUtil::Functor<void, TYPELIST_3(const dtCore::UniqueId&, GameActorProxy&, VolumeEventType)> VolumeEventFunc;
+
+      typedef std::vector<GameActorProxy*> ActorVector;
+
+      SpatialIndexComponent(dtCore::SystemComponentType& type = *TYPE);
+
+      /**
+       * The edge length of a grid cell in world units.  Queries touch every cell their bounds overlap, so
+       * this should be on the order of the common query radius.  Changing it rebuckets every actor.
+       */
+      DT_DECLARE_ACCESSOR(float, CellSize);
+
+      /// If false, the index will not refresh itself on TICK_LOCAL and the owner must call Update().
+      DT_DECLARE_ACCESSOR(bool, UpdateOnTick);
+
+      void BuildPropertyMap() override;
+
+      void ProcessMessage(const Message& message) override;
+
+      /// Indexes all the actors currently in the GM.
+      void OnAddedToGM() override;
+
+      void OnRemovedFromGM() override;
+
+      /**
+       * Adds an actor to the index.  This is done automatically for actors that enter the world
+       * while the component is in the GM.
+       * @return false if the actor has no transformable drawable or is already indexed.
+       */
+      bool AddActor(GameActorProxy& actor);
+
+      /// Removes an actor from the index and from the occupancy of any volumes.
+      bool RemoveActor(const dtCore::UniqueId& id);
+
+      bool IsActorIndexed(const dtCore::UniqueId& id) const;
+
+      unsigned GetNumIndexedActors() const;
+
+      /**
+       * Gets the translation of an indexed actor as read at the last Update().  This is cheaper
+       * than computing the absolute transform of the actor.
+       * @return false if the actor is not indexed.
+       */
+      bool GetActorPosition(const dtCore::UniqueId& id, osg::Vec3& posOut) const;
+
+      /// Removes all actors and volumes.
+      void Clear();
+
+      /**
+       * Reads the current translation of every indexed actor, moves the ones that changed cells, and
+       * then evaluates the volumes and fires the enter and leave callbacks.
+       */
+      void Update();
+
+      /**
+       * Fills the vector with the actors within the radius of the given point.  This does not clear the vector.
+       * The positions used are the ones read at the last Update().
+       */
+      void FindActorsInRadius(const osg::Vec3& center, float radius, ActorVector& toFill) const;
+
+      /// Fills the vector with the actors inside the box.  This does not clear the vector.
+      void FindActorsInBox(const osg::BoundingBox& box, ActorVector& toFill) const;
+
+      /**
+       * Registers a box volume attached to an actor.  The box is centered on the owner actor's translation,
+       * which is read each Update(), and is axis aligned.  The owner is never reported as an occupant of its own volume.
+       * @param volumeId The id of the owner actor, which is also the volume id.
+       * @param halfExtents half the size of the box on each axis.
+       * @param eventFunc the callback for enter and leave events.
+       * @return false if a volume with that id is already registered.
+       */
+      bool AddVolume(const dtCore::UniqueId& volumeId, const osg::Vec3& halfExtents, VolumeEventFunc eventFunc);
+
+      /// Changes the size of an existing volume.  It is re-evaluated on the next update.
+      void SetVolumeHalfExtents(const dtCore::UniqueId& volumeId, const osg::Vec3& halfExtents);
+
+      /**
+       * Removes a volume.  No leave events are sent for the occupants.
+       * It is safe to call from a volume event, the volume just stops being evaluated until the update ends.
+       */
+      bool RemoveVolume(const dtCore::UniqueId& volumeId);
+
+      unsigned GetNumVolumes() const;
+
+      /// Fills the vector with the ids of the actors in the volume as of the last update.
+      void GetVolumeOccupants(const dtCore::UniqueId& volumeId, std::vector<dtCore::UniqueId>& toFill) const;
+
+   protected:
+      ~SpatialIndexComponent() override;
+
+   private:
+      typedef long long CellKey;
+
+      struct CellKeyHash
+      {
+         size_t operator()(CellKey key) const
+         {
+            // fold the upper bits in so 32 bit size_t still sees all three axes.
+            return size_t(key ^ (key >> 32));
+         }
+      };
+
+      struct Entry
+      {
+         Entry() : mId(false), mCell(0), mIndexInCell(0) {}
+
+         dtCore::UniqueId mId;
+         dtCore::ObserverPtr<GameActorProxy> mActor;
+         dtCore::ObserverPtr<dtCore::Transformable> mTransformable;
+         osg::Vec3 mPosition;
+         CellKey mCell;
+         unsigned mIndexInCell;
+      };
+
+      struct Volume
+      {
+         Volume() : mId(false), mRemoved(false) {}
+
+         dtCore::UniqueId mId;
+         /// Set by RemoveVolume during an update.  The volume is erased when the update is done.
+         bool mRemoved;
+         osg::Vec3 mHalfExtents;
+         VolumeEventFunc mEventFunc;
+         /// Sorted entry ids of the current occupants.
+         std::vector<dtCore::UniqueId> mOccupants;
+      };
+
+      typedef std::vector<unsigned> Cell;
+      typedef dtUtil::HashMap<CellKey, Cell, CellKeyHash> CellMap;
+      typedef dtUtil::HashMap<dtCore::UniqueId, unsigned> IdToIndexMap;
+
+      CellKey CalcCellKey(const osg::Vec3& pos) const;
+      int CalcCellCoord(float value) const;
+      static CellKey PackCellKey(int x, int y, int z);
+
+      void InsertIntoCell(unsigned entryIndex);
+      void RemoveFromCell(unsigned entryIndex);
+      void RemoveEntryAt(unsigned entryIndex);
+      bool ReadPosition(Entry& entry) const;
+      void Rebucket();
+
+      template <typename Pred>
+      void VisitBox(const osg::BoundingBox& box, Pred& pred) const;
+
+      void UpdateVolume(Volume& volume);
+      void EraseRemovedVolumes();
+
+      std::vector<Entry> mEntries;
+      IdToIndexMap mIdToIndex;
+      CellMap mCells;
+      std::vector<Volume> mVolumes;
+      bool mUpdatingVolumes;
+      unsigned mNumRemovedVolumes;
+
+      // reused scratch buffer for the volume evaluation
+      std::vector<dtCore::UniqueId> mScratchOccupants;
+   };
+
+}
+
+#endif // DELTA_SPATIALINDEXCOMPONENT
@@ -0,0 +1,142 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_TIMERWHEEL_H
+#define DELTA_TIMERWHEEL_H
+
+#include <dtGame/export.h>
+#include <dtCore/timer.h>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/hashmap.h>
+
+#include <string>
+#include <vector>
+
+namespace dtGame
+{
+   /**
+    * Holds the named timers of the GameManager in a hierarchical timer wheel.  Timers are bucketed by their due
+    * time, with coarser buckets further out that cascade into the finer ones as the clock reaches them, and each
+    * actor's timers are linked together.  Adding a timer, expiring it, and clearing all the timers of an actor all
+    * take constant amortized time, however many timers are pending.
+    *
+    * All times are in microseconds, the same as the GameManager clocks.
+    */
+   class DT_GAME_EXPORT TimerWheel
+   {
+   public:
+      struct TimerInfo
+      {
+         std::string name;
+         dtCore::UniqueId aboutActor;
+         dtCore::Timer_t time;
+         bool repeat;
+         dtCore::Timer_t interval;
+      };
+
+      /**
+       * @param resolution The width of a bucket on the finest wheel in microseconds.  Timers are still
+       *                   fired in exact time order, this only controls how they are grouped.
+       */
+      TimerWheel(dtCore::Timer_t resolution = 1000);
+
+      /// Adds a timer.  A timer that is already due fires on the next call to Expire.
+      void Add(const TimerInfo& timer);
+
+      /**
+       * Removes every timer that is due at or before the clock time and appends it to expired, ordered by due time.
+       * Repeating timers are added back one interval later, so each one is reported at most once per call.
+       * If the clock moved backward since the last call, the pending timers are re-bucketed around the new time.
+       */
+      void Expire(dtCore::Timer_t clockTime, std::vector<TimerInfo>& expired);
+
+      /**
+       * Removes the timers with the given name.
+       * @param aboutActor If not NULL, only the timers about this actor are removed.
+       */
+      void Clear(const std::string& name, const dtCore::UniqueId* aboutActor);
+
+      /// Removes all the timers about the given actor.
+      void ClearForActor(const dtCore::UniqueId& aboutActor);
+
+      /// Removes all the timers.
+      void Clear();
+
+      /// @return the number of pending timers.
+      unsigned GetSize() const;
+
+      bool IsEmpty() const;
+
+   private:
+      enum
+      {
+         SLOT_BITS = 8,
+         NUM_SLOTS = 1 << SLOT_BITS,
+         NUM_LEVELS = 4,
+         /// Timers further out than the coarsest wheel covers wait in one extra list.
+         OVERFLOW_LIST = NUM_LEVELS * NUM_SLOTS
+      };
+
+      static const unsigned INVALID_INDEX = ~0U;
+
+      struct Node
+      {
+         TimerInfo mInfo;
+         dtCore::Timer_t mTick;
+         unsigned long long mSequence;
+         unsigned mList;
+         unsigned mPrev, mNext;
+         unsigned mActorPrev, mActorNext;
+         bool mActive;
+      };
+
+      unsigned AllocateNode();
+      void FreeNode(unsigned index);
+
+      /// Puts the node in the list that matches its tick relative to the current tick.
+      void Link(unsigned index);
+      void Unlink(unsigned index);
+      void UnlinkActor(unsigned index);
+      void Remove(unsigned index);
+
+      /// Moves the timers on the coarser wheels that reached the current tick down to the finer wheels.
+      void Cascade();
+      void RelinkList(unsigned list);
+      /// Unlinks the due timers in the current bucket of the finest wheel and adds them to mDue.
+      void CollectDue(dtCore::Timer_t clockTime);
+      void Rebase(dtCore::Timer_t tick);
+
+      std::vector<Node> mNodes;
+      std::vector<unsigned> mFreeNodes;
+      std::vector<unsigned> mListHeads;
+      unsigned mLevelCounts[NUM_LEVELS + 1];
+
+      typedef dtUtil::HashMap<dtCore::UniqueId, unsigned> ActorTimerMap;
+      ActorTimerMap mActorTimers;
+
+      std::vector<unsigned> mDue;
+
+      dtCore::Timer_t mResolution;
+      dtCore::Timer_t mCurrentTick;
+      unsigned long long mNextSequence;
+      unsigned mSize;
+   };
+}
+
+#endif // DELTA_TIMERWHEEL_H
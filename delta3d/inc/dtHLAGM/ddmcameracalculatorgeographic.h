@@ -70,7 +70,7 @@ namespace dtHLAGM
          void SetYSubscriptionRange(float range);
          
          /// @return the minimum time between updates.
-         float GetMinTimeBetweenUpdates() const { return mMinTimeBetweenUpdates; }
+         float GetMinTimeBetweenUpdates() const override { return mMinTimeBetweenUpdates; }
          /// sets the minimum time between updates.
          void SetMinTimeBetweenUpdates(float minTime);
          
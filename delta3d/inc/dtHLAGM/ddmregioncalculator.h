@@ -98,6 +98,12 @@ namespace dtHLAGM
           */
          virtual bool UpdateRegionData(DDMRegionData& ddmData) const = 0;
 
+         /**
+          * @return the minimum time, in seconds, between updates of the subscription regions of this calculator.
+          *         The HLAComponent won't call UpdateRegionData more often than this.
+          */
+         virtual float GetMinTimeBetweenUpdates() const { return 0.0f; }
+
          const std::string& GetFirstDimensionName() const { return mFirstDimensionName; }
          void SetFirstDimensionName(const std::string& newName) { mFirstDimensionName = newName; }
 
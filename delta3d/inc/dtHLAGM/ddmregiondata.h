@@ -79,6 +79,20 @@ namespace dtHLAGM
          const DimensionValues* GetDimensionValue(unsigned extent) const;
 
          void ClearDimensions() { mDimensions.clear(); }
+
+         /// Records the current dimension values as the extents last sent to the RTI.
+         void MarkCommitted() { mCommittedDimensions = mDimensions; }
+
+         /// Forgets the committed extents, so the next change will always be sent to the RTI.
+         void ClearCommitted() { mCommittedDimensions.clear(); }
+
+         /**
+          * @return the largest amount any min or max extent has moved since the last commit, or
+          *         the maximum unsigned int if the number or names of the dimensions differ from the committed ones,
+          *         including when nothing was ever committed, i.e. the region can't be modified in place.
+          */
+         unsigned int GetChangeSinceCommit() const;
+
       protected:
          virtual ~DDMRegionData() {};
          
@@ -86,6 +100,7 @@ namespace dtHLAGM
          //Note that this region must be deleted by the RTI.
          dtCore::RefPtr<RTIRegion> mRegion;
          std::vector<DimensionValues> mDimensions;
+         std::vector<DimensionValues> mCommittedDimensions;
    };
 }
 
@@ -203,6 +203,23 @@ namespace dtHLAGM
           * @throws dtUtil::Exception if component is connected to a federation.
           */
          void SetDDMEnabled(bool enable);
+
+         /**
+          * Sets how far any bound of a subscription region must move from the extents last sent to the RTI
+          * before the region is modified again, as a fraction of the full DDM extent range.  This keeps small
+          * camera movements from generating region traffic.  It defaults to 0, which sends every change.
+          */
+         void SetDDMRegionUpdateThreshold(double fraction);
+         /// @return how far a subscription region must move, as a fraction of the extent range, before it is sent to the RTI.
+         double GetDDMRegionUpdateThreshold() const;
+
+         /**
+          * Sets the minimum time, in seconds, between updates of the subscription regions of any one calculator.
+          * If a calculator has its own minimum time, the larger of the two is used.  It defaults to 0.
+          */
+         void SetDDMMinTimeBetweenRegionUpdates(double seconds);
+         /// @return the minimum time, in seconds, between updates of the subscription regions of any one calculator.
+         double GetDDMMinTimeBetweenRegionUpdates() const;
          
          virtual void DiscoverObjectInstance(RTIObjectInstanceHandle& theObject,
                                              RTIObjectClassHandle& theObjectClassHandle,
@@ -415,13 +432,24 @@ namespace dtHLAGM
 
       protected:
 
-         /// Calls all of the subscription calculators to update their regions.
-         void UpdateDDMSubscriptions();
+         /**
+          * Calls the subscription calculators that are due to update their regions, and modifies the regions
+          * that moved past the update threshold.
+          * @param currentTime the real time, in seconds, used to rate limit the updates.
+          */
+         void UpdateDDMSubscriptions(double currentTime);
          void CreateDDMSubscriptionRegions();
          void DestroyDDMSubscriptionRegions();
 
+         /**
+          * Sends the extents of the region data to the RTI, modifying the existing region in place if it
+          * has the same dimensions, otherwise creating a new one.
+          */
          void UpdateRegion(DDMRegionData& regionData);
 
+         /// @return the dimension handle for the given name, only asking the RTI the first time it is requested.
+         RTIDimensionHandle& GetDDMDimensionHandle(const std::string& name);
+
          /**
           * Prepares the interaction parameters for an interaction.  This may be overridden in a subclass
           * to do one-off translations of outgoing data.
@@ -650,6 +678,11 @@ namespace dtHLAGM
          DDMRegionCalculatorGroup mDDMPublishingCalculators;
 
          std::vector<std::vector<dtCore::RefPtr<DDMRegionData> > > mDDMSubscriptionRegions;
+         /// The time each subscription calculator may next update its regions, indexed like the regions.
+         std::vector<double> mDDMNextUpdateTimes;
+         std::map<std::string, dtCore::RefPtr<RTIDimensionHandle> > mDDMDimensionHandles;
+         double mDDMRegionUpdateThreshold;
+         double mDDMMinTimeBetweenRegionUpdates;
 
          std::vector<dtCore::RefPtr<ParameterTranslator> > mParameterTranslators;
 
@@ -23,6 +23,7 @@
 
 #include <dtNetGM/export.h>
 #include <dtNetGM/networkcomponent.h>
+#include <osg/Vec3>
 
 /// @cond DOXYGEN_SHOULD_SKIP_THIS
 namespace OpenThreads
@@ -140,6 +141,17 @@ namespace dtNetGM
        */
       void SendRequestConnectionMessage();
 
+      /**
+       * Tells the server which area this client needs full rate actor updates for.  Partial updates
+       * about actors outside of it are throttled by the server.  Call it again as the viewpoint moves.
+       * @param position center of the region, normally the camera position.
+       * @param radius radius of the region.  0 or less asks for all updates again.
+       * @param viewDirection if not zero, the region is limited to a cone around this direction, like a view frustum.
+       * @param viewHalfAngle half the angle of the cone in degrees, normally half of the wider field of view.
+       */
+      void SendInterestRegion(const osg::Vec3& position, float radius,
+               const osg::Vec3& viewDirection = osg::Vec3(), float viewHalfAngle = 180.0f);
+
       /// Overridden. Uses a mutex and adds message to the input buffer. Also checks for specific message types. 
       virtual void AddMessageToInputBuffer(const dtGame::Message& message);
 
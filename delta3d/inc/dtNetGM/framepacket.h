@@ -0,0 +1,117 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_FRAMEPACKET
+#define DELTA_FRAMEPACKET
+
+#ifdef _MSC_VER
+#pragma warning ( disable : 4275 )
+#endif
+
+#include <dtNetGM/export.h>
+#include <dtNetGM/datastreampacket.h>
+#include <gnelib.h>
+
+namespace dtNetGM
+{
+   /**
+    * @class FramePacket
+    * @brief A FramePacket holds several small serialized messages so they go out as one network packet.
+    *
+    * Each message in the payload is stored as a 2 byte little endian size followed by the message data.
+    * Frames on the sequenced channel carry a sequence number so the receiver can drop the values in them
+    * that a newer frame already set.  Frames on the reliable channel are always delivered in order.
+    */
+   class DT_NETGM_EXPORT FramePacket : public GNE::Packet
+   {
+   public:
+      // pointer used by GNE
+      typedef GNE::SmartPtr<FramePacket> sptr;
+      // pointer used by GNE
+      typedef GNE::WeakPtr<FramePacket> wptr;
+
+      /// Same limit as the DataStreamPacket so a frame always fits in one GNE raw packet.
+      static const int MAX_PAYLOAD = DataStreamPacket::MAX_PAYLOAD;
+
+      /// The largest single message that can be added to a frame.
+      static const int MAX_ENTRY_SIZE = MAX_PAYLOAD - 2;
+
+      /// ID used by GNE to identify the FramePacket.
+      static const int ID = GNE::PacketParser::MIN_USER_ID + 2;
+
+      /// Constructor
+      FramePacket();
+
+      /// Copy constructor, used by the GNE::PacketParser.
+      FramePacket(const FramePacket& framePacket);
+
+      /// Destructor, public for GNE......
+      virtual ~FramePacket();
+
+      /// Writes a FramePacket into a packet stream, used by GNE::PacketParser
+      virtual void writePacket(GNE::Buffer& raw) const;
+
+      /// Reads a FramePacket from a packet stream, used by GNE::PacketParser
+      virtual void readPacket(GNE::Buffer& raw);
+
+      /// Gets the size of the FramePacket, used by GNE::PacketParser
+      virtual int getSize() const;
+
+      /**
+       * Appends a serialized message to the frame.
+       * @return false if it does not fit in the space left.
+       */
+      bool AddEntry(const char* data, unsigned size);
+
+      /**
+       * Reads the entry starting at the given offset into the payload.
+       * @param offset in: offset of the entry, out: offset of the next entry.
+       * @param data set to the start of the entry data.
+       * @param size set to the size of the entry.
+       * @return false if there are no more entries or the frame is malformed.
+       */
+      bool ReadEntry(unsigned& offset, const char*& data, unsigned& size) const;
+
+      /// Removes all entries
+      void Clear();
+
+      bool IsEmpty() const { return mPayloadSize == 0; }
+      unsigned GetNumEntries() const { return unsigned(mNumEntries); }
+      unsigned GetPayloadSize() const { return unsigned(mPayloadSize); }
+
+      void SetSequence(GNE::guint16 sequence) { mSequence = sequence; }
+      unsigned GetSequence() const { return unsigned(mSequence); }
+
+      /// @return true if sequence comes after lastSequence, allowing for the 16 bit sequence wrapping around.
+      static bool IsNewerSequence(unsigned sequence, unsigned lastSequence);
+
+      void SetSequenced(bool sequenced) { mSequenced = sequenced ? 1 : 0; }
+      bool IsSequenced() const { return mSequenced != 0; }
+
+   private:
+      GNE::guint16 mSequence; // increases by one for each sequenced frame sent on a connection
+      GNE::guint8 mSequenced; // 1 if the frame was sent on the sequenced channel
+      GNE::guint8 mNumEntries; // number of messages in the payload
+      GNE::guint16 mPayloadSize; // payloadsize of this packet
+
+      GNE::gbyte mPayloadBuffer[MAX_PAYLOAD]; // dataBuffer
+   };
+}
+
+#endif // DELTA_FRAMEPACKET
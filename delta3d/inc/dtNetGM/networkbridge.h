@@ -35,11 +35,18 @@
 #include <dtCore/base.h>
 #include <dtUtil/datastream.h>
 #include <dtGame/machineinfo.h>
+#include <dtUtil/hashmap.h>
+#include <dtUtil/refstring.h>
+#include <dtNetGM/framepacket.h>
+#include <OpenThreads/Mutex>
+#include <map>
+#include <vector>
 
 // Forward declaration
 namespace dtGame
 {
    class Message;
+   class ActorUpdateMessage;
 }
 
 namespace dtNetGM
@@ -54,6 +61,8 @@ namespace dtNetGM
    class  DT_NETGM_EXPORT NetworkBridge : public dtCore::Base
    {
    public:
+      typedef std::vector<dtCore::RefPtr<dtGame::Message> > MessageVector;
+
       // Constructor
       NetworkBridge(NetworkComponent* networkComp);
 
@@ -107,6 +116,59 @@ namespace dtNetGM
        */
       void SendDataStream(dtUtil::DataStream& dataStream, bool allowBestEffort);
 
+      /**
+       * Adds a DataStream to the frame being built for this connection.  Frames are written when they are full
+       * or when FlushFrames is called, so many small messages share one packet.  DataStreams too big for a frame
+       * are sent right away with SendDataStream, after flushing the reliable frame to keep them in order.
+       * @param dataStream the serialized message.
+       * @param sequenced true to send it on the sequenced channel, which is unreliable if the connection has an
+       *                  unreliable socket.  The receiver drops the values in it that a newer frame already set.
+       */
+      void QueueDataStream(dtUtil::DataStream& dataStream, bool sequenced);
+
+      /// Writes any partially filled frames.
+      void FlushFrames();
+
+      /// @return the total number of payload bytes sent on this connection.
+      unsigned long long GetNumBytesSent() const;
+
+      /// @return the number of data streams, i.e. messages, sent on this connection.
+      unsigned long long GetNumDataStreamsSent() const;
+
+      /// @return the number of frames sent on this connection.
+      unsigned long long GetNumFramesSent() const;
+
+      /// @return the number of actor updates received on the sequenced channel that were dropped because newer values had arrived.
+      unsigned long long GetNumStaleUpdatesDropped() const;
+
+      /// @return the number of partial actor updates received on the sequenced channel before the actor's create.
+      unsigned long long GetNumUpdatesHeld() const;
+
+      /// Handles a frame received from the connection.  Called by OnReceive on the receive thread.
+      void ReceiveFrame(const FramePacket& frame);
+
+      /**
+       * Puts an actor message received on this connection in order with the others about the same actor.
+       * Called on the receive thread before the message is delivered.
+       * Updates from the sequenced channel lose the properties that an update in a newer frame already set,
+       * and partial ones are dropped if nothing is left.  Partial updates about an actor whose create or full update
+       * has not arrived are held, since it may still be on its way on the reliable channel.  A delete discards them.
+       * @param message the received message.  Stale properties are removed from it.
+       * @param sequence the sequence of the frame the message arrived in, or 0 if it came on the reliable channel.
+       * @param released filled with held updates that can now be delivered after the message, oldest first.
+       * @return true if the message should be delivered now.
+       */
+      bool SequenceReceivedMessage(dtGame::Message& message, unsigned long long sequence, MessageVector& released);
+
+      /// Discards what has been received about an actor, including held updates.  Called when the actor is deleted.
+      void ForgetReceivedActor(const dtCore::UniqueId& actorId);
+
+      /// Discards what has been received about all actors.  Called when the connection drops.
+      void ClearReceivedActors();
+
+      /// @return the number of actors this connection is keeping received state for.
+      size_t GetNumReceivedActors() const;
+
       /**
        * Disconnects the current connection
        */
@@ -175,7 +237,30 @@ namespace dtNetGM
        */
       std::string GetHostDescription();
 
+   protected:
+      /**
+       * Writes a packet to the GNE connection.
+       * @param reliable false to let it go on the unreliable socket.
+       * @return false if there is no connection to write to.
+       */
+      virtual bool WritePacket(const GNE::Packet& packet, bool reliable);
+
    private:
+      /// What has been received on this connection about one actor.
+      struct ReceivedActorState
+      {
+         ReceivedActorState() : mCreated(false) {}
+
+         /// true once a create or full update for the actor has arrived.
+         bool mCreated;
+         /// The sequence of the newest frame that set each property.
+         std::map<dtUtil::RefString, unsigned long long> mPropertySequences;
+         /// Partial updates that arrived before the create, oldest first.
+         std::vector<dtCore::RefPtr<dtGame::ActorUpdateMessage> > mHeldUpdates;
+      };
+
+      typedef dtUtil::HashMap<dtCore::UniqueId, ReceivedActorState> ReceivedActorMap;
+
       dtCore::RefPtr<NetworkComponent> mNetworkComponent; ///Reference to our NetworkComponent
       dtCore::RefPtr<dtGame::MachineInfo> mMachineInfo; // MachineInfo of the remote GameManager
 
@@ -184,6 +269,33 @@ namespace dtNetGM
 
       unsigned int mLastStream;
       dtUtil::DataStream mDataStream;
+
+      // Send statistics.  Sends can happen on both the dispatch thread and the receive thread.
+      mutable OpenThreads::Mutex mStatsMutex;
+      unsigned long long mNumBytesSent;
+      unsigned long long mNumDataStreamsSent;
+      unsigned long long mNumFramesSent;
+      unsigned long long mNumStaleUpdatesDropped;
+      unsigned long long mNumUpdatesHeld;
+
+      // Frames being filled on the sending thread.
+      OpenThreads::Mutex mFrameMutex;
+      FramePacket mReliableFrame;
+      FramePacket mSequencedFrame;
+      GNE::guint16 mNextSequence;
+
+      // Filled on the receive thread, purged on the dispatch thread when actors are deleted.
+      mutable OpenThreads::Mutex mReceivedMutex;
+      /// The newest sequence received, extended past 16 bits so it never wraps.
+      unsigned long long mNewestReceivedSequence;
+      ReceivedActorMap mReceivedActors;
+
+      /// Writes the frame to the connection if it has anything in it, then clears it.
+      void WriteFrame(FramePacket& frame);
+
+      /// @return true if the connection has an unreliable socket for packets that allow best effort delivery.
+      bool HasUnreliableSocket() const;
+
       /**
        * Sets the timestamp of the machineinfo to the current time
        */
@@ -56,6 +56,7 @@ namespace dtGame
    class NetServerRejectMessage;
    class ServerMessageRejected;
    class MachineInfoMessage;
+   class ClientInterestRegionMessage;
 }
 
 namespace dtNetGM
@@ -123,6 +124,20 @@ namespace dtNetGM
       DT_DECLARE_ACCESSOR(int, GameVersion);
       DT_DECLARE_ACCESSOR(std::string, GNELogFile);
 
+      /**
+       * If true, outgoing messages are packed into frames per connection and sent once per tick
+       * instead of as one or more packets each.  Peers that predate frames can't read them.  Default is false.
+       */
+      DT_DECLARE_ACCESSOR(bool, CoalesceMessages);
+
+      /**
+       * If true, and CoalesceMessages is true, actor updates go on a sequenced channel that is unreliable when the
+       * connection has an unreliable socket.  Only the newest update per actor and set of properties queued in a tick
+       * is sent, and the receiver drops the values in them that a newer frame already set.  Creates, deletes and
+       * all other messages stay on the reliable channel.  Default is false.
+       */
+      DT_DECLARE_ACCESSOR(bool, SequencedActorUpdates);
+
       /**
        * Called immediately after a component is added to the GM. Used to register
        * 'additional' Network Messages on the GameManager
@@ -206,6 +221,12 @@ namespace dtNetGM
        */
       virtual void ProcessNetServerRejectMessage(const dtGame::ServerMessageRejected& msg) { };
 
+      /**
+       * Processes a MessageType::NETCLIENT_INTEREST_REGION Message.
+       * @param msg The message
+       */
+      virtual void ProcessNetClientInterestRegion(const dtGame::ClientInterestRegionMessage& msg) { };
+
       /**
        * Sets the connection Parameters to be used by GNE
        * @param reliable The reliability of the connection
@@ -283,8 +304,9 @@ namespace dtNetGM
        * contained in the message. If appropriate, the message is delivered to the GameManager
        * @param networkBridge The NetworkBridge which received the MessagePakcet
        * @param dataStream The DataStream received
+       * @param sequence The sequence of the frame it arrived in, or 0 if it came on the reliable channel.
        */
-      virtual void OnReceivedDataStream(NetworkBridge& networkBridge, dtUtil::DataStream& dataStream);
+      virtual void OnReceivedDataStream(NetworkBridge& networkBridge, dtUtil::DataStream& dataStream, unsigned long long sequence = 0);
 
       virtual void OnReceivedNetworkMessage(const dtGame::Message& message, NetworkBridge& networkBridge);
 
@@ -409,6 +431,9 @@ namespace dtNetGM
        */
       void SetFrameSyncMaxWaitTime(float newValue);
 
+      /// @return the number of actor updates that were not sent because a newer one for the same properties was queued in the same tick.
+      unsigned long long GetNumStaleUpdatesDropped() const;
+
    private:
       static bool mGneInitialized; // bool indicating GNE initialization
 
@@ -445,6 +470,12 @@ namespace dtNetGM
        */
       void RemoveConnection(const dtGame::MachineInfo& machineInfo);
 
+      /**
+       * Discards what every connection has received about an actor.
+       * @param actorId the id of the deleted actor
+       */
+      void ForgetReceivedActor(const dtCore::UniqueId& actorId);
+
       /**
        * Retrieves a NetworkBridge from the map
        * If no networkbridge is found, NULL is returned
@@ -471,6 +502,25 @@ namespace dtNetGM
 
       void SendNetworkMessage(const dtGame::Message& message, const DestinationType& destinationType = DestinationType::DESTINATION);
 
+      /// Like SendNetworkMessage, but adds the message to the frames of the connections.  Call FlushFrames to send them.
+      void QueueNetworkMessage(const dtGame::Message& message, const DestinationType& destinationType = DestinationType::DESTINATION);
+
+      /// Writes the partially filled frames of all connections.
+      void FlushFrames();
+
+      /**
+       * Removes actor updates from the buffer that are followed by a newer update to the same actor
+       * with the same set of properties.  Called on the sending thread.
+       */
+      void DropStaleActorUpdates(MessageBufferType& messages);
+
+      /**
+       * Called for each connected client before a message without a specific destination is sent or forwarded to it.
+       * This is called on the sending thread, not the main thread.
+       * @return false to skip sending the message to the given connection.  The default always returns true.
+       */
+      virtual bool ShouldSendToConnection(const dtGame::Message& message, NetworkBridge& networkBridge) { return true; }
+
       /// When the tick is over, we force a final send. The subclasses might also do work.  
       virtual void DoEndOfTick();
 
@@ -506,6 +556,9 @@ namespace dtNetGM
 
       std::set<short> mUnknownMessages;
 
+      /// Does the work of both SendNetworkMessage and QueueNetworkMessage
+      void SendOrQueueNetworkMessage(const dtGame::Message& message, const DestinationType& destinationType, bool queue);
+
       dtCore::RefPtr<dtUtil::ThreadPoolTask> mDispatchTask;
       bool mMapChangeInProcess;
 
@@ -518,6 +571,8 @@ namespace dtNetGM
       float mFrameSyncMaxWaitTime; // how long should the client wait to get a frame sync
       bool mFrameSyncValuesAreDirty; // tracks if the frame sync values have changed
 
+      unsigned long long mNumStaleUpdatesDropped; // only written on the sending thread, guarded by mMutex
+
    };
 }
 #endif // DELTA_NETWORKCOMPONENT
@@ -23,10 +23,19 @@
 
 #include <dtGame/message.h>
 #include <dtGame/machineinfo.h>
+#include <dtCore/timer.h>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/getsetmacros.h>
+#include <dtUtil/hashmap.h>
+#include <dtUtil/refstring.h>
 
 #include <dtNetGM/export.h>
 #include <dtNetGM/networkcomponent.h>
 
+#include <osg/Vec3>
+#include <map>
+#include <set>
+
 
 namespace dtGame
 {
@@ -46,6 +55,8 @@ namespace dtNetGM
       static const dtUtil::RefString CONFIG_PROP_FRAMESYNC_ISENABLED;
       static const dtUtil::RefString CONFIG_PROP_FRAMESYNC_NUMPERSECOND;
       static const dtUtil::RefString CONFIG_PROP_FRAMESYNC_MAXWAITTIME;
+      // Interest management config property.  Call the Set AFTER adding to the GM to override it.
+      static const dtUtil::RefString CONFIG_PROP_OUT_OF_INTEREST_UPDATE_INTERVAL;
 
       typedef NetworkComponent BaseClass;
 
@@ -70,6 +81,37 @@ namespace dtNetGM
        */
       void SendFrameSyncControlMessage();
 
+      /**
+       * Minimum number of seconds between partial actor updates sent to a client about an actor outside
+       * of that client's interest region.  Full updates, creates and deletes are always sent.  Property values
+       * that were filtered out are sent at this rate, or as soon as the actor comes back into the region.
+       * 0 or less means they are only sent when the actor comes back into the region.  Default is 1 second.
+       */
+      DT_DECLARE_ACCESSOR(float, OutOfInterestUpdateInterval);
+
+      /**
+       * Sets the area a client needs full rate actor updates for.  This is normally set by the client
+       * sending a ClientInterestRegionMessage.
+       * @param client the client machine.
+       * @param position center of the region.
+       * @param radius radius of the region.  0 or less removes the region so the client gets all updates.
+       *               Property values filtered out before the region changed are sent at the end of the tick.
+       * @param viewDirection if not zero, only actors within viewHalfAngle of this direction from the position,
+       *                      and within the radius, are in the region.  It approximates the client's view frustum.
+       * @param viewHalfAngle half the angle of the view cone in degrees.  180 or more makes the region the whole sphere.
+       */
+      void SetClientInterestRegion(const dtGame::MachineInfo& client, const osg::Vec3& position, float radius,
+               const osg::Vec3& viewDirection = osg::Vec3(), float viewHalfAngle = 180.0f);
+
+      /// @return the number of clients the server is keeping an interest region for.
+      unsigned GetNumClientInterestRegions() const;
+
+      /// @return the number of partial actor updates that were not sent to a client because of interest management.
+      unsigned long long GetNumUpdatesFiltered() const;
+
+      /// @return the total bytes sent to all connected clients.
+      unsigned long long GetNumBytesSentToClients();
+
    protected:
       // Destructor
       ~ServerNetworkComponent(void);
@@ -114,6 +156,18 @@ namespace dtNetGM
       /// Overridden to handle config properties.
       virtual void OnAddedToGM();
 
+      /// Overridden to track the positions of published actors.
+      virtual void ProcessMessage(const dtGame::Message& message);
+
+      /// Overridden to track the positions of published actors.
+      virtual void DispatchNetworkMessage(const dtGame::Message& message);
+
+      /**
+       * Processes a MessageType::NETCLIENT_INTEREST_REGION Message.
+       * @param msg The message
+       */
+      virtual void ProcessNetClientInterestRegion(const dtGame::ClientInterestRegionMessage& msg);
+
    protected:
 
       // should we accept new clients
@@ -138,6 +192,56 @@ namespace dtNetGM
        * @param machineInfo The MachineInfo of the new client
        */
       virtual void SendConnectedClientMessage(const dtGame::MachineInfo& machineInfo);
+
+      /// Filters partial actor updates based on the interest region of the client.
+      virtual bool ShouldSendToConnection(const dtGame::Message& message, NetworkBridge& networkBridge);
+
+      /// Records the current position of the actor the message is about, or forgets it if the actor was deleted.
+      void UpdatePublishedActorPosition(const dtGame::Message& message);
+
+      /**
+       * Creates partial updates addressed to each client with the current values of the properties
+       * ShouldSendToConnection filtered out, for the actors that are back in the client's region or whose
+       * OutOfInterestUpdateInterval has passed.  Called from DoEndOfTick.
+       * @param toFill the updates are added to the end of this.
+       */
+      void CreateFilteredPropertyUpdates(MessageBufferType& toFill);
+
+      /// Forgets the region of a client and what was filtered for it.  Called when the client disconnects.
+      void RemoveClientInterestRegion(const dtGame::MachineInfo& client);
+
+   private:
+      typedef std::set<dtUtil::RefString> PropertyNameSet;
+      typedef dtUtil::HashMap<dtCore::UniqueId, PropertyNameSet> FilteredPropertyMap;
+
+      struct ClientInterestRegion
+      {
+         ClientInterestRegion() : mRadius(0.0f), mCosViewHalfAngle(-1.0f) {}
+
+         /// @return true if the position is inside the sphere and, if there is one, the view cone.
+         bool Contains(const osg::Vec3& pos) const;
+
+         dtCore::RefPtr<const dtGame::MachineInfo> mClient;
+         osg::Vec3 mPosition;
+         /// 0 or less means the region was removed and is only kept until its filtered properties are sent.
+         float mRadius;
+         /// Normalized, or zero if the region has no view cone.
+         osg::Vec3 mViewDirection;
+         float mCosViewHalfAngle;
+         /// When the last partial update about each actor outside of the region was sent.
+         dtUtil::HashMap<dtCore::UniqueId, dtCore::Timer_t> mLastOutOfInterestSend;
+         /// The properties of each actor whose values were filtered out since they were last sent.
+         FilteredPropertyMap mFilteredProperties;
+      };
+
+      typedef std::map<dtCore::UniqueId, ClientInterestRegion> ClientInterestMap;
+      typedef dtUtil::HashMap<dtCore::UniqueId, osg::Vec3> ActorPositionMap;
+
+      // Written on the main thread, read on the sending threads.
+      mutable OpenThreads::Mutex mInterestMutex;
+      ClientInterestMap mClientInterest;
+      ActorPositionMap mPublishedActorPositions;
+      unsigned long long mNumUpdatesFiltered;
    };
 }
 
@@ -0,0 +1,113 @@
+/* -*-c++-*-
+ * dtPhysics
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#ifndef DTPHYSICS_COOKEDMESHCACHE_H_
+#define DTPHYSICS_COOKEDMESHCACHE_H_
+
+#include <dtPhysics/physicsexport.h>
+#include <dtPhysics/physicstypes.h>
+#include <string>
+
+namespace osg
+{
+   class Node;
+}
+
+namespace dtPhysics
+{
+   class VertexData;
+
+   /**
+    * A cache on local disk for cooked physics meshes, that is, the triangle data recorded from a model and, for
+    * convex hulls, the hull built from it.  Entries are keyed on a hash of the source geometry and the cooking
+    * parameters, so a changed model or parameter just maps to a different entry and old entries are never read.
+    * The cache is off until a directory is set, either here or with PhysicsWorld::CONFIG_COOKED_MESH_CACHE_DIRECTORY.
+    */
+   class DT_PHYSICS_EXPORT CookedMeshCache
+   {
+   public:
+      /// Increment this when the triangle recorder or convex hull output changes so that existing entries are not used.
+      static const unsigned COOKING_VERSION = 1;
+
+      static const std::string FILE_EXTENSION;
+
+      /**
+       * Sets the directory to keep the cooked meshes in.  It is created on the first save if it doesn't exist.
+       * @param dir the cache directory.  Empty turns the cache off.
+       */
+      static void SetDirectory(const std::string& dir);
+
+      /// @return the cache directory, or empty if the cache is off.
+      static std::string GetDirectory();
+
+      /// @return true if a cache directory has been set.
+      static bool IsEnabled();
+
+      /**
+       * Hashes the vertices, primitives, transforms, and descriptions the TriangleRecorder reads under the node
+       * along with the cooking parameters.  This is much cheaper than recording the triangles.
+       * @param node the root of the model to hash.
+       * @param polytope true if the data will be converted to a convex hull.
+       * @param maxEdgeLength the max triangle edge length given to the TriangleRecorder.
+       * @return the cache key.
+       */
+      static std::string ComputeKey(const osg::Node& node, bool polytope, Real maxEdgeLength);
+
+      /**
+       * Computes the key for a model or compiled physics file.  Models are read through osgDB and hashed with
+       * ComputeKey, so the files they load, such as ProxyNode children, are part of the key.  Compiled physics
+       * files don't reference other files, so their bytes are hashed along with the cooking parameters.
+       * @return the cache key, or empty if the file could not be read.
+       */
+      static std::string ComputeKeyForFile(const std::string& fileName, bool polytope, Real maxEdgeLength);
+
+      /// @return the path of the cache file for the given key.
+      static std::string GetFilePath(const std::string& key);
+
+      /**
+       * Loads a cooked mesh.
+       * @param key the key from ComputeKey or ComputeKeyForFile.
+       * @param dataOut the data to fill.  It is only changed if the entry is found.
+       * @return true if the entry was found and loaded.
+       */
+      static bool Load(const std::string& key, VertexData& dataOut);
+
+      /**
+       * Saves a cooked mesh.  The data should not have been scaled.  Failures are logged but otherwise ignored
+       * because the mesh can always be cooked again.
+       * @return true if the entry was written.
+       */
+      static bool Save(const std::string& key, const VertexData& data);
+
+      /**
+       * Loads the triangle data from a model or compiled physics file, converting it to a convex hull if requested.
+       * If the cache is on, the cooked data is read from the cache when the file is unchanged, and saved to it otherwise.
+       * @return false if the file could not be loaded.
+       */
+      static bool LoadFile(const std::string& fileName, bool polytope, VertexData& dataOut);
+
+   private:
+      CookedMeshCache();
+   };
+}
+
+#endif /* DTPHYSICS_COOKEDMESHCACHE_H_ */
@@ -124,6 +124,8 @@ namespace dtPhysics
       static const std::string CONFIG_TICKS_PER_SECOND;
       static const std::string CONFIG_DEBUG_DRAW_RANGE;
       static const std::string CONFIG_PRINT_ENGINE_PROPERTY_DOCUMENTATION;
+      /// The directory for the CookedMeshCache.  The cache is off if this isn't set.
+      static const std::string CONFIG_COOKED_MESH_CACHE_DIRECTORY;
 
    public:
       /**
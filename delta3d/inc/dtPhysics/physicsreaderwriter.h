@@ -49,6 +49,12 @@ namespace dtPhysics
           */
          static bool LoadTriangleDataFile(VertexData& triangleData, const std::string& filename);
 
+         /**
+          * Loads a compiled physics file directly rather than through osgDB, so the result is never a cached object
+          * and a renderable mesh file is never loaded instead.
+          */
+         static bool LoadCompiledTriangleDataFile(VertexData& triangleData, const std::string& filename);
+
          /**
           * Saves a simple triangle buffer to file for quick reloading for the physics.
           */
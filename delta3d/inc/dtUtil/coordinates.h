@@ -571,6 +571,45 @@ namespace dtUtil
          static void ConvertLatLonToFlatEarth(osg::Vec3d& xyz, const osg::Vec3d& lle, const osg::Vec2d& originll, double convergenceParam);
          static void ConvertFlatEarthToLatLon(osg::Vec3d& lle, const osg::Vec3d& xyz, const osg::Vec2d& originll, double convergenceParam);
 
+         /**
+          * @name Batch conversions
+          * Array versions of the conversions above for converting large numbers of points at once.
+          * Each component is passed as its own array of count values.  An output array may be the same
+          * as the input array it replaces.  The transverse mercator parameters for each UTM zone are computed
+          * once and shared, and the math is arranged to need far fewer trig calls per point.
+          * If useThreadPool is true and the dtUtil::ThreadPool is initialized, large batches are split across
+          * the worker threads, unless it is called from a worker.  The results match the single point versions to within floating point rounding.
+          */
+         ///@{
+         /// @see ConvertGeocentricToGeodetic.  Latitude and longitude are in radians.
+         static void ConvertGeocentricToGeodeticBatch(const double* x, const double* y, const double* z,
+                  double* phi, double* lambda, double* elevation, unsigned count, bool useThreadPool = false);
+
+         /// @see GeodeticToGeocentric.  Latitude and longitude are in radians.
+         static void GeodeticToGeocentricBatch(const double* phi, const double* lambda, const double* elevation,
+                  double* x, double* y, double* z, unsigned count, bool useThreadPool = false);
+
+         /// @see ConvertGeodeticToUTM.  Latitude and longitude are in radians.
+         static void ConvertGeodeticToUTMBatch(const double* latitude, const double* longitude, unsigned zone, char hemisphere,
+                  double* easting, double* northing, unsigned count, bool useThreadPool = false);
+
+         /// @see ConvertUTMToGeodetic.  Latitude and longitude are in radians.
+         static void ConvertUTMToGeodeticBatch(unsigned zone, char hemisphere, const double* easting, const double* northing,
+                  double* latitude, double* longitude, unsigned count, bool useThreadPool = false);
+
+         /// @see ConvertLatLonToFlatEarth.  Latitude and longitude are in degrees.  Elevation passes through unchanged, so it isn't taken.
+         static void ConvertLatLonToFlatEarthBatch(const double* latitude, const double* longitude, const osg::Vec2d& originll,
+                  double convergenceParam, double* x, double* y, unsigned count);
+         ///@}
+
+         /**
+          * Batch version of ConvertToLocalTranslation.  The results are left as doubles rather than
+          * being rounded to floats, and like the single point version, any that are not finite are set to 0.
+          * @see ConvertToLocalTranslation
+          */
+         void ConvertToLocalTranslationBatch(const double* loc0, const double* loc1, const double* loc2,
+                  double* x, double* y, double* z, unsigned count, bool useThreadPool = false);
+
          std::string XYZToMGRS(const osg::Vec3 &pos);
 
          osg::Vec3 ConvertMGRSToXYZ(const std::string& mgrs);
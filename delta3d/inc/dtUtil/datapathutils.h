@@ -59,6 +59,8 @@ namespace dtUtil
     * @param fileName Can be a single filename or a path and file name relative
     *  to the current Delta3D data path list.
     * @return The full path to the file requested or empty string if it's not found. 
+    * @note When every path set with SetDataFilePathList is absolute, relative file names are looked up
+    *       in a dtUtil::FilePathIndex for each path rather than searching the disk each time.
     */
    DT_UTIL_EXPORT std::string FindFileInPathList(const std::string& fileName);
 
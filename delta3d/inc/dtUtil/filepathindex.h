@@ -0,0 +1,159 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_FILEPATHINDEX_H
+#define DELTA_FILEPATHINDEX_H
+
+#include <dtUtil/export.h>
+#include <dtUtil/fileutils.h>
+#include <dtCore/refptr.h>
+#include <osg/Referenced>
+#include <OpenThreads/Atomic>
+#include <OpenThreads/Mutex>
+#include <string>
+#include <vector>
+
+namespace dtUtil
+{
+   /**
+    * Case insensitive index of the files under a single root directory, used to resolve
+    * resource identifiers and data file names without walking the file system on every lookup.
+    *
+    * Directories are read lazily, once each, the first time a lookup passes through them.
+    * A lookup only stats the one directory it finished in (the parent of a hit, or the level
+    * where a miss was decided), and rescans that directory when its modification time has changed,
+    * so files added or removed on disk are picked up without restarting.
+    *
+    * Lookups do not take a lock.  The directory listings are immutable once published, and
+    * the only shared mutable state a reader touches is an atomic child pointer per sub directory.
+    * Scans and rescans are serialized on an internal mutex, and replaced listings are released once
+    * no lookup is in flight.
+    *
+    * Paths that can't be answered from the index, i.e. absolute paths, paths containing "..",
+    * or paths that pass through a regular file such as an archive, are reported as not handled
+    * so the caller can fall back to FileUtils.
+    */
+   class DT_UTIL_EXPORT FilePathIndex : public osg::Referenced
+   {
+   public:
+      /**
+       * @param rootDir the directory to index.  It should be absolute, and it need not exist yet.
+       */
+      FilePathIndex(const std::string& rootDir);
+
+      /// @return the root directory passed to the constructor, with trailing separators removed.
+      const std::string& GetRootDirectory() const { return mRootDirectory; }
+
+      /**
+       * Looks up a path relative to the root, ignoring case.
+       * @param relPath the relative path, using either kind of separator.
+       * @param outPath filled with the absolute path, with the case as it is on disk, if it is found.
+       * @param outType filled with REGULAR_FILE, DIRECTORY, or FILE_NOT_FOUND.
+       * @return false if the path can't be answered by the index, in which case the outputs are unchanged.
+       */
+      bool Find(const std::string& relPath, std::string& outPath, FileType& outType) const;
+
+      /**
+       * Reads the entire tree up front rather than one directory at a time as lookups
+       * need them. This is optional, but moves the cost out of the first lookups.
+       */
+      void Preload();
+
+      /// Throws away everything that has been read.  The next lookup starts reading from the root again.
+      void Clear();
+
+      /**
+       * Splits a relative path into lower case components, dropping empty and "." components.
+       * @return false if the path is absolute or contains "..", which the index doesn't handle.
+       */
+      static bool NormalizePath(const std::string& relPath, std::vector<std::string>& componentsOut);
+
+      /// Counters for profiling.  They are not reset except by ResetCounters.
+      unsigned GetNumLookups() const { return mNumLookups; }
+      unsigned GetNumHits() const { return mNumHits; }
+      /// The number of stat calls the index has made, both for validating and for scanning.
+      unsigned GetNumStatCalls() const { return mNumStatCalls; }
+      /// The number of times a directory has been read, including rescans.
+      unsigned GetNumDirectoryScans() const { return mNumDirectoryScans; }
+      /// The number of times a directory had to be read again because it changed on disk.
+      unsigned GetNumRescans() const { return mNumRescans; }
+      void ResetCounters();
+
+      class DirectoryListing;
+
+   protected:
+      virtual ~FilePathIndex();
+
+   private:
+      /// Nanoseconds since the epoch, though the real resolution depends on the platform.
+      typedef unsigned long long FileTime;
+
+      enum LookupResult
+      {
+         LOOKUP_FOUND,
+         LOOKUP_NOT_FOUND,
+         LOOKUP_UNHANDLED,
+         LOOKUP_STALE
+      };
+
+      LookupResult InternalFind(const std::vector<std::string>& components, std::string& outPath, FileType& outType) const;
+
+      /// Gets the listing for the given child entry, reading the directory if no lookup has yet.
+      const DirectoryListing* GetOrScanChild(const DirectoryListing& parent, unsigned entryIndex) const;
+      const DirectoryListing* GetOrScanRoot() const;
+
+      /**
+       * Stats the directory of the listing, rescanning it if it changed.
+       * @return the listing that is current for the directory, or NULL if the directory is gone.
+       */
+      const DirectoryListing* RefreshListing(const DirectoryListing& listing) const;
+
+      /// Reads the given directory.  Must be called with the write mutex held.
+      DirectoryListing* ScanDirectory(const std::string& absPath) const;
+
+      /// Swaps the new listing in for the old one, keeping any sub directory listings that are still valid.
+      void ReplaceListing(const DirectoryListing& oldListing, DirectoryListing& newListing) const;
+
+      void PreloadListing(const DirectoryListing& listing);
+
+      /// Frees replaced listings if no lookup is running.  Must be called with the write mutex held.
+      void ReleaseRetiredListings() const;
+
+      bool StatDirectory(const std::string& absPath, FileTime& modTimeOut) const;
+      static FileTime GetCurrentFileTime();
+
+      std::string mRootDirectory;
+
+      mutable OpenThreads::AtomicPtr mRoot;
+      mutable dtCore::RefPtr<DirectoryListing> mRootRef;
+
+      mutable OpenThreads::Mutex mWriteMutex;
+      mutable OpenThreads::Atomic mNumActiveReaders;
+      mutable std::vector<dtCore::RefPtr<DirectoryListing> > mRetiredListings;
+      mutable OpenThreads::Atomic mNumRetiredListings;
+
+      mutable OpenThreads::Atomic mNumLookups;
+      mutable OpenThreads::Atomic mNumHits;
+      mutable OpenThreads::Atomic mNumStatCalls;
+      mutable OpenThreads::Atomic mNumDirectoryScans;
+      mutable OpenThreads::Atomic mNumRescans;
+   };
+}
+
+#endif // DELTA_FILEPATHINDEX_H
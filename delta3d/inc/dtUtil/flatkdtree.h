@@ -0,0 +1,593 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_FLATKDTREE_H_
+#define DELTA_FLATKDTREE_H_
+
+#include <osg/Vec3>
+#include <algorithm>
+#include <vector>
+#include <cstddef>
+
+namespace dtUtil
+{
+   /**
+    * A 3D point index that keeps its points in flat arrays laid out as implicit kd-trees, so queries walk
+    * contiguous memory instead of chasing node pointers, and results are the stored values directly.
+    *
+    * The points live in a few levels, each an independent balanced tree about twice the size of the one before it.
+    * New points go into a small unsorted buffer.  When it fills, it is merged with the smaller levels into the first
+    * empty one, so an insert only ever rebuilds the small levels it touches (amortized O(log^2 n)).  Removing marks the
+    * point dead in place, and the levels are compacted once more than half of the points are dead.
+    *
+    * All queries take an optional filter, a functor called as bool(const ValueType&), that is only called for
+    * points that are in range.  The nearest search prunes with the best distance found so far, so a filtered nearest
+    * search only looks at the points closer than the closest match.
+    *
+    * ValueType must be copyable and comparable with ==.  It is not thread safe.
+    */
+   template <typename ValueType>
+   class FlatKDTree
+   {
+   public:
+      /// A filter that accepts everything.
+      struct AcceptAll
+      {
+         bool operator()(const ValueType&) const { return true; }
+      };
+
+      FlatKDTree()
+         : mNumLive(0)
+         , mNumDead(0)
+      {
+      }
+
+      /// Adds a point.  The same value may be added more than once.
+      void Insert(const osg::Vec3& pos, const ValueType& value)
+      {
+         Entry entry;
+         entry.mPos = pos;
+         entry.mValue = value;
+         entry.mAxis = 0;
+         entry.mDead = false;
+         mPending.push_back(entry);
+         ++mNumLive;
+
+         if (mPending.size() >= PENDING_SIZE)
+         {
+            MergePending();
+         }
+      }
+
+      /**
+       * Removes one point with the given value at the given position.
+       * @param tolerance how far the stored point may be from pos and still match.
+       * @return false if it was not found.
+       */
+      bool Remove(const osg::Vec3& pos, const ValueType& value, float tolerance = 0.0f)
+      {
+         const float tolerance2 = tolerance * tolerance;
+         for (size_t i = 0; i < mPending.size(); ++i)
+         {
+            if (mPending[i].mValue == value && (mPending[i].mPos - pos).length2() <= tolerance2)
+            {
+               mPending[i] = mPending.back();
+               mPending.pop_back();
+               --mNumLive;
+               return true;
+            }
+         }
+
+         for (size_t l = 0; l < mLevels.size(); ++l)
+         {
+            EntryArray& level = mLevels[l];
+            if (!level.empty() && MarkDead(level, 0, level.size(), pos, value, tolerance))
+            {
+               --mNumLive;
+               ++mNumDead;
+               if (mNumDead > mNumLive)
+               {
+                  Optimize();
+               }
+               return true;
+            }
+         }
+         return false;
+      }
+
+      /**
+       * Moves a point.
+       * @return false if it was not found at the old position, in which case nothing is added.
+       */
+      bool Move(const osg::Vec3& oldPos, const osg::Vec3& newPos, const ValueType& value)
+      {
+         if (!Remove(oldPos, value))
+         {
+            return false;
+         }
+         Insert(newPos, value);
+         return true;
+      }
+
+      void Clear()
+      {
+         mPending.clear();
+         mLevels.clear();
+         mNumLive = 0;
+         mNumDead = 0;
+      }
+
+      /// @return the number of points
+      size_t GetSize() const { return mNumLive; }
+      bool IsEmpty() const { return mNumLive == 0; }
+
+      /// Rebuilds everything into a single tree and drops the removed points.  Best called after a bulk load.
+      void Optimize()
+      {
+         EntryArray all;
+         all.reserve(mNumLive);
+         all.insert(all.end(), mPending.begin(), mPending.end());
+         mPending.clear();
+         for (size_t l = 0; l < mLevels.size(); ++l)
+         {
+            AppendLive(mLevels[l], all);
+         }
+         mLevels.clear();
+         mNumDead = 0;
+
+         if (!all.empty())
+         {
+            size_t l = 0;
+            while ((size_t(PENDING_SIZE) << l) < all.size())
+            {
+               ++l;
+            }
+            mLevels.resize(l + 1);
+            mLevels[l].swap(all);
+            Build(mLevels[l], 0, mLevels[l].size());
+         }
+      }
+
+      /**
+       * Finds the closest point that passes the filter.
+       * @param pos the point to search from.
+       * @param maxDistance points further than this are ignored.
+       * @param result set to the value found.
+       * @return true if one was found.
+       */
+      template <typename Filter>
+      bool FindNearest(const osg::Vec3& pos, float maxDistance, ValueType& result, Filter filter) const
+      {
+         if (maxDistance < 0.0f)
+         {
+            return false;
+         }
+
+         NearestSearch<Filter> search(pos, maxDistance * maxDistance, filter);
+         ScanNearest(mPending, 0, mPending.size(), search);
+         for (size_t l = 0; l < mLevels.size(); ++l)
+         {
+            if (!mLevels[l].empty())
+            {
+               SearchNearest(mLevels[l], 0, mLevels[l].size(), search);
+            }
+         }
+
+         if (search.mBest != NULL)
+         {
+            result = search.mBest->mValue;
+            return true;
+         }
+         return false;
+      }
+
+      bool FindNearest(const osg::Vec3& pos, float maxDistance, ValueType& result) const
+      {
+         return FindNearest(pos, maxDistance, result, AcceptAll());
+      }
+
+      /**
+       * Runs FindNearest for many positions.  The queries are run in an order that keeps nearby ones together
+       * so the tree stays in the cache, which is much faster than separate calls for large batches.
+       * @param results filled with one value per position, notFound where nothing was in range.
+       * @return the number of positions that found a point.
+       */
+      template <typename Filter>
+      size_t FindNearestBatch(const std::vector<osg::Vec3>& positions, float maxDistance,
+               std::vector<ValueType>& results, const ValueType& notFound, Filter filter) const
+      {
+         results.assign(positions.size(), notFound);
+         if (positions.empty())
+         {
+            return 0;
+         }
+
+         std::vector<std::pair<unsigned, unsigned> > order;
+         SortSpatially(positions, order);
+
+         size_t numFound = 0;
+         for (size_t i = 0; i < order.size(); ++i)
+         {
+            unsigned idx = order[i].second;
+            if (FindNearest(positions[idx], maxDistance, results[idx], filter))
+            {
+               ++numFound;
+            }
+         }
+         return numFound;
+      }
+
+      size_t FindNearestBatch(const std::vector<osg::Vec3>& positions, float maxDistance,
+               std::vector<ValueType>& results, const ValueType& notFound) const
+      {
+         return FindNearestBatch(positions, maxDistance, results, notFound, AcceptAll());
+      }
+
+      /**
+       * Finds all points closer than radius that pass the filter.  They are not sorted.
+       * @param out an output iterator of ValueType, such as std::back_inserter(vector).
+       * @return the number of points found.
+       */
+      template <typename OutputIterator, typename Filter>
+      size_t FindInRadius(const osg::Vec3& pos, float radius, OutputIterator out, Filter filter) const
+      {
+         if (radius <= 0.0f)
+         {
+            return 0;
+         }
+
+         RadiusSearch<OutputIterator, Filter> search(pos, radius, out, filter);
+         ScanRadius(mPending, 0, mPending.size(), search);
+         for (size_t l = 0; l < mLevels.size(); ++l)
+         {
+            if (!mLevels[l].empty())
+            {
+               SearchRadius(mLevels[l], 0, mLevels[l].size(), search);
+            }
+         }
+         return search.mNumFound;
+      }
+
+      template <typename OutputIterator>
+      size_t FindInRadius(const osg::Vec3& pos, float radius, OutputIterator out) const
+      {
+         return FindInRadius(pos, radius, out, AcceptAll());
+      }
+
+   private:
+      /// Ranges this small are scanned instead of split.
+      static const size_t LEAF_SIZE = 8;
+      /// Size of the unsorted insert buffer, and of the smallest level.
+      static const size_t PENDING_SIZE = 32;
+
+      struct Entry
+      {
+         osg::Vec3 mPos;
+         ValueType mValue;
+         unsigned char mAxis;
+         bool mDead;
+      };
+
+      typedef std::vector<Entry> EntryArray;
+
+      struct AxisLess
+      {
+         explicit AxisLess(unsigned axis) : mAxis(axis) {}
+         bool operator()(const Entry& a, const Entry& b) const { return a.mPos[mAxis] < b.mPos[mAxis]; }
+         unsigned mAxis;
+      };
+
+      template <typename Filter>
+      struct NearestSearch
+      {
+         NearestSearch(const osg::Vec3& pos, float maxDist2, Filter& filter)
+            : mPos(pos), mBestDist2(maxDist2), mBest(NULL), mFilter(filter)
+         {
+         }
+
+         void Check(const Entry& entry)
+         {
+            if (entry.mDead)
+            {
+               return;
+            }
+            float dist2 = (entry.mPos - mPos).length2();
+            if ((dist2 < mBestDist2 || (mBest == NULL && dist2 <= mBestDist2)) && mFilter(entry.mValue))
+            {
+               mBestDist2 = dist2;
+               mBest = &entry;
+            }
+         }
+
+         osg::Vec3 mPos;
+         float mBestDist2;
+         const Entry* mBest;
+         Filter& mFilter;
+      };
+
+      template <typename OutputIterator, typename Filter>
+      struct RadiusSearch
+      {
+         RadiusSearch(const osg::Vec3& pos, float radius, OutputIterator& out, Filter& filter)
+            : mPos(pos), mRadius(radius), mRadius2(radius * radius), mNumFound(0), mOut(out), mFilter(filter)
+         {
+         }
+
+         void Check(const Entry& entry)
+         {
+            if (!entry.mDead && (entry.mPos - mPos).length2() < mRadius2 && mFilter(entry.mValue))
+            {
+               *mOut = entry.mValue;
+               ++mOut;
+               ++mNumFound;
+            }
+         }
+
+         osg::Vec3 mPos;
+         float mRadius;
+         float mRadius2;
+         size_t mNumFound;
+         OutputIterator& mOut;
+         Filter& mFilter;
+      };
+
+      /// Sorts the entries in [begin, end) into an implicit kd-tree.  The splitter of a range is its middle entry.
+      static void Build(EntryArray& entries, size_t begin, size_t end)
+      {
+         if (end - begin <= LEAF_SIZE)
+         {
+            return;
+         }
+
+         osg::Vec3 minPos = entries[begin].mPos;
+         osg::Vec3 maxPos = minPos;
+         for (size_t i = begin + 1; i < end; ++i)
+         {
+            const osg::Vec3& p = entries[i].mPos;
+            for (unsigned a = 0; a < 3; ++a)
+            {
+               minPos[a] = std::min(minPos[a], p[a]);
+               maxPos[a] = std::max(maxPos[a], p[a]);
+            }
+         }
+
+         // split on the axis with the largest extent
+         osg::Vec3 extent = maxPos - minPos;
+         unsigned axis = 0;
+         if (extent[1] > extent[axis]) axis = 1;
+         if (extent[2] > extent[axis]) axis = 2;
+
+         size_t mid = begin + (end - begin) / 2;
+         std::nth_element(entries.begin() + begin, entries.begin() + mid, entries.begin() + end, AxisLess(axis));
+         entries[mid].mAxis = (unsigned char)(axis);
+
+         Build(entries, begin, mid);
+         Build(entries, mid + 1, end);
+      }
+
+      template <typename Search>
+      static void ScanNearest(const EntryArray& entries, size_t begin, size_t end, Search& search)
+      {
+         for (size_t i = begin; i < end; ++i)
+         {
+            search.Check(entries[i]);
+         }
+      }
+
+      template <typename Search>
+      static void SearchNearest(const EntryArray& entries, size_t begin, size_t end, Search& search)
+      {
+         if (end - begin <= LEAF_SIZE)
+         {
+            ScanNearest(entries, begin, end, search);
+            return;
+         }
+
+         size_t mid = begin + (end - begin) / 2;
+         const Entry& split = entries[mid];
+         float diff = search.mPos[split.mAxis] - split.mPos[split.mAxis];
+
+         // Points equal to the splitter can be on either side, so ties search both.
+         if (diff < 0.0f)
+         {
+            SearchNearest(entries, begin, mid, search);
+            search.Check(split);
+            if (diff * diff <= search.mBestDist2)
+            {
+               SearchNearest(entries, mid + 1, end, search);
+            }
+         }
+         else
+         {
+            SearchNearest(entries, mid + 1, end, search);
+            search.Check(split);
+            if (diff * diff <= search.mBestDist2)
+            {
+               SearchNearest(entries, begin, mid, search);
+            }
+         }
+      }
+
+      template <typename Search>
+      static void ScanRadius(const EntryArray& entries, size_t begin, size_t end, Search& search)
+      {
+         for (size_t i = begin; i < end; ++i)
+         {
+            search.Check(entries[i]);
+         }
+      }
+
+      template <typename Search>
+      static void SearchRadius(const EntryArray& entries, size_t begin, size_t end, Search& search)
+      {
+         if (end - begin <= LEAF_SIZE)
+         {
+            ScanRadius(entries, begin, end, search);
+            return;
+         }
+
+         size_t mid = begin + (end - begin) / 2;
+         const Entry& split = entries[mid];
+         float q = search.mPos[split.mAxis];
+         float s = split.mPos[split.mAxis];
+
+         search.Check(split);
+         if (q - search.mRadius <= s)
+         {
+            SearchRadius(entries, begin, mid, search);
+         }
+         if (q + search.mRadius >= s)
+         {
+            SearchRadius(entries, mid + 1, end, search);
+         }
+      }
+
+      /// Finds a live entry with the value within tolerance of pos and marks it dead.
+      static bool MarkDead(EntryArray& entries, size_t begin, size_t end, const osg::Vec3& pos, const ValueType& value,
+               float tolerance)
+      {
+         const float tolerance2 = tolerance * tolerance;
+         if (end - begin <= LEAF_SIZE)
+         {
+            for (size_t i = begin; i < end; ++i)
+            {
+               Entry& entry = entries[i];
+               if (!entry.mDead && entry.mValue == value && (entry.mPos - pos).length2() <= tolerance2)
+               {
+                  entry.mDead = true;
+                  return true;
+               }
+            }
+            return false;
+         }
+
+         size_t mid = begin + (end - begin) / 2;
+         Entry& split = entries[mid];
+         if (!split.mDead && split.mValue == value && (split.mPos - pos).length2() <= tolerance2)
+         {
+            split.mDead = true;
+            return true;
+         }
+
+         float q = pos[split.mAxis];
+         float s = split.mPos[split.mAxis];
+         return (q - tolerance <= s && MarkDead(entries, begin, mid, pos, value, tolerance))
+               || (q + tolerance >= s && MarkDead(entries, mid + 1, end, pos, value, tolerance));
+      }
+
+      static void AppendLive(const EntryArray& from, EntryArray& to)
+      {
+         for (size_t i = 0; i < from.size(); ++i)
+         {
+            if (!from[i].mDead)
+            {
+               to.push_back(from[i]);
+            }
+         }
+      }
+
+      /// Merges the insert buffer and the levels below the first empty one into that level.
+      void MergePending()
+      {
+         EntryArray merged;
+         merged.swap(mPending);
+
+         size_t l = 0;
+         for (; l < mLevels.size() && !mLevels[l].empty(); ++l)
+         {
+            mNumDead -= CountDead(mLevels[l]);
+            AppendLive(mLevels[l], merged);
+            EntryArray().swap(mLevels[l]);
+         }
+
+         if (l == mLevels.size())
+         {
+            mLevels.resize(l + 1);
+         }
+         mLevels[l].swap(merged);
+         Build(mLevels[l], 0, mLevels[l].size());
+         mPending.reserve(PENDING_SIZE);
+      }
+
+      static size_t CountDead(const EntryArray& entries)
+      {
+         size_t count = 0;
+         for (size_t i = 0; i < entries.size(); ++i)
+         {
+            if (entries[i].mDead)
+            {
+               ++count;
+            }
+         }
+         return count;
+      }
+
+      /// Orders the positions along a Morton curve over their bounding box.  pair is (code, index).
+      static void SortSpatially(const std::vector<osg::Vec3>& positions, std::vector<std::pair<unsigned, unsigned> >& order)
+      {
+         osg::Vec3 minPos = positions[0];
+         osg::Vec3 maxPos = minPos;
+         for (size_t i = 1; i < positions.size(); ++i)
+         {
+            for (unsigned a = 0; a < 3; ++a)
+            {
+               minPos[a] = std::min(minPos[a], positions[i][a]);
+               maxPos[a] = std::max(maxPos[a], positions[i][a]);
+            }
+         }
+
+         osg::Vec3 scale;
+         for (unsigned a = 0; a < 3; ++a)
+         {
+            float extent = maxPos[a] - minPos[a];
+            scale[a] = extent > 0.0f ? 1023.0f / extent : 0.0f;
+         }
+
+         order.resize(positions.size());
+         for (size_t i = 0; i < positions.size(); ++i)
+         {
+            unsigned code = 0;
+            for (unsigned a = 0; a < 3; ++a)
+            {
+               unsigned cell = unsigned((positions[i][a] - minPos[a]) * scale[a]);
+               code |= SpreadBits(std::min(cell, 1023U)) << a;
+            }
+            order[i] = std::make_pair(code, unsigned(i));
+         }
+         std::sort(order.begin(), order.end());
+      }
+
+      /// Spreads the low 10 bits of x so there are two zero bits between each.
+      static unsigned SpreadBits(unsigned x)
+      {
+         x = (x | (x << 16)) & 0x030000FF;
+         x = (x | (x << 8)) & 0x0300F00F;
+         x = (x | (x << 4)) & 0x030C30C3;
+         x = (x | (x << 2)) & 0x09249249;
+         return x;
+      }
+
+      EntryArray mPending;
+      std::vector<EntryArray> mLevels;
+      size_t mNumLive;
+      size_t mNumDead;
+   };
+}
+
+#endif /* DELTA_FLATKDTREE_H_ */
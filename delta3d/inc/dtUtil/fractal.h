@@ -22,6 +22,9 @@
 #ifndef __FRACTAL_H__
 #define __FRACTAL_H__
 
+#include <algorithm>
+#include <cmath>
+
 namespace dtUtil
 {
 
@@ -58,6 +61,9 @@ public:
    ///FBM: The standard Fractal Brownian Motion summation
    Real FBM(Vector vect_in, int octaves = 2, Real freq = 1.0f, Real persistance = 0.5f, Real lacunarity = 2.0f);
 
+   ///FBMBatch: FBM over an array of points, evaluated an octave at a time with the batched noise of the base class
+   void FBMBatch(const Vector* vect_in, Real* out, unsigned count, int octaves = 2, Real freq = 1.0f, Real persistance = 0.5f, Real lacunarity = 2.0f) const;
+
    ///Turbulence: this should be used for gases, clouds, lava, etc, generates an inconsistent bubbly pattern
    Real Turbulence(Vector vect_in, int octaves = 1, Real freq = 1.0f, Real persistance = 0.5f, Real lacunarity = 2.0f);
 
@@ -91,7 +97,7 @@ Real Fractal<Real, Vector, Noise>::FBM(Vector vect_in, int octaves, Real freq, R
 
    for (int i = 0; i < octaves; i++)
    {
-      total += GetNoise(vect_in * freq) * amplitude;
+      total += this->GetNoise(vect_in * freq) * amplitude;
       freq *= lacunarity;
       amplitude *= persistance;
    }
@@ -101,6 +107,47 @@ Real Fractal<Real, Vector, Noise>::FBM(Vector vect_in, int octaves, Real freq, R
 }
 
 
+template <class Real, class Vector, class Noise>
+void Fractal<Real, Vector, Noise>::FBMBatch(const Vector* vect_in, Real* out, unsigned count, int octaves, Real freq, Real persistance, Real lacunarity) const
+{
+   static const unsigned BLOCK = 256;
+   Vector scaled[BLOCK];
+   Real noise[BLOCK];
+
+   for (unsigned blockStart = 0; blockStart < count; blockStart += BLOCK)
+   {
+      unsigned blockSize = std::min(BLOCK, count - blockStart);
+      Real* blockOut = out + blockStart;
+
+      for (unsigned k = 0; k < blockSize; ++k)
+      {
+         blockOut[k] = 0.0f;
+      }
+
+      Real octaveFreq = freq;
+      Real amplitude = 1.0f;
+
+      for (int i = 0; i < octaves; i++)
+      {
+         for (unsigned k = 0; k < blockSize; ++k)
+         {
+            scaled[k] = vect_in[blockStart + k] * octaveFreq;
+         }
+
+         this->GetNoiseBatch(scaled, noise, blockSize);
+
+         for (unsigned k = 0; k < blockSize; ++k)
+         {
+            blockOut[k] += noise[k] * amplitude;
+         }
+
+         octaveFreq *= lacunarity;
+         amplitude *= persistance;
+      }
+   }
+}
+
+
 template <class Real, class Vector, class Noise>
 Real Fractal<Real, Vector, Noise>::Turbulence(Vector vect_in, int octaves, Real freq, Real persistance, Real lacunarity)
 {
@@ -109,7 +156,7 @@ Real Fractal<Real, Vector, Noise>::Turbulence(Vector vect_in, int octaves, Real
 
    for (int i = 0; i < octaves; i++)
    {
-      total += amplitude * std::abs(GetNoise(vect_in * freq));
+      total += amplitude * std::abs(this->GetNoise(vect_in * freq));
       freq *= lacunarity;
       amplitude *= persistance;
    }
@@ -138,7 +185,7 @@ Real Fractal<Real, Vector, Noise>::RigidMultiFractal(Vector vect_in, int octaves
 
    for (int i = 0; i < octaves; i++)
    {
-      signal = weight * (offset - std::abs(GetNoise(vect_in)));
+      signal = weight * (offset - std::abs(this->GetNoise(vect_in)));
       weight = signal * gain;
 
       total += signal * amplitude;
@@ -163,7 +210,7 @@ Real Fractal<Real, Vector, Noise>::HeteroFractal(Vector vect_in, int octaves, Re
 
    for (int i = 0; i < octaves; i++)
    {
-      signal = amplitude * (GetNoise(vect_in) + offset);
+      signal = amplitude * (this->GetNoise(vect_in) + offset);
 
       signal *= total;
       total += signal;
@@ -187,7 +234,7 @@ Real Fractal<Real, Vector, Noise>::IslandFractal(Vector vect_in, int octaves /*
 
    for (int i = 0; i < octaves; i++)
    {
-      total += GetNoise(vect_in * freq) * pers;
+      total += this->GetNoise(vect_in * freq) * pers;
 
       freq *= lacunarity;
       pers *= persistance;
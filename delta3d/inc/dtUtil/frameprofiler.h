@@ -0,0 +1,178 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_FRAMEPROFILER_H_
+#define DELTA_FRAMEPROFILER_H_
+
+#include <dtUtil/export.h>
+#include <osg/Timer>
+#include <OpenThreads/Atomic>
+#include <cstring>
+#include <iosfwd>
+#include <string>
+
+namespace dtUtil
+{
+   /**
+    * Records named, timed zones into a ring buffer per thread so that a single slow frame can be
+    * taken apart after the fact.  Zones are added with the DT_PROFILE_ZONE macros, which compile to nothing
+    * unless DT_FRAME_PROFILER is defined (the BUILD_WITH_FRAME_PROFILER cmake option).  When compiled in,
+    * the profiler still does nothing but test a flag until SetEnabled(true) is called.
+    *
+    * The trace can be written as Chrome trace event JSON (open it in chrome://tracing or Perfetto) with
+    * WriteChromeTrace, or automatically for each frame that takes longer than the spike threshold.
+    *
+    * Writing a trace reads the buffers of the other threads without stopping them, so do it from the main
+    * thread between frames, when the thread pool is idle, as System does for spike frames.
+    */
+   class DT_UTIL_EXPORT FrameProfiler
+   {
+   public:
+      /// Longest zone name that is kept.  Longer names are truncated.
+      static const unsigned MAX_NAME_LENGTH = 47;
+
+      /// Turns recording on or off at runtime.
+      static void SetEnabled(bool enabled);
+      static bool IsEnabled() { return unsigned(mEnabled) != 0U; }
+
+      /**
+       * Sets how many zones each thread keeps before overwriting the oldest one.
+       * Only affects the buffers of threads that have not recorded anything yet, or all of them after Clear().
+       */
+      static void SetEventsPerThread(unsigned numEvents);
+      static unsigned GetEventsPerThread();
+
+      /**
+       * Frames that take longer than this many milliseconds are written as a Chrome trace into the spike directory.
+       * Zero or less, the default, turns this off.
+       */
+      static void SetSpikeThresholdMs(double thresholdMs);
+      static double GetSpikeThresholdMs();
+
+      /// The directory spike traces are written into.  Defaults to the current directory.
+      static void SetSpikeDirectory(const std::string& dir);
+      static const std::string& GetSpikeDirectory();
+
+      /// Marks the start of a frame.  Called by System.
+      static void BeginFrame();
+
+      /**
+       * Marks the end of a frame, and writes the frame if it went over the spike threshold.  Called by System.
+       * @return the length of the frame in milliseconds, or 0 if the profiler is disabled.
+       */
+      static double EndFrame();
+
+      /// @return the number of frames that have been started since recording was enabled.
+      static unsigned GetFrameNumber();
+
+      /// @return the number of zones currently held in all the thread buffers.
+      static unsigned GetNumEvents();
+
+      /**
+       * Forgets all recorded zones and resizes the buffers.  This may be called while other threads are recording.
+       * Each thread empties and resizes its own buffer the next time it records, and until then its old zones
+       * are not counted or written.
+       */
+      static void Clear();
+
+      /**
+       * Writes all recorded zones, optionally only those overlapping the given time range, as Chrome trace JSON.
+       * @return false if the file could not be opened.
+       */
+      static bool WriteChromeTrace(const std::string& fileName, osg::Timer_t from = 0, osg::Timer_t to = 0);
+
+      /// Same as WriteChromeTrace, but to a stream.
+      static void WriteChromeTrace(std::ostream& stream, osg::Timer_t from = 0, osg::Timer_t to = 0);
+
+      /// Adds a finished zone to the buffer of the calling thread.  Use the macros or ScopedProfileZone instead.
+      static void RecordZone(const char* name, unsigned nameLength, osg::Timer_t start, osg::Timer_t end);
+
+   private:
+      FrameProfiler();
+      static OpenThreads::Atomic mEnabled;
+   };
+
+   /**
+    * Times its own lifetime as a zone.  The name only needs to live as long as this object.
+    */
+   class ScopedProfileZone
+   {
+   public:
+      explicit ScopedProfileZone(const char* name)
+      : mName(NULL)
+      , mNameLength(0)
+      , mStart(0)
+      {
+         if (FrameProfiler::IsEnabled())
+         {
+            Start(name, unsigned(strlen(name)));
+         }
+      }
+
+      explicit ScopedProfileZone(const std::string& name)
+      : mName(NULL)
+      , mNameLength(0)
+      , mStart(0)
+      {
+         if (FrameProfiler::IsEnabled())
+         {
+            Start(name.c_str(), unsigned(name.size()));
+         }
+      }
+
+      ~ScopedProfileZone()
+      {
+         if (mName != NULL)
+         {
+            FrameProfiler::RecordZone(mName, mNameLength, mStart, osg::Timer::instance()->tick());
+         }
+      }
+
+   private:
+      void Start(const char* name, unsigned length)
+      {
+         mName = name;
+         mNameLength = length;
+         mStart = osg::Timer::instance()->tick();
+      }
+
+      ScopedProfileZone(const ScopedProfileZone&);
+      ScopedProfileZone& operator=(const ScopedProfileZone&);
+
+      const char* mName;
+      unsigned mNameLength;
+      osg::Timer_t mStart;
+   };
+}
+
+#define DT_PROFILE_CONCAT_IMPL(a, b) a ## b
+#define DT_PROFILE_CONCAT(a, b) DT_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef DT_FRAME_PROFILER
+   /// Times the rest of the enclosing scope under the given name, a const char* or std::string.
+   #define DT_PROFILE_ZONE(name) dtUtil::ScopedProfileZone DT_PROFILE_CONCAT(dtProfileZone, __LINE__)(name)
+   #define DT_PROFILE_BEGIN_FRAME() dtUtil::FrameProfiler::BeginFrame()
+   #define DT_PROFILE_END_FRAME() dtUtil::FrameProfiler::EndFrame()
+#else
+   #define DT_PROFILE_ZONE(name)
+   #define DT_PROFILE_BEGIN_FRAME()
+   #define DT_PROFILE_END_FRAME()
+#endif
+
+#endif /* DELTA_FRAMEPROFILER_H_ */
@@ -271,6 +271,42 @@ namespace dtUtil
        */
       static void SetLogTimeProvider(LogTimeProvider* ltp);
 
+      /**
+       * Switches every log between writing each message on the calling thread, the default, and async mode.
+       * In async mode LogMessage only copies the message into a lock-free queue owned by the calling thread.
+       * A background thread takes the messages off all the queues in the order they were logged and sends them
+       * to the file, console and observers in batches.  Errors and LOG_ALWAYS messages are written and flushed,
+       * along with everything logged before them, before LogMessage returns, so a crash can't lose them.
+       * Whatever else is still queued is written when the process exits normally, but a crash loses it,
+       * so call Flush first if the last messages before risky work matter.
+       *
+       * Turn this on or off only while no other thread is logging, such as at startup and shutdown.
+       * Turning it off flushes everything that is queued.
+       */
+      static void SetAsyncMode(bool async);
+      static bool GetAsyncMode();
+
+      /**
+       * Sets how many messages each thread may have queued in async mode before new ones are dropped.
+       * It only affects threads that have not logged in async mode yet.  Defaults to 4096.
+       */
+      static void SetAsyncQueueSize(unsigned numMessages);
+      static unsigned GetAsyncQueueSize();
+
+      /**
+       * In async mode, an identical message from the same log, file and line that is repeated within this many seconds
+       * is counted rather than written, and the count is written once the window passes.  Zero turns this off.
+       * Defaults to 1 second.
+       */
+      static void SetAsyncDuplicateWindow(double seconds);
+      static double GetAsyncDuplicateWindow();
+
+      /// Blocks until every message queued in async mode so far has been written.  Does nothing in sync mode.
+      static void Flush();
+
+      /// @return the number of messages dropped because a thread's async queue was full.
+      static unsigned GetNumDroppedMessages();
+
       /**
         *  Add an observer that receives all log messages via callback.  The
         *  TO_OBSERVER OutputStreamOptions bit must be set in order for LogObservers
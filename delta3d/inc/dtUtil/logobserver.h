@@ -54,6 +54,12 @@ namespace dtUtil
 
       virtual void LogMessage(const LogData& logData) = 0;
 
+      /**
+       * Called after a batch of messages has been sent when the log is in async mode.
+       * Observers that buffer their output should write it out here.
+       */
+      virtual void Flush() {}
+
    protected:
       virtual ~LogObserver() {}
 
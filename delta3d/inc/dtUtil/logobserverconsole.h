@@ -37,8 +37,17 @@ namespace dtUtil
 
       virtual void LogMessage(const LogData& logData);
 
+      virtual void Flush();
+
+      /// If true, the default, the console is flushed after every message.
+      void SetFlushEachMessage(bool flush);
+      bool GetFlushEachMessage() const;
+
    protected:
       virtual ~LogObserverConsole();
+
+   private:
+      bool mFlushEachMessage;
    };
 }
 
@@ -40,8 +40,17 @@ namespace dtUtil
       
       virtual void LogMessage(const LogData& logData);
 
+      virtual void Flush();
+
       void LogHorizRule();
 
+      /**
+       * If true, the default, the file is flushed after every message so nothing is lost in a crash.
+       * The async log writer turns this off and flushes once per batch instead.
+       */
+      void SetFlushEachMessage(bool flush);
+      bool GetFlushEachMessage() const;
+
       bool mOpenFailed;
 
    protected:
@@ -49,6 +58,7 @@ namespace dtUtil
 
    private:
       std::ofstream logFile;
+      bool mFlushEachMessage;
 
       void TimeTag(std::string prefix);
       void EndFile();
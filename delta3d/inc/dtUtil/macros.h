@@ -28,6 +28,8 @@
 
 #include <string>
 #include <vector>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
 
 //
 // The "is-a" macro.  Checks whether the first parameter (a pointer) is an
@@ -50,7 +52,9 @@
 //
 // The management layer declaration macro.  Should be included in the
 // declarations of all heavyweight dtCore classes, with the (unquoted) name of
-// the class specified as its parameter.
+// the class specified as its parameter.  Registration is locked so instances
+// may be constructed on worker threads, such as when a map is parsed in the
+// background.
 //
 
 #ifdef DECLARE_MANAGEMENT_LAYER
@@ -59,6 +63,7 @@
 #define DECLARE_MANAGEMENT_LAYER(T)                \
    private:                                        \
       static std::vector<T*> instances;            \
+      static OpenThreads::Mutex& GetInstanceMutex(); \
       static void RegisterInstance(T* instance);   \
       static void DeregisterInstance(T* instance); \
    public:                                         \
@@ -78,13 +83,20 @@
 #endif
 #define IMPLEMENT_MANAGEMENT_LAYER(T)                          \
    std::vector<T*> T::instances;                               \
+   OpenThreads::Mutex& T::GetInstanceMutex()                   \
+   {                                                           \
+      static OpenThreads::Mutex instanceMutex;                 \
+      return instanceMutex;                                    \
+   }                                                           \
    void T::RegisterInstance(T* instance)                       \
    {                                                           \
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(GetInstanceMutex()); \
       if (instance != NULL)                                    \
          instances.push_back(instance);                        \
    }                                                           \
    void T::DeregisterInstance(T* instance)                     \
    {                                                           \
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(GetInstanceMutex()); \
       for (std::vector<T*>::iterator it = instances.begin();   \
           it != instances.end();                               \
           ++it)                                                \
@@ -96,10 +108,19 @@
          }                                                     \
       }                                                        \
    }                                                           \
-   int T::GetInstanceCount() { return instances.size(); }      \
-   T* T::GetInstance(int index) { return instances[index]; }   \
+   int T::GetInstanceCount()                                   \
+   {                                                           \
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(GetInstanceMutex()); \
+      return instances.size();                                 \
+   }                                                           \
+   T* T::GetInstance(int index)                                \
+   {                                                           \
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(GetInstanceMutex()); \
+      return instances[index];                                 \
+   }                                                           \
    T* T::GetInstance(std::string name)                         \
    {                                                           \
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(GetInstanceMutex()); \
       for (std::vector<T*>::iterator it = instances.begin();   \
           it != instances.end();                               \
           ++it)                                                \
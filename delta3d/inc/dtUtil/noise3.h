@@ -40,20 +40,30 @@ public:
    ~Noise3();
 
    void Reseed(unsigned int seed);
-   Real GetNoise(const Vector& vect_in);
+
+   /// GetNoise keeps no per call state, so it may be called from several threads at once.
+   Real GetNoise(const Vector& vect_in) const;
+
+   /**
+   * Evaluates the noise for a whole array of points.
+   * The table lookups are done first for a block of points, then the interpolation
+   * runs over flat arrays so the compiler can vectorize it.  The results match GetNoise.
+   *
+   * @param vect_in the points to evaluate
+   * @param out receives one noise value per point
+   * @param count the number of points
+   */
+   void GetNoiseBatch(const Vector* vect_in, Real* out, unsigned count) const;
 
 private:
 
    void BuildTable();
-   void BuildCoefs(const Vector& vect_in);
-   int Fold(const Vector& vect_in);
-   Real Interp(Real t);
+   int Fold(int x, int y, int z) const;
+   static Real Interp(Real t);
 
 
    static const int TABLE_SIZE = 256;
-
-   Vector   m_vCoef[8];
-   int      m_iCoef[8];
+   static const unsigned BATCH_BLOCK = 64;
 
    int      m_iPerm[TABLE_SIZE * 2];
    Vector   m_gTable[TABLE_SIZE];
@@ -134,71 +144,47 @@ void Noise3<Real, Vector>::BuildTable()
 
 
 template <class Real, class Vector>
-void Noise3<Real, Vector>::BuildCoefs(const Vector& vect_in)
-{
-   Real iX, iY, iZ, iX1, iY1, iZ1;
-   iX = floor(vect_in[0]);
-   iY = floor(vect_in[1]);
-   iZ = floor(vect_in[2]);
-
-   iX1 = (iX + Real(1.0));
-   iY1 = (iY + Real(1.0));
-   iZ1 = (iZ + Real(1.0));
-
-
-   m_vCoef[0] = Vector(iX, iY, iZ);
-   m_vCoef[1] = Vector(iX1, iY, iZ);
-
-   m_vCoef[2] = Vector(iX, iY1, iZ);
-   m_vCoef[3] = Vector(iX1, iY1, iZ);
-
-   m_vCoef[4] = Vector(iX, iY, iZ1);
-   m_vCoef[5] = Vector(iX1, iY, iZ1);
-
-   m_vCoef[6] = Vector(iX, iY1, iZ1);
-   m_vCoef[7] = Vector(iX1, iY1, iZ1);
-
-   for (int i = 0; i < 8; i++)
-   {
-      m_iCoef[i] = Fold(m_vCoef[i]);
-   }
-}
-
-
-template <class Real, class Vector>
-int Noise3<Real, Vector>::Fold(const Vector& vect_in)
+int Noise3<Real, Vector>::Fold(int x, int y, int z) const
 {
-   int x = int(vect_in[0]) & (TABLE_SIZE - 1);
-   int y = int(vect_in[1]) & (TABLE_SIZE - 1);
-   int z = int(vect_in[2]) & (TABLE_SIZE - 1);
-
-   return m_iPerm[x + m_iPerm[ y + m_iPerm[z]]];
+   return m_iPerm[(x & (TABLE_SIZE - 1)) + m_iPerm[(y & (TABLE_SIZE - 1)) + m_iPerm[z & (TABLE_SIZE - 1)]]];
 }
 
 //Ken Perlin's new interpolation function
-//n = 6t^5 - 15t^4 + 10t^3
+//n = 6t^5 - 15t^4 + 10t^3, in Horner form
 template <class Real, class Vector>
 Real Noise3<Real, Vector>::Interp(Real t)
 {
-   return Real((Real(6.0) * pow(t, Real(5.0))) - (Real(15.0) * pow(t, Real(4.0))) + (Real(10.0) * pow(t, Real(3.0))));
+   return t * t * t * (t * (t * Real(6.0) - Real(15.0)) + Real(10.0));
 }
 
 
 template <class Real, class Vector>
-Real Noise3<Real, Vector>::GetNoise(const Vector& vect_in)
+Real Noise3<Real, Vector>::GetNoise(const Vector& vect_in) const
 {
-   BuildCoefs(vect_in);
+   Real fX = floor(vect_in[0]);
+   Real fY = floor(vect_in[1]);
+   Real fZ = floor(vect_in[2]);
+
+   int iX = int(fX);
+   int iY = int(fY);
+   int iZ = int(fZ);
+
+   Real tX = vect_in[0] - fX;
+   Real tY = vect_in[1] - fY;
+   Real tZ = vect_in[2] - fZ;
 
    Real gradientValues[8];
 
    for (int i = 0; i < 8; i++)
    {
-      gradientValues[i] = (vect_in - m_vCoef[i]) * m_gTable[m_iCoef[i]];
+      int cX = i & 1, cY = (i >> 1) & 1, cZ = (i >> 2) & 1;
+      const Vector& g = m_gTable[Fold(iX + cX, iY + cY, iZ + cZ)];
+      gradientValues[i] = (tX - Real(cX)) * g[0] + (tY - Real(cY)) * g[1] + (tZ - Real(cZ)) * g[2];
    }
 
-   Real u = Interp(vect_in[0] - m_vCoef[0][0]);
-   Real v = Interp(vect_in[1] - m_vCoef[0][1]);
-   Real w = Interp(vect_in[2] - m_vCoef[0][2]);
+   Real u = Interp(tX);
+   Real v = Interp(tY);
+   Real w = Interp(tZ);
 
    Real sumX1 = Lerp(gradientValues[0], gradientValues[1], u);
    Real sumX2 = Lerp(gradientValues[2], gradientValues[3], u);
@@ -214,6 +200,78 @@ Real Noise3<Real, Vector>::GetNoise(const Vector& vect_in)
 }
 
 
+template <class Real, class Vector>
+void Noise3<Real, Vector>::GetNoiseBatch(const Vector* vect_in, Real* out, unsigned count) const
+{
+   Real tX[BATCH_BLOCK], tY[BATCH_BLOCK], tZ[BATCH_BLOCK];
+   Real gX[8][BATCH_BLOCK], gY[8][BATCH_BLOCK], gZ[8][BATCH_BLOCK];
+
+   for (unsigned blockStart = 0; blockStart < count; blockStart += BATCH_BLOCK)
+   {
+      unsigned blockSize = count - blockStart;
+      if (blockSize > BATCH_BLOCK)
+      {
+         blockSize = BATCH_BLOCK;
+      }
+
+      //gather the lattice gradients into flat arrays
+      for (unsigned k = 0; k < blockSize; ++k)
+      {
+         const Vector& p = vect_in[blockStart + k];
+         Real fX = floor(p[0]);
+         Real fY = floor(p[1]);
+         Real fZ = floor(p[2]);
+         int iX = int(fX);
+         int iY = int(fY);
+         int iZ = int(fZ);
+
+         tX[k] = p[0] - fX;
+         tY[k] = p[1] - fY;
+         tZ[k] = p[2] - fZ;
+
+         for (int i = 0; i < 8; ++i)
+         {
+            const Vector& g = m_gTable[Fold(iX + (i & 1), iY + ((i >> 1) & 1), iZ + ((i >> 2) & 1))];
+            gX[i][k] = g[0];
+            gY[i][k] = g[1];
+            gZ[i][k] = g[2];
+         }
+      }
+
+      //branch free arithmetic over the flat arrays
+      Real* blockOut = out + blockStart;
+      for (unsigned k = 0; k < blockSize; ++k)
+      {
+         Real x0 = tX[k], y0 = tY[k], z0 = tZ[k];
+         Real x1 = x0 - Real(1.0), y1 = y0 - Real(1.0), z1 = z0 - Real(1.0);
+
+         Real d0 = x0 * gX[0][k] + y0 * gY[0][k] + z0 * gZ[0][k];
+         Real d1 = x1 * gX[1][k] + y0 * gY[1][k] + z0 * gZ[1][k];
+         Real d2 = x0 * gX[2][k] + y1 * gY[2][k] + z0 * gZ[2][k];
+         Real d3 = x1 * gX[3][k] + y1 * gY[3][k] + z0 * gZ[3][k];
+         Real d4 = x0 * gX[4][k] + y0 * gY[4][k] + z1 * gZ[4][k];
+         Real d5 = x1 * gX[5][k] + y0 * gY[5][k] + z1 * gZ[5][k];
+         Real d6 = x0 * gX[6][k] + y1 * gY[6][k] + z1 * gZ[6][k];
+         Real d7 = x1 * gX[7][k] + y1 * gY[7][k] + z1 * gZ[7][k];
+
+         Real u = Interp(x0);
+         Real v = Interp(y0);
+         Real w = Interp(z0);
+
+         Real sumX1 = d0 + u * (d1 - d0);
+         Real sumX2 = d2 + u * (d3 - d2);
+         Real sumX3 = d4 + u * (d5 - d4);
+         Real sumX4 = d6 + u * (d7 - d6);
+
+         Real sumY1 = sumX1 + v * (sumX2 - sumX1);
+         Real sumY2 = sumX3 + v * (sumX4 - sumX3);
+
+         blockOut[k] = sumY1 + w * (sumY2 - sumY1);
+      }
+   }
+}
+
+
 
 }//dtCore
 
@@ -47,6 +47,7 @@ namespace dtUtil
 
       DT_DECLARE_ACCESSOR(bool, UseFileCaching);
       DT_DECLARE_ACCESSOR(std::string, FileToLoad);
+      /// The options to read with.  If not set, new options with "loadMaterialsToStateSet" are used.  The cache hint is always set from UseFileCaching.
       DT_DECLARE_ACCESSOR(osg::ref_ptr<osgDB::Options>, LoadOptions);
 
    protected:
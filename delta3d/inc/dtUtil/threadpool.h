@@ -140,6 +140,12 @@ namespace dtUtil
        */
       static unsigned GetNumImmediateWorkerThreads();
 
+      /**
+       * @return true if the calling thread is one of the pool's worker threads.  Code that may run inside a task
+       *         should not wait on other tasks from such a thread, since it would be holding up a worker.
+       */
+      static bool IsWorkerThread();
+
    private:
       // Hide all constructors and destructors
       ThreadPool();
@@ -14,9 +14,13 @@
 #include <dtUtil/typetraits.h>
 #include <dtCore/typetoactorproperty.h>
 #include <dtCore/namedarrayparameter.h>
+#include <dtCore/namedunsignedintparameter.h>
+#include <dtCore/namedunsignedshortintparameter.h>
+#include <dtCore/namedfloatparameter.h>
 #include <osg/Vec3>
 #include <openvdb/openvdb.h>
 #include <OpenEXR/half.h>
+#include <map>
 
 namespace dtVoxel
 {
@@ -37,6 +41,19 @@ namespace dtVoxel
       // Name to use for array items, for simplicity
       static const dtUtil::RefString PARAM_ARRAY_ITEM;
 
+      // unsigned int list, for each brick the origin, then the words of the changed mask and the active mask.  See AddBrick.
+      static const dtUtil::RefString PARAM_BRICKS;
+      // unsigned short list with the half float values of the voxels the bricks turn on, in order.
+      static const dtUtil::RefString PARAM_BRICK_HALF_VALUES;
+      // float list used instead of PARAM_BRICK_HALF_VALUES when StoreHalfFloats is false.
+      static const dtUtil::RefString PARAM_BRICK_FLOAT_VALUES;
+
+      /// Bricks are the size of, and aligned with, the openvdb leaf nodes.
+      typedef openvdb::FloatTree::LeafNodeType BrickLayout;
+      typedef openvdb::util::NodeMask<BrickLayout::LOG2DIM> BrickMask;
+      static const unsigned BRICK_MASK_WORDS = BrickMask::SIZE / 32U;
+      static const unsigned BRICK_HEADER_SIZE = 3U + 2U * BRICK_MASK_WORDS;
+
 
       DT_DECLARE_ACCESSOR(bool, StoreHalfFloats);
 
@@ -68,6 +85,26 @@ namespace dtVoxel
       ArrayT* GetIndicesChanged();
       ArrayT* GetValuesChanged();
 
+      /**
+       * Adds the changes to one leaf aligned brick of voxels.  When an edit changes a lot of voxels that are close
+       * together, like a crater, this is far smaller on the wire than a vec3 index and a value per voxel.
+       * Bricks are applied after the changes added with AddChangedValue and AddDeactivatedIndex.
+       * @param origin The origin of the brick, which must be a multiple of the brick size.
+       * @param changed A bit for each voxel in the brick that changed.
+       * @param active A bit for each changed voxel that is on. Bits for voxels that didn't change are ignored.
+       * @param values The value of each voxel that is both changed and active, in mask order.  Bool grids use 0 and 1.
+       */
+      void AddBrick(const openvdb::Coord& origin, const BrickMask& changed, const BrickMask& active, const std::vector<float>& values);
+
+      unsigned GetNumBricks() const;
+
+      /**
+       * Calls func(const openvdb::Coord& voxel, bool active, float value) for every voxel the bricks changed, in order.
+       * @return false if the brick data is truncated, which stops the iteration.
+       */
+      template<typename FuncType>
+      bool ForEachBrickVoxel(FuncType func) const;
+
    protected:
       ~VolumeUpdateMessage() override;
    private:
@@ -76,10 +113,94 @@ namespace dtVoxel
       // Using direct datamembers because in a complex voxel system with a lot of changes, just accessing the values can be slow.
       dtCore::RefPtr<ArrayT> mIndicesChanged;
       dtCore::RefPtr<ArrayT> mValuesChanged;
+      dtCore::RefPtr<dtCore::NamedUnsignedIntParameter> mBricks;
+      dtCore::RefPtr<dtCore::NamedUnsignedShortIntParameter> mBrickHalfValues;
+      dtCore::RefPtr<dtCore::NamedFloatParameter> mBrickFloatValues;
    };
 
+   template<typename FuncType>
+   bool VolumeUpdateMessage::ForEachBrickVoxel(FuncType func) const
+   {
+      const std::vector<unsigned>& bricks = mBricks->GetValueList();
+      const std::vector<unsigned short>& halfValues = mBrickHalfValues->GetValueList();
+      const std::vector<float>& floatValues = mBrickFloatValues->GetValueList();
+      size_t nextValue = 0;
+
+      for (size_t b = 0; b + BRICK_HEADER_SIZE <= bricks.size(); b += BRICK_HEADER_SIZE)
+      {
+         openvdb::Coord origin(int(bricks[b]), int(bricks[b + 1]), int(bricks[b + 2]));
+         BrickMask changed, active;
+         for (unsigned w = 0; w < BRICK_MASK_WORDS; ++w)
+         {
+            changed.getWord<openvdb::Index32>(w) = bricks[b + 3 + w];
+            active.getWord<openvdb::Index32>(w) = bricks[b + 3 + BRICK_MASK_WORDS + w];
+         }
+
+         for (BrickMask::OnIterator itr = changed.beginOn(); itr; ++itr)
+         {
+            openvdb::Coord voxel = origin + BrickLayout::offsetToLocalCoord(itr.pos());
+            if (active.isOn(itr.pos()))
+            {
+               float value;
+               if (nextValue < halfValues.size())
+               {
+                  half h;
+                  h.setBits(halfValues[nextValue]);
+                  value = h;
+               }
+               else if (nextValue - halfValues.size() < floatValues.size())
+               {
+                  value = floatValues[nextValue - halfValues.size()];
+               }
+               else
+               {
+                  return false;
+               }
+               ++nextValue;
+               func(voxel, true, value);
+            }
+            else
+            {
+               func(voxel, false, 0.0f);
+            }
+         }
+      }
+      return bricks.size() % BRICK_HEADER_SIZE == 0;
+   }
+
    typedef dtCore::RefPtr<const VolumeUpdateMessage> VolumeUpdateMessagePtr;
 
+   /**
+    * Groups voxel changes by brick so they can be added to a VolumeUpdateMessage with AddBrick.
+    * Setting the same voxel more than once keeps the last change.
+    */
+   class DT_VOXEL_EXPORT VolumeBrickBuilder
+   {
+   public:
+      typedef VolumeUpdateMessage::BrickMask BrickMask;
+
+      void SetValueOn(const openvdb::Coord& voxel, float value);
+      void SetValueOff(const openvdb::Coord& voxel);
+
+      /// Adds a brick to the message for each brick that has changes, then clears the builder.
+      void AddTo(VolumeUpdateMessage& msg);
+
+      bool IsEmpty() const;
+      void Clear();
+
+   private:
+      struct Brick
+      {
+         BrickMask mChanged;
+         BrickMask mActive;
+         float mValues[BrickMask::SIZE];
+      };
+
+      Brick& GetBrick(const openvdb::Coord& voxel);
+
+      std::map<openvdb::Coord, Brick> mBricks;
+   };
+
    template<>
    inline void VolumeUpdateMessage::AddChangedValue<float>(const osg::Vec3& idx, float value)
    {
@@ -24,6 +24,7 @@
 #include <dtVoxel/volumeupdatemessage.h>
 #include <dtVoxel/readovdbthreadpooltask.h>
 #include <dtVoxel/physicstesselationmode.h>
+#include <dtVoxel/voxelcollisioncache.h>
 #include <dtGame/gameactorproxy.h>
 #include <dtUtil/getsetmacros.h>
 //Really need to fine grain this.
@@ -96,6 +97,12 @@ namespace dtVoxel
       // This exists external objects can deform the grid, created a change message, and then tell the visual to update with the message.
       void UpdateVolume(const VolumeUpdateMessage& msg, bool updateVisualOnly);
 
+      /**
+       * @return the collision triangle cache of the physics geometry, or NULL if there is no voxel physics.
+       * UpdateVolume keeps it current, so code that edits the grids directly should call InvalidateVoxel on it.
+       */
+      VoxelCollisionCache* GetCollisionCache();
+
       /// Forces the background grid loading to block and complete.  It's also called when the loading actually completes
       void CompleteLoad();
    protected:
@@ -123,9 +130,13 @@ namespace dtVoxel
       template<typename GridTypePtr>
       void UpdateVolumeInternal(GridTypePtr grid, const dtCore::NamedArrayParameter* indices, const dtCore::NamedArrayParameter* values, bool updateVisualOnly);
 
+      template<typename GridTypePtr>
+      void UpdateVolumeBricks(GridTypePtr grid, const VolumeUpdateMessage& msg, bool updateVisualOnly);
+
       dtCore::RefPtr<ReadOVDBThreadPoolTask> mLoader;
 
       dtCore::RefPtr<VoxelGrid> mVisualGrid;
+      dtCore::RefPtr<VoxelCollisionCache> mCollisionCache;
       openvdb::GridPtrVecPtr mGrids;
       std::vector<VolumeUpdateMessagePtr> mUpdateMessages;
       int mTicksSinceVisualUpdate;
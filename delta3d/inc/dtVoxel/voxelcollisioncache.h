@@ -0,0 +1,190 @@
+/* -*-c++-*-
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef DTVOXEL_VOXELCOLLISIONCACHE_H_
+#define DTVOXEL_VOXELCOLLISIONCACHE_H_
+
+#include <dtVoxel/export.h>
+#include <dtVoxel/physicstesselationmode.h>
+#include <dtCore/refptr.h>
+#include <osg/Referenced>
+#include <OpenThreads/Mutex>
+#include <openvdb/openvdb.h>
+#include <bitset>
+#include <map>
+#include <vector>
+
+namespace dtVoxel
+{
+   /**
+    * Caches the collision triangles of a voxel grid in blocks the size of the openvdb leaf nodes, so the physics
+    * doesn't tessellate the same voxels for every query, and an edit only rebuilds the blocks it touches.
+    * Blocks are built lazily by GetBlock, which is safe to call from the physics threads.
+    */
+   class DT_VOXEL_EXPORT VoxelCollisionCache : public osg::Referenced
+   {
+   public:
+      static const int BLOCK_DIM = openvdb::FloatTree::LeafNodeType::DIM;
+
+      struct Triangle
+      {
+         openvdb::Vec3s mVertices[3];
+         openvdb::Coord mVoxel;
+         int mPartId;
+         int mTriangleIndex;
+
+         bool operator==(const Triangle& other) const;
+         bool operator!=(const Triangle& other) const { return !(*this == other); }
+      };
+
+      class Block : public osg::Referenced
+      {
+      public:
+         Block() {}
+         std::vector<Triangle> mTriangles;
+      protected:
+         ~Block() {}
+      };
+
+      typedef dtCore::RefPtr<const Block> BlockPtr;
+
+      static openvdb::Coord GetBlockOrigin(const openvdb::Coord& voxel)
+      {
+         return voxel & ~(BLOCK_DIM - 1);
+      }
+
+      /// @return the triangles for the block that holds the given voxel, building them if they aren't cached.
+      BlockPtr GetBlock(const openvdb::Coord& voxel);
+
+      /**
+       * Call after changing a voxel.  It drops the block holding the voxel, plus any neighboring block with a voxel
+       * that shares a face with it, since whether that face is exposed depends on this voxel.
+       */
+      void InvalidateVoxel(const openvdb::Coord& voxel);
+
+      /// Drops every block, such as when the whole grid changes.
+      void InvalidateAll();
+
+      unsigned GetNumCachedBlocks() const;
+
+      /// @return the number of times a block has been built, so the cost of the incremental updates can be checked.
+      unsigned GetNumBlocksBuilt() const;
+
+      PhysicsTesselationMode& GetTesselationMode() const { return mTesselationMode; }
+      int GetPartIdScale() const { return mPartIdScale; }
+
+   protected:
+      /**
+       * @param partIdScale The part id of a triangle is partIdScale * x + y of its voxel.
+       */
+      VoxelCollisionCache(int partIdScale, PhysicsTesselationMode& mode);
+      virtual ~VoxelCollisionCache();
+
+      /// Fills the block with the triangles for the active voxels in the block starting at origin.
+      virtual void BuildBlock(const openvdb::Coord& origin, Block& block) const = 0;
+
+      /**
+       * Adds the triangles for the faces of an active voxel that aren't against another active voxel.
+       * The neighbors are in the order -x, +z, +x, -z, +y, -y.
+       */
+      void AddVoxelTriangles(const openvdb::Coord& voxel, const openvdb::BBoxd& worldBox,
+               const std::bitset<6>& activeNeighbors, std::vector<Triangle>& toFill) const;
+
+   private:
+      typedef std::map<openvdb::Coord, dtCore::RefPtr<Block> > BlockMap;
+
+      mutable OpenThreads::Mutex mMutex;
+      BlockMap mBlocks;
+      int mPartIdScale;
+      PhysicsTesselationMode& mTesselationMode;
+      unsigned mTriCount;
+      unsigned mNumBlocksBuilt;
+   };
+
+   template<typename GridType>
+   class VoxelGridCollisionCache : public VoxelCollisionCache
+   {
+   public:
+      typedef typename GridType::ConstPtr GridPtr;
+      typedef typename GridType::TreeType::LeafNodeType LeafType;
+
+      VoxelGridCollisionCache(GridPtr grid, int partIdScale, PhysicsTesselationMode& mode = PhysicsTesselationMode::BOX_2_TRI_PER_SIDE)
+      : VoxelCollisionCache(partIdScale, mode)
+      , mGrid(grid)
+      {
+      }
+
+      GridPtr GetGrid() const { return mGrid; }
+
+   protected:
+      ~VoxelGridCollisionCache() {}
+
+      void BuildBlock(const openvdb::Coord& origin, Block& block) const override
+      {
+         typename GridType::ConstAccessor ca = mGrid->getConstAccessor();
+         const LeafType* leaf = mGrid->tree().probeConstLeaf(origin);
+         if (leaf != NULL)
+         {
+            for (typename LeafType::ValueOnCIter itr = leaf->cbeginValueOn(); itr; ++itr)
+            {
+               AddVoxel(ca, itr.getCoord(), block);
+            }
+         }
+         else if (ca.isValueOn(origin))
+         {
+            // The block is one active tile, so only the voxels on its surface can have exposed faces.
+            openvdb::Coord voxel;
+            for (int i = origin.x(), iend = origin.x() + BLOCK_DIM; i < iend; ++i)
+            {
+               for (int j = origin.y(), jend = origin.y() + BLOCK_DIM; j < jend; ++j)
+               {
+                  for (int k = origin.z(), kend = origin.z() + BLOCK_DIM; k < kend; ++k)
+                  {
+                     voxel.reset(i, j, k);
+                     AddVoxel(ca, voxel, block);
+                  }
+               }
+            }
+         }
+      }
+
+   private:
+      void AddVoxel(typename GridType::ConstAccessor& ca, const openvdb::Coord& voxel, Block& block) const
+      {
+         std::bitset<6> activeNeighbors;
+         activeNeighbors[0] = ca.isValueOn(openvdb::Coord(voxel.x()-1, voxel.y(), voxel.z()));
+         activeNeighbors[1] = ca.isValueOn(openvdb::Coord(voxel.x(), voxel.y(), voxel.z()+1));
+         activeNeighbors[2] = ca.isValueOn(openvdb::Coord(voxel.x()+1, voxel.y(), voxel.z()));
+         activeNeighbors[3] = ca.isValueOn(openvdb::Coord(voxel.x(), voxel.y(), voxel.z()-1));
+         activeNeighbors[4] = ca.isValueOn(openvdb::Coord(voxel.x(), voxel.y()+1, voxel.z()));
+         activeNeighbors[5] = ca.isValueOn(openvdb::Coord(voxel.x(), voxel.y()-1, voxel.z()));
+         if (activeNeighbors.all())
+            return;
+
+         openvdb::BBoxd iBox(openvdb::Vec3d(double(voxel.x()), double(voxel.y()), double(voxel.z())), 0);
+         iBox.expand(0.5f);
+         AddVoxelTriangles(voxel, mGrid->transform().indexToWorld(iBox), activeNeighbors, block.mTriangles);
+      }
+
+      GridPtr mGrid;
+   };
+} /* namespace dtVoxel */
+
+#endif /* DTVOXEL_VOXELCOLLISIONCACHE_H_ */
@@ -24,10 +24,10 @@
 #include <dtPhysics/geometry.h>
 #include <dtVoxel/aabbintersector.h>
 #include <dtVoxel/physicstesselationmode.h>
+#include <dtVoxel/voxelcollisioncache.h>
 #include <pal/palFactory.h>
 #include <pal/palGeometry.h>
 #include <openvdb/openvdb.h>
-#include <bitset>
 #include <dtCore/camera.h>
 #include <osg/io_utils>
 
@@ -51,33 +51,20 @@ namespace dtVoxel
       : palCustomGeometryCallback(shapeBoundingBox)
       , mGrid(grid)
       , mTesselationMode(mode)
+      , mCache(new VoxelGridCollisionCache<GridType>(grid, int(shapeBoundingBox.max.x - shapeBoundingBox.min.x), mode))
       {
-         mTriCount = mode == PhysicsTesselationMode::BOX_2_TRI_PER_SIDE ? 12U : 6U;
       }
 
       ~ColliderCallback()  {}
 
+      /// The triangles are cached per block, so edits to the grid must invalidate the voxels they change.
+      VoxelCollisionCache& GetCollisionCache() { return *mCache; }
+
       /**
        * Override this to return the triangles within the given axis aligned bounding box.
        */
       virtual void operator()(const palBoundingBox& bbBox, palTriangleCallback& callback)
       {
-         static const int faces[] =
-               {
-                     0, 3, 2,
-                     0, 2, 1, // -x
-                     0, 1, 4,
-                     6, 0, 4, // +z
-                     4, 5, 6,
-                     5, 7, 6, // +x
-                     5, 3, 7,
-                     2, 3, 5, // -z
-                     0, 6, 3,
-                     3, 6, 7, // +y
-                     4, 2, 5,
-                     1, 2, 4  // -y
-               };
-         //typedef typename GridType::ValueOnIter GridItr;
          openvdb::BBoxd worldBoundingBox(openvdb::Vec3d(bbBox.min.x,bbBox.min.y,bbBox.min.z), openvdb::Vec3d(bbBox.max.x,bbBox.max.y,bbBox.max.z));
          openvdb::CoordBBox collideBox;
          GridPtr grid = mGrid;
@@ -106,85 +93,48 @@ namespace dtVoxel
             debugDraw = true;
          }
 
-         const palBoundingBox& fullBoundingBox = GetBoundingBox();
-         typename GridType::ConstAccessor ca = mGrid->getConstAccessor();
-
-         unsigned divisor = mTriCount/6U;
-         unsigned faceMultiplier = 3U * (12U/mTriCount);
-
 #ifdef VOXEL_PHYSICS_GEOM_LOGGING
          std::cout << " collision box: " << collideBox << std::endl;
 #endif
-         for (int i = collideBox.min().x(), iend = collideBox.max().x() + 1; i < iend; ++i)
+         const int blockDim = VoxelCollisionCache::BLOCK_DIM;
+         const openvdb::Coord firstBlock = VoxelCollisionCache::GetBlockOrigin(collideBox.min());
+         const openvdb::Coord lastBlock = VoxelCollisionCache::GetBlockOrigin(collideBox.max());
+         for (int i = firstBlock.x(); i <= lastBlock.x(); i += blockDim)
          {
-            for (int j = collideBox.min().y(), jend = collideBox.max().y() + 1; j < jend; ++j)
+            for (int j = firstBlock.y(); j <= lastBlock.y(); j += blockDim)
             {
-               int partId = (fullBoundingBox.max.x - fullBoundingBox.min.x) * i + j;
-
-               for (int k = collideBox.min().z(), kend = collideBox.max().z() + 1; k < kend; ++k)
+               for (int k = firstBlock.z(); k <= lastBlock.z(); k += blockDim)
                {
-                  openvdb::math::Coord coord(i, j, k);
-                  if (!ca.isValueOn(coord))
-                     continue;
-
-                  openvdb::BBoxd iBox(openvdb::Vec3d(double(coord.x()), double(coord.y()), double(coord.z())), 0);
-                  iBox.expand(0.5f);
-#ifdef VOXEL_PHYSICS_GEOM_LOGGING
-                  std::cout << "Voxel in collision box: " << iBox << std::endl;
-#endif
-                  openvdb::BBoxd voxelBBox = grid->transform().indexToWorld(iBox);
-                  std::bitset<6> activeNeighbors;
-                  activeNeighbors[0] = ca.isValueOn(openvdb::Coord(coord.x()-1,coord.y(),coord.z()));
-                  activeNeighbors[1] = ca.isValueOn(openvdb::Coord(coord.x(),coord.y(),coord.z()+1));
-                  activeNeighbors[2] = ca.isValueOn(openvdb::Coord(coord.x()+1,coord.y(),coord.z()));
-                  activeNeighbors[3] = ca.isValueOn(openvdb::Coord(coord.x(),coord.y(),coord.z()-1));
-                  activeNeighbors[4] = ca.isValueOn(openvdb::Coord(coord.x(),coord.y()+1,coord.z()));
-                  activeNeighbors[5] = ca.isValueOn(openvdb::Coord(coord.x(),coord.y()-1,coord.z()));
-                  openvdb::math::Vec3<Float> min = voxelBBox.min();
-                  openvdb::math::Vec3<Float> max = voxelBBox.max();
-#ifdef VOXEL_PHYSICS_GEOM_LOGGING
-                  std::cout << " Neighbors ";
-                  for (unsigned n = 0 ; n < 6 ; ++n) std::cout << activeNeighbors[n];
-                  std::cout << std::endl;
-                  std::cout << "voxel min max: " << min << max << std::endl;
-#endif
-                  Float cube_vertices[] =
-                        {
-                              min.x(),  max.y(),  max.z(),
-                              min.x(),  min.y(),  max.z(),
-                              min.x(),  min.y(),  min.z(),
-                              min.x(),  max.y(),  min.z(),
-                              max.x(),  min.y(),  max.z(),
-                              max.x(),  min.y(),  min.z(),
-                              max.x(),  max.y(),  max.z(),
-                              max.x(),  max.y(),  min.z()
-                        };
-
-                  int baseTriIdx = (mTriCount * k);
-                  for (unsigned triIdx=0; triIdx < mTriCount; ++triIdx)
+                  VoxelCollisionCache::BlockPtr block = mCache->GetBlock(openvdb::Coord(i, j, k));
+                  const openvdb::Coord* lastVoxel = NULL;
+                  for (std::vector<VoxelCollisionCache::Triangle>::const_iterator itr = block->mTriangles.begin(), itrEnd = block->mTriangles.end();
+                           itr != itrEnd; ++itr)
                   {
-                     if (!activeNeighbors[triIdx/divisor])
-                     {
-                        palTriangle triangle;
+                     const VoxelCollisionCache::Triangle& cached = *itr;
+                     if (!collideBox.isInside(cached.mVoxel))
+                        continue;
+                     // in debug draw, only output the first triangle of each voxel.
+                     if (debugDraw && lastVoxel != NULL && *lastVoxel == cached.mVoxel)
+                        continue;
+                     lastVoxel = &cached.mVoxel;
+
+                     palTriangle triangle;
 #ifdef VOXEL_PHYSICS_GEOM_LOGGING
-                        std::cout << "triangle ";
+                     std::cout << "triangle ";
 #endif
-                        for (unsigned vertIdx = 0; vertIdx < 3; ++vertIdx)
-                        {
-                           unsigned faceIdx = faceMultiplier * triIdx + vertIdx;
-                           triangle.vertices[vertIdx].x = cube_vertices[3 * faces[faceIdx] + 0];
-                           triangle.vertices[vertIdx].y = cube_vertices[3 * faces[faceIdx] + 1];
-                           triangle.vertices[vertIdx].z = cube_vertices[3 * faces[faceIdx] + 2];
+                     for (unsigned vertIdx = 0; vertIdx < 3; ++vertIdx)
+                     {
+                        triangle.vertices[vertIdx].x = cached.mVertices[vertIdx].x();
+                        triangle.vertices[vertIdx].y = cached.mVertices[vertIdx].y();
+                        triangle.vertices[vertIdx].z = cached.mVertices[vertIdx].z();
 #ifdef VOXEL_PHYSICS_GEOM_LOGGING
-                           std::cout << "[" << triangle.vertices[vertIdx].x << " " << triangle.vertices[vertIdx].y << " " << triangle.vertices[vertIdx].z << "]";
+                        std::cout << "[" << triangle.vertices[vertIdx].x << " " << triangle.vertices[vertIdx].y << " " << triangle.vertices[vertIdx].z << "]";
 #endif
-                        }
+                     }
 #ifdef VOXEL_PHYSICS_GEOM_LOGGING
-                        std::cout << std::endl;
+                     std::cout << std::endl;
 #endif
-                        callback.ProcessTriangle(triangle, partId,  baseTriIdx + triIdx);
-                        if (debugDraw) break; // in debug draw, exit after the first triangle is output.
-                     }
+                     callback.ProcessTriangle(triangle, cached.mPartId, cached.mTriangleIndex);
                   }
                }
             }
@@ -193,7 +143,7 @@ namespace dtVoxel
 
       GridPtr mGrid;
       PhysicsTesselationMode& mTesselationMode;
-      unsigned mTriCount;
+      dtCore::RefPtr<VoxelGridCollisionCache<GridType> > mCache;
    };
 
    class DT_VOXEL_EXPORT VoxelGeometry : public dtPhysics::Geometry
@@ -214,13 +164,23 @@ namespace dtVoxel
          palBB.min.Set(Float(start.x()), Float(start.y()), Float(start.z()));
          palBB.max.Set(Float(end.x()), Float(end.y()), Float(end.z()));
          ColliderCallback<GridType>* cc = new ColliderCallback<GridType>(palBB, grid, mode);
-         return CreateVoxelGeometryWithCallback(worldxform, mass, cc);
+         dtCore::RefPtr<VoxelGeometry> result = CreateVoxelGeometryWithCallback(worldxform, mass, cc);
+         if (result.valid())
+         {
+            result->mCollisionCache = &cc->GetCollisionCache();
+         }
+         return result;
       }
       static dtCore::RefPtr<VoxelGeometry> CreateVoxelGeometryWithCallback(const dtCore::Transform& worldxform, float mass, palCustomGeometryCallback* callBack);
 
+      /// @return the triangle cache of the geometry if it was made with CreateVoxelGeometry, or NULL.
+      VoxelCollisionCache* GetCollisionCache();
+
    protected:
       VoxelGeometry();
       virtual ~VoxelGeometry();
+   private:
+      dtCore::RefPtr<VoxelCollisionCache> mCollisionCache;
    };
 
    typedef dtCore::RefPtr<VoxelGeometry> VoxelGeometryPtr;
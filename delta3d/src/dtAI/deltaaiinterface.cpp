@@ -48,8 +48,6 @@ namespace dtAI
    DeltaAIInterface::DeltaAIInterface()
       : mWaypointGraph(new WaypointGraph())
       , mAStar(*mWaypointGraph)
-      , mKDTreeDirty(true)
-      , mKDTree(new WaypointKDTree(std::ptr_fun(KDHolderIndexFunc)))
    {
    }
 
@@ -67,10 +65,7 @@ namespace dtAI
             mDrawable->InsertWaypoint(*waypoint);
          }
 
-         KDHolder node(waypoint->GetPosition(), waypoint->GetID());
-         mKDTree->insert(node);
-
-         mKDTreeDirty = true;
+         mWaypointTree.Insert(waypoint->GetPosition(), waypoint);
       }
    }
 
@@ -88,10 +83,7 @@ namespace dtAI
             mDrawable->InsertWaypoint(*waypoint);
          }
 
-         KDHolder node(waypoint->GetPosition(), waypoint->GetID());
-         mKDTree->insert(node);
-
-         mKDTreeDirty = true;
+         mWaypointTree.Insert(waypoint->GetPosition(), waypoint);
       }
    }
 
@@ -125,10 +117,7 @@ namespace dtAI
                mDrawable->InsertWaypoint(*parentWp);
             }
 
-            KDHolder node(parentWp->GetPosition(), parentWp->GetID());
-            mKDTree->insert(node);
-
-            mKDTreeDirty = true;
+            mWaypointTree.Insert(parentWp->GetPosition(), parentWp);
          }
 
          return true;
@@ -140,17 +129,8 @@ namespace dtAI
    /////////////////////////////////////////////////////////////////////////////
    bool DeltaAIInterface::MoveWaypoint(WaypointInterface* wi, const osg::Vec3& newPos)
    {
-      // the kd-tree cannot move :( for now remove and re-insert
-      osg::Vec3 pos = wi->GetPosition();
-
-      find_result found = mKDTree->find_nearest(pos, 1.0f);
-      if (found.first != mKDTree->end() && (*found.first).mID == wi->GetID())
+      if (mWaypointTree.Move(wi->GetPosition(), newPos, wi))
       {
-         mKDTree->erase(found.first);
-
-         KDHolder node(newPos, wi->GetID());
-         mKDTree->insert(node);
-
          wi->SetPosition(newPos);
 
          // re-insert to move
@@ -162,7 +142,6 @@ namespace dtAI
             mDrawable->InsertWaypoint(*wi);
          }
 
-         mKDTreeDirty = true;
          return true;
       }
 
@@ -174,38 +153,24 @@ namespace dtAI
    {
       bool result = false;
 
-      osg::Vec3 pos = wi->GetPosition();
-      std::vector<KDHolder> v;
-
-      mKDTree->find_within_range(pos, 0.1f, std::back_inserter(v));
-
-      std::vector<KDHolder>::const_iterator iter = v.begin();
-      std::vector<KDHolder>::const_iterator iterEnd = v.end();
-      for (; iter != iterEnd; ++iter)
+      // Like the old kd-tree lookup, allow the caller's position to be a little off.
+      WaypointInterface* wpPtr = GetWaypointById(wi->GetID());
+      if (wpPtr != NULL && mWaypointTree.Remove(wi->GetPosition(), wpPtr, 0.1f))
       {
-         WaypointInterface* wpPtr = GetWaypointById(iter->mID);
-         if (wpPtr != NULL && wpPtr->GetID() == wi->GetID())
+         // remove from current drawable
+         if (mDrawable.valid())
          {
-            // remove from current drawable
-            if (mDrawable.valid())
-            {
-               RemoveAllEdges(wpPtr->GetID());
-               mDrawable->RemoveWaypoint(wpPtr->GetID());
-            }
-
-            // remove from kd-tree
-            mKDTree->erase(*iter);
-            mKDTreeDirty = true;
+            RemoveAllEdges(wpPtr->GetID());
+            mDrawable->RemoveWaypoint(wpPtr->GetID());
+         }
 
-            // remove from waypoint graph
-            mWaypointGraph->RemoveWaypoint(wpPtr->GetID());
+         // remove from waypoint graph
+         mWaypointGraph->RemoveWaypoint(wpPtr->GetID());
 
-            // finally remove it from internal array
-            dtUtil::array_remove<WaypointRefArray> rm(mWaypoints);
-            dtCore::RefPtr<WaypointInterface> wpRef = wpPtr;
-            result = rm(wpRef);
-            break;
-         }
+         // finally remove it from internal array
+         dtUtil::array_remove<WaypointRefArray> rm(mWaypoints);
+         dtCore::RefPtr<WaypointInterface> wpRef = wpPtr;
+         result = rm(wpRef);
       }
 
       return result;
@@ -352,7 +317,7 @@ namespace dtAI
    /////////////////////////////////////////////////////////////////////////////
    void DeltaAIInterface::ClearMemory()
    {
-      mKDTree->clear();
+      mWaypointTree.Clear();
 
       if (mDrawable.valid())
       {
@@ -424,6 +389,9 @@ namespace dtAI
          }
       }
 
+      // pack the freshly loaded waypoints into a single tree
+      Optimize();
+
       mLastFileLoaded = filename;
       return result;
    }
@@ -536,78 +504,64 @@ namespace dtAI
    }
 
    /////////////////////////////////////////////////////////////////////////////
-   WaypointInterface* DeltaAIInterface::GetClosestWaypoint(const osg::Vec3& pos, float maxRadius)
+   namespace
    {
-      if (mKDTreeDirty)
+      struct WaypointNameFilter
       {
-         Optimize();
-      }
-
-      WaypointInterface* result = NULL;
+         explicit WaypointNameFilter(const std::string& name) : mName(name) {}
+         bool operator()(WaypointInterface* wp) const { return wp->ToString() == mName; }
+         const std::string& mName;
+      };
 
-      find_result found = mKDTree->find_nearest(pos, maxRadius);
-      if (found.first != mKDTree->end())
+      struct WaypointTypeFilter
       {
-         result = GetWaypointById(found.first->mID);
-      }
+         explicit WaypointTypeFilter(const dtCore::ObjectType& type) : mType(type) {}
+         bool operator()(WaypointInterface* wp) const { return wp->GetWaypointType() == mType; }
+         const dtCore::ObjectType& mType;
+      };
+   }
 
+   /////////////////////////////////////////////////////////////////////////////
+   WaypointInterface* DeltaAIInterface::GetClosestWaypoint(const osg::Vec3& pos, float maxRadius)
+   {
+      WaypointInterface* result = NULL;
+      mWaypointTree.FindNearest(pos, maxRadius, result);
       return result;
    }
 
-
    /////////////////////////////////////////////////////////////////////////////
    WaypointInterface* DeltaAIInterface::GetClosestNamedWaypoint(const std::string& name, const osg::Vec3& pos, float maxRadius)
    {
-      WaypointInterface* closestPoint = NULL;
-
-      WaypointRefArray::const_iterator iter = mWaypoints.begin();
-      WaypointRefArray::const_iterator iterEnd = mWaypoints.end();
-
-      float minDistance = FLT_MAX;
+      WaypointInterface* result = NULL;
+      mWaypointTree.FindNearest(pos, maxRadius, result, WaypointNameFilter(name));
+      return result;
+   }
 
-      for (;iter != iterEnd; ++iter)
-      {
-         if ((*iter)->ToString() == name)
-         {
-            float distanceSquared = ((*iter)->GetPosition() - pos).length2();
-            if (distanceSquared < minDistance && distanceSquared < osg::square(maxRadius))
-            {
-               minDistance = distanceSquared;
-               closestPoint = *iter;
-            }
-         }
-      }
+   /////////////////////////////////////////////////////////////////////////////
+   WaypointInterface* DeltaAIInterface::GetClosestWaypointOfType(const dtCore::ObjectType& type, const osg::Vec3& pos, float maxRadius)
+   {
+      WaypointInterface* result = NULL;
+      mWaypointTree.FindNearest(pos, maxRadius, result, WaypointTypeFilter(type));
+      return result;
+   }
 
-      return closestPoint;
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned DeltaAIInterface::GetClosestWaypoints(const std::vector<osg::Vec3>& positions, float maxRadius, WaypointArray& arrayToFill)
+   {
+      return unsigned(mWaypointTree.FindNearestBatch(positions, maxRadius, arrayToFill, NULL));
    }
 
    /////////////////////////////////////////////////////////////////////////////
    bool DeltaAIInterface::GetWaypointsAtRadius(const osg::Vec3& pos, float radius, WaypointArray& arrayToFill)
    {
-      if (mKDTreeDirty)
-      {
-         Optimize();
-      }
-
-      std::vector<KDHolder> v;
-
-      mKDTree->find_within_range(pos, radius, std::back_inserter(v));
-
-      std::vector<KDHolder>::const_iterator iter = v.begin();
-      std::vector<KDHolder>::const_iterator iterEnd = v.end();
-      for (; iter != iterEnd; ++iter)
-      {
-         WaypointInterface* wi = GetWaypointById(iter->mID);
-         if (wi != NULL)
-         {
-            arrayToFill.push_back(wi);
-         }
-         else
-         {
-            LOG_ERROR("Error searching for waypoints.");
-         }
-      }
+      mWaypointTree.FindInRadius(pos, radius, std::back_inserter(arrayToFill));
+      return !arrayToFill.empty();
+   }
 
+   /////////////////////////////////////////////////////////////////////////////
+   bool DeltaAIInterface::GetWaypointsOfTypeAtRadius(const dtCore::ObjectType& type, const osg::Vec3& pos, float radius, WaypointArray& arrayToFill)
+   {
+      mWaypointTree.FindInRadius(pos, radius, std::back_inserter(arrayToFill), WaypointTypeFilter(type));
       return !arrayToFill.empty();
    }
 
@@ -615,13 +569,11 @@ namespace dtAI
    DeltaAIInterface::~DeltaAIInterface()
    {
       ClearMemory();
-      delete mKDTree;
    }
 
    /////////////////////////////////////////////////////////////////////////////
    void DeltaAIInterface::Optimize()
    {
-      mKDTree->optimize();
-      mKDTreeDirty = false;
+      mWaypointTree.Optimize();
    }
 }
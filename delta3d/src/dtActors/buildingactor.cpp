@@ -272,6 +272,8 @@ namespace dtActors
          return;
       }
 
+      MarkBatchDirty(pointIndex);
+
       BuildingGeomNode* point = dynamic_cast<BuildingGeomNode*>(GetPointDrawable(pointIndex));
       // If the drawable is not the proper class, regenerate it.
       if (!point)
@@ -239,6 +239,8 @@ namespace dtActors
          return;
       }
 
+      MarkBatchDirty(pointIndex);
+
       // If there are no meshes setup for the posts yet, use the default sphere/line schema.
       if (mPostResourceList.empty() || mSegmentPointList.empty())
       {
@@ -4,9 +4,12 @@
 #include <dtCore/transformable.h>
 
 #include <dtCore/arrayactorproperty.h>
+#include <dtCore/booleanactorproperty.h>
 #include <dtCore/containeractorproperty.h>
 #include <dtCore/functor.h>
+#include <dtCore/intactorproperty.h>
 #include <dtCore/mapxml.h>
+#include <dtCore/observerptr.h>
 #include <dtCore/project.h>
 #include <dtCore/vectoractorproperties.h>
 
@@ -16,6 +19,15 @@
 
 #include <dtUtil/exception.h>
 
+#include <algorithm>
+
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+#include <osg/NodeCallback>
+#include <osg/NodeVisitor>
+#include <osg/Transform>
+#include <osgUtil/Optimizer>
+
 namespace dtActors
 {
    bool LinkedPointsGeomData::Initialize()
@@ -84,6 +96,142 @@ namespace dtActors
    }
 
 
+   ////////////////////////////////////////////////////////////////////////////////
+   // BATCHING HELPERS
+   ////////////////////////////////////////////////////////////////////////////////
+   namespace
+   {
+      /**
+      * Prepares a copied point subgraph to be flattened and merged.
+      * Transforms are marked static, callbacks are stripped and
+      * per primitive set normals are expanded to per vertex normals so
+      * the optimizer is able to merge the geometry.
+      */
+      class BatchPrepareVisitor : public osg::NodeVisitor
+      {
+      public:
+         BatchPrepareVisitor()
+            : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN)
+         {
+         }
+
+         virtual void apply(osg::Node& node)
+         {
+            node.setUpdateCallback(NULL);
+            node.setCullCallback(NULL);
+            node.setEventCallback(NULL);
+            traverse(node);
+         }
+
+         virtual void apply(osg::Transform& node)
+         {
+            node.setDataVariance(osg::Object::STATIC);
+            apply(static_cast<osg::Node&>(node));
+         }
+
+         virtual void apply(osg::Geode& geode)
+         {
+            for (unsigned i = 0; i < geode.getNumDrawables(); ++i)
+            {
+               osg::Geometry* geom = geode.getDrawable(i)->asGeometry();
+               if (geom != NULL)
+               {
+                  geom->setDataVariance(osg::Object::STATIC);
+                  ExpandPrimitiveSetNormals(*geom);
+               }
+            }
+            apply(static_cast<osg::Node&>(geode));
+         }
+
+         static void ExpandPrimitiveSetNormals(osg::Geometry& geom)
+         {
+            const osg::Vec3Array* normals = dynamic_cast<const osg::Vec3Array*>(geom.getNormalArray());
+            const osg::Array* vertices = geom.getVertexArray();
+            if (normals == NULL || vertices == NULL ||
+               geom.getNormalBinding() != osg::Geometry::BIND_PER_PRIMITIVE_SET ||
+               normals->size() < geom.getNumPrimitiveSets())
+            {
+               return;
+            }
+
+            // Only plain draw arrays can be expanded, since every vertex belongs to one primitive set.
+            for (unsigned i = 0; i < geom.getNumPrimitiveSets(); ++i)
+            {
+               if (dynamic_cast<const osg::DrawArrays*>(geom.getPrimitiveSet(i)) == NULL)
+               {
+                  return;
+               }
+            }
+
+            dtCore::RefPtr<osg::Vec3Array> perVertex = new osg::Vec3Array(vertices->getNumElements());
+            for (unsigned i = 0; i < geom.getNumPrimitiveSets(); ++i)
+            {
+               const osg::DrawArrays* prim = static_cast<const osg::DrawArrays*>(geom.getPrimitiveSet(i));
+               unsigned last = std::min(unsigned(prim->getFirst() + prim->getCount()), unsigned(perVertex->size()));
+               for (unsigned v = unsigned(prim->getFirst()); v < last; ++v)
+               {
+                  (*perVertex)[v] = (*normals)[i];
+               }
+            }
+
+            geom.setNormalArray(perVertex.get());
+            geom.setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
+         }
+      };
+
+      /**
+      * Rebuilds the dirty batch chunks of a linked points actor during
+      * the update traversal.
+      */
+      class BatchUpdateCallback : public osg::NodeCallback
+      {
+      public:
+         BatchUpdateCallback(LinkedPointsActor& actor)
+            : mActor(&actor)
+         {
+         }
+
+         virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+         {
+            if (mActor.valid())
+            {
+               mActor->UpdateBatches();
+            }
+            traverse(node, nv);
+         }
+
+      private:
+         dtCore::ObserverPtr<LinkedPointsActor> mActor;
+      };
+
+      /**
+      * Skips the cull traversal of a point node while the chunk that draws
+      * it is attached.  The node mask is left alone so the point can still
+      * be intersected.
+      */
+      class BatchedPointCullCallback : public osg::NodeCallback
+      {
+      public:
+         BatchedPointCullCallback(osg::Node& chunk)
+            : mChunk(&chunk)
+         {
+         }
+
+         virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+         {
+            // Until the chunk is live the point draws itself, so it is never drawn twice or not at all.
+            if (mChunk.valid() && mChunk->getNumParents() > 0)
+            {
+               return;
+            }
+            traverse(node, nv);
+         }
+
+      private:
+         dtCore::ObserverPtr<osg::Node> mChunk;
+      };
+   }
+
    ////////////////////////////////////////////////////////////////////////////////
    // LINKED POINTS GEOM NODE BASE
    ////////////////////////////////////////////////////////////////////////////////
@@ -161,7 +309,13 @@ namespace dtActors
       : BaseClass(name)
       , mProxy(proxy)
       , mVisualize(false)
+      , mBatchGeometry(false)
+      , mBatchChunkSize(16)
+      , mBatchRoot(new osg::Group())
    {
+      mBatchRoot->setName("LinkedPointsBatches");
+      mBatchRoot->setUpdateCallback(new BatchUpdateCallback(*this));
+      GetMatrixNode()->addChild(mBatchRoot.get());
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -201,6 +355,8 @@ namespace dtActors
          return;
       }
 
+      MarkBatchDirty(pointIndex);
+
       dtActors::LinkedPointsGeomNode* point =
          dynamic_cast<dtActors::LinkedPointsGeomNode*>(GetPointDrawable(pointIndex));
       // If the drawable is not of the proper class, regenerate it.
@@ -279,6 +435,7 @@ namespace dtActors
       else
       {
          mPointList.insert(mPointList.begin() + index, point);
+         MarkBatchDirtyFrom(index);
 
          // Update both the new point and the previous one.
          Visualize(index);
@@ -340,6 +497,7 @@ namespace dtActors
       }
 
       mPointList.erase(mPointList.begin() + index);
+      MarkBatchDirtyFrom(index);
 
       // Update the previous point that was connected to the removed point.
       Visualize(index - 1);
@@ -476,6 +634,7 @@ namespace dtActors
       }
 
       mPointList = pointList;
+      ClearBatches();
 
       Visualize();
    }
@@ -639,6 +798,201 @@ namespace dtActors
       }
    }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   void LinkedPointsActor::SetBatchGeometry(bool enabled)
+   {
+      if (mBatchGeometry == enabled)
+      {
+         return;
+      }
+
+      mBatchGeometry = enabled;
+      ClearBatches();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void LinkedPointsActor::SetBatchChunkSize(int size)
+   {
+      if (size < 1)
+      {
+         size = 1;
+      }
+
+      if (mBatchChunkSize == size)
+      {
+         return;
+      }
+
+      mBatchChunkSize = size;
+      ClearBatches();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool LinkedPointsActor::IsBatching() const
+   {
+      // Batched points can't be picked, so STAGE always edits the individual points.
+      return mBatchGeometry && !mProxy->IsInSTAGE();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   int LinkedPointsActor::GetDirtyBatchCount() const
+   {
+      int chunkCount = (GetPointCount() + mBatchChunkSize - 1) / mBatchChunkSize;
+      int dirtyCount = 0;
+      for (int chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+      {
+         // Chunks that have never been built are dirty too.
+         if (chunkIndex >= int(mBatchChunkDirty.size()) || mBatchChunkDirty[chunkIndex])
+         {
+            ++dirtyCount;
+         }
+      }
+      return dirtyCount;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void LinkedPointsActor::MarkBatchDirty(int pointIndex)
+   {
+      if (pointIndex < 0)
+      {
+         return;
+      }
+
+      unsigned chunkIndex = unsigned(pointIndex / mBatchChunkSize);
+      if (chunkIndex < mBatchChunkDirty.size())
+      {
+         mBatchChunkDirty[chunkIndex] = true;
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void LinkedPointsActor::MarkBatchDirtyFrom(int pointIndex)
+   {
+      if (pointIndex < 0)
+      {
+         pointIndex = 0;
+      }
+
+      for (unsigned chunkIndex = unsigned(pointIndex / mBatchChunkSize); chunkIndex < mBatchChunkDirty.size(); ++chunkIndex)
+      {
+         mBatchChunkDirty[chunkIndex] = true;
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void LinkedPointsActor::UpdateBatches()
+   {
+      if (!IsBatching() || mProxy->IsLoading())
+      {
+         return;
+      }
+
+      unsigned chunkCount = unsigned((GetPointCount() + mBatchChunkSize - 1) / mBatchChunkSize);
+
+      // Drop chunks past the end of the point list.
+      while (mBatchChunks.size() > chunkCount)
+      {
+         ShowBatchedPoints(unsigned(mBatchChunks.size() - 1));
+         mBatchRoot->removeChild(mBatchChunks.back().get());
+         mBatchChunks.pop_back();
+         mBatchChunkDirty.pop_back();
+         mBatchHiddenPoints.pop_back();
+      }
+
+      mBatchChunks.resize(chunkCount);
+      mBatchChunkDirty.resize(chunkCount, true);
+      mBatchHiddenPoints.resize(chunkCount);
+
+      for (unsigned chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+      {
+         if (mBatchChunkDirty[chunkIndex])
+         {
+            RebuildBatchChunk(int(chunkIndex));
+            mBatchChunkDirty[chunkIndex] = false;
+         }
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void LinkedPointsActor::RebuildBatchChunk(int chunkIndex)
+   {
+      int first = chunkIndex * mBatchChunkSize;
+      int last = std::min(first + mBatchChunkSize, GetPointCount());
+
+      // Copy the structure and geometry, but share state and images with the live points.
+      const osg::CopyOp copyOp(osg::CopyOp::DEEP_COPY_NODES | osg::CopyOp::DEEP_COPY_DRAWABLES |
+         osg::CopyOp::DEEP_COPY_ARRAYS | osg::CopyOp::DEEP_COPY_PRIMITIVES);
+
+      dtCore::RefPtr<osg::Group> chunk = new osg::Group();
+      for (int pointIndex = first; pointIndex < last; ++pointIndex)
+      {
+         osg::Node* pointNode = mPointList[pointIndex]->GetOSGNode();
+
+         dtCore::RefPtr<osg::Node> copy = osg::clone(pointNode, copyOp);
+         chunk->addChild(copy.get());
+      }
+
+      BatchPrepareVisitor prepare;
+      chunk->accept(prepare);
+
+      osgUtil::Optimizer optimizer;
+      optimizer.optimize(chunk.get(),
+         osgUtil::Optimizer::FLATTEN_STATIC_TRANSFORMS_DUPLICATING_SHARED_SUBGRAPHS |
+         osgUtil::Optimizer::REMOVE_REDUNDANT_NODES |
+         osgUtil::Optimizer::SHARE_DUPLICATE_STATE |
+         osgUtil::Optimizer::MERGE_GEODES |
+         osgUtil::Optimizer::MERGE_GEOMETRY);
+
+      if (mBatchChunks[chunkIndex].valid())
+      {
+         mBatchRoot->replaceChild(mBatchChunks[chunkIndex].get(), chunk.get());
+      }
+      else
+      {
+         mBatchRoot->addChild(chunk.get());
+      }
+      mBatchChunks[chunkIndex] = chunk.get();
+
+      // The chunk draws these points from now on.
+      ShowBatchedPoints(unsigned(chunkIndex));
+      std::vector<HiddenPoint>& hidden = mBatchHiddenPoints[chunkIndex];
+      for (int pointIndex = first; pointIndex < last; ++pointIndex)
+      {
+         osg::Node* pointNode = mPointList[pointIndex]->GetOSGNode();
+         dtCore::RefPtr<osg::NodeCallback> hide = new BatchedPointCullCallback(*chunk);
+         pointNode->addCullCallback(hide.get());
+         hidden.push_back(HiddenPoint(pointNode, hide));
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void LinkedPointsActor::ShowBatchedPoints(unsigned chunkIndex)
+   {
+      std::vector<HiddenPoint>& hidden = mBatchHiddenPoints[chunkIndex];
+      for (size_t i = 0; i < hidden.size(); ++i)
+      {
+         if (hidden[i].first.valid())
+         {
+            hidden[i].first->removeCullCallback(hidden[i].second.get());
+         }
+      }
+      hidden.clear();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void LinkedPointsActor::ClearBatches()
+   {
+      for (unsigned chunkIndex = 0; chunkIndex < mBatchHiddenPoints.size(); ++chunkIndex)
+      {
+         ShowBatchedPoints(chunkIndex);
+      }
+
+      mBatchRoot->removeChildren(0, mBatchRoot->getNumChildren());
+      mBatchChunks.clear();
+      mBatchChunkDirty.clear();
+      mBatchHiddenPoints.clear();
+   }
+
    /////////////////////////////////////////////////////////////////////////////
    // PROXY CODE
    /////////////////////////////////////////////////////////////////////////////
@@ -702,6 +1056,18 @@ namespace dtActors
       arrayProp->SetMinArraySize(1);
 
       AddProperty(arrayProp);
+
+      AddProperty(new dtCore::BooleanActorProperty(
+         "BatchGeometry", "Batch Geometry",
+         dtCore::BooleanActorProperty::SetFuncType(actor, &LinkedPointsActor::SetBatchGeometry),
+         dtCore::BooleanActorProperty::GetFuncType(actor, &LinkedPointsActor::GetBatchGeometry),
+         "Merges the geometry of neighboring points into static batches outside of STAGE.", "Points"));
+
+      AddProperty(new dtCore::IntActorProperty(
+         "BatchChunkSize", "Batch Chunk Size",
+         dtCore::IntActorProperty::SetFuncType(actor, &LinkedPointsActor::SetBatchChunkSize),
+         dtCore::IntActorProperty::GetFuncType(actor, &LinkedPointsActor::GetBatchChunkSize),
+         "The number of points merged into each batch.  Editing a point only rebuilds its batch.", "Points"));
    }
 
    //////////////////////////////////////////////////////////////////////////
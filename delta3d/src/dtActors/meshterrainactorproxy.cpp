@@ -48,6 +48,10 @@ namespace dtActors
       RemoveProperty("static mesh");
       dtCore::Object* drawable = GetDrawable<dtCore::Object>();
 
+      // Ground clamping and collision need the terrain as soon as it's in the scene.
+      RemoveProperty("LoadAsynchronously");
+      drawable->SetLoadAsynchronously(false);
+
       AddProperty(new dtCore::ResourceActorProperty(dtCore::DataType::TERRAIN,
          "terrain mesh", "Terrain Mesh",
          dtCore::ResourceActorProperty::SetDescFuncType(drawable, &dtCore::Object::SetMeshResource),
@@ -3,6 +3,10 @@
 
 #include <dtCore/scene.h>
 #include <dtCore/system.h>
+#include <dtCore/transform.h>
+
+#include <dtGame/gamemanager.h>
+#include <dtUtil/log.h>
 
 #include <assert.h>
 #include <iostream>
@@ -17,6 +21,7 @@ TriggerVolumeActor::TriggerVolumeActor(dtActors::TriggerVolumeActorProxy& proxy,
    : dtGame::GameActor(proxy, name)
    , mMaxTriggerCount(0)
    , mTriggerCount(0)
+   , mHalfExtents(1.0f, 1.0f, 1.0f)
 {
    RegisterInstance(this);
 
@@ -34,6 +39,85 @@ void TriggerVolumeActor::OnSystem(const dtUtil::RefString& str, double deltaSim,
 
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TriggerVolumeActor::SetHalfExtents(const osg::Vec3& halfExtents)
+{
+   mHalfExtents = halfExtents;
+
+   if (mSpatialIndex.valid())
+   {
+      mSpatialIndex->SetVolumeHalfExtents(GetUniqueId(), mHalfExtents);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TriggerVolumeActor::RegisterWithSpatialIndex()
+{
+   if (!IsGameActorProxyValid() || GetGameActorProxy().GetGameManager() == NULL)
+   {
+      return;
+   }
+
+   dtGame::SpatialIndexComponent* spatialIndex = NULL;
+   GetGameActorProxy().GetGameManager()->GetComponentByName(dtGame::SpatialIndexComponent::DEFAULT_NAME, spatialIndex);
+   if (spatialIndex == NULL)
+   {
+      LOG_WARNING("No SpatialIndexComponent was found in the GameManager, so trigger volume \"" + GetName() + "\" will never fire.");
+      return;
+   }
+
+   mSpatialIndex = spatialIndex;
+   mSpatialIndex->AddActor(GetGameActorProxy());
+   mSpatialIndex->AddVolume(GetUniqueId(), mHalfExtents,
+            dtGame::SpatialIndexComponent::VolumeEventFunc(this, &TriggerVolumeActor::OnVolumeEvent));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TriggerVolumeActor::UnregisterFromSpatialIndex()
+{
+   if (mSpatialIndex.valid())
+   {
+      mSpatialIndex->RemoveVolume(GetUniqueId());
+   }
+   mSpatialIndex = NULL;
+   mOccupancyList.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TriggerVolumeActor::OnVolumeEvent(const dtCore::UniqueId& /*volumeId*/, dtGame::GameActorProxy& actor,
+         dtGame::SpatialIndexComponent::VolumeEventType eventType)
+{
+   // Do not send events in STAGE.
+   if (IsGameActorProxyValid() && GetGameActorProxy().IsInSTAGE())
+   {
+      return;
+   }
+
+   dtCore::Transformable* xformable = actor.GetDrawable<dtCore::Transformable>();
+   if (xformable == NULL)
+   {
+      return;
+   }
+
+   if (eventType == dtGame::SpatialIndexComponent::VOLUME_ENTER)
+   {
+      // An expired trigger still tracks who leaves, but lets no one else in.
+      if (mMaxTriggerCount != 0 && mTriggerCount >= mMaxTriggerCount)
+      {
+         return;
+      }
+
+      if (mOccupancyList.insert(xformable).second)
+      {
+         TriggerEvent(xformable, ENTER_EVENT);
+      }
+   }
+   else if (mOccupancyList.erase(xformable) > 0)
+   {
+      TriggerEvent(xformable, LEAVE_EVENT);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool TriggerVolumeActor::RegisterListener(void* receiver, EventFuncType eventCallback)
 {
@@ -83,9 +167,17 @@ bool TriggerVolumeActor::IsActorInVolume(dtCore::Transformable* actor)
 
    if (actor)
    {
-      int numContacts = 0;
+      dtCore::Transform xform;
+      GetTransform(xform);
+      osg::Vec3 center;
+      xform.GetTranslation(center);
+
+      actor->GetTransform(xform);
+      osg::Vec3 pos;
+      xform.GetTranslation(pos);
 
-      inVolume = numContacts > 0;
+      osg::BoundingBox box(center - mHalfExtents, center + mHalfExtents);
+      inVolume = box.contains(pos);
    }
 
    return inVolume;
@@ -138,6 +230,7 @@ void TriggerVolumeActor::TriggerEvent(dtCore::Transformable* instigator, Trigger
          if (mOccupancyList.empty())
          {
             DeregisterInstance(this);
+            UnregisterFromSpatialIndex();
          }
       }
    }
@@ -24,12 +24,14 @@
 
 #include <dtCore/datatype.h>
 #include <dtCore/intactorproperty.h>
+#include <dtCore/vectoractorproperties.h>
 #include <dtCore/actorproxyicon.h>
 
 using namespace dtActors;
 
 const dtUtil::RefString TriggerVolumeActorProxy::CLASS_NAME("dtActors::TriggerVolumeActorProxy");
 const dtUtil::RefString TriggerVolumeActorProxy::PROPERTY_MAX_TRIGGER_COUNT("MaxTriggerCount");
+const dtUtil::RefString TriggerVolumeActorProxy::PROPERTY_HALF_EXTENTS("HalfExtents");
 
 ////////////////////////////////////////////////////////////////////////////////
 TriggerVolumeActorProxy::TriggerVolumeActorProxy()
@@ -67,6 +69,34 @@ void TriggerVolumeActorProxy::BuildPropertyMap()
       dtCore::IntActorProperty::GetFuncType(actor, &TriggerVolumeActor::GetMaxTriggerCount),
       "Sets the maximum number of times the trigger can active.  0 means an infinite number.",
       GROUP_TRIGGER));
+
+   AddProperty(new dtCore::Vec3ActorProperty(
+      TriggerVolumeActorProxy::PROPERTY_HALF_EXTENTS,
+      TriggerVolumeActorProxy::PROPERTY_HALF_EXTENTS,
+      dtCore::Vec3ActorProperty::SetFuncType(actor, &TriggerVolumeActor::SetHalfExtents),
+      dtCore::Vec3ActorProperty::GetFuncType(actor, &TriggerVolumeActor::GetHalfExtents),
+      "Half the size of the axis aligned box around the actor that makes up the volume.",
+      GROUP_TRIGGER));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TriggerVolumeActorProxy::OnEnteredWorld()
+{
+   dtGame::GameActorProxy::OnEnteredWorld();
+
+   TriggerVolumeActor* actor = NULL;
+   GetDrawable(actor);
+   actor->RegisterWithSpatialIndex();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TriggerVolumeActorProxy::OnRemovedFromWorld()
+{
+   TriggerVolumeActor* actor = NULL;
+   GetDrawable(actor);
+   actor->UnregisterFromSpatialIndex();
+
+   dtGame::GameActorProxy::OnRemovedFromWorld();
 }
 
 //////////////////////////////////////////////////////////////////////////
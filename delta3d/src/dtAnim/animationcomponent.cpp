@@ -29,6 +29,7 @@
 #include <dtGame/gameactor.h>
 #include <dtUtil/functor.h>
 #include <dtUtil/log.h>
+#include <algorithm>
 
 namespace dtAnim
 {
@@ -37,6 +38,9 @@ namespace dtAnim
 AnimationComponent::AnimationComponent(dtCore::SystemComponentType& type)
 : BaseClass(type)
 , mGroundClamper(new dtGame::DefaultGroundClamper)
+, mSharedPosesEnabled(false)
+, mSharedPoseCache(new SharedPoseCache)
+, mLODEyePointValid(false)
 {
    mGroundClamper->SetHighResGroundClampingRange(0.01);
    mGroundClamper->SetLowResGroundClampingRange(0.1);
@@ -69,6 +73,24 @@ void AnimationComponent::ProcessMessage(const dtGame::Message& message)
 /////////////////////////////////////////////////////////////////////////////////
 void AnimationComponent::TickLocal(float dt)
 {
+   if (mSharedPosesEnabled)
+   {
+      mSharedPoseCache->AdvanceFrame();
+   }
+
+   if (!mSkeletonUpdateLODs.empty())
+   {
+      dtCore::Transformable* eyePoint = GetEyePointActor();
+      mLODEyePointValid = eyePoint != NULL;
+      if (mLODEyePointValid)
+      {
+         dtCore::Transform xform;
+         eyePoint->GetTransform(xform);
+         xform.GetTranslation(mLODEyePoint);
+      }
+      ForEachActorComponent(dtUtil::MakeFunctor(&AnimationComponent::UpdateSkeletonLOD, this));
+   }
+
    BaseClass::TickLocal(dt);
 
    if (mGroundClamper->GetTerrainActor() != NULL)
@@ -89,6 +111,11 @@ bool AnimationComponent::RegisterActor(dtGame::GameActorProxy& actor, dtAnim::An
       // when any animatable reaches a particular state.
       AnimEventCallback callback(this, &AnimationComponent::OnAnimationEvent);
       helper.SetSendEventCallback(callback);
+
+      if (mSharedPosesEnabled)
+      {
+         helper.SetSharedPoseCache(mSharedPoseCache.get());
+      }
    }
    return result;
 }
@@ -100,6 +127,8 @@ bool AnimationComponent::UnregisterActor(const dtCore::UniqueId& actorId)
    if (actorComp != NULL)
    {
       actorComp->SetSendEventCallback(AnimEventCallback());
+      actorComp->SetSharedPoseCache(NULL);
+      actorComp->SetSkeletonUpdateInterval(0.0f);
    }
    return BaseClass::UnregisterActor(actorId);
 }
@@ -160,6 +189,88 @@ const dtGame::BaseGroundClamper& AnimationComponent::GetGroundClamper() const
 }
 
 
+//////////////////////////////////////////////////////////////////////
+void AnimationComponent::SetSharedPosesEnabled(bool enabled)
+{
+   if (mSharedPosesEnabled != enabled)
+   {
+      mSharedPosesEnabled = enabled;
+      ForEachActorComponent(dtUtil::MakeFunctor(&AnimationComponent::ApplySharedPoseCache, this));
+      if (!enabled)
+      {
+         mSharedPoseCache->Clear();
+      }
+   }
+}
+
+//////////////////////////////////////////////////////////////////////
+bool AnimationComponent::GetSharedPosesEnabled() const
+{
+   return mSharedPosesEnabled;
+}
+
+//////////////////////////////////////////////////////////////////////
+SharedPoseCache& AnimationComponent::GetSharedPoseCache()
+{
+   return *mSharedPoseCache;
+}
+
+//////////////////////////////////////////////////////////////////////
+void AnimationComponent::SetSkeletonUpdateLODs(const SkeletonUpdateLODVector& lods)
+{
+   mSkeletonUpdateLODs = lods;
+   std::sort(mSkeletonUpdateLODs.begin(), mSkeletonUpdateLODs.end());
+   if (mSkeletonUpdateLODs.empty())
+   {
+      // Nothing will update the intervals anymore, so put everyone back to full rate.
+      mLODEyePointValid = false;
+      ForEachActorComponent(dtUtil::MakeFunctor(&AnimationComponent::UpdateSkeletonLOD, this));
+   }
+}
+
+//////////////////////////////////////////////////////////////////////
+const AnimationComponent::SkeletonUpdateLODVector& AnimationComponent::GetSkeletonUpdateLODs() const
+{
+   return mSkeletonUpdateLODs;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+void AnimationComponent::ApplySharedPoseCache(BaseClass::ActorCompMapping& item)
+{
+   item.second.mActorComp->SetSharedPoseCache(mSharedPosesEnabled ? mSharedPoseCache.get() : NULL);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+void AnimationComponent::UpdateSkeletonLOD(BaseClass::ActorCompMapping& item)
+{
+   dtAnim::AnimationHelper* curHelper = item.second.mActorComp.get();
+
+   float interval = 0.0f;
+   if (mLODEyePointValid)
+   {
+      dtGame::GameActorProxy* actor = NULL;
+      curHelper->GetOwner(actor);
+      dtCore::Transformable* drawable = actor != NULL ? actor->GetDrawable<dtCore::Transformable>() : NULL;
+      if (drawable != NULL)
+      {
+         dtCore::Transform xform;
+         drawable->GetTransform(xform);
+         osg::Vec3 pos;
+         xform.GetTranslation(pos);
+         const float distance = (pos - mLODEyePoint).length();
+
+         // The tiers are sorted by distance, so the last one passed is the one to use.
+         SkeletonUpdateLODVector::const_iterator i, iend;
+         for (i = mSkeletonUpdateLODs.begin(), iend = mSkeletonUpdateLODs.end(); i != iend && distance >= i->mDistance; ++i)
+         {
+            interval = i->mUpdateInterval;
+         }
+      }
+   }
+
+   curHelper->SetSkeletonUpdateInterval(interval);
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 void AnimationComponent::ExecuteCommands(BaseClass::ActorCompMapping& item)
 {
@@ -28,6 +28,7 @@
 #include <dtAnim/animationupdaterinterface.h>
 #include <dtAnim/animnodebuilder.h>
 #include <dtAnim/basemodeldata.h>
+#include <dtAnim/cal3danimator.h>
 #include <dtAnim/modeldatabase.h>
 #include <dtAnim/posesequence.h>
 
@@ -68,6 +69,7 @@ AnimationHelper::AnimationHelper()
    , mLastUpdateTime(0.0)
    , mSequenceMixer(new SequenceMixer())
    , mAttachmentController(NULL)
+   , mSkeletonUpdateInterval(0.0f)
 {
    ModelLoadedSignal.connect_slot(this, &AnimationHelper::OnLoadCompleted);
    ModelUnloadedSignal.connect_slot(this, &AnimationHelper::OnUnloadCompleted);
@@ -126,6 +128,7 @@ void AnimationHelper::CheckLoadingState()
       mModelWrapper->CreateDrawableNode(false);
 
       mAttachmentController = mModelLoader->GetAttachmentController();
+      ApplySkeletonUpdateSettings();
 
       dtAnim::BaseModelData* modelData = mModelWrapper->GetModelData();
 
@@ -983,6 +986,55 @@ bool AnimationHelper::GetPosesEnabled() const
    return mPoseSequence.valid() && mSequenceMixer->IsAnimationPlaying(mPoseSequence->GetName());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void AnimationHelper::SetSharedPoseCache(SharedPoseCache* cache)
+{
+   if (mSharedPoseCache != cache)
+   {
+      mSharedPoseCache = cache;
+      ApplySkeletonUpdateSettings();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SharedPoseCache* AnimationHelper::GetSharedPoseCache() const
+{
+   return mSharedPoseCache.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AnimationHelper::SetSkeletonUpdateInterval(float seconds)
+{
+   if (mSkeletonUpdateInterval != seconds)
+   {
+      mSkeletonUpdateInterval = seconds;
+      ApplySkeletonUpdateSettings();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+float AnimationHelper::GetSkeletonUpdateInterval() const
+{
+   return mSkeletonUpdateInterval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AnimationHelper::ApplySkeletonUpdateSettings()
+{
+   // The wrapper isn't safe to touch while it's loading.  This is called again once the load completes.
+   if (IsLoadingAsynchronously() || !mModelWrapper.valid())
+   {
+      return;
+   }
+
+   Cal3DAnimator* animator = dynamic_cast<Cal3DAnimator*>(mModelWrapper->GetAnimator());
+   if (animator != NULL)
+   {
+      animator->SetSharedPoseCache(mSharedPoseCache.get());
+      animator->SetSkeletonUpdateInterval(mSkeletonUpdateInterval);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool AnimationHelper::SetupPoses(const dtAnim::BaseModelData& modelData)
 {
@@ -32,11 +32,19 @@
 #include <dtAnim/springdriver.h>
 #include <dtUtil/log.h>
 // CAL3D
+#include <cal3d/animation_action.h>
+#include <cal3d/animation_cycle.h>
+#include <cal3d/bone.h>
+#include <cal3d/coreanimation.h>
 #include <cal3d/mixer.h>
 #include <cal3d/model.h>
 #include <cal3d/morphtargetmixer.h>
 #include <cal3d/physique.h>
+#include <cal3d/skeleton.h>
 #include <cal3d/springsystem.h>
+// STL
+#include <algorithm>
+#include <cmath>
 
 
 
@@ -82,6 +90,9 @@ namespace dtAnim
       , mMorphDriver(NULL)
       , mSpringDriver(NULL)
       , mPhysiqueDriver(NULL)
+      , mSkeletonUpdateInterval(0.0f)
+      , mTimeSinceSkeletonUpdate(0.0f)
+      , mPoseBlendAlpha(1.0f)
    {
       mAnimDriver = new AnimDriver(this);
       mSkelDriver = new SkeletonDriver(this);
@@ -127,6 +138,9 @@ namespace dtAnim
          mCalModel = mWrapper->GetCalModel();
          mMixer = mCalModel->getMixer();
       }
+
+      mPoseFrom = NULL;
+      mPoseTo = NULL;
    }
 
    Cal3DModelWrapper* Cal3DAnimator::GetWrapper()
@@ -198,10 +212,225 @@ namespace dtAnim
    /////////////////////////////////////////////////////////////////////////////
    void Cal3DAnimator::UpdateSkeleton(float deltaTime)
    {
-      if(IsUpdatable())
+      if (!IsUpdatable())
+      {
+         return;
+      }
+
+      if (mSkeletonUpdateInterval <= 0.0f)
+      {
+         if (!mSharedPoseCache.valid())
+         {
+            mMixer->updateSkeleton();
+         }
+         else
+         {
+            bool bonesUpdated = false;
+            dtCore::RefPtr<const SharedPoseCache::Pose> pose = EvaluatePose(bonesUpdated);
+            if (!bonesUpdated)
+            {
+               ApplyPose(*pose);
+            }
+         }
+         return;
+      }
+
+      mTimeSinceSkeletonUpdate += deltaTime;
+      if (!mPoseTo.valid() || mTimeSinceSkeletonUpdate >= mSkeletonUpdateInterval)
       {
-         mMixer->updateSkeleton();
+         // The next blend starts from whatever the skeleton is showing now.
+         if (!mPoseTo.valid())
+         {
+            mPoseFrom = NULL;
+         }
+         else if (mPoseBlendAlpha >= 1.0f)
+         {
+            mPoseFrom = mPoseTo;
+         }
+         else
+         {
+            mPoseFrom = CapturePose();
+         }
+
+         bool bonesUpdated = false;
+         mPoseTo = EvaluatePose(bonesUpdated);
+         // keep the remainder so the update phase, which is staggered between characters, doesn't drift.
+         mTimeSinceSkeletonUpdate = std::fmod(mTimeSinceSkeletonUpdate, mSkeletonUpdateInterval);
+
+         if (!mPoseFrom.valid())
+         {
+            if (!bonesUpdated)
+            {
+               ApplyPose(*mPoseTo);
+            }
+            mPoseBlendAlpha = 1.0f;
+            return;
+         }
+         mPoseBlendAlpha = -1.0f;
+      }
+
+      // Once the blend reaches the target, the bones are left alone until the next evaluation.
+      if (mPoseBlendAlpha < 1.0f)
+      {
+         float alpha = std::min(mTimeSinceSkeletonUpdate / mSkeletonUpdateInterval, 1.0f);
+         ApplyPose(*mPoseFrom, *mPoseTo, alpha);
+         mPoseBlendAlpha = alpha;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Cal3DAnimator::SetSharedPoseCache(SharedPoseCache* cache)
+   {
+      mSharedPoseCache = cache;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   SharedPoseCache* Cal3DAnimator::GetSharedPoseCache() const
+   {
+      return mSharedPoseCache.get();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Cal3DAnimator::SetSkeletonUpdateInterval(float seconds)
+   {
+      if (seconds > 0.0f && mSkeletonUpdateInterval <= 0.0f)
+      {
+         // Offset each animator's update phase so that a crowd switched to the same rate
+         // on the same frame doesn't evaluate all at once.
+         mTimeSinceSkeletonUpdate = seconds * float((size_t(this) >> 4) % 61) / 61.0f;
+         mPoseFrom = NULL;
+         mPoseTo = NULL;
+      }
+      mSkeletonUpdateInterval = seconds;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   float Cal3DAnimator::GetSkeletonUpdateInterval() const
+   {
+      return mSkeletonUpdateInterval;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   template <typename AnimationList>
+   static void AddAnimationsToPoseKey(const AnimationList& animList, const SharedPoseCache& cache,
+            float mixerTime, float mixerDuration, SharedPoseCache::Key& key)
+   {
+      typename AnimationList::const_iterator i, iend;
+      for (i = animList.begin(), iend = animList.end(); i != iend; ++i)
+      {
+         CalAnimation* anim = *i;
+         CalCoreAnimation* coreAnim = anim->getCoreAnimation();
+
+         // This matches how CalMixer::updateSkeleton decides the time of each animation.
+         float time = anim->getTime();
+         if (anim->getState() == CalAnimation::STATE_SYNC)
+         {
+            time = mixerDuration > 0.0f ? mixerTime * coreAnim->getDuration() / mixerDuration : 0.0f;
+         }
+
+         key.Add(size_t(coreAnim));
+         key.Add(size_t(anim->getType()));
+         key.Add(cache.QuantizeWeight(anim->getWeight()));
+         key.Add(cache.QuantizeTime(time));
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Cal3DAnimator::BuildPoseKey(SharedPoseCache::Key& key) const
+   {
+      key.Reset(mCalModel->getCoreModel());
+      const float mixerTime = mMixer->getAnimationTime();
+      const float mixerDuration = mMixer->getAnimationDuration();
+      AddAnimationsToPoseKey(mMixer->getAnimationActionList(), *mSharedPoseCache, mixerTime, mixerDuration, key);
+      AddAnimationsToPoseKey(mMixer->getAnimationCycle(), *mSharedPoseCache, mixerTime, mixerDuration, key);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<const SharedPoseCache::Pose> Cal3DAnimator::EvaluatePose(bool& bonesUpdated)
+   {
+      // Blended poses are driven per character (aiming and so on), so those characters are not shared.
+      bool shared = mSharedPoseCache.valid() && mMixer->getAnimationPose().empty();
+      if (shared)
+      {
+         BuildPoseKey(mPoseKey);
+         dtCore::RefPtr<const SharedPoseCache::Pose> pose = mSharedPoseCache->Find(mPoseKey);
+         if (pose.valid())
+         {
+            bonesUpdated = false;
+            return pose;
+         }
+      }
+
+      mMixer->updateSkeleton();
+      bonesUpdated = true;
+
+      dtCore::RefPtr<SharedPoseCache::Pose> pose = CapturePose();
+      if (shared)
+      {
+         mSharedPoseCache->Insert(mPoseKey, *pose);
+      }
+      return pose;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<SharedPoseCache::Pose> Cal3DAnimator::CapturePose() const
+   {
+      const std::vector<CalBone*>& bones = mCalModel->getSkeleton()->getVectorBone();
+
+      dtCore::RefPtr<SharedPoseCache::Pose> pose = new SharedPoseCache::Pose;
+      pose->mBones.resize(bones.size());
+      for (size_t i = 0; i < bones.size(); ++i)
+      {
+         const CalQuaternion& rotation = bones[i]->getRotation();
+         const CalVector& translation = bones[i]->getTranslation();
+         SharedPoseCache::BoneState& state = pose->mBones[i];
+         state.mRotation[0] = rotation.x;
+         state.mRotation[1] = rotation.y;
+         state.mRotation[2] = rotation.z;
+         state.mRotation[3] = rotation.w;
+         state.mTranslation[0] = translation.x;
+         state.mTranslation[1] = translation.y;
+         state.mTranslation[2] = translation.z;
+      }
+      return pose;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Cal3DAnimator::ApplyPose(const SharedPoseCache::Pose& pose)
+   {
+      CalSkeleton* skeleton = mCalModel->getSkeleton();
+      std::vector<CalBone*>& bones = skeleton->getVectorBone();
+      const size_t count = std::min(bones.size(), pose.mBones.size());
+      for (size_t i = 0; i < count; ++i)
+      {
+         const SharedPoseCache::BoneState& state = pose.mBones[i];
+         // Setting the relative transform also marks the bone as animated, so calculateState keeps it.
+         bones[i]->setRotation(CalQuaternion(state.mRotation[0], state.mRotation[1], state.mRotation[2], state.mRotation[3]));
+         bones[i]->setTranslation(CalVector(state.mTranslation[0], state.mTranslation[1], state.mTranslation[2]));
+      }
+      skeleton->calculateState();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Cal3DAnimator::ApplyPose(const SharedPoseCache::Pose& from, const SharedPoseCache::Pose& to, float alpha)
+   {
+      CalSkeleton* skeleton = mCalModel->getSkeleton();
+      std::vector<CalBone*>& bones = skeleton->getVectorBone();
+      const size_t count = std::min(bones.size(), std::min(from.mBones.size(), to.mBones.size()));
+      for (size_t i = 0; i < count; ++i)
+      {
+         const SharedPoseCache::BoneState& a = from.mBones[i];
+         const SharedPoseCache::BoneState& b = to.mBones[i];
+
+         CalQuaternion rotation(a.mRotation[0], a.mRotation[1], a.mRotation[2], a.mRotation[3]);
+         rotation.blend(alpha, CalQuaternion(b.mRotation[0], b.mRotation[1], b.mRotation[2], b.mRotation[3]));
+         CalVector translation(a.mTranslation[0], a.mTranslation[1], a.mTranslation[2]);
+         translation.blend(alpha, CalVector(b.mTranslation[0], b.mTranslation[1], b.mTranslation[2]));
+
+         bones[i]->setRotation(rotation);
+         bones[i]->setTranslation(translation);
       }
+      skeleton->calculateState();
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -189,7 +189,8 @@ namespace dtAnim
                }
             }
             dtCore::RefPtr<dtCore::Object> obj = new dtCore::Object(hsd.mName);
-            obj->LoadFile(pathToLoad, true);
+            // This may be on the model loading thread, so let the async loader attach the mesh on the main thread.
+            obj->LoadFileAsync(pathToLoad, true);
             newAttachment->AddChild(obj);
          }
 
@@ -0,0 +1,189 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <dtAnim/sharedposecache.h>
+#include <OpenThreads/ScopedLock>
+#include <cmath>
+
+namespace dtAnim
+{
+   /////////////////////////////////////////////////////////////////////////////
+   SharedPoseCache::Key::Key()
+   : mModel(NULL)
+   , mHash(0)
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void SharedPoseCache::Key::Reset(const void* model)
+   {
+      mModel = model;
+      mValues.clear();
+      mHash = size_t(model);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void SharedPoseCache::Key::Add(size_t value)
+   {
+      mValues.push_back(value);
+      // boost::hash_combine
+      mHash ^= value + size_t(0x9e3779b9) + (mHash << 6) + (mHash >> 2);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool SharedPoseCache::Key::operator==(const Key& rhs) const
+   {
+      return mHash == rhs.mHash && mModel == rhs.mModel && mValues == rhs.mValues;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool SharedPoseCache::Key::operator<(const Key& rhs) const
+   {
+      if (mHash != rhs.mHash)
+      {
+         return mHash < rhs.mHash;
+      }
+      if (mModel != rhs.mModel)
+      {
+         return mModel < rhs.mModel;
+      }
+      return mValues < rhs.mValues;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   SharedPoseCache::SharedPoseCache()
+   : mTimeQuantum(1.0f / 30.0f)
+   , mWeightQuantum(1.0f / 32.0f)
+   , mMaxIdleFrames(4U)
+   , mMaxPoses(4096U)
+   , mFrame(0U)
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   SharedPoseCache::~SharedPoseCache()
+   {
+   }
+
+   DT_IMPLEMENT_ACCESSOR(SharedPoseCache, float, TimeQuantum)
+   DT_IMPLEMENT_ACCESSOR(SharedPoseCache, float, WeightQuantum)
+   DT_IMPLEMENT_ACCESSOR(SharedPoseCache, unsigned, MaxIdleFrames)
+   DT_IMPLEMENT_ACCESSOR(SharedPoseCache, unsigned, MaxPoses)
+
+   /////////////////////////////////////////////////////////////////////////////
+   size_t SharedPoseCache::QuantizeTime(float time) const
+   {
+      if (mTimeQuantum <= 0.0f || time <= 0.0f)
+      {
+         return 0;
+      }
+      return size_t(std::floor(time / mTimeQuantum));
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   size_t SharedPoseCache::QuantizeWeight(float weight) const
+   {
+      if (mWeightQuantum <= 0.0f || weight <= 0.0f)
+      {
+         return 0;
+      }
+      return size_t(std::floor(weight / mWeightQuantum + 0.5f));
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<const SharedPoseCache::Pose> SharedPoseCache::Find(const Key& key)
+   {
+      dtCore::RefPtr<const Pose> result;
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         PoseMap::iterator i = mPoses.find(key);
+         if (i != mPoses.end())
+         {
+            i->second.mLastUsedFrame = mFrame;
+            result = i->second.mPose;
+         }
+      }
+
+      if (result.valid())
+      {
+         ++mNumHits;
+      }
+      else
+      {
+         ++mNumMisses;
+      }
+      return result;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void SharedPoseCache::Insert(const Key& key, const Pose& pose)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      if (mPoses.size() < mMaxPoses)
+      {
+         Entry& entry = mPoses[key];
+         if (!entry.mPose.valid())
+         {
+            entry.mPose = &pose;
+         }
+         entry.mLastUsedFrame = mFrame;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void SharedPoseCache::AdvanceFrame()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      ++mFrame;
+      PoseMap::iterator i = mPoses.begin();
+      while (i != mPoses.end())
+      {
+         if (mFrame - i->second.mLastUsedFrame > mMaxIdleFrames)
+         {
+            mPoses.erase(i++);
+         }
+         else
+         {
+            ++i;
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void SharedPoseCache::Clear()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      mPoses.clear();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned SharedPoseCache::GetNumPoses() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return unsigned(mPoses.size());
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void SharedPoseCache::ResetCounters()
+   {
+      mNumHits.exchange(0);
+      mNumMisses.exchange(0);
+   }
+
+} // namespace dtAnim
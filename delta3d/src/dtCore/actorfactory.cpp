@@ -27,6 +27,7 @@
 #include <dtUtil/log.h>
 
 #include <osgDB/FileUtils>
+#include <OpenThreads/ScopedLock>
 
 #include <sstream>
 
@@ -75,6 +76,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    bool ActorFactory::IsInRegistry(const std::string& libName) const
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       RegistryMap::const_iterator regItor = mRegistries.find(libName);
       if (regItor != mRegistries.end())
       {
@@ -89,6 +91,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    void ActorFactory::LoadActorRegistry(const std::string& libName)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       //Used to format log messages.
       std::ostringstream msg;
 
@@ -177,6 +180,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    bool ActorFactory::AddRegistryEntry(const std::string& libName, const RegistryEntry& entry)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       //Finally we can actually add the new registry to the library manager.
       //The map key is the system independent library name.
       bool inserted = mRegistries.insert(std::make_pair(libName,entry)).second;
@@ -213,6 +217,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    void ActorFactory::GetActorTypes(ActorTypeList& actorTypes) const
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       RegistryMapConstItor i, iend;
       i = mRegistries.begin();
       iend = mRegistries.end();
@@ -235,6 +240,7 @@ namespace dtCore
    ////////////////////////////////////////////////////////////////////////////////
    std::vector<std::string> ActorFactory::GetClassTypes() const
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       ActorTypeList types;
       GetActorTypes(types);
 
@@ -255,6 +261,7 @@ namespace dtCore
    const ActorType* ActorFactory::FindActorType(const std::string& category,
          const std::string& name) const
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       const ActorType* result = NULL;
       dtCore::RefPtr<const ActorType> typeToFind = new ActorType(name, category);
       ActorTypeMapItor itor = mActorTypeCache.find(typeToFind);
@@ -288,6 +295,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    std::string ActorFactory::FindActorTypeReplacementName(const std::string& fullName) const
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       std::string resultName;
       ActorPluginRegistry::ActorTypeReplacements::const_iterator itr = mReplacementActors.begin();
       while (itr != mReplacementActors.end())
@@ -305,6 +313,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    const ActorType* ActorFactory::FindActorTypeReplacement(const std::string& category, const std::string& name) const
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       std::string fullName = category + "." + name;
       std::string resultName = FindActorTypeReplacementName(fullName);
       const ActorType* result = NULL;
@@ -320,6 +329,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    dtCore::RefPtr<BaseActorObject> ActorFactory::CreateActor(const ActorType& actorType)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       ActorPluginRegistry* apr = GetRegistryForType(actorType);
 
       if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
@@ -342,6 +352,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    dtCore::RefPtr<BaseActorObject> ActorFactory::CreateActor(const std::string& category, const std::string& name)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       dtCore::RefPtr<const ActorType> type = FindActorType(category, name);
       if (!type.valid())
       {
@@ -356,6 +367,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    ActorPluginRegistry* ActorFactory::GetRegistry(const std::string& name)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
       {
          for (RegistryMapItor i = mRegistries.begin(); i != mRegistries.end(); ++i)
@@ -381,6 +393,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    ActorPluginRegistry* ActorFactory::GetRegistryForType(const ActorType& actorType)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       std::ostringstream error;
 
       //To create an new actor proxy, first we search our map of actor types
@@ -425,6 +438,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    std::string ActorFactory::GetLibraryNameForRegistry(const ActorPluginRegistry& registry) const
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       std::string result;
       for (RegistryMapConstItor i = mRegistries.begin(); i != mRegistries.end(); ++i)
       {
@@ -440,6 +454,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    void ActorFactory::UnloadActorRegistry(const std::string& libName)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       if (libName == DEFAULT_ACTOR_LIBRARY)
       {
          mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
@@ -536,6 +551,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    void ActorFactory::LoadOptionalActorRegistry(const std::string& libName)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mMutex);
       const std::string actualLibName = GetPlatformSpecificLibraryName(libName);
       std::string fullLibraryName = osgDB::findLibraryFile(actualLibName);
 
@@ -40,6 +40,7 @@ namespace dtCore
       , mLabel(label)
       , mDescription(desc)
       , mNumberPrecision(16)
+      , mDirty(false)
       , mReadOnly(readOnly)
       , mMultipleEdit(true)
       , mSendInPartialUpdate(false)
@@ -0,0 +1,420 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <prefix/dtcoreprefix.h>
+#include <dtCore/asyncmeshloader.h>
+#include <dtCore/shadermanager.h>
+#include <dtCore/shaderprogram.h>
+#include <dtCore/system.h>
+#include <dtUtil/exception.h>
+#include <dtUtil/log.h>
+#include <dtUtil/readnodethreadpooltask.h>
+#include <dtUtil/threadpool.h>
+
+#include <OpenThreads/Atomic>
+#include <OpenThreads/ScopedLock>
+#include <osg/Geode>
+#include <osg/NodeVisitor>
+#include <osg/Texture>
+#include <osg/Timer>
+#include <osgDB/Registry>
+#include <osgUtil/Optimizer>
+
+namespace dtCore
+{
+   /////////////////////////////////////////////////////////////////////////////
+   /// Sets uncompressed textures to be compressed by the driver when they are uploaded.
+   class TextureCompressionVisitor : public osg::NodeVisitor
+   {
+   public:
+      TextureCompressionVisitor()
+         : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN)
+      {
+      }
+
+      void apply(osg::Node& node) override
+      {
+         ApplyStateSet(node.getStateSet());
+         traverse(node);
+      }
+
+      void apply(osg::Geode& geode) override
+      {
+         ApplyStateSet(geode.getStateSet());
+         for (unsigned i = 0; i < geode.getNumDrawables(); ++i)
+         {
+            ApplyStateSet(geode.getDrawable(i)->getStateSet());
+         }
+         traverse(geode);
+      }
+
+   private:
+      void ApplyStateSet(osg::StateSet* stateSet)
+      {
+         if (stateSet == NULL)
+         {
+            return;
+         }
+
+         unsigned numUnits = stateSet->getTextureAttributeList().size();
+         for (unsigned unit = 0; unit < numUnits; ++unit)
+         {
+            osg::Texture* texture = dynamic_cast<osg::Texture*>(stateSet->getTextureAttribute(unit, osg::StateAttribute::TEXTURE));
+            if (texture == NULL || texture->getInternalFormatMode() != osg::Texture::USE_IMAGE_DATA_FORMAT)
+            {
+               continue;
+            }
+
+            bool compressed = false;
+            for (unsigned i = 0; i < texture->getNumImages(); ++i)
+            {
+               const osg::Image* image = texture->getImage(i);
+               compressed = compressed || (image != NULL && image->isCompressed());
+            }
+
+            if (!compressed)
+            {
+               texture->setInternalFormatMode(osg::Texture::USE_ARB_COMPRESSION);
+            }
+         }
+      }
+   };
+
+   /////////////////////////////////////////////////////////////////////////////
+   /// Reads the mesh, then post processes it on the same worker thread.
+   class MeshLoadTask : public dtUtil::ReadNodeThreadPoolTask
+   {
+   public:
+      MeshLoadTask(unsigned optimizerOptions, bool compressTextures)
+         : mOptimizerOptions(optimizerOptions)
+         , mCompressTextures(compressTextures)
+         , mDone(0U)
+      {
+      }
+
+      void operator()() override
+      {
+         dtUtil::ReadNodeThreadPoolTask::operator()();
+
+         osg::Node* node = GetLoadedNode();
+         // A node from the object cache is shared with everything else that loads the file, even before it has
+         // parents, so only private copies are changed here.  A cached load gives the same node a sync load does.
+         if (node != NULL && !GetUseFileCaching())
+         {
+            if (mOptimizerOptions != 0U)
+            {
+               osgUtil::Optimizer optimizer;
+               optimizer.optimize(node, mOptimizerOptions);
+            }
+
+            if (mCompressTextures)
+            {
+               TextureCompressionVisitor tcv;
+               node->accept(tcv);
+            }
+
+            // compute the bounds here so the first cull doesn't have to
+            node->getBound();
+         }
+
+         mDone.exchange(1U);
+      }
+
+      /// Unlike IsComplete, this includes the post processing.
+      bool IsDone() const
+      {
+         return unsigned(mDone) != 0U;
+      }
+
+   protected:
+      ~MeshLoadTask() override
+      {
+      }
+
+   private:
+      unsigned mOptimizerOptions;
+      bool mCompressTextures;
+      OpenThreads::Atomic mDone;
+   };
+
+   /////////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<AsyncMeshLoader> AsyncMeshLoader::mInstance(NULL);
+   OpenThreads::Mutex AsyncMeshLoader::mInstanceMutex;
+
+   /////////////////////////////////////////////////////////////////////////////
+   AsyncMeshLoader::AsyncMeshLoader()
+      : dtCore::Base("AsyncMeshLoader")
+      , mFrameBudgetMs(2.0)
+      , mOptimizerOptions(osgUtil::Optimizer::SHARE_DUPLICATE_STATE | osgUtil::Optimizer::MERGE_GEOMETRY | osgUtil::Optimizer::CHECK_GEOMETRY)
+      , mCompressTextures(false)
+      , mNumPending(0U)
+      , mNumSharedLoads(0U)
+   {
+      dtCore::System::GetInstance().TickSignal.connect_slot(this, &AsyncMeshLoader::OnSystem);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   AsyncMeshLoader::~AsyncMeshLoader()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   AsyncMeshLoader& AsyncMeshLoader::GetInstance()
+   {
+      // Requests can come from loader threads, like the ModelLoader's.
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mInstanceMutex);
+      if (mInstance == NULL)
+      {
+         mInstance = new AsyncMeshLoader();
+      }
+
+      return *mInstance;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void AsyncMeshLoader::Destroy()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mInstanceMutex);
+      mInstance = NULL;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool AsyncMeshLoader::IsAvailable()
+   {
+      return dtUtil::ThreadPool::IsInitialized();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   DT_IMPLEMENT_ACCESSOR(AsyncMeshLoader, double, FrameBudgetMs);
+   DT_IMPLEMENT_ACCESSOR(AsyncMeshLoader, unsigned, OptimizerOptions);
+   DT_IMPLEMENT_ACCESSOR(AsyncMeshLoader, bool, CompressTextures);
+
+   /////////////////////////////////////////////////////////////////////////////
+   void AsyncMeshLoader::RequestLoad(const std::string& filename, bool useCache, const LoadCallback& callback,
+            osg::Referenced* owner, const std::string& shaderName, const std::string& shaderGroup)
+   {
+      Request request;
+      request.mCallback = callback;
+      request.mHasOwner = owner != NULL;
+      request.mOwner = owner;
+      request.mShaderName = shaderName;
+      request.mShaderGroup = shaderGroup;
+
+      dtCore::RefPtr<MeshLoadTask> newTask;
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         ++mNumPending;
+
+         if (useCache)
+         {
+            SharedLoadMap::iterator found = mSharedLoads.find(filename);
+            if (found != mSharedLoads.end())
+            {
+               found->second->mRequests.push_back(request);
+               ++mNumSharedLoads;
+               return;
+            }
+         }
+
+         newTask = new MeshLoadTask(mOptimizerOptions, mCompressTextures);
+         newTask->SetName(filename);
+         newTask->SetFileToLoad(filename);
+         newTask->SetUseFileCaching(useCache);
+
+         // The same options Loadable::LoadFile uses, so an async load gives the same result as a sync one.
+         osgDB::Registry* reg = osgDB::Registry::instance();
+         newTask->SetLoadOptions(reg->getOptions() != NULL ?
+                  static_cast<osgDB::Options*>(reg->getOptions()->clone(osg::CopyOp::SHALLOW_COPY)) :
+                  new osgDB::Options);
+
+         Load load;
+         load.mTask = newTask;
+         load.mRequests.push_back(request);
+         load.mUseCache = useCache;
+         LoadList::iterator loadIter = mLoads.insert(mLoads.end(), load);
+
+         if (useCache)
+         {
+            mSharedLoads.insert(std::make_pair(filename, loadIter));
+         }
+      }
+
+      if (IsAvailable())
+      {
+         dtUtil::ThreadPool::AddTask(*newTask, dtUtil::ThreadPool::IO);
+      }
+      else
+      {
+         (*newTask)();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool AsyncMeshLoader::PopReadyRequest(Request& request, dtCore::RefPtr<osg::Node>& node, std::string& filename)
+   {
+      for (LoadList::iterator i = mLoads.begin(); i != mLoads.end(); ++i)
+      {
+         Load& load = *i;
+         if (!load.mTask->IsDone())
+         {
+            continue;
+         }
+
+         request = load.mRequests.front();
+         load.mRequests.erase(load.mRequests.begin());
+         node = load.mTask->GetLoadedNode();
+         filename = load.mTask->GetFileToLoad();
+         --mNumPending;
+
+         if (load.mRequests.empty())
+         {
+            if (load.mUseCache)
+            {
+               mSharedLoads.erase(filename);
+            }
+            mLoads.erase(i);
+         }
+         return true;
+      }
+      return false;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void AsyncMeshLoader::Dispatch(Request& request, osg::Node* node, const std::string& filename)
+   {
+      if (request.mHasOwner && !request.mOwner.valid())
+      {
+         return;
+      }
+
+      try
+      {
+         if (node != NULL && !request.mShaderName.empty())
+         {
+            dtCore::ShaderManager& shaderManager = dtCore::ShaderManager::GetInstance();
+            const dtCore::ShaderProgram* prototype = shaderManager.FindShaderPrototype(request.mShaderName, request.mShaderGroup);
+            if (prototype != NULL)
+            {
+               shaderManager.AssignShaderFromPrototype(*prototype, *node);
+            }
+            else
+            {
+               LOG_WARNING("Could not find shader \"" + request.mShaderName + "\" in group \"" + request.mShaderGroup
+                        + "\" to assign to mesh: " + filename);
+            }
+         }
+
+         request.mCallback(node, filename);
+      }
+      catch (const dtUtil::Exception& ex)
+      {
+         ex.LogException(dtUtil::Log::LOG_ERROR);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned AsyncMeshLoader::CommitCompleted(double budgetMs)
+   {
+      osg::Timer* timer = osg::Timer::instance();
+      osg::Timer_t start = timer->tick();
+
+      unsigned numCommitted = 0U;
+      Request request;
+      dtCore::RefPtr<osg::Node> node;
+      std::string filename;
+
+      for (;;)
+      {
+         {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+            if (!PopReadyRequest(request, node, filename))
+            {
+               break;
+            }
+         }
+
+         // The callback is called without the lock so it can make new requests.
+         Dispatch(request, node.get(), filename);
+         ++numCommitted;
+
+         if (budgetMs >= 0.0 && timer->delta_m(start, timer->tick()) >= budgetMs)
+         {
+            break;
+         }
+      }
+
+      return numCommitted;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void AsyncMeshLoader::WaitForAll()
+   {
+      while (GetNumPending() > 0U)
+      {
+         std::vector<dtCore::RefPtr<MeshLoadTask> > tasks;
+         {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+            for (LoadList::iterator i = mLoads.begin(); i != mLoads.end(); ++i)
+            {
+               if (!i->mTask->IsDone())
+               {
+                  tasks.push_back(i->mTask);
+               }
+            }
+         }
+
+         for (unsigned i = 0; i < tasks.size(); ++i)
+         {
+            tasks[i]->WaitUntilComplete();
+         }
+
+         CommitCompleted(-1.0);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned AsyncMeshLoader::GetNumPending() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return mNumPending;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned AsyncMeshLoader::GetNumLoadsInFlight() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return unsigned(mLoads.size());
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned AsyncMeshLoader::GetNumSharedLoads() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return mNumSharedLoads;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void AsyncMeshLoader::OnSystem(const dtUtil::RefString& str, double /*deltaSim*/, double /*deltaReal*/)
+   {
+      if (str == dtCore::System::MESSAGE_PRE_FRAME)
+      {
+         CommitCompleted(mFrameBudgetMs);
+      }
+   }
+}
@@ -28,20 +28,86 @@
 #include <dtUtil/exception.h>
 #include <dtUtil/mathdefines.h>
 #include <dtUtil/cullmask.h>
+#include <dtUtil/threadpool.h>
 
 #include <osg/Group>
 #include <osg/Version>
 
 #include <stack>
+#include <vector>
 #include <algorithm>
 
 namespace dtCore
 {
+   ///////////////////////////////////////////////////////////////////////////////
+   /// Runs one intersect visitor for a range of the isectors and keeps the hit lists until they are merged.
+   class BatchIsectorTask : public dtUtil::ThreadPoolTask
+   {
+   public:
+      BatchIsectorTask(osg::Node& root, const osg::Vec3& eyePoint, bool useHighestLvlOfDetail, int traversalMask)
+      : mHits(false)
+      , mRoot(&root)
+      , mEyePoint(eyePoint)
+      , mUseHighestLvlOfDetail(useHighestLvlOfDetail)
+      , mTraversalMask(traversalMask)
+      {
+         SetName("BatchIsectorTask");
+      }
+
+      void operator()() override
+      {
+         osgUtil::IntersectVisitor intersectVisitor;
+
+         if (mUseHighestLvlOfDetail)
+         {
+            intersectVisitor.setLODSelectionMode(osgUtil::IntersectVisitor::USE_HIGHEST_LEVEL_OF_DETAIL);
+         }
+         else
+         {
+            intersectVisitor.setLODSelectionMode(osgUtil::IntersectVisitor::USE_SEGMENT_START_POINT_AS_EYE_POINT_FOR_LOD_LEVEL_SELECTION);
+         }
+
+         for (unsigned i = 0; i < mISectors.size(); ++i)
+         {
+            intersectVisitor.addLineSegment(mISectors[i]->GetLineSegment());
+         }
+
+         intersectVisitor.setEyePoint(mEyePoint);
+         intersectVisitor.setTraversalMask(mTraversalMask);
+
+         mRoot->accept(intersectVisitor);
+
+         mHits = intersectVisitor.hits();
+         mHitLists.resize(mISectors.size());
+         if (mHits)
+         {
+            for (unsigned i = 0; i < mISectors.size(); ++i)
+            {
+               mHitLists[i] = intersectVisitor.getHitList(mISectors[i]->GetLineSegment());
+            }
+         }
+      }
+
+      std::vector<BatchIsector::SingleISector*> mISectors;
+      std::vector<BatchIsector::HitList> mHitLists;
+      bool mHits;
+
+   protected:
+      ~BatchIsectorTask() override {}
+
+   private:
+      dtCore::RefPtr<osg::Node> mRoot;
+      osg::Vec3 mEyePoint;
+      bool mUseHighestLvlOfDetail;
+      int mTraversalMask;
+   };
+
    ///////////////////////////////////////////////////////////////////////////////
    BatchIsector::BatchIsector(dtCore::Scene* scene)
       : mScene(scene)
       , mFixedArraySize(32)
       //, mTraversalMask(dtUtil::CullMask::SCENE_INTERSECT_MASK)
+      , mUseThreadPool(false)
    {
       for (int i = 0 ; i < mFixedArraySize; ++i)
       {
@@ -73,48 +139,79 @@ namespace dtCore
          return false;
       }
 
-      osgUtil::IntersectVisitor intersectVisitor;
+      osg::Node* root = mQueryRoot.valid() ? mQueryRoot->GetOSGNode() : mScene->GetSceneNode();
 
-      if (useHighestLvlOfDetail)
+      std::vector<SingleISector*> active;
+      for (int i = 0 ; i < mFixedArraySize; ++i)
       {
-         intersectVisitor.setLODSelectionMode(osgUtil::IntersectVisitor::USE_HIGHEST_LEVEL_OF_DETAIL);
+         if (mISectors[i]->GetIsOn())
+         {
+            active.push_back(mISectors[i].get());
+         }
       }
-      else
+
+      // Waiting on the pool from one of its own workers could stall it, so that case runs serially.
+      unsigned numTasks = 1U;
+      if (mUseThreadPool && dtUtil::ThreadPool::IsInitialized() && !dtUtil::ThreadPool::IsWorkerThread()
+         && dtUtil::ThreadPool::GetNumImmediateWorkerThreads() > 1U)
       {
-         intersectVisitor.setLODSelectionMode(osgUtil::IntersectVisitor::USE_SEGMENT_START_POINT_AS_EYE_POINT_FOR_LOD_LEVEL_SELECTION);
+         numTasks = std::max(1U, std::min(dtUtil::ThreadPool::GetNumImmediateWorkerThreads(), unsigned(active.size())));
       }
 
-      for (int i = 0 ; i < mFixedArraySize; ++i)
+      // Each task gets a contiguous range of isectors so merging them task by task keeps the isector order.
+      std::vector<dtCore::RefPtr<BatchIsectorTask> > tasks;
+      tasks.reserve(numTasks);
+      const unsigned perTask = std::max(1U, (unsigned(active.size()) + numTasks - 1) / numTasks);
+      for (unsigned start = 0; start < active.size() || tasks.empty(); start += perTask)
       {
-         if (mISectors[i]->GetIsOn())
+         unsigned end = std::min(unsigned(active.size()), start + perTask);
+         dtCore::RefPtr<BatchIsectorTask> task = new BatchIsectorTask(*root, cameraEyePoint, useHighestLvlOfDetail, mTraversalMask);
+         task->mISectors.assign(active.begin() + start, active.begin() + end);
+         tasks.push_back(task);
+      }
+
+      if (tasks.size() == 1U)
+      {
+         (*tasks[0])();
+      }
+      else
+      {
+         // Computing the bounds is lazy, so do it here rather than letting the workers race to update them.
+         root->getBound();
+
+         // Only wait on this update's tasks, other code may have its own immediate tasks queued.
+         for (unsigned i = 1; i < tasks.size(); ++i)
          {
-            intersectVisitor.addLineSegment(mISectors[i]->mLineSegment.get());
+            dtUtil::ThreadPool::AddTask(*tasks[i]);
          }
-      }
 
-      intersectVisitor.setEyePoint(cameraEyePoint);
-      intersectVisitor.setTraversalMask(mTraversalMask);
+         (*tasks[0])();
 
-      if (mQueryRoot.valid())
-      {
-         mQueryRoot->GetOSGNode()->accept(intersectVisitor);
+         for (unsigned i = 1; i < tasks.size(); ++i)
+         {
+            tasks[i]->WaitUntilComplete();
+         }
       }
-      else if (mScene != NULL)
+
+      bool hits = false;
+      for (unsigned i = 0; i < tasks.size(); ++i)
       {
-         mScene->GetSceneNode()->accept(intersectVisitor);
+         hits = hits || tasks[i]->mHits;
       }
 
-      if (intersectVisitor.hits())
+      if (hits)
       {
-         for (int i = 0 ; i < mFixedArraySize; ++i)
+         for (unsigned i = 0; i < tasks.size(); ++i)
          {
-            if (mISectors[i]->GetIsOn())
+            BatchIsectorTask& task = *tasks[i];
+            for (unsigned j = 0; j < task.mISectors.size(); ++j)
             {
-               mISectors[i]->SetHitList(intersectVisitor.getHitList(mISectors[i]->mLineSegment.get()));
-               if (mISectors[i]->mCheckClosestDrawables == true)
+               SingleISector& isector = *task.mISectors[j];
+               isector.SetHitList(task.mHitLists[j]);
+               if (isector.mCheckClosestDrawables && !isector.GetHitList().empty())
                {
-                  osg::NodePath& nodePath = mISectors[i]->GetHitList()[0].getNodePath();
-                  mISectors[i]->mClosestDrawable = MapNodePathToDrawable(nodePath);
+                  osg::NodePath& nodePath = isector.GetHitList()[0].getNodePath();
+                  isector.mClosestDrawable = MapNodePathToDrawable(nodePath);
                }
             }
          }
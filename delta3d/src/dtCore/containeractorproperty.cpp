@@ -121,7 +121,30 @@ namespace dtCore
       const ContainerActorProperty* src = dynamic_cast<const ContainerActorProperty*>(&otherProp);
       if (src)
       {
-         FromString(src->ToString());
+         // When both containers hold the same kinds of properties, copy them one by one rather than going
+         // through the string form of the whole container.
+         bool sameLayout = !IsReadOnly() && src->mProperties.size() == mProperties.size();
+         for (size_t index = 0; sameLayout && index < mProperties.size(); ++index)
+         {
+            const ActorProperty* to = mProperties[index];
+            const ActorProperty* from = src->mProperties[index];
+            sameLayout = to != NULL && from != NULL && to->GetDataType() == from->GetDataType();
+         }
+
+         if (sameLayout)
+         {
+            for (size_t index = 0; index < mProperties.size(); ++index)
+            {
+               if (!mProperties[index]->IsReadOnly())
+               {
+                  mProperties[index]->CopyFrom(*src->mProperties[index]);
+               }
+            }
+         }
+         else
+         {
+            FromString(src->ToString());
+         }
       }
    }
 
@@ -5,6 +5,7 @@
 #include <dtCore/infiniteterrain.h>
 #include <dtUtil/mathdefines.h>
 #include <dtUtil/matrixutil.h>
+#include <dtUtil/threadpool.h>
 
 #include <osg/Drawable>
 #include <osg/Geode>
@@ -17,6 +18,12 @@
 #include <osg/LOD>
 #include <osgDB/ReadFile>
 
+#include <OpenThreads/Atomic>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+
+#include <algorithm>
+
 namespace dtCore
 {
 
@@ -47,32 +54,13 @@ class InfiniteTerrainCallback : public osg::NodeCallback
        */
       virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
       {
-         if (mTerrain->mClearFlag)
+         double time = 0.0;
+         if (nv->getFrameStamp() != NULL)
          {
-            mTerrain->GetMatrixNode()->removeChild(0, mTerrain->GetMatrixNode()->getNumChildren());
-
-            mTerrain->mBuiltSegments.clear();
-
-            mTerrain->mClearFlag = false;
+            time = nv->getFrameStamp()->getReferenceTime();
          }
 
-         osg::Vec3 eyepoint = nv->getEyePoint();
-
-         float bd = mTerrain->GetBuildDistance(),
-               bd2 = bd*2,
-               x = eyepoint[0] - bd,
-               y = eyepoint[1] - bd;
-
-         for (float i=0.0f;i<=bd2;i+=mTerrain->mSegmentSize)
-         {
-            for (float j=0.0f;j<=bd2;j+=mTerrain->mSegmentSize)
-            {
-               mTerrain->BuildSegment(
-                  int((x + i)/mTerrain->mSegmentSize),
-                  int((y + j)/mTerrain->mSegmentSize)
-               );
-            }
-         }
+         mTerrain->UpdateSegments(nv->getEyePoint(), time);
 
          traverse(node, nv);
       }
@@ -86,6 +74,236 @@ class InfiniteTerrainCallback : public osg::NodeCallback
       InfiniteTerrain* mTerrain;
 };
 
+/// The most segments that may wait on the background queue at once.
+static const unsigned MAX_PENDING_SEGMENTS = 32;
+
+/**
+ * The height to color settings, shared by the terrain and the segment builders.
+ */
+struct InfiniteTerrainColorInfo
+{
+   float mIdealHeight;
+   float mMinColorIncrement;
+   osg::Vec3 mMinColor, mMaxColor;
+
+   osg::Vec4 GetColor(float height) const
+   {
+      float r,g,b;
+
+      float minPercent = std::min<float>(std::max<float>(0.0f, (mIdealHeight - height) / mMinColorIncrement), 1.0f);
+      float maxPercent = 1 - minPercent;
+
+      r = mMaxColor[0] * maxPercent;
+      g = mMaxColor[1] * maxPercent;
+      b = mMaxColor[2] * maxPercent;
+
+      r += mMinColor[0] * minPercent;
+      g += mMinColor[1] * minPercent * minPercent;
+      b += mMinColor[2] * minPercent * minPercent;
+
+      return osg::Vec4(r, g, b, 1.0f);
+   }
+};
+
+/**
+ * A single terrain segment.  It holds a copy of the noise and settings so
+ * it can be built on a thread pool thread, and it keeps the post heights
+ * so height queries don't have to evaluate the noise again.
+ */
+class InfiniteTerrainSegment : public dtUtil::ThreadPoolTask
+{
+   public:
+
+      InfiniteTerrainSegment(int x, int y, const dtUtil::Noise2f& noise,
+                             float segmentSize, int segmentDivisions,
+                             float horizontalScale, float verticalScale,
+                             float buildDistance, const InfiniteTerrainColorInfo& colorInfo)
+         : mX(x)
+         , mY(y)
+         , mNoise(noise)
+         , mSegmentSize(segmentSize)
+         , mSegmentDivisions(segmentDivisions)
+         , mHorizontalScale(horizontalScale)
+         , mVerticalScale(verticalScale)
+         , mBuildDistance(buildDistance)
+         , mColorInfo(colorInfo)
+         , mReady(0U)
+      {
+         SetName("InfiniteTerrainSegment");
+      }
+
+      void operator()() override
+      {
+         Build();
+      }
+
+      /**
+       * Builds the segment if no other thread has.  If another thread is
+       * building it, this waits for it to finish.
+       */
+      void Build();
+
+      bool IsReady() const
+      {
+         return unsigned(mReady) != 0U;
+      }
+
+      osg::Node* GetNode()
+      {
+         return mNode.get();
+      }
+
+      int GetSegmentDivisions() const
+      {
+         return mSegmentDivisions;
+      }
+
+      /**
+       * @return the height of a post in this segment, 0 to segment divisions inclusive.
+       */
+      float GetPostHeight(int localX, int localY) const
+      {
+         // The heights include a one post border used for the normals.
+         return mHeights[(localY + 1) * (mSegmentDivisions + 3) + localX + 1];
+      }
+
+   protected:
+
+      ~InfiniteTerrainSegment() override {}
+
+   private:
+
+      int mX, mY;
+      dtUtil::Noise2f mNoise;
+      float mSegmentSize;
+      int mSegmentDivisions;
+      float mHorizontalScale;
+      float mVerticalScale;
+      float mBuildDistance;
+      InfiniteTerrainColorInfo mColorInfo;
+
+      OpenThreads::Mutex mBuildMutex;
+      OpenThreads::Atomic mReady;
+
+      std::vector<float> mHeights;
+      RefPtr<osg::LOD> mNode;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+void InfiniteTerrainSegment::Build()
+{
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mBuildMutex);
+
+   if (IsReady())
+   {
+      return;
+   }
+
+   int width = mSegmentDivisions + 1,
+       height = mSegmentDivisions + 1,
+       border = mSegmentDivisions + 3;
+
+   float step = mSegmentSize / mSegmentDivisions;
+
+   osg::Vec2 minimum(mX * mSegmentSize, mY * mSegmentSize);
+
+   // Evaluate the noise for every post plus a one post border in one batch.
+   std::vector<osg::Vec2f> samples(border * border);
+   for (int i = 0; i < border; ++i)
+   {
+      for (int j = 0; j < border; ++j)
+      {
+         float x = minimum[0] + (j - 1) * step,
+               y = minimum[1] + (i - 1) * step;
+
+         samples[i * border + j].set((x + mBuildDistance) * mHorizontalScale, (y + mBuildDistance) * mHorizontalScale);
+      }
+   }
+
+   mHeights.resize(samples.size());
+   mNoise.GetNoiseBatch(&samples[0], &mHeights[0], unsigned(samples.size()));
+   for (size_t k = 0; k < mHeights.size(); ++k)
+   {
+      mHeights[k] = mVerticalScale * 2.0f * mHeights[k] - 1.0f;
+   }
+
+   RefPtr<osg::Vec3Array> vertices =
+      new osg::Vec3Array(width*height);
+
+   RefPtr<osg::Vec3Array> normals =
+      new osg::Vec3Array(width*height);
+
+   RefPtr<osg::Vec4Array> colors =
+      new osg::Vec4Array(width*height);
+
+   RefPtr<osg::Vec2Array> textureCoordinates =
+      new osg::Vec2Array(width*height);
+
+   int i, j;
+
+   for (i=0;i<height;i++)
+   {
+      for (j=0;j<width;j++)
+      {
+         float x = minimum[0] + j * step,
+               y = minimum[1] + i * step;
+
+         float heightAtXY = GetPostHeight(j, i);
+
+         (*vertices)[i*width+j].set(x, y, heightAtXY);
+
+         // Central differences over the neighboring posts.
+         osg::Vec3 normal(
+            (GetPostHeight(j - 1, i) - GetPostHeight(j + 1, i)) / (2.0f * step),
+            (GetPostHeight(j, i - 1) - GetPostHeight(j, i + 1)) / (2.0f * step),
+            1.0f);
+         normal.normalize();
+
+         (*normals)[i*width+j] = normal;
+
+         (*colors)[i*width+j] = mColorInfo.GetColor(heightAtXY);
+
+         (*textureCoordinates)[i*width+j].set(x*0.1, y*0.1);
+      }
+   }
+
+   osg::Geometry* geom = new osg::Geometry;
+
+   for (i=0;i<mSegmentDivisions;i++)
+   {
+      RefPtr<osg::DrawElementsUInt> indices = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLE_STRIP);
+      indices->reserveElements(width * 2);
+
+      for (j=0;j<width;j++)
+      {
+         indices->addElement((i+1)*width + j);
+         indices->addElement(i*width + j);
+      }
+
+      geom->addPrimitiveSet(indices);
+   }
+
+   geom->setVertexArray(vertices.get());
+
+   geom->setNormalArray(normals.get());
+   geom->setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
+
+   geom->setColorArray(colors.get());
+   geom->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
+
+   geom->setTexCoordArray(0, textureCoordinates.get());
+
+   geom->setUseDisplayList(true);
+
+   osg::Geode* geode = new osg::Geode;
+   geode->addDrawable(geom);
+
+   mNode = new osg::LOD;
+   mNode->addChild(geode, 0.0f, mBuildDistance);
+
+   ++mReady;
+}
+
 /**
  * Constructor.
  *
@@ -102,6 +320,10 @@ InfiniteTerrain::InfiniteTerrain(const std::string& name, osg::Image* textureIma
       mBuildDistance(3000.0f),
       mSmoothCollisionsEnabled(false),
       mClearFlag(false),
+      mAsyncBuildEnabled(false),
+      mPrefetchTime(2.0f),
+      mLastEyeTime(0.0),
+      mHasLastEyePoint(false),
       mLOSPostSpacing(0.0f)
 {
    SetName(name);
@@ -182,7 +404,8 @@ InfiniteTerrain::~InfiniteTerrain()
  */
 void InfiniteTerrain::Regenerate()
 {
-   mClearFlag = true;
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mSegmentMutex);
+   ClearSegments();
 }
 
 /**
@@ -192,9 +415,10 @@ void InfiniteTerrain::Regenerate()
  */
 void InfiniteTerrain::SetSegmentSize(float segmentSize)
 {
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mSegmentMutex);
    mSegmentSize = segmentSize;
 
-   mClearFlag = true;
+   ClearSegments();
 }
 
 /**
@@ -214,9 +438,10 @@ float InfiniteTerrain::GetSegmentSize() const
  */
 void InfiniteTerrain::SetSegmentDivisions(int segmentDivisions)
 {
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mSegmentMutex);
    mSegmentDivisions = segmentDivisions;
 
-   mClearFlag = true;
+   ClearSegments();
 }
 
 /**
@@ -237,9 +462,10 @@ int InfiniteTerrain::GetSegmentDivisions() const
  */
 void InfiniteTerrain::SetHorizontalScale(float horizontalScale)
 {
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mSegmentMutex);
    mHorizontalScale = horizontalScale;
 
-   mClearFlag = true;
+   ClearSegments();
 }
 
 /**
@@ -260,9 +486,10 @@ float InfiniteTerrain::GetHorizontalScale() const
  */
 void InfiniteTerrain::SetVerticalScale(float verticalScale)
 {
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mSegmentMutex);
    mVerticalScale = verticalScale;
 
-   mClearFlag = true;
+   ClearSegments();
 }
 
 /**
@@ -283,7 +510,11 @@ float InfiniteTerrain::GetVerticalScale() const
  */
 void InfiniteTerrain::SetBuildDistance(float buildDistance)
 {
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mSegmentMutex);
    mBuildDistance = buildDistance;
+
+   // The build distance offsets the noise and sets the segment LOD range.
+   ClearSegments();
 }
 
 /**
@@ -344,27 +575,8 @@ void InfiniteTerrain::SetupColorInfo()
 //returns an interpolated color based on the height
 osg::Vec4 InfiniteTerrain::GetColor(float height)
 {
-   float r,g,b;
-
-   float minPercent, maxPercent;
-   osg::Vec3* minColor;
-   osg::Vec3* maxColor;
-
-   minPercent = std::min<float>(std::max<float>(0.0f, (mIdealHeight - height) / mMinColorIncrement), 1.0f);
-   maxPercent = 1 - minPercent;
-   maxColor = &mMaxColor;
-   minColor = &mMinColor;
-
-   r = (*maxColor)[0] * maxPercent;
-   g = (*maxColor)[1] * maxPercent;
-   b = (*maxColor)[2] * maxPercent;
-
-
-   r += (*minColor)[0] * minPercent;
-   g += (*minColor)[1] * minPercent * minPercent;
-   b += (*minColor)[2] * minPercent * minPercent;
-
-   return osg::Vec4(r, g, b, 1.0f);
+   InfiniteTerrainColorInfo colorInfo = { mIdealHeight, mMinColorIncrement, mMinColor, mMaxColor };
+   return colorInfo.GetColor(height);
 }
 
 /**
@@ -396,18 +608,18 @@ float InfiniteTerrain::GetHeight(float x, float y, bool smooth)
 
       if (ix < iy)
       {
-         float p00 = GetHeight(fx*scale, fy*scale, true),
-               p01 = GetHeight(fx*scale, cy*scale, true),
-               p11 = GetHeight(cx*scale, cy*scale, true),
+         float p00 = GetPostHeight(int(fx), int(fy)),
+               p01 = GetPostHeight(int(fx), int(cy)),
+               p11 = GetPostHeight(int(cx), int(cy)),
                p00_01 = p00 + iy*(p01-p00);
 
          return p00_01 + ix*(p11 - p00_01);
       }
       else
       {
-         float p00 = GetHeight(fx*scale, fy*scale, true),
-               p10 = GetHeight(cx*scale, fy*scale, true),
-               p11 = GetHeight(cx*scale, cy*scale, true),
+         float p00 = GetPostHeight(int(fx), int(fy)),
+               p10 = GetPostHeight(int(cx), int(fy)),
+               p11 = GetPostHeight(int(cx), int(cy)),
                p10_11 = p10 + iy*(p11-p10);
 
          return p00 + ix*(p10_11 - p00);
@@ -450,9 +662,9 @@ void InfiniteTerrain::GetNormal(float x, float y, osg::Vec3& normal, bool smooth
 
       if (ix < iy)
       {
-         float p00 = GetHeight(fx*scale, fy*scale, true),
-               p01 = GetHeight(fx*scale, cy*scale, true),
-               p11 = GetHeight(cx*scale, cy*scale, true);
+         float p00 = GetPostHeight(int(fx), int(fy)),
+               p01 = GetPostHeight(int(fx), int(cy)),
+               p11 = GetPostHeight(int(cx), int(cy));
 
          osg::Vec3 v1(0.0f, -scale, p00 - p01);
          osg::Vec3 v2(scale, 0.0f, p11 - p01);
@@ -463,9 +675,9 @@ void InfiniteTerrain::GetNormal(float x, float y, osg::Vec3& normal, bool smooth
       }
       else
       {
-         float p00 = GetHeight(fx*scale, fy*scale, true),
-               p10 = GetHeight(cx*scale, fy*scale, true),
-               p11 = GetHeight(cx*scale, cy*scale, true);
+         float p00 = GetPostHeight(int(fx), int(fy)),
+               p10 = GetPostHeight(int(cx), int(fy)),
+               p11 = GetPostHeight(int(cx), int(cy));
 
          osg::Vec3 v1(0.0f, scale, p11 - p10);
          osg::Vec3 v2(-scale, 0.0f, p00 - p10 );
@@ -487,101 +699,201 @@ void InfiniteTerrain::BuildSegment(int x, int y)
 {
    Segment coord(x, y);
 
-   if (mBuiltSegments.count(coord) > 0)
+   SegmentMap::iterator found = mSegments.find(coord);
+   if (found == mSegments.end())
    {
+      RefPtr<InfiniteTerrainSegment> segment = CreateSegment(x, y);
+      mSegments.insert(std::make_pair(coord, segment));
+
+      segment->Build();
+      GetMatrixNode()->addChild(segment->GetNode());
       return;
    }
-   else
+
+   // The segment is needed now, so finish it here if the background hasn't.
+   InfiniteTerrainSegment* segment = found->second.get();
+   std::vector<RefPtr<InfiniteTerrainSegment> >::iterator pending =
+      std::find(mPendingSegments.begin(), mPendingSegments.end(), segment);
+   if (pending != mPendingSegments.end())
    {
-      mBuiltSegments.insert(coord);
+      segment->Build();
+      GetMatrixNode()->addChild(segment->GetNode());
+      mPendingSegments.erase(pending);
    }
+}
 
-   osg::LOD* lod = new osg::LOD;
-
-   osg::Geode* geode = new osg::Geode;
-
-   osg::Geometry* geom = new osg::Geometry;
-
-   int width = mSegmentDivisions + 1,
-       height = mSegmentDivisions + 1;
-
-   osg::Vec2 minimum(x * mSegmentSize, y * mSegmentSize);
-
-   RefPtr<osg::Vec3Array> vertices =
-      new osg::Vec3Array(width*height);
+/**
+ * Queues a single terrain segment to be built on a background thread.
+ *
+ * @param x the x coordinate at which to build the segment
+ * @param y the y coordinate at which to build the segment
+ */
+void InfiniteTerrain::QueueSegment(int x, int y)
+{
+   Segment coord(x, y);
 
-   RefPtr<osg::Vec3Array> normals =
-      new osg::Vec3Array(width*height);
+   if (mSegments.count(coord) > 0 || mPendingSegments.size() >= MAX_PENDING_SEGMENTS)
+   {
+      return;
+   }
 
-   RefPtr<osg::Vec4Array> colors =
-      new osg::Vec4Array(width*height);
+   RefPtr<InfiniteTerrainSegment> segment = CreateSegment(x, y);
+   mSegments.insert(std::make_pair(coord, segment));
+   mPendingSegments.push_back(segment);
 
-   RefPtr<osg::Vec2Array> textureCoordinates =
-      new osg::Vec2Array(width*height);
+   dtUtil::ThreadPool::AddTask(*segment, dtUtil::ThreadPool::BACKGROUND);
+}
 
-   int i, j;
+InfiniteTerrainSegment* InfiniteTerrain::CreateSegment(int x, int y)
+{
+   InfiniteTerrainColorInfo colorInfo = { mIdealHeight, mMinColorIncrement, mMinColor, mMaxColor };
+   return new InfiniteTerrainSegment(x, y, mNoise, mSegmentSize, mSegmentDivisions,
+      mHorizontalScale, mVerticalScale, mBuildDistance, colorInfo);
+}
 
-   for (i=0;i<height;i++)
+void InfiniteTerrain::AttachReadySegments()
+{
+   std::vector<RefPtr<InfiniteTerrainSegment> >::iterator i = mPendingSegments.begin();
+   while (i != mPendingSegments.end())
    {
-      for (j=0;j<width;j++)
+      if ((*i)->IsReady())
       {
-         float x = minimum[0] + j * (mSegmentSize / mSegmentDivisions),
-               y = minimum[1] + i * (mSegmentSize / mSegmentDivisions);
+         GetMatrixNode()->addChild((*i)->GetNode());
+         i = mPendingSegments.erase(i);
+      }
+      else
+      {
+         ++i;
+      }
+   }
+}
 
-         float heightAtXY = GetHeight(x, y, true);
+void InfiniteTerrain::ClearSegments()
+{
+   // Queued segments may still be running, but they are dropped when they finish.
+   mSegments.clear();
+   mPendingSegments.clear();
 
-         (*vertices)[i*width+j].set(
-            x, y,
-            heightAtXY
-         );
+   // The scene is only changed from the cull traversal.
+   mClearFlag = true;
+}
 
-         osg::Vec3 normal;
+void InfiniteTerrain::UpdateSegments(const osg::Vec3& eyePoint, double time)
+{
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mSegmentMutex);
 
-         GetNormal(x, y, normal, true);
+   if (mClearFlag)
+   {
+      GetMatrixNode()->removeChild(0, GetMatrixNode()->getNumChildren());
+      mClearFlag = false;
+   }
 
-         (*normals)[i*width+j].set(normal[0], normal[1], normal[2]);
+   AttachReadySegments();
 
-         (*colors)[i*width+j] = GetColor(heightAtXY);
+   float bd = mBuildDistance,
+         bd2 = bd*2,
+         x = eyePoint[0] - bd,
+         y = eyePoint[1] - bd;
 
-         (*textureCoordinates)[i*width+j].set(x*0.1, y*0.1);
+   for (float i=0.0f;i<=bd2;i+=mSegmentSize)
+   {
+      for (float j=0.0f;j<=bd2;j+=mSegmentSize)
+      {
+         BuildSegment(
+            int((x + i)/mSegmentSize),
+            int((y + j)/mSegmentSize)
+         );
       }
    }
 
-   
-   for (i=0;i<mSegmentDivisions;i++)
+   if (mAsyncBuildEnabled && dtUtil::ThreadPool::IsInitialized())
    {
-      RefPtr<osg::DrawElementsUInt> indices = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLE_STRIP);
-      indices->reserveElements(width * 2);
+      // Queue a ring one segment wider than the build distance around where the eyepoint is heading.
+      osg::Vec3 ahead = eyePoint;
+      if (mHasLastEyePoint && time > mLastEyeTime)
+      {
+         osg::Vec3 velocity = (eyePoint - mLastEyePoint) / float(time - mLastEyeTime);
+         ahead += velocity * mPrefetchTime;
+      }
 
-      for (j=0;j<width;j++)
+      float pd = bd + mSegmentSize,
+            pd2 = pd*2,
+            px = ahead[0] - pd,
+            py = ahead[1] - pd;
+
+      for (float i=0.0f;i<=pd2;i+=mSegmentSize)
       {
-         indices->addElement((i+1)*width + j);
-         indices->addElement(i*width + j);
+         for (float j=0.0f;j<=pd2;j+=mSegmentSize)
+         {
+            QueueSegment(
+               int((px + i)/mSegmentSize),
+               int((py + j)/mSegmentSize)
+            );
+         }
       }
-      
-      geom->addPrimitiveSet(indices);
    }
 
-   geom->setVertexArray(vertices.get());
+   mLastEyePoint = eyePoint;
+   mLastEyeTime = time;
+   mHasLastEyePoint = true;
+}
 
-   geom->setNormalArray(normals.get());
-   geom->setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
+unsigned InfiniteTerrain::GetNumPendingSegments() const
+{
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mSegmentMutex);
+   return unsigned(mPendingSegments.size());
+}
 
-   geom->setColorArray(colors.get());
-   geom->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
+void InfiniteTerrain::FinishPendingSegments()
+{
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mSegmentMutex);
+   for (size_t i = 0; i < mPendingSegments.size(); ++i)
+   {
+      mPendingSegments[i]->Build();
+      GetMatrixNode()->addChild(mPendingSegments[i]->GetNode());
+   }
+   mPendingSegments.clear();
+}
 
-   geom->setTexCoordArray(0, textureCoordinates.get());
+float InfiniteTerrain::GetPostHeight(int gridX, int gridY)
+{
+   // Find the segment holding the post, rounding toward negative infinity.
+   int segmentX = gridX >= 0 ? gridX / mSegmentDivisions : -((-gridX - 1) / mSegmentDivisions) - 1;
+   int segmentY = gridY >= 0 ? gridY / mSegmentDivisions : -((-gridY - 1) / mSegmentDivisions) - 1;
 
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mSegmentMutex);
+      SegmentMap::const_iterator found = mSegments.find(Segment(segmentX, segmentY));
+      if (found != mSegments.end() && found->second->IsReady()
+         && found->second->GetSegmentDivisions() == mSegmentDivisions)
+      {
+         return found->second->GetPostHeight(gridX - segmentX * mSegmentDivisions, gridY - segmentY * mSegmentDivisions);
+      }
+   }
 
-   geom->setUseDisplayList(true);
+   float scale = mSegmentSize / mSegmentDivisions;
+   return GetHeight(gridX * scale, gridY * scale, true);
+}
 
-   geode->addDrawable(geom);
+void InfiniteTerrain::SetAsyncBuildEnabled(bool enable)
+{
+   mAsyncBuildEnabled = enable;
+}
 
-   lod->addChild(geode, 0.0f, mBuildDistance);
+bool InfiniteTerrain::IsAsyncBuildEnabled() const
+{
+   return mAsyncBuildEnabled;
+}
 
-   GetMatrixNode()->addChild(lod);
+void InfiniteTerrain::SetPrefetchTime(float seconds)
+{
+   mPrefetchTime = seconds;
 }
 
+float InfiniteTerrain::GetPrefetchTime() const
+{
+   return mPrefetchTime;
+}
 
 
 bool InfiniteTerrain::IsClearLineOfSight( const osg::Vec3& pointOne,
@@ -77,6 +77,9 @@ XERCES_CPP_NAMESPACE_USE
 
 namespace dtCore
 {
+   /// The parser whose Parse(path) call is running on this thread, so the reader writer below uses the same one.
+   static thread_local MapParser* tParserOnThisThread = NULL;
+
    /////////////////////////////////////////////////////////////////
    //this class is used as a wrapper to read the map files through osgdb
    //which will support loading through archives such as .zip files
@@ -95,7 +98,11 @@ namespace dtCore
 
          bool ParseMap(std::istream& str, bool prefab)
          {
-            dtCore::RefPtr<MapParser> parser = Project::GetInstance().GetCurrentMapParser();
+            dtCore::RefPtr<MapParser> parser = MapParser::GetParserOnThisThread();
+            if (parser == NULL)
+            {
+               parser = Project::GetInstance().GetCurrentMapParser();
+            }
 
             if(parser == NULL)
             {
@@ -114,7 +121,11 @@ namespace dtCore
          {
             std::string mapName;
 
-            dtCore::RefPtr<MapParser> parser = Project::GetInstance().GetCurrentMapParser();
+            dtCore::RefPtr<MapParser> parser = MapParser::GetParserOnThisThread();
+            if (parser == NULL)
+            {
+               parser = Project::GetInstance().GetCurrentMapParser();
+            }
 
             if(parser == NULL)
             {
@@ -273,6 +284,14 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    bool MapParser::Parse(const std::string& path, Map** map, bool prefab)
    {
+      // Put back whatever was there, since loading a map can load a prefab with another parser.
+      struct ScopedParserOnThisThread
+      {
+         ScopedParserOnThisThread(MapParser* parser) : mPrevious(tParserOnThisThread) { tParserOnThisThread = parser; }
+         ~ScopedParserOnThisThread() { tParserOnThisThread = mPrevious; }
+         MapParser* mPrevious;
+      } scopedParser(this);
+
       bool result = false;
       dtCore::RefPtr<MapReaderWriter::MapStream> mapStreamObject;
 
@@ -498,6 +517,12 @@ namespace dtCore
 
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   MapParser* MapParser::GetParserOnThisThread()
+   {
+      return tParserOnThisThread;
+   }
+
    /////////////////////////////////////////////////////////////////////////////
    Map* MapParser::GetMapBeingParsed()
    {
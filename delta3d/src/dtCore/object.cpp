@@ -3,10 +3,12 @@
 //////////////////////////////////////////////////////////////////////
 #include <prefix/dtcoreprefix.h>
 #include <dtCore/object.h>
+#include <dtCore/asyncmeshloader.h>
 #include <dtCore/transform.h>
 #include <dtCore/project.h>
 
 #include <dtUtil/boundingshapeutils.h>
+#include <dtUtil/log.h>
 
 #include <osg/MatrixTransform>
 #include <osg/Matrix>
@@ -22,6 +24,7 @@ namespace dtCore
       , mUseCache(true)
       , mRecenterGeometryUponLoad(false)
       , mGenerateTangents(false)
+      , mLoadAsynchronously(false)
       , mModel(new Model)
    {
       Ctor();
@@ -33,6 +36,7 @@ namespace dtCore
       , mUseCache(true)
       , mRecenterGeometryUponLoad(false)
       , mGenerateTangents(false)
+      , mLoadAsynchronously(false)
       , mModel(new Model)
    {
       Ctor();
@@ -59,9 +63,49 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    osg::Node* Object::LoadFile(const std::string& filename, bool useCache)
    {
-      osg::Node* node = NULL;
-      node = Loadable::LoadFile(filename, useCache);
+      // a synchronous load replaces any pending async one.
+      mPendingAsyncFile.clear();
 
+      osg::Node* node = Loadable::LoadFile(filename, useCache);
+      AttachLoadedNode(node);
+      return node;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Object::LoadFileAsync(const std::string& filename, bool useCache)
+   {
+      mFilename = filename;
+      mPendingAsyncFile = filename;
+      AsyncMeshLoader::GetInstance().RequestLoad(filename, useCache,
+               AsyncMeshLoader::LoadCallback(this, &Object::OnAsyncMeshLoaded), this);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool Object::IsLoadingAsynchronously() const
+   {
+      return !mPendingAsyncFile.empty();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Object::OnAsyncMeshLoaded(osg::Node* node, const std::string& filename)
+   {
+      // Ignore loads that have been replaced by a later one.
+      if (filename != mPendingAsyncFile)
+      {
+         return;
+      }
+      mPendingAsyncFile.clear();
+
+      if (node == NULL)
+      {
+         LOG_WARNING("Can't load '" + filename + "'");
+      }
+      AttachLoadedNode(node);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Object::AttachLoadedNode(osg::Node* node)
+   {
       //We should always clear the geometry.  If LoadFile fails, we should have no geometry.
       if (mModel->GetMatrixTransform().getNumChildren() != 0)
       {
@@ -91,12 +135,20 @@ namespace dtCore
          {
             GenerateTangents();
          }
+      }
+   }
 
-         return node;
+   /////////////////////////////////////////////////////////////////////////////
+   void Object::LoadMeshResource()
+   {
+      std::string path = dtCore::Project::GetInstance().GetResourcePath(mMeshResource);
+      if (mLoadAsynchronously && !dtCore::Project::GetInstance().GetEditMode())
+      {
+         LoadFileAsync(path, GetUseCache());
       }
       else
       {
-         return NULL;
+         LoadFile(path, GetUseCache());
       }
    }
 
@@ -111,7 +163,7 @@ namespace dtCore
       {
          if (mMeshResource != dtCore::ResourceDescriptor::NULL_RESOURCE)
          {
-            LoadFile(dtCore::Project::GetInstance().GetResourcePath(mMeshResource), GetUseCache());
+            LoadMeshResource();
          }
       }
    }
@@ -120,6 +172,7 @@ namespace dtCore
    DT_IMPLEMENT_ACCESSOR(Object, bool, UseCache);
    DT_IMPLEMENT_ACCESSOR(Object, bool, RecenterGeometryUponLoad);
    DT_IMPLEMENT_ACCESSOR(Object, bool, GenerateTangents);
+   DT_IMPLEMENT_ACCESSOR(Object, bool, LoadAsynchronously);
 
 
    //////////////////////////////////////////////////////////////////////////
@@ -134,7 +187,7 @@ namespace dtCore
          // For the initial setting, load the mesh when we first enter the world so we can use the cache variable
          if (GetSceneParent())
          {
-            LoadFile(dtCore::Project::GetInstance().GetResourcePath(mMeshResource), GetUseCache());
+            LoadMeshResource();
          }
       }
 
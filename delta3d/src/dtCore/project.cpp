@@ -29,10 +29,12 @@
 
 #include <dtCore/scene.h>
 
+#include <dtUtil/frameprofiler.h>
 #include <dtUtil/log.h>
 #include <dtUtil/stringutils.h>
 #include <dtUtil/datapathutils.h>
 #include <dtUtil/fileutils.h>
+#include <dtUtil/filepathindex.h>
 #include <dtUtil/wrapperosgobject.h>
 
 #include <dtCore/project.h>
@@ -54,6 +56,9 @@
 #include <osgDB/ReadFile>
 #include <osgDB/WriteFile>
 
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+
 namespace dtCore
 {
    const std::string Project::LOG_NAME("project.cpp");
@@ -67,12 +72,23 @@ namespace dtCore
       Project::ContextSlot mSlotId;
    };
 
+   /// A parsed prefab kept so that later loads can clone the actors instead of parsing the file again.
+   struct PrefabTemplate
+   {
+      std::string mFullPath;
+      time_t mLastModified;
+      size_t mSize;
+      MapPtr mMap;
+      ActorRefPtrVector mActors;
+   };
+
    class ProjectImpl {
    public:
       ProjectImpl()
       : mContextReadOnly(true)
       , mResourcesIndexed(false)
       , mEditMode(false)
+      , mPrefabCacheEnabled(true)
       {
          libraryManager = &ActorFactory::GetInstance();
          mLogger = &dtUtil::Log::GetInstance(Project::LOG_NAME);
@@ -87,6 +103,8 @@ namespace dtCore
       }
 
       std::vector<std::string> mContexts;
+      /// An index of the files in each context, in the same order as mContexts, for resolving resources.
+      std::vector<dtCore::RefPtr<dtUtil::FilePathIndex> > mContextIndexes;
 
       bool mContextReadOnly;
       mutable bool mResourcesIndexed;
@@ -100,10 +118,52 @@ namespace dtCore
       dtCore::Project::MapTreeData mMapTree;
 
       std::map<std::string, dtCore::RefPtr<Map> > mOpenMaps; //< A vector of the maps currently loaded.
+
+      /**
+       * Guards mOpenMaps.  Only the main thread changes it, and it holds this while it does.  Map parsing on a worker
+       * reads it through GetMapForActor and GetGameEvent, which hold it while they read.  The contexts are not locked
+       * so resource lookups stay lock free, so they must not change while a map is being parsed.
+       */
+      mutable OpenThreads::Mutex mMutex;
+
+      void InsertOpenMap(const std::string& name, Map& map)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         mOpenMaps.insert(std::make_pair(name, dtCore::RefPtr<Map>(&map)));
+      }
+
+      void EraseOpenMap(std::map<std::string, dtCore::RefPtr<Map> >::iterator i)
+      {
+         // Declared before the lock so the map is deleted after it's released.
+         dtCore::RefPtr<Map> holder = i->second;
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         mOpenMaps.erase(i);
+      }
       mutable Project::ResourceTree mResources; //< a tree of all the resources.  This is more of a cache.
 
       dtCore::RefPtr<MapParser> mParser;
 
+      typedef std::map<ResourceDescriptor, PrefabTemplate> PrefabCache;
+      PrefabCache mPrefabCache;
+      /// Prefabs load on map parsing workers too.  Not held while parsing, since prefabs can contain prefabs.
+      mutable OpenThreads::Mutex mPrefabCacheMutex;
+
+      void ClearPrefabCache()
+      {
+         PrefabCache cleared;
+         {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPrefabCacheMutex);
+            cleared.swap(mPrefabCache);
+         }
+      }
+
+      void ErasePrefabFromCache(const ResourceDescriptor& rd)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPrefabCacheMutex);
+         mPrefabCache.erase(rd);
+      }
+      bool mPrefabCacheEnabled;
+
       //This is here to make sure the library manager is deleted AFTER the maps are closed.
       //so that libraries won't be closed and the proxies deleted out from under the map.
       dtCore::RefPtr<ActorFactory> libraryManager;
@@ -125,9 +185,13 @@ namespace dtCore
 
       //internal handling for loading a map.
       Map& InternalLoadMap(const MapFileData& fileData, bool backup, bool clearModified);
+      std::string GetMapFilePath(const MapFileData& fileData, bool backup);
 
       MapPtr InternalLoadPrefab(const std::string& fullPath, dtCore::ActorRefPtrVector& actorsOut);
 
+      //loads a prefab through the template cache, parsing it only if the file changed.
+      MapPtr InternalLoadCachedPrefab(const ResourceDescriptor& rd, const std::string& fullPath, dtCore::ActorRefPtrVector& actorsOut);
+
       //internal handling of closing a sincle map.
       void InternalCloseMap(Map& map, bool unloadLibraries);
 
@@ -424,6 +488,7 @@ namespace dtCore
 
       mContexts.push_back(dtUtil::FileUtils::GetInstance().CurrentDirectory());
       const std::string& context = mContexts.back();
+      mContextIndexes.push_back(new dtUtil::FilePathIndex(context));
       std::string searchPath = dtUtil::GetDataFilePathList();
 
       if (searchPath.empty())
@@ -464,13 +529,19 @@ namespace dtCore
             dtUtil::SetDataFilePathList(searchPath);
          }
          mContexts.erase(mContexts.begin() + slot);
+         mContextIndexes.erase(mContextIndexes.begin() + slot);
       }
    }
 
    /////////////////////////////////////////////////////////////////////////////
    void Project::ClearAllContexts()
    {
-      mImpl->mOpenMaps.clear();
+      std::map<std::string, dtCore::RefPtr<Map> > closedMaps;
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mImpl->mMutex);
+         closedMaps.swap(mImpl->mOpenMaps);
+      }
+      closedMaps.clear();
       //clear the references to all the open maps
       mImpl->mMapList.clear();
       mImpl->mMapNames.clear();
@@ -479,6 +550,8 @@ namespace dtCore
       mImpl->mResources.clear();
       mImpl->mResourcesIndexed = false;
 
+      mImpl->ClearPrefabCache();
+
       while (!mImpl->mContexts.empty())
       {
          mImpl->InternalRemoveContext(0);
@@ -558,6 +631,9 @@ namespace dtCore
       //clear out the list of mResources.
       mImpl->mResources.clear();
       mImpl->mResourcesIndexed = false;
+
+      // The contexts may have changed, so the same descriptor could now point to another file.
+      mImpl->ClearPrefabCache();
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -801,20 +877,15 @@ namespace dtCore
       // This really should be impossible because the code shouldn't call this unless it already validated the path.
       if (fullPath.empty()) return MapPtr(nullptr);
 
-      //create the parser after setting the context.
-      //because the parser looks for map.xsd in the constructor.
-      //that way users can put map.xsd in the project and not need
-      //a "data" path.
-      if (!mParser.valid())
-      {
-         mParser = new MapParser();
-      }
+      // Prefabs get their own parser.  They load on map parsing workers and from inside other
+      // map and prefab loads, so they can't share mParser.
+      dtCore::RefPtr<MapParser> parser = new MapParser();
 
       MapPtr mapToUse;
       try
       {
          Map* mapRawPointer = nullptr;
-         mParser->Parse(fullPath,&mapRawPointer, true);
+         parser->Parse(fullPath,&mapRawPointer, true);
          mapToUse = mapRawPointer;
          if (!mapToUse.valid())
          {
@@ -828,21 +899,55 @@ namespace dtCore
       }
       catch (const dtUtil::Exception& e)
       {
-         mParser = NULL;
          std::string error = "Unable to parse \"" + fullPath + "\" with error \"" + e.What() + "\"";
          mLogger->LogMessage(dtUtil::Log::LOG_INFO, __FUNCTION__, __LINE__, error.c_str());
          throw e;
       }
 
-      mParser = NULL; //done using this MapParser, delete it
       return mapToUse;
    }
 
    /////////////////////////////////////////////////////////////////////////////
-   Map& ProjectImpl::InternalLoadMap(const MapFileData& fileData, bool backup, bool clearModified)
+   /// Does the parse and clean up for a map load.  Nothing in here touches the project.
+   static dtCore::RefPtr<Map> ParseMapWithParser(MapParser& parser, const std::string& fullPath, bool clearModified)
    {
-      dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+      if (dtUtil::FileUtils::GetInstance().GetFileInfo(fullPath).fileType != dtUtil::REGULAR_FILE)
+      {
+         throw dtCore::ProjectFileNotFoundException(
+                std::string("Map file \"") + fullPath + "\" not found.", __FILE__, __LINE__);
+      }
 
+      Map* rawMap = NULL;
+      if (!parser.Parse(fullPath, &rawMap) || rawMap == NULL)
+      {
+         throw dtCore::MapParsingException(
+            "Map loading didn't throw an exception, but the result is NULL", __FILE__, __LINE__);
+      }
+      dtCore::RefPtr<Map> map = rawMap;
+
+      //Clearing the modified flag must be done because setting the
+      //map properties at load will make the map look modified.
+      //it must be done before adding the missing libraries and proxy
+      //classes because clearing the modified flag clears those lists.
+      if (clearModified)
+      {
+         map->ClearModified();
+      }
+
+      // If the map has a temporary property, we should mark it modified.
+      if (parser.HasDeprecatedProperty())
+      {
+         map->SetModified(true);
+      }
+
+      map->AddMissingLibraries(parser.GetMissingLibraries());
+      map->AddMissingActorTypes(parser.GetMissingActorTypes());
+      return map;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   std::string ProjectImpl::GetMapFilePath(const MapFileData& fileData, bool backup)
+   {
       std::string fullPath = GetMapsDirectory(mContexts[fileData.mSlotId], true).fileName;
 
       if (backup)
@@ -855,7 +960,15 @@ namespace dtCore
       {
          fullPath += ".backup";
       }
+      return fullPath;
+   }
 
+   /////////////////////////////////////////////////////////////////////////////
+   Map& ProjectImpl::InternalLoadMap(const MapFileData& fileData, bool backup, bool clearModified)
+   {
+      DT_PROFILE_ZONE("LoadMap");
+
+      std::string fullPath = GetMapFilePath(fileData, backup);
       Map* map = NULL;
 
       //create the parser after setting the context.
@@ -869,38 +982,11 @@ namespace dtCore
 
       try
       {
-         if (fileUtils.GetFileInfo(fullPath).fileType != dtUtil::REGULAR_FILE)
-         {
-            throw dtCore::ProjectFileNotFoundException(
-                   std::string("Map file \"") + fullPath + "\" not found.", __FILE__, __LINE__);
-         }
-
-         if (!mParser->Parse(fullPath, &map) || map == NULL)
-         {
-            throw dtCore::MapParsingException(
-               "Map loading didn't throw an exception, but the result is NULL", __FILE__, __LINE__);
-         }
+         dtCore::RefPtr<Map> parsed = ParseMapWithParser(*mParser, fullPath, clearModified);
+         map = parsed.get();
 
          // TODO the name here should be the disabiguated name?
-         mOpenMaps.insert(std::make_pair(fileData.mOrigName, dtCore::RefPtr<Map>(map)));
-
-         //Clearing the modified flag must be done because setting the
-         //map properties at load will make the map look modified.
-         //it must be done before adding the missing libraries and proxy
-         //classes because clearing the modified flag clears those lists.
-         if (clearModified)
-         {
-            map->ClearModified();
-         }
-
-         // If the map has a temporary property, we should mark it modified.
-         if (mParser->HasDeprecatedProperty())
-         {
-            map->SetModified(true);
-         }
-
-         map->AddMissingLibraries(mParser->GetMissingLibraries());
-         map->AddMissingActorTypes(mParser->GetMissingActorTypes());
+         InsertOpenMap(fileData.mOrigName, *parsed);
       }
       catch (const dtUtil::Exception& e)
       {
@@ -948,6 +1034,57 @@ namespace dtCore
       return map;
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   std::string Project::GetMapFilePath(const std::string& name)
+   {
+      if (!IsContextValid())
+      {
+         throw dtCore::ProjectInvalidContextException(
+         std::string("The context is not valid."), __FILE__, __LINE__);
+      }
+
+      ProjectImpl::MapListType::iterator mapIter = mImpl->mMapList.find(name);
+      if (mapIter == mImpl->mMapList.end())
+      {
+         throw dtCore::ProjectFileNotFoundException(
+                std::string("Map named ") + name + " does not exist.", __FILE__, __LINE__);
+      }
+
+      return mImpl->GetMapFilePath(mapIter->second, false);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<Map> Project::ParseMapFile(const std::string& fullPath)
+   {
+      DT_PROFILE_ZONE("ParseMap");
+      // Each call gets its own parser so calls on different threads don't share any state.
+      dtCore::RefPtr<MapParser> parser = new MapParser();
+      return ParseMapWithParser(*parser, fullPath, true);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   Map& Project::AddParsedMap(const std::string& name, Map& map)
+   {
+      dtCore::RefPtr<Map> holder = &map;
+
+      std::map<std::string, dtCore::RefPtr<Map> >::iterator openMapI = mImpl->mOpenMaps.find(name);
+      if (openMapI != mImpl->mOpenMaps.end())
+      {
+         return *(openMapI->second);
+      }
+
+      ProjectImpl::MapListType::iterator mapIter = mImpl->mMapList.find(name);
+      if (mapIter == mImpl->mMapList.end())
+      {
+         throw dtCore::ProjectFileNotFoundException(
+                std::string("Map named ") + name + " does not exist.", __FILE__, __LINE__);
+      }
+
+      mImpl->InsertOpenMap(mapIter->second.mOrigName, map);
+      map.SetFileName(mapIter->second.mFileName);
+      return map;
+   }
+
    //////////////////////////////////////////////////////////////////////////
    bool Project::IsMapOpen(const std::string& name)
    {
@@ -981,7 +1118,7 @@ namespace dtCore
       if (openMapI != mImpl->mOpenMaps.end())
       {
          //close the map if it's open.
-         mImpl->mOpenMaps.erase(openMapI);
+         mImpl->EraseOpenMap(openMapI);
       }
 
       ProjectImpl::MapListType::iterator mapIter = mImpl->mMapList.find(name);
@@ -1053,7 +1190,7 @@ namespace dtCore
 
       mImpl->InternalSaveMap(*map, slot);
 
-      mImpl->mOpenMaps.insert(make_pair(name, dtCore::RefPtr<Map>(map.get())));
+      mImpl->InsertOpenMap(name, *map);
       //The map can add extensions and such to the file name, so it
       //must be fetched back from the map object before being added to the name-file map.
       MapFileData fileData;
@@ -1092,9 +1229,111 @@ namespace dtCore
 
       std::string fullPath = GetResourcePath(rd);
 
+      if (mImpl->mPrefabCacheEnabled)
+      {
+         return mImpl->InternalLoadCachedPrefab(rd, fullPath, actorsOut);
+      }
+
       return mImpl->InternalLoadPrefab(fullPath, actorsOut);
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   MapPtr ProjectImpl::InternalLoadCachedPrefab(const ResourceDescriptor& rd, const std::string& fullPath, dtCore::ActorRefPtrVector& actorsOut)
+   {
+      if (fullPath.empty()) return MapPtr(nullptr);
+
+      dtUtil::FileInfo fileInfo = dtUtil::FileUtils::GetInstance().GetFileInfo(fullPath);
+
+      // Copied out so the entry can be replaced by another thread while the actors are cloned.
+      PrefabTemplate prefabTemplate;
+      bool upToDate = false;
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPrefabCacheMutex);
+         PrefabCache::iterator found = mPrefabCache.find(rd);
+         if (found != mPrefabCache.end()
+                  && found->second.mFullPath == fullPath
+                  && found->second.mLastModified == fileInfo.lastModified
+                  && found->second.mSize == fileInfo.size)
+         {
+            prefabTemplate = found->second;
+            upToDate = true;
+         }
+      }
+
+      if (!upToDate)
+      {
+         prefabTemplate.mFullPath = fullPath;
+         prefabTemplate.mLastModified = fileInfo.lastModified;
+         prefabTemplate.mSize = fileInfo.size;
+         // If this throws, the stale entry is left alone and will be retried next time.
+         prefabTemplate.mMap = InternalLoadPrefab(fullPath, prefabTemplate.mActors);
+
+         // Another thread may have parsed it at the same time, in which case the last one in wins.
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPrefabCacheMutex);
+         mPrefabCache[rd] = prefabTemplate;
+      }
+
+      const Map& templateMap = *prefabTemplate.mMap;
+
+      // Build a new map with the header of the template so callers can read it or add actors to it like a parsed one.
+      MapPtr result = new Map(templateMap.GetFileName(), templateMap.GetName());
+      result->SetDescription(templateMap.GetDescription());
+      result->SetIconFile(templateMap.GetIconFile());
+
+      const std::vector<std::string>& libraries = templateMap.GetAllLibraries();
+      for (std::vector<std::string>::const_iterator i = libraries.begin(); i != libraries.end(); ++i)
+      {
+         result->AddLibrary(*i, templateMap.GetLibraryVersion(*i));
+      }
+
+      // Clones get fresh unique ids, just as the parser creates new actors for a prefab.
+      actorsOut.reserve(actorsOut.size() + prefabTemplate.mActors.size());
+      for (ActorRefPtrVector::const_iterator i = prefabTemplate.mActors.begin(); i != prefabTemplate.mActors.end(); ++i)
+      {
+         dtCore::RefPtr<BaseActorObject> copy = (*i)->Clone();
+         if (!copy.valid())
+         {
+            continue;
+         }
+
+         copy->OnMapLoadEnd();
+         result->AddProxy(*copy);
+         actorsOut.push_back(copy);
+      }
+
+      result->ClearModified();
+      return result;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Project::SetPrefabCacheEnabled(bool enable)
+   {
+      mImpl->mPrefabCacheEnabled = enable;
+      if (!enable)
+      {
+         mImpl->ClearPrefabCache();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool Project::IsPrefabCacheEnabled() const
+   {
+      return mImpl->mPrefabCacheEnabled;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Project::ClearPrefabCache()
+   {
+      mImpl->ClearPrefabCache();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned Project::GetPrefabCacheSize() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mImpl->mPrefabCacheMutex);
+      return unsigned(mImpl->mPrefabCache.size());
+   }
+
    /////////////////////////////////////////////////////////////////////////////
    ResourceDescriptor Project::SavePrefab(const std::string& name, const std::string& category, const ActorRefPtrVector& actorList,
          const std::string& description,
@@ -1390,7 +1629,7 @@ namespace dtCore
       else
       {
          mImpl->InternalCloseMap(map, unloadLibraries);
-         mImpl->mOpenMaps.erase(mapIter);
+         mImpl->EraseOpenMap(mapIter);
       }
    }
 
@@ -1404,7 +1643,7 @@ namespace dtCore
          std::map<std::string, dtCore::RefPtr<Map> >::iterator inext = mapIter;
          ++inext;
          mImpl->InternalCloseMap(*mapIter->second, unloadLibraries);
-         mImpl->mOpenMaps.erase(mapIter);
+         mImpl->EraseOpenMap(mapIter);
          mapIter = inext;
       }
    }
@@ -1734,6 +1973,7 @@ namespace dtCore
 
          dtCore::RefPtr<Map> holder(&map);
 
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
          mOpenMaps.erase(mOpenMaps.find(map.GetSavedName()));
          mOpenMaps.insert(make_pair(map.GetName(), holder));
       }
@@ -1907,9 +2147,16 @@ namespace dtCore
          throw dtCore::ProjectInvalidContextException(
          std::string("The context is not valid."), __FILE__, __LINE__);
 
-      if (mImpl->mParser.valid() && mImpl->mParser->IsParsing())
+      // Maps may be parsed on a worker with their own parser, so check the one on this thread.
+      MapParser* parser = MapParser::GetParserOnThisThread();
+      if (parser == NULL)
+      {
+         parser = mImpl->mParser.get();
+      }
+
+      if (parser != NULL && parser->IsParsing())
       {
-         Map* m = mImpl->mParser->GetMapBeingParsed();
+         Map* m = parser->GetMapBeingParsed();
          if (m != NULL)
          {
             BaseActorObject* ap = m->GetProxyById(id);
@@ -1918,6 +2165,7 @@ namespace dtCore
          }
       }
 
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mImpl->mMutex);
       std::map< std::string, dtCore::RefPtr<Map> >::iterator i = mImpl->mOpenMaps.begin();
       while (i != mImpl->mOpenMaps.end())
       {
@@ -1939,9 +2187,15 @@ namespace dtCore
             std::string("The context is not valid."), __FILE__, __LINE__);
       }
 
-      if (mImpl->mParser.valid() && mImpl->mParser->IsParsing())
+      const MapParser* parser = MapParser::GetParserOnThisThread();
+      if (parser == NULL)
       {
-         const Map* m = mImpl->mParser->GetMapBeingParsed();
+         parser = mImpl->mParser.get();
+      }
+
+      if (parser != NULL && parser->IsParsing())
+      {
+         const Map* m = parser->GetMapBeingParsed();
          if (m != NULL)
          {
             const BaseActorObject* ap = m->GetProxyById(id);
@@ -1950,6 +2204,7 @@ namespace dtCore
          }
       }
 
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mImpl->mMutex);
       std::map< std::string, dtCore::RefPtr<Map> >::const_iterator i = mImpl->mOpenMaps.begin();
       while (i != mImpl->mOpenMaps.end())
       {
@@ -1990,6 +2245,7 @@ namespace dtCore
          return NULL;
       }
 
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mImpl->mMutex);
       std::map<std::string, dtCore::RefPtr<Map> >::iterator i = mImpl->mOpenMaps.begin();
       for (; i != mImpl->mOpenMaps.end(); ++i)
       {
@@ -2019,6 +2275,7 @@ namespace dtCore
          return NULL;
       }
 
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mImpl->mMutex);
       std::map<std::string, dtCore::RefPtr<Map> >::iterator i = mImpl->mOpenMaps.begin();
       for (; i != mImpl->mOpenMaps.end(); ++i)
       {
@@ -2141,13 +2398,19 @@ namespace dtCore
 
       dtUtil::FileInfo resultInfo;
 
-      std::vector<std::string>::const_iterator i, iend;
-      i = mImpl->mContexts.begin();
-      iend = mImpl->mContexts.end();
-      for (; i != iend && ftype != expectedType; ++i)
+      for (unsigned i = 0; i < mImpl->mContexts.size() && ftype != expectedType; ++i)
       {
-         resultInfo = fileUtils.GetFileInfo(*i + dtUtil::FileUtils::PATH_SEPARATOR + path, true);
-         ftype = resultInfo.fileType;
+         // The index answers most lookups with a single stat, but it leaves paths
+         // it can't handle, such as those into archives, to FileUtils.
+         if (mImpl->mContextIndexes[i]->Find(path, resultInfo.fileName, resultInfo.fileType))
+         {
+            ftype = resultInfo.fileType;
+         }
+         else
+         {
+            resultInfo = fileUtils.GetFileInfo(mImpl->mContexts[i] + dtUtil::FileUtils::PATH_SEPARATOR + path, true);
+            ftype = resultInfo.fileType;
+         }
 
          if (ftype == dtUtil::DIRECTORY)
          {
@@ -2361,6 +2624,9 @@ namespace dtCore
 
       result = mImpl->mResourceHelper.AddResource(newName, pathToFile, category, type, dataTypeTree, slot);
 
+      // The file may have been replaced within the resolution of its modification time.
+      mImpl->ErasePrefabFromCache(result);
+
       return result;
    }
 
@@ -2398,6 +2664,8 @@ namespace dtCore
 
          mImpl->mResourceHelper.RemoveResource(resource, resourceTree);
       }
+
+      mImpl->ErasePrefabFromCache(resource);
    }
 
    //////////////////////////////////////////////////////////
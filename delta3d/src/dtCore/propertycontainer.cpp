@@ -277,18 +277,39 @@ namespace dtCore
    ///////////////////////////////////////////////////////////////////////////////////////
    void PropertyContainer::CopyPropertiesFrom(const PropertyContainer& copyFrom, bool copyMetadata)
    {
-      //Now copy all of the properties from this proxy to the clone.
+      // Containers of the same type add their properties in the same order, so try the property at the same
+      // index first and only fall back to the by name lookup if it isn't the one, e.g. when the types differ
+      // or a property was added or removed on just one of them.  The names are interned, so comparing the
+      // string pointers is usually enough.
+      const PropertyVectorType& fromProperties = copyFrom.mProperties;
       for (size_t i = 0; i < mProperties.size(); ++i)
       {
-         const ActorProperty* prop = copyFrom.GetProperty(mProperties[i]->GetName());
+         ActorProperty& toProp = *mProperties[i];
+         const dtUtil::RefString& name = toProp.GetName();
+
+         const ActorProperty* prop = nullptr;
+         if (i < fromProperties.size())
+         {
+            const dtUtil::RefString& fromName = fromProperties[i]->GetName();
+            if (&fromName.Get() == &name.Get() || fromName == name)
+            {
+               prop = fromProperties[i].get();
+            }
+         }
+
+         if (prop == nullptr)
+         {
+            prop = copyFrom.GetProperty(name);
+         }
+
          if (prop != nullptr)
          {
             if (!prop->IsReadOnly())
             {
-               mProperties[i]->CopyFrom(*prop);
+               toProp.CopyFrom(*prop);
             }
             if (copyMetadata)
-               mProperties[i]->CopyMetadata(*prop);
+               toProp.CopyMetadata(*prop);
          }
       }
    }
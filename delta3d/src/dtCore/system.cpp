@@ -6,6 +6,7 @@
 #include <dtCore/system.h>
 #include <dtUtil/log.h>
 #include <dtUtil/bits.h>
+#include <dtUtil/frameprofiler.h>
 #include <dtUtil/mswinmacros.h>
 #include <dtCore/deltawin.h>
 
@@ -522,6 +523,8 @@ namespace dtCore
    ///private
    void SystemImpl::SystemStep(float realDeltaOverride)
    {
+      DT_PROFILE_BEGIN_FRAME();
+
       double realDT = realDeltaOverride;
       if (realDeltaOverride < FLT_EPSILON)
       {
@@ -577,6 +580,8 @@ namespace dtCore
       }
 
       FinishFrameStats();
+
+      DT_PROFILE_END_FRAME();
    }
 
    ////////////////////////////////////////////////////////////////////////////////
@@ -676,6 +681,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_EVENT_TRAVERSAL))
       {
          StartStatTimer();
+         DT_PROFILE_ZONE(System::MESSAGE_EVENT_TRAVERSAL.c_str());
 
          System::GetInstance().TickSignal.emit_signal(System::MESSAGE_EVENT_TRAVERSAL, deltaSimTime, deltaRealTime);
 
@@ -689,6 +695,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_POST_EVENT_TRAVERSAL))
       {
          StartStatTimer();
+         DT_PROFILE_ZONE(System::MESSAGE_POST_EVENT_TRAVERSAL.c_str());
 
          System::GetInstance().TickSignal.emit_signal(System::MESSAGE_POST_EVENT_TRAVERSAL, deltaSimTime, deltaRealTime);
 
@@ -702,6 +709,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_PREFRAME))
       {
          StartStatTimer();
+         DT_PROFILE_ZONE(System::MESSAGE_PRE_FRAME.c_str());
 
          System::GetInstance().TickSignal.emit_signal(System::MESSAGE_PRE_FRAME, deltaSimTime, deltaRealTime);
 
@@ -715,6 +723,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_FRAME_SYNCH))
       {
          StartStatTimer();
+         DT_PROFILE_ZONE(System::MESSAGE_FRAME_SYNCH.c_str());
 
          System::GetInstance().TickSignal.emit_signal(System::MESSAGE_FRAME_SYNCH, deltaSimTime, deltaRealTime);
 
@@ -728,6 +737,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_CAMERA_SYNCH))
       {
          StartStatTimer();
+         DT_PROFILE_ZONE(System::MESSAGE_CAMERA_SYNCH.c_str());
 
          System::GetInstance().TickSignal.emit_signal(System::MESSAGE_CAMERA_SYNCH, deltaSimTime, deltaRealTime);
 
@@ -741,6 +751,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_FRAME))
       {
          StartStatTimer();
+         DT_PROFILE_ZONE(System::MESSAGE_FRAME.c_str());
 
          System::GetInstance().TickSignal.emit_signal(System::MESSAGE_FRAME, deltaSimTime, deltaRealTime);
 
@@ -754,6 +765,7 @@ namespace dtCore
       if (dtUtil::Bits::Has(mSystemStages, System::STAGE_POSTFRAME))
       {
          StartStatTimer();
+         DT_PROFILE_ZONE(System::MESSAGE_POST_FRAME.c_str());
 
          System::GetInstance().TickSignal.emit_signal(System::MESSAGE_POST_FRAME, deltaSimTime, deltaRealTime);
 
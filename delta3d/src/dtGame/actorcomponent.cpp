@@ -25,11 +25,14 @@
 #include <dtGame/actorcomponent.h>
 #include <dtGame/gameactor.h>
 #include <dtGame/gameactorproxy.h>
+#include <dtGame/gamemanager.h>
 #include <dtGame/invokable.h>
 #include <dtGame/messagetype.h>
 #include <dtGame/message.h>
 #include <dtGame/basemessages.h> //for TickMessage
 #include <dtUtil/log.h>
+
+#include <climits>
 #include <stdexcept>
 
 namespace dtGame
@@ -45,7 +48,10 @@ ActorComponent::ActorComponent(ActorComponent::ACType type)
   : mOwner(NULL)
   , mType(type)
   , mInitialized(false)
+  , mTickRegistration(TICK_NOT_REGISTERED)
+  , mParallelTickIndex(UINT_MAX)
   , mIsInGM(false)
+  , mParallelTick(false)
 {
 }
 
@@ -93,6 +99,27 @@ void ActorComponent::RegisterForTick()
    if (owner == NULL) // This should probably be an error log
       return;
 
+   // Registering again may be for a different tick if ParallelTick or the owner's remote state changed.
+   if (mTickRegistration != TICK_NOT_REGISTERED)
+   {
+      UnregisterForTick();
+   }
+
+   if (mParallelTick)
+   {
+      if (owner->IsInGM())
+      {
+         owner->GetGameManager()->RegisterForParallelTick(*this, owner->IsRemote());
+         mTickRegistration = owner->IsRemote() ? TICK_PARALLEL_REMOTE : TICK_PARALLEL_LOCAL;
+      }
+      else
+      {
+         LOG_ERROR("Could not register actor component \"" + GetType()->GetFullName() +
+                  "\" for parallel tick because the owner is not in the Game Manager yet.");
+      }
+      return;
+   }
+
    if (!owner->IsRemote())
    {
       std::string tickInvokable = INVOKABLE_PREFIX_TICK_LOCAL.Get() + GetType()->GetFullName();
@@ -101,6 +128,7 @@ void ActorComponent::RegisterForTick()
          owner->AddInvokable(*new Invokable(tickInvokable, dtUtil::MakeFunctor(&ActorComponent::OnTickLocal, this)));
       }
       owner->RegisterForMessages(MessageType::TICK_LOCAL, tickInvokable);
+      mTickRegistration = TICK_INVOKABLE_LOCAL;
    }
    else
    {
@@ -110,6 +138,7 @@ void ActorComponent::RegisterForTick()
          owner->AddInvokable(*new Invokable(tickInvokable, dtUtil::MakeFunctor(&ActorComponent::OnTickRemote, this)));
       }
       owner->RegisterForMessages(MessageType::TICK_REMOTE, tickInvokable);
+      mTickRegistration = TICK_INVOKABLE_REMOTE;
    }
  }
 
@@ -122,7 +151,20 @@ void ActorComponent::UnregisterForTick()
    if (owner == NULL)
       return;
 
-   if (!owner->IsRemote())
+   TickRegistration registration = mTickRegistration;
+   mTickRegistration = TICK_NOT_REGISTERED;
+
+   if (registration == TICK_PARALLEL_LOCAL || registration == TICK_PARALLEL_REMOTE)
+   {
+      if (owner->GetGameManager() != NULL)
+      {
+         owner->GetGameManager()->UnregisterForParallelTick(*this, registration == TICK_PARALLEL_REMOTE);
+      }
+      return;
+   }
+
+   bool remote = registration == TICK_NOT_REGISTERED ? owner->IsRemote() : registration == TICK_INVOKABLE_REMOTE;
+   if (!remote)
    {
       std::string tickInvokable = INVOKABLE_PREFIX_TICK_LOCAL.Get() + GetType()->GetFullName();
       owner->UnregisterForMessages(MessageType::TICK_LOCAL, tickInvokable);
@@ -144,4 +186,7 @@ void ActorComponent::UnregisterForTick()
 
 //////////////////////////////////////////////////////////////////////////
 DT_IMPLEMENT_ACCESSOR(ActorComponent, bool, IsInGM);
+
+//////////////////////////////////////////////////////////////////////////
+DT_IMPLEMENT_ACCESSOR(ActorComponent, bool, ParallelTick);
 }
@@ -119,6 +119,12 @@ namespace dtGame
       return mUpdateParameters->GetParameter(name);
    }
 
+   /////////////////////////////////////////////////////////////////
+   bool ActorUpdateMessage::RemoveUpdateParameter(const std::string& name)
+   {
+      return mUpdateParameters->RemoveParameter(name).valid();
+   }
+
    /////////////////////////////////////////////////////////////////
    void ActorUpdateMessage::GetUpdateParameters(std::vector<MessageParameter*>& toFill)
    {
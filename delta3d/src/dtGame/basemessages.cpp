@@ -146,6 +146,13 @@ namespace dtGame
       DT_ADD_PARAMETER(std::string, RejectionMessage)
    DT_IMPLEMENT_MESSAGE_END()
 
+   DT_IMPLEMENT_MESSAGE_BEGIN(ClientInterestRegionMessage)
+      DT_ADD_PARAMETER(osg::Vec3, Position)
+      DT_ADD_PARAMETER_WITH_DEFAULT(float, Radius, 0.0f)
+      DT_ADD_PARAMETER(osg::Vec3, ViewDirection)
+      DT_ADD_PARAMETER_WITH_DEFAULT(float, ViewHalfAngle, 180.0f)
+   DT_IMPLEMENT_MESSAGE_END()
+
    //////////////////////////////////////////////////////////////////////////////
    //////////////////////////////////////////////////////////////////////////////
 
@@ -45,11 +45,27 @@ namespace dtGame
          dtGame::GMComponent::BaseGMComponentType));
    const std::string DeadReckoningComponent::DEFAULT_NAME(TYPE->GetName());
 
+   //////////////////////////////////////////////////////////////////////
+   IMPLEMENT_ENUM(DeadReckoningComponent::UpdateTier);
+   DeadReckoningComponent::UpdateTier DeadReckoningComponent::UpdateTier::FULL("FULL");
+   DeadReckoningComponent::UpdateTier DeadReckoningComponent::UpdateTier::REDUCED("REDUCED");
+   DeadReckoningComponent::UpdateTier DeadReckoningComponent::UpdateTier::MINIMAL("MINIMAL");
+
    //////////////////////////////////////////////////////////////////////
    DeadReckoningComponent::DeadReckoningComponent(dtCore::SystemComponentType& type)
       : dtGame::GMComponent(type)
       , mGroundClamper(new DefaultGroundClamper)
       , mArticSmoothTime(0.5f)
+      , mUpdateTiersEnabled(false)
+      , mFullTierDistance(500.0f)
+      , mReducedTierDistance(3000.0f)
+      , mReducedTierFrameInterval(4U)
+      , mMinimalTierFrameInterval(0U)
+      , mTierAssignmentsPerFrame(256U)
+      , mFrameCount(0U)
+      , mNextPhase(0U)
+      , mNumActorsUpdatedLastFrame(0U)
+      , mNextTierAssignmentId(false)
    {
       mLogger = &dtUtil::Log::GetInstance("deadreckoningcomponent.cpp");
    }
@@ -146,6 +162,97 @@ namespace dtGame
       return *mGroundClamper;
    }
 
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::SetUpdateTiersEnabled(bool enabled)
+   {
+      mUpdateTiersEnabled = enabled;
+      if (!mUpdateTiersEnabled)
+      {
+         RegisteredActorMap::iterator i, iend;
+         for (i = mRegisteredActors.begin(), iend = mRegisteredActors.end(); i != iend; ++i)
+         {
+            i->second.mTier = &UpdateTier::FULL;
+         }
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   bool DeadReckoningComponent::GetUpdateTiersEnabled() const
+   {
+      return mUpdateTiersEnabled;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::SetFullTierDistance(float distance)
+   {
+      mFullTierDistance = distance;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   float DeadReckoningComponent::GetFullTierDistance() const
+   {
+      return mFullTierDistance;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::SetReducedTierDistance(float distance)
+   {
+      mReducedTierDistance = distance;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   float DeadReckoningComponent::GetReducedTierDistance() const
+   {
+      return mReducedTierDistance;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::SetReducedTierFrameInterval(unsigned frames)
+   {
+      mReducedTierFrameInterval = std::max(frames, 1U);
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   unsigned DeadReckoningComponent::GetReducedTierFrameInterval() const
+   {
+      return mReducedTierFrameInterval;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::SetMinimalTierFrameInterval(unsigned frames)
+   {
+      mMinimalTierFrameInterval = frames;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   unsigned DeadReckoningComponent::GetMinimalTierFrameInterval() const
+   {
+      return mMinimalTierFrameInterval;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::SetTierAssignmentsPerFrame(unsigned count)
+   {
+      mTierAssignmentsPerFrame = std::max(count, 1U);
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   unsigned DeadReckoningComponent::GetTierAssignmentsPerFrame() const
+   {
+      return mTierAssignmentsPerFrame;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   const DeadReckoningComponent::UpdateTier& DeadReckoningComponent::GetActorUpdateTier(const dtGame::GameActorProxy& gameActorProxy) const
+   {
+      RegisteredActorMap::const_iterator itor = mRegisteredActors.find(gameActorProxy.GetId());
+      if (itor == mRegisteredActors.end())
+      {
+         return UpdateTier::FULL;
+      }
+      return *itor->second.mTier;
+   }
+
    //////////////////////////////////////////////////////////////////////
    void DeadReckoningComponent::RegisterActor(dtGame::GameActorProxy& toRegister, DeadReckoningActorComponent& helper)
    {
@@ -172,7 +279,7 @@ namespace dtGame
          }
       }
 
-      if (!mRegisteredActors.insert(std::make_pair(toRegister.GetId(), &helper)).second)
+      if (!mRegisteredActors.insert(std::make_pair(toRegister.GetId(), RegisteredActorData(helper, mNextPhase++))).second)
       {
          throw dtGame::DeadReckoningException(
             "Actor \"" + toRegister.GetName() +
@@ -220,7 +327,7 @@ namespace dtGame
    //////////////////////////////////////////////////////////////////////
    void DeadReckoningComponent::UnregisterActor(dtGame::GameActorProxy& toRegister)
    {
-      std::map<dtCore::UniqueId, dtCore::RefPtr<DeadReckoningActorComponent> >::iterator itor;
+      RegisteredActorMap::iterator itor;
       itor = mRegisteredActors.find(toRegister.GetId());
       if (itor != mRegisteredActors.end())
       {
@@ -231,7 +338,7 @@ namespace dtGame
    //////////////////////////////////////////////////////////////////////
    bool DeadReckoningComponent::IsRegisteredActor(dtGame::GameActorProxy& gameActorProxy)
    {
-      std::map<dtCore::UniqueId, dtCore::RefPtr<DeadReckoningActorComponent> >::iterator itor;
+      RegisteredActorMap::iterator itor;
       itor = mRegisteredActors.find(gameActorProxy.GetId());
       return itor != mRegisteredActors.end();
    }
@@ -241,9 +348,36 @@ namespace dtGame
    {
       mGroundClamper->UpdateEyePoint();
 
-      for (std::map<dtCore::UniqueId, dtCore::RefPtr<DeadReckoningActorComponent> >::iterator i = mRegisteredActors.begin();
+      ++mFrameCount;
+      mNumActorsUpdatedLastFrame = 0U;
+
+      const bool useTiers = mUpdateTiersEnabled && mGroundClamper->GetEyePointActor() != NULL;
+      if (useTiers)
+      {
+         AssignUpdateTiers();
+      }
+
+      for (RegisteredActorMap::iterator i = mRegisteredActors.begin();
          i != mRegisteredActors.end(); ++i)
       {
+         RegisteredActorData& data = i->second;
+         DeadReckoningActorComponent& helper = *data.mHelper;
+
+         // Get the current time delta.  Actors that were skipped on earlier frames catch up
+         // on all the time that passed unless an update just arrived, in which case the helper
+         // resets its elapsed time anyway.
+         float simTimeDelta = tickMessage.GetDeltaSimTime();
+         data.mSkippedSimTime += simTimeDelta;
+         if (useTiers && !IsUpdateDue(data))
+         {
+            continue;
+         }
+
+         if (!helper.IsUpdated())
+         {
+            simTimeDelta = data.mSkippedSimTime;
+         }
+         data.mSkippedSimTime = 0.0f;
 
          dtGame::GameActorProxy* actor = GetGameManager()->FindGameActorById(i->first);
          if (actor == NULL)
@@ -253,7 +387,7 @@ namespace dtGame
 
          dtCore::Transformable* drawable = NULL;
          actor->GetDrawable(drawable);
-         DeadReckoningActorComponent& helper = *i->second;
+         ++mNumActorsUpdatedLastFrame;
 
          if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
          {
@@ -269,8 +403,6 @@ namespace dtGame
          xform.SetTranslation(helper.GetCurrentDeadReckonedTranslation());
          xform.SetRotation(helper.GetCurrentDeadReckonedRotation());
 
-         // Get the current time delta.
-         float simTimeDelta = tickMessage.GetDeltaSimTime();
          helper.IncrementTimeSinceUpdate(simTimeDelta, tickMessage.GetSimulationTime());
 
 
@@ -278,6 +410,13 @@ namespace dtGame
          BaseGroundClamper::GroundClampRangeType* groundClampingType = &BaseGroundClamper::GroundClampRangeType::NONE;
          bool transformChanged = helper.DoDR(*drawable, xform, mLogger, groundClampingType);
 
+         // Far away actors don't need a full clamp, so keep their offset from the last one.
+         if (*data.mTier == UpdateTier::MINIMAL
+               && *groundClampingType == BaseGroundClamper::GroundClampRangeType::RANGED)
+         {
+            groundClampingType = &BaseGroundClamper::GroundClampRangeType::INTERMITTENT_SAVE_OFFSET;
+         }
+
          if (helper.GetDeadReckoningAlgorithm() != DeadReckoningAlgorithm::NONE)
          {
             // Only ground clamp and move remote objects.
@@ -303,7 +442,7 @@ namespace dtGame
                }
             }
 
-            DoArticulation(helper, *drawable, tickMessage);
+            DoArticulation(helper, *drawable, simTimeDelta);
          }
          // Clear the updated flag.
          helper.ClearUpdated();
@@ -313,9 +452,87 @@ namespace dtGame
       mGroundClamper->FinishUp();
    }
 
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::AssignUpdateTiers()
+   {
+      if (mRegisteredActors.empty())
+      {
+         return;
+      }
+
+      const osg::Vec3& eyePoint = mGroundClamper->GetLastEyePoint();
+      RegisteredActorMap::iterator i = mRegisteredActors.lower_bound(mNextTierAssignmentId);
+      unsigned count = std::min(mTierAssignmentsPerFrame, unsigned(mRegisteredActors.size()));
+      for (unsigned n = 0; n < count; ++n)
+      {
+         if (i == mRegisteredActors.end())
+         {
+            i = mRegisteredActors.begin();
+         }
+
+         // Local actors are needed every frame to decide when to publish.
+         RegisteredActorData& data = i->second;
+         dtGame::GameActorProxy* actor = GetGameManager()->FindGameActorById(i->first);
+         if (actor != NULL && actor->IsRemote() && data.mHelper->GetEffectiveUpdateMode(true)
+               == DeadReckoningActorComponent::UpdateMode::CALCULATE_AND_MOVE_ACTOR)
+         {
+            data.mTier = &CalculateUpdateTier(*data.mHelper, eyePoint);
+         }
+         else
+         {
+            data.mTier = &UpdateTier::FULL;
+         }
+         ++i;
+      }
+
+      if (i == mRegisteredActors.end())
+      {
+         i = mRegisteredActors.begin();
+      }
+      mNextTierAssignmentId = i->first;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   DeadReckoningComponent::UpdateTier& DeadReckoningComponent::CalculateUpdateTier(
+            const dtGame::DeadReckoningActorComponent& helper, const osg::Vec3& eyePoint) const
+   {
+      float distance2 = (helper.GetCurrentDeadReckonedTranslation() - eyePoint).length2();
+      if (distance2 <= mFullTierDistance * mFullTierDistance)
+      {
+         return UpdateTier::FULL;
+      }
+      else if (distance2 <= mReducedTierDistance * mReducedTierDistance)
+      {
+         return UpdateTier::REDUCED;
+      }
+      return UpdateTier::MINIMAL;
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   bool DeadReckoningComponent::IsUpdateDue(const RegisteredActorData& data) const
+   {
+      // An update always gets applied right away.
+      if (*data.mTier == UpdateTier::FULL || data.mHelper->IsUpdated())
+      {
+         return true;
+      }
+
+      unsigned interval = (*data.mTier == UpdateTier::REDUCED) ? mReducedTierFrameInterval : mMinimalTierFrameInterval;
+      return interval > 0U && (mFrameCount + data.mPhase) % interval == 0U;
+   }
+
+   //////////////////////////////////////////////////////////////////////
    void DeadReckoningComponent::DoArticulation(dtGame::DeadReckoningActorComponent& helper,
                                                const dtCore::Transformable& xformable,
                                                const dtGame::TickMessage& tickMessage) const
+   {
+      DoArticulation(helper, xformable, tickMessage.GetDeltaSimTime());
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DoArticulation(dtGame::DeadReckoningActorComponent& helper,
+                                               const dtCore::Transformable& xformable,
+                                               float simTimeDelta) const
    {
       if(helper.GetNodeCollector() == NULL)
       {
@@ -366,7 +583,7 @@ namespace dtGame
          // stops will be used as blending targets.
          if(currentDOF->mPrev == NULL && !currentDOF->mUpdate)
          {
-            currentDOF->mCurrentTime += tickMessage.GetDeltaSimTime();
+            currentDOF->mCurrentTime += simTimeDelta;
             currentDOF->mUpdate = true;
 
             // Smooth time has completed, and this has more in its chain
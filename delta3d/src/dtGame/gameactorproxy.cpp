@@ -26,8 +26,11 @@
 #include <dtCore/actoridactorproperty.h>
 #include <dtCore/actortype.h>
 #include <dtCore/booleanactorproperty.h>
+#include <dtCore/doubleactorproperty.h>
 #include <dtCore/enumactorproperty.h>
+#include <dtCore/floatactorproperty.h>
 #include <dtCore/stringactorproperty.h>
+#include <dtCore/vectoractorproperties.h>
 #include <dtGame/environmentactor.h>
 
 #include <dtGame/actorcomponent.h>
@@ -46,6 +49,9 @@
 #include <dtUtil/functor.h>
 #include <dtUtil/log.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace dtGame
 {
 
@@ -85,6 +91,17 @@ namespace dtGame
    GameActorProxy::LocalActorUpdatePolicy GameActorProxy::LocalActorUpdatePolicy::ACCEPT_ALL("ACCEPT_ALL");
    GameActorProxy::LocalActorUpdatePolicy GameActorProxy::LocalActorUpdatePolicy::ACCEPT_WITH_PROPERTY_FILTER("ACCEPT_WITH_PROPERTY_FILTER");
 
+   IMPLEMENT_ENUM(GameActorProxy::PropertyPublishPolicy);
+
+   GameActorProxy::PropertyPublishPolicy::PropertyPublishPolicy(const std::string& name)
+   : dtUtil::Enumeration(name)
+   {
+      AddInstance(this);
+   }
+
+   GameActorProxy::PropertyPublishPolicy GameActorProxy::PropertyPublishPolicy::MANUAL("MANUAL");
+   GameActorProxy::PropertyPublishPolicy GameActorProxy::PropertyPublishPolicy::DIRTY_PROPERTIES("DIRTY_PROPERTIES");
+
 
 
    /////////////////////////////////////////////////////////////////////////////
@@ -130,12 +147,14 @@ namespace dtGame
    , mParent(nullptr)
    , mOwnership(&GameActorProxy::Ownership::SERVER_LOCAL)
    , mLocalActorUpdatePolicy(&GameActorProxy::LocalActorUpdatePolicy::ACCEPT_ALL)
+   , mPropertyPublishPolicy(&GameActorProxy::PropertyPublishPolicy::MANUAL)
    , mLogger(dtUtil::Log::GetInstance("gameactor.cpp"))
    , mIsInGM(false)
    , mPublished(false)
    , mRemote(false)
    , mDrawableIsAGameActor(true) // It defaults to true so it will try to do the cast early in the init.
    , mDeleted(false)
+   , mInDirtyPublishList(false)
    {
       // Set the Tree base class value member.
       value = this;
@@ -625,6 +644,12 @@ namespace dtGame
 
       PopulateActorUpdate(*message);
       GetGameManager()->SendMessage(*updateMsg);
+
+      // Everything just went out, so there is nothing left to publish at the end of the tick.
+      if (*mPropertyPublishPolicy == PropertyPublishPolicy::DIRTY_PROPERTIES)
+      {
+         ClearDirtyProperties();
+      }
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -1005,6 +1030,189 @@ namespace dtGame
       mLocalActorUpdatePolicy = &newPolicy;
    }
 
+   /////////////////////////////////////////////////////////////////////////////////////////////////////////
+   GameActorProxy::PropertyPublishPolicy& GameActorProxy::GetPropertyPublishPolicy() const
+   {
+      return *mPropertyPublishPolicy;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////////////////////////////
+   void GameActorProxy::SetPropertyPublishPolicy(GameActorProxy::PropertyPublishPolicy& newPolicy)
+   {
+      mPropertyPublishPolicy = &newPolicy;
+      ClearDirtyProperties();
+      RegisterForDirtyPropertyPublishing();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////////////////////////////
+   void GameActorProxy::RegisterForDirtyPropertyPublishing()
+   {
+      if (*mPropertyPublishPolicy == PropertyPublishPolicy::DIRTY_PROPERTIES && GetGameManager() != nullptr
+               && IsInGM() && !IsRemote())
+      {
+         GetGameManager()->RegisterForDirtyPropertyPublishing(*this);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////////////////////////////
+   // Reads the float, double, and vector types into a Vec4d so the thresholds can treat them all the same way.
+   static bool GetThresholdValue(const dtCore::ActorProperty& prop, osg::Vec4d& result)
+   {
+      const dtCore::DataType& type = prop.GetDataType();
+      if (type == dtCore::DataType::FLOAT)
+      {
+         result.set(static_cast<const dtCore::FloatActorProperty&>(prop).GetValue(), 0.0, 0.0, 0.0);
+      }
+      else if (type == dtCore::DataType::DOUBLE)
+      {
+         result.set(static_cast<const dtCore::DoubleActorProperty&>(prop).GetValue(), 0.0, 0.0, 0.0);
+      }
+      else if (type == dtCore::DataType::VEC2F)
+      {
+         osg::Vec2f value = static_cast<const dtCore::Vec2fActorProperty&>(prop).GetValue();
+         result.set(value.x(), value.y(), 0.0, 0.0);
+      }
+      else if (type == dtCore::DataType::VEC2D)
+      {
+         osg::Vec2d value = static_cast<const dtCore::Vec2dActorProperty&>(prop).GetValue();
+         result.set(value.x(), value.y(), 0.0, 0.0);
+      }
+      else if (type == dtCore::DataType::VEC3F)
+      {
+         osg::Vec3f value = static_cast<const dtCore::Vec3fActorProperty&>(prop).GetValue();
+         result.set(value.x(), value.y(), value.z(), 0.0);
+      }
+      else if (type == dtCore::DataType::VEC3D)
+      {
+         osg::Vec3d value = static_cast<const dtCore::Vec3dActorProperty&>(prop).GetValue();
+         result.set(value.x(), value.y(), value.z(), 0.0);
+      }
+      else if (type == dtCore::DataType::VEC4F)
+      {
+         result = static_cast<const dtCore::Vec4fActorProperty&>(prop).GetValue();
+      }
+      else if (type == dtCore::DataType::VEC4D)
+      {
+         result = static_cast<const dtCore::Vec4dActorProperty&>(prop).GetValue();
+      }
+      else
+      {
+         return false;
+      }
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////////////////////////////
+   void GameActorProxy::SetPropertyPublishThreshold(const dtUtil::RefString& propName, float epsilon)
+   {
+      PublishThreshold& threshold = mPublishThresholds[propName];
+      threshold.mEpsilon = epsilon;
+
+      const dtCore::ActorProperty* prop = GetProperty(propName);
+      if (prop != nullptr)
+      {
+         GetThresholdValue(*prop, threshold.mLastPublished);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////////////////////////////
+   float GameActorProxy::GetPropertyPublishThreshold(const dtUtil::RefString& propName) const
+   {
+      std::map<dtUtil::RefString, PublishThreshold>::const_iterator found = mPublishThresholds.find(propName);
+      if (found != mPublishThresholds.end())
+      {
+         return found->second.mEpsilon;
+      }
+      return 0.0f;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////////////////////////////
+   void GameActorProxy::MarkPropertyDirty(const dtUtil::RefString& propName)
+   {
+      dtCore::ActorProperty* prop = GetProperty(propName);
+      if (prop != nullptr)
+      {
+         prop->SetDirty(true);
+      }
+      else
+      {
+         mLogger.LogMessage(dtUtil::Log::LOG_WARNING, __FUNCTION__, __LINE__,
+               "Property \"%s\" was not found on actor type \"%s\", so it can't be marked dirty.",
+               propName.c_str(), GetActorType().GetFullName().c_str());
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////////////////////////////
+   void GameActorProxy::ClearDirtyProperties()
+   {
+      ForEachProperty([](dtCore::RefPtr<dtCore::ActorProperty>& prop)
+            {
+               prop->SetDirty(false);
+            });
+
+      std::map<dtUtil::RefString, PublishThreshold>::iterator i, iend;
+      i = mPublishThresholds.begin();
+      iend = mPublishThresholds.end();
+      for (; i != iend; ++i)
+      {
+         const dtCore::ActorProperty* prop = GetProperty(i->first);
+         if (prop != nullptr)
+         {
+            GetThresholdValue(*prop, i->second.mLastPublished);
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////////////////////////////
+   bool GameActorProxy::PublishDirtyProperties()
+   {
+      if (GetGameManager() == nullptr || IsRemote())
+      {
+         return false;
+      }
+
+      std::vector<dtUtil::RefString> propNames;
+      ForEachProperty([&](dtCore::RefPtr<dtCore::ActorProperty>& prop)
+            {
+               if (!prop->IsDirty())
+               {
+                  return;
+               }
+               prop->SetDirty(false);
+
+               if (prop->IsReadOnly() || !prop->GetSendInFullUpdate())
+               {
+                  return;
+               }
+
+               std::map<dtUtil::RefString, PublishThreshold>::iterator found = mPublishThresholds.find(prop->GetName());
+               osg::Vec4d value;
+               if (found != mPublishThresholds.end() && GetThresholdValue(*prop, value))
+               {
+                  PublishThreshold& threshold = found->second;
+                  osg::Vec4d delta = value - threshold.mLastPublished;
+                  double maxDelta = std::max(std::max(std::abs(delta.x()), std::abs(delta.y())),
+                           std::max(std::abs(delta.z()), std::abs(delta.w())));
+                  // Small changes are compared against the last value sent, so they add up until one goes out.
+                  if (maxDelta <= double(threshold.mEpsilon))
+                  {
+                     return;
+                  }
+                  threshold.mLastPublished = value;
+               }
+
+               propNames.push_back(prop->GetName());
+            });
+
+      if (propNames.empty())
+      {
+         return false;
+      }
+
+      NotifyPartialActorUpdate(propNames);
+      return true;
+   }
+
    /////////////////////////////////////////////////////////////////////////////////////////////////////////
    void GameActorProxy::AddInvokable(Invokable& newInvokable)
    {
@@ -1220,6 +1428,13 @@ namespace dtGame
       AddActorComponentProperties();
 
       OnEnteredWorld();
+
+      // The create message has the values set so far, so only later changes should go out.
+      if (*mPropertyPublishPolicy == PropertyPublishPolicy::DIRTY_PROPERTIES)
+      {
+         ClearDirtyProperties();
+         RegisterForDirtyPropertyPublishing();
+      }
    }
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////
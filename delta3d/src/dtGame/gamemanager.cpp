@@ -32,6 +32,7 @@
 #include <dtGame/exceptionenum.h>
 #include <dtGame/gameactor.h>
 
+#include <dtGame/actorcomponent.h>
 #include <dtGame/gmcomponent.h>
 #include <dtGame/invokable.h>
 #include <dtGame/machineinfo.h>
@@ -52,15 +53,76 @@
 #include <dtCore/system.h>
 #include <dtCore/scene.h>
 
+#include <dtUtil/frameprofiler.h>
 #include <dtUtil/stringutils.h>
 #include <dtUtil/log.h>
+#include <dtUtil/threadpool.h>
 
+#include <algorithm>
+#include <climits>
 #include <list>
 
 namespace dtGame
 {
    IMPLEMENT_MANAGEMENT_LAYER(GameManager);
 
+   /// Messages sent from a parallel tick are held here per task, then queued in task order.
+   struct DeferredMessages
+   {
+      std::vector<dtCore::RefPtr<const Message> > mProcess;
+      std::vector<dtCore::RefPtr<const Message> > mNetwork;
+   };
+
+   /// Set only while a worker is running a parallel tick task.
+   static thread_local DeferredMessages* tDeferredMessages = NULL;
+
+   /////////////////////////////////////////////////////////////////////////////
+   class ParallelTickTask : public dtUtil::ThreadPoolTask
+   {
+   public:
+      ParallelTickTask(const TickMessage& tick, bool remote)
+      : mTick(&tick)
+      , mRemote(remote)
+      {
+         SetName("ParallelTickTask");
+      }
+
+      void operator()() override
+      {
+         tDeferredMessages = &mDeferred;
+         std::vector<ActorComponent*>::iterator i, iend;
+         for (i = mComponents.begin(), iend = mComponents.end(); i != iend; ++i)
+         {
+            try
+            {
+               if (mRemote)
+               {
+                  (*i)->OnTickRemote(*mTick);
+               }
+               else
+               {
+                  (*i)->OnTickLocal(*mTick);
+               }
+            }
+            catch (const dtUtil::Exception& ex)
+            {
+               ex.LogException(dtUtil::Log::LOG_ERROR);
+            }
+         }
+         tDeferredMessages = NULL;
+      }
+
+      std::vector<ActorComponent*> mComponents;
+      DeferredMessages mDeferred;
+
+   protected:
+      ~ParallelTickTask() override {}
+
+   private:
+      dtCore::RefPtr<const TickMessage> mTick;
+      bool mRemote;
+   };
+
    const std::string GameManager::CONFIG_STATISTICS_INTERVAL("GameManager.Statistics.Interval");
    const std::string GameManager::CONFIG_STATISTICS_TO_CONSOLE("GameManager.Statistics.ToConsole");
    const std::string GameManager::CONFIG_STATISTICS_OUTPUT_FILE("GameManager.Statistics.OutputFile");
@@ -301,12 +363,22 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::SendNetworkMessage(const Message& message)
    {
+      if (tDeferredMessages != NULL)
+      {
+         tDeferredMessages->mNetwork.push_back(&message);
+         return;
+      }
       mGMImpl->mSendNetworkMessageQueue.push(dtCore::RefPtr<const Message>(&message));
    }
 
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::SendMessage(const Message& message)
    {
+      if (tDeferredMessages != NULL)
+      {
+         tDeferredMessages->mProcess.push_back(&message);
+         return;
+      }
       mGMImpl->mSendMessageQueue.push(dtCore::RefPtr<const Message>(&message));
    }
 
@@ -465,6 +537,7 @@ namespace dtGame
             DoSendMessages();
          }while (!RemoveDeletedActors());
 
+         PublishDirtyActorProperties();
          DoSendMessages();
 
          dtCore::RefPtr<TickMessage> tickEnd;
@@ -556,7 +629,11 @@ namespace dtGame
             continue;
          }
 
-         DoSendMessageToComponents(*mGMImpl->mSendNetworkMessageQueue.front(), true);
+         {
+            const Message& networkMessage = *mGMImpl->mSendNetworkMessageQueue.front();
+            DT_PROFILE_ZONE(networkMessage.GetMessageType().GetName());
+            DoSendMessageToComponents(networkMessage, true);
+         }
          mGMImpl->mSendNetworkMessageQueue.pop();
       }
    }
@@ -569,19 +646,24 @@ namespace dtGame
       dtCore::Timer_t frameTickStartCurrent(0);
       bool isATickLocalMessage = (message.GetMessageType() == MessageType::TICK_LOCAL);
 
-      // Components get messages first
-      GMImpl::GMComponentContainer::iterator compItr = mGMImpl->mComponentList.begin();
-      while (compItr != mGMImpl->mComponentList.end())
+      // Components get messages first.  Only the ones subscribed to this type are in the list, and
+      // the list is held so a component adding or removing components doesn't pull it out from under us.
+      dtCore::RefPtr<ComponentDispatchList> dispatch =
+         &mGMImpl->GetComponentDispatchList(toNetwork ? NULL : &message.GetMessageType());
+
+      std::vector<dtCore::RefPtr<GMComponent> >::const_iterator compItr = dispatch->mComponents.begin();
+      for (; compItr != dispatch->mComponents.end(); ++compItr)
       {
          if (mGMImpl->mShuttingDown)
          {
             throw GMShutdownException();
          }
 
-         if (compItr->valid() == false) //set from a previous call to RemoveComponent()
+         //RefPtr in case it get deleted during a Message. We need to hang onto it for a bit.
+         const dtCore::RefPtr<GMComponent>& component = *compItr;
+
+         if (component->GetGameManager() != this) //removed by an earlier component during this message
          {
-            //Erase this value from the container and move on. Iterator gets pointed to next in container.
-            compItr = mGMImpl->mComponentList.erase(compItr);
             continue;
          }
 
@@ -591,9 +673,6 @@ namespace dtGame
             frameTickStartCurrent = mGMImpl->mGMStatistics.mStatsTickClock.Tick();
          }
 
-         //RefPtr in case it get deleted during a Message. We need to hang onto it for a bit.
-         dtCore::RefPtr<GMComponent>& component = *compItr;
-
          if (mGMImpl->mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
          {
             mGMImpl->mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
@@ -603,6 +682,7 @@ namespace dtGame
 
          try
          {
+            DT_PROFILE_ZONE(component->GetName());
             if (toNetwork)
             {
                component->DispatchNetworkMessage(message);
@@ -636,14 +716,14 @@ namespace dtGame
                                                     component->GetName(),
                                                     frameTickDelta, true, isATickLocalMessage);
          }
-
-         ++compItr;
       }
    }
 
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::DoSendMessage(const Message& message)
    {
+      DT_PROFILE_ZONE(message.GetMessageType().GetName());
+
       DoSendMessageToComponents(message, false);
 
       // The component message sending checks for this internally
@@ -654,6 +734,7 @@ namespace dtGame
       }
 
       InvokeGlobalInvokables(message);
+      InvokeParallelTickComponents(message);
 
       // ABOUT ACTOR - The actor itself and others registered against a particular actor
       if (!message.GetAboutActorId().ToString().empty())
@@ -752,6 +833,7 @@ namespace dtGame
                            listenerActorProxy->GetName() + "\" of Type \"" + listenerActorProxy->GetActorType().GetFullName()
                            + "\"");
                }
+               DT_PROFILE_ZONE(invokable->GetName());
                invokable->Invoke(message);
             }
             catch (const dtUtil::Exception& ex)
@@ -801,6 +883,133 @@ namespace dtGame
       }
    }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::InvokeParallelTickComponents(const Message& message)
+   {
+      const bool remote = message.GetMessageType() == MessageType::TICK_REMOTE;
+      if (!remote && message.GetMessageType() != MessageType::TICK_LOCAL)
+      {
+         return;
+      }
+
+      GMImpl::ParallelTickList& tickList = remote ? mGMImpl->mParallelTickRemote : mGMImpl->mParallelTickLocal;
+      if (tickList.empty())
+      {
+         return;
+      }
+
+      // Drop the deleted components and the ones whose actor has left the GM, keeping the order.
+      std::vector<ActorComponent*> components;
+      components.reserve(tickList.size());
+      unsigned keep = 0;
+      for (unsigned i = 0; i < tickList.size(); ++i)
+      {
+         ActorComponent* comp = tickList[i].get();
+         GameActorProxy* owner = NULL;
+         if (comp != NULL)
+         {
+            comp->GetOwner(owner);
+         }
+
+         if (owner == NULL || owner->GetGameManager() != this)
+         {
+            continue;
+         }
+
+         comp->mParallelTickIndex = keep;
+         tickList[keep++] = tickList[i];
+         if (owner->IsInGM() && !owner->IsDeleted())
+         {
+            components.push_back(comp);
+         }
+      }
+      tickList.resize(keep);
+
+      if (components.empty())
+      {
+         return;
+      }
+
+      const TickMessage& tick = static_cast<const TickMessage&>(message);
+
+      // A few tasks per thread evens out components with uneven tick costs.  Waiting on the pool from
+      // one of its own workers could stall it, so that case runs serially.
+      unsigned numTasks = 1U;
+      if (dtUtil::ThreadPool::IsInitialized() && !dtUtil::ThreadPool::IsWorkerThread()
+         && dtUtil::ThreadPool::GetNumImmediateWorkerThreads() > 1U)
+      {
+         const unsigned minPerTask = 64U;
+         numTasks = dtUtil::ThreadPool::GetNumImmediateWorkerThreads() * 4U;
+         numTasks = std::max(1U, std::min(numTasks, unsigned(components.size()) / minPerTask));
+      }
+
+      std::vector<dtCore::RefPtr<ParallelTickTask> > tasks;
+      tasks.reserve(numTasks);
+      const unsigned perTask = (unsigned(components.size()) + numTasks - 1) / numTasks;
+      for (unsigned start = 0; start < components.size(); start += perTask)
+      {
+         unsigned end = std::min(unsigned(components.size()), start + perTask);
+         dtCore::RefPtr<ParallelTickTask> task = new ParallelTickTask(tick, remote);
+         task->mComponents.assign(components.begin() + start, components.begin() + end);
+         tasks.push_back(task);
+      }
+
+      // Only wait on the tick's own tasks, other code may have its own immediate tasks queued.
+      for (unsigned i = 1; i < tasks.size(); ++i)
+      {
+         dtUtil::ThreadPool::AddTask(*tasks[i]);
+      }
+
+      (*tasks[0])();
+
+      for (unsigned i = 1; i < tasks.size(); ++i)
+      {
+         tasks[i]->WaitUntilComplete();
+      }
+
+      // Merge in task order, which is the registration order, so the queue is the same no matter which thread ran what.
+      for (unsigned i = 0; i < tasks.size(); ++i)
+      {
+         DeferredMessages& deferred = tasks[i]->mDeferred;
+         for (unsigned j = 0; j < deferred.mProcess.size(); ++j)
+         {
+            mGMImpl->mSendMessageQueue.push(deferred.mProcess[j]);
+         }
+         for (unsigned j = 0; j < deferred.mNetwork.size(); ++j)
+         {
+            mGMImpl->mSendNetworkMessageQueue.push(deferred.mNetwork[j]);
+         }
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::PublishDirtyActorProperties()
+   {
+      std::vector<dtCore::ObserverPtr<GameActorProxy> >& actors = mGMImpl->mDirtyPublishActors;
+      unsigned keep = 0;
+      for (unsigned i = 0; i < actors.size(); ++i)
+      {
+         dtCore::RefPtr<GameActorProxy> actor = actors[i].get();
+         if (!actor.valid())
+         {
+            continue;
+         }
+         if (actor->GetGameManager() != this || !actor->IsInGM() || actor->IsRemote()
+                  || actor->GetPropertyPublishPolicy() != GameActorProxy::PropertyPublishPolicy::DIRTY_PROPERTIES)
+         {
+            actor->mInDirtyPublishList = false;
+            continue;
+         }
+
+         actors[keep++] = actors[i];
+         if (!actor->IsDeleted())
+         {
+            actor->PublishDirtyProperties();
+         }
+      }
+      actors.resize(keep);
+   }
+
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::InvokeForActorInvokables(const Message& message, GameActorProxy& aboutActor)
    {
@@ -833,6 +1042,7 @@ namespace dtGame
                          aboutActor.GetName() + "\" of Type \"" + aboutActor.GetActorType().GetFullName()
                          + "\"");
             }
+            DT_PROFILE_ZONE((*i)->GetName());
             (*i)->Invoke(message);
          }
          catch (const dtUtil::Exception& ex)
@@ -898,6 +1108,7 @@ namespace dtGame
                             currentProxy.GetName() + "\" of Type \"" + currentProxy.GetActorType().GetFullName()
                             + "\"");
                }
+               DT_PROFILE_ZONE(invokable->GetName());
                invokable->Invoke(message);
             }
             catch (const dtUtil::Exception& ex)
@@ -990,6 +1201,7 @@ namespace dtGame
 
       // we sort the items by priority so that components of higher priority get messages first.
       mGMImpl->mComponentList.sort(CompareComponentPriority);
+      mGMImpl->InvalidateComponentDispatch();
 
       // notify the component that it was added to the GM
       component.OnAddedToGM();
@@ -1006,9 +1218,16 @@ namespace dtGame
          (*found)->OnRemovedFromGM();
          (*found)->SetGameManager(NULL);
          (*found) = NULL; //RefPtr will be erased from the container later on
+         mGMImpl->InvalidateComponentDispatch();
       }
    }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::InvalidateComponentDispatch()
+   {
+      mGMImpl->InvalidateComponentDispatch();
+   }
+
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::GetAllComponents(std::vector<GMComponent*>& toFill)
    {
@@ -1653,8 +1872,8 @@ namespace dtGame
       // Clear all the timers first so the delete actor calls don't have to
       // iterate over the lists a bunch of times.  We have to clear this list anyway
       // to get rid of the timers not related to actors if no one has cleaned them up.
-      mGMImpl->mRealTimeTimers.clear();
-      mGMImpl->mSimulationTimers.clear();
+      mGMImpl->mRealTimeTimers.Clear();
+      mGMImpl->mSimulationTimers.Clear();
 
       while (!mGMImpl->mBaseActorObjectMap.empty())
       {
@@ -1970,6 +2189,18 @@ namespace dtGame
 
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::ChangeMapSet(const GameManager::NameVector& mapNames, bool addBillboards)
+   {
+      InternalChangeMapSet(mapNames, addBillboards, false);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::ChangeMapSetAsync(const GameManager::NameVector& mapNames, bool addBillboards)
+   {
+      InternalChangeMapSet(mapNames, addBillboards, true);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::InternalChangeMapSet(const GameManager::NameVector& mapNames, bool addBillboards, bool async)
    {
       if (mapNames.empty())
       {
@@ -1993,7 +2224,7 @@ namespace dtGame
          throw dtGame::GeneralGameManagerException( changeMessage, __FILE__, __LINE__);
       }
 
-      mGMImpl->mMapChangeStateData->BeginMapChange(mGMImpl->mLoadedMaps, mapNames, addBillboards);
+      mGMImpl->mMapChangeStateData->BeginMapChange(mGMImpl->mLoadedMaps, mapNames, addBillboards, async);
    }
 
 
@@ -2130,7 +2361,7 @@ namespace dtGame
       }
 
       t.repeat = repeat;
-      realTime ? mGMImpl->mRealTimeTimers.insert(t) : mGMImpl->mSimulationTimers.insert(t);
+      realTime ? mGMImpl->mRealTimeTimers.Add(t) : mGMImpl->mSimulationTimers.Add(t);
    }
 
 
@@ -2318,6 +2549,57 @@ namespace dtGame
       }
    }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::RegisterForParallelTick(ActorComponent& component, bool remote)
+   {
+      GMImpl::ParallelTickList& tickList = remote ? mGMImpl->mParallelTickRemote : mGMImpl->mParallelTickLocal;
+      unsigned index = component.mParallelTickIndex;
+      if (index < tickList.size() && tickList[index] == &component)
+      {
+         return;
+      }
+      component.mParallelTickIndex = unsigned(tickList.size());
+      tickList.push_back(&component);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::UnregisterForParallelTick(ActorComponent& component, bool remote)
+   {
+      GMImpl::ParallelTickList& tickList = remote ? mGMImpl->mParallelTickRemote : mGMImpl->mParallelTickLocal;
+      unsigned index = component.mParallelTickIndex;
+      if (index < tickList.size() && tickList[index] == &component)
+      {
+         // Leave a hole so the other indices stay valid.  The next parallel tick compacts the list.
+         tickList[index] = NULL;
+      }
+      component.mParallelTickIndex = UINT_MAX;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   unsigned GameManager::GetNumParallelTickComponents() const
+   {
+      unsigned count = 0;
+      for (unsigned i = 0; i < mGMImpl->mParallelTickLocal.size(); ++i)
+      {
+         count += mGMImpl->mParallelTickLocal[i].valid() ? 1U : 0U;
+      }
+      for (unsigned i = 0; i < mGMImpl->mParallelTickRemote.size(); ++i)
+      {
+         count += mGMImpl->mParallelTickRemote[i].valid() ? 1U : 0U;
+      }
+      return count;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::RegisterForDirtyPropertyPublishing(GameActorProxy& actor)
+   {
+      if (!actor.mInDirtyPublishList)
+      {
+         actor.mInDirtyPublishList = true;
+         mGMImpl->mDirtyPublishActors.push_back(&actor);
+      }
+   }
+
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::RejectMessage(const dtGame::Message& reasonMessage, const std::string& rejectDescription)
    {
@@ -2398,6 +2680,7 @@ namespace dtGame
 
       //now purge the component container for real
       mGMImpl->mComponentList.clear();
+      mGMImpl->InvalidateComponentDispatch();
 
       mGMImpl->mGMStatistics.mDebugLoggerInformation.clear();
 
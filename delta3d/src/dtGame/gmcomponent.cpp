@@ -21,7 +21,9 @@
 #include <prefix/dtgameprefix.h>
 #include <dtGame/gmcomponent.h>
 #include <dtGame/message.h>
+#include <dtGame/messagetype.h>
 #include <dtCore/propertymacros.h>
+#include <algorithm>
 
 namespace dtGame
 {
@@ -74,6 +76,53 @@ namespace dtGame
    {
    }
 
+   //////////////////////////////////////////////
+   void GMComponent::AddMessageSubscription(const MessageType& type)
+   {
+      if (std::find(mMessageSubscriptions.begin(), mMessageSubscriptions.end(), &type) == mMessageSubscriptions.end())
+      {
+         mMessageSubscriptions.push_back(&type);
+         OnMessageSubscriptionsChanged();
+      }
+   }
+
+   //////////////////////////////////////////////
+   void GMComponent::RemoveMessageSubscription(const MessageType& type)
+   {
+      MessageTypeList::iterator found = std::find(mMessageSubscriptions.begin(), mMessageSubscriptions.end(), &type);
+      if (found != mMessageSubscriptions.end())
+      {
+         mMessageSubscriptions.erase(found);
+         OnMessageSubscriptionsChanged();
+      }
+   }
+
+   //////////////////////////////////////////////
+   void GMComponent::ClearMessageSubscriptions()
+   {
+      if (!mMessageSubscriptions.empty())
+      {
+         mMessageSubscriptions.clear();
+         OnMessageSubscriptionsChanged();
+      }
+   }
+
+   //////////////////////////////////////////////
+   bool GMComponent::IsSubscribedTo(const MessageType& type) const
+   {
+      return mMessageSubscriptions.empty() ||
+         std::find(mMessageSubscriptions.begin(), mMessageSubscriptions.end(), &type) != mMessageSubscriptions.end();
+   }
+
+   //////////////////////////////////////////////
+   void GMComponent::OnMessageSubscriptionsChanged()
+   {
+      if (mParent.valid())
+      {
+         mParent->InvalidateComponentDispatch();
+      }
+   }
+
    DT_IMPLEMENT_ACCESSOR(GMComponent, dtUtil::EnumerationPointer<GameManager::ComponentPriority>, ComponentPriority)
 
    //////////////////////////////////////////////
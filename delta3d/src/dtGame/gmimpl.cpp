@@ -26,47 +26,83 @@
 namespace dtGame
 {
 //////////////////////////////////////////////////////////////////////////
-void GMImpl::ClearTimerSingleSet(std::set<TimerInfo> &timerSet,
+void GMImpl::ClearTimerSingleSet(TimerWheel& timers,
                                          const std::string &name,
                                          const GameActorProxy *proxy)
 {
-   std::set<TimerInfo>::iterator i = timerSet.begin();
-   while (i != timerSet.end())
+   if (proxy == NULL)
    {
-      std::set<TimerInfo>::iterator toDelete;
-      const TimerInfo& timer = *i;
-      if (timer.name == name &&  (proxy == NULL || timer.aboutActor == proxy->GetId()))
-      {
-         toDelete = i;
-         ++i;
-         timerSet.erase(toDelete);
-      }
-      else
-      {
-         ++i;
-      }
+      timers.Clear(name, NULL);
+   }
+   else
+   {
+      timers.Clear(name, &proxy->GetId());
    }
 }
 
 //////////////////////////////////////////////////////////////////////////
-void GMImpl::ClearTimersForActor(std::set<TimerInfo>& timerSet, const GameActorProxy& actor)
+void GMImpl::ClearTimersForActor(TimerWheel& timers, const GameActorProxy& actor)
+{
+   timers.ClearForActor(actor.GetId());
+}
+
+//////////////////////////////////////////////////////////////////////////
+ComponentDispatchList& GMImpl::GetComponentDispatchList(const MessageType* type)
 {
-   std::set<TimerInfo>::iterator i = timerSet.begin();
-   while (i != timerSet.end())
+   if (type == NULL && mAllComponentsDispatch.valid())
+   {
+      return *mAllComponentsDispatch;
+   }
+
+   if (type != NULL)
+   {
+      ComponentDispatchMap::iterator found = mComponentDispatch.find(type);
+      if (found != mComponentDispatch.end())
+      {
+         return *found->second;
+      }
+   }
+
+   // Components removed since the last build are only nulled out, so purge them here where
+   // nothing else is walking the list.
+   GMComponentContainer::iterator i = mComponentList.begin();
+   while (i != mComponentList.end())
    {
-      std::set<TimerInfo>::iterator toDelete;
-      const TimerInfo& timer = *i;
-      if (timer.aboutActor == actor.GetId())
+      if (i->valid())
       {
-         toDelete = i;
          ++i;
-         timerSet.erase(toDelete);
       }
       else
       {
-         ++i;
+         i = mComponentList.erase(i);
+      }
+   }
+
+   dtCore::RefPtr<ComponentDispatchList> dispatch = new ComponentDispatchList;
+   for (i = mComponentList.begin(); i != mComponentList.end(); ++i)
+   {
+      if (type == NULL || (*i)->IsSubscribedTo(*type))
+      {
+         dispatch->mComponents.push_back(*i);
       }
    }
+
+   if (type == NULL)
+   {
+      mAllComponentsDispatch = dispatch;
+   }
+   else
+   {
+      mComponentDispatch.insert(std::make_pair(type, dispatch));
+   }
+   return *dispatch;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::InvalidateComponentDispatch()
+{
+   mComponentDispatch.clear();
+   mAllComponentsDispatch = NULL;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -87,43 +123,25 @@ GMImpl::GMImpl(dtCore::Scene& scene) : mGMStatistics()
 
 }
 ////////////////////////////////////////////////////////////////////////////////
-void GMImpl::ProcessTimers(GameManager& gm, std::set<TimerInfo>& listToProcess, dtCore::Timer_t clockTime)
+void GMImpl::ProcessTimers(GameManager& gm, TimerWheel& timersToProcess, dtCore::Timer_t clockTime)
 {
-   std::set<TimerInfo>::iterator itor;
-   std::set<TimerInfo> repeatingTimers;
-   for (itor=listToProcess.begin(); itor!=listToProcess.end();)
-   {
-      if (itor->time <= clockTime)
-      {
-         dtCore::RefPtr<TimerElapsedMessage> timerMsg =
-            static_cast<TimerElapsedMessage*>(mFactory.CreateMessage(MessageType::INFO_TIMER_ELAPSED).get());
+   // Repeating timers are added back to the wheel by Expire, so they are processed again later.
+   mExpiredTimers.clear();
+   timersToProcess.Expire(clockTime, mExpiredTimers);
 
-         timerMsg->SetTimerName(itor->name);
-         float lateTime = float((clockTime - itor->time));
-         // convert from microseconds to seconds
-         lateTime /= 1e6;
-         timerMsg->SetLateTime(lateTime);
-         timerMsg->SetAboutActorId(itor->aboutActor);
-         gm.SendMessage(*timerMsg.get());
-         if (itor->repeat)
-         {
-            TimerInfo tInfo = *itor;
-            tInfo.time += tInfo.interval;
-            repeatingTimers.insert(tInfo);
-         }
+   for (std::vector<TimerInfo>::const_iterator itor = mExpiredTimers.begin(); itor != mExpiredTimers.end(); ++itor)
+   {
+      dtCore::RefPtr<TimerElapsedMessage> timerMsg =
+         static_cast<TimerElapsedMessage*>(mFactory.CreateMessage(MessageType::INFO_TIMER_ELAPSED).get());
 
-         std::set<TimerInfo>::iterator toDelete = itor;
-         ++itor;
-         listToProcess.erase(toDelete);
-      }
-      else
-      {
-         break;
-      }
+      timerMsg->SetTimerName(itor->name);
+      float lateTime = float((clockTime - itor->time));
+      // convert from microseconds to seconds
+      lateTime /= 1e6;
+      timerMsg->SetLateTime(lateTime);
+      timerMsg->SetAboutActorId(itor->aboutActor);
+      gm.SendMessage(*timerMsg.get());
    }
-
-   // Repeating timers have to be readded so they are processed again later
-   listToProcess.insert(repeatingTimers.begin(), repeatingTimers.end());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -31,6 +31,7 @@ namespace dtGame
       : mServerRole(true)
       , mClientRole(true)
       , mEditorMode(false)
+      , mMapLoadActorsPerFrame(250U)
    {
    }
 
@@ -45,5 +46,7 @@ namespace dtGame
 
    DT_IMPLEMENT_ACCESSOR(GMSettings, bool, EditorMode);
 
+   DT_IMPLEMENT_ACCESSOR(GMSettings, unsigned, MapLoadActorsPerFrame);
+
 
 } // namespace dtGame
@@ -21,6 +21,7 @@
 #include <prefix/dtgameprefix.h>
 #include <dtUtil/log.h>
 #include <dtUtil/exception.h>
+#include <dtUtil/threadpool.h>
 
 #include <dtCore/project.h>
 #include <dtCore/map.h>
@@ -37,6 +38,9 @@
 #include <dtGame/gmcomponent.h>
 
 #include <dtCore/system.h>
+
+#include <OpenThreads/Atomic>
+
 namespace dtGame
 {
    IMPLEMENT_ENUM(MapChangeStateData::MapChangeState);
@@ -51,15 +55,71 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    const MapChangeStateData::MapChangeState MapChangeStateData::MapChangeState::IDLE("IDLE");
 
+   ///////////////////////////////////////////////////////////////////////////////
+   /// Parses one map on a worker.  It only holds its own data, so it's fine if the GM goes away first.
+   class MapChangeStateData::MapParseTask : public dtUtil::ThreadPoolTask
+   {
+   public:
+      MapParseTask(const std::string& mapName, const std::string& fullPath)
+         : mMapName(mapName)
+         , mFullPath(fullPath)
+         , mDone(0U)
+      {
+         SetName("MapParseTask");
+      }
+
+      void operator()() override
+      {
+         try
+         {
+            mMap = dtCore::Project::ParseMapFile(mFullPath);
+         }
+         catch (const dtUtil::Exception& ex)
+         {
+            mError = ex.ToString();
+         }
+         catch (const std::exception& ex)
+         {
+            mError = ex.what();
+         }
+
+         mDone.exchange(1U);
+      }
+
+      bool IsDone() const
+      {
+         return unsigned(mDone) != 0U;
+      }
+
+      std::string mMapName;
+      std::string mFullPath;
+      dtCore::RefPtr<dtCore::Map> mMap;
+      std::string mError;
+
+   protected:
+      ~MapParseTask() override
+      {
+      }
+
+   private:
+      OpenThreads::Atomic mDone;
+   };
+
    ///////////////////////////////////////////////////////////////////////////////
    MapChangeStateData::MapChangeStateData(GameManager& gm):
       osg::Referenced(), mGameManager(&gm), mCurrentState(&MapChangeStateData::MapChangeState::IDLE),
-      mAddBillboards(false)
+      mAddBillboards(false), mAsync(false), mParsedMapsOpened(false), mParseOnMainThread(false),
+      mNextPendingActor(0U)
+   {
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   MapChangeStateData::~MapChangeStateData()
    {
    }
 
    ///////////////////////////////////////////////////////////////////////////////
-   void MapChangeStateData::BeginMapChange(const MapChangeStateData::NameVector& oldMapNames, const MapChangeStateData::NameVector& newMapNames, bool addBillboards)
+   void MapChangeStateData::BeginMapChange(const MapChangeStateData::NameVector& oldMapNames, const MapChangeStateData::NameVector& newMapNames, bool addBillboards, bool async)
    {
       if (!mGameManager.valid())
       {
@@ -74,6 +134,11 @@ namespace dtGame
       mOldMapNames = oldMapNames;
       mNewMapNames = newMapNames;
       mAddBillboards = addBillboards;
+      mAsync = async;
+      mParsedMapsOpened = false;
+      mParseTasks.clear();
+      mPendingActors.clear();
+      mNextPendingActor = 0U;
 
       mCurrentState = &MapChangeState::UNLOAD;
 
@@ -207,6 +272,16 @@ namespace dtGame
    void MapChangeStateData::LoadSingleMapIntoGM(const std::string& mapName)
    {
       dtCore::Map& map = dtCore::Project::GetInstance().GetMap(mapName);
+      AddMapEventsToGM(map);
+
+      PendingActorList actors;
+      GetActorsToAdd(map, actors);
+      AddActorsToGM(actors, 0U, actors.size());
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::AddMapEventsToGM(dtCore::Map& map)
+   {
       // add all the events in the map to the game manager.
       std::vector<dtCore::GameEvent* > events;
       map.GetEventManager().GetAllEvents(events);
@@ -222,20 +297,24 @@ namespace dtGame
             mainGEM.AddEvent(*currEvent);
          }
       }
+   }
 
-      ScopedGMBatchAdd batch(*mGameManager);
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::GetActorsToAdd(dtCore::Map& map, PendingActorList& toFill)
+   {
+      PendingActor pending;
 
       if (map.GetEnvironmentActor() != NULL)
       {
-         dtGame::IEnvGameActorProxy* eap =
-            static_cast<dtGame::IEnvGameActorProxy*>(map.GetEnvironmentActor());
-
-         mGameManager->SetEnvironmentActor(eap);
+         pending.mActor = map.GetEnvironmentActor();
+         pending.mIsEnvironment = true;
+         toFill.push_back(pending);
       }
 
       dtCore::ActorRefPtrVector proxies;
       map.GetAllProxies(proxies);
 
+      pending.mIsEnvironment = false;
       for (unsigned int i = 0; i < proxies.size(); ++i)
       {
          dtCore::BaseActorObject& curAddActor = *proxies[i];
@@ -249,21 +328,153 @@ namespace dtGame
          {
             continue;
          }
-         else
+
+         pending.mActor = &curAddActor;
+         toFill.push_back(pending);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::AddActorsToGM(const PendingActorList& actors, size_t begin, size_t end)
+   {
+      ScopedGMBatchAdd batch(*mGameManager);
+
+      for (size_t i = begin; i < end; ++i)
+      {
+         dtCore::BaseActorObject& curAddActor = *actors[i].mActor;
+         if (actors[i].mIsEnvironment)
          {
-            try
-            {
-               mGameManager->AddActor(curAddActor);
-            }
-            catch (const dtUtil::Exception& ex)
+            mGameManager->SetEnvironmentActor(static_cast<dtGame::IEnvGameActorProxy*>(&curAddActor));
+            continue;
+         }
+
+         try
+         {
+            mGameManager->AddActor(curAddActor);
+         }
+         catch (const dtUtil::Exception& ex)
+         {
+            dtUtil::Log::GetInstance("mapchangestatedata.cpp").LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
+                  "A problem occurred adding Actor with name \"%s\" of type \"%s\" to the GameManager.",
+                  curAddActor.GetName().c_str(), curAddActor.GetActorType().GetFullName().c_str());
+            ex.LogException(dtUtil::Log::LOG_ERROR, dtUtil::Log::GetInstance("mapchangestatedata.cpp"));
+         }
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::StartParsingNewMaps()
+   {
+      mParseOnMainThread = !dtUtil::ThreadPool::IsInitialized();
+
+      dtCore::Project& project = dtCore::Project::GetInstance();
+      MapChangeStateData::NameVector::const_iterator i = mNewMapNames.begin();
+      MapChangeStateData::NameVector::const_iterator end = mNewMapNames.end();
+      for (; i != end; ++i)
+      {
+         // A map that is still open is used as is, just like GetMap would.
+         if (project.IsMapOpen(*i))
+         {
+            continue;
+         }
+
+         dtCore::RefPtr<MapParseTask> task = new MapParseTask(*i, project.GetMapFilePath(*i));
+         mParseTasks.push_back(task);
+         if (!mParseOnMainThread)
+         {
+            dtUtil::ThreadPool::AddTask(*task, dtUtil::ThreadPool::IO);
+         }
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool MapChangeStateData::OpenParsedMaps()
+   {
+      for (unsigned i = 0; i < mParseTasks.size(); ++i)
+      {
+         if (mParseOnMainThread)
+         {
+            (*mParseTasks[i])();
+         }
+         else if (!mParseTasks[i]->IsDone())
+         {
+            return false;
+         }
+      }
+      mParseOnMainThread = false;
+
+      for (unsigned i = 0; i < mParseTasks.size(); ++i)
+      {
+         const MapParseTask& task = *mParseTasks[i];
+         if (!task.mMap.valid())
+         {
+            // Same as a failure in OpenNewMaps.
+            mCurrentState = &MapChangeState::IDLE;
+            SendMapMessage(MessageType::INFO_MAP_CHANGED, MapChangeStateData::NameVector());
+            dtUtil::Log::GetInstance("mapchangestatedata.cpp").LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
+               "Critical failure occurred while opening map[%s]: %s", task.mMapName.c_str(), task.mError.c_str());
+            mNewMapNames.clear();
+            mParseTasks.clear();
+            return false;
+         }
+      }
+
+      dtCore::Project& project = dtCore::Project::GetInstance();
+      std::vector<dtCore::Map*> maps;
+      MapChangeStateData::NameVector::const_iterator i = mNewMapNames.begin();
+      MapChangeStateData::NameVector::const_iterator end = mNewMapNames.end();
+      for (; i != end; ++i)
+      {
+         dtCore::Map* map = NULL;
+         for (unsigned j = 0; j < mParseTasks.size() && map == NULL; ++j)
+         {
+            if (mParseTasks[j]->mMapName == *i)
             {
-               dtUtil::Log::GetInstance("mapchangestatedata.cpp").LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
-                     "A problem occurred adding Actor with name \"%s\" of type \"%s\" to the GameManager.",
-                     curAddActor.GetName().c_str(), curAddActor.GetActorType().GetFullName().c_str());
-               ex.LogException(dtUtil::Log::LOG_ERROR, dtUtil::Log::GetInstance("mapchangestatedata.cpp"));
+               map = &project.AddParsedMap(*i, *mParseTasks[j]->mMap);
             }
          }
+
+         if (map == NULL)
+         {
+            map = &project.GetMap(*i);
+         }
+         maps.push_back(map);
+      }
+      mParseTasks.clear();
+
+      SendMapMessage(MessageType::INFO_MAP_LOAD_BEGIN, mNewMapNames);
+
+      for (unsigned j = 0; j < maps.size(); ++j)
+      {
+         AddMapEventsToGM(*maps[j]);
+         GetActorsToAdd(*maps[j], mPendingActors);
+      }
+
+      mParsedMapsOpened = true;
+      return true;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool MapChangeStateData::AddPendingActors()
+   {
+      size_t end = mPendingActors.size();
+      unsigned budget = mGameManager->GetGMSettings().GetMapLoadActorsPerFrame();
+      if (budget > 0U && mNextPendingActor + budget < end)
+      {
+         end = mNextPendingActor + budget;
+      }
+
+      AddActorsToGM(mPendingActors, mNextPendingActor, end);
+      mNextPendingActor = end;
+
+      if (mNextPendingActor < mPendingActors.size())
+      {
+         return false;
       }
+
+      mPendingActors.clear();
+      mNextPendingActor = 0U;
+      return true;
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -286,7 +497,14 @@ namespace dtGame
       {
          CloseOldMaps();
 
-         if (OpenNewMaps())
+         if (mAsync && !mNewMapNames.empty())
+         {
+            // Parsing can't start any sooner because closing the old maps may unload actor libraries
+            // the new maps use.  The maps are opened once they finish parsing.
+            StartParsingNewMaps();
+            mCurrentState = &MapChangeState::LOAD;
+         }
+         else if (OpenNewMaps())
          {
             mCurrentState = &MapChangeState::LOAD;
          }
@@ -295,16 +513,41 @@ namespace dtGame
             // set the app to unpause so time stepping is correct
             mGameManager->SetPaused(false);
             mCurrentState = &MapChangeState::IDLE;
+            mAsync = false;
          }
       }
       else if (mCurrentState == &MapChangeState::LOAD)
       {
-         MapChangeStateData::NameVector::const_iterator i = mNewMapNames.begin();
-         MapChangeStateData::NameVector::const_iterator iend = mNewMapNames.end();
+         if (mAsync)
+         {
+            if (!mParsedMapsOpened)
+            {
+               if (!OpenParsedMaps() && *mCurrentState == MapChangeState::IDLE)
+               {
+                  // set the app to unpause so time stepping is correct
+                  mGameManager->SetPaused(false);
+                  mAsync = false;
+               }
+               // The actors are added starting next frame, just like the synchronous load.
+               return;
+            }
 
-         for (; i != iend; ++i)
+            if (!AddPendingActors())
+            {
+               return;
+            }
+            mAsync = false;
+            mParsedMapsOpened = false;
+         }
+         else
          {
-            LoadSingleMapIntoGM(*i);
+            MapChangeStateData::NameVector::const_iterator i = mNewMapNames.begin();
+            MapChangeStateData::NameVector::const_iterator iend = mNewMapNames.end();
+
+            for (; i != iend; ++i)
+            {
+               LoadSingleMapIntoGM(*i);
+            }
          }
 
          // set the app to unpause so time stepping is correct
@@ -55,9 +55,18 @@ namespace dtGame
 
    }
 
+   /////////////////////////////////////////////////////////////////
+   OpenThreads::Mutex& MessageFactory::GetRegistryMutex()
+   {
+      // Function static so it exists before any message types are registered during static init.
+      static OpenThreads::Mutex registryMutex;
+      return registryMutex;
+   }
+
    /////////////////////////////////////////////////////////////////
    void MessageFactory::UnregisterMessageType(const MessageType& type)
    {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(GetRegistryMutex());
       mMessageFactory->RemoveType(&type);
       std::map<unsigned short, const MessageType*>::iterator i = mIdMap.find(type.GetId());
       if (i != mIdMap.end())
@@ -69,19 +78,25 @@ namespace dtGame
    /////////////////////////////////////////////////////////////////
    bool MessageFactory::IsMessageTypeSupported(const MessageType& msg)
    {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(GetRegistryMutex());
       return mMessageFactory->IsTypeSupported(&msg);
    }
 
    /////////////////////////////////////////////////////////////////
    void MessageFactory::GetSupportedMessageTypes(std::vector<const MessageType*>& vec)
    {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(GetRegistryMutex());
       mMessageFactory->GetSupportedTypes(vec);
    }
 
    /////////////////////////////////////////////////////////////////
    dtCore::RefPtr<Message> MessageFactory::CreateMessage(const MessageType& msgType) const
    {
-      dtCore::RefPtr<Message> msg = mMessageFactory->CreateObject(&msgType);
+      dtCore::RefPtr<Message> msg;
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(GetRegistryMutex());
+         msg = mMessageFactory->CreateObject(&msgType);
+      }
 
       if (msg == NULL)
       {
@@ -123,6 +138,7 @@ namespace dtGame
    /////////////////////////////////////////////////////////////////
    const MessageType& MessageFactory::GetMessageTypeById(unsigned short id)
    {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(GetRegistryMutex());
       std::map<unsigned short, const MessageType*>::const_iterator itor = mIdMap.find(id);
       if (itor == mIdMap.end())
       {
@@ -138,6 +154,7 @@ namespace dtGame
    /////////////////////////////////////////////////////////////////
    const MessageType* MessageFactory::GetMessageTypeByName(const std::string& name)
    {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(GetRegistryMutex());
       for (std::map<unsigned short, const MessageType*>::const_iterator i = mIdMap.begin(); i != mIdMap.end(); ++i)
       {
          if (i->second->GetName() == name)
@@ -251,6 +268,8 @@ namespace dtGame
       "Sent from the server to tell the client about the frame sync mechanism.", 154, (ServerSyncControlMessage*)(NULL));
    const MessageType MessageType::NETSERVER_FRAME_SYNC("Server Frame Sync", "Server",
       "Sent from the server, every frame, to give clients a chance to sync up.", 155, (ServerFrameSyncMessage*)(NULL));
+   const MessageType MessageType::NETCLIENT_INTEREST_REGION("Client Interest Region", "Client",
+      "Sent from a client to tell the server which area it needs full rate actor updates for.", 156, (ClientInterestRegionMessage*)(NULL));
 
     // Logger messages
    const MessageType MessageType::LOG_REQ_CHANGESTATE_PLAYBACK("Logger - Change State to Playback",
@@ -0,0 +1,691 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include <prefix/dtgameprefix.h>
+#include <dtGame/spatialindexcomponent.h>
+
+#include <dtCore/propertymacros.h>
+#include <dtCore/transform.h>
+#include <dtCore/transformable.h>
+
+#include <dtGame/gameactorproxy.h>
+#include <dtGame/messagetype.h>
+
+#include <dtUtil/log.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace dtGame
+{
+   const dtCore::RefPtr<dtCore::SystemComponentType> SpatialIndexComponent::TYPE(new dtCore::SystemComponentType("SpatialIndexComponent","GMComponents",
+         "Keeps a spatial index of the actors in the world for radius queries and trigger volumes.",
+         dtGame::GMComponent::BaseGMComponentType));
+   const std::string SpatialIndexComponent::DEFAULT_NAME(TYPE->GetName());
+
+   // 21 bits per axis packed into the key.
+   static const int CELL_COORD_BITS = 21;
+   static const int CELL_COORD_MAX = (1 << (CELL_COORD_BITS - 1)) - 1;
+   static const int CELL_COORD_MIN = -CELL_COORD_MAX;
+
+   /////////////////////////////////////////////////////////////////
+   SpatialIndexComponent::SpatialIndexComponent(dtCore::SystemComponentType& type)
+   : BaseClass(type)
+   , mCellSize(50.0f)
+   , mUpdateOnTick(true)
+   , mUpdatingVolumes(false)
+   , mNumRemovedVolumes(0)
+   {
+      AddMessageSubscription(MessageType::TICK_LOCAL);
+      AddMessageSubscription(MessageType::INFO_ACTOR_CREATED);
+      AddMessageSubscription(MessageType::INFO_ACTOR_DELETED);
+      AddMessageSubscription(MessageType::INFO_MAP_UNLOAD_BEGIN);
+   }
+
+   /////////////////////////////////////////////////////////////////
+   SpatialIndexComponent::~SpatialIndexComponent()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////
+   DT_IMPLEMENT_ACCESSOR_GETTER(SpatialIndexComponent, float, CellSize);
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::SetCellSize(float value)
+   {
+      if (value <= 0.0f)
+      {
+         LOG_ERROR("The cell size of the spatial index must be greater than zero.");
+         return;
+      }
+
+      if (value != mCellSize)
+      {
+         mCellSize = value;
+         Rebucket();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////
+   DT_IMPLEMENT_ACCESSOR(SpatialIndexComponent, bool, UpdateOnTick);
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::BuildPropertyMap()
+   {
+      BaseClass::BuildPropertyMap();
+
+      const dtUtil::RefString GROUP("SpatialIndex");
+      typedef dtCore::PropertyRegHelper<SpatialIndexComponent> RegHelperType;
+      RegHelperType propReg(*this, this, GROUP);
+
+      DT_REGISTER_PROPERTY(CellSize,
+            "The edge length of the cells of the index grid.  It should be about the size of a common query radius.",
+            RegHelperType, propReg);
+
+      DT_REGISTER_PROPERTY(UpdateOnTick,
+            "If true, the index refreshes the actor positions and evaluates the volumes on every tick local.",
+            RegHelperType, propReg);
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::ProcessMessage(const Message& message)
+   {
+      const MessageType& type = message.GetMessageType();
+      if (type == MessageType::TICK_LOCAL)
+      {
+         if (mUpdateOnTick)
+         {
+            Update();
+         }
+      }
+      else if (type == MessageType::INFO_ACTOR_CREATED)
+      {
+         GameActorProxy* actor = GetGameManager()->FindGameActorById(message.GetAboutActorId());
+         if (actor != NULL)
+         {
+            AddActor(*actor);
+         }
+      }
+      else if (type == MessageType::INFO_ACTOR_DELETED)
+      {
+         RemoveActor(message.GetAboutActorId());
+      }
+      else if (type == MessageType::INFO_MAP_UNLOAD_BEGIN)
+      {
+         Clear();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::OnAddedToGM()
+   {
+      std::vector<GameActorProxy*> actors;
+      GetGameManager()->GetAllGameActors(actors);
+      std::vector<GameActorProxy*>::iterator i, iend;
+      for (i = actors.begin(), iend = actors.end(); i != iend; ++i)
+      {
+         AddActor(**i);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::OnRemovedFromGM()
+   {
+      Clear();
+   }
+
+   /////////////////////////////////////////////////////////////////
+   bool SpatialIndexComponent::AddActor(GameActorProxy& actor)
+   {
+      dtCore::Transformable* xformable = actor.GetDrawable<dtCore::Transformable>();
+      if (xformable == NULL || actor.IsDeleted())
+      {
+         return false;
+      }
+
+      if (mIdToIndex.find(actor.GetId()) != mIdToIndex.end())
+      {
+         return false;
+      }
+
+      Entry entry;
+      entry.mId = actor.GetId();
+      entry.mActor = &actor;
+      entry.mTransformable = xformable;
+      ReadPosition(entry);
+      entry.mCell = CalcCellKey(entry.mPosition);
+
+      unsigned entryIndex = unsigned(mEntries.size());
+      mEntries.push_back(entry);
+      mIdToIndex.insert(std::make_pair(entry.mId, entryIndex));
+      InsertIntoCell(entryIndex);
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   bool SpatialIndexComponent::RemoveActor(const dtCore::UniqueId& id)
+   {
+      IdToIndexMap::iterator found = mIdToIndex.find(id);
+      if (found == mIdToIndex.end())
+      {
+         return false;
+      }
+
+      dtCore::RefPtr<GameActorProxy> actor = mEntries[found->second].mActor.get();
+
+      // Drop it from the volume occupancy so a re-add shows up as a new enter.
+      std::vector<std::pair<dtCore::UniqueId, VolumeEventFunc> > left;
+      std::vector<Volume>::iterator vi, viend;
+      for (vi = mVolumes.begin(), viend = mVolumes.end(); vi != viend; ++vi)
+      {
+         std::vector<dtCore::UniqueId>::iterator occ = std::lower_bound(vi->mOccupants.begin(), vi->mOccupants.end(), id);
+         if (occ != vi->mOccupants.end() && *occ == id)
+         {
+            vi->mOccupants.erase(occ);
+            if (vi->mEventFunc.valid())
+            {
+               left.push_back(std::make_pair(vi->mId, vi->mEventFunc));
+            }
+         }
+      }
+
+      RemoveEntryAt(found->second);
+
+      // Sent once the index is consistent again, since the callbacks may change it.
+      if (actor.valid())
+      {
+         for (unsigned i = 0; i < left.size(); ++i)
+         {
+            left[i].second(left[i].first, *actor, VOLUME_LEAVE);
+         }
+      }
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   bool SpatialIndexComponent::IsActorIndexed(const dtCore::UniqueId& id) const
+   {
+      return mIdToIndex.find(id) != mIdToIndex.end();
+   }
+
+   /////////////////////////////////////////////////////////////////
+   unsigned SpatialIndexComponent::GetNumIndexedActors() const
+   {
+      return unsigned(mEntries.size());
+   }
+
+   /////////////////////////////////////////////////////////////////
+   bool SpatialIndexComponent::GetActorPosition(const dtCore::UniqueId& id, osg::Vec3& posOut) const
+   {
+      IdToIndexMap::const_iterator found = mIdToIndex.find(id);
+      if (found == mIdToIndex.end())
+      {
+         return false;
+      }
+      posOut = mEntries[found->second].mPosition;
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::Clear()
+   {
+      mEntries.clear();
+      mIdToIndex.clear();
+      mCells.clear();
+      mVolumes.clear();
+      mNumRemovedVolumes = 0;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::Update()
+   {
+      // Walk backwards so removing a dead entry, which swaps the last one in, doesn't skip anything.
+      for (unsigned i = unsigned(mEntries.size()); i > 0; --i)
+      {
+         unsigned entryIndex = i - 1;
+         Entry& entry = mEntries[entryIndex];
+         if (!ReadPosition(entry))
+         {
+            RemoveActor(dtCore::UniqueId(entry.mId));
+            continue;
+         }
+
+         CellKey newCell = CalcCellKey(entry.mPosition);
+         if (newCell != entry.mCell)
+         {
+            RemoveFromCell(entryIndex);
+            entry.mCell = newCell;
+            InsertIntoCell(entryIndex);
+         }
+      }
+
+      // Callbacks may add volumes, so index rather than iterate.  Removed ones are erased afterwards so none are skipped.
+      mUpdatingVolumes = true;
+      for (unsigned i = 0; i < mVolumes.size(); ++i)
+      {
+         if (!mVolumes[i].mRemoved)
+         {
+            UpdateVolume(mVolumes[i]);
+         }
+      }
+      mUpdatingVolumes = false;
+      EraseRemovedVolumes();
+   }
+
+   /////////////////////////////////////////////////////////////////
+   namespace
+   {
+      struct CollectInRadius
+      {
+         CollectInRadius(const osg::Vec3& center, float radius, SpatialIndexComponent::ActorVector& toFill)
+         : mCenter(center)
+         , mRadius2(radius * radius)
+         , mToFill(toFill)
+         {}
+
+         template <typename EntryType>
+         void operator()(const EntryType& entry)
+         {
+            if ((entry.mPosition - mCenter).length2() <= mRadius2 && entry.mActor.valid())
+            {
+               mToFill.push_back(entry.mActor.get());
+            }
+         }
+
+         osg::Vec3 mCenter;
+         float mRadius2;
+         SpatialIndexComponent::ActorVector& mToFill;
+      };
+
+      struct CollectInBox
+      {
+         CollectInBox(const osg::BoundingBox& box, SpatialIndexComponent::ActorVector& toFill)
+         : mBox(box)
+         , mToFill(toFill)
+         {}
+
+         template <typename EntryType>
+         void operator()(const EntryType& entry)
+         {
+            if (mBox.contains(entry.mPosition) && entry.mActor.valid())
+            {
+               mToFill.push_back(entry.mActor.get());
+            }
+         }
+
+         osg::BoundingBox mBox;
+         SpatialIndexComponent::ActorVector& mToFill;
+      };
+
+      struct CollectIdsInBox
+      {
+         CollectIdsInBox(const osg::BoundingBox& box, const dtCore::UniqueId& exclude, std::vector<dtCore::UniqueId>& toFill)
+         : mBox(box)
+         , mExclude(exclude)
+         , mToFill(toFill)
+         {}
+
+         template <typename EntryType>
+         void operator()(const EntryType& entry)
+         {
+            if (mBox.contains(entry.mPosition) && entry.mId != mExclude)
+            {
+               mToFill.push_back(entry.mId);
+            }
+         }
+
+         osg::BoundingBox mBox;
+         const dtCore::UniqueId& mExclude;
+         std::vector<dtCore::UniqueId>& mToFill;
+      };
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::FindActorsInRadius(const osg::Vec3& center, float radius, ActorVector& toFill) const
+   {
+      osg::Vec3 extent(radius, radius, radius);
+      osg::BoundingBox box(center - extent, center + extent);
+      CollectInRadius collector(center, radius, toFill);
+      VisitBox(box, collector);
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::FindActorsInBox(const osg::BoundingBox& box, ActorVector& toFill) const
+   {
+      CollectInBox collector(box, toFill);
+      VisitBox(box, collector);
+   }
+
+   /////////////////////////////////////////////////////////////////
+   bool SpatialIndexComponent::AddVolume(const dtCore::UniqueId& volumeId, const osg::Vec3& halfExtents, VolumeEventFunc eventFunc)
+   {
+      std::vector<Volume>::iterator i, iend;
+      for (i = mVolumes.begin(), iend = mVolumes.end(); i != iend; ++i)
+      {
+         if (i->mId == volumeId && !i->mRemoved)
+         {
+            return false;
+         }
+      }
+
+      Volume volume;
+      volume.mId = volumeId;
+      volume.mHalfExtents = halfExtents;
+      volume.mEventFunc = eventFunc;
+      mVolumes.push_back(volume);
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::SetVolumeHalfExtents(const dtCore::UniqueId& volumeId, const osg::Vec3& halfExtents)
+   {
+      std::vector<Volume>::iterator i, iend;
+      for (i = mVolumes.begin(), iend = mVolumes.end(); i != iend; ++i)
+      {
+         if (i->mId == volumeId && !i->mRemoved)
+         {
+            i->mHalfExtents = halfExtents;
+            return;
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////
+   bool SpatialIndexComponent::RemoveVolume(const dtCore::UniqueId& volumeId)
+   {
+      std::vector<Volume>::iterator i, iend;
+      for (i = mVolumes.begin(), iend = mVolumes.end(); i != iend; ++i)
+      {
+         if (i->mId == volumeId && !i->mRemoved)
+         {
+            if (mUpdatingVolumes)
+            {
+               i->mRemoved = true;
+               i->mOccupants.clear();
+               i->mEventFunc = VolumeEventFunc();
+               ++mNumRemovedVolumes;
+            }
+            else
+            {
+               mVolumes.erase(i);
+            }
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::EraseRemovedVolumes()
+   {
+      if (mNumRemovedVolumes == 0)
+      {
+         return;
+      }
+
+      unsigned kept = 0;
+      for (unsigned i = 0; i < mVolumes.size(); ++i)
+      {
+         if (!mVolumes[i].mRemoved)
+         {
+            if (kept != i)
+            {
+               mVolumes[kept] = mVolumes[i];
+            }
+            ++kept;
+         }
+      }
+      mVolumes.resize(kept);
+      mNumRemovedVolumes = 0;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   unsigned SpatialIndexComponent::GetNumVolumes() const
+   {
+      return unsigned(mVolumes.size()) - mNumRemovedVolumes;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::GetVolumeOccupants(const dtCore::UniqueId& volumeId, std::vector<dtCore::UniqueId>& toFill) const
+   {
+      std::vector<Volume>::const_iterator i, iend;
+      for (i = mVolumes.begin(), iend = mVolumes.end(); i != iend; ++i)
+      {
+         if (i->mId == volumeId && !i->mRemoved)
+         {
+            toFill.insert(toFill.end(), i->mOccupants.begin(), i->mOccupants.end());
+            return;
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////
+   int SpatialIndexComponent::CalcCellCoord(float value) const
+   {
+      float scaled = std::floor(value / mCellSize);
+      if (scaled > float(CELL_COORD_MAX))
+      {
+         return CELL_COORD_MAX;
+      }
+      else if (scaled < float(CELL_COORD_MIN))
+      {
+         return CELL_COORD_MIN;
+      }
+      return int(scaled);
+   }
+
+   /////////////////////////////////////////////////////////////////
+   SpatialIndexComponent::CellKey SpatialIndexComponent::PackCellKey(int x, int y, int z)
+   {
+      const CellKey mask = (CellKey(1) << CELL_COORD_BITS) - 1;
+      return  (CellKey(x) & mask)
+            | ((CellKey(y) & mask) << CELL_COORD_BITS)
+            | ((CellKey(z) & mask) << (CELL_COORD_BITS * 2));
+   }
+
+   /////////////////////////////////////////////////////////////////
+   SpatialIndexComponent::CellKey SpatialIndexComponent::CalcCellKey(const osg::Vec3& pos) const
+   {
+      return PackCellKey(CalcCellCoord(pos.x()), CalcCellCoord(pos.y()), CalcCellCoord(pos.z()));
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::InsertIntoCell(unsigned entryIndex)
+   {
+      Entry& entry = mEntries[entryIndex];
+      Cell& cell = mCells[entry.mCell];
+      entry.mIndexInCell = unsigned(cell.size());
+      cell.push_back(entryIndex);
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::RemoveFromCell(unsigned entryIndex)
+   {
+      Entry& entry = mEntries[entryIndex];
+      CellMap::iterator found = mCells.find(entry.mCell);
+      if (found == mCells.end())
+      {
+         return;
+      }
+
+      Cell& cell = found->second;
+      unsigned last = cell.back();
+      cell[entry.mIndexInCell] = last;
+      mEntries[last].mIndexInCell = entry.mIndexInCell;
+      cell.pop_back();
+
+      if (cell.empty())
+      {
+         mCells.erase(found);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::RemoveEntryAt(unsigned entryIndex)
+   {
+      RemoveFromCell(entryIndex);
+      mIdToIndex.erase(mEntries[entryIndex].mId);
+
+      unsigned lastIndex = unsigned(mEntries.size()) - 1;
+      if (entryIndex != lastIndex)
+      {
+         // Move the last entry into the hole and repoint its cell slot and id mapping.
+         mEntries[entryIndex] = mEntries[lastIndex];
+         Entry& moved = mEntries[entryIndex];
+         mCells[moved.mCell][moved.mIndexInCell] = entryIndex;
+         mIdToIndex[moved.mId] = entryIndex;
+      }
+      mEntries.pop_back();
+   }
+
+   /////////////////////////////////////////////////////////////////
+   bool SpatialIndexComponent::ReadPosition(Entry& entry) const
+   {
+      if (!entry.mTransformable.valid() || !entry.mActor.valid() || entry.mActor->IsDeleted())
+      {
+         return false;
+      }
+
+      dtCore::Transform xform;
+      entry.mTransformable->GetTransform(xform, dtCore::Transformable::ABS_CS);
+      xform.GetTranslation(entry.mPosition);
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::Rebucket()
+   {
+      mCells.clear();
+      for (unsigned i = 0; i < mEntries.size(); ++i)
+      {
+         mEntries[i].mCell = CalcCellKey(mEntries[i].mPosition);
+         InsertIntoCell(i);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////
+   template <typename Pred>
+   void SpatialIndexComponent::VisitBox(const osg::BoundingBox& box, Pred& pred) const
+   {
+      if (!box.valid() || mEntries.empty())
+      {
+         return;
+      }
+
+      const int minX = CalcCellCoord(box.xMin()), maxX = CalcCellCoord(box.xMax());
+      const int minY = CalcCellCoord(box.yMin()), maxY = CalcCellCoord(box.yMax());
+      const int minZ = CalcCellCoord(box.zMin()), maxZ = CalcCellCoord(box.zMax());
+
+      // A huge box would touch more empty cells than there are actors, so just scan the actors.
+      const double numCells = double(maxX - minX + 1) * double(maxY - minY + 1) * double(maxZ - minZ + 1);
+      if (numCells > double(mEntries.size()))
+      {
+         std::vector<Entry>::const_iterator i, iend;
+         for (i = mEntries.begin(), iend = mEntries.end(); i != iend; ++i)
+         {
+            pred(*i);
+         }
+         return;
+      }
+
+      for (int z = minZ; z <= maxZ; ++z)
+      {
+         for (int y = minY; y <= maxY; ++y)
+         {
+            for (int x = minX; x <= maxX; ++x)
+            {
+               CellMap::const_iterator found = mCells.find(PackCellKey(x, y, z));
+               if (found == mCells.end())
+               {
+                  continue;
+               }
+
+               const Cell& cell = found->second;
+               Cell::const_iterator ci, ciend;
+               for (ci = cell.begin(), ciend = cell.end(); ci != ciend; ++ci)
+               {
+                  pred(mEntries[*ci]);
+               }
+            }
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void SpatialIndexComponent::UpdateVolume(Volume& volume)
+   {
+      IdToIndexMap::const_iterator ownerItr = mIdToIndex.find(volume.mId);
+      if (ownerItr == mIdToIndex.end())
+      {
+         // The owner isn't indexed yet, or it has been deleted.
+         return;
+      }
+
+      const osg::Vec3& center = mEntries[ownerItr->second].mPosition;
+      osg::BoundingBox box(center - volume.mHalfExtents, center + volume.mHalfExtents);
+
+      mScratchOccupants.clear();
+      CollectIdsInBox collector(box, volume.mId, mScratchOccupants);
+      VisitBox(box, collector);
+      std::sort(mScratchOccupants.begin(), mScratchOccupants.end());
+
+      if (mScratchOccupants == volume.mOccupants)
+      {
+         return;
+      }
+
+      // Copy the id because the callbacks may remove the volume.
+      dtCore::UniqueId volumeId = volume.mId;
+      VolumeEventFunc eventFunc = volume.mEventFunc;
+
+      std::vector<dtCore::UniqueId> left;
+      std::set_difference(volume.mOccupants.begin(), volume.mOccupants.end(),
+            mScratchOccupants.begin(), mScratchOccupants.end(), std::back_inserter(left));
+
+      std::vector<dtCore::UniqueId> entered;
+      std::set_difference(mScratchOccupants.begin(), mScratchOccupants.end(),
+            volume.mOccupants.begin(), volume.mOccupants.end(), std::back_inserter(entered));
+
+      volume.mOccupants.swap(mScratchOccupants);
+
+      if (!eventFunc.valid())
+      {
+         return;
+      }
+
+      std::vector<dtCore::UniqueId>::iterator i, iend;
+      for (i = left.begin(), iend = left.end(); i != iend; ++i)
+      {
+         GameActorProxy* actor = GetGameManager() != NULL ? GetGameManager()->FindGameActorById(*i) : NULL;
+         if (actor != NULL)
+         {
+            eventFunc(volumeId, *actor, VOLUME_LEAVE);
+         }
+      }
+
+      for (i = entered.begin(), iend = entered.end(); i != iend; ++i)
+      {
+         GameActorProxy* actor = GetGameManager() != NULL ? GetGameManager()->FindGameActorById(*i) : NULL;
+         if (actor != NULL)
+         {
+            eventFunc(volumeId, *actor, VOLUME_ENTER);
+         }
+      }
+   }
+}
@@ -0,0 +1,416 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <prefix/dtgameprefix.h>
+#include <dtGame/timerwheel.h>
+
+#include <algorithm>
+
+namespace dtGame
+{
+   /////////////////////////////////////////////////////////////////////////////
+   TimerWheel::TimerWheel(dtCore::Timer_t resolution)
+   : mListHeads(OVERFLOW_LIST + 1, INVALID_INDEX)
+   , mResolution(std::max(resolution, dtCore::Timer_t(1)))
+   , mCurrentTick(0)
+   , mNextSequence(0)
+   , mSize(0)
+   {
+      std::fill(mLevelCounts, mLevelCounts + NUM_LEVELS + 1, 0U);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned TimerWheel::AllocateNode()
+   {
+      unsigned index;
+      if (!mFreeNodes.empty())
+      {
+         index = mFreeNodes.back();
+         mFreeNodes.pop_back();
+      }
+      else
+      {
+         index = unsigned(mNodes.size());
+         mNodes.push_back(Node());
+      }
+
+      Node& node = mNodes[index];
+      node.mList = INVALID_INDEX;
+      node.mPrev = node.mNext = INVALID_INDEX;
+      node.mActorPrev = node.mActorNext = INVALID_INDEX;
+      node.mActive = true;
+      ++mSize;
+      return index;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::FreeNode(unsigned index)
+   {
+      Node& node = mNodes[index];
+      node.mActive = false;
+      node.mInfo.name.clear();
+      mFreeNodes.push_back(index);
+      --mSize;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Add(const TimerInfo& timer)
+   {
+      unsigned index = AllocateNode();
+      Node& node = mNodes[index];
+      node.mInfo = timer;
+      node.mTick = timer.time / mResolution;
+      node.mSequence = mNextSequence++;
+
+      ActorTimerMap::iterator found = mActorTimers.find(timer.aboutActor);
+      if (found == mActorTimers.end())
+      {
+         mActorTimers.insert(std::make_pair(timer.aboutActor, index));
+      }
+      else
+      {
+         node.mActorNext = found->second;
+         mNodes[found->second].mActorPrev = index;
+         found->second = index;
+      }
+
+      Link(index);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Link(unsigned index)
+   {
+      Node& node = mNodes[index];
+      dtCore::Timer_t tick = std::max(node.mTick, mCurrentTick);
+      dtCore::Timer_t delta = tick - mCurrentTick;
+
+      unsigned level = 0;
+      while (level < NUM_LEVELS && delta >= (dtCore::Timer_t(1) << (SLOT_BITS * (level + 1))))
+      {
+         ++level;
+      }
+
+      unsigned list = OVERFLOW_LIST;
+      if (level < NUM_LEVELS)
+      {
+         list = level * NUM_SLOTS + unsigned((tick >> (SLOT_BITS * level)) & (NUM_SLOTS - 1));
+      }
+
+      node.mList = list;
+      node.mPrev = INVALID_INDEX;
+      node.mNext = mListHeads[list];
+      if (node.mNext != INVALID_INDEX)
+      {
+         mNodes[node.mNext].mPrev = index;
+      }
+      mListHeads[list] = index;
+      ++mLevelCounts[list / NUM_SLOTS];
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Unlink(unsigned index)
+   {
+      Node& node = mNodes[index];
+      if (node.mList == INVALID_INDEX)
+      {
+         return;
+      }
+
+      if (node.mPrev != INVALID_INDEX)
+      {
+         mNodes[node.mPrev].mNext = node.mNext;
+      }
+      else
+      {
+         mListHeads[node.mList] = node.mNext;
+      }
+
+      if (node.mNext != INVALID_INDEX)
+      {
+         mNodes[node.mNext].mPrev = node.mPrev;
+      }
+
+      --mLevelCounts[node.mList / NUM_SLOTS];
+      node.mList = INVALID_INDEX;
+      node.mPrev = node.mNext = INVALID_INDEX;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::UnlinkActor(unsigned index)
+   {
+      Node& node = mNodes[index];
+      if (node.mActorPrev != INVALID_INDEX)
+      {
+         mNodes[node.mActorPrev].mActorNext = node.mActorNext;
+      }
+      else if (node.mActorNext != INVALID_INDEX)
+      {
+         mActorTimers[node.mInfo.aboutActor] = node.mActorNext;
+      }
+      else
+      {
+         mActorTimers.erase(node.mInfo.aboutActor);
+      }
+
+      if (node.mActorNext != INVALID_INDEX)
+      {
+         mNodes[node.mActorNext].mActorPrev = node.mActorPrev;
+      }
+
+      node.mActorPrev = node.mActorNext = INVALID_INDEX;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Remove(unsigned index)
+   {
+      Unlink(index);
+      UnlinkActor(index);
+      FreeNode(index);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::RelinkList(unsigned list)
+   {
+      unsigned index = mListHeads[list];
+      while (index != INVALID_INDEX)
+      {
+         unsigned next = mNodes[index].mNext;
+         Unlink(index);
+         Link(index);
+         index = next;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Cascade()
+   {
+      for (unsigned level = 1; level <= NUM_LEVELS; ++level)
+      {
+         dtCore::Timer_t lowBits = mCurrentTick & ((dtCore::Timer_t(1) << (SLOT_BITS * level)) - 1);
+         if (lowBits != 0)
+         {
+            break;
+         }
+
+         if (level == NUM_LEVELS)
+         {
+            RelinkList(OVERFLOW_LIST);
+         }
+         else if (mLevelCounts[level] > 0)
+         {
+            RelinkList(level * NUM_SLOTS + unsigned((mCurrentTick >> (SLOT_BITS * level)) & (NUM_SLOTS - 1)));
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::CollectDue(dtCore::Timer_t clockTime)
+   {
+      unsigned index = mListHeads[unsigned(mCurrentTick & (NUM_SLOTS - 1))];
+      while (index != INVALID_INDEX)
+      {
+         unsigned next = mNodes[index].mNext;
+         // The bucket of the current tick may still hold timers later within the same tick.
+         if (mNodes[index].mInfo.time <= clockTime)
+         {
+            Unlink(index);
+            mDue.push_back(index);
+         }
+         index = next;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Rebase(dtCore::Timer_t tick)
+   {
+      std::vector<unsigned> pending;
+      pending.reserve(mSize);
+      for (unsigned i = 0; i < mNodes.size(); ++i)
+      {
+         if (mNodes[i].mActive)
+         {
+            Unlink(i);
+            pending.push_back(i);
+         }
+      }
+
+      mCurrentTick = tick;
+      for (unsigned i = 0; i < pending.size(); ++i)
+      {
+         Link(pending[i]);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Expire(dtCore::Timer_t clockTime, std::vector<TimerInfo>& expired)
+   {
+      dtCore::Timer_t nowTick = clockTime / mResolution;
+      if (mSize == 0)
+      {
+         mCurrentTick = nowTick;
+         return;
+      }
+
+      if (nowTick < mCurrentTick)
+      {
+         Rebase(nowTick);
+      }
+
+      mDue.clear();
+      CollectDue(clockTime);
+
+      while (mCurrentTick < nowTick)
+      {
+         if (mLevelCounts[0] == 0)
+         {
+            // Nothing can come due before the next cascade of the finest wheel that has timers,
+            // so jump straight to it, or to the clock time if that comes first.
+            unsigned level = 1;
+            while (level < NUM_LEVELS && mLevelCounts[level] == 0)
+            {
+               ++level;
+            }
+
+            dtCore::Timer_t nextCascade = ((mCurrentTick >> (SLOT_BITS * level)) + 1) << (SLOT_BITS * level);
+            if (nextCascade > nowTick)
+            {
+               mCurrentTick = nowTick;
+               break;
+            }
+            mCurrentTick = nextCascade - 1;
+         }
+
+         ++mCurrentTick;
+         Cascade();
+         CollectDue(clockTime);
+      }
+
+      if (mDue.empty())
+      {
+         return;
+      }
+
+      // Report in time order, and in the order they were added for equal times.
+      std::vector<Node>& nodes = mNodes;
+      std::sort(mDue.begin(), mDue.end(), [&nodes](unsigned a, unsigned b)
+      {
+         if (nodes[a].mInfo.time != nodes[b].mInfo.time)
+         {
+            return nodes[a].mInfo.time < nodes[b].mInfo.time;
+         }
+         return nodes[a].mSequence < nodes[b].mSequence;
+      });
+
+      expired.reserve(expired.size() + mDue.size());
+      for (unsigned i = 0; i < mDue.size(); ++i)
+      {
+         unsigned index = mDue[i];
+         Node& node = mNodes[index];
+         expired.push_back(node.mInfo);
+
+         if (node.mInfo.repeat)
+         {
+            // Added back only after all the due timers were collected, so it can't fire twice in one call.
+            node.mInfo.time += node.mInfo.interval;
+            node.mTick = node.mInfo.time / mResolution;
+            node.mSequence = mNextSequence++;
+            Link(index);
+         }
+         else
+         {
+            UnlinkActor(index);
+            FreeNode(index);
+         }
+      }
+      mDue.clear();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Clear(const std::string& name, const dtCore::UniqueId* aboutActor)
+   {
+      if (aboutActor != NULL)
+      {
+         ActorTimerMap::iterator found = mActorTimers.find(*aboutActor);
+         unsigned index = found == mActorTimers.end() ? INVALID_INDEX : found->second;
+         while (index != INVALID_INDEX)
+         {
+            unsigned next = mNodes[index].mActorNext;
+            if (mNodes[index].mInfo.name == name)
+            {
+               Remove(index);
+            }
+            index = next;
+         }
+      }
+      else
+      {
+         for (unsigned i = 0; i < mNodes.size(); ++i)
+         {
+            if (mNodes[i].mActive && mNodes[i].mInfo.name == name)
+            {
+               Remove(i);
+            }
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::ClearForActor(const dtCore::UniqueId& aboutActor)
+   {
+      ActorTimerMap::iterator found = mActorTimers.find(aboutActor);
+      if (found == mActorTimers.end())
+      {
+         return;
+      }
+
+      unsigned index = found->second;
+      mActorTimers.erase(found);
+      while (index != INVALID_INDEX)
+      {
+         unsigned next = mNodes[index].mActorNext;
+         Unlink(index);
+         FreeNode(index);
+         index = next;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Clear()
+   {
+      mNodes.clear();
+      mFreeNodes.clear();
+      std::fill(mListHeads.begin(), mListHeads.end(), unsigned(INVALID_INDEX));
+      std::fill(mLevelCounts, mLevelCounts + NUM_LEVELS + 1, 0U);
+      mActorTimers.clear();
+      mDue.clear();
+      mSize = 0;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned TimerWheel::GetSize() const
+   {
+      return mSize;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool TimerWheel::IsEmpty() const
+   {
+      return mSize == 0;
+   }
+}
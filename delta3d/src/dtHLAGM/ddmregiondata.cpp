@@ -21,6 +21,8 @@
 
 #include <dtHLAGM/ddmregiondata.h>
 
+#include <algorithm>
+#include <climits>
 #include <cstring>
 
 namespace dtHLAGM
@@ -44,6 +46,26 @@ namespace dtHLAGM
       return &mDimensions[extent];
    }
 
+   unsigned int DDMRegionData::GetChangeSinceCommit() const
+   {
+      if (mCommittedDimensions.size() != mDimensions.size())
+         return UINT_MAX;
+
+      unsigned int result = 0U;
+      for (unsigned i = 0; i < mDimensions.size(); ++i)
+      {
+         const DimensionValues& current = mDimensions[i];
+         const DimensionValues& committed = mCommittedDimensions[i];
+         if (current.mName != committed.mName)
+            return UINT_MAX;
+
+         unsigned int minDelta = current.mMin > committed.mMin ? current.mMin - committed.mMin : committed.mMin - current.mMin;
+         unsigned int maxDelta = current.mMax > committed.mMax ? current.mMax - committed.mMax : committed.mMax - current.mMax;
+         result = std::max(result, std::max(minDelta, maxDelta));
+      }
+      return result;
+   }
+
    bool DDMRegionData::DimensionValues::operator == (const DDMRegionData::DimensionValues& toComp) const
    {
       if (this == &toComp)
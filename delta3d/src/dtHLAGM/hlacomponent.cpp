@@ -32,6 +32,7 @@
 #include <dtHLAGM/rprparametertranslator.h>
 #include <dtHLAGM/ddmregioncalculator.h>
 #include <dtHLAGM/ddmregiondata.h>
+#include <dtHLAGM/ddmutil.h>
 #include <dtHLAGM/exceptionenum.h>
 #include <dtHLAGM/rtiexception.h>
 
@@ -58,6 +59,7 @@
 #include <osg/Endian>
 #include <osg/io_utils>
 
+#include <climits>
 #include <cstdlib>
 #include <algorithm>
 
@@ -110,6 +112,8 @@ namespace dtHLAGM
    , mLocalIPAddress(0x7f000001)
    , mDDMEnabled(false)
    , mMachineInfo(new dtGame::MachineInfo)
+   , mDDMRegionUpdateThreshold(0.0)
+   , mDDMMinTimeBetweenRegionUpdates(0.0)
    {
       mLogger = &dtUtil::Log::GetInstance("hlacomponent.cpp");
 
@@ -515,6 +519,30 @@ namespace dtHLAGM
       mDDMEnabled = enable;
    }
 
+   /////////////////////////////////////////////////////////////////////////////////
+   void HLAComponent::SetDDMRegionUpdateThreshold(double fraction)
+   {
+      mDDMRegionUpdateThreshold = fraction;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////
+   double HLAComponent::GetDDMRegionUpdateThreshold() const
+   {
+      return mDDMRegionUpdateThreshold;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////
+   void HLAComponent::SetDDMMinTimeBetweenRegionUpdates(double seconds)
+   {
+      mDDMMinTimeBetweenRegionUpdates = seconds;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////
+   double HLAComponent::GetDDMMinTimeBetweenRegionUpdates() const
+   {
+      return mDDMMinTimeBetweenRegionUpdates;
+   }
+
    /////////////////////////////////////////////////////////////////////////////////
    void HLAComponent::JoinFederationExecution(const std::string& executionName,
                                               const std::vector<std::string>& fedFilenames,
@@ -701,6 +729,7 @@ namespace dtHLAGM
          mExecutionName.clear();
       }
 
+      mDDMDimensionHandles.clear();
       mRTIAmbassador = NULL;
    }
 
@@ -2344,16 +2373,20 @@ namespace dtHLAGM
 
       dtCore::RefPtr<RTIRegion> r = regionData.GetRegion();
 
-      if (r != NULL && mRTIAmbassador->GetNumDimensions(*r) != regionData.GetNumberOfExtents())
+      // A region can only be modified in place if it still has the same dimensions, which is
+      // always true if they match the ones last committed, so only ask the RTI when they don't.
+      if (r != NULL && regionData.GetChangeSinceCommit() == UINT_MAX
+            && mRTIAmbassador->GetNumDimensions(*r) != regionData.GetNumberOfExtents())
       {
+         mLogger->LogMessage(dtUtil::Log::LOG_WARNING, __FUNCTION__, __LINE__,
+               "The number of dimensions of a subscription region changed, so it must be deleted and recreated.");
          mRTIAmbassador->DeleteRegion(*r);
          //just to be safe.
          regionData.SetRegion(NULL);
+         regionData.ClearCommitted();
          r = NULL;
       }
 
-
-
       if (r == NULL && regionData.GetNumberOfExtents() > 0)
       {
          RTIDimensionHandleSet dimHandleSet;
@@ -2367,15 +2400,7 @@ namespace dtHLAGM
                continue;
             }
 
-            try
-            {
-               dtCore::RefPtr<RTIDimensionHandle> dimHandle = mRTIAmbassador->GetDimensionHandle(dimension->mName);
-               dimHandleSet.insert(dimHandle);
-            }
-            catch (const RTIException& ex)
-            {
-               throw RTIException("Error getting dimension handle \"" + dimension->mName + "\": " + ex.ToString(), __FILE__, __LINE__);
-            }
+            dimHandleSet.insert(&GetDDMDimensionHandle(dimension->mName));
          }
 
          r = mRTIAmbassador->CreateRegion(dimHandleSet);
@@ -2385,6 +2410,7 @@ namespace dtHLAGM
       if (r != NULL)
       {
          RTIDimensionVector regionDimensions;
+         regionDimensions.reserve(regionData.GetNumberOfExtents());
          for (unsigned i = 0; i < regionData.GetNumberOfExtents(); ++i)
          {
             const DDMRegionData::DimensionValues* dimension = regionData.GetDimensionValue(i);
@@ -2395,33 +2421,49 @@ namespace dtHLAGM
                continue;
             }
 
-            try
-            {
-               RTIDimensionData dimData;
-               dimData.mDimHandle = mRTIAmbassador->GetDimensionHandle(dimension->mName);
-
-               dimData.mMin = dimension->mMin;
-               dimData.mMax = dimension->mMax;
-            }
-            catch (const RTIException& ex)
-            {
-               throw RTIException("Error getting dimension handle \"" + dimension->mName + "\": " + ex.ToString(), __FILE__, __LINE__);
-            }
+            RTIDimensionData dimData;
+            dimData.mDimHandle = &GetDDMDimensionHandle(dimension->mName);
+            dimData.mMin = dimension->mMin;
+            dimData.mMax = dimension->mMax;
+            regionDimensions.push_back(dimData);
          }
          mRTIAmbassador->SetRegionDimensions(*r, regionDimensions);
+
+         try
+         {
+            mRTIAmbassador->CommitRegionChanges(*r);
+         }
+         catch (const RTIException& ex)
+         {
+            throw RTIException("Error updating region: " + ex.ToString(), __FILE__, __LINE__);
+         }
       }
+   }
 
-      if (regionData.GetRegion() != NULL)
+   /////////////////////////////////////////////////////////////////////////////////
+   RTIDimensionHandle& HLAComponent::GetDDMDimensionHandle(const std::string& name)
+   {
+      std::map<std::string, dtCore::RefPtr<RTIDimensionHandle> >::iterator i = mDDMDimensionHandles.find(name);
+      if (i == mDDMDimensionHandles.end())
       {
+         dtCore::RefPtr<RTIDimensionHandle> dimHandle;
          try
          {
-            mRTIAmbassador->CommitRegionChanges(*regionData.GetRegion());
+            dimHandle = mRTIAmbassador->GetDimensionHandle(name);
          }
          catch (const RTIException& ex)
          {
-            throw RTIException("Error updating region: " + ex.ToString(), __FILE__, __LINE__);
+            throw RTIException("Error getting dimension handle \"" + name + "\": " + ex.ToString(), __FILE__, __LINE__);
          }
+
+         if (!dimHandle.valid())
+         {
+            throw RTIException("The RTI returned no dimension handle for \"" + name + "\"", __FILE__, __LINE__);
+         }
+
+         i = mDDMDimensionHandles.insert(std::make_pair(name, dimHandle)).first;
       }
+      return *i->second;
    }
 
    /////////////////////////////////////////////////////////////////////////////////
@@ -2461,27 +2503,40 @@ namespace dtHLAGM
    }
 
    /////////////////////////////////////////////////////////////////////////////////
-   void HLAComponent::UpdateDDMSubscriptions()
+   void HLAComponent::UpdateDDMSubscriptions(double currentTime)
    {
-      for (unsigned i = 0; i < mDDMSubscriptionCalculators.GetSize(); ++i)
+      const double extentRange = double(DDMUtil::GetMaxExtent()) - double(DDMUtil::GetMinExtent());
+      const unsigned int threshold = unsigned(std::min(mDDMRegionUpdateThreshold * extentRange, double(UINT_MAX - 1U)));
+
+      for (unsigned i = 0; i < mDDMSubscriptionCalculators.GetSize() && i < mDDMSubscriptionRegions.size(); ++i)
       {
+         // Don't even ask the calculator if it was asked too recently.
+         if (i < mDDMNextUpdateTimes.size() && currentTime < mDDMNextUpdateTimes[i])
+         {
+            continue;
+         }
+
          DDMRegionCalculator& calc = *mDDMSubscriptionCalculators[i];
 
-         // if the region is actually changed.
-         if (mDDMSubscriptionRegions.size() > i)
+         if (i < mDDMNextUpdateTimes.size())
          {
-            std::vector<dtCore::RefPtr<DDMRegionData> >& regionVector = mDDMSubscriptionRegions[i];
-            for (unsigned j = 0; j < regionVector.size(); ++j)
+            mDDMNextUpdateTimes[i] = currentTime + std::max(mDDMMinTimeBetweenRegionUpdates, double(calc.GetMinTimeBetweenUpdates()));
+         }
+
+         std::vector<dtCore::RefPtr<DDMRegionData> >& regionVector = mDDMSubscriptionRegions[i];
+         for (unsigned j = 0; j < regionVector.size(); ++j)
+         {
+            DDMRegionData& data = *regionVector[j];
+            // The calculator reports changes against the last values it calculated, which may not have been
+            // sent to the RTI if they were within the threshold, so compare against the committed extents.
+            if (calc.UpdateRegionData(data) && data.GetChangeSinceCommit() > threshold)
             {
-               DDMRegionData& data = *regionVector[j];
-               if (calc.UpdateRegionData(data))
+               RTIRegion* r = data.GetRegion();
+               UpdateRegion(data);
+               data.MarkCommitted();
+               if (r != data.GetRegion())
                {
-                  RTIRegion* r = data.GetRegion();
-                  UpdateRegion(data);
-                  if (r != data.GetRegion())
-                  {
-                     // TODO subscribe with new region.
-                  }
+                  // TODO subscribe with new region.
                }
             }
          }
@@ -2499,6 +2554,8 @@ namespace dtHLAGM
       }
 
       mDDMSubscriptionRegions.resize(mDDMSubscriptionCalculators.GetSize());
+      mDDMNextUpdateTimes.clear();
+      mDDMNextUpdateTimes.resize(mDDMSubscriptionCalculators.GetSize(), 0.0);
 
       for (unsigned i = 0; i < mDDMSubscriptionCalculators.GetSize(); ++i)
       {
@@ -2512,6 +2569,7 @@ namespace dtHLAGM
                DDMRegionData& regionData = *regionVector[j];
                mDDMSubscriptionCalculators[i]->UpdateRegionData(regionData);
                UpdateRegion(regionData);
+               regionData.MarkCommitted();
             }
 
             mDDMSubscriptionRegions[i] = regionVector;
@@ -2601,6 +2659,7 @@ namespace dtHLAGM
          }
       }
       mDDMSubscriptionRegions.clear();
+      mDDMNextUpdateTimes.clear();
    }
 
    void HLAComponent::PrepareSingleUpdateParameter(AttributeToPropertyList& curAttrToProp,
@@ -3258,7 +3317,7 @@ namespace dtHLAGM
             {
                if (IsDDMEnabled())
                {
-                  UpdateDDMSubscriptions();
+                  UpdateDDMSubscriptions(double(GetGameManager()->GetRealClockTime()) / 1000000.0);
                }
                mRTIAmbassador->Tick();
             }
@@ -251,6 +251,20 @@ namespace dtNetGM
       SendNetworkMessage(*message, dtNetGM::NetworkComponent::DestinationType::ALL_NOT_CLIENTS);
    }
 
+   ////////////////////////////////////////////////////////////////////
+   void ClientNetworkComponent::SendInterestRegion(const osg::Vec3& position, float radius,
+            const osg::Vec3& viewDirection, float viewHalfAngle)
+   {
+      dtCore::RefPtr<dtGame::ClientInterestRegionMessage> message;
+      GetGameManager()->GetMessageFactory().CreateMessage(dtGame::MessageType::NETCLIENT_INTEREST_REGION, message);
+      message->SetDestination(GetServer());
+      message->SetPosition(position);
+      message->SetRadius(radius);
+      message->SetViewDirection(viewDirection);
+      message->SetViewHalfAngle(viewHalfAngle);
+      SendNetworkMessage(*message, dtNetGM::NetworkComponent::DestinationType::ALL_NOT_CLIENTS);
+   }
+
 
 
    ////////////////////////////////////////////////////////////////////
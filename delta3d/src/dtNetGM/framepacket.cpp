@@ -0,0 +1,130 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <dtNetGM/framepacket.h>
+#include <cstring>
+
+namespace dtNetGM
+{
+   FramePacket::FramePacket()
+      : GNE::Packet(FramePacket::ID)
+      , mSequence(0)
+      , mSequenced(0)
+      , mNumEntries(0)
+      , mPayloadSize(0)
+   {
+   }
+
+   FramePacket::FramePacket(const FramePacket& framePacket)
+      : GNE::Packet(FramePacket::ID)
+      , mSequence(framePacket.mSequence)
+      , mSequenced(framePacket.mSequenced)
+      , mNumEntries(framePacket.mNumEntries)
+      , mPayloadSize(framePacket.mPayloadSize)
+   {
+      memcpy(&mPayloadBuffer, &framePacket.mPayloadBuffer, mPayloadSize);
+   }
+
+   FramePacket::~FramePacket()
+   {
+   }
+
+   int FramePacket::getSize() const
+   {
+      int size = (GNE::Packet::getSize()
+         + GNE::Buffer::getSizeOf(mSequence)
+         + GNE::Buffer::getSizeOf(mSequenced)
+         + GNE::Buffer::getSizeOf(mNumEntries)
+         + GNE::Buffer::getSizeOf(mPayloadSize)
+         + mPayloadSize
+         );
+      return size;
+   }
+
+   void FramePacket::writePacket(GNE::Buffer& raw) const
+   {
+      GNE::Packet::writePacket(raw);
+      raw << mSequence;
+      raw << mSequenced;
+      raw << mNumEntries;
+      raw << mPayloadSize;
+      raw.writeRaw((GNE::gbyte*)&mPayloadBuffer, mPayloadSize);
+   }
+
+   void FramePacket::readPacket(GNE::Buffer& raw)
+   {
+      GNE::Packet::readPacket(raw);
+      raw >> mSequence;
+      raw >> mSequenced;
+      raw >> mNumEntries;
+      raw >> mPayloadSize;
+      if (mPayloadSize > MAX_PAYLOAD)
+      {
+         mPayloadSize = 0;
+         mNumEntries = 0;
+         return;
+      }
+      raw.readRaw((GNE::gbyte*)&mPayloadBuffer, mPayloadSize);
+   }
+
+   bool FramePacket::AddEntry(const char* data, unsigned size)
+   {
+      if (size == 0 || mNumEntries == 255 || unsigned(mPayloadSize) + 2U + size > unsigned(MAX_PAYLOAD))
+      {
+         return false;
+      }
+
+      mPayloadBuffer[mPayloadSize] = GNE::gbyte(size & 0xFF);
+      mPayloadBuffer[mPayloadSize + 1] = GNE::gbyte((size >> 8) & 0xFF);
+      memcpy(&mPayloadBuffer[mPayloadSize + 2], data, size);
+      mPayloadSize += GNE::guint16(2 + size);
+      ++mNumEntries;
+      return true;
+   }
+
+   bool FramePacket::ReadEntry(unsigned& offset, const char*& data, unsigned& size) const
+   {
+      if (offset + 2U > unsigned(mPayloadSize))
+      {
+         return false;
+      }
+
+      size = unsigned(mPayloadBuffer[offset]) | (unsigned(mPayloadBuffer[offset + 1]) << 8);
+      if (size == 0 || offset + 2U + size > unsigned(mPayloadSize))
+      {
+         return false;
+      }
+
+      data = reinterpret_cast<const char*>(&mPayloadBuffer[offset + 2]);
+      offset += 2U + size;
+      return true;
+   }
+
+   bool FramePacket::IsNewerSequence(unsigned sequence, unsigned lastSequence)
+   {
+      GNE::guint16 diff = GNE::guint16(sequence - lastSequence);
+      return diff != 0 && diff < 0x8000;
+   }
+
+   void FramePacket::Clear()
+   {
+      mNumEntries = 0;
+      mPayloadSize = 0;
+   }
+}
@@ -25,9 +25,12 @@
 #include <dtNetGM/networkcomponent.h>
 #include <dtNetGM/datastreampacket.h>
 #include <dtGame/machineinfo.h>
+#include <dtGame/messagetype.h>
+#include <dtGame/actorupdatemessage.h>
 #include <dtUtil/stringutils.h>
 #include <gnelib.h>
 #include <dtUtil/log.h>
+#include <OpenThreads/ScopedLock>
 
 namespace dtNetGM
 {
@@ -38,7 +41,16 @@ namespace dtNetGM
       , mGneConnection(NULL)
       , mConnectedClient(false)
       , mLastStream(0)
+      , mNumBytesSent(0)
+      , mNumDataStreamsSent(0)
+      , mNumFramesSent(0)
+      , mNumStaleUpdatesDropped(0)
+      , mNumUpdatesHeld(0)
+      , mNextSequence(0)
+      , mNewestReceivedSequence(0)
    {
+      mSequencedFrame.SetSequenced(true);
+
       mMachineInfo->SetName("Not Connected");
       mMachineInfo->SetHostName("");
       mMachineInfo->SetIPAddress("");
@@ -84,6 +96,7 @@ namespace dtNetGM
       mNetworkComponent->OnDisconnect(*this);
 
       mConnectedClient = false;
+      ClearReceivedActors();
    }
 
    void NetworkBridge::Disconnect(int waitTime)
@@ -158,6 +171,11 @@ namespace dtNetGM
             }
          }
 
+         if (type == FramePacket::ID)
+         {
+            ReceiveFrame(*static_cast<FramePacket*>(next));
+         }
+
          // receive next of datastream packets, we have a reliable connection so packets are received and in correct order
          if (type == DataStreamPacket::ID)
          {
@@ -202,7 +220,7 @@ namespace dtNetGM
    void NetworkBridge::SendDataStream(dtUtil::DataStream& dataStream, bool allowBestEffort)
    {
       // Unreliable;
-      bool reliable = allowBestEffort && mGneConnection->getStats(0).openSockets == 0;
+      bool reliable = allowBestEffort && !HasUnreliableSocket();
 
       static unsigned int streamId = 0;
       // create packets
@@ -234,22 +252,278 @@ namespace dtNetGM
       unsigned int packetCount = qPackets.size();
 
       // send packets
-      if (IsNetworkConnected())
+      bool written = false;
+      while (!qPackets.empty())
       {
-         while (!qPackets.empty())
-         {
-            dtNetGM::DataStreamPacket packet = qPackets.front();
-            qPackets.pop();
+         dtNetGM::DataStreamPacket packet = qPackets.front();
+         qPackets.pop();
+
+         packet.SetPacketCount(packetCount);
 
-            packet.SetPacketCount(packetCount);
+         // write packet to reliable stream
+         written = WritePacket(packet, reliable);
+         if (!written)
+         {
+            break;
+         }
+      }
 
-            // write packet to reliable stream
-            mGneConnection->stream().writePacket(packet, reliable);
+      if (written)
+      {
+         {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mStatsMutex);
+            mNumBytesSent += dataStreamSize;
+            ++mNumDataStreamsSent;
          }
          LOG_DEBUG("Send DataStream[" + dtUtil::ToString(streamId) + "] in " + dtUtil::ToString(packetCount) + " packet(s) to " + GetHostDescription());
       }
    }
 
+   void NetworkBridge::QueueDataStream(dtUtil::DataStream& dataStream, bool sequenced)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mFrameMutex);
+
+      unsigned int dataStreamSize = dataStream.GetBufferSize();
+      if (dataStreamSize > unsigned(FramePacket::MAX_ENTRY_SIZE))
+      {
+         WriteFrame(mReliableFrame);
+         SendDataStream(dataStream, true);
+         return;
+      }
+
+      FramePacket& frame = sequenced ? mSequencedFrame : mReliableFrame;
+      if (!frame.AddEntry(dataStream.GetBuffer(), dataStreamSize))
+      {
+         WriteFrame(frame);
+         frame.AddEntry(dataStream.GetBuffer(), dataStreamSize);
+      }
+   }
+
+   void NetworkBridge::FlushFrames()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mFrameMutex);
+      WriteFrame(mReliableFrame);
+      WriteFrame(mSequencedFrame);
+   }
+
+   void NetworkBridge::WriteFrame(FramePacket& frame)
+   {
+      if (frame.IsEmpty())
+      {
+         return;
+      }
+
+      // The sequenced channel falls back to the reliable socket if the connection has no unreliable one.
+      bool reliable = true;
+      if (frame.IsSequenced())
+      {
+         reliable = !HasUnreliableSocket();
+         frame.SetSequence(mNextSequence++);
+      }
+
+      if (WritePacket(frame, reliable))
+      {
+         {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mStatsMutex);
+            mNumBytesSent += frame.GetPayloadSize();
+            mNumDataStreamsSent += frame.GetNumEntries();
+            ++mNumFramesSent;
+         }
+         LOG_DEBUG("Send frame with " + dtUtil::ToString(frame.GetNumEntries()) + " message(s) to " + GetHostDescription());
+      }
+
+      frame.Clear();
+   }
+
+   bool NetworkBridge::WritePacket(const GNE::Packet& packet, bool reliable)
+   {
+      if (!IsNetworkConnected())
+      {
+         return false;
+      }
+      mGneConnection->stream().writePacket(packet, reliable);
+      return true;
+   }
+
+   bool NetworkBridge::HasUnreliableSocket() const
+   {
+      return mGneConnection != NULL && mGneConnection->getStats(0).openSockets != 0;
+   }
+
+   void NetworkBridge::ReceiveFrame(const FramePacket& frame)
+   {
+      // Frames are not dropped as a whole.  Each update in a frame only loses the values a newer frame already set.
+      unsigned long long sequence = 0;
+      if (frame.IsSequenced())
+      {
+         if (mNewestReceivedSequence == 0)
+         {
+            // Start above 0, which means the reliable channel, and far enough up that older frames stay above it too.
+            sequence = 0x10000ULL + frame.GetSequence();
+         }
+         else
+         {
+            short delta = short(GNE::guint16(frame.GetSequence() - (mNewestReceivedSequence & 0xFFFFU)));
+            sequence = (unsigned long long)((long long)mNewestReceivedSequence + delta);
+         }
+
+         if (sequence > mNewestReceivedSequence)
+         {
+            mNewestReceivedSequence = sequence;
+         }
+      }
+
+      unsigned offset = 0;
+      const char* data = NULL;
+      unsigned size = 0;
+      while (frame.ReadEntry(offset, data, size))
+      {
+         // Wraps the packet buffer without copying it.
+         dtUtil::DataStream entryStream(const_cast<char*>(data), size, false);
+         mNetworkComponent->OnReceivedDataStream(*this, entryStream, sequence);
+      }
+   }
+
+   bool NetworkBridge::SequenceReceivedMessage(dtGame::Message& message, unsigned long long sequence, MessageVector& released)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mReceivedMutex);
+
+      const dtGame::MessageType& type = message.GetMessageType();
+      if (type == dtGame::MessageType::INFO_ACTOR_DELETED)
+      {
+         // Anything held is about the deleted actor, and a new one with the same id starts over.
+         mReceivedActors.erase(message.GetAboutActorId());
+         return true;
+      }
+
+      if (type != dtGame::MessageType::INFO_ACTOR_CREATED && type != dtGame::MessageType::INFO_ACTOR_UPDATED)
+      {
+         return true;
+      }
+
+      dtGame::ActorUpdateMessage& update = static_cast<dtGame::ActorUpdateMessage&>(message);
+      ReceivedActorState& state = mReceivedActors[message.GetAboutActorId()];
+      bool partial = type == dtGame::MessageType::INFO_ACTOR_UPDATED && update.IsPartialUpdate();
+
+      if (sequence != 0)
+      {
+         std::vector<const dtGame::MessageParameter*> params;
+         update.GetUpdateParameters(params);
+
+         std::vector<dtUtil::RefString> staleNames;
+         for (size_t i = 0; i < params.size(); ++i)
+         {
+            unsigned long long& lastSequence = state.mPropertySequences[params[i]->GetName()];
+            if (lastSequence > sequence)
+            {
+               staleNames.push_back(params[i]->GetName());
+            }
+            else
+            {
+               lastSequence = sequence;
+            }
+         }
+
+         for (size_t i = 0; i < staleNames.size(); ++i)
+         {
+            update.RemoveUpdateParameter(staleNames[i]);
+         }
+
+         // A full update still creates the actor if it has to, so only partial ones are dropped.
+         if (partial && !params.empty() && staleNames.size() == params.size())
+         {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> statsLock(mStatsMutex);
+            ++mNumStaleUpdatesDropped;
+            return false;
+         }
+
+         if (partial && !state.mCreated)
+         {
+            // What this update sets is newer than anything held, so the held ones don't need it any more.
+            params.clear();
+            update.GetUpdateParameters(params);
+            for (size_t h = state.mHeldUpdates.size(); h > 0; --h)
+            {
+               dtGame::ActorUpdateMessage& held = *state.mHeldUpdates[h - 1];
+               for (size_t i = 0; i < params.size(); ++i)
+               {
+                  held.RemoveUpdateParameter(params[i]->GetName());
+               }
+
+               std::vector<const dtGame::MessageParameter*> heldParams;
+               held.GetUpdateParameters(heldParams);
+               if (heldParams.empty())
+               {
+                  state.mHeldUpdates.erase(state.mHeldUpdates.begin() + (h - 1));
+               }
+            }
+            state.mHeldUpdates.push_back(&update);
+
+            OpenThreads::ScopedLock<OpenThreads::Mutex> statsLock(mStatsMutex);
+            ++mNumUpdatesHeld;
+            return false;
+         }
+      }
+
+      if (!partial && !state.mCreated)
+      {
+         state.mCreated = true;
+         released.insert(released.end(), state.mHeldUpdates.begin(), state.mHeldUpdates.end());
+         state.mHeldUpdates.clear();
+      }
+
+      return true;
+   }
+
+   void NetworkBridge::ForgetReceivedActor(const dtCore::UniqueId& actorId)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mReceivedMutex);
+      mReceivedActors.erase(actorId);
+   }
+
+   void NetworkBridge::ClearReceivedActors()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mReceivedMutex);
+      mReceivedActors.clear();
+      mNewestReceivedSequence = 0;
+   }
+
+   size_t NetworkBridge::GetNumReceivedActors() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mReceivedMutex);
+      return mReceivedActors.size();
+   }
+
+   unsigned long long NetworkBridge::GetNumBytesSent() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mStatsMutex);
+      return mNumBytesSent;
+   }
+
+   unsigned long long NetworkBridge::GetNumDataStreamsSent() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mStatsMutex);
+      return mNumDataStreamsSent;
+   }
+
+   unsigned long long NetworkBridge::GetNumFramesSent() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mStatsMutex);
+      return mNumFramesSent;
+   }
+
+   unsigned long long NetworkBridge::GetNumStaleUpdatesDropped() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mStatsMutex);
+      return mNumStaleUpdatesDropped;
+   }
+
+   unsigned long long NetworkBridge::GetNumUpdatesHeld() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mStatsMutex);
+      return mNumUpdatesHeld;
+   }
+
    void NetworkBridge::OnFailure(GNE::Connection& conn, const GNE::Error& error)
    {
       // forward to NetworkComponent
@@ -23,6 +23,7 @@
 
 #include <dtNetGM/networkcomponent.h>
 #include <dtNetGM/datastreampacket.h>
+#include <dtNetGM/framepacket.h>
 //#include <dtNetGM/machineinfomessage.h>
 #include <dtNetGM/networkbridge.h>
 //#include <dtNetGM/serverframesyncmessage.h>
@@ -31,6 +32,7 @@
 #include <dtGame/messagetype.h>
 #include <dtGame/messagefactory.h>
 #include <dtGame/basemessages.h>
+#include <dtGame/actorupdatemessage.h>
 #include <dtUtil/log.h>
 #include <dtUtil/threadpool.h>
 #include <dtCore/system.h>
@@ -38,6 +40,8 @@
 #include <OpenThreads/ScopedLock>
 #include <OpenThreads/Atomic>
 
+#include <map>
+
 #include <dtCore/propertymacros.h>
 
 namespace dtNetGM
@@ -99,6 +103,8 @@ namespace dtNetGM
 
    NetworkComponent::NetworkComponent(dtCore::SystemComponentType& type)
    : dtGame::GMComponent(*TYPE)
+   , mCoalesceMessages(false)
+   , mSequencedActorUpdates(false)
    , mShuttingDown(false)
    , mReliable(true)
    , mRateOut(0)
@@ -107,6 +113,7 @@ namespace dtNetGM
    , mFrameSyncIsEnabled(false)
    , mFrameSyncNumPerSecond(60)
    , mFrameSyncMaxWaitTime(4.0f)
+   , mNumStaleUpdatesDropped(0)
    {
 
    }
@@ -117,6 +124,8 @@ namespace dtNetGM
    , mGameName(gameName)
    , mGameVersion(gameVersion)
    , mGNELogFile(logFile)
+   , mCoalesceMessages(false)
+   , mSequencedActorUpdates(false)
    , mShuttingDown(false)
    , mReliable(true)
    , mRateOut(0)
@@ -125,6 +134,7 @@ namespace dtNetGM
    , mFrameSyncIsEnabled(false)
    , mFrameSyncNumPerSecond(60)
    , mFrameSyncMaxWaitTime(4.0f)
+   , mNumStaleUpdatesDropped(0)
    {
       if (GetInstanceCount() == 0)
       {
@@ -144,6 +154,8 @@ namespace dtNetGM
    DT_IMPLEMENT_ACCESSOR(NetworkComponent, std::string, GameName);
    DT_IMPLEMENT_ACCESSOR(NetworkComponent, int, GameVersion);
    DT_IMPLEMENT_ACCESSOR(NetworkComponent, std::string, GNELogFile);
+   DT_IMPLEMENT_ACCESSOR(NetworkComponent, bool, CoalesceMessages);
+   DT_IMPLEMENT_ACCESSOR(NetworkComponent, bool, SequencedActorUpdates);
 
    ////////////////////////////////////////////////////////////////////////////////
    void NetworkComponent::BuildPropertyMap()
@@ -156,6 +168,8 @@ namespace dtNetGM
       DT_REGISTER_PROPERTY(GameName, "The Name of this game from the perspective or the networking.", RegHelperType, propReg);
       DT_REGISTER_PROPERTY(GameVersion, "The version this game from the perspective or the networking.", RegHelperType, propReg);
       DT_REGISTER_PROPERTY(GNELogFile, "The log file for the GNE networking library.", RegHelperType, propReg);
+      DT_REGISTER_PROPERTY(CoalesceMessages, "Pack outgoing messages into frames per connection and send them once per tick.", RegHelperType, propReg);
+      DT_REGISTER_PROPERTY(SequencedActorUpdates, "Send only the newest actor updates on a sequenced, possibly unreliable, channel.  Needs CoalesceMessages.", RegHelperType, propReg);
    }
 
    ////////////////////////////////////////////////////////////////////////////////
@@ -250,6 +264,14 @@ namespace dtNetGM
       {
          ProcessNetServerRejectMessage(static_cast<const dtGame::ServerMessageRejected&>(message));
       }
+      else if (message.GetMessageType() == dtGame::MessageType::NETCLIENT_INTEREST_REGION)
+      {
+         ProcessNetClientInterestRegion(static_cast<const dtGame::ClientInterestRegionMessage&>(message));
+      }
+      else if (message.GetMessageType() == dtGame::MessageType::INFO_ACTOR_DELETED)
+      {
+         ForgetReceivedActor(message.GetAboutActorId());
+      }
       else if (message.GetMessageType() == dtGame::MessageType::INFO_MAP_CHANGE_BEGIN)
       {
          mMapChangeInProcess = true;
@@ -373,6 +395,7 @@ namespace dtNetGM
 
          // and of course register the new DataStreamPacket!!!!!!!!!
          GNE::PacketParser::defaultRegisterPacket<DataStreamPacket>();
+         GNE::PacketParser::defaultRegisterPacket<FramePacket>();
 
          mGneInitialized = true;
       }
@@ -410,6 +433,17 @@ namespace dtNetGM
       LOGN_WARNING("dtNetGM","Connection not found! " + machineInfo.GetName() + " [" + machineInfo.GetHostName()+ "]");
    }
 
+   ////////////////////////////////////////////////////////////////////////////////
+   void NetworkComponent::ForgetReceivedActor(const dtCore::UniqueId& actorId)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+      for (std::vector<NetworkBridge*>::iterator iter = mConnections.begin(); iter != mConnections.end(); iter++)
+      {
+         (*iter)->ForgetReceivedActor(actorId);
+      }
+   }
+
    ////////////////////////////////////////////////////////////////////////////////
    const dtGame::MachineInfo* NetworkComponent::GetMachineInfo(const dtCore::UniqueId& uniqueId)
    {
@@ -535,7 +569,7 @@ namespace dtNetGM
    }
 
    ////////////////////////////////////////////////////////////////////////////////
-   void NetworkComponent::OnReceivedDataStream(NetworkBridge& networkBridge, dtUtil::DataStream& dataStream)
+   void NetworkComponent::OnReceivedDataStream(NetworkBridge& networkBridge, dtUtil::DataStream& dataStream, unsigned long long sequence)
    {
       if (IsShuttingDown() || GetGameManager() == NULL)
       {
@@ -582,8 +616,18 @@ namespace dtNetGM
       message = CreateMessage(dataStream, networkBridge);
       if (message.valid())
       {
-         OnReceivedNetworkMessage(*message, networkBridge);
-         ForwardMessage(*message, networkBridge);
+         NetworkBridge::MessageVector released;
+         if (networkBridge.SequenceReceivedMessage(*message, sequence, released))
+         {
+            OnReceivedNetworkMessage(*message, networkBridge);
+            ForwardMessage(*message, networkBridge);
+         }
+
+         for (size_t i = 0; i < released.size(); ++i)
+         {
+            OnReceivedNetworkMessage(*released[i], networkBridge);
+            ForwardMessage(*released[i], networkBridge);
+         }
       }
    }
 
@@ -603,7 +647,8 @@ namespace dtNetGM
          for (std::vector<dtNetGM::NetworkBridge*>::iterator iter = mConnections.begin(); iter != mConnections.end(); iter++)
          {
             dtNetGM::NetworkBridge* bridge = *iter;
-            if (bridge != &networkBridge && bridge->IsConnectedClient() && bridge->GetMachineInfo() != message.GetSource())
+            if (bridge != &networkBridge && bridge->IsConnectedClient() && bridge->GetMachineInfo() != message.GetSource()
+                  && ShouldSendToConnection(message, *bridge))
             {
                bridge->SendDataStream(dataStreamFwd, true);
             }
@@ -666,7 +711,8 @@ namespace dtNetGM
 
       AddMessageToOutputBuffer(message);
 
-      if (mMessageBufferOut.size() > 5)
+      // When coalescing, everything waits for the end of the tick so it can be packed into as few frames as possible.
+      if (!GetCoalesceMessages() && mMessageBufferOut.size() > 5)
       {
          StartSendTask();
       }
@@ -692,6 +738,12 @@ namespace dtNetGM
    /////////////////////////////////////////////////////////////
    void NetworkComponent::SendNetworkMessages(MessageBufferType& messageBuffer)
    {
+      bool coalesce = GetCoalesceMessages();
+      if (coalesce && GetSequencedActorUpdates())
+      {
+         DropStaleActorUpdates(messageBuffer);
+      }
+
       MessageBufferType::iterator i, iend;
       i = messageBuffer.begin();
       iend = messageBuffer.end();
@@ -708,12 +760,12 @@ namespace dtNetGM
             if (message.GetMessageType() == dtGame::MessageType::NETCLIENT_REQUEST_CONNECTION)
             {
                // This message should be send to connections which are not clients!
-               SendNetworkMessage(message, DestinationType::ALL_NOT_CLIENTS);
+               SendOrQueueNetworkMessage(message, DestinationType::ALL_NOT_CLIENTS, coalesce);
             }
             else
             {
                // Send message to all ClientConnections, default behavior for null destination!
-               SendNetworkMessage(message, DestinationType::ALL_CLIENTS);
+               SendOrQueueNetworkMessage(message, DestinationType::ALL_CLIENTS, coalesce);
             }
          }
          else
@@ -721,14 +773,109 @@ namespace dtNetGM
             // trying to send a message across the network to ourselves
             if (*message.GetDestination() != GetGameManager()->GetMachineInfo())
             {
-               SendNetworkMessage(message);
+               SendOrQueueNetworkMessage(message, DestinationType::DESTINATION, coalesce);
+            }
+         }
+      }
+
+      if (coalesce)
+      {
+         FlushFrames();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////
+   void NetworkComponent::DropStaleActorUpdates(MessageBufferType& messageBuffer)
+   {
+      // Walk backward so the first update seen for a key is the newest one.
+      typedef std::map<dtCore::UniqueId, std::set<std::string> > SentUpdateMap;
+      SentUpdateMap newerUpdates;
+      std::vector<const dtGame::MessageParameter*> params;
+      std::string key;
+
+      std::vector<bool> keep(messageBuffer.size(), true);
+      size_t numDropped = 0;
+
+      for (size_t idx = messageBuffer.size(); idx > 0; --idx)
+      {
+         const dtGame::Message& message = *messageBuffer[idx - 1];
+         const dtGame::MessageType& type = message.GetMessageType();
+
+         if (type == dtGame::MessageType::INFO_ACTOR_CREATED || type == dtGame::MessageType::INFO_ACTOR_DELETED)
+         {
+            // Never let an update jump over a create or delete.
+            newerUpdates.erase(message.GetAboutActorId());
+         }
+         else if (type == dtGame::MessageType::INFO_ACTOR_UPDATED && message.GetDestination() == NULL)
+         {
+            const dtGame::ActorUpdateMessage& updateMessage = static_cast<const dtGame::ActorUpdateMessage&>(message);
+
+            key = updateMessage.IsPartialUpdate() ? "P" : "F";
+            params.clear();
+            updateMessage.GetUpdateParameters(params);
+            for (size_t p = 0; p < params.size(); ++p)
+            {
+               key += ':';
+               key += params[p]->GetName().Get();
+            }
+
+            if (!newerUpdates[message.GetAboutActorId()].insert(key).second)
+            {
+               keep[idx - 1] = false;
+               ++numDropped;
             }
          }
       }
+
+      if (numDropped > 0)
+      {
+         MessageBufferType kept;
+         for (size_t idx = 0; idx < messageBuffer.size(); ++idx)
+         {
+            if (keep[idx])
+            {
+               kept.push_back(messageBuffer[idx]);
+            }
+         }
+         messageBuffer.swap(kept);
+
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         mNumStaleUpdatesDropped += numDropped;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////
+   unsigned long long NetworkComponent::GetNumStaleUpdatesDropped() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return mNumStaleUpdatesDropped;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void NetworkComponent::FlushFrames()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+      for (std::vector<NetworkBridge*>::iterator iter = mConnections.begin(); iter != mConnections.end(); iter++)
+      {
+         (*iter)->FlushFrames();
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void NetworkComponent::QueueNetworkMessage(const dtGame::Message& message, const DestinationType& destinationType)
+   {
+      SendOrQueueNetworkMessage(message, destinationType, true);
    }
 
    ////////////////////////////////////////////////////////////////////////////////
    void NetworkComponent::SendNetworkMessage(const dtGame::Message& message, const DestinationType& destinationType)
+   {
+      SendOrQueueNetworkMessage(message, destinationType, false);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void NetworkComponent::SendOrQueueNetworkMessage(const dtGame::Message& message, const DestinationType& destinationType, bool queue)
    {
       OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
 
@@ -740,13 +887,22 @@ namespace dtNetGM
       // Create the MessageDataStream
       dtUtil::DataStream dataStream = CreateDataStream(message);
 
+      bool sequenced = queue && GetSequencedActorUpdates() && message.GetMessageType() == dtGame::MessageType::INFO_ACTOR_UPDATED;
+
       if (destinationType == DestinationType::DESTINATION)
       {
          for (std::vector<NetworkBridge*>::iterator iter = mConnections.begin(); iter != mConnections.end(); iter++)
          {
             if ((*iter)->GetMachineInfo() == *(message.GetDestination()))
             {
-               (*iter)->SendDataStream(dataStream, true);
+               if (queue)
+               {
+                  (*iter)->QueueDataStream(dataStream, sequenced);
+               }
+               else
+               {
+                  (*iter)->SendDataStream(dataStream, true);
+               }
                return;
             }
          }
@@ -757,9 +913,16 @@ namespace dtNetGM
          {
             for (std::vector<NetworkBridge*>::iterator iter = mConnections.begin(); iter != mConnections.end(); iter++)
             {
-               if ((*iter)->IsConnectedClient())
+               if ((*iter)->IsConnectedClient() && ShouldSendToConnection(message, **iter))
                {
-                  (*iter)->SendDataStream(dataStream, true);
+                  if (queue)
+                  {
+                     (*iter)->QueueDataStream(dataStream, sequenced);
+                  }
+                  else
+                  {
+                     (*iter)->SendDataStream(dataStream, true);
+                  }
                }
             }
          } // DestinationType::ALL_CLIENTS
@@ -770,7 +933,14 @@ namespace dtNetGM
             {
                if (!(*iter)->IsConnectedClient())
                {
-                  (*iter)->SendDataStream(dataStream, true);
+                  if (queue)
+                  {
+                     (*iter)->QueueDataStream(dataStream, sequenced);
+                  }
+                  else
+                  {
+                     (*iter)->SendDataStream(dataStream, true);
+                  }
                }
             }
          } // DestinationType::ALL_NOT_CLIENTS
@@ -28,7 +28,11 @@
 #include <dtGame/basemessages.h>
 #include <dtGame/messagefactory.h>
 #include <dtGame/messagetype.h>
+#include <dtGame/gameactorproxy.h>
+#include <dtGame/actorupdatemessage.h>
 #include <dtCore/timer.h>
+#include <dtCore/transformable.h>
+#include <dtCore/transform.h>
 #include <dtUtil/mathdefines.h>
 #include <dtUtil/configproperties.h>
 
@@ -39,11 +43,14 @@ namespace dtNetGM
    const dtUtil::RefString ServerNetworkComponent::CONFIG_PROP_FRAMESYNC_ISENABLED("dtNetGM.FrameSyncIsEnabled");
    const dtUtil::RefString ServerNetworkComponent::CONFIG_PROP_FRAMESYNC_NUMPERSECOND("dtNetGM.FrameSyncNumPerSecond");
    const dtUtil::RefString ServerNetworkComponent::CONFIG_PROP_FRAMESYNC_MAXWAITTIME("dtNetGM.FrameSyncMaxWaitTime");
+   const dtUtil::RefString ServerNetworkComponent::CONFIG_PROP_OUT_OF_INTEREST_UPDATE_INTERVAL("dtNetGM.OutOfInterestUpdateInterval");
 
    ////////////////////////////////////////////////////////////////////////////////
    ServerNetworkComponent::ServerNetworkComponent(dtCore::SystemComponentType& type)
    : NetworkComponent(type)
    , mAcceptClients(true)
+   , mOutOfInterestUpdateInterval(1.0f)
+   , mNumUpdatesFiltered(0)
    {
    }
 
@@ -51,6 +58,8 @@ namespace dtNetGM
    ServerNetworkComponent::ServerNetworkComponent(const std::string& gameName, const int gameVersion, const std::string& logFile)
    : NetworkComponent(gameName, gameVersion, logFile)
    , mAcceptClients(true)
+   , mOutOfInterestUpdateInterval(1.0f)
+   , mNumUpdatesFiltered(0)
    {
       SetName(DEFAULT_NAME);
    }
@@ -103,6 +112,340 @@ namespace dtNetGM
 
       }
 
+      // INTEREST MANAGEMENT
+      std::string strOutOfInterestInterval = GetGameManager()->GetConfiguration().
+         GetConfigPropertyValue(CONFIG_PROP_OUT_OF_INTEREST_UPDATE_INTERVAL);
+      if (!strOutOfInterestInterval.empty())
+      {
+         SetOutOfInterestUpdateInterval(dtUtil::ToFloat(strOutOfInterestInterval));
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   DT_IMPLEMENT_ACCESSOR(ServerNetworkComponent, float, OutOfInterestUpdateInterval);
+
+   ////////////////////////////////////////////////////////////////////////////////
+   bool ServerNetworkComponent::ClientInterestRegion::Contains(const osg::Vec3& pos) const
+   {
+      osg::Vec3 offset = pos - mPosition;
+      float distance2 = offset.length2();
+      if (distance2 > mRadius * mRadius)
+      {
+         return false;
+      }
+
+      if (mViewDirection.length2() == 0.0f || mCosViewHalfAngle <= -1.0f)
+      {
+         return true;
+      }
+
+      // The angle between the offset and the view direction is within the half angle.
+      return offset * mViewDirection >= mCosViewHalfAngle * std::sqrt(distance2);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void ServerNetworkComponent::SetClientInterestRegion(const dtGame::MachineInfo& client, const osg::Vec3& position, float radius,
+            const osg::Vec3& viewDirection, float viewHalfAngle)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mInterestMutex);
+      if (radius <= 0.0f)
+      {
+         ClientInterestMap::iterator regionI = mClientInterest.find(client.GetUniqueId());
+         if (regionI != mClientInterest.end())
+         {
+            if (regionI->second.mFilteredProperties.empty())
+            {
+               mClientInterest.erase(regionI);
+            }
+            else
+            {
+               // Kept until CreateFilteredPropertyUpdates sends the values the client missed.
+               regionI->second.mRadius = 0.0f;
+            }
+         }
+      }
+      else
+      {
+         ClientInterestRegion& region = mClientInterest[client.GetUniqueId()];
+         region.mClient = &client;
+         region.mPosition = position;
+         region.mRadius = radius;
+         region.mViewDirection = viewDirection;
+         region.mViewDirection.normalize();
+         region.mCosViewHalfAngle = viewHalfAngle >= 180.0f ? -1.0f : std::cos(osg::DegreesToRadians(viewHalfAngle));
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   unsigned ServerNetworkComponent::GetNumClientInterestRegions() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mInterestMutex);
+      return unsigned(mClientInterest.size());
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void ServerNetworkComponent::RemoveClientInterestRegion(const dtGame::MachineInfo& client)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mInterestMutex);
+      mClientInterest.erase(client.GetUniqueId());
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   unsigned long long ServerNetworkComponent::GetNumUpdatesFiltered() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mInterestMutex);
+      return mNumUpdatesFiltered;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   unsigned long long ServerNetworkComponent::GetNumBytesSentToClients()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      unsigned long long result = 0;
+      for (unsigned i = 0; i < mConnections.size(); ++i)
+      {
+         result += mConnections[i]->GetNumBytesSent();
+      }
+      return result;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void ServerNetworkComponent::ProcessMessage(const dtGame::Message& message)
+   {
+      BaseClass::ProcessMessage(message);
+
+      // Local actors are tracked when published.  Remote ones are tracked here so forwarded updates can be filtered too.
+      if (message.GetSource() != GetGameManager()->GetMachineInfo()
+         || message.GetMessageType() == dtGame::MessageType::INFO_ACTOR_DELETED)
+      {
+         UpdatePublishedActorPosition(message);
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void ServerNetworkComponent::DispatchNetworkMessage(const dtGame::Message& message)
+   {
+      UpdatePublishedActorPosition(message);
+      BaseClass::DispatchNetworkMessage(message);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void ServerNetworkComponent::ProcessNetClientInterestRegion(const dtGame::ClientInterestRegionMessage& msg)
+   {
+      SetClientInterestRegion(msg.GetSource(), msg.GetPosition(), msg.GetRadius(), msg.GetViewDirection(), msg.GetViewHalfAngle());
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void ServerNetworkComponent::UpdatePublishedActorPosition(const dtGame::Message& message)
+   {
+      const dtGame::MessageType& type = message.GetMessageType();
+      if (type == dtGame::MessageType::INFO_ACTOR_DELETED)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mInterestMutex);
+         mPublishedActorPositions.erase(message.GetAboutActorId());
+         ClientInterestMap::iterator i, iend;
+         i = mClientInterest.begin();
+         iend = mClientInterest.end();
+         for (; i != iend; ++i)
+         {
+            i->second.mLastOutOfInterestSend.erase(message.GetAboutActorId());
+            i->second.mFilteredProperties.erase(message.GetAboutActorId());
+         }
+      }
+      else if (type == dtGame::MessageType::INFO_ACTOR_CREATED || type == dtGame::MessageType::INFO_ACTOR_UPDATED)
+      {
+         dtGame::GameActorProxy* actor = GetGameManager()->FindGameActorById(message.GetAboutActorId());
+         if (actor == NULL)
+         {
+            return;
+         }
+
+         dtCore::Transformable* xformable = actor->GetDrawable<dtCore::Transformable>();
+         if (xformable == NULL)
+         {
+            return;
+         }
+
+         dtCore::Transform xform;
+         xformable->GetTransform(xform, dtCore::Transformable::ABS_CS);
+         osg::Vec3 pos;
+         xform.GetTranslation(pos);
+
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mInterestMutex);
+         mPublishedActorPositions[message.GetAboutActorId()] = pos;
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   bool ServerNetworkComponent::ShouldSendToConnection(const dtGame::Message& message, NetworkBridge& networkBridge)
+   {
+      // Only partial updates are filtered.  Full updates carry state a client can't rebuild if it misses one.
+      if (message.GetMessageType() != dtGame::MessageType::INFO_ACTOR_UPDATED
+         || !static_cast<const dtGame::ActorUpdateMessage&>(message).IsPartialUpdate())
+      {
+         return true;
+      }
+      const dtGame::ActorUpdateMessage& update = static_cast<const dtGame::ActorUpdateMessage&>(message);
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mInterestMutex);
+
+      ClientInterestMap::iterator regionI = mClientInterest.find(networkBridge.GetMachineInfo().GetUniqueId());
+      if (regionI == mClientInterest.end())
+      {
+         return true;
+      }
+
+      ActorPositionMap::const_iterator posI = mPublishedActorPositions.find(message.GetAboutActorId());
+      if (posI == mPublishedActorPositions.end())
+      {
+         return true;
+      }
+
+      ClientInterestRegion& region = regionI->second;
+      if (region.mRadius <= 0.0f || region.Contains(posI->second))
+      {
+         return true;
+      }
+
+      std::vector<const dtGame::MessageParameter*> params;
+      update.GetUpdateParameters(params);
+
+      if (mOutOfInterestUpdateInterval > 0.0f)
+      {
+         const dtCore::Timer* timer = dtCore::Timer::Instance();
+         dtCore::Timer_t now = timer->Tick();
+
+         bool send = false;
+         dtUtil::HashMap<dtCore::UniqueId, dtCore::Timer_t>::iterator lastI = region.mLastOutOfInterestSend.find(message.GetAboutActorId());
+         if (lastI == region.mLastOutOfInterestSend.end())
+         {
+            region.mLastOutOfInterestSend.insert(std::make_pair(message.GetAboutActorId(), now));
+            send = true;
+         }
+         else if (timer->DeltaSec(lastI->second, now) >= double(mOutOfInterestUpdateInterval))
+         {
+            lastI->second = now;
+            send = true;
+         }
+
+         if (send)
+         {
+            // The values in this update no longer need to be caught up.
+            FilteredPropertyMap::iterator filteredI = region.mFilteredProperties.find(message.GetAboutActorId());
+            if (filteredI != region.mFilteredProperties.end())
+            {
+               for (size_t i = 0; i < params.size(); ++i)
+               {
+                  filteredI->second.erase(params[i]->GetName());
+               }
+               if (filteredI->second.empty())
+               {
+                  region.mFilteredProperties.erase(filteredI);
+               }
+            }
+            return true;
+         }
+      }
+
+      // Remember what was dropped so CreateFilteredPropertyUpdates can send the latest values later.
+      PropertyNameSet& filtered = region.mFilteredProperties[message.GetAboutActorId()];
+      for (size_t i = 0; i < params.size(); ++i)
+      {
+         filtered.insert(params[i]->GetName());
+      }
+
+      ++mNumUpdatesFiltered;
+      return false;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void ServerNetworkComponent::CreateFilteredPropertyUpdates(MessageBufferType& toFill)
+   {
+      struct FilteredUpdate
+      {
+         dtCore::RefPtr<const dtGame::MachineInfo> mClient;
+         dtCore::UniqueId mActorId;
+         std::vector<dtUtil::RefString> mPropertyNames;
+      };
+      std::vector<FilteredUpdate> filteredUpdates;
+
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mInterestMutex);
+
+         const dtCore::Timer* timer = dtCore::Timer::Instance();
+         dtCore::Timer_t now = timer->Tick();
+
+         ClientInterestMap::iterator regionI = mClientInterest.begin();
+         while (regionI != mClientInterest.end())
+         {
+            ClientInterestRegion& region = regionI->second;
+
+            FilteredPropertyMap::iterator filteredI = region.mFilteredProperties.begin();
+            while (filteredI != region.mFilteredProperties.end())
+            {
+               bool send = region.mRadius <= 0.0f;
+               if (!send)
+               {
+                  ActorPositionMap::const_iterator posI = mPublishedActorPositions.find(filteredI->first);
+                  if (posI == mPublishedActorPositions.end() || region.Contains(posI->second))
+                  {
+                     send = true;
+                  }
+                  else if (mOutOfInterestUpdateInterval > 0.0f)
+                  {
+                     dtUtil::HashMap<dtCore::UniqueId, dtCore::Timer_t>::iterator lastI = region.mLastOutOfInterestSend.find(filteredI->first);
+                     if (lastI == region.mLastOutOfInterestSend.end()
+                        || timer->DeltaSec(lastI->second, now) >= double(mOutOfInterestUpdateInterval))
+                     {
+                        region.mLastOutOfInterestSend[filteredI->first] = now;
+                        send = true;
+                     }
+                  }
+               }
+
+               if (send)
+               {
+                  filteredUpdates.push_back(FilteredUpdate());
+                  FilteredUpdate& filteredUpdate = filteredUpdates.back();
+                  filteredUpdate.mClient = region.mClient;
+                  filteredUpdate.mActorId = filteredI->first;
+                  filteredUpdate.mPropertyNames.assign(filteredI->second.begin(), filteredI->second.end());
+                  region.mFilteredProperties.erase(filteredI++);
+               }
+               else
+               {
+                  ++filteredI;
+               }
+            }
+
+            if (region.mRadius <= 0.0f)
+            {
+               mClientInterest.erase(regionI++);
+            }
+            else
+            {
+               ++regionI;
+            }
+         }
+      }
+
+      // Read the current values outside of the lock so the sending threads aren't held up.
+      for (size_t i = 0; i < filteredUpdates.size(); ++i)
+      {
+         FilteredUpdate& filteredUpdate = filteredUpdates[i];
+         dtGame::GameActorProxy* actor = GetGameManager()->FindGameActorById(filteredUpdate.mActorId);
+         if (actor == NULL)
+         {
+            continue;
+         }
+
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> update;
+         GetGameManager()->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, update);
+         actor->PopulateActorUpdate(*update, filteredUpdate.mPropertyNames);
+         update->SetPartialUpdate(true);
+         update->SetDestination(filteredUpdate.mClient.get());
+         toFill.push_back(update.get());
+      }
    }
 
    ////////////////////////////////////////////////////////////////////////////////
@@ -127,6 +470,13 @@ namespace dtNetGM
          AddMessageToOutputBuffer(*frameSync); // Note - should go to all clients
       }
 
+      MessageBufferType filteredUpdates;
+      CreateFilteredPropertyUpdates(filteredUpdates);
+      for (MessageBufferType::iterator i = filteredUpdates.begin(); i != filteredUpdates.end(); ++i)
+      {
+         AddMessageToOutputBuffer(**i);
+      }
+
       BaseClass::DoEndOfTick();
 
    }
@@ -234,6 +584,9 @@ namespace dtNetGM
          SendNetworkMessage(*machineMsg, DestinationType::ALL_CLIENTS);
       }
 
+      // Nothing filtered for the client needs to be caught up any more.
+      RemoveClientInterestRegion(networkBridge.GetMachineInfo());
+
       // remove Connection
       NetworkComponent::OnDisconnect(networkBridge);
    }
@@ -0,0 +1,440 @@
+/* -*-c++-*-
+ * dtPhysics
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#include <dtPhysics/cookedmeshcache.h>
+#include <dtPhysics/geometry.h>
+#include <dtPhysics/physicsreaderwriter.h>
+#include <dtPhysics/trianglerecorder.h>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/exception.h>
+#include <dtUtil/fileutils.h>
+#include <dtUtil/log.h>
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/NodeVisitor>
+#include <osg/Transform>
+#include <osg/TriangleFunctor>
+#include <osgDB/FileNameUtils>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace dtPhysics
+{
+   const std::string CookedMeshCache::FILE_EXTENSION(".dtphys");
+
+   static OpenThreads::Mutex gCookedMeshCacheMutex;
+   static std::string gCookedMeshCacheDirectory;
+
+   /////////////////////////////////////////////////
+   /// 64 bit FNV-1a hash used for the cache keys.
+   class CookedMeshKeyHash
+   {
+   public:
+      CookedMeshKeyHash()
+      : mHash(14695981039346656037ULL)
+      {
+      }
+
+      void Add(const void* data, size_t size)
+      {
+         const unsigned char* bytes = static_cast<const unsigned char*>(data);
+         for (size_t i = 0; i < size; ++i)
+         {
+            mHash ^= bytes[i];
+            mHash *= 1099511628211ULL;
+         }
+      }
+
+      template <typename T>
+      void Add(const T& value)
+      {
+         Add(&value, sizeof(T));
+      }
+
+      void Add(const std::string& value)
+      {
+         Add(unsigned(value.size()));
+         Add(value.data(), value.size());
+      }
+
+      void AddCookingParameters(bool polytope, Real maxEdgeLength)
+      {
+         Add(CookedMeshCache::COOKING_VERSION);
+         Add(polytope);
+         Add(maxEdgeLength);
+      }
+
+      std::string GetKey() const
+      {
+         std::ostringstream ss;
+         ss << std::hex << std::setw(16) << std::setfill('0') << mHash;
+         return ss.str();
+      }
+
+   private:
+      unsigned long long mHash;
+   };
+
+   /////////////////////////////////////////////////
+   /// Fallback for drawables that aren't osg::Geometry, hashes the triangles one at a time.
+   struct CookedMeshTriangleHash
+   {
+      CookedMeshTriangleHash()
+      : mHash(NULL)
+      {
+      }
+
+      void operator()(const osg::Vec3& v1, const osg::Vec3& v2, const osg::Vec3& v3, bool)
+      {
+         mHash->Add(v1);
+         mHash->Add(v2);
+         mHash->Add(v3);
+      }
+
+      CookedMeshKeyHash* mHash;
+   };
+
+   /////////////////////////////////////////////////
+   /// Hashes what the TriangleRecorderVisitor would read without recording any triangles.
+   class CookedMeshKeyVisitor : public osg::NodeVisitor
+   {
+   public:
+      CookedMeshKeyVisitor(CookedMeshKeyHash& hash)
+      : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ACTIVE_CHILDREN)
+      , mHash(hash)
+      {
+      }
+
+      void apply(osg::Billboard&) override
+      {
+         // The triangle recorder skips billboards.
+      }
+
+      void apply(osg::Geode& geode) override
+      {
+         const osg::NodePath& nodePath = getNodePath();
+         osg::Matrix localToWorld = osg::computeLocalToWorld(nodePath);
+         mHash.Add(localToWorld.ptr(), sizeof(osg::Matrix::value_type) * 16);
+
+         // The material comes from the nearest description, so wrappers without one don't change the key.
+         mHash.Add(GetNearestDescription(geode));
+         mHash.Add(geode.getName());
+
+         mHash.Add(geode.getNumDrawables());
+         for (unsigned i = 0; i < geode.getNumDrawables(); ++i)
+         {
+            const osg::Geometry* geometry = geode.getDrawable(i)->asGeometry();
+            if (geometry != NULL)
+            {
+               AddGeometry(*geometry);
+            }
+            else
+            {
+               osg::TriangleFunctor<CookedMeshTriangleHash> triangleHash;
+               triangleHash.mHash = &mHash;
+               geode.getDrawable(i)->accept(triangleHash);
+            }
+         }
+      }
+
+   private:
+      /// The same lookup as TriangleRecorderVisitor::CheckDescriptionInAncestors, the last description of the
+      /// geode or of the nearest ancestor that has one, following the first parent.
+      static std::string GetNearestDescription(const osg::Node& node)
+      {
+         const osg::Node* curNode = &node;
+         while (curNode != NULL)
+         {
+            if (curNode->getNumDescriptions() > 0)
+            {
+               return curNode->getDescription(curNode->getNumDescriptions() - 1);
+            }
+            curNode = curNode->getNumParents() > 0 ? curNode->getParent(0) : NULL;
+         }
+         return std::string();
+      }
+
+      void AddGeometry(const osg::Geometry& geometry)
+      {
+         const osg::Array* verts = geometry.getVertexArray();
+         if (verts != NULL)
+         {
+            mHash.Add(int(verts->getType()));
+            mHash.Add(verts->getTotalDataSize());
+            mHash.Add(verts->getDataPointer(), verts->getTotalDataSize());
+         }
+
+         mHash.Add(geometry.getNumPrimitiveSets());
+         for (unsigned i = 0; i < geometry.getNumPrimitiveSets(); ++i)
+         {
+            const osg::PrimitiveSet& primitives = *geometry.getPrimitiveSet(i);
+            mHash.Add(int(primitives.getType()));
+            mHash.Add(primitives.getMode());
+            mHash.Add(primitives.getNumIndices());
+
+            const osg::DrawArrays* drawArrays = dynamic_cast<const osg::DrawArrays*>(&primitives);
+            const osg::DrawArrayLengths* drawLengths = dynamic_cast<const osg::DrawArrayLengths*>(&primitives);
+            if (drawArrays != NULL)
+            {
+               mHash.Add(drawArrays->getFirst());
+            }
+            else if (drawLengths != NULL)
+            {
+               mHash.Add(drawLengths->getFirst());
+            }
+
+            // Empty for draw arrays, the lengths or the indices otherwise.
+            if (primitives.getTotalDataSize() > 0)
+            {
+               mHash.Add(primitives.getDataPointer(), primitives.getTotalDataSize());
+            }
+         }
+      }
+
+      CookedMeshKeyHash& mHash;
+   };
+
+   /////////////////////////////////////////////////
+   /// @return true for the compiled physics formats, which don't reference other files.
+   static bool IsCompiledPhysicsFile(const std::string& fileName)
+   {
+      std::string ext = osgDB::getLowerCaseFileExtension(fileName);
+      return ext == "dtphys" || ext == "phys";
+   }
+
+   /////////////////////////////////////////////////
+   /// Reads a model with the registry options, which loads the files it references too.
+   static dtCore::RefPtr<osg::Node> ReadModelFile(const std::string& fileName)
+   {
+      return dtUtil::FileUtils::GetInstance().ReadNode(fileName);
+   }
+
+   /////////////////////////////////////////////////
+   /// Hashes the bytes of the file along with the cooking parameters.
+   static std::string ComputeKeyForFileContents(const std::string& fileName, bool polytope, Real maxEdgeLength)
+   {
+      std::ifstream infile(fileName.c_str(), std::ios_base::binary | std::ios_base::in);
+      if (!infile.is_open())
+      {
+         return std::string();
+      }
+
+      CookedMeshKeyHash hash;
+      hash.AddCookingParameters(polytope, maxEdgeLength);
+
+      char buffer[65536];
+      while (infile.good())
+      {
+         infile.read(buffer, sizeof(buffer));
+         hash.Add(buffer, size_t(infile.gcount()));
+      }
+
+      if (infile.bad())
+      {
+         return std::string();
+      }
+      return hash.GetKey();
+   }
+
+   /////////////////////////////////////////////////
+   void CookedMeshCache::SetDirectory(const std::string& dir)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(gCookedMeshCacheMutex);
+      gCookedMeshCacheDirectory = dir;
+   }
+
+   /////////////////////////////////////////////////
+   std::string CookedMeshCache::GetDirectory()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(gCookedMeshCacheMutex);
+      return gCookedMeshCacheDirectory;
+   }
+
+   /////////////////////////////////////////////////
+   bool CookedMeshCache::IsEnabled()
+   {
+      return !GetDirectory().empty();
+   }
+
+   /////////////////////////////////////////////////
+   std::string CookedMeshCache::ComputeKey(const osg::Node& node, bool polytope, Real maxEdgeLength)
+   {
+      CookedMeshKeyHash hash;
+      hash.AddCookingParameters(polytope, maxEdgeLength);
+
+      CookedMeshKeyVisitor visitor(hash);
+      // sorry about the const cast.  The node SHOULD be const since we aren't changing it
+      // but accept doesn't work as const.
+      const_cast<osg::Node&>(node).accept(visitor);
+      return hash.GetKey();
+   }
+
+   /////////////////////////////////////////////////
+   std::string CookedMeshCache::ComputeKeyForFile(const std::string& fileName, bool polytope, Real maxEdgeLength)
+   {
+      if (IsCompiledPhysicsFile(fileName))
+      {
+         return ComputeKeyForFileContents(fileName, polytope, maxEdgeLength);
+      }
+
+      dtCore::RefPtr<osg::Node> model = ReadModelFile(fileName);
+      if (!model.valid())
+      {
+         return std::string();
+      }
+      return ComputeKey(*model, polytope, maxEdgeLength);
+   }
+
+   /////////////////////////////////////////////////
+   std::string CookedMeshCache::GetFilePath(const std::string& key)
+   {
+      return GetDirectory() + "/" + key + FILE_EXTENSION;
+   }
+
+   /////////////////////////////////////////////////
+   bool CookedMeshCache::Load(const std::string& key, VertexData& dataOut)
+   {
+      if (!IsEnabled() || key.empty())
+      {
+         return false;
+      }
+
+      std::string fileName = GetFilePath(key);
+      if (!dtUtil::FileUtils::GetInstance().FileExists(fileName))
+      {
+         return false;
+      }
+
+      dtCore::RefPtr<VertexData> loaded = new VertexData;
+      if (!PhysicsReaderWriter::LoadCompiledTriangleDataFile(*loaded, fileName) || loaded->mVertices.empty())
+      {
+         LOG_WARNING("Ignoring unreadable cooked mesh file: " + fileName);
+         return false;
+      }
+
+      dataOut.Swap(*loaded);
+      return true;
+   }
+
+   /////////////////////////////////////////////////
+   bool CookedMeshCache::Save(const std::string& key, const VertexData& data)
+   {
+      std::string dir = GetDirectory();
+      if (dir.empty() || key.empty())
+      {
+         return false;
+      }
+
+      dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+      std::string fileName = GetFilePath(key);
+      // Write to a uniquely named file first so another process never reads a partial entry.
+      std::string tempFileName = fileName + "." + dtCore::UniqueId().ToString() + ".tmp";
+      try
+      {
+         if (!fileUtils.DirExists(dir))
+         {
+            fileUtils.MakeDirectoryEX(dir);
+         }
+
+         if (!PhysicsReaderWriter::SaveTriangleDataFile(data, tempFileName))
+         {
+            return false;
+         }
+         fileUtils.FileMove(tempFileName, fileName, true);
+      }
+      catch (const dtUtil::Exception& ex)
+      {
+         ex.LogException(dtUtil::Log::LOG_WARNING);
+         return false;
+      }
+      return true;
+   }
+
+   /////////////////////////////////////////////////
+   bool CookedMeshCache::LoadFile(const std::string& fileName, bool polytope, VertexData& dataOut)
+   {
+      // A compiled physics file is already cooked unless it has to be made into a hull.
+      bool compiled = IsCompiledPhysicsFile(fileName);
+      bool cooked = !polytope && compiled;
+
+      // A model is read once, both to compute the key and, if it isn't cached, to record its triangles.
+      dtCore::RefPtr<osg::Node> model;
+      std::string key;
+      if (!cooked && IsEnabled())
+      {
+         TriangleRecorder recorder;
+         if (compiled)
+         {
+            key = ComputeKeyForFileContents(fileName, polytope, recorder.GetMaxEdgeLength());
+         }
+         else
+         {
+            model = ReadModelFile(fileName);
+            if (!model.valid())
+            {
+               return false;
+            }
+            key = ComputeKey(*model, polytope, recorder.GetMaxEdgeLength());
+         }
+
+         if (Load(key, dataOut))
+         {
+            return true;
+         }
+      }
+
+      dtCore::RefPtr<VertexData> readerData = new VertexData;
+      if (model.valid())
+      {
+         TriangleRecorder recorder;
+         recorder.Record(*model);
+         if (recorder.mData.empty() || recorder.mData.back()->mVertices.empty() || recorder.mData.back()->mIndices.empty())
+         {
+            return false;
+         }
+         readerData->mVertices = recorder.mData.back()->mVertices;
+         readerData->mIndices.swap(recorder.mData.back()->mIndices);
+         readerData->SwapMaterialTable(*recorder.mData.back());
+      }
+      else if (!PhysicsReaderWriter::LoadTriangleDataFile(*readerData, fileName))
+      {
+         return false;
+      }
+
+      dataOut.Swap(*readerData);
+      if (polytope)
+      {
+         dataOut.ConvertToPolytope();
+      }
+
+      if (!key.empty())
+      {
+         Save(key, dataOut);
+      }
+      return true;
+   }
+}
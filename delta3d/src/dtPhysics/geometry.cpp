@@ -28,6 +28,7 @@
 #include <dtPhysics/palutil.h>
 #include <dtPhysics/trianglerecorder.h>
 #include <dtPhysics/convexhull.h>
+#include <dtPhysics/cookedmeshcache.h>
 #include <dtUtil/exception.h>
 #include <dtUtil/mathdefines.h>
 
@@ -135,6 +136,17 @@ namespace dtPhysics
       if (newData)
       {
          TriangleRecorder tr;
+
+         std::string cookedKey;
+         if (CookedMeshCache::IsEnabled())
+         {
+            cookedKey = CookedMeshCache::ComputeKey(*nodeToParse, polytope, tr.GetMaxEdgeLength());
+            if (CookedMeshCache::Load(cookedKey, *dataOut))
+            {
+               return;
+            }
+         }
+
          tr.Record(*nodeToParse);
 
          // Using the last one is fine because we aren't splitting the data.
@@ -147,6 +159,11 @@ namespace dtPhysics
          {
             dataOut->ConvertToPolytope();
          }
+
+         if (!cookedKey.empty())
+         {
+            CookedMeshCache::Save(cookedKey, *dataOut);
+         }
       }
    }
 
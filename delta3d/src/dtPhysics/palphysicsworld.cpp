@@ -23,6 +23,7 @@
 #include <dtPhysics/physicsobject.h>
 #include <dtPhysics/collisioncontact.h>
 #include <dtPhysics/bodywrapper.h>
+#include <dtPhysics/cookedmeshcache.h>
 #include <dtPhysics/palutil.h>
 #include <dtPhysics/physicsmaterials.h>
 #include <dtPhysics/customraycastcallbacks.h>
@@ -284,6 +285,7 @@ namespace dtPhysics
    const std::string PhysicsWorld::CONFIG_TICKS_PER_SECOND("dtPhysics.TicksPerSecond");
    const std::string PhysicsWorld::CONFIG_DEBUG_DRAW_RANGE("dtPhysics.DebugDrawRange");
    const std::string PhysicsWorld::CONFIG_PRINT_ENGINE_PROPERTY_DOCUMENTATION("dtPhysics.PrintEnginePropertyDocumentation");
+   const std::string PhysicsWorld::CONFIG_COOKED_MESH_CACHE_DIRECTORY("dtPhysics.CookedMeshCacheDirectory");
 
 
    //////////////////////////////////////////////////////////////////////////
@@ -310,6 +312,12 @@ namespace dtPhysics
                CONFIG_PHYSICS_ENGINE, CONFIG_PHYSICS_ENGINE_DEFAULT);
       const std::string basePath = config.GetConfigPropertyValue(CONFIG_PAL_PLUGIN_PATH);
 
+      const std::string cookedMeshDir = config.GetConfigPropertyValue(CONFIG_COOKED_MESH_CACHE_DIRECTORY);
+      if (!cookedMeshDir.empty())
+      {
+         CookedMeshCache::SetDirectory(cookedMeshDir);
+      }
+
       mImpl = new PhysicsWorldImpl(engineToLoad, basePath);
       mImpl->mConfig = &config;
       Ctor();
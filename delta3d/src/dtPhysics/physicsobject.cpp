@@ -30,6 +30,7 @@
 #include <dtPhysics/physicsactcomp.h>
 #include <dtPhysics/palphysicsworld.h>
 #include <dtPhysics/bodywrapper.h>
+#include <dtPhysics/cookedmeshcache.h>
 #include <dtPhysics/geometry.h>
 #include <dtPhysics/physicsreaderwriter.h>
 #include <dtGame/gameactor.h>
@@ -610,20 +611,8 @@ namespace dtPhysics
 
          if (!fileToLoad.empty())
          {
-            dtCore::RefPtr<VertexData> readerData = new VertexData;
-
-            if (dtPhysics::PhysicsReaderWriter::LoadTriangleDataFile(*readerData, fileToLoad))
-            {
-               dtCore::Transform geometryWorld;
-               GetTransform(geometryWorld);
-
-               vertDataOut->Swap(*readerData);
-               if (polytope)
-               {
-                  vertDataOut->ConvertToPolytope();
-               }
-            }
-            else
+            // This reuses the cooked data from an earlier run if the file hasn't changed.
+            if (!CookedMeshCache::LoadFile(fileToLoad, polytope, *vertDataOut))
             {
                vertDataOut = nullptr;
                throw dtUtil::Exception("Unable to load triangle data from existing file resource: "
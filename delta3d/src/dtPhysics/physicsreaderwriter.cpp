@@ -411,6 +411,19 @@ namespace dtPhysics
       }
       return !triangleData.mVertices.empty();
    }
+
+   bool PhysicsReaderWriter::LoadCompiledTriangleDataFile(VertexData& triangleData, const std::string& filename)
+   {
+      std::ifstream infile(filename.c_str(), std::ios_base::binary | std::ios_base::in);
+      if (!infile.is_open())
+      {
+         return false;
+      }
+
+      dtCore::RefPtr<PhysicsOSGReaderWriterPlugin> readerWriter = new PhysicsOSGReaderWriterPlugin;
+      dtCore::RefPtr<PhysOptions> physOptions = new PhysOptions(triangleData, filename);
+      return readerWriter->LoadFile(infile, *physOptions);
+   }
   
    bool PhysicsReaderWriter::SaveTriangleDataFile(const VertexData& triangleData, const std::string& filename)
    {
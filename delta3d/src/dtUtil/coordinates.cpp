@@ -8,6 +8,11 @@
 #include <dtUtil/log.h>
 #include <dtUtil/stringutils.h>
 #include <dtUtil/mathdefines.h>
+#include <dtUtil/threadpool.h>
+#include <dtCore/refptr.h>
+
+#include <algorithm>
+#include <vector>
 
 namespace dtUtil
 {
@@ -122,6 +127,482 @@ namespace dtUtil
       return ((double) (TranMerc_a * (1.e0 - TranMerc_es) / pow(DENOM(Latitude), 3)));
    }
 
+   namespace
+   {
+      /////////////////////////////////////////////////////////////////////////////
+      void ComputeUTMZoneParameters(unsigned zone, bool south, UTMParameters& params)
+      {
+         double centralMeridian = 0.0;
+         if (zone >= 31)
+         {
+            centralMeridian = osg::DegreesToRadians(double(6 * zone - 183));
+         }
+         else
+         {
+            centralMeridian = osg::DegreesToRadians(double(6 * zone + 177));
+         }
+
+         // If we are projecting in the southern hemisphere, set the false northing.
+         double falseNorthing = south ? 10000000.0 : 0.0;
+
+         params.CalcTransverseMercatorParameters(Geocent_a, Geocent_f, 0.0,
+                  centralMeridian, 500000.0, falseNorthing, CentralMeridianScale);
+      }
+
+      /// The transverse mercator parameters for every UTM zone and hemisphere, computed once.
+      struct UTMZoneParameterTable
+      {
+         UTMZoneParameterTable()
+         {
+            for (unsigned zone = 1; zone <= 60; ++zone)
+            {
+               ComputeUTMZoneParameters(zone, false, mParams[zone - 1][0]);
+               ComputeUTMZoneParameters(zone, true, mParams[zone - 1][1]);
+            }
+         }
+
+         UTMParameters mParams[60][2];
+      };
+
+      /////////////////////////////////////////////////////////////////////////////
+      /// @return the shared parameters for the zone, or for a zone out of range, parameters computed into scratch.
+      const UTMParameters& GetUTMZoneParameters(unsigned zone, char hemisphere, UTMParameters& scratch)
+      {
+         bool south = hemisphere == 'S' || hemisphere == 's';
+         if (zone >= 1 && zone <= 60)
+         {
+            static const UTMZoneParameterTable table;
+            return table.mParams[zone - 1][south ? 1 : 0];
+         }
+
+         ComputeUTMZoneParameters(zone, south, scratch);
+         return scratch;
+      }
+
+      /////////////////////////////////////////////////////////////////////////////
+      /**
+       * Same as UTMParameters::SPHTMD, but it takes the sine and cosine of the latitude and
+       * gets the sines of the multiple angles from them rather than calling sin four more times.
+       */
+      inline double MeridionalDistance(const UTMParameters& params, double lat, double s, double c)
+      {
+         const double s2 = 2.0 * s * c;
+         const double c2 = c * c - s * s;
+         const double s4 = 2.0 * s2 * c2;
+         const double c4 = c2 * c2 - s2 * s2;
+         const double s6 = s4 * c2 + c4 * s2;
+         const double s8 = 2.0 * s4 * c4;
+         return params.TranMerc_ap * lat - params.TranMerc_bp * s2 + params.TranMerc_cp * s4
+                  - params.TranMerc_dp * s6 + params.TranMerc_ep * s8;
+      }
+
+      /////////////////////////////////////////////////////////////////////////////
+      /// A range of a batch conversion, so it can be split into thread pool tasks.
+      class CoordinateBatchKernel
+      {
+      public:
+         virtual ~CoordinateBatchKernel() {}
+         virtual void Run(unsigned begin, unsigned end) const = 0;
+      };
+
+      /////////////////////////////////////////////////////////////////////////////
+      class CoordinateBatchTask : public ThreadPoolTask
+      {
+      public:
+         CoordinateBatchTask(const CoordinateBatchKernel& kernel, unsigned begin, unsigned end)
+         : mKernel(kernel)
+         , mBegin(begin)
+         , mEnd(end)
+         {
+            SetName("CoordinateBatchTask");
+         }
+
+         void operator()() override
+         {
+            mKernel.Run(mBegin, mEnd);
+         }
+
+      protected:
+         ~CoordinateBatchTask() override {}
+
+      private:
+         const CoordinateBatchKernel& mKernel;
+         unsigned mBegin, mEnd;
+      };
+
+      /////////////////////////////////////////////////////////////////////////////
+      void RunBatch(const CoordinateBatchKernel& kernel, unsigned count, bool useThreadPool)
+      {
+         // Below this, the cost of the tasks is more than the work they save.
+         const unsigned minPerTask = 2048U;
+
+         // Waiting on the pool from one of its own workers could stall it, so that case runs serially.
+         unsigned numTasks = 1U;
+         if (useThreadPool && ThreadPool::IsInitialized() && !ThreadPool::IsWorkerThread()
+            && ThreadPool::GetNumImmediateWorkerThreads() > 1U)
+         {
+            numTasks = ThreadPool::GetNumImmediateWorkerThreads() * 2U;
+            numTasks = std::max(1U, std::min(numTasks, count / minPerTask));
+         }
+
+         if (numTasks == 1U)
+         {
+            kernel.Run(0U, count);
+            return;
+         }
+
+         std::vector<dtCore::RefPtr<CoordinateBatchTask> > tasks;
+         tasks.reserve(numTasks);
+         const unsigned perTask = (count + numTasks - 1) / numTasks;
+         for (unsigned begin = 0; begin < count; begin += perTask)
+         {
+            tasks.push_back(new CoordinateBatchTask(kernel, begin, std::min(count, begin + perTask)));
+         }
+
+         // Only wait on this batch's tasks, other code may have its own immediate tasks queued.
+         for (unsigned i = 1; i < tasks.size(); ++i)
+         {
+            ThreadPool::AddTask(*tasks[i]);
+         }
+
+         (*tasks[0])();
+
+         for (unsigned i = 1; i < tasks.size(); ++i)
+         {
+            tasks[i]->WaitUntilComplete();
+         }
+      }
+
+      /////////////////////////////////////////////////////////////////////////////
+      class GeocentricToGeodeticKernel : public CoordinateBatchKernel
+      {
+      public:
+         GeocentricToGeodeticKernel(const double* x, const double* y, const double* z,
+                  double* phi, double* lambda, double* elevation)
+         : mX(x), mY(y), mZ(z), mPhi(phi), mLambda(lambda), mElevation(elevation)
+         {
+         }
+
+         void Run(unsigned begin, unsigned end) const override
+         {
+            const double Geocent_b = Geocent_a * (1 - Geocent_f);
+            for (unsigned i = begin; i < end; ++i)
+            {
+               const double x = mX[i], y = mY[i], z = mZ[i];
+               double phi = 0.0, lambda = 0.0;
+               bool atPole = false;
+               if (x != 0.0)
+               {
+                  lambda = atan2(y, x);
+               }
+               else if (y > 0)
+               {
+                  lambda = osg::PI_2;
+               }
+               else if (y < 0)
+               {
+                  lambda = -osg::PI_2;
+               }
+               else
+               {
+                  atPole = true;
+                  if (z == 0.0)
+                  {
+                     // center of earth
+                     mPhi[i] = osg::PI_2;
+                     mLambda[i] = 0.0;
+                     mElevation[i] = -Geocent_b;
+                     continue;
+                  }
+                  phi = z > 0.0 ? osg::PI_2 : -osg::PI_2;
+               }
+
+               const double W2 = x*x + y*y;
+               const double W = sqrt(W2);
+               const double T0 = z * AD_C;
+               const double invS0 = 1.0 / sqrt(T0 * T0 + W2);
+               const double Sin_B0 = T0 * invS0;
+               const double Cos_B0 = W * invS0;
+               const double T1 = z + Geocent_b * Geocent_ep2 * Sin_B0 * Sin_B0 * Sin_B0;
+               const double Sum = W - Geocent_a * Geocent_e2 * Cos_B0 * Cos_B0 * Cos_B0;
+               const double invS1 = 1.0 / sqrt(T1*T1 + Sum * Sum);
+               const double Sin_p1 = T1 * invS1;
+               const double Cos_p1 = Sum * invS1;
+               const double Rn = Geocent_a / sqrt(1.0 - Geocent_e2 * Sin_p1 * Sin_p1);
+
+               double elevation;
+               if (Cos_p1 >= COS_67P5)
+               {
+                  elevation = W / Cos_p1 - Rn;
+               }
+               else if (Cos_p1 <= -COS_67P5)
+               {
+                  elevation = W / -Cos_p1 - Rn;
+               }
+               else
+               {
+                  elevation = z / Sin_p1 + Rn * (Geocent_e2 - 1.0);
+               }
+
+               if (!atPole)
+               {
+                  phi = atan(Sin_p1 / Cos_p1);
+               }
+
+               mPhi[i] = phi;
+               mLambda[i] = lambda;
+               mElevation[i] = elevation;
+            }
+         }
+
+      private:
+         const double* mX;
+         const double* mY;
+         const double* mZ;
+         double* mPhi;
+         double* mLambda;
+         double* mElevation;
+      };
+
+      /////////////////////////////////////////////////////////////////////////////
+      class GeodeticToGeocentricKernel : public CoordinateBatchKernel
+      {
+      public:
+         GeodeticToGeocentricKernel(const double* phi, const double* lambda, const double* elevation,
+                  double* x, double* y, double* z)
+         : mPhi(phi), mLambda(lambda), mElevation(elevation), mX(x), mY(y), mZ(z)
+         {
+         }
+
+         void Run(unsigned begin, unsigned end) const override
+         {
+            const double esqu = 2.0 * Geocent_f - Geocent_f*Geocent_f;
+            for (unsigned i = begin; i < end; ++i)
+            {
+               const double phi = mPhi[i], lambda = mLambda[i], elevation = mElevation[i];
+               const double sinPhi = sin(phi), cosPhi = cos(phi);
+               const double n = Geocent_a / sqrt(1.0 - esqu * sinPhi * sinPhi);
+               const double r = (n + elevation) * cosPhi;
+               mX[i] = r * cos(lambda);
+               mY[i] = r * sin(lambda);
+               mZ[i] = (n * (1.0 - esqu) + elevation) * sinPhi;
+            }
+         }
+
+      private:
+         const double* mPhi;
+         const double* mLambda;
+         const double* mElevation;
+         double* mX;
+         double* mY;
+         double* mZ;
+      };
+
+      /////////////////////////////////////////////////////////////////////////////
+      /// Coordinates::ConvertGeodeticToTransverseMercator with the UTM longitude handling, in Horner form.
+      class GeodeticToUTMKernel : public CoordinateBatchKernel
+      {
+      public:
+         GeodeticToUTMKernel(const UTMParameters& params, const double* lat, const double* lon,
+                  double* easting, double* northing)
+         : mParams(params), mLat(lat), mLon(lon), mEasting(easting), mNorthing(northing)
+         {
+         }
+
+         void Run(unsigned begin, unsigned end) const override
+         {
+            const UTMParameters& p = mParams;
+            const double a = p.TranMerc_a;
+            const double es = p.TranMerc_es;
+            const double ebs = p.TranMerc_ebs;
+            const double k = p.TranMerc_Scale_Factor;
+            const double tmdo = p.SPHTMD(p.TranMerc_Origin_Lat);
+
+            for (unsigned i = begin; i < end; ++i)
+            {
+               const double lat = mLat[i];
+               double lon = mLon[i];
+               if (lon < 0)
+               {
+                  lon += (2*osg::PI) + 1.0e-10;
+               }
+               if (lon > osg::PI)
+               {
+                  lon -= (2 * osg::PI);
+               }
+
+               double dlam = lon - p.TranMerc_Origin_Long;
+               if (dlam > osg::PI)
+               {
+                  dlam -= (2 * osg::PI);
+               }
+               if (dlam < -osg::PI)
+               {
+                  dlam += (2 * osg::PI);
+               }
+               if (std::abs(dlam) < 2.e-10)
+               {
+                  dlam = 0.0;
+               }
+               const double dl2 = dlam * dlam;
+
+               const double s = sin(lat);
+               const double c = cos(lat);
+               const double c2 = c * c;
+               const double c3 = c2 * c;
+               const double c5 = c3 * c2;
+               const double c7 = c5 * c2;
+               const double t = s / c;
+               const double tan2 = t * t;
+               const double tan4 = tan2 * tan2;
+               const double tan6 = tan4 * tan2;
+               const double eta = ebs * c2;
+               const double eta2 = eta * eta;
+               const double eta3 = eta2 * eta;
+               const double eta4 = eta3 * eta;
+
+               const double snk = k * a / sqrt(1.e0 - es * s * s);
+               const double tmd = MeridionalDistance(p, lat, s, c);
+
+               const double t1 = (tmd - tmdo) * k;
+               const double t2 = snk * s * c / 2.e0;
+               const double t3 = snk * s * c3 * (5.e0 - tan2 + 9.e0 * eta + 4.e0 * eta2) / 24.e0;
+               const double t4 = snk * s * c5 * (61.e0 - 58.e0 * tan2
+                        + tan4 + 270.e0 * eta - 330.e0 * tan2 * eta + 445.e0 * eta2
+                        + 324.e0 * eta3 -680.e0 * tan2 * eta2 + 88.e0 * eta4
+                        -600.e0 * tan2 * eta3 - 192.e0 * tan2 * eta4) / 720.e0;
+               const double t5 = snk * s * c7 * (1385.e0 - 3111.e0 * tan2 + 543.e0 * tan4 - tan6) / 40320.e0;
+
+               const double t6 = snk * c;
+               const double t7 = snk * c3 * (1.e0 - tan2 + eta) / 6.e0;
+               const double t8 = snk * c5 * (5.e0 - 18.e0 * tan2 + tan4
+                        + 14.e0 * eta - 58.e0 * tan2 * eta + 13.e0 * eta2 + 4.e0 * eta3
+                        - 64.e0 * tan2 * eta2 - 24.e0 * tan2 * eta3) / 120.e0;
+               const double t9 = snk * c7 * (61.e0 - 479.e0 * tan2 + 179.e0 * tan4 - tan6) / 5040.e0;
+
+               mNorthing[i] = p.TranMerc_False_Northing + t1 + dl2 * (t2 + dl2 * (t3 + dl2 * (t4 + dl2 * t5)));
+               mEasting[i] = p.TranMerc_False_Easting + dlam * (t6 + dl2 * (t7 + dl2 * (t8 + dl2 * t9)));
+            }
+         }
+
+      private:
+         const UTMParameters& mParams;
+         const double* mLat;
+         const double* mLon;
+         double* mEasting;
+         double* mNorthing;
+      };
+
+      /////////////////////////////////////////////////////////////////////////////
+      /// Coordinates::ConvertTransverseMercatorToGeodetic in Horner form.
+      class UTMToGeodeticKernel : public CoordinateBatchKernel
+      {
+      public:
+         UTMToGeodeticKernel(const UTMParameters& params, const double* easting, const double* northing,
+                  double* lat, double* lon)
+         : mParams(params), mEasting(easting), mNorthing(northing), mLat(lat), mLon(lon)
+         {
+         }
+
+         void Run(unsigned begin, unsigned end) const override
+         {
+            const UTMParameters& p = mParams;
+            const double a = p.TranMerc_a;
+            const double es = p.TranMerc_es;
+            const double ebs = p.TranMerc_ebs;
+            const double k = p.TranMerc_Scale_Factor;
+            const double k2 = k * k;
+            const double k3 = k2 * k;
+            const double k4 = k2 * k2;
+            const double k5 = k4 * k;
+            const double k6 = k4 * k2;
+            const double k7 = k6 * k;
+            const double k8 = k4 * k4;
+            const double tmdo = p.SPHTMD(p.TranMerc_Origin_Lat);
+            // The radius of curvature in the meridian is this over DENOM cubed.
+            const double srNumerator = a * (1.e0 - es);
+
+            for (unsigned i = begin; i < end; ++i)
+            {
+               const double easting = mEasting[i];
+               const double tmd = tmdo + (mNorthing[i] - p.TranMerc_False_Northing) / k;
+
+               // First Estimate
+               double ftphi = tmd / srNumerator;
+               for (unsigned j = 0; j < 5; ++j)
+               {
+                  const double s = sin(ftphi), c = cos(ftphi);
+                  const double denom = sqrt(1.e0 - es * s * s);
+                  const double sr = srNumerator / (denom * denom * denom);
+                  ftphi = ftphi + (tmd - MeridionalDistance(p, ftphi, s, c)) / sr;
+               }
+
+               const double s = sin(ftphi);
+               const double c = cos(ftphi);
+               const double denom = sqrt(1.e0 - es * s * s);
+               const double sr = srNumerator / (denom * denom * denom);
+               const double sn = a / denom;
+               const double sn3 = sn * sn * sn;
+               const double sn5 = sn3 * sn * sn;
+               const double sn7 = sn5 * sn * sn;
+
+               const double t = s / c;
+               const double tan2 = t * t;
+               const double tan4 = tan2 * tan2;
+               const double tan6 = tan4 * tan2;
+               const double eta = ebs * c * c;
+               const double eta2 = eta * eta;
+               const double eta3 = eta2 * eta;
+               const double eta4 = eta3 * eta;
+
+               double de = easting - p.TranMerc_False_Easting;
+               if (fabs(de) < 0.0001)
+               {
+                  de = 0.0;
+               }
+               const double de2 = de * de;
+
+               const double t10 = t / (2.e0 * sr * sn * k2);
+               const double t11 = t * (5.e0  + 3.e0 * tan2 + eta - 4.e0 * eta2
+                        - 9.e0 * tan2 * eta) / (24.e0 * sr * sn3 * k4);
+               const double t12 = t * (61.e0 + 90.e0 * tan2 + 46.e0 * eta + 45.E0 * tan4
+                        - 252.e0 * tan2 * eta  - 3.e0 * eta2 + 100.e0
+                        * eta3 - 66.e0 * tan2 * eta2 - 90.e0 * tan4
+                        * eta + 88.e0 * eta4 + 225.e0 * tan4 * eta2
+                        + 84.e0 * tan2* eta3 - 192.e0 * tan2 * eta4)
+                        / (720.e0 * sr * sn5 * k6);
+               const double t13 = t * (1385.e0 + 3633.e0 * tan2 + 4095.e0 * tan4 + 1575.e0 * tan6)
+                        / (40320.e0 * sr * sn7 * k8);
+
+               const double t14 = 1.e0 / (sn * c * k);
+               const double t15 = (1.e0 + 2.e0 * tan2 + eta) / (6.e0 * sn3 * c * k3);
+               const double t16 = (5.e0 + 6.e0 * eta + 28.e0 * tan2 - 3.e0 * eta2
+                        + 8.e0 * tan2 * eta + 24.e0 * tan4 - 4.e0
+                        * eta3 + 4.e0 * tan2 * eta2 + 24.e0
+                        * tan2 * eta3) / (120.e0 * sn5 * c * k5);
+               const double t17 = (61.e0 +  662.e0 * tan2 + 1320.e0 * tan4 + 720.e0 * tan6)
+                        / (5040.e0 * sn7 * c * k7);
+
+               mLat[i] = ftphi - de2 * (t10 - de2 * (t11 - de2 * (t12 - de2 * t13)));
+
+               double longitude = p.TranMerc_Origin_Long + de * (t14 - de2 * (t15 - de2 * (t16 - de2 * t17)));
+               if (longitude > osg::PI)
+               {
+                  longitude -= (2 * osg::PI);
+               }
+               mLon[i] = longitude;
+            }
+         }
+
+      private:
+         const UTMParameters& mParams;
+         const double* mEasting;
+         const double* mNorthing;
+         double* mLat;
+         double* mLon;
+      };
+   }
+
    IMPLEMENT_ENUM(IncomingCoordinateType)
    const IncomingCoordinateType IncomingCoordinateType::GEOCENTRIC("Geocentric");
    const IncomingCoordinateType IncomingCoordinateType::GEODETIC("Geodetic");
@@ -641,6 +1122,171 @@ namespace dtUtil
       lle[2] = xyz[2];
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   void Coordinates::ConvertGeocentricToGeodeticBatch(const double* x, const double* y, const double* z,
+            double* phi, double* lambda, double* elevation, unsigned count, bool useThreadPool)
+   {
+      RunBatch(GeocentricToGeodeticKernel(x, y, z, phi, lambda, elevation), count, useThreadPool);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Coordinates::GeodeticToGeocentricBatch(const double* phi, const double* lambda, const double* elevation,
+            double* x, double* y, double* z, unsigned count, bool useThreadPool)
+   {
+      RunBatch(GeodeticToGeocentricKernel(phi, lambda, elevation, x, y, z), count, useThreadPool);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Coordinates::ConvertGeodeticToUTMBatch(const double* latitude, const double* longitude, unsigned zone, char hemisphere,
+            double* easting, double* northing, unsigned count, bool useThreadPool)
+   {
+      UTMParameters scratch;
+      const UTMParameters& params = GetUTMZoneParameters(zone, hemisphere, scratch);
+      RunBatch(GeodeticToUTMKernel(params, latitude, longitude, easting, northing), count, useThreadPool);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Coordinates::ConvertUTMToGeodeticBatch(unsigned zone, char hemisphere, const double* easting, const double* northing,
+            double* latitude, double* longitude, unsigned count, bool useThreadPool)
+   {
+      UTMParameters scratch;
+      const UTMParameters& params = GetUTMZoneParameters(zone, hemisphere, scratch);
+      RunBatch(UTMToGeodeticKernel(params, easting, northing, latitude, longitude), count, useThreadPool);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Coordinates::ConvertLatLonToFlatEarthBatch(const double* latitude, const double* longitude, const osg::Vec2d& originll,
+            double convergenceParam, double* x, double* y, unsigned count)
+   {
+      // Simple enough that the compiler can vectorize it, and not worth the threads.
+      const double xScale = METERS_PER_DEGREE * convergenceParam;
+      const double originLat = originll[0], originLon = originll[1];
+      for (unsigned i = 0; i < count; ++i)
+      {
+         const double lat = latitude[i], lon = longitude[i];
+         x[i] = (lon - originLon) * xScale;
+         y[i] = (lat - originLat) * METERS_PER_DEGREE;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Coordinates::ConvertToLocalTranslationBatch(const double* loc0, const double* loc1, const double* loc2,
+            double* x, double* y, double* z, unsigned count, bool useThreadPool)
+   {
+      bool applyOffset = true;
+
+      // The intermediate results go straight into the output arrays, so each step below works in place.
+      if (*mLocalCoordinateType == LocalCoordinateType::GLOBE)
+      {
+         if (*mIncomingCoordinateType == IncomingCoordinateType::GEOCENTRIC)
+         {
+            const double scale = GetGlobeRadius() / semiMajorAxis;
+            for (unsigned i = 0; i < count; ++i)
+            {
+               x[i] = loc0[i] * scale;
+               y[i] = loc1[i] * scale;
+               z[i] = loc2[i] * scale;
+            }
+         }
+         else
+         {
+            LOGN_ERROR("coordinates.cpp", "With local coordinates in globe mode, only GEOCENTRIC coordinates types are supported.");
+            std::fill(x, x + count, 0.0);
+            std::fill(y, y + count, 0.0);
+            std::fill(z, z + count, 0.0);
+         }
+         applyOffset = false;
+      }
+      else if (*mLocalCoordinateType == LocalCoordinateType::CARTESIAN_UTM)
+      {
+         if (*mIncomingCoordinateType == IncomingCoordinateType::GEOCENTRIC)
+         {
+            ConvertGeocentricToGeodeticBatch(loc0, loc1, loc2, x, y, z, count, useThreadPool);
+            ConvertGeodeticToUTMBatch(x, y, mUTMZone, mUTMHemisphere, x, y, count, useThreadPool);
+         }
+         else if (*mIncomingCoordinateType == IncomingCoordinateType::GEODETIC)
+         {
+            for (unsigned i = 0; i < count; ++i)
+            {
+               x[i] = osg::DegreesToRadians(loc0[i]);
+               y[i] = osg::DegreesToRadians(loc1[i]);
+               z[i] = loc2[i];
+            }
+            ConvertGeodeticToUTMBatch(x, y, mUTMZone, mUTMHemisphere, x, y, count, useThreadPool);
+         }
+         else if (*mIncomingCoordinateType == IncomingCoordinateType::UTM)
+         {
+            std::copy(loc0, loc0 + count, x);
+            std::copy(loc1, loc1 + count, y);
+            std::copy(loc2, loc2 + count, z);
+         }
+      }
+      else if (*mLocalCoordinateType == LocalCoordinateType::CARTESIAN_FLAT_EARTH)
+      {
+         if (*mIncomingCoordinateType == IncomingCoordinateType::GEOCENTRIC)
+         {
+            ConvertGeocentricToGeodeticBatch(loc0, loc1, loc2, x, y, z, count, useThreadPool);
+            for (unsigned i = 0; i < count; ++i)
+            {
+               x[i] = osg::RadiansToDegrees(x[i]);
+               y[i] = osg::RadiansToDegrees(y[i]);
+            }
+            ConvertLatLonToFlatEarthBatch(x, y, mFlatEarthOrigin, mConvergence, x, y, count);
+         }
+         else if (*mIncomingCoordinateType == IncomingCoordinateType::GEODETIC)
+         {
+            ConvertLatLonToFlatEarthBatch(loc0, loc1, mFlatEarthOrigin, mConvergence, x, y, count);
+            std::copy(loc2, loc2 + count, z);
+         }
+         else if (*mIncomingCoordinateType == IncomingCoordinateType::UTM)
+         {
+            ConvertUTMToGeodeticBatch(mUTMZone, mUTMHemisphere, loc0, loc1, x, y, count, useThreadPool);
+            for (unsigned i = 0; i < count; ++i)
+            {
+               x[i] = osg::RadiansToDegrees(x[i]);
+               y[i] = osg::RadiansToDegrees(y[i]);
+            }
+            ConvertLatLonToFlatEarthBatch(x, y, mFlatEarthOrigin, mConvergence, x, y, count);
+            std::copy(loc2, loc2 + count, z);
+         }
+      }
+      else
+      {
+         LOGN_ERROR("coordinates.cpp", "Unsupported local coordinate mode: " + mLocalCoordinateType->GetName());
+         std::fill(x, x + count, 0.0);
+         std::fill(y, y + count, 0.0);
+         std::fill(z, z + count, 0.0);
+         applyOffset = false;
+      }
+
+      if (applyOffset)
+      {
+         const osg::Vec3d& offset = mLocalOffset;
+         for (unsigned i = 0; i < count; ++i)
+         {
+            x[i] -= offset.x();
+            y[i] -= offset.y();
+            z[i] -= offset.z();
+         }
+      }
+
+      for (unsigned i = 0; i < count; ++i)
+      {
+         if (!IsFinite(x[i]))
+         {
+            x[i] = 0.0;
+         }
+         if (!IsFinite(y[i]))
+         {
+            y[i] = 0.0;
+         }
+         if (!IsFinite(z[i]))
+         {
+            z[i] = 0.0;
+         }
+      }
+   }
+
    /////////////////////////////////////////////////////////////////////////////
    const osg::Vec3d Coordinates::ConvertToRemoteTranslation(const osg::Vec3& translation)
    {
@@ -1048,11 +1694,6 @@ namespace dtUtil
    void Coordinates::ConvertGeodeticToUTM (double Latitude, double Longitude,
                                            unsigned Zone, char Hemisphere, double& Easting, double& Northing)
    {
-      double Origin_Latitude = 0.0;
-      double Central_Meridian = 0.0;
-      double False_Easting = 500000;
-      double False_Northing = 0;
-
       // no errors
       if (Longitude < 0)
       {
@@ -1062,24 +1703,8 @@ namespace dtUtil
       //char nsZone;
       //CalculateUTMZone(osg::RadiansToDegrees(Latitude), osg::RadiansToDegrees(Longitude), Zone, nsZone);
 
-      if (Zone >= 31)
-      {
-         Central_Meridian = osg::DegreesToRadians(double(6 * Zone - 183));
-      }
-      else
-      {
-         Central_Meridian = osg::DegreesToRadians(double(6 * Zone + 177));
-      }
-
-      // If we are projecting in the southern hemisphere, set the false northing.
-      if (Hemisphere == 'S' || Hemisphere == 's')
-      {
-         False_Northing = 10000000;
-      }
-
-      UTMParameters params;
-      params.CalcTransverseMercatorParameters(Geocent_a, Geocent_f, Origin_Latitude,
-                                      Central_Meridian, False_Easting, False_Northing, CentralMeridianScale);
+      UTMParameters scratch;
+      const UTMParameters& params = GetUTMZoneParameters(Zone, Hemisphere, scratch);
       ConvertGeodeticToTransverseMercator(params, Latitude, Longitude, Easting, Northing);
    } // END OF Convert_Geodetic_To_UTM
 
@@ -1101,28 +1726,8 @@ namespace dtUtil
        *    Longitude         : Longitude in radians                   (output)
        */
 
-      double Origin_Latitude = 0;
-      double Central_Meridian = 0;
-      double False_Easting = 500000;
-      double False_Northing = 0;
-
-      if (zone >= 31)
-      {
-         Central_Meridian = ((6 * zone - 183) * osg::PI / 180.0 /*+ 0.00000005*/);
-      }
-      else
-      {
-         Central_Meridian = ((6 * zone + 177) * osg::PI / 180.0 /*+ 0.00000005*/);
-      }
-
-      if (hemisphere == 'S' || hemisphere == 's')
-      {
-         False_Northing = 10000000;
-      }
-
-      UTMParameters params;
-      params.CalcTransverseMercatorParameters(Geocent_a, Geocent_f, Origin_Latitude,
-                                      Central_Meridian, False_Easting, False_Northing, CentralMeridianScale);
+      UTMParameters scratch;
+      const UTMParameters& params = GetUTMZoneParameters(zone, hemisphere, scratch);
 
       ConvertTransverseMercatorToGeodetic(params, easting,northing,latitude,longitude);
    }
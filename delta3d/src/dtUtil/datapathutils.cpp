@@ -25,6 +25,8 @@
 #include <dtUtil/mswin.h>
 
 #include <dtUtil/fileutils.h>
+#include <dtUtil/filepathindex.h>
+#include <OpenThreads/Atomic>
 #include <osgDB/FileUtils>
 #include <osgDB/FileNameUtils>
 
@@ -44,6 +46,148 @@ namespace dtUtil
 {
    static OpenThreads::Mutex gDatapathMutex;
 
+   /// The indexes for the data file paths, in search order.  Immutable once published.
+   class DataPathIndexList : public osg::Referenced
+   {
+   public:
+      DataPathIndexList()
+      : mComplete(true)
+      {
+      }
+
+      std::vector<dtCore::RefPtr<FilePathIndex> > mIndexes;
+      /// false if some paths couldn't be indexed, in which case every search goes to osgDB.
+      bool mComplete;
+
+   protected:
+      ~DataPathIndexList() {}
+   };
+
+   // Searches read the list without taking gDatapathMutex.  Replaced lists are kept until no search is running.
+   static OpenThreads::AtomicPtr gDataPathIndexes;
+   static dtCore::RefPtr<DataPathIndexList> gDataPathIndexesRef;
+   static std::vector<dtCore::RefPtr<DataPathIndexList> > gRetiredDataPathIndexes;
+   static OpenThreads::Atomic gNumDataPathSearches;
+
+   /////////////////////////////////////////////////////////////////////////////
+   /// Rebuilds the data path indexes from osgDB's list.  Must be called with gDatapathMutex held.
+   static void RebuildDataPathIndexes()
+   {
+      dtCore::RefPtr<DataPathIndexList> newList = new DataPathIndexList;
+      const osgDB::FilePathList& pathList = osgDB::getDataFilePathList();
+      FileUtils& fileUtils = FileUtils::GetInstance();
+      for (osgDB::FilePathList::const_iterator i = pathList.begin(), iend = pathList.end(); i != iend; ++i)
+      {
+         // Relative paths depend on the current directory at the time of the search, so those can't be cached.
+         if (i->empty() || !fileUtils.IsAbsolutePath(*i))
+         {
+            newList->mComplete = false;
+            break;
+         }
+
+         dtCore::RefPtr<FilePathIndex> index = new FilePathIndex(*i);
+         // Keep the index for a path that was already in the list so what it has read isn't lost.
+         if (gDataPathIndexesRef.valid())
+         {
+            for (unsigned j = 0; j < gDataPathIndexesRef->mIndexes.size(); ++j)
+            {
+               if (gDataPathIndexesRef->mIndexes[j]->GetRootDirectory() == index->GetRootDirectory())
+               {
+                  index = gDataPathIndexesRef->mIndexes[j];
+                  break;
+               }
+            }
+         }
+
+         newList->mIndexes.push_back(index);
+      }
+
+      if (gNumDataPathSearches == 0)
+      {
+         gRetiredDataPathIndexes.clear();
+      }
+      if (gDataPathIndexesRef.valid())
+      {
+         gRetiredDataPathIndexes.push_back(gDataPathIndexesRef);
+      }
+      gDataPathIndexes.assign(newList.get(), gDataPathIndexesRef.get());
+      gDataPathIndexesRef = newList;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   /**
+    * Searches the data path indexes.
+    * @return false if the indexes can't answer for the file name and osgDB has to do the search.
+    */
+   static bool FindFileInDataPathIndexes(const std::string& fileName, std::string& filePathOut)
+   {
+      const DataPathIndexList* list = static_cast<const DataPathIndexList*>(gDataPathIndexes.get());
+      if (list == NULL || !list->mComplete)
+      {
+         return false;
+      }
+
+      std::vector<std::string> components;
+      if (!FilePathIndex::NormalizePath(fileName, components))
+      {
+         return false;
+      }
+
+      // osgDB checks the current directory before the data paths.  That's one stat, so do the same.
+      if (osgDB::fileExists(fileName))
+      {
+         return false;
+      }
+
+      // osgDB prefers a match with the exact case in any path over a case insensitive match in an earlier one.
+      std::string exactSuffix;
+      std::string component;
+      for (size_t i = 0; i <= fileName.size(); ++i)
+      {
+         char c = i < fileName.size() ? fileName[i] : '/';
+         if (c == '/' || c == '\\')
+         {
+            if (!component.empty() && component != ".")
+            {
+               exactSuffix += FileUtils::PATH_SEPARATOR;
+               exactSuffix += component;
+            }
+            component.clear();
+         }
+         else
+         {
+            component.push_back(c);
+         }
+      }
+
+      std::string path;
+      FileType type = FILE_NOT_FOUND;
+      for (unsigned i = 0; i < list->mIndexes.size(); ++i)
+      {
+         if (!list->mIndexes[i]->Find(fileName, path, type))
+         {
+            return false;
+         }
+
+         if (type == FILE_NOT_FOUND)
+         {
+            continue;
+         }
+
+         if (path.size() >= exactSuffix.size() && path.compare(path.size() - exactSuffix.size(), exactSuffix.size(), exactSuffix) == 0)
+         {
+            filePathOut = path;
+            break;
+         }
+         else if (filePathOut.empty())
+         {
+            filePathOut = path;
+         }
+      }
+
+      return true;
+   }
+
    std::string GetHomeDirectory()
    {
       std::string homedir;
@@ -100,6 +244,7 @@ namespace dtUtil
 #endif
       }
       osgDB::setDataFilePathList(modpath);
+      RebuildDataPathIndexes();
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -132,9 +277,19 @@ namespace dtUtil
    /////////////////////////////////////////////////////////////////////////////
    std::string FindFileInPathList(const std::string& fileName)
    {
+      std::string filePath;
+      ++gNumDataPathSearches;
+      bool indexed = FindFileInDataPathIndexes(fileName, filePath);
+      --gNumDataPathSearches;
+
+      if (indexed)
+      {
+         return filePath;
+      }
+
       OpenThreads::ScopedLock<OpenThreads::Mutex> lock(gDatapathMutex);
 
-      std::string filePath = osgDB::findDataFile(fileName, osgDB::CASE_INSENSITIVE);
+      filePath = osgDB::findDataFile(fileName, osgDB::CASE_INSENSITIVE);
 
       // In some cases, filePath will contain a url that is
       // relative to the current working directory so for
@@ -0,0 +1,645 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <prefix/dtutilprefix.h>
+#include <dtUtil/filepathindex.h>
+#include <dtUtil/hashmap.h>
+#include <dtUtil/stringutils.h>
+#include <OpenThreads/ScopedLock>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <ctime>
+
+#ifdef DELTA_WIN32
+#   include <osgDB/FileUtils>
+#else
+#   include <dirent.h>
+#   include <sys/time.h>
+#endif
+
+namespace dtUtil
+{
+   /////////////////////////////////////////////////////////////////////////////
+   /**
+    * The contents of one directory as of the last time it was read.  Nothing a reader
+    * can see changes after the listing is published except the child pointers, which are atomic.
+    */
+   class FilePathIndex::DirectoryListing : public osg::Referenced
+   {
+   public:
+      struct Entry
+      {
+         Entry()
+         : mType(FILE_NOT_FOUND)
+         , mChild(NULL)
+         {
+         }
+
+         std::string mName; ///< the name with the case it has on disk.
+         FileType mType;
+         /// The listing for a sub directory, or NULL if it hasn't been read.
+         mutable OpenThreads::AtomicPtr mChild;
+         /// Holds the reference for mChild.  Only touched with the write mutex held.
+         mutable dtCore::RefPtr<DirectoryListing> mChildRef;
+      };
+
+      DirectoryListing(const std::string& absPath, unsigned numEntries)
+      : mAbsPath(absPath)
+      , mModTime(0)
+      , mScanTime(0)
+      , mEntries(numEntries)
+      , mParent(NULL)
+      , mParentEntry(0)
+      {
+      }
+
+      /// @return the index of the entry with the given lower case name, or -1.
+      int FindEntry(const std::string& lowerCaseName) const
+      {
+         IndexMap::const_iterator found = mLowerCaseIndex.find(lowerCaseName);
+         if (found == mLowerCaseIndex.end())
+         {
+            return -1;
+         }
+         return int(found->second);
+      }
+
+      /**
+       * Directory modification times are only as fine grained as the file system clock, so a
+       * change made shortly after another one may leave the time the same.  A listing read within
+       * that window of the last change can't be trusted by comparing times, so it is read again
+       * on every check until the window has passed.
+       */
+      bool IsRacy() const
+      {
+         return mScanTime < mModTime + RACY_WINDOW;
+      }
+
+#ifdef DELTA_WIN32
+      static const FileTime RACY_WINDOW = 2000000000ULL;
+#else
+      static const FileTime RACY_WINDOW = 100000000ULL;
+#endif
+
+      std::string mAbsPath;
+      FileTime mModTime;
+      FileTime mScanTime;
+      std::vector<Entry> mEntries;
+
+      typedef dtUtil::HashMap<std::string, unsigned> IndexMap;
+      IndexMap mLowerCaseIndex;
+
+      // Where this listing hangs in the tree.  These are only used with the write mutex held.
+      mutable const DirectoryListing* mParent;
+      mutable unsigned mParentEntry;
+
+   protected:
+      ~DirectoryListing() {}
+   };
+
+   namespace
+   {
+   /////////////////////////////////////////////////////////////////////////////
+   /// Counts a lookup as running for the lifetime of the object, so listings it can see aren't freed.
+   class ReaderScope
+   {
+   public:
+      ReaderScope(OpenThreads::Atomic& numReaders)
+      : mNumReaders(numReaders)
+      {
+         ++mNumReaders;
+      }
+
+      ~ReaderScope()
+      {
+         --mNumReaders;
+      }
+
+   private:
+      OpenThreads::Atomic& mNumReaders;
+   };
+
+   /////////////////////////////////////////////////////////////////////////////
+   inline std::string LowerCaseCopy(const std::string& name)
+   {
+      std::string result(name);
+      ToLowerCase(result);
+      return result;
+   }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   FilePathIndex::FilePathIndex(const std::string& rootDir)
+   : mRootDirectory(rootDir)
+   , mRoot(NULL)
+   {
+      while (mRootDirectory.size() > 1 &&
+            (mRootDirectory[mRootDirectory.size() - 1] == '/' || mRootDirectory[mRootDirectory.size() - 1] == '\\'))
+      {
+         mRootDirectory.erase(mRootDirectory.size() - 1);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   FilePathIndex::~FilePathIndex()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool FilePathIndex::NormalizePath(const std::string& relPath, std::vector<std::string>& componentsOut)
+   {
+      componentsOut.clear();
+      if (relPath.empty() || relPath[0] == '/' || relPath[0] == '\\' || relPath.find(':') != std::string::npos)
+      {
+         return false;
+      }
+
+      std::string component;
+      for (size_t i = 0; i <= relPath.size(); ++i)
+      {
+         char c = i < relPath.size() ? relPath[i] : '/';
+         if (c == '/' || c == '\\')
+         {
+            if (component == "..")
+            {
+               return false;
+            }
+            if (!component.empty() && component != ".")
+            {
+               componentsOut.push_back(component);
+            }
+            component.clear();
+         }
+         else
+         {
+            component.push_back(char(tolower(c)));
+         }
+      }
+
+      return !componentsOut.empty();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool FilePathIndex::Find(const std::string& relPath, std::string& outPath, FileType& outType) const
+   {
+      std::vector<std::string> components;
+      if (!NormalizePath(relPath, components))
+      {
+         return false;
+      }
+
+      ++mNumLookups;
+
+      LookupResult result = LOOKUP_STALE;
+      {
+         ReaderScope scope(mNumActiveReaders);
+         // A stale result means a directory was read again, so just try again with the new listing.
+         // The limit is only there so a directory that changes constantly can't hold the caller forever.
+         for (unsigned tries = 0; result == LOOKUP_STALE && tries < 4; ++tries)
+         {
+            result = InternalFind(components, outPath, outType);
+         }
+      }
+
+      if (mNumRetiredListings > 0 && mNumActiveReaders == 0)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mWriteMutex);
+         ReleaseRetiredListings();
+      }
+
+      if (result == LOOKUP_FOUND)
+      {
+         ++mNumHits;
+         return true;
+      }
+      else if (result == LOOKUP_NOT_FOUND)
+      {
+         outType = FILE_NOT_FOUND;
+         return true;
+      }
+      return false;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   FilePathIndex::LookupResult FilePathIndex::InternalFind(const std::vector<std::string>& components,
+            std::string& outPath, FileType& outType) const
+   {
+      const DirectoryListing* listing = GetOrScanRoot();
+      if (listing == NULL)
+      {
+         // The root doesn't exist, so nothing under it does either.
+         return LOOKUP_NOT_FOUND;
+      }
+
+      const unsigned last = unsigned(components.size() - 1);
+      bool refreshed = false;
+      unsigned i = 0;
+      while (i < last)
+      {
+         int entryIdx = listing->FindEntry(components[i]);
+         const DirectoryListing* child = NULL;
+         if (entryIdx >= 0 && listing->mEntries[entryIdx].mType == DIRECTORY)
+         {
+            child = GetOrScanChild(*listing, unsigned(entryIdx));
+         }
+
+         if (child != NULL)
+         {
+            listing = child;
+            refreshed = false;
+            ++i;
+            continue;
+         }
+
+         // The walk can't go on, so this is the level where the answer is decided.  Make sure it's current.
+         if (!refreshed)
+         {
+            listing = RefreshListing(*listing);
+            if (listing == NULL)
+            {
+               return LOOKUP_STALE;
+            }
+            refreshed = true;
+            continue;
+         }
+
+         if (entryIdx >= 0 && listing->mEntries[entryIdx].mType != DIRECTORY)
+         {
+            // Looking inside a regular file, which is probably an archive.  Let FileUtils deal with it.
+            return LOOKUP_UNHANDLED;
+         }
+         return LOOKUP_NOT_FOUND;
+      }
+
+      if (!refreshed)
+      {
+         listing = RefreshListing(*listing);
+         if (listing == NULL)
+         {
+            return LOOKUP_STALE;
+         }
+      }
+
+      int entryIdx = listing->FindEntry(components[last]);
+      if (entryIdx < 0)
+      {
+         return LOOKUP_NOT_FOUND;
+      }
+
+      const DirectoryListing::Entry& entry = listing->mEntries[entryIdx];
+      outPath.reserve(listing->mAbsPath.size() + entry.mName.size() + 1);
+      outPath = listing->mAbsPath;
+      outPath += FileUtils::PATH_SEPARATOR;
+      outPath += entry.mName;
+      outType = entry.mType;
+      return LOOKUP_FOUND;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const FilePathIndex::DirectoryListing* FilePathIndex::GetOrScanRoot() const
+   {
+      const DirectoryListing* root = static_cast<const DirectoryListing*>(mRoot.get());
+      if (root != NULL)
+      {
+         return root;
+      }
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mWriteMutex);
+      root = static_cast<const DirectoryListing*>(mRoot.get());
+      if (root == NULL)
+      {
+         mRootRef = ScanDirectory(mRootDirectory);
+         root = mRootRef.get();
+         mRoot.assign(mRootRef.get(), NULL);
+      }
+      return root;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const FilePathIndex::DirectoryListing* FilePathIndex::GetOrScanChild(const DirectoryListing& parent, unsigned entryIndex) const
+   {
+      const DirectoryListing::Entry& entry = parent.mEntries[entryIndex];
+      const DirectoryListing* child = static_cast<const DirectoryListing*>(entry.mChild.get());
+      if (child != NULL)
+      {
+         return child;
+      }
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mWriteMutex);
+      child = static_cast<const DirectoryListing*>(entry.mChild.get());
+      if (child == NULL)
+      {
+         entry.mChildRef = ScanDirectory(parent.mAbsPath + FileUtils::PATH_SEPARATOR + entry.mName);
+         if (entry.mChildRef.valid())
+         {
+            entry.mChildRef->mParent = &parent;
+            entry.mChildRef->mParentEntry = entryIndex;
+         }
+         child = entry.mChildRef.get();
+         entry.mChild.assign(entry.mChildRef.get(), NULL);
+      }
+      return child;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const FilePathIndex::DirectoryListing* FilePathIndex::RefreshListing(const DirectoryListing& listing) const
+   {
+      FileTime modTime = 0;
+      bool exists = StatDirectory(listing.mAbsPath, modTime);
+      if (exists && modTime == listing.mModTime && !listing.IsRacy())
+      {
+         return &listing;
+      }
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mWriteMutex);
+
+      // If the directory is gone, read the closest parent that still exists instead, and
+      // have the caller start over so it stops at the level where the path no longer exists.
+      const DirectoryListing* target = &listing;
+      while (!exists && target->mParent != NULL)
+      {
+         target = target->mParent;
+         exists = StatDirectory(target->mAbsPath, modTime);
+      }
+
+      const DirectoryListing* current = NULL;
+      if (target->mParent == NULL)
+      {
+         current = static_cast<const DirectoryListing*>(mRoot.get());
+      }
+      else
+      {
+         current = static_cast<const DirectoryListing*>(target->mParent->mEntries[target->mParentEntry].mChild.get());
+      }
+
+      // Another thread may have already replaced it while this one waited on the lock.
+      if (current == target)
+      {
+         ++mNumRescans;
+         dtCore::RefPtr<DirectoryListing> newListing;
+         if (exists)
+         {
+            newListing = ScanDirectory(target->mAbsPath);
+         }
+
+         if (!newListing.valid())
+         {
+            // Only the root can get here, and with no root there is nothing to find.
+            newListing = new DirectoryListing(target->mAbsPath, 0);
+         }
+         ReplaceListing(*target, *newListing);
+         current = newListing.get();
+      }
+
+      if (target != &listing)
+      {
+         return NULL;
+      }
+      return current;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FilePathIndex::ReplaceListing(const DirectoryListing& oldListing, DirectoryListing& newListing) const
+   {
+      // Carry over the sub directories that have already been read so a change in one directory
+      // doesn't cause everything under it to be read again.  They are validated on their own.
+      for (unsigned i = 0; i < newListing.mEntries.size(); ++i)
+      {
+         DirectoryListing::Entry& newEntry = newListing.mEntries[i];
+         if (newEntry.mType != DIRECTORY)
+         {
+            continue;
+         }
+
+         int oldIdx = oldListing.FindEntry(LowerCaseCopy(newEntry.mName));
+         if (oldIdx < 0)
+         {
+            continue;
+         }
+
+         const DirectoryListing::Entry& oldEntry = oldListing.mEntries[oldIdx];
+         if (oldEntry.mType == DIRECTORY && oldEntry.mName == newEntry.mName && oldEntry.mChildRef.valid())
+         {
+            newEntry.mChildRef = oldEntry.mChildRef;
+            newEntry.mChildRef->mParent = &newListing;
+            newEntry.mChildRef->mParentEntry = i;
+            newEntry.mChild.assign(newEntry.mChildRef.get(), NULL);
+         }
+      }
+
+      newListing.mParent = oldListing.mParent;
+      newListing.mParentEntry = oldListing.mParentEntry;
+
+      if (oldListing.mParent == NULL)
+      {
+         mRetiredListings.push_back(mRootRef);
+         ++mNumRetiredListings;
+         mRootRef = &newListing;
+         mRoot.assign(&newListing, &oldListing);
+      }
+      else
+      {
+         const DirectoryListing::Entry& parentEntry = oldListing.mParent->mEntries[oldListing.mParentEntry];
+         mRetiredListings.push_back(parentEntry.mChildRef);
+         ++mNumRetiredListings;
+         parentEntry.mChildRef = &newListing;
+         parentEntry.mChild.assign(&newListing, &oldListing);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FilePathIndex::ReleaseRetiredListings() const
+   {
+      // Only lookups that started before a listing was replaced can be holding it, so once
+      // no lookups are running, nothing can get to the retired listings anymore.
+      if (mNumActiveReaders == 0)
+      {
+         mRetiredListings.clear();
+         mNumRetiredListings.exchange(0);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool FilePathIndex::StatDirectory(const std::string& absPath, FileTime& modTimeOut) const
+   {
+      ++mNumStatCalls;
+      struct stat tagStat;
+      if (stat(absPath.c_str(), &tagStat) != 0 || !S_ISDIR(tagStat.st_mode))
+      {
+         return false;
+      }
+#if defined(DELTA_WIN32)
+      modTimeOut = FileTime(tagStat.st_mtime) * 1000000000ULL;
+#elif defined(__APPLE__)
+      modTimeOut = FileTime(tagStat.st_mtimespec.tv_sec) * 1000000000ULL + FileTime(tagStat.st_mtimespec.tv_nsec);
+#else
+      modTimeOut = FileTime(tagStat.st_mtim.tv_sec) * 1000000000ULL + FileTime(tagStat.st_mtim.tv_nsec);
+#endif
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   FilePathIndex::FileTime FilePathIndex::GetCurrentFileTime()
+   {
+#ifdef DELTA_WIN32
+      return FileTime(time(NULL)) * 1000000000ULL;
+#else
+      struct timeval tv;
+      gettimeofday(&tv, NULL);
+      return FileTime(tv.tv_sec) * 1000000000ULL + FileTime(tv.tv_usec) * 1000ULL;
+#endif
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   FilePathIndex::DirectoryListing* FilePathIndex::ScanDirectory(const std::string& absPath) const
+   {
+      // The time is taken before reading so that a change made while reading leaves the listing racy.
+      FileTime scanTime = GetCurrentFileTime();
+      FileTime modTime = 0;
+      if (!StatDirectory(absPath, modTime))
+      {
+         return NULL;
+      }
+
+      ++mNumDirectoryScans;
+
+      std::vector<std::pair<std::string, FileType> > contents;
+
+#ifdef DELTA_WIN32
+      DirectoryContents names = osgDB::getDirectoryContents(absPath);
+      for (DirectoryContents::const_iterator i = names.begin(), iend = names.end(); i != iend; ++i)
+      {
+         if (*i == "." || *i == "..")
+         {
+            continue;
+         }
+
+         ++mNumStatCalls;
+         struct stat tagStat;
+         if (stat((absPath + FileUtils::PATH_SEPARATOR + *i).c_str(), &tagStat) == 0)
+         {
+            contents.push_back(std::make_pair(*i, S_ISDIR(tagStat.st_mode) ? DIRECTORY : REGULAR_FILE));
+         }
+      }
+#else
+      DIR* dir = opendir(absPath.c_str());
+      if (dir == NULL)
+      {
+         return NULL;
+      }
+
+      struct dirent* dirEntry = NULL;
+      while ((dirEntry = readdir(dir)) != NULL)
+      {
+         std::string name(dirEntry->d_name);
+         if (name == "." || name == "..")
+         {
+            continue;
+         }
+
+         FileType type = REGULAR_FILE;
+#ifdef _DIRENT_HAVE_D_TYPE
+         if (dirEntry->d_type == DT_DIR)
+         {
+            type = DIRECTORY;
+         }
+         else if (dirEntry->d_type == DT_LNK || dirEntry->d_type == DT_UNKNOWN)
+#endif
+         {
+            // Links are followed to match what FileUtils reports, since it uses stat, not lstat.
+            ++mNumStatCalls;
+            struct stat tagStat;
+            if (stat((absPath + FileUtils::PATH_SEPARATOR + name).c_str(), &tagStat) != 0)
+            {
+               continue;
+            }
+            type = S_ISDIR(tagStat.st_mode) ? DIRECTORY : REGULAR_FILE;
+         }
+         contents.push_back(std::make_pair(name, type));
+      }
+      closedir(dir);
+#endif
+
+      DirectoryListing* listing = new DirectoryListing(absPath, unsigned(contents.size()));
+      listing->mModTime = modTime;
+      listing->mScanTime = scanTime;
+      listing->mLowerCaseIndex.rehash(contents.size());
+      for (unsigned i = 0; i < contents.size(); ++i)
+      {
+         DirectoryListing::Entry& entry = listing->mEntries[i];
+         entry.mName = contents[i].first;
+         entry.mType = contents[i].second;
+         // If names differ only by case, the first one read wins, same as a case insensitive search on disk.
+         listing->mLowerCaseIndex.insert(std::make_pair(LowerCaseCopy(entry.mName), i));
+      }
+      return listing;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FilePathIndex::Preload()
+   {
+      ReaderScope scope(mNumActiveReaders);
+      const DirectoryListing* root = GetOrScanRoot();
+      if (root != NULL)
+      {
+         PreloadListing(*root);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FilePathIndex::PreloadListing(const DirectoryListing& listing)
+   {
+      for (unsigned i = 0; i < listing.mEntries.size(); ++i)
+      {
+         if (listing.mEntries[i].mType == DIRECTORY)
+         {
+            const DirectoryListing* child = GetOrScanChild(listing, i);
+            if (child != NULL)
+            {
+               PreloadListing(*child);
+            }
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FilePathIndex::Clear()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mWriteMutex);
+      if (mRootRef.valid())
+      {
+         mRetiredListings.push_back(mRootRef);
+         ++mNumRetiredListings;
+         mRoot.assign(NULL, mRootRef.get());
+         mRootRef = NULL;
+      }
+      ReleaseRetiredListings();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FilePathIndex::ResetCounters()
+   {
+      mNumLookups.exchange(0);
+      mNumHits.exchange(0);
+      mNumStatCalls.exchange(0);
+      mNumDirectoryScans.exchange(0);
+      mNumRescans.exchange(0);
+   }
+}
@@ -54,6 +54,7 @@ _CRTIMP extern int errno;
 #include <dtUtil/fileutils.h>
 #include <dtUtil/stringutils.h>
 #include <dtUtil/exception.h>
+#include <dtUtil/frameprofiler.h>
 #include <dtUtil/log.h>
 #include <osgDB/ReadFile>
 
@@ -1729,6 +1730,7 @@ namespace dtUtil
    ////////////////////////////////////////////////////////////////////////////////
    osg::Node* FileUtils::ReadNode(const std::string& filename, osgDB::ReaderWriter::Options* options)
    {
+      DT_PROFILE_ZONE("ReadNode");
       FileInfo info = GetFileInfo(filename);
       osgDB::Registry* reg = osgDB::Registry::instance();
 
@@ -0,0 +1,348 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <prefix/dtutilprefix.h>
+#include <dtUtil/frameprofiler.h>
+#include <dtUtil/log.h>
+
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+#include <OpenThreads/Atomic>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace dtUtil
+{
+   namespace
+   {
+      struct ProfileEvent
+      {
+         osg::Timer_t mStart;
+         osg::Timer_t mEnd;
+         char mName[FrameProfiler::MAX_NAME_LENGTH + 1];
+      };
+
+      /**
+       * Only the owning thread writes to a buffer.  The count is bumped after the event is filled in.
+       * The owner resets the buffer, under the profiler mutex, when it sees that Clear changed the generation.
+       */
+      class ThreadBuffer : public osg::Referenced
+      {
+      public:
+         ThreadBuffer(unsigned numEvents, unsigned threadId, unsigned generation)
+         : mEvents(std::max(numEvents, 1U))
+         , mThreadId(threadId)
+         , mGeneration(generation)
+         {
+         }
+
+         /// Call with the profiler mutex held.  Buffers from before the last Clear hold nothing.
+         unsigned GetNumHeld(unsigned generation) const
+         {
+            if (mGeneration != generation)
+            {
+               return 0U;
+            }
+            return std::min(unsigned(mCount), unsigned(mEvents.size()));
+         }
+
+         std::vector<ProfileEvent> mEvents;
+         OpenThreads::Atomic mCount;
+         unsigned mThreadId;
+         unsigned mGeneration;
+
+      protected:
+         ~ThreadBuffer() {}
+      };
+
+      struct ProfilerData
+      {
+         ProfilerData()
+         : mEventsPerThread(16384U)
+         , mSpikeThresholdMs(0.0)
+         , mTraceStart(osg::Timer::instance()->tick())
+         , mFrameStart(0)
+         , mFrameNumber(0U)
+         {
+         }
+
+         OpenThreads::Mutex mMutex;
+         std::vector<osg::ref_ptr<ThreadBuffer> > mBuffers;
+         /// Bumped by Clear, with the mutex held.
+         OpenThreads::Atomic mGeneration;
+         unsigned mEventsPerThread;
+         double mSpikeThresholdMs;
+         std::string mSpikeDirectory;
+         osg::Timer_t mTraceStart;
+         osg::Timer_t mFrameStart;
+         unsigned mFrameNumber;
+      };
+
+      ProfilerData& GetData()
+      {
+         static ProfilerData data;
+         return data;
+      }
+
+      thread_local ThreadBuffer* tThreadBuffer = NULL;
+
+      ThreadBuffer& GetThreadBuffer()
+      {
+         if (tThreadBuffer == NULL)
+         {
+            ProfilerData& data = GetData();
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(data.mMutex);
+            data.mBuffers.push_back(new ThreadBuffer(data.mEventsPerThread, unsigned(data.mBuffers.size()) + 1U,
+                     unsigned(data.mGeneration)));
+            tThreadBuffer = data.mBuffers.back().get();
+         }
+         else if (tThreadBuffer->mGeneration != unsigned(GetData().mGeneration))
+         {
+            ProfilerData& data = GetData();
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(data.mMutex);
+            tThreadBuffer->mEvents.resize(data.mEventsPerThread);
+            tThreadBuffer->mCount.exchange(0U);
+            tThreadBuffer->mGeneration = unsigned(data.mGeneration);
+         }
+         return *tThreadBuffer;
+      }
+
+      void WriteJsonString(std::ostream& stream, const char* str)
+      {
+         stream << '"';
+         for (; *str != '\0'; ++str)
+         {
+            const char c = *str;
+            if (c == '"' || c == '\\')
+            {
+               stream << '\\' << c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+               stream << ' ';
+            }
+            else
+            {
+               stream << c;
+            }
+         }
+         stream << '"';
+      }
+   }
+
+   OpenThreads::Atomic FrameProfiler::mEnabled(0U);
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FrameProfiler::SetEnabled(bool enabled)
+   {
+      if (enabled && !IsEnabled())
+      {
+         GetData().mFrameStart = 0;
+      }
+      mEnabled.exchange(enabled ? 1U : 0U);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FrameProfiler::SetEventsPerThread(unsigned numEvents)
+   {
+      ProfilerData& data = GetData();
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(data.mMutex);
+      data.mEventsPerThread = std::max(numEvents, 1U);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned FrameProfiler::GetEventsPerThread()
+   {
+      return GetData().mEventsPerThread;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FrameProfiler::SetSpikeThresholdMs(double thresholdMs)
+   {
+      GetData().mSpikeThresholdMs = thresholdMs;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   double FrameProfiler::GetSpikeThresholdMs()
+   {
+      return GetData().mSpikeThresholdMs;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FrameProfiler::SetSpikeDirectory(const std::string& dir)
+   {
+      GetData().mSpikeDirectory = dir;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const std::string& FrameProfiler::GetSpikeDirectory()
+   {
+      return GetData().mSpikeDirectory;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FrameProfiler::BeginFrame()
+   {
+      if (!IsEnabled())
+      {
+         return;
+      }
+
+      ProfilerData& data = GetData();
+      data.mFrameStart = osg::Timer::instance()->tick();
+      ++data.mFrameNumber;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   double FrameProfiler::EndFrame()
+   {
+      ProfilerData& data = GetData();
+      if (!IsEnabled() || data.mFrameStart == 0)
+      {
+         return 0.0;
+      }
+
+      const osg::Timer_t frameEnd = osg::Timer::instance()->tick();
+      static const char frameName[] = "Frame";
+      RecordZone(frameName, sizeof(frameName) - 1U, data.mFrameStart, frameEnd);
+
+      const double frameMs = osg::Timer::instance()->delta_m(data.mFrameStart, frameEnd);
+      if (data.mSpikeThresholdMs > 0.0 && frameMs > data.mSpikeThresholdMs)
+      {
+         std::ostringstream fileName;
+         if (!data.mSpikeDirectory.empty())
+         {
+            fileName << data.mSpikeDirectory << '/';
+         }
+         fileName << "frame_" << data.mFrameNumber << ".trace.json";
+
+         if (WriteChromeTrace(fileName.str(), data.mFrameStart, frameEnd))
+         {
+            std::ostringstream ss;
+            ss << "Frame " << data.mFrameNumber << " took " << frameMs << "ms, wrote trace \"" << fileName.str() << "\".";
+            LOG_WARNING(ss.str());
+         }
+      }
+      return frameMs;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned FrameProfiler::GetFrameNumber()
+   {
+      return GetData().mFrameNumber;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned FrameProfiler::GetNumEvents()
+   {
+      ProfilerData& data = GetData();
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(data.mMutex);
+      const unsigned generation = unsigned(data.mGeneration);
+      unsigned result = 0U;
+      for (unsigned i = 0; i < data.mBuffers.size(); ++i)
+      {
+         result += data.mBuffers[i]->GetNumHeld(generation);
+      }
+      return result;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FrameProfiler::Clear()
+   {
+      ProfilerData& data = GetData();
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(data.mMutex);
+      // The buffers belong to the threads recording into them, so each one resets its own.
+      ++data.mGeneration;
+      data.mFrameNumber = 0U;
+      data.mFrameStart = 0;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool FrameProfiler::WriteChromeTrace(const std::string& fileName, osg::Timer_t from, osg::Timer_t to)
+   {
+      std::ofstream stream(fileName.c_str(), std::ios::out | std::ios::trunc);
+      if (!stream.is_open())
+      {
+         LOG_ERROR("Unable to open \"" + fileName + "\" to write the frame profiler trace.");
+         return false;
+      }
+      WriteChromeTrace(stream, from, to);
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FrameProfiler::WriteChromeTrace(std::ostream& stream, osg::Timer_t from, osg::Timer_t to)
+   {
+      ProfilerData& data = GetData();
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(data.mMutex);
+      const osg::Timer* timer = osg::Timer::instance();
+
+      const unsigned generation = unsigned(data.mGeneration);
+
+      stream << "{\"traceEvents\":[";
+      bool first = true;
+      for (unsigned i = 0; i < data.mBuffers.size(); ++i)
+      {
+         const ThreadBuffer& buffer = *data.mBuffers[i];
+         const unsigned size = unsigned(buffer.mEvents.size());
+         const unsigned count = unsigned(buffer.mCount);
+         const unsigned held = buffer.GetNumHeld(generation);
+
+         // oldest to newest
+         for (unsigned j = count - held; j != count; ++j)
+         {
+            const ProfileEvent& evt = buffer.mEvents[j % size];
+            if (to != 0 && (evt.mEnd < from || evt.mStart > to))
+            {
+               continue;
+            }
+
+            stream << (first ? "\n" : ",\n");
+            first = false;
+            stream << "{\"name\":";
+            WriteJsonString(stream, evt.mName);
+            stream << ",\"cat\":\"delta3d\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.mThreadId
+                   << ",\"ts\":" << timer->delta_u(data.mTraceStart, evt.mStart)
+                   << ",\"dur\":" << timer->delta_u(evt.mStart, evt.mEnd) << "}";
+         }
+      }
+      stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void FrameProfiler::RecordZone(const char* name, unsigned nameLength, osg::Timer_t start, osg::Timer_t end)
+   {
+      ThreadBuffer& buffer = GetThreadBuffer();
+      const unsigned count = unsigned(buffer.mCount);
+      ProfileEvent& evt = buffer.mEvents[count % unsigned(buffer.mEvents.size())];
+      evt.mStart = start;
+      evt.mEnd = end;
+
+      const unsigned length = std::min(nameLength, MAX_NAME_LENGTH);
+      memcpy(evt.mName, name, length);
+      evt.mName[length] = '\0';
+
+      ++buffer.mCount;
+   }
+}
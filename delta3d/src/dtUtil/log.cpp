@@ -28,15 +28,20 @@
 #include <dtUtil/stringutils.h>
 #include <osg/ref_ptr>
 #include <osg/observer_ptr>
+#include <osg/Timer>
 #include <osgDB/FileNameUtils>
 
 
 
+#include <OpenThreads/Atomic>
 #include <OpenThreads/Mutex>
 #include <OpenThreads/ScopedLock>
+#include <OpenThreads/Thread>
 
 #include <algorithm>
 #include <cstdarg>
+#include <cstdlib>
+#include <sstream>
 //#include <cstdio>
 #include <dtUtil/hashmap.h>
 
@@ -52,6 +57,7 @@ namespace dtUtil
 
    //forward declaration
    class LogManager;
+   class AsyncLogWriter;
 
    static osg::ref_ptr<LogManager> LOG_MANAGER(NULL);
    static Log::LogMessageType DEFAULT_LOG_LEVEL(Log::LOG_WARNING);
@@ -61,26 +67,26 @@ namespace dtUtil
    class LogManager: public osg::Referenced
    {
    public:
-      osg::ref_ptr<LogObserver> mLogObserverConsole; ///writes to console
+      osg::ref_ptr<LogObserverConsole> mLogObserverConsole; ///writes to console
       osg::ref_ptr<LogObserverFile> mLogObserverFile; ///writes to file
       osg::observer_ptr<osg::Referenced> mLogTimeProviderAsRef;
       LogTimeProvider* mLogTimeProvider;
+      AsyncLogWriter* mAsyncWriter; ///< created the first time async mode is turned on.
 
       ////////////////////////////////////////////////////////////////
       LogManager()
       : mLogObserverConsole(new LogObserverConsole())
       , mLogObserverFile(new LogObserverFile())
       , mLogTimeProvider(NULL)
+      , mAsyncWriter(NULL)
       {
       }
 
       ////////////////////////////////////////////////////////////////
-      ~LogManager()
-      {
-         mInstances.clear();
-         mLogObserverConsole = NULL;
-         mLogObserverFile = NULL;
-      }
+      ~LogManager();
+
+      ////////////////////////////////////////////////////////////////
+      bool IsAsync() const;
 
       ////////////////////////////////////////////////////////////////
       bool AddInstance(const std::string& name, Log* log)
@@ -189,6 +195,579 @@ namespace dtUtil
       Log::LogMessageType mLevel;
       Log::LogObserverContainer mObservers;
    };
+
+   //////////////////////////////////////////////////////////////////////////
+   /// Sends one message to the file, console and the observers of a log.  The caller holds the manager mutex.
+   static void DispatchLogData(LogManager& manager, const LogImpl* log, unsigned outputBits, const LogObserver::LogData& logData)
+   {
+      if (dtUtil::Bits::Has(outputBits, Log::TO_FILE))
+      {
+         manager.mLogObserverFile->LogMessage(logData);
+      }
+
+      if (dtUtil::Bits::Has(outputBits, Log::TO_CONSOLE))
+      {
+         manager.mLogObserverConsole->LogMessage(logData);
+      }
+
+      if (log != NULL && dtUtil::Bits::Has(outputBits, Log::TO_OBSERVER) && !log->mObservers.empty())
+      {
+         Log::LogObserverContainer::const_iterator itr = log->mObservers.begin();
+         while (itr != log->mObservers.end())
+         {
+            (*itr)->LogMessage(logData);
+            ++itr;
+         }
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   //////////////////////////////////////////////////////////////////////////
+   /// A message waiting in an async queue, already formatted and stamped.
+   struct AsyncLogRecord
+   {
+      AsyncLogRecord()
+      : mLog(NULL)
+      , mOutputBits(0U)
+      , mSequence(0U)
+      {
+      }
+
+      LogObserver::LogData mData;
+      const LogImpl* mLog;
+      unsigned mOutputBits;
+      unsigned mSequence;
+   };
+
+   //////////////////////////////////////////////////////////////////////////
+   /**
+    * Single producer, single consumer ring of records.  Only the owning thread pushes, and only the writer,
+    * under its drain mutex, pops.  The slots are reused, so the strings in them stop allocating once they have grown.
+    */
+   class AsyncLogQueue : public osg::Referenced
+   {
+   public:
+      explicit AsyncLogQueue(unsigned size)
+      {
+         unsigned pow2 = 1U;
+         while (pow2 < size)
+         {
+            pow2 <<= 1;
+         }
+         mRecords.resize(pow2);
+         mMask = pow2 - 1U;
+      }
+
+      /// @return the slot to fill in, or NULL if the queue is full.
+      AsyncLogRecord* BeginPush()
+      {
+         const unsigned tail = mTail;
+         if (tail - unsigned(mHead) > mMask)
+         {
+            return NULL;
+         }
+         return &mRecords[tail & mMask];
+      }
+
+      /// Publishes the slot returned by BeginPush.
+      void EndPush()
+      {
+         ++mTail;
+      }
+
+      std::vector<AsyncLogRecord> mRecords;
+      unsigned mMask;
+      OpenThreads::Atomic mHead;
+      OpenThreads::Atomic mTail;
+      OpenThreads::Atomic mThreadExited; ///< set once the owning thread is gone, so the writer can drop the queue.
+
+   protected:
+      ~AsyncLogQueue() {}
+   };
+
+   /// Holds the queue of the current thread, and marks it when the thread exits.
+   struct AsyncLogQueueOwner
+   {
+      ~AsyncLogQueueOwner()
+      {
+         if (mQueue.valid())
+         {
+            mQueue->mThreadExited.exchange(1U);
+         }
+      }
+
+      osg::ref_ptr<AsyncLogQueue> mQueue;
+   };
+
+   static thread_local AsyncLogQueueOwner tAsyncLogQueue;
+
+   class AsyncLogThread;
+
+   //////////////////////////////////////////////////////////////////////////
+   /// Owns the per thread queues and moves their records to the observers.
+   class AsyncLogWriter
+   {
+   public:
+      AsyncLogWriter(LogManager& manager)
+      : mQueueSize(4096U)
+      , mDuplicateWindow(1.0)
+      , mManager(manager)
+      , mThread(NULL)
+      , mLastExpiryCheck(0)
+      {
+      }
+
+      ~AsyncLogWriter()
+      {
+         Stop();
+      }
+
+      bool IsRunning() const { return mThread != NULL; }
+
+      void Start();
+      void Stop();
+
+      /**
+       * Queues a message on the calling thread's queue.
+       * @param flush if true, the message and everything queued before it are written and flushed before returning,
+       *              and a full queue is drained instead of dropping the message.
+       */
+      void Push(const LogImpl& log, Log::LogMessageType msgType, const std::string& file,
+               const std::string& method, int line, const std::string& msg, bool flush);
+
+      /**
+       * Writes everything queued so far.
+       * @param finalDrain if true, for a stop, it writes out all pending duplicate counts.
+       * @return true if anything was written.
+       */
+      bool Drain(bool finalDrain = false);
+
+      unsigned mQueueSize;
+      double mDuplicateWindow;
+      OpenThreads::Atomic mTotalDropped;
+      OpenThreads::Atomic mQuit;
+
+   private:
+      struct DuplicateInfo
+      {
+         osg::Timer_t mFirstTime;
+         unsigned mSuppressed;
+         LogObserver::LogData mData;
+         const LogImpl* mLog;
+         unsigned mOutputBits;
+
+         /// @return true if the record is the same message logged from the same place.
+         bool Matches(const AsyncLogRecord& record) const
+         {
+            return mLog == record.mLog && mData.line == record.mData.line
+                     && mData.file == record.mData.file && mData.msg == record.mData.msg;
+         }
+      };
+
+      typedef dtUtil::HashMap<unsigned long, DuplicateInfo> DuplicateMap;
+
+      /// Hashes the log, file, line and message of a record, the fields DuplicateInfo::Matches compares.
+      static unsigned long HashDuplicateKey(const AsyncLogRecord& record)
+      {
+         dtUtil::hash<std::string> hashString;
+         unsigned long hash = (unsigned long)(reinterpret_cast<size_t>(record.mLog));
+         hash = hash * 31UL + hashString(record.mData.file);
+         hash = hash * 31UL + (unsigned long)(record.mData.line);
+         hash = hash * 31UL + hashString(record.mData.msg);
+         return hash;
+      }
+
+      struct SequenceLess
+      {
+         bool operator()(const AsyncLogRecord* a, const AsyncLogRecord* b) const
+         {
+            // works across the wrap of the counter
+            return int(a->mSequence - b->mSequence) < 0;
+         }
+      };
+
+      bool IsDuplicate(const AsyncLogRecord& record, osg::Timer_t now);
+      void WriteRepeatCount(DuplicateInfo& info);
+      void ReportExpiredDuplicates(osg::Timer_t now, bool all);
+
+      /// Checking a few times per window is enough, and keeps a large map from being walked on every drain.
+      bool IsExpiryCheckDue(osg::Timer_t now) const
+      {
+         return osg::Timer::instance()->delta_s(mLastExpiryCheck, now) >= mDuplicateWindow * 0.25;
+      }
+      void Dispatch(const LogImpl* log, unsigned outputBits, const LogObserver::LogData& logData);
+
+      LogManager& mManager;
+      AsyncLogThread* mThread;
+
+      OpenThreads::Mutex mQueuesMutex;
+      std::vector<osg::ref_ptr<AsyncLogQueue> > mQueues;
+
+      OpenThreads::Atomic mSequence;
+      OpenThreads::Atomic mDropped;
+
+      // Only touched while holding the drain mutex.
+      OpenThreads::Mutex mDrainMutex;
+      std::vector<osg::ref_ptr<AsyncLogQueue> > mSnapshot;
+      std::vector<unsigned> mTails;
+      std::vector<AsyncLogRecord*> mPending;
+      std::vector<const LogImpl*> mLogsToFlush;
+      DuplicateMap mDuplicates;
+      osg::Timer_t mLastExpiryCheck;
+   };
+
+   //////////////////////////////////////////////////////////////////////////
+   class AsyncLogThread : public OpenThreads::Thread
+   {
+   public:
+      AsyncLogThread(AsyncLogWriter& writer)
+      : mWriter(writer)
+      {
+      }
+
+      void run() override
+      {
+         while (unsigned(mWriter.mQuit) == 0U)
+         {
+            if (!mWriter.Drain())
+            {
+               OpenThreads::Thread::microSleep(2000);
+            }
+         }
+      }
+
+   private:
+      AsyncLogWriter& mWriter;
+   };
+
+   //////////////////////////////////////////////////////////////////////////
+   // Writes out the queues on a normal exit.  Flushing from a signal handler isn't safe, so a crash loses
+   // whatever below error level is still queued.  It runs before the static LOG_MANAGER is destroyed because it is registered later.
+   static void StopAsyncLogOnExit()
+   {
+      if (LOG_MANAGER.valid() && LOG_MANAGER->mAsyncWriter != NULL)
+      {
+         LOG_MANAGER->mAsyncWriter->Stop();
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void AsyncLogWriter::Start()
+   {
+      if (mThread != NULL)
+      {
+         return;
+      }
+
+      mManager.mLogObserverFile->SetFlushEachMessage(false);
+      mManager.mLogObserverConsole->SetFlushEachMessage(false);
+
+      mQuit.exchange(0U);
+      mThread = new AsyncLogThread(*this);
+      mThread->startThread();
+
+      static bool registeredAtExit = false;
+      if (!registeredAtExit)
+      {
+         registeredAtExit = true;
+         std::atexit(StopAsyncLogOnExit);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void AsyncLogWriter::Stop()
+   {
+      if (mThread == NULL)
+      {
+         return;
+      }
+
+      mQuit.exchange(1U);
+      mThread->join();
+      delete mThread;
+      mThread = NULL;
+
+      // anything logged while the thread was stopping, and the last duplicate counts.
+      Drain(true);
+
+      mManager.mLogObserverFile->SetFlushEachMessage(true);
+      mManager.mLogObserverConsole->SetFlushEachMessage(true);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void AsyncLogWriter::Push(const LogImpl& log, Log::LogMessageType msgType, const std::string& file,
+            const std::string& method, int line, const std::string& msg, bool flush)
+   {
+      AsyncLogQueue* queue = tAsyncLogQueue.mQueue.get();
+      if (queue == NULL)
+      {
+         queue = new AsyncLogQueue(mQueueSize);
+         tAsyncLogQueue.mQueue = queue;
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mQueuesMutex);
+         mQueues.push_back(queue);
+      }
+
+      AsyncLogRecord* record = queue->BeginPush();
+      if (record == NULL && flush)
+      {
+         Drain();
+         record = queue->BeginPush();
+      }
+
+      if (record == NULL)
+      {
+         ++mDropped;
+         ++mTotalDropped;
+         return;
+      }
+
+      LogObserver::LogData& logData = record->mData;
+      if (mManager.IsLogTimeProviderValid())
+      {
+         logData.frameNumber = mManager.mLogTimeProvider->GetFrameNumber();
+         logData.time = mManager.mLogTimeProvider->GetDateTime();
+      }
+      else
+      {
+         logData.frameNumber = 0U;
+         logData.time.SetToLocalTime();
+      }
+
+      logData.type = msgType;
+      logData.logName = log.mName;
+      logData.file = osgDB::getSimpleFileName(file);
+      logData.method = method;
+      logData.line = line;
+      logData.msg = msg;
+
+      record->mLog = &log;
+      record->mOutputBits = log.mOutputStreamBit;
+      record->mSequence = ++mSequence;
+
+      queue->EndPush();
+
+      if (flush)
+      {
+         Drain();
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool AsyncLogWriter::Drain(bool finalDrain)
+   {
+      mDrainMutex.lock();
+
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mQueuesMutex);
+         // Drop the queues of threads that have exited once they have been emptied.
+         for (unsigned i = 0; i < mQueues.size();)
+         {
+            AsyncLogQueue& queue = *mQueues[i];
+            if (unsigned(queue.mThreadExited) != 0U && unsigned(queue.mHead) == unsigned(queue.mTail))
+            {
+               mQueues[i] = mQueues.back();
+               mQueues.pop_back();
+            }
+            else
+            {
+               ++i;
+            }
+         }
+         mSnapshot = mQueues;
+      }
+
+      // Only take what was published before now, the producers keep going.
+      mPending.clear();
+      mTails.resize(mSnapshot.size());
+      for (unsigned i = 0; i < mSnapshot.size(); ++i)
+      {
+         AsyncLogQueue& queue = *mSnapshot[i];
+         const unsigned tail = queue.mTail;
+         mTails[i] = tail;
+         for (unsigned j = queue.mHead; j != tail; ++j)
+         {
+            mPending.push_back(&queue.mRecords[j & queue.mMask]);
+         }
+      }
+
+      const unsigned dropped = mDropped.exchange(0U);
+      const bool wroteSomething = !mPending.empty() || dropped > 0U;
+      const osg::Timer_t now = osg::Timer::instance()->tick();
+
+      if (wroteSomething || (!mDuplicates.empty() && (finalDrain || IsExpiryCheckDue(now))))
+      {
+         std::sort(mPending.begin(), mPending.end(), SequenceLess());
+
+         // Keeps the output from mixing with LogHorizRule or a message logged before async mode was turned on.
+         mManager.mMutex.lock();
+
+         mLogsToFlush.clear();
+         for (unsigned i = 0; i < mPending.size(); ++i)
+         {
+            const AsyncLogRecord& record = *mPending[i];
+            if (!IsDuplicate(record, now))
+            {
+               Dispatch(record.mLog, record.mOutputBits, record.mData);
+            }
+         }
+
+         ReportExpiredDuplicates(now, finalDrain);
+
+         if (dropped > 0U)
+         {
+            LogObserver::LogData logData;
+            logData.type = Log::LOG_WARNING;
+            logData.time.SetToLocalTime();
+            std::ostringstream ss;
+            ss << dropped << " log message(s) were dropped because a thread's async log queue was full.";
+            logData.msg = ss.str();
+            Dispatch(NULL, Log::TO_FILE | Log::TO_CONSOLE, logData);
+         }
+
+         mManager.mLogObserverFile->Flush();
+         mManager.mLogObserverConsole->Flush();
+         for (unsigned i = 0; i < mLogsToFlush.size(); ++i)
+         {
+            const Log::LogObserverContainer& observers = mLogsToFlush[i]->mObservers;
+            for (unsigned j = 0; j < observers.size(); ++j)
+            {
+               observers[j]->Flush();
+            }
+         }
+
+         mManager.mMutex.unlock();
+      }
+
+      for (unsigned i = 0; i < mSnapshot.size(); ++i)
+      {
+         mSnapshot[i]->mHead.exchange(mTails[i]);
+      }
+
+      mDrainMutex.unlock();
+      return wroteSomething;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void AsyncLogWriter::Dispatch(const LogImpl* log, unsigned outputBits, const LogObserver::LogData& logData)
+   {
+      DispatchLogData(mManager, log, outputBits, logData);
+
+      if (log != NULL && dtUtil::Bits::Has(outputBits, Log::TO_OBSERVER) && !log->mObservers.empty()
+               && std::find(mLogsToFlush.begin(), mLogsToFlush.end(), log) == mLogsToFlush.end())
+      {
+         mLogsToFlush.push_back(log);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool AsyncLogWriter::IsDuplicate(const AsyncLogRecord& record, osg::Timer_t now)
+   {
+      if (mDuplicateWindow <= 0.0)
+      {
+         return false;
+      }
+
+      const unsigned long key = HashDuplicateKey(record);
+      DuplicateMap::iterator found = mDuplicates.find(key);
+      if (found == mDuplicates.end())
+      {
+         DuplicateInfo& info = mDuplicates[key];
+         info.mFirstTime = now;
+         info.mSuppressed = 0U;
+         info.mData = record.mData;
+         info.mLog = record.mLog;
+         info.mOutputBits = record.mOutputBits;
+         return false;
+      }
+
+      DuplicateInfo& info = found->second;
+      if (!info.Matches(record))
+      {
+         // A different message with the same hash is just written.
+         return false;
+      }
+      if (osg::Timer::instance()->delta_s(info.mFirstTime, now) < mDuplicateWindow)
+      {
+         ++info.mSuppressed;
+         return true;
+      }
+
+      WriteRepeatCount(info);
+      info.mFirstTime = now;
+      return false;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void AsyncLogWriter::WriteRepeatCount(DuplicateInfo& info)
+   {
+      if (info.mSuppressed == 0U)
+      {
+         return;
+      }
+
+      LogObserver::LogData logData = info.mData;
+      std::ostringstream ss;
+      ss << "(repeated " << info.mSuppressed << " more time(s)) " << info.mData.msg;
+      logData.msg = ss.str();
+      Dispatch(info.mLog, info.mOutputBits, logData);
+
+      info.mSuppressed = 0U;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void AsyncLogWriter::ReportExpiredDuplicates(osg::Timer_t now, bool all)
+   {
+      if (!all && !IsExpiryCheckDue(now))
+      {
+         return;
+      }
+      mLastExpiryCheck = now;
+
+      DuplicateMap::iterator i = mDuplicates.begin();
+      while (i != mDuplicates.end())
+      {
+         if (all || osg::Timer::instance()->delta_s(i->second.mFirstTime, now) >= mDuplicateWindow)
+         {
+            WriteRepeatCount(i->second);
+            mDuplicates.erase(i++);
+         }
+         else
+         {
+            ++i;
+         }
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   LogManager::~LogManager()
+   {
+      delete mAsyncWriter;
+      mAsyncWriter = NULL;
+      mInstances.clear();
+      mLogObserverConsole = NULL;
+      mLogObserverFile = NULL;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool LogManager::IsAsync() const
+   {
+      return mAsyncWriter != NULL && mAsyncWriter->IsRunning();
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   static AsyncLogWriter& GetAsyncWriter()
+   {
+      if (LOG_MANAGER == NULL)
+      {
+         LOG_MANAGER = new LogManager;
+      }
+
+      if (LOG_MANAGER->mAsyncWriter == NULL)
+      {
+         LOG_MANAGER->mAsyncWriter = new AsyncLogWriter(*LOG_MANAGER);
+      }
+      return *LOG_MANAGER->mAsyncWriter;
+   }
 //   /** Stream buffer calling notify handler when buffer is synchronized (usually on std::endl).
 //    * Stream stores last notification severity to pass it to handler call.
 //    */
@@ -259,6 +838,12 @@ namespace dtUtil
          return;
       }
 
+      if (LOG_MANAGER->IsAsync())
+      {
+         // Errors are written before returning so a crash right after them doesn't lose them.
+         LOG_MANAGER->mAsyncWriter->Push(*mImpl, msgType, file, method, line, msg, msgType >= LOG_ERROR);
+         return;
+      }
 
       OpenThreads::ScopedLock<OpenThreads::Mutex> lock(LOG_MANAGER->mMutex);
       bool hasLogTimeProvider = LOG_MANAGER->IsLogTimeProviderValid();
@@ -281,26 +866,7 @@ namespace dtUtil
       logData.line = line;
       logData.msg = msg;
 
-
-      if (dtUtil::Bits::Has(mImpl->mOutputStreamBit, Log::TO_FILE))
-      {
-         LOG_MANAGER->mLogObserverFile->LogMessage(logData);
-      }
-
-      if (dtUtil::Bits::Has(mImpl->mOutputStreamBit, Log::TO_CONSOLE))
-      {
-         LOG_MANAGER->mLogObserverConsole->LogMessage(logData);
-      }
-
-      if (dtUtil::Bits::Has(mImpl->mOutputStreamBit, Log::TO_OBSERVER) && !mImpl->mObservers.empty())
-      {
-         Log::LogObserverContainer::iterator itr = mImpl->mObservers.begin();
-         while (itr != mImpl->mObservers.end())
-         {
-            (*itr)->LogMessage(logData);
-            ++itr;
-         }
-      }
+      DispatchLogData(*LOG_MANAGER, mImpl, mImpl->mOutputStreamBit, logData);
    }
 
    //////////////////////////////////////////////////////////////////////////
@@ -355,6 +921,9 @@ namespace dtUtil
 
       if (dtUtil::Bits::Has(mImpl->mOutputStreamBit, Log::TO_FILE))
       {
+         // Keep the rule after the messages logged before it.
+         Flush();
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(LOG_MANAGER->mMutex);
          LOG_MANAGER->mLogObserverFile->LogHorizRule();
       }
    }
@@ -508,6 +1077,76 @@ namespace dtUtil
 	  }
    }
 
+   ////////////////////////////////////////////////////////////////////////////////
+   void Log::SetAsyncMode(bool async)
+   {
+      if (async)
+      {
+         GetAsyncWriter().Start();
+      }
+      else if (LOG_MANAGER.valid() && LOG_MANAGER->mAsyncWriter != NULL)
+      {
+         LOG_MANAGER->mAsyncWriter->Stop();
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   bool Log::GetAsyncMode()
+   {
+      return LOG_MANAGER.valid() && LOG_MANAGER->IsAsync();
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void Log::SetAsyncQueueSize(unsigned numMessages)
+   {
+      GetAsyncWriter().mQueueSize = std::max(numMessages, 1U);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   unsigned Log::GetAsyncQueueSize()
+   {
+      if (LOG_MANAGER.valid() && LOG_MANAGER->mAsyncWriter != NULL)
+      {
+         return LOG_MANAGER->mAsyncWriter->mQueueSize;
+      }
+      return 4096U;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void Log::SetAsyncDuplicateWindow(double seconds)
+   {
+      GetAsyncWriter().mDuplicateWindow = seconds;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   double Log::GetAsyncDuplicateWindow()
+   {
+      if (LOG_MANAGER.valid() && LOG_MANAGER->mAsyncWriter != NULL)
+      {
+         return LOG_MANAGER->mAsyncWriter->mDuplicateWindow;
+      }
+      return 1.0;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void Log::Flush()
+   {
+      if (LOG_MANAGER.valid() && LOG_MANAGER->IsAsync())
+      {
+         LOG_MANAGER->mAsyncWriter->Drain();
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   unsigned Log::GetNumDroppedMessages()
+   {
+      if (LOG_MANAGER.valid() && LOG_MANAGER->mAsyncWriter != NULL)
+      {
+         return LOG_MANAGER->mAsyncWriter->mTotalDropped;
+      }
+      return 0U;
+   }
+
    ////////////////////////////////////////////////////////////////////////////////
    void Log::AddObserver(LogObserver& observer)
    {
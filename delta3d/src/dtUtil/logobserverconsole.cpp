@@ -25,6 +25,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 dtUtil::LogObserverConsole::LogObserverConsole()
+: mFlushEachMessage(true)
 {
 }
 
@@ -68,6 +69,29 @@ void dtUtil::LogObserverConsole::LogMessage(const LogData& logData)
       }
    }
 
-   std::cout << "]" << std::endl;
+   std::cout << "]\n";
+
+   if (mFlushEachMessage)
+   {
+      std::cout.flush();
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void dtUtil::LogObserverConsole::Flush()
+{
+   std::cout.flush();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void dtUtil::LogObserverConsole::SetFlushEachMessage(bool flush)
+{
+   mFlushEachMessage = flush;
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool dtUtil::LogObserverConsole::GetFlushEachMessage() const
+{
+   return mFlushEachMessage;
 }
 
@@ -28,6 +28,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 dtUtil::LogObserverFile::LogObserverFile() 
 : mOpenFailed(false)
+, mFlushEachMessage(true)
 {
 }
 
@@ -206,9 +207,33 @@ void dtUtil::LogObserverFile::LogMessage(const LogData& logData)
       }
    }
 
-   logFile << "]" << "</font></b><br>" << std::endl;
+   logFile << "]" << "</font></b><br>\n";
 
-   logFile.flush(); //Make sure everything is written, in case of a crash.
+   if (mFlushEachMessage)
+   {
+      logFile.flush(); //Make sure everything is written, in case of a crash.
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void dtUtil::LogObserverFile::Flush()
+{
+   if (logFile.is_open())
+   {
+      logFile.flush();
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void dtUtil::LogObserverFile::SetFlushEachMessage(bool flush)
+{
+   mFlushEachMessage = flush;
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool dtUtil::LogObserverFile::GetFlushEachMessage() const
+{
+   return mFlushEachMessage;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
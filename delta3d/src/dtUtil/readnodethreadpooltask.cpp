@@ -40,6 +40,7 @@ namespace dtUtil
    {
       if (!mFileToLoad.empty())
       {
+         // Options that were passed in are used as they are, apart from the cache hint.
          osg::ref_ptr<osgDB::ReaderWriter::Options> options;
          if (mLoadOptions.valid())
          {
@@ -48,6 +49,7 @@ namespace dtUtil
          else
          {
             options = new osgDB::Options;
+            options->setOptionString("loadMaterialsToStateSet");
          }
 
          if (mUseFileCaching)
@@ -59,8 +61,6 @@ namespace dtUtil
             options->setObjectCacheHint(osgDB::Options::CACHE_NONE);
          }
 
-         options->setOptionString("loadMaterialsToStateSet");
-
          mLoadedNode = NULL;
 
          try
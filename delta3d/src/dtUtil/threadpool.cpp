@@ -24,6 +24,7 @@
 
 #include <prefix/dtutilprefix.h>
 #include <dtUtil/threadpool.h>
+#include <dtUtil/frameprofiler.h>
 #include <dtUtil/log.h>
 
 #include <dtUtil/mswinmacros.h>
@@ -289,7 +290,10 @@ template<class _Ty,
       else
       {
          /// execute
-         (*currentTask)();
+         {
+            DT_PROFILE_ZONE(currentTask->GetName().Get());
+            (*currentTask)();
+         }
 
          if (currentTask->GetKeep())
          {
@@ -605,6 +609,12 @@ template<class _Ty,
       return gThreadPoolImpl.mTaskThreads.size();
    }
 
+   //////////////////////////////////////////////////
+   bool ThreadPool::IsWorkerThread()
+   {
+      return dynamic_cast<TaskThread*>(OpenThreads::Thread::CurrentThread()) != NULL;
+   }
+
    //////////////////////////////////////////////////
    //////////////////////////////////////////////////
    //////////////////////////////////////////////////
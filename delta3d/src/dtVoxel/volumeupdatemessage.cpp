@@ -17,13 +17,30 @@ namespace dtVoxel
 
    const dtUtil::RefString VolumeUpdateMessage::PARAM_ARRAY_ITEM("x");
 
+   const dtUtil::RefString VolumeUpdateMessage::PARAM_BRICKS("ParamBricks");
+
+   const dtUtil::RefString VolumeUpdateMessage::PARAM_BRICK_HALF_VALUES("ParamBrickHalfValues");
+
+   const dtUtil::RefString VolumeUpdateMessage::PARAM_BRICK_FLOAT_VALUES("ParamBrickFloatValues");
+
    VolumeUpdateMessage::VolumeUpdateMessage()
    : mStoreHalfFloats(true)
    , mIndicesChanged(new dtCore::NamedArrayParameter(PARAM_INDICES_CHANGED))
    , mValuesChanged(new dtCore::NamedArrayParameter(PARAM_VALUES_CHANGED))
+   , mBricks(new dtCore::NamedUnsignedIntParameter(PARAM_BRICKS, 0U, true))
+   , mBrickHalfValues(new dtCore::NamedUnsignedShortIntParameter(PARAM_BRICK_HALF_VALUES, 0U, true))
+   , mBrickFloatValues(new dtCore::NamedFloatParameter(PARAM_BRICK_FLOAT_VALUES, 0.0f, true))
    {
+      // list parameters start with the default value in them.
+      mBricks->GetValueList().clear();
+      mBrickHalfValues->GetValueList().clear();
+      mBrickFloatValues->GetValueList().clear();
+
       AddParameter(mIndicesChanged);
       AddParameter(mValuesChanged);
+      AddParameter(mBricks);
+      AddParameter(mBrickHalfValues);
+      AddParameter(mBrickFloatValues);
    }
 
    VolumeUpdateMessage::~VolumeUpdateMessage() {}
@@ -80,6 +97,94 @@ namespace dtVoxel
       return mValuesChanged;
    }
 
+   void VolumeUpdateMessage::AddBrick(const openvdb::Coord& origin, const BrickMask& changed, const BrickMask& active, const std::vector<float>& values)
+   {
+      std::vector<unsigned>& bricks = mBricks->GetValueList();
+      bricks.push_back(unsigned(origin.x()));
+      bricks.push_back(unsigned(origin.y()));
+      bricks.push_back(unsigned(origin.z()));
+      for (unsigned w = 0; w < BRICK_MASK_WORDS; ++w)
+      {
+         bricks.push_back(changed.getWord<openvdb::Index32>(w));
+      }
+      for (unsigned w = 0; w < BRICK_MASK_WORDS; ++w)
+      {
+         // Only the changed voxels matter, so mask the rest off to keep the values in step with the bits.
+         bricks.push_back(changed.getWord<openvdb::Index32>(w) & active.getWord<openvdb::Index32>(w));
+      }
 
+      // The values of a message are either all half floats or all floats, whichever list is used first.
+      if (mStoreHalfFloats && mBrickFloatValues->GetValueList().empty())
+      {
+         std::vector<unsigned short>& halfValues = mBrickHalfValues->GetValueList();
+         for (std::vector<float>::const_iterator i = values.begin(), iend = values.end(); i != iend; ++i)
+         {
+            half h(*i);
+            halfValues.push_back(h.bits());
+         }
+      }
+      else
+      {
+         std::vector<float>& floatValues = mBrickFloatValues->GetValueList();
+         floatValues.insert(floatValues.end(), values.begin(), values.end());
+      }
+   }
+
+   unsigned VolumeUpdateMessage::GetNumBricks() const
+   {
+      return unsigned(mBricks->GetValueList().size() / BRICK_HEADER_SIZE);
+   }
+
+   VolumeBrickBuilder::Brick& VolumeBrickBuilder::GetBrick(const openvdb::Coord& voxel)
+   {
+      openvdb::Coord origin = voxel & ~int(VolumeUpdateMessage::BrickLayout::DIM - 1);
+      return mBricks[origin];
+   }
+
+   void VolumeBrickBuilder::SetValueOn(const openvdb::Coord& voxel, float value)
+   {
+      Brick& brick = GetBrick(voxel);
+      openvdb::Index offset = VolumeUpdateMessage::BrickLayout::coordToOffset(voxel);
+      brick.mChanged.setOn(offset);
+      brick.mActive.setOn(offset);
+      brick.mValues[offset] = value;
+   }
+
+   void VolumeBrickBuilder::SetValueOff(const openvdb::Coord& voxel)
+   {
+      Brick& brick = GetBrick(voxel);
+      openvdb::Index offset = VolumeUpdateMessage::BrickLayout::coordToOffset(voxel);
+      brick.mChanged.setOn(offset);
+      brick.mActive.setOff(offset);
+   }
+
+   void VolumeBrickBuilder::AddTo(VolumeUpdateMessage& msg)
+   {
+      std::vector<float> values;
+      for (std::map<openvdb::Coord, Brick>::const_iterator i = mBricks.begin(), iend = mBricks.end(); i != iend; ++i)
+      {
+         const Brick& brick = i->second;
+         values.clear();
+         for (BrickMask::OnIterator itr = brick.mChanged.beginOn(); itr; ++itr)
+         {
+            if (brick.mActive.isOn(itr.pos()))
+            {
+               values.push_back(brick.mValues[itr.pos()]);
+            }
+         }
+         msg.AddBrick(i->first, brick.mChanged, brick.mActive, values);
+      }
+      Clear();
+   }
+
+   bool VolumeBrickBuilder::IsEmpty() const
+   {
+      return mBricks.empty();
+   }
+
+   void VolumeBrickBuilder::Clear()
+   {
+      mBricks.clear();
+   }
 
 } /* namespace dtVoxel */
@@ -425,6 +425,11 @@ namespace dtVoxel
                   accessor.setValueOff(c, grid->background());
                   //std::cout << "turning off coord: "  << c << std::endl;
                }
+
+               if (mCollisionCache.valid())
+               {
+                  mCollisionCache->InvalidateVoxel(c);
+               }
             }
 
             lastVector = worldVec;
@@ -438,6 +443,70 @@ namespace dtVoxel
       MarkVisualDirty(bb, 0);
    }
 
+   /////////////////////////////////////////////////////
+   template<typename GridTypePtr>
+   void VoxelActor::UpdateVolumeBricks(GridTypePtr grid, const VolumeUpdateMessage& msg, bool updateVisualOnly)
+   {
+      typedef typename GridTypePtr::element_type GridType;
+      typedef typename GridType::ValueType ValueType;
+      typedef typename GridType::Accessor AccessorType;
+
+      if (msg.GetNumBricks() == 0)
+         return;
+
+      AccessorType accessor = grid->getAccessor();
+      openvdb::Coord brickOrigin;
+      bool first = true;
+      osg::BoundingBox bb;
+
+      bool okay = msg.ForEachBrickVoxel([&](const openvdb::Coord& voxel, bool active, float value)
+      {
+         // Mark the whole brick dirty once rather than every voxel in it.
+         openvdb::Coord origin = voxel & ~int(VolumeUpdateMessage::BrickLayout::DIM - 1);
+         if (first || origin != brickOrigin)
+         {
+            if (!first)
+            {
+               MarkVisualDirty(bb, 0);
+            }
+            openvdb::BBoxd brickBox(openvdb::Vec3d(origin.x(), origin.y(), origin.z()),
+                     openvdb::Vec3d(origin.x(), origin.y(), origin.z()) + openvdb::Vec3d(VolumeUpdateMessage::BrickLayout::DIM - 1));
+            brickBox.expand(0.5);
+            openvdb::BBoxd worldBox = grid->transform().indexToWorld(brickBox);
+            bb.set(worldBox.min().x(), worldBox.min().y(), worldBox.min().z(), worldBox.max().x(), worldBox.max().y(), worldBox.max().z());
+            brickOrigin = origin;
+            first = false;
+         }
+
+         if (!updateVisualOnly)
+         {
+            if (active)
+            {
+               accessor.setValueOn(voxel, ValueType(value));
+            }
+            else
+            {
+               accessor.setValueOff(voxel, grid->background());
+            }
+
+            if (mCollisionCache.valid())
+            {
+               mCollisionCache->InvalidateVoxel(voxel);
+            }
+         }
+      });
+
+      if (!first)
+      {
+         MarkVisualDirty(bb, 0);
+      }
+
+      if (!okay)
+      {
+         LOGN_ERROR("voxelactor.cpp", "Received a VolumeUpdateMessage with truncated brick data.");
+      }
+   }
+
    /////////////////////////////////////////////////////
    void VoxelActor::UpdateVolume(const VolumeUpdateMessage& msg, bool updateVisualOnly)
    {
@@ -450,16 +519,26 @@ namespace dtVoxel
          if (gridF)
          {
             UpdateVolumeInternal(gridF, indices, values, updateVisualOnly);
+            UpdateVolumeBricks(gridF, msg, updateVisualOnly);
          }
          else
          {
             openvdb::BoolGrid::Ptr gridB = boost::dynamic_pointer_cast<openvdb::BoolGrid>(GetGrid(0));
             if (gridB)
+            {
                UpdateVolumeInternal(gridB, indices, values, updateVisualOnly);
+               UpdateVolumeBricks(gridB, msg, updateVisualOnly);
+            }
          }
       }
    }
 
+   /////////////////////////////////////////////////////
+   VoxelCollisionCache* VoxelActor::GetCollisionCache()
+   {
+      return mCollisionCache.get();
+   }
+
    /////////////////////////////////////////////////////
    void VoxelActor::OnVolumeUpdateMsg(const VolumeUpdateMessage& msg)
    {
@@ -499,7 +578,10 @@ namespace dtVoxel
                         geometry = VoxelGeometry::CreateVoxelGeometry(xform, po->GetMass(), gridB, mPhysicsTesselationMode);
                   }
                   if (geometry.valid())
+                  {
                      po->CreateFromGeometry(*geometry);
+                     mCollisionCache = geometry->GetCollisionCache();
+                  }
                }
             }
          }
@@ -509,6 +591,7 @@ namespace dtVoxel
    /////////////////////////////////////////////////////
    void VoxelActor::CleanupPhysics()
    {
+      mCollisionCache = nullptr;
       dtPhysics::PhysicsActCompPtr pac = GetComponent<dtPhysics::PhysicsActComp>();
       if (pac.valid())
       {
@@ -0,0 +1,170 @@
+/* -*-c++-*-
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2015, Caper Holdings, LLC
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include <dtVoxel/voxelcollisioncache.h>
+#include <OpenThreads/ScopedLock>
+
+namespace dtVoxel
+{
+   /////////////////////////////////////////////////////
+   bool VoxelCollisionCache::Triangle::operator==(const Triangle& other) const
+   {
+      return mVoxel == other.mVoxel
+            && mPartId == other.mPartId
+            && mTriangleIndex == other.mTriangleIndex
+            && mVertices[0] == other.mVertices[0]
+            && mVertices[1] == other.mVertices[1]
+            && mVertices[2] == other.mVertices[2];
+   }
+
+   /////////////////////////////////////////////////////
+   VoxelCollisionCache::VoxelCollisionCache(int partIdScale, PhysicsTesselationMode& mode)
+   : mPartIdScale(partIdScale)
+   , mTesselationMode(mode)
+   , mTriCount(mode == PhysicsTesselationMode::BOX_2_TRI_PER_SIDE ? 12U : 6U)
+   , mNumBlocksBuilt(0U)
+   {
+   }
+
+   /////////////////////////////////////////////////////
+   VoxelCollisionCache::~VoxelCollisionCache()
+   {
+   }
+
+   /////////////////////////////////////////////////////
+   VoxelCollisionCache::BlockPtr VoxelCollisionCache::GetBlock(const openvdb::Coord& voxel)
+   {
+      const openvdb::Coord origin = GetBlockOrigin(voxel);
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      dtCore::RefPtr<Block>& block = mBlocks[origin];
+      if (!block.valid())
+      {
+         block = new Block();
+         BuildBlock(origin, *block);
+         ++mNumBlocksBuilt;
+      }
+      return block.get();
+   }
+
+   /////////////////////////////////////////////////////
+   void VoxelCollisionCache::InvalidateVoxel(const openvdb::Coord& voxel)
+   {
+      const openvdb::Coord origin = GetBlockOrigin(voxel);
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      mBlocks.erase(origin);
+      for (unsigned axis = 0; axis < 3; ++axis)
+      {
+         openvdb::Coord offset;
+         if (voxel[axis] == origin[axis])
+         {
+            offset[axis] = -BLOCK_DIM;
+         }
+         else if (voxel[axis] == origin[axis] + BLOCK_DIM - 1)
+         {
+            offset[axis] = BLOCK_DIM;
+         }
+         else
+         {
+            continue;
+         }
+         mBlocks.erase(origin + offset);
+      }
+   }
+
+   /////////////////////////////////////////////////////
+   void VoxelCollisionCache::InvalidateAll()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      mBlocks.clear();
+   }
+
+   /////////////////////////////////////////////////////
+   unsigned VoxelCollisionCache::GetNumCachedBlocks() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return unsigned(mBlocks.size());
+   }
+
+   /////////////////////////////////////////////////////
+   unsigned VoxelCollisionCache::GetNumBlocksBuilt() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return mNumBlocksBuilt;
+   }
+
+   /////////////////////////////////////////////////////
+   void VoxelCollisionCache::AddVoxelTriangles(const openvdb::Coord& voxel, const openvdb::BBoxd& worldBox,
+            const std::bitset<6>& activeNeighbors, std::vector<Triangle>& toFill) const
+   {
+      static const int faces[] =
+            {
+                  0, 3, 2,
+                  0, 2, 1, // -x
+                  0, 1, 4,
+                  6, 0, 4, // +z
+                  4, 5, 6,
+                  5, 7, 6, // +x
+                  5, 3, 7,
+                  2, 3, 5, // -z
+                  0, 6, 3,
+                  3, 6, 7, // +y
+                  4, 2, 5,
+                  1, 2, 4  // -y
+            };
+
+      const openvdb::Vec3s min(worldBox.min());
+      const openvdb::Vec3s max(worldBox.max());
+      const openvdb::Vec3s cubeVertices[] =
+            {
+                  openvdb::Vec3s(min.x(), max.y(), max.z()),
+                  openvdb::Vec3s(min.x(), min.y(), max.z()),
+                  openvdb::Vec3s(min.x(), min.y(), min.z()),
+                  openvdb::Vec3s(min.x(), max.y(), min.z()),
+                  openvdb::Vec3s(max.x(), min.y(), max.z()),
+                  openvdb::Vec3s(max.x(), min.y(), min.z()),
+                  openvdb::Vec3s(max.x(), max.y(), max.z()),
+                  openvdb::Vec3s(max.x(), max.y(), min.z())
+            };
+
+      const unsigned divisor = mTriCount / 6U;
+      const unsigned faceMultiplier = 3U * (12U / mTriCount);
+      const int partId = mPartIdScale * voxel.x() + voxel.y();
+      const int baseTriIdx = int(mTriCount) * voxel.z();
+
+      for (unsigned triIdx = 0; triIdx < mTriCount; ++triIdx)
+      {
+         if (!activeNeighbors[triIdx / divisor])
+         {
+            Triangle triangle;
+            for (unsigned vertIdx = 0; vertIdx < 3; ++vertIdx)
+            {
+               triangle.mVertices[vertIdx] = cubeVertices[faces[faceMultiplier * triIdx + vertIdx]];
+            }
+            triangle.mVoxel = voxel;
+            triangle.mPartId = partId;
+            triangle.mTriangleIndex = baseTriIdx + int(triIdx);
+            toFill.push_back(triangle);
+         }
+      }
+   }
+
+} /* namespace dtVoxel */
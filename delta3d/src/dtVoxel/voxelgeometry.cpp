@@ -57,4 +57,9 @@ namespace dtVoxel
    {
    }
 
+   VoxelCollisionCache* VoxelGeometry::GetCollisionCache()
+   {
+      return mCollisionCache.get();
+   }
+
 } /* namespace dtVoxel */
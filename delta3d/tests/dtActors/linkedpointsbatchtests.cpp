@@ -0,0 +1,263 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <dtActors/buildingactor.h>
+#include <dtActors/engineactorregistry.h>
+#include <dtActors/linkedpointsactorproxy.h>
+#include <dtCore/actorfactory.h>
+#include <dtCore/refptr.h>
+#include <dtUtil/log.h>
+
+#include <osg/Geode>
+#include <osg/Timer>
+#include <osg/Viewport>
+#include <osgUtil/CullVisitor>
+#include <osgUtil/RenderStage>
+#include <osgUtil/StateGraph>
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace dtActors
+{
+   /// Counts the nodes and drawables that a traversal would actually visit.
+   class ActiveNodeCounter : public osg::NodeVisitor
+   {
+   public:
+      ActiveNodeCounter()
+         : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ACTIVE_CHILDREN)
+         , mNodes(0)
+         , mDrawables(0)
+      {
+      }
+
+      virtual void apply(osg::Node& node)
+      {
+         ++mNodes;
+         traverse(node);
+      }
+
+      virtual void apply(osg::Geode& geode)
+      {
+         ++mNodes;
+         mDrawables += geode.getNumDrawables();
+      }
+
+      unsigned mNodes;
+      unsigned mDrawables;
+   };
+
+   class LinkedPointsBatchTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(LinkedPointsBatchTests);
+      CPPUNIT_TEST(TestProperties);
+      CPPUNIT_TEST(TestDirtyChunks);
+      CPPUNIT_TEST(TestBuildingBatching);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+
+      void setUp() override
+      {
+         dtCore::ActorFactory::GetInstance().LoadActorRegistry(dtCore::ActorFactory::DEFAULT_ACTOR_LIBRARY);
+      }
+
+      void tearDown() override
+      {
+         dtCore::ActorFactory::GetInstance().UnloadActorRegistry(dtCore::ActorFactory::DEFAULT_ACTOR_LIBRARY);
+      }
+
+      template <typename ActorT>
+      dtCore::RefPtr<dtCore::BaseActorObject> CreateActor(const dtCore::ActorType& type, ActorT*& actor)
+      {
+         dtCore::RefPtr<dtCore::BaseActorObject> proxy = dtCore::ActorFactory::GetInstance().CreateActor(type);
+         CPPUNIT_ASSERT(proxy.valid());
+         proxy->GetDrawable(actor);
+         CPPUNIT_ASSERT(actor != NULL);
+         return proxy;
+      }
+
+      void TestProperties()
+      {
+         LinkedPointsActor* actor = NULL;
+         dtCore::RefPtr<dtCore::BaseActorObject> proxy = CreateActor(*EngineActorRegistry::LINKED_POINTS_ACTOR_TYPE, actor);
+
+         CPPUNIT_ASSERT(!actor->GetBatchGeometry());
+         CPPUNIT_ASSERT(!actor->IsBatching());
+         CPPUNIT_ASSERT(proxy->GetProperty("BatchGeometry") != NULL);
+         CPPUNIT_ASSERT(proxy->GetProperty("BatchChunkSize") != NULL);
+
+         actor->SetBatchGeometry(true);
+         CPPUNIT_ASSERT(actor->GetBatchGeometry());
+         CPPUNIT_ASSERT(actor->IsBatching());
+
+         actor->SetBatchChunkSize(0);
+         CPPUNIT_ASSERT_EQUAL(1, actor->GetBatchChunkSize());
+         actor->SetBatchChunkSize(8);
+         CPPUNIT_ASSERT_EQUAL(8, actor->GetBatchChunkSize());
+
+         // Nothing gets batched while batching is off.
+         actor->SetBatchGeometry(false);
+         actor->UpdateBatches();
+         CPPUNIT_ASSERT_EQUAL(0U, actor->GetBatchRoot()->getNumChildren());
+      }
+
+      void TestDirtyChunks()
+      {
+         LinkedPointsActor* actor = NULL;
+         dtCore::RefPtr<dtCore::BaseActorObject> proxy = CreateActor(*EngineActorRegistry::LINKED_POINTS_ACTOR_TYPE, actor);
+
+         actor->SetVisualize(true);
+         actor->SetBatchChunkSize(4);
+         for (int i = 1; i < 12; ++i)
+         {
+            actor->AddPoint(osg::Vec3(float(i) * 10.0f, 0.0f, 0.0f));
+         }
+         std::vector<unsigned> originalMasks;
+         for (int i = 0; i < actor->GetPointCount(); ++i)
+         {
+            osg::Node* pointNode = actor->GetPointDrawable(i)->GetOSGNode();
+            pointNode->setNodeMask(0x00FF0000 | unsigned(i));
+            originalMasks.push_back(pointNode->getNodeMask());
+            CPPUNIT_ASSERT(pointNode->getCullCallback() == NULL);
+         }
+         actor->SetBatchGeometry(true);
+
+         CPPUNIT_ASSERT_EQUAL(3, actor->GetDirtyBatchCount());
+         actor->UpdateBatches();
+         CPPUNIT_ASSERT_EQUAL(0, actor->GetDirtyBatchCount());
+         CPPUNIT_ASSERT_EQUAL(3U, actor->GetBatchRoot()->getNumChildren());
+
+         // Every point is culled in favor of its batch, but keeps its mask so it can still be intersected.
+         for (int i = 0; i < actor->GetPointCount(); ++i)
+         {
+            osg::Node* pointNode = actor->GetPointDrawable(i)->GetOSGNode();
+            CPPUNIT_ASSERT_EQUAL(originalMasks[i], unsigned(pointNode->getNodeMask()));
+            CPPUNIT_ASSERT(pointNode->getCullCallback() != NULL);
+         }
+
+         // Moving point 5 touches points 4 through 6, which are all in the second chunk.
+         osg::Node* firstChunk = actor->GetBatchRoot()->getChild(0);
+         actor->SetPointPosition(5, osg::Vec3(50.0f, 5.0f, 0.0f));
+         CPPUNIT_ASSERT_EQUAL(1, actor->GetDirtyBatchCount());
+         actor->UpdateBatches();
+         CPPUNIT_ASSERT_MESSAGE("An untouched chunk should not be rebuilt.", actor->GetBatchRoot()->getChild(0) == firstChunk);
+
+         // Point 4 also changes point 3 in the first chunk.
+         actor->SetPointPosition(4, osg::Vec3(40.0f, 5.0f, 0.0f));
+         CPPUNIT_ASSERT_EQUAL(2, actor->GetDirtyBatchCount());
+         actor->UpdateBatches();
+
+         // Removing a point shifts every chunk after it.
+         actor->RemovePoint(1);
+         CPPUNIT_ASSERT_EQUAL(3, actor->GetDirtyBatchCount());
+         actor->UpdateBatches();
+         CPPUNIT_ASSERT_EQUAL(3U, actor->GetBatchRoot()->getNumChildren());
+
+         // Point 1 was removed, so the remaining points are the original 0 and 2 on.
+         actor->SetBatchGeometry(false);
+         CPPUNIT_ASSERT_EQUAL(0U, actor->GetBatchRoot()->getNumChildren());
+         for (int i = 0; i < actor->GetPointCount(); ++i)
+         {
+            osg::Node* pointNode = actor->GetPointDrawable(i)->GetOSGNode();
+            CPPUNIT_ASSERT_EQUAL(originalMasks[i == 0 ? 0 : i + 1], unsigned(pointNode->getNodeMask()));
+            CPPUNIT_ASSERT(pointNode->getCullCallback() == NULL);
+         }
+      }
+
+      double TimeCull(osg::Node& node, int passes)
+      {
+         dtCore::RefPtr<osg::Viewport> viewport = new osg::Viewport(0, 0, 1280, 720);
+         dtCore::RefPtr<osgUtil::CullVisitor> cullVisitor = new osgUtil::CullVisitor();
+         dtCore::RefPtr<osgUtil::StateGraph> stateGraph = new osgUtil::StateGraph();
+         dtCore::RefPtr<osgUtil::RenderStage> renderStage = new osgUtil::RenderStage();
+         renderStage->setViewport(viewport.get());
+         cullVisitor->setStateGraph(stateGraph.get());
+         cullVisitor->setRenderStage(renderStage.get());
+
+         dtCore::RefPtr<osg::RefMatrix> projection = new osg::RefMatrix(osg::Matrix::perspective(60.0, 1280.0 / 720.0, 1.0, 5000.0));
+         dtCore::RefPtr<osg::RefMatrix> modelView = new osg::RefMatrix(osg::Matrix::lookAt(
+            osg::Vec3(0.0f, -400.0f, 200.0f), osg::Vec3(), osg::Vec3(0.0f, 0.0f, 1.0f)));
+
+         osg::Timer timer;
+         osg::Timer_t start = timer.tick();
+         for (int i = 0; i < passes; ++i)
+         {
+            cullVisitor->reset();
+            stateGraph->clean();
+            renderStage->reset();
+
+            cullVisitor->pushViewport(viewport.get());
+            cullVisitor->pushProjectionMatrix(projection.get());
+            cullVisitor->pushModelViewMatrix(modelView.get(), osg::Transform::ABSOLUTE_RF);
+            node.accept(*cullVisitor);
+            cullVisitor->popModelViewMatrix();
+            cullVisitor->popProjectionMatrix();
+            cullVisitor->popViewport();
+         }
+         return timer.delta_m(start, timer.tick()) / double(passes);
+      }
+
+      void TestBuildingBatching()
+      {
+         BuildingActor* actor = NULL;
+         dtCore::RefPtr<dtCore::BaseActorObject> proxy = CreateActor(*EngineActorRegistry::BUILDING_ACTOR_TYPE, actor);
+
+         const int pointCount = 96;
+         std::vector<dtCore::RefPtr<dtCore::Transformable> > points;
+         for (int i = 0; i < pointCount; ++i)
+         {
+            float angle = float(i) / float(pointCount) * 2.0f * float(osg::PI);
+            points.push_back(actor->CreatePointDrawable(osg::Vec3(std::cos(angle), std::sin(angle), 0.0f) * 150.0f));
+         }
+         actor->SetPointList(points);
+
+         const int passes = 200;
+         ActiveNodeCounter before;
+         actor->GetOSGNode()->accept(before);
+         double cullBefore = TimeCull(*actor->GetOSGNode(), passes);
+
+         actor->SetBatchGeometry(true);
+         actor->UpdateBatches();
+
+         ActiveNodeCounter after;
+         actor->GetOSGNode()->accept(after);
+         double cullAfter = TimeCull(*actor->GetOSGNode(), passes);
+
+         std::ostringstream ss;
+         ss << "Building with " << pointCount << " points, chunk size " << actor->GetBatchChunkSize()
+            << ": nodes " << before.mNodes << " -> " << after.mNodes
+            << ", drawables " << before.mDrawables << " -> " << after.mDrawables
+            << ", cull " << cullBefore << " ms -> " << cullAfter << " ms";
+         LOG_ALWAYS(ss.str());
+
+         CPPUNIT_ASSERT_MESSAGE("Batching should reduce the number of traversed nodes.", after.mNodes < before.mNodes);
+         CPPUNIT_ASSERT_MESSAGE("Batching should merge the wall geometry.", after.mDrawables < before.mDrawables);
+      }
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(LinkedPointsBatchTests);
+}
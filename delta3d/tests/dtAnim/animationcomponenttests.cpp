@@ -26,6 +26,7 @@
 #include <dtUtil/log.h>
 #include <dtUtil/datapathutils.h>
 #include <dtUtil/stringutils.h>
+#include <dtUtil/mathdefines.h>
 
 #include <dtABC/application.h>
 
@@ -33,7 +34,9 @@
 #include <dtAnim/animationhelper.h>
 #include <dtAnim/animnodebuilder.h>
 #include <dtAnim/animactorregistry.h>
+#include <dtAnim/boneinterface.h>
 #include <dtAnim/modeldatabase.h>
+#include <dtAnim/sharedposecache.h>
 
 #include <dtCore/refptr.h>
 #include <dtCore/system.h>
@@ -41,6 +44,7 @@
 #include <dtCore/camera.h>
 #include <dtCore/deltawin.h>
 #include <dtCore/timer.h>
+#include <dtCore/transformable.h>
 
 #include <dtGame/gamemanager.h>
 #include <dtGame/basemessages.h>
@@ -55,6 +59,7 @@
 #include <osg/Geode>
 
 #include <string>
+#include <vector>
 
 extern dtABC::Application& GetGlobalApplication();
 
@@ -86,6 +91,9 @@ namespace dtAnim
          CPPUNIT_TEST(TestAnimationEventFiring_FullSpeed);
          CPPUNIT_TEST(TestAnimationEventFiring_TwiceSpeed);
          CPPUNIT_TEST(TestAnimationEventFiring_HalfSpeed);
+         CPPUNIT_TEST(TestSharedPoses);
+         CPPUNIT_TEST(TestSkeletonUpdateLODs);
+         CPPUNIT_TEST(TestCrowdAnimationPerformance);
       CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -104,9 +112,17 @@ namespace dtAnim
       void TestAnimationEventFiring_FullSpeed();
       void TestAnimationEventFiring_TwiceSpeed();
       void TestAnimationEventFiring_HalfSpeed();
+      void TestSharedPoses();
+      void TestSkeletonUpdateLODs();
+      void TestCrowdAnimationPerformance();
 
       void SubtestAnimationEventFiring(float speed);
 
+      typedef std::vector<dtCore::RefPtr<dtGame::GameActorProxy> > CrowdVector;
+      /// Creates loaded marines in rows of 32, spaced 2 meters apart, all playing the walk cycle.
+      void CreateCrowd(unsigned count, CrowdVector& crowd);
+      void TickAnimationComponent(unsigned count, float dt);
+
       // Helper methods.
       void LoadAnimationACModel();
 
@@ -591,4 +607,165 @@ namespace dtAnim
       CPPUNIT_ASSERT(gem.FindEvent(eventMid3) != NULL);
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   void AnimationComponentTests::CreateCrowd(unsigned count, CrowdVector& crowd)
+   {
+      dtCore::Project::GetInstance().SetContext(dtUtil::GetDeltaRootPath() + "/examples/data");
+
+      for (unsigned i = 0; i < count; ++i)
+      {
+         dtCore::RefPtr<dtGame::GameActorProxy> actor;
+         mGM->CreateActor(*dtAnim::AnimActorRegistry::ANIMATION_ACTOR_TYPE, actor);
+         CPPUNIT_ASSERT(actor.valid());
+
+         dtCore::Transform xform;
+         xform.SetTranslation(osg::Vec3(float(i % 32) * 2.0f, float(i / 32) * 2.0f, 0.0f));
+         actor->GetDrawable<dtCore::Transformable>()->SetTransform(xform);
+
+         AnimationHelper* helper = actor->GetComponent<AnimationHelper>();
+         helper->SetLoadModelAsynchronously(false);
+         helper->SetSkeletalMesh(dtCore::ResourceDescriptor("SkeletalMeshes:Marine:marine.xml"));
+         mGM->AddActor(*actor, false, false);
+         CPPUNIT_ASSERT(helper->GetModelWrapper() != NULL);
+         helper->PlayAnimation("Walk");
+
+         crowd.push_back(actor);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void AnimationComponentTests::TickAnimationComponent(unsigned count, float dt)
+   {
+      dtCore::RefPtr<dtGame::TickMessage> tick;
+      mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::TICK_LOCAL, tick);
+      tick->SetDeltaSimTime(dt);
+      for (unsigned i = 0; i < count; ++i)
+      {
+         mAnimComp->ProcessMessage(*tick);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void AnimationComponentTests::TestSharedPoses()
+   {
+      CrowdVector crowd;
+      CreateCrowd(4, crowd);
+
+      mAnimComp->SetSharedPosesEnabled(true);
+      SharedPoseCache& cache = mAnimComp->GetSharedPoseCache();
+      for (unsigned i = 0; i < crowd.size(); ++i)
+      {
+         CPPUNIT_ASSERT(crowd[i]->GetComponent<AnimationHelper>()->GetSharedPoseCache() == &cache);
+      }
+
+      cache.ResetCounters();
+      TickAnimationComponent(10, 1.0f / 60.0f);
+
+      CPPUNIT_ASSERT_MESSAGE("Characters walking in step should share the evaluated poses.", cache.GetNumHits() > 0U);
+      CPPUNIT_ASSERT(cache.GetNumPoses() > 0U);
+
+      dtAnim::BoneArray bones0, bones1;
+      crowd[0]->GetComponent<AnimationHelper>()->GetModelWrapper()->GetBones(bones0);
+      crowd[1]->GetComponent<AnimationHelper>()->GetModelWrapper()->GetBones(bones1);
+      CPPUNIT_ASSERT(!bones0.empty());
+      CPPUNIT_ASSERT_EQUAL(bones0.size(), bones1.size());
+      for (unsigned i = 0; i < bones0.size(); ++i)
+      {
+         CPPUNIT_ASSERT(dtUtil::Equivalent(bones0[i]->GetAbsoluteRotation().asVec4(), bones1[i]->GetAbsoluteRotation().asVec4(), 1e-4));
+      }
+
+      mAnimComp->SetSharedPosesEnabled(false);
+      CPPUNIT_ASSERT_EQUAL(0U, cache.GetNumPoses());
+      CPPUNIT_ASSERT(crowd[0]->GetComponent<AnimationHelper>()->GetSharedPoseCache() == NULL);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void AnimationComponentTests::TestSkeletonUpdateLODs()
+   {
+      CrowdVector crowd;
+      CreateCrowd(3, crowd);
+
+      dtCore::Transform xform;
+      xform.SetTranslation(osg::Vec3(20.0f, 0.0f, 0.0f));
+      crowd[1]->GetDrawable<dtCore::Transformable>()->SetTransform(xform);
+      xform.SetTranslation(osg::Vec3(100.0f, 0.0f, 0.0f));
+      crowd[2]->GetDrawable<dtCore::Transformable>()->SetTransform(xform);
+
+      AnimationComponent::SkeletonUpdateLODVector lods;
+      lods.push_back(AnimationComponent::SkeletonUpdateLOD(50.0f, 0.25f));
+      lods.push_back(AnimationComponent::SkeletonUpdateLOD(10.0f, 0.1f));
+      mAnimComp->SetSkeletonUpdateLODs(lods);
+      CPPUNIT_ASSERT_EQUAL(size_t(2), mAnimComp->GetSkeletonUpdateLODs().size());
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("The tiers should be sorted by distance.",
+               10.0f, mAnimComp->GetSkeletonUpdateLODs()[0].mDistance);
+
+      TickAnimationComponent(1, 1.0f / 60.0f);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Nothing should be throttled without an eye point.",
+               0.0f, crowd[2]->GetComponent<AnimationHelper>()->GetSkeletonUpdateInterval());
+
+      mAnimComp->SetEyePointActor(crowd[0]->GetDrawable<dtCore::Transformable>());
+      TickAnimationComponent(1, 1.0f / 60.0f);
+      CPPUNIT_ASSERT_EQUAL(0.0f, crowd[0]->GetComponent<AnimationHelper>()->GetSkeletonUpdateInterval());
+      CPPUNIT_ASSERT_EQUAL(0.1f, crowd[1]->GetComponent<AnimationHelper>()->GetSkeletonUpdateInterval());
+      CPPUNIT_ASSERT_EQUAL(0.25f, crowd[2]->GetComponent<AnimationHelper>()->GetSkeletonUpdateInterval());
+
+      // The throttled characters should still move, just less often.
+      dtAnim::BoneInterface* bone = crowd[2]->GetComponent<AnimationHelper>()->GetModelWrapper()->GetBoneByIndex(1);
+      CPPUNIT_ASSERT(bone != NULL);
+      osg::Quat before = bone->GetAbsoluteRotation();
+      TickAnimationComponent(30, 1.0f / 60.0f);
+      CPPUNIT_ASSERT(!dtUtil::Equivalent(before.asVec4(), bone->GetAbsoluteRotation().asVec4(), 1e-6));
+
+      mAnimComp->SetSkeletonUpdateLODs(AnimationComponent::SkeletonUpdateLODVector());
+      CPPUNIT_ASSERT_EQUAL(0.0f, crowd[1]->GetComponent<AnimationHelper>()->GetSkeletonUpdateInterval());
+      CPPUNIT_ASSERT_EQUAL(0.0f, crowd[2]->GetComponent<AnimationHelper>()->GetSkeletonUpdateInterval());
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void AnimationComponentTests::TestCrowdAnimationPerformance()
+   {
+      const unsigned numCharacters = 1000;
+      const unsigned numUpdates = 60;
+      const float updateTime = 1.0f / 60.0f;
+
+      CrowdVector crowd;
+      CreateCrowd(numCharacters, crowd);
+
+      // Put the characters at different points in the walk cycle so it doesn't
+      // measure a crowd that's perfectly in step.
+      for (unsigned i = 0; i < crowd.size(); ++i)
+      {
+         crowd[i]->GetComponent<AnimationHelper>()->Update(0.013f * float(i % 77));
+      }
+
+      dtCore::Timer timer;
+      dtCore::Timer_t timerStart = timer.Tick();
+      TickAnimationComponent(numUpdates, updateTime);
+      double baselineMs = timer.DeltaMil(timerStart, timer.Tick());
+
+      mAnimComp->SetSharedPosesEnabled(true);
+      mAnimComp->GetSharedPoseCache().ResetCounters();
+      timerStart = timer.Tick();
+      TickAnimationComponent(numUpdates, updateTime);
+      double sharedMs = timer.DeltaMil(timerStart, timer.Tick());
+      unsigned hits = mAnimComp->GetSharedPoseCache().GetNumHits();
+      unsigned misses = mAnimComp->GetSharedPoseCache().GetNumMisses();
+
+      AnimationComponent::SkeletonUpdateLODVector lods;
+      lods.push_back(AnimationComponent::SkeletonUpdateLOD(20.0f, 0.1f));
+      lods.push_back(AnimationComponent::SkeletonUpdateLOD(40.0f, 0.25f));
+      mAnimComp->SetSkeletonUpdateLODs(lods);
+      mAnimComp->SetEyePointActor(crowd[0]->GetDrawable<dtCore::Transformable>());
+      timerStart = timer.Tick();
+      TickAnimationComponent(numUpdates, updateTime);
+      double lodMs = timer.DeltaMil(timerStart, timer.Tick());
+
+      std::ostringstream ss;
+      ss << "Animation update of " << numCharacters << " walking characters, average ms per frame over "
+         << numUpdates << " frames: each skeleton evaluated " << baselineMs / numUpdates
+         << ", shared poses " << sharedMs / numUpdates << " (" << hits << " hits, " << misses << " misses)"
+         << ", shared poses with update LODs " << lodMs / numUpdates;
+      LOG_ALWAYS(ss.str());
+   }
+
 } // namespace dtAnim
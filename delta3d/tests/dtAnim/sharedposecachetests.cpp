@@ -0,0 +1,183 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <dtAnim/sharedposecache.h>
+#include <dtCore/refptr.h>
+
+namespace dtAnim
+{
+   class SharedPoseCacheTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(SharedPoseCacheTests);
+      CPPUNIT_TEST(TestKeys);
+      CPPUNIT_TEST(TestQuantize);
+      CPPUNIT_TEST(TestFindAndInsert);
+      CPPUNIT_TEST(TestAdvanceFrame);
+      CPPUNIT_TEST(TestMaxPoses);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp() override
+      {
+         mCache = new SharedPoseCache;
+      }
+
+      void tearDown() override
+      {
+         mCache = NULL;
+      }
+
+      void TestKeys()
+      {
+         int modelA = 0, modelB = 0;
+         SharedPoseCache::Key key1, key2;
+         key1.Reset(&modelA);
+         key2.Reset(&modelA);
+         CPPUNIT_ASSERT(key1 == key2);
+
+         key1.Add(3U);
+         key1.Add(12U);
+         CPPUNIT_ASSERT(!(key1 == key2));
+         key2.Add(3U);
+         key2.Add(12U);
+         CPPUNIT_ASSERT(key1 == key2);
+         CPPUNIT_ASSERT_EQUAL(key1.GetHash(), key2.GetHash());
+         CPPUNIT_ASSERT(!(key1 < key2) && !(key2 < key1));
+
+         key2.Reset(&modelB);
+         key2.Add(3U);
+         key2.Add(12U);
+         CPPUNIT_ASSERT_MESSAGE("Keys for different models must not match.", !(key1 == key2));
+         CPPUNIT_ASSERT(key1 < key2 || key2 < key1);
+
+         key2.Reset(&modelA);
+         key2.Add(12U);
+         key2.Add(3U);
+         CPPUNIT_ASSERT_MESSAGE("The order of the values matters.", !(key1 == key2));
+      }
+
+      void TestQuantize()
+      {
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0f / 30.0f, mCache->GetTimeQuantum(), 1e-6f);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0f / 32.0f, mCache->GetWeightQuantum(), 1e-6f);
+
+         mCache->SetTimeQuantum(0.1f);
+         CPPUNIT_ASSERT_EQUAL(size_t(0), mCache->QuantizeTime(0.0f));
+         CPPUNIT_ASSERT_EQUAL(size_t(0), mCache->QuantizeTime(-1.0f));
+         CPPUNIT_ASSERT_EQUAL(size_t(3), mCache->QuantizeTime(0.31f));
+         CPPUNIT_ASSERT_EQUAL(size_t(3), mCache->QuantizeTime(0.39f));
+         CPPUNIT_ASSERT_EQUAL(size_t(4), mCache->QuantizeTime(0.41f));
+
+         mCache->SetWeightQuantum(0.25f);
+         CPPUNIT_ASSERT_EQUAL(size_t(4), mCache->QuantizeWeight(1.0f));
+         CPPUNIT_ASSERT_EQUAL(size_t(4), mCache->QuantizeWeight(0.9f));
+         CPPUNIT_ASSERT_EQUAL(size_t(2), mCache->QuantizeWeight(0.5f));
+         CPPUNIT_ASSERT_EQUAL(size_t(0), mCache->QuantizeWeight(0.1f));
+
+         mCache->SetTimeQuantum(0.0f);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("A zero quantum should not divide by zero.", size_t(0), mCache->QuantizeTime(5.0f));
+      }
+
+      void TestFindAndInsert()
+      {
+         int model = 0;
+         SharedPoseCache::Key key;
+         key.Reset(&model);
+         key.Add(7U);
+
+         CPPUNIT_ASSERT(!mCache->Find(key).valid());
+         CPPUNIT_ASSERT_EQUAL(0U, mCache->GetNumHits());
+         CPPUNIT_ASSERT_EQUAL(1U, mCache->GetNumMisses());
+
+         dtCore::RefPtr<SharedPoseCache::Pose> pose = new SharedPoseCache::Pose;
+         pose->mBones.resize(2);
+         pose->mBones[1].mTranslation[2] = 4.0f;
+         mCache->Insert(key, *pose);
+         CPPUNIT_ASSERT_EQUAL(1U, mCache->GetNumPoses());
+
+         dtCore::RefPtr<const SharedPoseCache::Pose> found = mCache->Find(key);
+         CPPUNIT_ASSERT(found.get() == pose.get());
+         CPPUNIT_ASSERT_EQUAL(1U, mCache->GetNumHits());
+
+         dtCore::RefPtr<SharedPoseCache::Pose> otherPose = new SharedPoseCache::Pose;
+         mCache->Insert(key, *otherPose);
+         CPPUNIT_ASSERT_MESSAGE("The first pose inserted for a key should be kept.", mCache->Find(key).get() == pose.get());
+
+         mCache->ResetCounters();
+         CPPUNIT_ASSERT_EQUAL(0U, mCache->GetNumHits());
+         CPPUNIT_ASSERT_EQUAL(0U, mCache->GetNumMisses());
+
+         mCache->Clear();
+         CPPUNIT_ASSERT_EQUAL(0U, mCache->GetNumPoses());
+         CPPUNIT_ASSERT(!mCache->Find(key).valid());
+      }
+
+      void TestAdvanceFrame()
+      {
+         mCache->SetMaxIdleFrames(2U);
+
+         int model = 0;
+         SharedPoseCache::Key used, unused;
+         used.Reset(&model);
+         used.Add(1U);
+         unused.Reset(&model);
+         unused.Add(2U);
+
+         dtCore::RefPtr<SharedPoseCache::Pose> pose = new SharedPoseCache::Pose;
+         mCache->Insert(used, *pose);
+         mCache->Insert(unused, *pose);
+
+         for (unsigned i = 0; i < 3; ++i)
+         {
+            mCache->AdvanceFrame();
+            CPPUNIT_ASSERT(mCache->Find(used).valid());
+         }
+
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Only the pose that is still being used should be left.", 1U, mCache->GetNumPoses());
+         CPPUNIT_ASSERT(mCache->Find(used).valid());
+         CPPUNIT_ASSERT(!mCache->Find(unused).valid());
+      }
+
+      void TestMaxPoses()
+      {
+         mCache->SetMaxPoses(3U);
+         int model = 0;
+         dtCore::RefPtr<SharedPoseCache::Pose> pose = new SharedPoseCache::Pose;
+         for (unsigned i = 0; i < 10; ++i)
+         {
+            SharedPoseCache::Key key;
+            key.Reset(&model);
+            key.Add(i);
+            mCache->Insert(key, *pose);
+         }
+         CPPUNIT_ASSERT_EQUAL(3U, mCache->GetNumPoses());
+      }
+
+   private:
+      dtCore::RefPtr<SharedPoseCache> mCache;
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(SharedPoseCacheTests);
+}
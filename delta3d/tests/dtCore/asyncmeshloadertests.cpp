@@ -0,0 +1,212 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtCore/asyncmeshloader.h>
+#include <dtCore/object.h>
+#include <dtUtil/datapathutils.h>
+
+#include <OpenThreads/Thread>
+#include <osg/MatrixTransform>
+
+class AsyncMeshLoaderTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(AsyncMeshLoaderTests);
+   CPPUNIT_TEST(TestLoadAndCommit);
+   CPPUNIT_TEST(TestSharedLoads);
+   CPPUNIT_TEST(TestUncachedLoadsAreSeparate);
+   CPPUNIT_TEST(TestCachedLoadMatchesSync);
+   CPPUNIT_TEST(TestReplacedLoad);
+   CPPUNIT_TEST(TestDeletedOwner);
+   CPPUNIT_TEST(TestFrameBudget);
+   CPPUNIT_TEST_SUITE_END();
+
+public:
+   void setUp()
+   {
+      dtUtil::SetDataFilePathList(dtUtil::GetDeltaRootPath() + "/tests/data/ProjectContext/");
+      mMeshFile = dtUtil::FindFileInPathList("StaticMeshes/articulation_test.ive");
+      CPPUNIT_ASSERT(!mMeshFile.empty());
+      mMissingFile = "StaticMeshes/not_a_real_mesh.ive";
+   }
+
+   void tearDown()
+   {
+      dtCore::AsyncMeshLoader::GetInstance().WaitForAll();
+   }
+
+   void TestLoadAndCommit()
+   {
+      dtCore::AsyncMeshLoader& loader = dtCore::AsyncMeshLoader::GetInstance();
+      dtCore::RefPtr<dtCore::Object> obj = new dtCore::Object("Async");
+
+      obj->LoadFileAsync(mMeshFile);
+      CPPUNIT_ASSERT(obj->IsLoadingAsynchronously());
+      CPPUNIT_ASSERT_EQUAL(mMeshFile, obj->GetFilename());
+      // nothing is attached until the commit, even if the file was read on this thread.
+      CPPUNIT_ASSERT_EQUAL(0U, obj->GetMatrixTransform().getNumChildren());
+      CPPUNIT_ASSERT_EQUAL(1U, loader.GetNumPending());
+
+      loader.WaitForAll();
+      CPPUNIT_ASSERT(!obj->IsLoadingAsynchronously());
+      CPPUNIT_ASSERT_EQUAL(0U, loader.GetNumPending());
+      CPPUNIT_ASSERT_EQUAL(0U, loader.GetNumLoadsInFlight());
+      CPPUNIT_ASSERT_EQUAL(1U, obj->GetMatrixTransform().getNumChildren());
+
+      obj->LoadFileAsync(mMissingFile);
+      loader.WaitForAll();
+      CPPUNIT_ASSERT_MESSAGE("A failed load should clear the geometry like LoadFile does.",
+               obj->GetMatrixTransform().getNumChildren() == 0U);
+   }
+
+   void TestSharedLoads()
+   {
+      dtCore::AsyncMeshLoader& loader = dtCore::AsyncMeshLoader::GetInstance();
+      dtCore::RefPtr<dtCore::Object> obj1 = new dtCore::Object("Async1");
+      dtCore::RefPtr<dtCore::Object> obj2 = new dtCore::Object("Async2");
+
+      unsigned sharedBefore = loader.GetNumSharedLoads();
+      obj1->LoadFileAsync(mMeshFile, true);
+      obj2->LoadFileAsync(mMeshFile, true);
+      CPPUNIT_ASSERT_EQUAL(2U, loader.GetNumPending());
+      CPPUNIT_ASSERT_EQUAL(1U, loader.GetNumLoadsInFlight());
+      CPPUNIT_ASSERT_EQUAL(sharedBefore + 1U, loader.GetNumSharedLoads());
+
+      loader.WaitForAll();
+      CPPUNIT_ASSERT_EQUAL(1U, obj1->GetMatrixTransform().getNumChildren());
+      CPPUNIT_ASSERT_EQUAL(1U, obj2->GetMatrixTransform().getNumChildren());
+      CPPUNIT_ASSERT(obj1->GetMatrixTransform().getChild(0) == obj2->GetMatrixTransform().getChild(0));
+   }
+
+   void TestUncachedLoadsAreSeparate()
+   {
+      dtCore::AsyncMeshLoader& loader = dtCore::AsyncMeshLoader::GetInstance();
+      dtCore::RefPtr<dtCore::Object> obj1 = new dtCore::Object("Async1");
+      dtCore::RefPtr<dtCore::Object> obj2 = new dtCore::Object("Async2");
+
+      obj1->LoadFileAsync(mMeshFile, false);
+      obj2->LoadFileAsync(mMeshFile, false);
+      CPPUNIT_ASSERT_EQUAL(2U, loader.GetNumLoadsInFlight());
+
+      loader.WaitForAll();
+      CPPUNIT_ASSERT_EQUAL(1U, obj1->GetMatrixTransform().getNumChildren());
+      CPPUNIT_ASSERT_EQUAL(1U, obj2->GetMatrixTransform().getNumChildren());
+      CPPUNIT_ASSERT(obj1->GetMatrixTransform().getChild(0) != obj2->GetMatrixTransform().getChild(0));
+   }
+
+   void TestCachedLoadMatchesSync()
+   {
+      dtCore::AsyncMeshLoader& loader = dtCore::AsyncMeshLoader::GetInstance();
+      dtCore::RefPtr<dtCore::Object> syncObj = new dtCore::Object("Sync");
+      dtCore::RefPtr<dtCore::Object> asyncObj = new dtCore::Object("Async");
+
+      syncObj->LoadFile(mMeshFile, true);
+      CPPUNIT_ASSERT_EQUAL(1U, syncObj->GetMatrixTransform().getNumChildren());
+      osg::Node* syncNode = syncObj->GetMatrixTransform().getChild(0);
+      const unsigned numChildren = syncNode->asGroup() != NULL ? syncNode->asGroup()->getNumChildren() : 0U;
+
+      asyncObj->LoadFileAsync(mMeshFile, true);
+      loader.WaitForAll();
+      CPPUNIT_ASSERT_EQUAL(1U, asyncObj->GetMatrixTransform().getNumChildren());
+      CPPUNIT_ASSERT_MESSAGE("A cached async load should get the same node from the cache as a sync load.",
+               asyncObj->GetMatrixTransform().getChild(0) == syncNode);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("The shared node must not be optimized on the loading thread.",
+               numChildren, syncNode->asGroup() != NULL ? syncNode->asGroup()->getNumChildren() : 0U);
+   }
+
+   void TestReplacedLoad()
+   {
+      dtCore::AsyncMeshLoader& loader = dtCore::AsyncMeshLoader::GetInstance();
+      dtCore::RefPtr<dtCore::Object> obj = new dtCore::Object("Async");
+
+      obj->LoadFileAsync(mMeshFile);
+      obj->LoadFileAsync(mMissingFile);
+      loader.WaitForAll();
+      CPPUNIT_ASSERT_EQUAL(0U, obj->GetMatrixTransform().getNumChildren());
+
+      obj->LoadFileAsync(mMissingFile);
+      obj->LoadFileAsync(mMeshFile);
+      loader.WaitForAll();
+      CPPUNIT_ASSERT_EQUAL(1U, obj->GetMatrixTransform().getNumChildren());
+
+      // a synchronous load cancels the async one.
+      obj->LoadFileAsync(mMeshFile);
+      obj->LoadFile(mMissingFile);
+      CPPUNIT_ASSERT(!obj->IsLoadingAsynchronously());
+      loader.WaitForAll();
+      CPPUNIT_ASSERT_EQUAL(0U, obj->GetMatrixTransform().getNumChildren());
+   }
+
+   void TestDeletedOwner()
+   {
+      dtCore::AsyncMeshLoader& loader = dtCore::AsyncMeshLoader::GetInstance();
+      dtCore::RefPtr<dtCore::Object> obj = new dtCore::Object("Async");
+      dtCore::ObserverPtr<dtCore::Object> observer = obj.get();
+
+      obj->LoadFileAsync(mMeshFile);
+      obj = NULL;
+
+      // must not call back into the deleted object.
+      loader.WaitForAll();
+      CPPUNIT_ASSERT_EQUAL(0U, loader.GetNumPending());
+   }
+
+   void TestFrameBudget()
+   {
+      const unsigned numObjects = 5U;
+      dtCore::AsyncMeshLoader& loader = dtCore::AsyncMeshLoader::GetInstance();
+
+      std::vector<dtCore::RefPtr<dtCore::Object> > objects;
+      for (unsigned i = 0; i < numObjects; ++i)
+      {
+         objects.push_back(new dtCore::Object("Async"));
+         objects.back()->LoadFileAsync(mMeshFile);
+      }
+
+      // With no budget, one load is committed per frame.
+      unsigned numCommitted = 0U;
+      for (unsigned tries = 0; numCommitted < numObjects && tries < 10000U; ++tries)
+      {
+         unsigned committed = loader.CommitCompleted(0.0);
+         CPPUNIT_ASSERT(committed <= 1U);
+         numCommitted += committed;
+         if (committed == 0U)
+         {
+            OpenThreads::Thread::microSleep(1000);
+         }
+      }
+      CPPUNIT_ASSERT_EQUAL(numObjects, numCommitted);
+
+      for (unsigned i = 0; i < numObjects; ++i)
+      {
+         CPPUNIT_ASSERT_EQUAL(1U, objects[i]->GetMatrixTransform().getNumChildren());
+      }
+   }
+
+private:
+   std::string mMeshFile;
+   std::string mMissingFile;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AsyncMeshLoaderTests);
@@ -36,12 +36,18 @@
 #include <dtCore/scene.h>
 #include <dtCore/system.h>
 #include <dtCore/exceptionenum.h>
+#include <dtCore/transformable.h>
 #include <dtABC/application.h>
 
 #include <dtUtil/exception.h>
+#include <dtUtil/threadpool.h>
 
+#include <osg/Geode>
+#include <osg/Geometry>
 #include <osg/io_utils>
 
+#include <cmath>
+
 extern dtABC::Application& GetGlobalApplication();
 
 class BatchISectorTests : public CPPUNIT_NS::TestFixture 
@@ -49,6 +55,7 @@ class BatchISectorTests : public CPPUNIT_NS::TestFixture
    CPPUNIT_TEST_SUITE(BatchISectorTests);
 
       CPPUNIT_TEST(TestIntersection);
+      CPPUNIT_TEST(TestThreadPoolUpdate);
 
    CPPUNIT_TEST_SUITE_END();
 
@@ -152,6 +159,75 @@ class BatchISectorTests : public CPPUNIT_NS::TestFixture
       }
 
 
+      void TestThreadPoolUpdate()
+      {
+         CPPUNIT_ASSERT(!mBatchIsector->GetUseThreadPool());
+
+         dtCore::RefPtr<dtCore::Transformable> terrain = new dtCore::Transformable("Heightfield");
+         terrain->GetMatrixNode()->addChild(CreateHeightfield(64, 2.0f));
+         mBatchIsector->SetQueryRoot(terrain.get());
+
+         // A 4 x 8 grid of rays covering every isector, with the odd ones checking for the closest drawable.
+         for (int i = 0; i < 32; ++i)
+         {
+            dtCore::BatchIsector::SingleISector& iSector = mBatchIsector->EnableAndGetISector(i);
+            float x = 10.0f + 30.0f * float(i % 4);
+            float y = 5.0f + 15.0f * float(i / 4);
+            iSector.SetSectorAsLineSegment(osg::Vec3(x, y, 100.0f), osg::Vec3(x, y, -100.0f));
+            iSector.SetToCheckForClosestDrawable(i % 2 == 1);
+         }
+
+         CPPUNIT_ASSERT(mBatchIsector->Update(osg::Vec3(0.0f, 0.0f, 0.0f), true));
+         std::vector<osg::Vec3> serialPoints, serialNormals;
+         GetHits(serialPoints, serialNormals);
+
+         bool initPool = !dtUtil::ThreadPool::IsInitialized();
+         if (initPool)
+         {
+            dtUtil::ThreadPool::Init();
+         }
+
+         mBatchIsector->SetUseThreadPool(true);
+         std::vector<osg::Vec3> parallelPoints, parallelNormals;
+         std::vector<dtCore::DeltaDrawable*> closest;
+         bool hit = true;
+         // Repeat so that the isectors land on different workers between runs.
+         for (unsigned run = 0; run < 10 && hit; ++run)
+         {
+            for (int i = 0; i < 32; ++i)
+            {
+               mBatchIsector->EnableAndGetISector(i).ResetSingleISector();
+            }
+            hit = mBatchIsector->Update(osg::Vec3(0.0f, 0.0f, 0.0f), true);
+            GetHits(parallelPoints, parallelNormals);
+            for (int i = 0; i < 32; ++i)
+            {
+               closest.push_back(mBatchIsector->EnableAndGetISector(i).GetClosestDrawable());
+            }
+         }
+
+         if (initPool)
+         {
+            dtUtil::ThreadPool::Shutdown();
+         }
+
+         CPPUNIT_ASSERT(hit);
+         CPPUNIT_ASSERT_EQUAL(size_t(32), serialPoints.size());
+         CPPUNIT_ASSERT_EQUAL(serialPoints.size() * 10, parallelPoints.size());
+         for (unsigned i = 0; i < parallelPoints.size(); ++i)
+         {
+            unsigned index = i % 32;
+            std::ostringstream ss;
+            ss << "Isector " << index << " should hit " << serialPoints[index] << " but hit " << parallelPoints[i] << ".";
+            CPPUNIT_ASSERT_MESSAGE(ss.str(), serialPoints[index] == parallelPoints[i]);
+            CPPUNIT_ASSERT(serialNormals[index] == parallelNormals[i]);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(GetHeight(serialPoints[index].x(), serialPoints[index].y()), serialPoints[index].z(), 0.5f);
+            CPPUNIT_ASSERT(closest[i] == (index % 2 == 1 ? terrain.get() : NULL));
+         }
+
+         mBatchIsector->SetUseThreadPool(false);
+      }
+
    private:
       dtCore::RefPtr<dtCore::BatchIsector>   mBatchIsector;
       dtCore::RefPtr<dtCore::Scene>          mScene;
@@ -159,6 +235,65 @@ class BatchISectorTests : public CPPUNIT_NS::TestFixture
       dtCore::RefPtr<dtCore::DeltaWin>       mWin;
       dtCore::RefPtr<dtABC::Application>     mApp;
       
+      static float GetHeight(float x, float y)
+      {
+         return 10.0f * std::sin(x * 0.1f) * std::cos(y * 0.07f);
+      }
+
+      /// A triangulated grid of quads in the XY plane that needs no graphics context.
+      static osg::Geode* CreateHeightfield(unsigned numQuads, float spacing)
+      {
+         dtCore::RefPtr<osg::Vec3Array> verts = new osg::Vec3Array;
+         for (unsigned y = 0; y <= numQuads; ++y)
+         {
+            for (unsigned x = 0; x <= numQuads; ++x)
+            {
+               float px = float(x) * spacing, py = float(y) * spacing;
+               verts->push_back(osg::Vec3(px, py, GetHeight(px, py)));
+            }
+         }
+
+         dtCore::RefPtr<osg::DrawElementsUInt> tris = new osg::DrawElementsUInt(GL_TRIANGLES);
+         const unsigned row = numQuads + 1;
+         for (unsigned y = 0; y < numQuads; ++y)
+         {
+            for (unsigned x = 0; x < numQuads; ++x)
+            {
+               unsigned i = y * row + x;
+               tris->push_back(i);
+               tris->push_back(i + 1);
+               tris->push_back(i + row + 1);
+               tris->push_back(i);
+               tris->push_back(i + row + 1);
+               tris->push_back(i + row);
+            }
+         }
+
+         osg::Geometry* geometry = new osg::Geometry;
+         geometry->setVertexArray(verts.get());
+         geometry->addPrimitiveSet(tris.get());
+
+         osg::Geode* geode = new osg::Geode;
+         geode->addDrawable(geometry);
+         return geode;
+      }
+
+      void GetHits(std::vector<osg::Vec3>& points, std::vector<osg::Vec3>& normals) const
+      {
+         for (int i = 0; i < 32; ++i)
+         {
+            const dtCore::BatchIsector::SingleISector& iSector = mBatchIsector->GetSingleISector(i);
+            osg::Vec3 point, normal;
+            if (iSector.GetNumberOfHits() > 0)
+            {
+               iSector.GetHitPoint(point);
+               iSector.GetHitPointNormal(normal);
+               points.push_back(point);
+               normals.push_back(normal);
+            }
+         }
+      }
+
       void CheckIsectorValues(const float height, const osg::Vec3& expectedNormal) const
       {
          osg::Vec3 hitPoint;
@@ -0,0 +1,189 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <dtCore/infiniteterrain.h>
+#include <dtUtil/log.h>
+#include <dtUtil/threadpool.h>
+
+#include <osg/MatrixTransform>
+#include <osg/Timer>
+
+#include <algorithm>
+#include <sstream>
+
+namespace dtCore
+{
+   class InfiniteTerrainTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(InfiniteTerrainTests);
+      CPPUNIT_TEST(TestCachedHeights);
+      CPPUNIT_TEST(TestPrefetch);
+      CPPUNIT_TEST(TestRegenerate);
+      CPPUNIT_TEST(TestLayoutChange);
+      CPPUNIT_TEST(TestSegmentBuildTime);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+
+      void setUp() override
+      {
+         mTerrain = new InfiniteTerrain();
+         mTerrain->SetBuildDistance(1500.0f);
+         mTerrain->SetSegmentDivisions(64);
+      }
+
+      void tearDown() override
+      {
+         mTerrain = NULL;
+      }
+
+      void TestCachedHeights()
+      {
+         mTerrain->SetAsyncBuildEnabled(false);
+         CPPUNIT_ASSERT(!mTerrain->IsAsyncBuildEnabled());
+
+         mTerrain->UpdateSegments(osg::Vec3(0.0f, 0.0f, 100.0f), 0.0);
+         CPPUNIT_ASSERT_EQUAL(0U, mTerrain->GetNumPendingSegments());
+         CPPUNIT_ASSERT(mTerrain->GetMatrixNode()->getNumChildren() > 0);
+
+         // On the posts, the cached heights match the noise, including negative coordinates.
+         float scale = mTerrain->GetSegmentSize() / mTerrain->GetSegmentDivisions();
+         for (int i = -20; i <= 20; i += 3)
+         {
+            for (int j = -20; j <= 20; j += 7)
+            {
+               float x = float(j) * scale, y = float(i) * scale;
+               CPPUNIT_ASSERT_DOUBLES_EQUAL(mTerrain->GetHeight(x, y, true), mTerrain->GetHeight(x, y, false), 1e-3f);
+            }
+         }
+
+         // Between posts the height stays within the surrounding posts.
+         float x = 3.3f * scale, y = -5.6f * scale;
+         float h00 = mTerrain->GetHeight(3.0f * scale, -6.0f * scale, true);
+         float h11 = mTerrain->GetHeight(4.0f * scale, -5.0f * scale, true);
+         float h01 = mTerrain->GetHeight(3.0f * scale, -5.0f * scale, true);
+         float h10 = mTerrain->GetHeight(4.0f * scale, -6.0f * scale, true);
+         float low = std::min(std::min(h00, h11), std::min(h01, h10));
+         float high = std::max(std::max(h00, h11), std::max(h01, h10));
+         float height = mTerrain->GetHeight(x, y);
+         CPPUNIT_ASSERT(height >= low - 1e-3f && height <= high + 1e-3f);
+
+         osg::Vec3 normal;
+         mTerrain->GetNormal(x, y, normal);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0f, normal.length(), 1e-4f);
+         CPPUNIT_ASSERT(normal.z() > 0.0f);
+      }
+
+      void TestPrefetch()
+      {
+         CPPUNIT_ASSERT_MESSAGE("Background building is opt-in.", !mTerrain->IsAsyncBuildEnabled());
+         mTerrain->SetAsyncBuildEnabled(true);
+         mTerrain->SetPrefetchTime(3.0f);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0f, mTerrain->GetPrefetchTime(), 1e-6f);
+
+         mTerrain->UpdateSegments(osg::Vec3(0.0f, 0.0f, 100.0f), 0.0);
+         unsigned builtAtRest = mTerrain->GetMatrixNode()->getNumChildren();
+
+         // Fly fast along x so the segments ahead get queued.
+         mTerrain->UpdateSegments(osg::Vec3(400.0f, 0.0f, 100.0f), 1.0);
+
+         if (!dtUtil::ThreadPool::IsInitialized())
+         {
+            CPPUNIT_ASSERT_EQUAL(0U, mTerrain->GetNumPendingSegments());
+            return;
+         }
+
+         CPPUNIT_ASSERT(mTerrain->GetNumPendingSegments() > 0U);
+
+         unsigned pending = mTerrain->GetNumPendingSegments();
+         unsigned attached = mTerrain->GetMatrixNode()->getNumChildren();
+         mTerrain->FinishPendingSegments();
+         CPPUNIT_ASSERT_EQUAL(0U, mTerrain->GetNumPendingSegments());
+         CPPUNIT_ASSERT_EQUAL(attached + pending, mTerrain->GetMatrixNode()->getNumChildren());
+         CPPUNIT_ASSERT(mTerrain->GetMatrixNode()->getNumChildren() > builtAtRest);
+      }
+
+      void TestRegenerate()
+      {
+         mTerrain->SetAsyncBuildEnabled(false);
+         mTerrain->UpdateSegments(osg::Vec3(), 0.0);
+         unsigned built = mTerrain->GetMatrixNode()->getNumChildren();
+         float height = mTerrain->GetHeight(12.0f, 34.0f);
+
+         mTerrain->SetVerticalScale(mTerrain->GetVerticalScale() * 2.0f);
+         mTerrain->UpdateSegments(osg::Vec3(), 0.0);
+         CPPUNIT_ASSERT_EQUAL(built, mTerrain->GetMatrixNode()->getNumChildren());
+         // The segments were rebuilt, so the cached heights follow the new scale.
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0f * (height + 1.0f) - 1.0f, mTerrain->GetHeight(12.0f, 34.0f), 1e-3f);
+      }
+
+      void TestLayoutChange()
+      {
+         mTerrain->UpdateSegments(osg::Vec3(), 0.0);
+
+         // Changing the layout drops the cached segments right away, before the next cull rebuilds them.
+         mTerrain->SetSegmentDivisions(32);
+         float scale = mTerrain->GetSegmentSize() / mTerrain->GetSegmentDivisions();
+         for (int i = -40; i <= 40; i += 9)
+         {
+            float x = float(i) * scale, y = float(-i) * scale;
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(mTerrain->GetHeight(x, y, true), mTerrain->GetHeight(x, y, false), 1e-3f);
+         }
+
+         mTerrain->UpdateSegments(osg::Vec3(), 0.0);
+         mTerrain->SetBuildDistance(800.0f);
+         mTerrain->UpdateSegments(osg::Vec3(), 0.0);
+         for (int i = -40; i <= 40; i += 9)
+         {
+            float x = float(i) * scale, y = float(i) * scale;
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(mTerrain->GetHeight(x, y, true), mTerrain->GetHeight(x, y, false), 1e-3f);
+         }
+      }
+
+      void TestSegmentBuildTime()
+      {
+         mTerrain->SetAsyncBuildEnabled(false);
+         mTerrain->SetSegmentDivisions(128);
+
+         osg::Timer timer;
+         osg::Timer_t start = timer.tick();
+         mTerrain->UpdateSegments(osg::Vec3(), 0.0);
+         double ms = timer.delta_m(start, timer.tick());
+
+         unsigned segments = mTerrain->GetMatrixNode()->getNumChildren();
+         CPPUNIT_ASSERT(segments > 0U);
+
+         std::ostringstream ss;
+         ss << "InfiniteTerrain built " << segments << " segments of 129x129 posts in " << ms
+            << " ms, " << ms / segments << " ms per segment";
+         LOG_ALWAYS(ss.str());
+      }
+
+   private:
+      RefPtr<InfiniteTerrain> mTerrain;
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(InfiniteTerrainTests);
+}
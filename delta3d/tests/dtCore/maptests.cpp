@@ -84,6 +84,7 @@
 #include <dtUtil/fileutils.h>
 #include <dtUtil/log.h>
 #include <dtUtil/mathdefines.h>
+#include <dtUtil/stringutils.h>
 #include <dtUtil/xercesutils.h>
 
 #include <cppunit/extensions/HelperMacros.h>
@@ -91,8 +92,11 @@
 #include <xercesc/sax/SAXParseException.hpp>
 
 #include <osg/io_utils>
+#include <osg/Timer>
 #include <osg/Math>
 
+#include <OpenThreads/Thread>
+
 #include <cstdio>
 #include <ctime>
 #include <sstream>
@@ -122,6 +126,8 @@ class MapTests : public CPPUNIT_NS::TestFixture
    CPPUNIT_TEST(TestMapCorrectLibraryListSetsModified);
    CPPUNIT_TEST(TestPrefabLoadHeader);
    CPPUNIT_TEST(TestPrefabCorrectLibraryList);
+   CPPUNIT_TEST(TestPrefabTemplateCache);
+   CPPUNIT_TEST(TestPrefabTemplateCacheSpawn);
    CPPUNIT_TEST(TestShouldSaveProperty);
    CPPUNIT_TEST(TestLibraryMethods);
    CPPUNIT_TEST(TestWildCard);
@@ -132,6 +138,7 @@ class MapTests : public CPPUNIT_NS::TestFixture
    CPPUNIT_TEST(TestCreateMapsMultiContext);
    CPPUNIT_TEST(TestSaveAsMultiContext);
    CPPUNIT_TEST(TestParsingMapHeaderData);
+   CPPUNIT_TEST(TestParseMapFileOnThreads);
    CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -153,6 +160,8 @@ public:
    void TestMapCorrectLibraryListSetsModified();
    void TestPrefabLoadHeader();
    void TestPrefabCorrectLibraryList();
+   void TestPrefabTemplateCache();
+   void TestPrefabTemplateCacheSpawn();
    void TestShouldSaveProperty();
    void TestIsMapFileValid();
    void TestLoadMapIntoScene();
@@ -174,7 +183,10 @@ private:
    static const std::string mExampleLibraryName;
    static const std::string mExampleGameLibraryName;
 
+   void TestParseMapFileOnThreads();
    void createActors(dtCore::Map& map);
+   dtCore::ResourceDescriptor savePrefabWithComponents(const std::string& description);
+   void assertSamePrefabActors(const dtCore::ActorRefPtrVector& expected, const dtCore::ActorRefPtrVector& actual);
    dtCore::ActorProperty* getActorProperty(dtCore::Map& map,
          const std::string& propName, dtCore::DataType& type, unsigned which = 0);
 
@@ -204,6 +216,32 @@ public:
    virtual void RegisterActorTypes() {}
 };
 
+///////////////////////////////////////////////////////////////////////////////////////
+class MapParseThread : public OpenThreads::Thread
+{
+public:
+   MapParseThread(const std::string& fullPath)
+   : mFullPath(fullPath)
+   {
+   }
+
+   virtual void run()
+   {
+      try
+      {
+         mMap = dtCore::Project::ParseMapFile(mFullPath);
+      }
+      catch (const dtUtil::Exception& ex)
+      {
+         mError = ex.ToString();
+      }
+   }
+
+   std::string mFullPath;
+   dtCore::RefPtr<dtCore::Map> mMap;
+   std::string mError;
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////
 void MapTests::setUp()
 {
@@ -669,6 +707,181 @@ void MapTests::TestPrefabCorrectLibraryList()
    }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////
+dtCore::ResourceDescriptor MapTests::savePrefabWithComponents(const std::string& description)
+{
+   dtCore::ActorFactory::GetInstance().LoadActorRegistry(mExampleLibraryName);
+   dtCore::ActorFactory::GetInstance().LoadActorRegistry(mExampleGameLibraryName);
+   dtCore::RefPtr<const dtCore::ActorType> example1Type = dtCore::ActorFactory::GetInstance().FindActorType("dtcore.examples", "Test All Properties");
+   CPPUNIT_ASSERT_MESSAGE("The example 1 actor type is null", example1Type.valid());
+   dtCore::RefPtr<const dtCore::ActorType> example2Type = dtCore::ActorFactory::GetInstance().FindActorType("ExampleActors", "Test1Actor");
+   CPPUNIT_ASSERT_MESSAGE("The example 2 actor type is null", example2Type.valid());
+   dtCore::RefPtr<const dtCore::ActorType> exampleACType = dtCore::ActorFactory::GetInstance().FindActorType("ActorComponents","DeadReckoningActComp");
+   CPPUNIT_ASSERT_MESSAGE("The example actor component type is null", exampleACType.valid());
+
+   dtCore::ActorRefPtrVector actors;
+   dtCore::RefPtr<dtCore::BaseActorObject> actor1 = dtCore::ActorFactory::GetInstance().CreateActor(*example1Type);
+   actor1->SetName("Mortar");
+   actors.push_back(actor1);
+   dtCore::RefPtr<dtCore::BaseActorObject> actor2 = dtCore::ActorFactory::GetInstance().CreateActor(*example2Type);
+   actor2->SetName("Crew");
+   actors.push_back(actor2);
+
+   dtCore::RefPtr<dtCore::BaseActorObject> actorComponent = dtCore::ActorFactory::GetInstance().CreateActor(*exampleACType);
+   dynamic_cast<dtCore::ActorComponentContainer&>(*actor2).AddComponent(*actorComponent);
+
+   // Give a few properties values other than the defaults so the comparisons mean something.
+   actor1->GetProperty("Test_Int")->FromString("27");
+   actor1->GetProperty("Test_String")->FromString("cached");
+   actor1->GetProperty("Test_Vec3")->FromString("1.5 -2.0 3.25");
+
+   return dtCore::Project::GetInstance().SavePrefab("CacheTest.dtprefab", "General:Test", actors, description);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+void MapTests::assertSamePrefabActors(const dtCore::ActorRefPtrVector& expected, const dtCore::ActorRefPtrVector& actual)
+{
+   CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+   for (unsigned i = 0; i < expected.size(); ++i)
+   {
+      const dtCore::BaseActorObject& exp = *expected[i];
+      const dtCore::BaseActorObject& act = *actual[i];
+      CPPUNIT_ASSERT_EQUAL(exp.GetActorType(), act.GetActorType());
+      CPPUNIT_ASSERT_EQUAL(exp.GetName(), act.GetName());
+      CPPUNIT_ASSERT(exp.GetId() != act.GetId());
+
+      std::vector<const dtCore::ActorProperty*> props;
+      exp.GetPropertyList(props);
+      for (unsigned j = 0; j < props.size(); ++j)
+      {
+         if (props[j]->IsReadOnly())
+         {
+            continue;
+         }
+         const dtCore::ActorProperty* actProp = act.GetProperty(props[j]->GetName());
+         CPPUNIT_ASSERT_MESSAGE(props[j]->GetName().Get(), actProp != NULL);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE(props[j]->GetName().Get(), props[j]->ToString(), actProp->ToString());
+      }
+
+      const dtCore::ActorComponentContainer* expAcc = dynamic_cast<const dtCore::ActorComponentContainer*>(&exp);
+      const dtCore::ActorComponentContainer* actAcc = dynamic_cast<const dtCore::ActorComponentContainer*>(&act);
+      CPPUNIT_ASSERT_EQUAL(expAcc == NULL, actAcc == NULL);
+      if (expAcc != NULL)
+      {
+         dtCore::ActorPtrVector expComps, actComps;
+         const_cast<dtCore::ActorComponentContainer*>(expAcc)->GetAllComponents(expComps);
+         const_cast<dtCore::ActorComponentContainer*>(actAcc)->GetAllComponents(actComps);
+         CPPUNIT_ASSERT_EQUAL(expComps.size(), actComps.size());
+         for (unsigned j = 0; j < expComps.size(); ++j)
+         {
+            CPPUNIT_ASSERT_EQUAL(expComps[j]->GetActorType(), actComps[j]->GetActorType());
+         }
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+void MapTests::TestPrefabTemplateCache()
+{
+   try
+   {
+      dtCore::Project& project = dtCore::Project::GetInstance();
+      CPPUNIT_ASSERT(project.IsPrefabCacheEnabled());
+
+      dtCore::ResourceDescriptor rd = savePrefabWithComponents("first");
+
+      project.SetPrefabCacheEnabled(false);
+      dtCore::ActorRefPtrVector uncached;
+      dtCore::MapPtr uncachedMap = project.LoadPrefab(rd, uncached);
+      CPPUNIT_ASSERT_EQUAL(0U, project.GetPrefabCacheSize());
+
+      project.SetPrefabCacheEnabled(true);
+      dtCore::ActorRefPtrVector first, second;
+      dtCore::MapPtr firstMap = project.LoadPrefab(rd, first);
+      CPPUNIT_ASSERT_EQUAL(1U, project.GetPrefabCacheSize());
+      dtCore::MapPtr secondMap = project.LoadPrefab(rd, second);
+      CPPUNIT_ASSERT_EQUAL(1U, project.GetPrefabCacheSize());
+
+      assertSamePrefabActors(uncached, first);
+      assertSamePrefabActors(uncached, second);
+      assertSamePrefabActors(first, second);
+
+      CPPUNIT_ASSERT(firstMap != secondMap);
+      CPPUNIT_ASSERT_EQUAL(uncachedMap->GetName(), secondMap->GetName());
+      CPPUNIT_ASSERT_EQUAL(uncachedMap->GetDescription(), secondMap->GetDescription());
+      CPPUNIT_ASSERT(uncachedMap->GetAllLibraries() == secondMap->GetAllLibraries());
+      CPPUNIT_ASSERT_EQUAL(second.size(), secondMap->GetAllProxies().size());
+
+      // Saving over the prefab must not hand out the old template.
+      dtCore::ResourceDescriptor rd2 = savePrefabWithComponents("second");
+      CPPUNIT_ASSERT_EQUAL(rd, rd2);
+      dtCore::ActorRefPtrVector third;
+      dtCore::MapPtr thirdMap = project.LoadPrefab(rd, third);
+      CPPUNIT_ASSERT_EQUAL(std::string("second"), thirdMap->GetDescription());
+
+      project.ClearPrefabCache();
+      CPPUNIT_ASSERT_EQUAL(0U, project.GetPrefabCacheSize());
+   }
+   catch (const dtUtil::Exception& e)
+   {
+      CPPUNIT_FAIL((std::string("Error: ") + e.What()).c_str());
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+void MapTests::TestPrefabTemplateCacheSpawn()
+{
+   try
+   {
+      dtCore::Project& project = dtCore::Project::GetInstance();
+      dtCore::ResourceDescriptor rd = savePrefabWithComponents("spawn");
+
+      const unsigned spawnCount = 10000U;
+      // Parsing every time is too slow to do 10k times in a unit test, so time a sample of it.
+      const unsigned uncachedCount = 100U;
+
+      osg::Timer timer;
+
+      project.SetPrefabCacheEnabled(false);
+      dtCore::ActorRefPtrVector reference;
+      osg::Timer_t start = timer.tick();
+      for (unsigned i = 0; i < uncachedCount; ++i)
+      {
+         dtCore::ActorRefPtrVector actors;
+         project.LoadPrefab(rd, actors);
+         if (i == 0)
+         {
+            reference.swap(actors);
+         }
+      }
+      double uncachedMs = timer.delta_m(start, timer.tick());
+
+      project.SetPrefabCacheEnabled(true);
+      std::set<dtCore::UniqueId> ids;
+      start = timer.tick();
+      for (unsigned i = 0; i < spawnCount; ++i)
+      {
+         dtCore::ActorRefPtrVector actors;
+         project.LoadPrefab(rd, actors);
+         assertSamePrefabActors(reference, actors);
+         for (unsigned j = 0; j < actors.size(); ++j)
+         {
+            CPPUNIT_ASSERT(ids.insert(actors[j]->GetId()).second);
+         }
+      }
+      double cachedMs = timer.delta_m(start, timer.tick());
+
+      std::ostringstream ss;
+      ss << "Prefab spawn: uncached " << uncachedMs / uncachedCount << " ms, cached "
+         << cachedMs / spawnCount << " ms per spawn over " << spawnCount << " spawns";
+      LOG_ALWAYS(ss.str());
+   }
+   catch (const dtUtil::Exception& e)
+   {
+      CPPUNIT_FAIL((std::string("Error: ") + e.What()).c_str());
+   }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 void MapTests::TestMapProxySearch()
 {
@@ -2199,3 +2412,79 @@ void MapTests::TestParsingMapHeaderData()
    dtCore::Project::GetInstance().DeleteMap(mapName, true);
    dtCore::Project::GetInstance().ClearAllContexts();
 }
+
+//////////////////////////////////////////////////////////////////////////
+void MapTests::TestParseMapFileOnThreads()
+{
+   try
+   {
+      dtCore::Project& project = dtCore::Project::GetInstance();
+
+      std::vector<std::string> mapNames;
+      mapNames.push_back("Parse Thread Map A");
+      mapNames.push_back("Parse Thread Map B");
+      const std::string busyMapName("Parse Thread Busy Map");
+
+      std::vector<size_t> numActors;
+      for (unsigned i = 0; i < mapNames.size(); ++i)
+      {
+         dtCore::Map& map = project.CreateMap(mapNames[i], "parsethread" + dtUtil::ToString(i));
+         createActors(map);
+         map.GetEventManager().AddEvent(*new dtCore::GameEvent("event" + dtUtil::ToString(i), "Parse thread event"));
+         numActors.push_back(map.GetAllProxies().size());
+         project.SaveMap(map);
+         project.CloseMap(map);
+      }
+
+      dtCore::Map& busyMap = project.CreateMap(busyMapName, "parsethreadbusy");
+      createActors(busyMap);
+      project.SaveMap(busyMap);
+      project.CloseMap(busyMap);
+
+      std::vector<dtCore::RefPtr<MapParseThread> > threads;
+      for (unsigned i = 0; i < mapNames.size(); ++i)
+      {
+         threads.push_back(new MapParseThread(project.GetMapFilePath(mapNames[i])));
+         threads.back()->start();
+      }
+
+      // The main thread keeps opening and closing a map, and parsing with the project's parser, while the workers parse.
+      bool running = true;
+      while (running)
+      {
+         dtCore::Map& map = project.GetMap(busyMapName);
+         project.CloseMap(map);
+
+         running = false;
+         for (unsigned i = 0; i < threads.size(); ++i)
+         {
+            running = running || threads[i]->isRunning();
+         }
+      }
+
+      CPPUNIT_ASSERT(dtCore::MapParser::GetParserOnThisThread() == NULL);
+
+      for (unsigned i = 0; i < threads.size(); ++i)
+      {
+         threads[i]->join();
+         CPPUNIT_ASSERT_MESSAGE(threads[i]->mError, threads[i]->mError.empty());
+         CPPUNIT_ASSERT(threads[i]->mMap.valid());
+         CPPUNIT_ASSERT_EQUAL(numActors[i], threads[i]->mMap->GetAllProxies().size());
+         CPPUNIT_ASSERT_EQUAL(1U, threads[i]->mMap->GetEventManager().GetNumEvents());
+
+         dtCore::Map& opened = project.AddParsedMap(mapNames[i], *threads[i]->mMap);
+         CPPUNIT_ASSERT(&opened == threads[i]->mMap.get());
+         CPPUNIT_ASSERT(project.IsMapOpen(mapNames[i]));
+      }
+
+      for (unsigned i = 0; i < mapNames.size(); ++i)
+      {
+         project.DeleteMap(mapNames[i], true);
+      }
+      project.DeleteMap(busyMapName, true);
+   }
+   catch (const dtUtil::Exception& e)
+   {
+      CPPUNIT_FAIL((std::string("Error: ") + e.What()).c_str());
+   }
+}
@@ -114,6 +114,8 @@ namespace dtCore
       CPPUNIT_TEST(TestPropertyMetaDataDefaults);
       CPPUNIT_TEST(TestPropertyCopy);
       CPPUNIT_TEST(TestPropertyCopyMetaData);
+      CPPUNIT_TEST(TestPropertyCopyDifferentOrder);
+      CPPUNIT_TEST(TestContainerPropertyCopy);
       CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -202,7 +204,71 @@ namespace dtCore
          CPPUNIT_ASSERT(!boolProp2->GetSendInFullUpdate());
          CPPUNIT_ASSERT(boolProp2->GetSendInPartialUpdate());
       }
+
+      void TestPropertyCopyDifferentOrder()
+      {
+         TestPCPtr pc1 = new TestPropertyContainer;
+         TestPCPtr pc2 = new TestPropertyContainer;
+
+         // Move Int to the end on the destination, so the indices no longer line up.
+         PropertyPtr intProp = pc2->GetProperty("Int");
+         pc2->RemoveProperty(intProp.get());
+         pc2->AddProperty(intProp.get());
+         // And drop one from the source so the sizes differ as well.
+         pc1->RemoveProperty("Vec4");
+
+         pc1->SetInt(36);
+         pc1->SetLong(91);
+         pc1->SetString("moved");
+         pc1->SetVec3(osg::Vec3(1.1f,2.2f,3.3f));
+         osg::Vec4 vec4(4.0f, 3.0f, 2.0f, 1.0f);
+         pc2->SetVec4(vec4);
+
+         pc2->CopyPropertiesFrom(*pc1);
+
+         CPPUNIT_ASSERT_EQUAL(pc1->GetInt(), pc2->GetInt());
+         CPPUNIT_ASSERT_EQUAL(pc1->GetLong(), pc2->GetLong());
+         CPPUNIT_ASSERT_EQUAL(pc1->GetString(), pc2->GetString());
+         CPPUNIT_ASSERT_EQUAL(pc1->GetVec3(), pc2->GetVec3());
+         CPPUNIT_ASSERT_EQUAL(vec4, pc2->GetVec4());
+      }
+
+      void TestContainerPropertyCopy()
+      {
+         TestPCPtr pc1 = new TestPropertyContainer;
+         TestPCPtr pc2 = new TestPropertyContainer;
+         RefPtr<ContainerActorProperty> container1 = CreateContainerProperty(*pc1);
+         RefPtr<ContainerActorProperty> container2 = CreateContainerProperty(*pc2);
+
+         pc1->SetInt(-12);
+         pc1->SetFloat(3.5f);
+         container2->CopyFrom(*container1);
+         CPPUNIT_ASSERT_EQUAL(-12, pc2->GetInt());
+         CPPUNIT_ASSERT_EQUAL(3.5f, pc2->GetFloat());
+
+         // A container with a different layout still copies through the string form.
+         RefPtr<ContainerActorProperty> shortContainer = new ContainerActorProperty("Short", "Short", "", "");
+         shortContainer->AddProperty(new IntActorProperty("Int", "Int",
+                  IntActorProperty::SetFuncType(pc1.get(), &TestPropertyContainer::SetInt),
+                  IntActorProperty::GetFuncType(pc1.get(), &TestPropertyContainer::GetInt)));
+         pc1->SetInt(77);
+         container2->CopyFrom(*shortContainer);
+         CPPUNIT_ASSERT_EQUAL(77, pc2->GetInt());
+      }
+
    private:
+
+      RefPtr<ContainerActorProperty> CreateContainerProperty(TestPropertyContainer& pc)
+      {
+         RefPtr<ContainerActorProperty> container = new ContainerActorProperty("Container", "Container", "", "");
+         container->AddProperty(new IntActorProperty("Int", "Int",
+                  IntActorProperty::SetFuncType(&pc, &TestPropertyContainer::SetInt),
+                  IntActorProperty::GetFuncType(&pc, &TestPropertyContainer::GetInt)));
+         container->AddProperty(new FloatActorProperty("Float", "Float",
+                  FloatActorProperty::SetFuncType(&pc, &TestPropertyContainer::SetFloat),
+                  FloatActorProperty::GetFuncType(&pc, &TestPropertyContainer::GetFloat)));
+         return container;
+      }
    };
 
    CPPUNIT_TEST_SUITE_REGISTRATION(PropertyContainerTests);
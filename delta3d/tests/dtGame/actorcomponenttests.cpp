@@ -61,12 +61,63 @@
 #include <dtUtil/datapathutils.h>
 #include <dtUtil/datastream.h>
 #include <dtUtil/log.h>
+#include <dtUtil/threadpool.h>
 
 #include <osg/Math>
 
 #include "basegmtests.h"
 
 #include <iostream>
+#include <sstream>
+
+/// Ticks on the thread pool and sends one game event per tick, about its owner.
+class ParallelTickTestComponent : public dtGame::ActorComponent
+{
+public:
+   static const ACType TYPE;
+
+   ParallelTickTestComponent()
+   : dtGame::ActorComponent(TYPE)
+   , mTickCount(0)
+   , mSimTime(0.0)
+   {
+      SetParallelTick(true);
+   }
+
+   void OnEnteredWorld() override
+   {
+      RegisterForTick();
+   }
+
+   void OnRemovedFromWorld() override
+   {
+      UnregisterForTick();
+   }
+
+   // Expose the tick registration so the tests can change ParallelTick in between.
+   void CallRegisterForTick() { RegisterForTick(); }
+   void CallUnregisterForTick() { UnregisterForTick(); }
+
+   void OnTickLocal(const dtGame::TickMessage& tickMessage) override
+   {
+      ++mTickCount;
+      mSimTime += tickMessage.GetDeltaSimTime();
+
+      dtGame::GameActorProxy* owner = GetOwner<dtGame::GameActorProxy>();
+      dtGame::GameManager* gm = owner->GetGameManager();
+      dtCore::RefPtr<dtGame::Message> msg;
+      gm->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_GAME_EVENT, msg);
+      msg->SetAboutActorId(owner->GetId());
+      gm->SendMessage(*msg);
+   }
+
+   unsigned mTickCount;
+   double mSimTime;
+};
+
+const dtGame::ActorComponent::ACType ParallelTickTestComponent::TYPE(new dtCore::ActorType("ParallelTickTestComponent", "ActorComponents",
+       "Test component ticked on the thread pool",
+       dtGame::ActorComponent::BaseActorComponentType));
 
 class ActorComponentTests : public dtGame::BaseGMTestFixture
 {
@@ -79,6 +130,8 @@ class ActorComponentTests : public dtGame::BaseGMTestFixture
       CPPUNIT_TEST(TestPropertyRemoving);
       CPPUNIT_TEST(TestCloning);
       CPPUNIT_TEST(TestCopyPropertiesOnComponents);
+      CPPUNIT_TEST(TestParallelTickStress);
+      CPPUNIT_TEST(TestParallelTickToggle);
 
    CPPUNIT_TEST_SUITE_END();
 
@@ -356,6 +409,116 @@ public:
       CPPUNIT_ASSERT_EQUAL(extraComp->GetProperty(propName)->ToString(), extraCompCopyProp->GetProperty(propName)->ToString());
    }
 
+   void TestParallelTickToggle()
+   {
+      dtCore::RefPtr<dtGame::GameActorProxy> actor;
+      mGM->CreateActor(*TestGameActorLibrary::TEST1_GAME_ACTOR_TYPE, actor);
+      dtCore::RefPtr<ParallelTickTestComponent> comp = new ParallelTickTestComponent;
+      actor->AddComponent(*comp);
+      mGM->AddActor(*actor, false, false);
+      CPPUNIT_ASSERT_EQUAL(1U, mGM->GetNumParallelTickComponents());
+
+      // Changing the flag after registering must not leave the component on the parallel list.
+      comp->SetParallelTick(false);
+      comp->CallUnregisterForTick();
+      CPPUNIT_ASSERT_EQUAL(0U, mGM->GetNumParallelTickComponents());
+
+      comp->CallRegisterForTick();
+      CPPUNIT_ASSERT_EQUAL(0U, mGM->GetNumParallelTickComponents());
+      dtCore::System::GetInstance().Step(0.016);
+      CPPUNIT_ASSERT_EQUAL(1U, comp->mTickCount);
+
+      // Switching back while registered moves it from the invokable to the parallel list, not onto both.
+      comp->SetParallelTick(true);
+      comp->CallRegisterForTick();
+      comp->CallRegisterForTick();
+      CPPUNIT_ASSERT_EQUAL(1U, mGM->GetNumParallelTickComponents());
+      dtCore::System::GetInstance().Step(0.016);
+      CPPUNIT_ASSERT_EQUAL(2U, comp->mTickCount);
+
+      comp->SetParallelTick(false);
+      comp->CallUnregisterForTick();
+      CPPUNIT_ASSERT_EQUAL(0U, mGM->GetNumParallelTickComponents());
+      dtCore::System::GetInstance().Step(0.016);
+      CPPUNIT_ASSERT_EQUAL(2U, comp->mTickCount);
+   }
+
+   void TestParallelTickStress()
+   {
+      const unsigned numActors = 10000U;
+      const unsigned numFrames = 5U;
+
+      bool initPool = !dtUtil::ThreadPool::IsInitialized();
+      if (initPool)
+      {
+         dtUtil::ThreadPool::Init();
+      }
+
+      std::vector<dtCore::RefPtr<dtGame::GameActorProxy> > actors;
+      std::vector<dtCore::RefPtr<ParallelTickTestComponent> > components;
+      actors.reserve(numActors);
+      components.reserve(numActors);
+      for (unsigned i = 0; i < numActors; ++i)
+      {
+         dtCore::RefPtr<dtGame::GameActorProxy> actor;
+         mGM->CreateActor(*TestGameActorLibrary::TEST1_GAME_ACTOR_TYPE, actor);
+         CPPUNIT_ASSERT(actor.valid());
+         dtCore::RefPtr<ParallelTickTestComponent> comp = new ParallelTickTestComponent;
+         actor->AddComponent(*comp);
+         mGM->AddActor(*actor, false, false);
+         actors.push_back(actor);
+         components.push_back(comp);
+      }
+
+      dtCore::System::GetInstance().Step(0.016);
+      CPPUNIT_ASSERT_EQUAL(numActors, mGM->GetNumParallelTickComponents());
+
+      dtCore::Timer statsTickClock;
+      double totalTime = 0.0;
+      for (unsigned frame = 0; frame < numFrames; ++frame)
+      {
+         mTestComp->reset();
+         dtCore::Timer_t frameStart = statsTickClock.Tick();
+         dtCore::System::GetInstance().Step(0.016);
+         totalTime += statsTickClock.DeltaMil(frameStart, statsTickClock.Tick());
+
+         // The messages sent from the workers must arrive in registration order, every frame.
+         unsigned next = 0;
+         std::vector<dtCore::RefPtr<const dtGame::Message> >& received = mTestComp->GetReceivedProcessMessages();
+         for (unsigned i = 0; i < received.size(); ++i)
+         {
+            if (received[i]->GetMessageType() != dtGame::MessageType::INFO_GAME_EVENT)
+            {
+               continue;
+            }
+            CPPUNIT_ASSERT(next < numActors);
+            CPPUNIT_ASSERT_EQUAL(actors[next]->GetId(), received[i]->GetAboutActorId());
+            ++next;
+         }
+         CPPUNIT_ASSERT_EQUAL(numActors, next);
+      }
+
+      for (unsigned i = 0; i < numActors; ++i)
+      {
+         CPPUNIT_ASSERT_EQUAL(numFrames + 1U, components[i]->mTickCount);
+      }
+
+      std::ostringstream ss;
+      ss << "Parallel tick of " << numActors << " components took " << (totalTime / double(numFrames))
+         << "ms per frame on " << dtUtil::ThreadPool::GetNumImmediateWorkerThreads() << " worker threads.";
+      LOG_ALWAYS(ss.str());
+
+      // Removing the actors must take their components off the parallel list.
+      mGM->DeleteAllActors(true);
+      dtCore::System::GetInstance().Step(0.016);
+      CPPUNIT_ASSERT_EQUAL(0U, mGM->GetNumParallelTickComponents());
+
+      if (initPool)
+      {
+         dtUtil::ThreadPool::Shutdown();
+      }
+   }
+
 private:
 };
 
@@ -56,6 +56,7 @@
 #include <dtABC/application.h>
 
 #include <dtCore/actortype.h>
+#include <dtCore/timer.h>
 
 #include <dtActors/engineactorregistry.h>
 
@@ -157,6 +158,8 @@ namespace dtGame
          CPPUNIT_TEST(TestDoDRStatic);
          CPPUNIT_TEST(TestDoDRStaticInitialConditions);
          CPPUNIT_TEST(TestDoDRNoDR);
+         CPPUNIT_TEST(TestUpdateTierProperties);
+         CPPUNIT_TEST(TestUpdateTiersStress);
 
       CPPUNIT_TEST_SUITE_END();
 
@@ -1114,6 +1117,229 @@ namespace dtGame
             CPPUNIT_ASSERT(helper->GetCurrentInstantVelocity().length2() <= FLT_EPSILON);
          }
 
+         void TestUpdateTierProperties()
+         {
+            CPPUNIT_ASSERT(!mDeadReckoningComponent->GetUpdateTiersEnabled());
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(500.0f, mDeadReckoningComponent->GetFullTierDistance(), 1e-3f);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(3000.0f, mDeadReckoningComponent->GetReducedTierDistance(), 1e-3f);
+            CPPUNIT_ASSERT_EQUAL(4U, mDeadReckoningComponent->GetReducedTierFrameInterval());
+            CPPUNIT_ASSERT_EQUAL(0U, mDeadReckoningComponent->GetMinimalTierFrameInterval());
+            CPPUNIT_ASSERT_EQUAL(256U, mDeadReckoningComponent->GetTierAssignmentsPerFrame());
+
+            mDeadReckoningComponent->SetUpdateTiersEnabled(true);
+            CPPUNIT_ASSERT(mDeadReckoningComponent->GetUpdateTiersEnabled());
+            mDeadReckoningComponent->SetFullTierDistance(100.0f);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0f, mDeadReckoningComponent->GetFullTierDistance(), 1e-3f);
+            mDeadReckoningComponent->SetReducedTierDistance(200.0f);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(200.0f, mDeadReckoningComponent->GetReducedTierDistance(), 1e-3f);
+            mDeadReckoningComponent->SetReducedTierFrameInterval(0U);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("The interval may not be 0", 1U, mDeadReckoningComponent->GetReducedTierFrameInterval());
+            mDeadReckoningComponent->SetReducedTierFrameInterval(3U);
+            CPPUNIT_ASSERT_EQUAL(3U, mDeadReckoningComponent->GetReducedTierFrameInterval());
+            mDeadReckoningComponent->SetMinimalTierFrameInterval(20U);
+            CPPUNIT_ASSERT_EQUAL(20U, mDeadReckoningComponent->GetMinimalTierFrameInterval());
+            mDeadReckoningComponent->SetTierAssignmentsPerFrame(0U);
+            CPPUNIT_ASSERT_EQUAL(1U, mDeadReckoningComponent->GetTierAssignmentsPerFrame());
+
+            // Eye point at the origin, one actor in each tier.
+            mGM->AddActor(*mTestGameActor, false, false);
+            mDeadReckoningComponent->SetEyePointActor(mTestGameActor->GetDrawable<dtCore::Transformable>());
+            mDeadReckoningComponent->SetTierAssignmentsPerFrame(10U);
+
+            const float distances[] = { 50.0f, 150.0f, 1000.0f };
+            const DeadReckoningComponent::UpdateTier* expected[] = { &DeadReckoningComponent::UpdateTier::FULL,
+               &DeadReckoningComponent::UpdateTier::REDUCED, &DeadReckoningComponent::UpdateTier::MINIMAL };
+            std::vector<dtCore::RefPtr<GameActorProxy> > actors;
+            for (unsigned i = 0; i < 3; ++i)
+            {
+               dtCore::RefPtr<GameActorProxy> actor;
+               mGM->CreateActor(*dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE, actor);
+               mGM->AddActor(*actor, true, false);
+               dtCore::RefPtr<DeadReckoningActorComponent> helper = new DeadReckoningActorComponent;
+               helper->SetGroundClampType(dtGame::GroundClampTypeEnum::NONE);
+               helper->SetLastKnownTranslation(osg::Vec3(distances[i], 0.0f, 0.0f));
+               mDeadReckoningComponent->RegisterActor(*actor, *helper);
+               actors.push_back(actor);
+            }
+
+            // A local actor is always dead reckoned every frame.
+            dtCore::RefPtr<GameActorProxy> localActor;
+            mGM->CreateActor(*dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE, localActor);
+            mGM->AddActor(*localActor, false, false);
+            dtCore::RefPtr<DeadReckoningActorComponent> localHelper = new DeadReckoningActorComponent;
+            localHelper->SetGroundClampType(dtGame::GroundClampTypeEnum::NONE);
+            mDeadReckoningComponent->RegisterActor(*localActor, *localHelper);
+
+            // Tiers are picked from the dead reckoned position, so the first frame has to run before they are known.
+            dtCore::System::GetInstance().Step(0.016);
+            dtCore::System::GetInstance().Step(0.016);
+
+            for (unsigned i = 0; i < 3; ++i)
+            {
+               CPPUNIT_ASSERT_EQUAL(*expected[i], mDeadReckoningComponent->GetActorUpdateTier(*actors[i]));
+            }
+            CPPUNIT_ASSERT_EQUAL(DeadReckoningComponent::UpdateTier::FULL, mDeadReckoningComponent->GetActorUpdateTier(*localActor));
+
+            mDeadReckoningComponent->SetUpdateTiersEnabled(false);
+            for (unsigned i = 0; i < 3; ++i)
+            {
+               CPPUNIT_ASSERT_EQUAL(DeadReckoningComponent::UpdateTier::FULL, mDeadReckoningComponent->GetActorUpdateTier(*actors[i]));
+            }
+            dtCore::System::GetInstance().Step(0.016);
+            CPPUNIT_ASSERT_EQUAL(4U, mDeadReckoningComponent->GetNumActorsUpdatedLastFrame());
+         }
+
+         struct TierStressEntity
+         {
+            dtCore::RefPtr<GameActorProxy> mActor;
+            dtCore::RefPtr<DeadReckoningActorComponent> mHelper;
+            osg::Vec3 mStart;
+            osg::Vec3 mVelocity;
+            osg::Vec3 mReferencePosition;
+         };
+
+         void SendTierStressUpdates(std::vector<TierStressEntity>& entities)
+         {
+            for (unsigned i = 0; i < entities.size(); ++i)
+            {
+               entities[i].mHelper->SetLastKnownTranslation(entities[i].mStart);
+               entities[i].mHelper->SetLastKnownVelocity(entities[i].mVelocity);
+            }
+         }
+
+         double RunTierStressFrames(unsigned numFrames, double stepTime, unsigned& totalUpdated)
+         {
+            dtCore::Timer timer;
+            dtCore::Timer_t start = timer.Tick();
+            totalUpdated = 0U;
+            for (unsigned i = 0; i < numFrames; ++i)
+            {
+               dtCore::System::GetInstance().Step(stepTime);
+               totalUpdated += mDeadReckoningComponent->GetNumActorsUpdatedLastFrame();
+            }
+            return timer.DeltaMil(start, timer.Tick());
+         }
+
+         osg::Vec3 GetTierStressPosition(TierStressEntity& entity)
+         {
+            dtCore::Transform xform;
+            entity.mActor->GetDrawable<dtCore::Transformable>()->GetTransform(xform);
+            osg::Vec3 pos;
+            xform.GetTranslation(pos);
+            return pos;
+         }
+
+         void TestUpdateTiersStress()
+         {
+            const unsigned numEntities = 10000U;
+            const unsigned numFrames = 30U;
+            const double stepTime = 0.016;
+            const float halfExtent = 50000.0f; // 100 km across, eye point in the middle.
+            const float maxSpeed = 20.0f;
+
+            mGM->AddActor(*mTestGameActor, false, false);
+            mDeadReckoningComponent->SetEyePointActor(mTestGameActor->GetDrawable<dtCore::Transformable>());
+            mDeadReckoningComponent->SetTierAssignmentsPerFrame(numEntities / 4U);
+
+            std::vector<TierStressEntity> entities(numEntities);
+            for (unsigned i = 0; i < numEntities; ++i)
+            {
+               TierStressEntity& entity = entities[i];
+               // Put a few hundred entities near the eye so every tier is well populated.
+               float extent = (i % 20U == 0U) ? 4000.0f : halfExtent;
+               entity.mStart.set(dtUtil::RandFloat(-extent, extent), dtUtil::RandFloat(-extent, extent), 0.0f);
+               entity.mVelocity.set(dtUtil::RandFloat(-1.0f, 1.0f), dtUtil::RandFloat(-1.0f, 1.0f), 0.0f);
+               entity.mVelocity.normalize();
+               entity.mVelocity *= dtUtil::RandFloat(0.0f, maxSpeed);
+
+               mGM->CreateActor(*dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE, entity.mActor);
+               mGM->AddActor(*entity.mActor, true, false);
+               entity.mHelper = new DeadReckoningActorComponent;
+               entity.mHelper->SetGroundClampType(dtGame::GroundClampTypeEnum::NONE);
+               entity.mHelper->SetDeadReckoningAlgorithm(DeadReckoningAlgorithm::VELOCITY_ONLY);
+               entity.mHelper->SetUseFixedSmoothingTime(true);
+               entity.mHelper->SetFixedSmoothingTime(0.0f);
+               mDeadReckoningComponent->RegisterActor(*entity.mActor, *entity.mHelper);
+            }
+
+            // Reference run, every entity every frame.
+            SendTierStressUpdates(entities);
+            unsigned referenceUpdated = 0U;
+            double referenceMs = RunTierStressFrames(numFrames, stepTime, referenceUpdated);
+            CPPUNIT_ASSERT_EQUAL(numEntities * numFrames, referenceUpdated);
+            for (unsigned i = 0; i < numEntities; ++i)
+            {
+               entities[i].mReferencePosition = GetTierStressPosition(entities[i]);
+            }
+
+            // Same motion again with tiers.  Each run starts with an update, so both extrapolate from the same state.
+            mDeadReckoningComponent->SetUpdateTiersEnabled(true);
+            SendTierStressUpdates(entities);
+            unsigned tieredUpdated = 0U;
+            double tieredMs = RunTierStressFrames(numFrames, stepTime, tieredUpdated);
+
+            const float tolerance = 0.05f;
+            const unsigned reducedInterval = mDeadReckoningComponent->GetReducedTierFrameInterval();
+            unsigned tierCounts[3] = { 0U, 0U, 0U };
+            float maxError[3] = { 0.0f, 0.0f, 0.0f };
+            std::vector<unsigned> minimalEntities;
+            for (unsigned i = 0; i < numEntities; ++i)
+            {
+               TierStressEntity& entity = entities[i];
+               const DeadReckoningComponent::UpdateTier& tier = mDeadReckoningComponent->GetActorUpdateTier(*entity.mActor);
+               float error = (GetTierStressPosition(entity) - entity.mReferencePosition).length();
+               float speed = entity.mVelocity.length();
+
+               unsigned tierIdx = 0U;
+               float bound = tolerance;
+               if (tier == DeadReckoningComponent::UpdateTier::REDUCED)
+               {
+                  tierIdx = 1U;
+                  bound += speed * float(stepTime * (reducedInterval - 1U));
+               }
+               else if (tier == DeadReckoningComponent::UpdateTier::MINIMAL)
+               {
+                  tierIdx = 2U;
+                  bound += speed * float(stepTime * numFrames);
+                  minimalEntities.push_back(i);
+               }
+
+               ++tierCounts[tierIdx];
+               maxError[tierIdx] = std::max(maxError[tierIdx], error);
+
+               std::ostringstream ss;
+               ss << "Entity " << i << " in tier " << tier << " is " << error << " m from the every-frame position, the bound is " << bound;
+               CPPUNIT_ASSERT_MESSAGE(ss.str(), error <= bound);
+            }
+
+            CPPUNIT_ASSERT(tierCounts[0] > 0U && tierCounts[1] > 0U && tierCounts[2] > 0U);
+            CPPUNIT_ASSERT_MESSAGE("Tiers should cut the per-frame work by an order of magnitude.",
+                     tieredUpdated * 10U < referenceUpdated);
+
+            std::ostringstream ss;
+            ss << "Dead reckoning " << numEntities << " entities over " << numFrames << " frames: every frame "
+               << referenceMs << " ms, " << referenceUpdated << " updates; tiered " << tieredMs << " ms, "
+               << tieredUpdated << " updates.  Tier counts full/reduced/minimal "
+               << tierCounts[0] << "/" << tierCounts[1] << "/" << tierCounts[2]
+               << ", max error " << maxError[0] << "/" << maxError[1] << "/" << maxError[2] << " m.";
+            LOG_ALWAYS(ss.str());
+
+            // A network update moves a minimal tier entity on the very next frame.
+            for (unsigned i = 0; i < minimalEntities.size(); ++i)
+            {
+               TierStressEntity& entity = entities[minimalEntities[i]];
+               entity.mHelper->SetLastKnownVelocity(osg::Vec3());
+               entity.mHelper->SetLastKnownTranslation(entity.mReferencePosition);
+            }
+            dtCore::System::GetInstance().Step(stepTime);
+            CPPUNIT_ASSERT(mDeadReckoningComponent->GetNumActorsUpdatedLastFrame() >= minimalEntities.size());
+            for (unsigned i = 0; i < minimalEntities.size(); ++i)
+            {
+               TierStressEntity& entity = entities[minimalEntities[i]];
+               CPPUNIT_ASSERT(dtUtil::Equivalent(entity.mReferencePosition, GetTierStressPosition(entity), tolerance));
+            }
+         }
+
          dtCore::RefPtr<TestDeadReckoningComponent> mDeadReckoningComponent;
          dtCore::RefPtr<GameActorProxy> mTestGameActor;
    };
@@ -46,9 +46,11 @@
 #include <dtCore/actortype.h>
 #include <dtCore/booleanactorproperty.h>
 #include <dtCore/datatype.h>
+#include <dtCore/floatactorproperty.h>
 #include <dtCore/intactorproperty.h>
 #include <dtCore/project.h>
 #include <dtCore/resourcedescriptor.h>
+#include <dtCore/vectoractorproperties.h>
 
 #include <dtGame/actorupdatemessage.h>
 #include <dtGame/basemessages.h>
@@ -95,6 +97,7 @@ class GameActorTests : public dtGame::BaseGMTestFixture
       CPPUNIT_TEST(TestUnregisterNextInvokable);
       CPPUNIT_TEST(TestFullUpdateFlags);
       CPPUNIT_TEST(TestPartialUpdateFlags);
+      CPPUNIT_TEST(TestDirtyPropertyPublishing);
 
    CPPUNIT_TEST_SUITE_END();
 
@@ -117,8 +120,11 @@ public:
    void TestUnregisterNextInvokable();
    void TestFullUpdateFlags();
    void TestPartialUpdateFlags();
+   void TestDirtyPropertyPublishing();
 
 private:
+   void GetUpdatesAbout(dtGame::TestComponent& tc, const dtCore::UniqueId& id,
+            std::vector<const dtGame::ActorUpdateMessage*>& toFill);
 };
 
 
@@ -1106,3 +1112,144 @@ void GameActorTests::TestUnregisterNextInvokable()
 
    dtCore::System::GetInstance().Step();
 }
+
+////////////////////////////////////////////////////////////////////////
+void GameActorTests::GetUpdatesAbout(dtGame::TestComponent& tc, const dtCore::UniqueId& id,
+         std::vector<const dtGame::ActorUpdateMessage*>& toFill)
+{
+   toFill.clear();
+   for (unsigned i = 0; i < tc.GetReceivedProcessMessages().size(); ++i)
+   {
+      const dtGame::Message& msg = *tc.GetReceivedProcessMessages()[i];
+      if (msg.GetMessageType() == dtGame::MessageType::INFO_ACTOR_UPDATED && msg.GetAboutActorId() == id)
+      {
+         toFill.push_back(static_cast<const dtGame::ActorUpdateMessage*>(&msg));
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////
+void GameActorTests::TestDirtyPropertyPublishing()
+{
+   dtCore::RefPtr<dtGame::TestComponent> tc = new dtGame::TestComponent("name");
+   mGM->AddComponent(*tc, dtGame::GameManager::ComponentPriority::NORMAL);
+
+   dtCore::RefPtr<const dtCore::ActorType> actor1Type = mGM->FindActorType("ExampleActors", "TestGamePropertyActor");
+   dtCore::RefPtr<TestGamePropertyActor> actor1;
+   mGM->CreateActor(*actor1Type, actor1);
+   CPPUNIT_ASSERT_MESSAGE("Actor should not be NULL", actor1 != NULL);
+   CPPUNIT_ASSERT(actor1->GetPropertyPublishPolicy() == dtGame::GameActorProxy::PropertyPublishPolicy::MANUAL);
+
+   dtCore::FloatActorProperty* floatProp = NULL;
+   dtCore::IntActorProperty* intProp = NULL;
+   dtCore::BooleanActorProperty* boolProp = NULL;
+   dtCore::Vec3ActorProperty* vecProp = NULL;
+   actor1->GetProperty("Test_Float", floatProp);
+   actor1->GetProperty("Test_Int", intProp);
+   actor1->GetProperty("Test_Boolean", boolProp);
+   actor1->GetProperty("Test_Vec3", vecProp);
+   CPPUNIT_ASSERT(floatProp != NULL && intProp != NULL && boolProp != NULL && vecProp != NULL);
+
+   CPPUNIT_ASSERT(!intProp->IsDirty());
+   intProp->SetValue(3);
+   CPPUNIT_ASSERT_MESSAGE("Setting through the property should mark it dirty.", intProp->IsDirty());
+
+   actor1->SetPropertyPublishPolicy(dtGame::GameActorProxy::PropertyPublishPolicy::DIRTY_PROPERTIES);
+   CPPUNIT_ASSERT_MESSAGE("Changing the policy should clear the dirty flags.", !intProp->IsDirty());
+
+   floatProp->SetValue(2.0f);
+   mGM->AddActor(*actor1, false, false);
+   CPPUNIT_ASSERT_MESSAGE("The create message has the values, so entering the world should clear the dirty flags.",
+            !floatProp->IsDirty());
+
+   std::vector<const dtGame::ActorUpdateMessage*> updates;
+
+   dtCore::System::GetInstance().Step();
+   GetUpdatesAbout(*tc, actor1->GetId(), updates);
+   CPPUNIT_ASSERT_MESSAGE("Nothing changed, so nothing should be published.", updates.empty());
+
+   // Several changes in one tick should go out together in one partial update with only those properties.
+   tc->reset();
+   intProp->SetValue(4);
+   intProp->SetValue(5);
+   boolProp->SetValue(!boolProp->GetValue());
+   dtCore::System::GetInstance().Step();
+   GetUpdatesAbout(*tc, actor1->GetId(), updates);
+   CPPUNIT_ASSERT_EQUAL(1U, unsigned(updates.size()));
+   CPPUNIT_ASSERT(updates[0]->IsPartialUpdate());
+   const dtCore::NamedParameter* intParam = updates[0]->GetUpdateParameter("Test_Int");
+   CPPUNIT_ASSERT(intParam != NULL);
+   CPPUNIT_ASSERT_EQUAL(5, static_cast<const dtCore::NamedIntParameter*>(intParam)->GetValue());
+   CPPUNIT_ASSERT(updates[0]->GetUpdateParameter("Test_Boolean") != NULL);
+   CPPUNIT_ASSERT(updates[0]->GetUpdateParameter("Test_Float") == NULL);
+   CPPUNIT_ASSERT(updates[0]->GetUpdateParameter("Test_Vec3") == NULL);
+   CPPUNIT_ASSERT(!intProp->IsDirty());
+
+   // Small moves are held back until they add up to more than the threshold from the last value sent.
+   actor1->SetPropertyPublishThreshold("Test_Vec3", 0.5f);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5f, actor1->GetPropertyPublishThreshold("Test_Vec3"), 1e-6f);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0f, actor1->GetPropertyPublishThreshold("Test_Float"), 1e-6f);
+   osg::Vec3 start = vecProp->GetValue();
+
+   tc->reset();
+   vecProp->SetValue(start + osg::Vec3(0.2f, 0.0f, 0.0f));
+   dtCore::System::GetInstance().Step();
+   vecProp->SetValue(start + osg::Vec3(0.4f, 0.0f, -0.3f));
+   dtCore::System::GetInstance().Step();
+   GetUpdatesAbout(*tc, actor1->GetId(), updates);
+   CPPUNIT_ASSERT_MESSAGE("Changes within the threshold should not be published.", updates.empty());
+
+   vecProp->SetValue(start + osg::Vec3(0.6f, 0.0f, 0.0f));
+   dtCore::System::GetInstance().Step();
+   GetUpdatesAbout(*tc, actor1->GetId(), updates);
+   CPPUNIT_ASSERT_EQUAL(1U, unsigned(updates.size()));
+   const dtCore::NamedParameter* vecParam = updates[0]->GetUpdateParameter("Test_Vec3");
+   CPPUNIT_ASSERT(vecParam != NULL);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(start.x() + 0.6f,
+            static_cast<const dtCore::NamedVec3Parameter*>(vecParam)->GetValue().x(), 1e-4f);
+
+   tc->reset();
+   vecProp->SetValue(start + osg::Vec3(0.8f, 0.0f, 0.0f));
+   dtCore::System::GetInstance().Step();
+   GetUpdatesAbout(*tc, actor1->GetId(), updates);
+   CPPUNIT_ASSERT_MESSAGE("The threshold should be measured from the last value sent.", updates.empty());
+
+   // Changing the value with the actor's setter bypasses the property, so it has to be marked by hand.
+   actor1->SetTestFloat(7.0f);
+   dtCore::System::GetInstance().Step();
+   GetUpdatesAbout(*tc, actor1->GetId(), updates);
+   CPPUNIT_ASSERT(updates.empty());
+
+   actor1->MarkPropertyDirty("Test_Float");
+   dtCore::System::GetInstance().Step();
+   GetUpdatesAbout(*tc, actor1->GetId(), updates);
+   CPPUNIT_ASSERT_EQUAL(1U, unsigned(updates.size()));
+   CPPUNIT_ASSERT(updates[0]->GetUpdateParameter("Test_Float") != NULL);
+   CPPUNIT_ASSERT(updates[0]->GetUpdateParameter("Test_Int") == NULL);
+
+   // A full update already has everything, so the changes before it shouldn't go out again.
+   tc->reset();
+   intProp->SetValue(9);
+   actor1->NotifyFullActorUpdate();
+   dtCore::System::GetInstance().Step();
+   GetUpdatesAbout(*tc, actor1->GetId(), updates);
+   CPPUNIT_ASSERT_EQUAL(1U, unsigned(updates.size()));
+   CPPUNIT_ASSERT(!updates[0]->IsPartialUpdate());
+
+   // Back to manual, changes are only sent when asked for.
+   tc->reset();
+   actor1->SetPropertyPublishPolicy(dtGame::GameActorProxy::PropertyPublishPolicy::MANUAL);
+   intProp->SetValue(10);
+   dtCore::System::GetInstance().Step();
+   GetUpdatesAbout(*tc, actor1->GetId(), updates);
+   CPPUNIT_ASSERT(updates.empty());
+
+   // The GM dropped it above, so switching back has to register it again, but only once.
+   actor1->SetPropertyPublishPolicy(dtGame::GameActorProxy::PropertyPublishPolicy::DIRTY_PROPERTIES);
+   actor1->SetPropertyPublishPolicy(dtGame::GameActorProxy::PropertyPublishPolicy::DIRTY_PROPERTIES);
+   intProp->SetValue(11);
+   dtCore::System::GetInstance().Step();
+   GetUpdatesAbout(*tc, actor1->GetId(), updates);
+   CPPUNIT_ASSERT_EQUAL(1U, unsigned(updates.size()));
+   CPPUNIT_ASSERT(updates[0]->GetUpdateParameter("Test_Int") != NULL);
+}
@@ -30,16 +30,25 @@
 #include <dtCore/scene.h>
 #include <dtCore/refptr.h>
 #include <dtCore/system.h>
+#include <dtCore/timer.h>
 #include <dtGame/gamemanager.h>
 #include <dtGame/gmcomponent.h>
+#include <dtGame/message.h>
+#include <dtGame/messagefactory.h>
+#include <dtGame/messagetype.h>
+#include <dtUtil/log.h>
 #include <dtUtil/stringutils.h>
 
+#include <sstream>
+
 class GMComponentTests : public CPPUNIT_NS::TestFixture
 {
    CPPUNIT_TEST_SUITE(GMComponentTests);
    CPPUNIT_TEST(TestComponentRemovingItselfDuringMessage);
    CPPUNIT_TEST(TestComponentRemovingAnotherDuringMessage);
    CPPUNIT_TEST(TestComponentAddingAnotherDuringMessage);
+   CPPUNIT_TEST(TestMessageSubscriptions);
+   CPPUNIT_TEST(TestSubscriptionDispatchPerformance);
    //CPPUNIT_TEST(TestComponentMessagePerformance); //disabled - just used for benchmarking
    CPPUNIT_TEST_SUITE_END();
 
@@ -51,6 +60,11 @@ public:
    void TestComponentRemovingAnotherDuringMessage();
    void TestComponentAddingAnotherDuringMessage();
    void TestComponentMessagePerformance();
+   void TestMessageSubscriptions();
+   void TestSubscriptionDispatchPerformance();
+
+private:
+   double RunDispatchBenchmark(bool subscribe, unsigned& tickCount);
 };
 
 // Registers the fixture into the 'registry'
@@ -225,3 +239,183 @@ void GMComponentTests::TestComponentMessagePerformance()
    gm = NULL;
    scene = NULL;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+class SubscribingComp : public dtGame::GMComponent
+{
+public:
+   SubscribingComp(const std::string& name, std::vector<std::string>* order = NULL)
+      : dtGame::GMComponent(name)
+      , mOrder(order)
+      , mTickCount(0)
+      , mTimerCount(0)
+      , mOtherCount(0)
+   {}
+
+   virtual void ProcessMessage(const dtGame::Message& message)
+   {
+      // The chain of compares a catch-all component has to do.
+      const dtGame::MessageType& type = message.GetMessageType();
+      if (type == dtGame::MessageType::TICK_LOCAL)
+      {
+         ++mTickCount;
+      }
+      else if (type == dtGame::MessageType::INFO_TIMER_ELAPSED)
+      {
+         ++mTimerCount;
+         if (mOrder != NULL)
+         {
+            mOrder->push_back(GetName());
+         }
+      }
+      else
+      {
+         ++mOtherCount;
+      }
+   }
+
+   std::vector<std::string>* mOrder;
+   unsigned mTickCount;
+   unsigned mTimerCount;
+   unsigned mOtherCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+void GMComponentTests::TestMessageSubscriptions()
+{
+   dtCore::RefPtr<dtCore::Scene> scene = new dtCore::Scene();
+   dtCore::RefPtr<dtGame::GameManager> gm = new dtGame::GameManager(*scene);
+
+   std::vector<std::string> order;
+   dtCore::RefPtr<SubscribingComp> catchAll = new SubscribingComp("CatchAll", &order);
+   dtCore::RefPtr<SubscribingComp> tickOnly = new SubscribingComp("TickOnly", &order);
+   dtCore::RefPtr<SubscribingComp> timerOnly = new SubscribingComp("TimerOnly", &order);
+
+   CPPUNIT_ASSERT(tickOnly->IsSubscribedToAllMessages());
+   CPPUNIT_ASSERT(tickOnly->IsSubscribedTo(dtGame::MessageType::INFO_TIMER_ELAPSED));
+
+   tickOnly->AddMessageSubscription(dtGame::MessageType::TICK_LOCAL);
+   tickOnly->AddMessageSubscription(dtGame::MessageType::TICK_LOCAL);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), tickOnly->GetMessageSubscriptions().size());
+   CPPUNIT_ASSERT(!tickOnly->IsSubscribedToAllMessages());
+   CPPUNIT_ASSERT(tickOnly->IsSubscribedTo(dtGame::MessageType::TICK_LOCAL));
+   CPPUNIT_ASSERT(!tickOnly->IsSubscribedTo(dtGame::MessageType::INFO_TIMER_ELAPSED));
+
+   gm->AddComponent(*timerOnly, dtGame::GameManager::ComponentPriority::LOWEST);
+   gm->AddComponent(*tickOnly, dtGame::GameManager::ComponentPriority::NORMAL);
+   gm->AddComponent(*catchAll, dtGame::GameManager::ComponentPriority::HIGHEST);
+
+   // Subscribing after being added has to update the GM's dispatch lists.
+   timerOnly->AddMessageSubscription(dtGame::MessageType::INFO_TIMER_ELAPSED);
+
+   dtCore::RefPtr<dtGame::Message> timerMsg =
+      gm->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_TIMER_ELAPSED);
+
+   dtCore::System::GetInstance().Start();
+   gm->SendMessage(*timerMsg);
+   dtCore::System::GetInstance().Step();
+
+   CPPUNIT_ASSERT(catchAll->mTickCount > 0);
+   CPPUNIT_ASSERT_EQUAL(1U, catchAll->mTimerCount);
+   CPPUNIT_ASSERT(catchAll->mOtherCount > 0);
+
+   CPPUNIT_ASSERT_EQUAL(catchAll->mTickCount, tickOnly->mTickCount);
+   CPPUNIT_ASSERT_EQUAL(0U, tickOnly->mTimerCount);
+   CPPUNIT_ASSERT_EQUAL(0U, tickOnly->mOtherCount);
+
+   CPPUNIT_ASSERT_EQUAL(0U, timerOnly->mTickCount);
+   CPPUNIT_ASSERT_EQUAL(1U, timerOnly->mTimerCount);
+   CPPUNIT_ASSERT_EQUAL(0U, timerOnly->mOtherCount);
+
+   // Subscribed components still get messages in priority order.
+   CPPUNIT_ASSERT_EQUAL(size_t(2), order.size());
+   CPPUNIT_ASSERT_EQUAL(std::string("CatchAll"), order[0]);
+   CPPUNIT_ASSERT_EQUAL(std::string("TimerOnly"), order[1]);
+
+   // Dropping the last subscription goes back to getting everything.
+   tickOnly->RemoveMessageSubscription(dtGame::MessageType::TICK_LOCAL);
+   CPPUNIT_ASSERT(tickOnly->IsSubscribedToAllMessages());
+   order.clear();
+   gm->SendMessage(*timerMsg);
+   dtCore::System::GetInstance().Step();
+
+   CPPUNIT_ASSERT_EQUAL(1U, tickOnly->mTimerCount);
+   CPPUNIT_ASSERT_EQUAL(size_t(3), order.size());
+   CPPUNIT_ASSERT_EQUAL(std::string("TickOnly"), order[1]);
+
+   // A removed component must drop out of the cached lists.
+   gm->RemoveComponent(*timerOnly);
+   gm->SendMessage(*timerMsg);
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL(2U, timerOnly->mTimerCount);
+   CPPUNIT_ASSERT_EQUAL(3U, catchAll->mTimerCount);
+
+   gm->Shutdown();
+   gm = NULL;
+   scene = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double GMComponentTests::RunDispatchBenchmark(bool subscribe, unsigned& tickCount)
+{
+   const unsigned numComponents = 30;
+   const unsigned numMessages = 100000;
+
+   dtCore::RefPtr<dtCore::Scene> scene = new dtCore::Scene();
+   dtCore::RefPtr<dtGame::GameManager> gm = new dtGame::GameManager(*scene);
+
+   std::vector<dtCore::RefPtr<SubscribingComp> > comps;
+   for (unsigned i = 0; i < numComponents; ++i)
+   {
+      comps.push_back(new SubscribingComp("Comp" + dtUtil::ToString(i)));
+      if (subscribe)
+      {
+         comps.back()->AddMessageSubscription(dtGame::MessageType::TICK_LOCAL);
+      }
+      gm->AddComponent(*comps.back());
+   }
+
+   dtCore::RefPtr<dtGame::Message> timerMsg =
+      gm->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_TIMER_ELAPSED);
+
+   dtCore::System::GetInstance().Start();
+   dtCore::System::GetInstance().Step();
+
+   for (unsigned i = 0; i < numMessages; ++i)
+   {
+      gm->SendMessage(*timerMsg);
+   }
+
+   dtCore::Timer statsTickClock;
+   dtCore::Timer_t frameStart = statsTickClock.Tick();
+   dtCore::System::GetInstance().Step();
+   double elapsed = statsTickClock.DeltaMil(frameStart, statsTickClock.Tick());
+
+   tickCount = comps.back()->mTickCount;
+   for (unsigned i = 0; i < numComponents; ++i)
+   {
+      CPPUNIT_ASSERT_EQUAL(tickCount, comps[i]->mTickCount);
+      CPPUNIT_ASSERT_EQUAL(subscribe ? 0U : numMessages, comps[i]->mTimerCount);
+   }
+
+   gm->Shutdown();
+   gm = NULL;
+   scene = NULL;
+   return elapsed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GMComponentTests::TestSubscriptionDispatchPerformance()
+{
+   unsigned catchAllTicks = 0, subscribedTicks = 0;
+   double catchAllTime = RunDispatchBenchmark(false, catchAllTicks);
+   double subscribedTime = RunDispatchBenchmark(true, subscribedTicks);
+
+   CPPUNIT_ASSERT_EQUAL(catchAllTicks, subscribedTicks);
+   CPPUNIT_ASSERT(subscribedTicks > 0);
+
+   std::ostringstream ss;
+   ss << "Dispatching 100000 messages to 30 components took " << catchAllTime
+      << "ms with catch-all components and " << subscribedTime << "ms with tick-only subscriptions.";
+   LOG_ALWAYS(ss.str());
+}
@@ -27,6 +27,7 @@
  */
 
 #include <prefix/unittestprefix.h>
+#include <algorithm>
 #include <iostream>
 #include <osg/Math>
 #include <dtUtil/log.h>
@@ -50,6 +51,7 @@
 
 #include <dtUtil/fileutils.h>
 #include <dtUtil/datastream.h>
+#include <dtUtil/threadpool.h>
 
 #include <dtGame/messageparameter.h>
 #include <dtGame/machineinfo.h>
@@ -90,6 +92,7 @@ class MessageTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestChangeMap);
       CPPUNIT_TEST(TestChangeMapGameEvents);
       CPPUNIT_TEST(TestChangeMapErrorConditions);
+      CPPUNIT_TEST(TestChangeMapAsync);
       CPPUNIT_TEST(TestDefaultMessageProcessorWithPauseResumeRequests);
       CPPUNIT_TEST(TestDefaultMessageProcessorWithMapRequests);
       CPPUNIT_TEST(TestDefaultMessageProcessorWithPauseResumeCommands);
@@ -125,6 +128,7 @@ public:
    void TestChangeMapGameEvents();
    void TestChangeMap();
    void TestChangeMapErrorConditions();
+   void TestChangeMapAsync();
    void TestDefaultMessageProcessorWithPauseResumeRequests();
    void TestDefaultMessageProcessorWithMapRequests();
    void TestDefaultMessageProcessorWithPauseResumeCommands();
@@ -1395,6 +1399,119 @@ void MessageTests::TestChangeMap()
 //   }
 }
 
+//////////////////////////////////////////////////////////////////////////
+void MessageTests::TestChangeMapAsync()
+{
+   bool initPool = !dtUtil::ThreadPool::IsInitialized();
+   if (initPool)
+   {
+      dtUtil::ThreadPool::Init();
+   }
+
+   try
+   {
+      dtCore::Project& project = dtCore::Project::GetInstance();
+      dtGame::GameManager::NameVector mapNamesExpected;
+      mapNamesExpected.push_back("Async Game Actors");
+      mapNamesExpected.push_back("Async Game Actors the second");
+
+      dtCore::RefPtr<dtCore::Map> mapA = &project.CreateMap(mapNamesExpected[0], "aga");
+      dtCore::RefPtr<dtCore::Map> mapB = &project.CreateMap(mapNamesExpected[1], "agb");
+
+      createActors(*mapA);
+      createActors(*mapB);
+
+      mapA->GetEventManager().AddEvent(*new dtCore::GameEvent("event1", "Event"));
+      mapB->GetEventManager().AddEvent(*new dtCore::GameEvent("event2", "Event"));
+
+      mapA->AddLibrary(mTestGameActorLibrary, "1.0");
+      mapA->AddLibrary(mTestActorLibrary, "1.0");
+      mapB->AddLibrary(mTestGameActorLibrary, "1.0");
+      mapB->AddLibrary(mTestActorLibrary, "1.0");
+
+      // The two crash actors throw in OnEnteredWorld, so they don't end up in the GM.
+      const size_t expectedActors = mapA->GetAllProxies().size() + mapB->GetAllProxies().size() - 2;
+
+      project.SaveMap(*mapA);
+      project.CloseMap(*mapA);
+      project.SaveMap(*mapB);
+      project.CloseMap(*mapB);
+
+      dtGame::TestComponent& tc = *new dtGame::TestComponent("name");
+      mGameManager->AddComponent(tc, dtGame::GameManager::ComponentPriority::NORMAL);
+
+      const unsigned actorsPerFrame = 5U;
+      mGameManager->GetGMSettings().SetMapLoadActorsPerFrame(actorsPerFrame);
+      mGameManager->ChangeMapSetAsync(mapNamesExpected, false);
+
+      CPPUNIT_ASSERT_THROW(mGameManager->ChangeMapSet(mapNamesExpected, false), dtUtil::Exception);
+
+      unsigned numFrames = 0U;
+      size_t lastNumActors = 0U;
+      while (!tc.FindProcessMessageOfType(dtGame::MessageType::INFO_MAP_CHANGED).valid() && numFrames < 5000U)
+      {
+         dtCore::AppSleep(1);
+         dtCore::System::GetInstance().Step();
+         ++numFrames;
+
+         size_t numActors = mGameManager->GetNumAllActors();
+         CPPUNIT_ASSERT_MESSAGE("No more than the budget of actors should be added in a frame.",
+                                numActors - lastNumActors <= actorsPerFrame);
+         lastNumActors = numActors;
+      }
+
+      CPPUNIT_ASSERT_EQUAL(expectedActors, mGameManager->GetNumAllActors());
+      CPPUNIT_ASSERT_MESSAGE("The actors should have been added over several frames.",
+                             numFrames > unsigned(expectedActors / actorsPerFrame));
+
+      dtCore::GameEventManager& mainGEM = dtCore::GameEventManager::GetInstance();
+      CPPUNIT_ASSERT(mainGEM.FindEvent("event1") != NULL);
+      CPPUNIT_ASSERT(mainGEM.FindEvent("event2") != NULL);
+
+      // The map messages come in the same order as a synchronous change.
+      std::vector<const dtGame::MessageType*> expectedOrder;
+      expectedOrder.push_back(&dtGame::MessageType::INFO_MAP_CHANGE_BEGIN);
+      expectedOrder.push_back(&dtGame::MessageType::INFO_MAP_LOAD_BEGIN);
+      expectedOrder.push_back(&dtGame::MessageType::INFO_MAPS_OPENED);
+      expectedOrder.push_back(&dtGame::MessageType::INFO_MAP_LOADED);
+      expectedOrder.push_back(&dtGame::MessageType::INFO_MAP_CHANGED);
+
+      unsigned next = 0U;
+      std::vector<dtCore::RefPtr<const dtGame::Message> >& received = tc.GetReceivedProcessMessages();
+      for (unsigned i = 0; i < received.size(); ++i)
+      {
+         const dtGame::MessageType& type = received[i]->GetMessageType();
+         if (std::find(expectedOrder.begin(), expectedOrder.end(), &type) == expectedOrder.end())
+         {
+            continue;
+         }
+
+         CPPUNIT_ASSERT_MESSAGE("Unexpected map message " + type.GetName(), next < expectedOrder.size());
+         CPPUNIT_ASSERT_EQUAL(expectedOrder[next]->GetName(), type.GetName());
+         CheckMapNames(static_cast<const dtGame::MapMessage&>(*received[i]), mapNamesExpected);
+         ++next;
+      }
+      CPPUNIT_ASSERT_EQUAL(unsigned(expectedOrder.size()), next);
+
+      CPPUNIT_ASSERT(project.IsMapOpen(mapNamesExpected[0]));
+      CPPUNIT_ASSERT(project.IsMapOpen(mapNamesExpected[1]));
+      CPPUNIT_ASSERT(mGameManager->GetCurrentMapSet() == mapNamesExpected);
+   }
+   catch(const dtUtil::Exception& e)
+   {
+      if (initPool)
+      {
+         dtUtil::ThreadPool::Shutdown();
+      }
+      CPPUNIT_FAIL(e.ToString());
+   }
+
+   if (initPool)
+   {
+      dtUtil::ThreadPool::Shutdown();
+   }
+}
+
 void MessageTests::TestGameEventMessage()
 {
    try
@@ -0,0 +1,369 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "basegmtests.h"
+
+#include <dtGame/spatialindexcomponent.h>
+#include <dtGame/gameactorproxy.h>
+#include <dtCore/system.h>
+#include <dtCore/timer.h>
+#include <dtCore/transform.h>
+#include <dtCore/transformable.h>
+
+#include <osg/io_utils>
+
+#include <algorithm>
+#include <sstream>
+#include <cstdlib>
+
+namespace dtGame
+{
+   class SpatialIndexComponentTests : public BaseGMTestFixture
+   {
+      CPPUNIT_TEST_SUITE(SpatialIndexComponentTests);
+         CPPUNIT_TEST(TestTracksActors);
+         CPPUNIT_TEST(TestRadiusQuery);
+         CPPUNIT_TEST(TestCellSizeChange);
+         CPPUNIT_TEST(TestVolumeEvents);
+         CPPUNIT_TEST(TestRemoveVolumeFromEvent);
+         CPPUNIT_TEST(TestMoversAndVolumesPerformance);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp() override
+      {
+         BaseGMTestFixture::setUp();
+         mSpatialIndex = new SpatialIndexComponent();
+         mGM->AddComponent(*mSpatialIndex, GameManager::ComponentPriority::NORMAL);
+         mEnterCount = 0;
+         mLeaveCount = 0;
+      }
+
+      void tearDown() override
+      {
+         mSpatialIndex = NULL;
+         BaseGMTestFixture::tearDown();
+      }
+
+      void OnVolumeEvent(const dtCore::UniqueId&, GameActorProxy&, SpatialIndexComponent::VolumeEventType eventType)
+      {
+         if (eventType == SpatialIndexComponent::VOLUME_ENTER)
+         {
+            ++mEnterCount;
+         }
+         else
+         {
+            ++mLeaveCount;
+         }
+      }
+
+      /// Removes the volume the first time it fires, like a one shot trigger.
+      void OnVolumeEventRemove(const dtCore::UniqueId& volumeId, GameActorProxy& actor, SpatialIndexComponent::VolumeEventType eventType)
+      {
+         OnVolumeEvent(volumeId, actor, eventType);
+         mSpatialIndex->RemoveVolume(volumeId);
+      }
+
+      dtCore::RefPtr<GameActorProxy> CreateActorAt(const osg::Vec3& pos)
+      {
+         dtCore::RefPtr<GameActorProxy> actor;
+         mGM->CreateActor("ExampleActors", "Test1Actor", actor);
+         CPPUNIT_ASSERT(actor.valid());
+         MoveActor(*actor, pos);
+         mGM->AddActor(*actor, false, false);
+         return actor;
+      }
+
+      void MoveActor(GameActorProxy& actor, const osg::Vec3& pos)
+      {
+         dtCore::Transformable* xformable = actor.GetDrawable<dtCore::Transformable>();
+         dtCore::Transform xform;
+         xformable->GetTransform(xform);
+         xform.SetTranslation(pos);
+         xformable->SetTransform(xform);
+      }
+
+      void TestTracksActors()
+      {
+         dtCore::RefPtr<GameActorProxy> actor = CreateActorAt(osg::Vec3(10.0f, 10.0f, 0.0f));
+         dtCore::System::GetInstance().Step(0.016);
+         CPPUNIT_ASSERT(mSpatialIndex->IsActorIndexed(actor->GetId()));
+         CPPUNIT_ASSERT_EQUAL(1U, mSpatialIndex->GetNumIndexedActors());
+
+         osg::Vec3 pos;
+         CPPUNIT_ASSERT(mSpatialIndex->GetActorPosition(actor->GetId(), pos));
+         CPPUNIT_ASSERT_EQUAL(osg::Vec3(10.0f, 10.0f, 0.0f), pos);
+
+         MoveActor(*actor, osg::Vec3(500.0f, -300.0f, 20.0f));
+         dtCore::System::GetInstance().Step(0.016);
+         CPPUNIT_ASSERT(mSpatialIndex->GetActorPosition(actor->GetId(), pos));
+         CPPUNIT_ASSERT_EQUAL(osg::Vec3(500.0f, -300.0f, 20.0f), pos);
+
+         mGM->DeleteActor(*actor);
+         dtCore::System::GetInstance().Step(0.016);
+         CPPUNIT_ASSERT(!mSpatialIndex->IsActorIndexed(actor->GetId()));
+         CPPUNIT_ASSERT_EQUAL(0U, mSpatialIndex->GetNumIndexedActors());
+      }
+
+      void TestRadiusQuery()
+      {
+         mSpatialIndex->SetCellSize(10.0f);
+         std::vector<dtCore::RefPtr<GameActorProxy> > actors;
+         for (int i = 0; i < 100; ++i)
+         {
+            actors.push_back(CreateActorAt(osg::Vec3(float(i) * 3.0f, 0.0f, 0.0f)));
+         }
+         dtCore::System::GetInstance().Step(0.016);
+
+         SpatialIndexComponent::ActorVector found;
+         mSpatialIndex->FindActorsInRadius(osg::Vec3(30.0f, 0.0f, 0.0f), 10.0f, found);
+         // 21, 24, ... 39 -> 7 actors
+         CPPUNIT_ASSERT_EQUAL(size_t(7), found.size());
+         for (unsigned i = 0; i < found.size(); ++i)
+         {
+            osg::Vec3 pos;
+            mSpatialIndex->GetActorPosition(found[i]->GetId(), pos);
+            CPPUNIT_ASSERT((pos - osg::Vec3(30.0f, 0.0f, 0.0f)).length() <= 10.0f);
+         }
+
+         found.clear();
+         mSpatialIndex->FindActorsInBox(osg::BoundingBox(-1.0f, -1.0f, -1.0f, 7.0f, 1.0f, 1.0f), found);
+         CPPUNIT_ASSERT_EQUAL(size_t(3), found.size());
+
+         found.clear();
+         // big enough to fall back to the linear scan
+         mSpatialIndex->FindActorsInRadius(osg::Vec3(150.0f, 0.0f, 0.0f), 10000.0f, found);
+         CPPUNIT_ASSERT_EQUAL(actors.size(), found.size());
+      }
+
+      void TestCellSizeChange()
+      {
+         for (int i = 0; i < 20; ++i)
+         {
+            CreateActorAt(osg::Vec3(float(i) * 7.0f, float(i) * -3.0f, 1.0f));
+         }
+         dtCore::System::GetInstance().Step(0.016);
+
+         SpatialIndexComponent::ActorVector before, after;
+         mSpatialIndex->FindActorsInRadius(osg::Vec3(40.0f, -20.0f, 0.0f), 25.0f, before);
+         mSpatialIndex->SetCellSize(3.0f);
+         mSpatialIndex->FindActorsInRadius(osg::Vec3(40.0f, -20.0f, 0.0f), 25.0f, after);
+         std::sort(before.begin(), before.end());
+         std::sort(after.begin(), after.end());
+         CPPUNIT_ASSERT(!before.empty());
+         CPPUNIT_ASSERT(before == after);
+      }
+
+      void TestVolumeEvents()
+      {
+         dtCore::RefPtr<GameActorProxy> volumeOwner = CreateActorAt(osg::Vec3(0.0f, 0.0f, 0.0f));
+         dtCore::RefPtr<GameActorProxy> mover = CreateActorAt(osg::Vec3(100.0f, 0.0f, 0.0f));
+         dtCore::System::GetInstance().Step(0.016);
+
+         CPPUNIT_ASSERT(mSpatialIndex->AddVolume(volumeOwner->GetId(), osg::Vec3(5.0f, 5.0f, 5.0f),
+                  SpatialIndexComponent::VolumeEventFunc(this, &SpatialIndexComponentTests::OnVolumeEvent)));
+         CPPUNIT_ASSERT_MESSAGE("A volume can only be added once",
+                  !mSpatialIndex->AddVolume(volumeOwner->GetId(), osg::Vec3(5.0f, 5.0f, 5.0f),
+                  SpatialIndexComponent::VolumeEventFunc(this, &SpatialIndexComponentTests::OnVolumeEvent)));
+
+         dtCore::System::GetInstance().Step(0.016);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("The owner is not an occupant of its own volume.", 0, mEnterCount);
+
+         MoveActor(*mover, osg::Vec3(2.0f, 1.0f, 0.0f));
+         dtCore::System::GetInstance().Step(0.016);
+         CPPUNIT_ASSERT_EQUAL(1, mEnterCount);
+         CPPUNIT_ASSERT_EQUAL(0, mLeaveCount);
+
+         std::vector<dtCore::UniqueId> occupants;
+         mSpatialIndex->GetVolumeOccupants(volumeOwner->GetId(), occupants);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), occupants.size());
+         CPPUNIT_ASSERT_EQUAL(mover->GetId(), occupants[0]);
+
+         // Staying inside must not send any more events.
+         MoveActor(*mover, osg::Vec3(-3.0f, 1.0f, 0.0f));
+         dtCore::System::GetInstance().Step(0.016);
+         CPPUNIT_ASSERT_EQUAL(1, mEnterCount);
+
+         // Moving the volume away is just as good as moving the actor out.
+         MoveActor(*volumeOwner, osg::Vec3(0.0f, 50.0f, 0.0f));
+         dtCore::System::GetInstance().Step(0.016);
+         CPPUNIT_ASSERT_EQUAL(1, mLeaveCount);
+
+         MoveActor(*volumeOwner, osg::Vec3(0.0f, 0.0f, 0.0f));
+         dtCore::System::GetInstance().Step(0.016);
+         CPPUNIT_ASSERT_EQUAL(2, mEnterCount);
+
+         mGM->DeleteActor(*mover);
+         dtCore::System::GetInstance().Step(0.016);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("A deleted occupant leaves the volume.", 2, mLeaveCount);
+         occupants.clear();
+         mSpatialIndex->GetVolumeOccupants(volumeOwner->GetId(), occupants);
+         CPPUNIT_ASSERT(occupants.empty());
+
+         CPPUNIT_ASSERT(mSpatialIndex->RemoveVolume(volumeOwner->GetId()));
+         CPPUNIT_ASSERT_EQUAL(0U, mSpatialIndex->GetNumVolumes());
+      }
+
+      void TestRemoveVolumeFromEvent()
+      {
+         dtCore::RefPtr<GameActorProxy> first = CreateActorAt(osg::Vec3(0.0f, 0.0f, 0.0f));
+         dtCore::RefPtr<GameActorProxy> second = CreateActorAt(osg::Vec3(1.0f, 0.0f, 0.0f));
+         dtCore::RefPtr<GameActorProxy> mover = CreateActorAt(osg::Vec3(100.0f, 0.0f, 0.0f));
+         dtCore::System::GetInstance().Step(0.016);
+
+         CPPUNIT_ASSERT(mSpatialIndex->AddVolume(first->GetId(), osg::Vec3(5.0f, 5.0f, 5.0f),
+                  SpatialIndexComponent::VolumeEventFunc(this, &SpatialIndexComponentTests::OnVolumeEventRemove)));
+         CPPUNIT_ASSERT(mSpatialIndex->AddVolume(second->GetId(), osg::Vec3(5.0f, 5.0f, 5.0f),
+                  SpatialIndexComponent::VolumeEventFunc(this, &SpatialIndexComponentTests::OnVolumeEvent)));
+         dtCore::System::GetInstance().Step(0.016);
+         // Each owner is inside the other's volume, and the first one removes itself on its enter.
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Removing a volume from its event must not skip the next volume.", 2, mEnterCount);
+         CPPUNIT_ASSERT_EQUAL(1U, mSpatialIndex->GetNumVolumes());
+
+         MoveActor(*mover, osg::Vec3(0.5f, 0.0f, 0.0f));
+         dtCore::System::GetInstance().Step(0.016);
+         CPPUNIT_ASSERT_EQUAL(3, mEnterCount);
+         std::vector<dtCore::UniqueId> occupants;
+         mSpatialIndex->GetVolumeOccupants(second->GetId(), occupants);
+         CPPUNIT_ASSERT_EQUAL(size_t(2), occupants.size());
+      }
+
+      void TestMoversAndVolumesPerformance()
+      {
+         const unsigned numMovers = 5000;
+         const unsigned numVolumes = 500;
+         const unsigned numFrames = 20;
+         const float worldSize = 5000.0f;
+         const osg::Vec3 halfExtents(20.0f, 20.0f, 20.0f);
+
+         mSpatialIndex->SetUpdateOnTick(false);
+         mSpatialIndex->SetCellSize(50.0f);
+
+         srand(42);
+         std::vector<dtCore::RefPtr<GameActorProxy> > movers, volumes;
+         movers.reserve(numMovers);
+         for (unsigned i = 0; i < numMovers; ++i)
+         {
+            movers.push_back(CreateActorAt(osg::Vec3(RandomCoord(worldSize), RandomCoord(worldSize), 0.0f)));
+         }
+
+         for (unsigned i = 0; i < numVolumes; ++i)
+         {
+            volumes.push_back(CreateActorAt(osg::Vec3(RandomCoord(worldSize), RandomCoord(worldSize), 0.0f)));
+         }
+         dtCore::System::GetInstance().Step(0.016);
+
+         for (unsigned i = 0; i < numVolumes; ++i)
+         {
+            mSpatialIndex->AddVolume(volumes[i]->GetId(), halfExtents,
+                     SpatialIndexComponent::VolumeEventFunc(this, &SpatialIndexComponentTests::OnVolumeEvent));
+         }
+
+         dtCore::Timer statsTickClock;
+         double indexSeconds = 0.0, bruteForceSeconds = 0.0;
+         for (unsigned frame = 0; frame < numFrames; ++frame)
+         {
+            for (unsigned i = 0; i < numMovers; ++i)
+            {
+               osg::Vec3 pos;
+               mSpatialIndex->GetActorPosition(movers[i]->GetId(), pos);
+               pos += osg::Vec3(RandomCoord(10.0f), RandomCoord(10.0f), 0.0f);
+               MoveActor(*movers[i], pos);
+            }
+
+            dtCore::Timer_t start = statsTickClock.Tick();
+            mSpatialIndex->Update();
+            indexSeconds += statsTickClock.DeltaSec(start, statsTickClock.Tick());
+
+            // The brute force answer for the same frame, which is what testing each volume against each candidate costs.
+            start = statsTickClock.Tick();
+            unsigned bruteForceOccupants = 0;
+            std::vector<osg::Vec3> moverPositions(numMovers);
+            for (unsigned i = 0; i < numMovers; ++i)
+            {
+               dtCore::Transform xform;
+               movers[i]->GetDrawable<dtCore::Transformable>()->GetTransform(xform);
+               xform.GetTranslation(moverPositions[i]);
+            }
+            for (unsigned v = 0; v < numVolumes; ++v)
+            {
+               osg::Vec3 center;
+               mSpatialIndex->GetActorPosition(volumes[v]->GetId(), center);
+               osg::BoundingBox box(center - halfExtents, center + halfExtents);
+               for (unsigned i = 0; i < numMovers; ++i)
+               {
+                  if (box.contains(moverPositions[i]))
+                  {
+                     ++bruteForceOccupants;
+                  }
+               }
+            }
+            bruteForceSeconds += statsTickClock.DeltaSec(start, statsTickClock.Tick());
+
+            unsigned indexedOccupants = 0;
+            for (unsigned v = 0; v < numVolumes; ++v)
+            {
+               std::vector<dtCore::UniqueId> occupants;
+               mSpatialIndex->GetVolumeOccupants(volumes[v]->GetId(), occupants);
+               for (unsigned o = 0; o < occupants.size(); ++o)
+               {
+                  // volumes may hold other volume owners, but the brute force only counted movers.
+                  if (std::find_if(volumes.begin(), volumes.end(), HasId(occupants[o])) == volumes.end())
+                  {
+                     ++indexedOccupants;
+                  }
+               }
+            }
+            CPPUNIT_ASSERT_EQUAL(bruteForceOccupants, indexedOccupants);
+         }
+
+         CPPUNIT_ASSERT_MESSAGE("Some movers should have wandered into a volume.", mEnterCount > 0);
+
+         std::ostringstream ss;
+         ss << numMovers << " movers x " << numVolumes << " volumes, " << numFrames << " frames: spatial index update took ["
+            << indexSeconds << "] seconds, brute force took [" << bruteForceSeconds << "] seconds.";
+         mLogger->LogMessage(dtUtil::Log::LOG_ALWAYS, __FUNCTION__, __LINE__, ss.str());
+      }
+
+   private:
+      struct HasId
+      {
+         HasId(const dtCore::UniqueId& id) : mId(id) {}
+         bool operator()(const dtCore::RefPtr<GameActorProxy>& actor) const { return actor->GetId() == mId; }
+         const dtCore::UniqueId& mId;
+      };
+
+      static float RandomCoord(float range)
+      {
+         return (float(rand()) / float(RAND_MAX) - 0.5f) * range;
+      }
+
+      dtCore::RefPtr<SpatialIndexComponent> mSpatialIndex;
+      int mEnterCount;
+      int mLeaveCount;
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(SpatialIndexComponentTests);
+}
@@ -0,0 +1,241 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <dtGame/timerwheel.h>
+#include <dtUtil/log.h>
+
+#include <osg/Timer>
+
+#include <sstream>
+
+namespace dtGame
+{
+   class TimerWheelTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(TimerWheelTests);
+      CPPUNIT_TEST(TestExpireOrder);
+      CPPUNIT_TEST(TestRepeat);
+      CPPUNIT_TEST(TestFarFuture);
+      CPPUNIT_TEST(TestClockBackward);
+      CPPUNIT_TEST(TestClear);
+      CPPUNIT_TEST(TestManyActorTimers);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+
+      void TestExpireOrder()
+      {
+         TimerWheel wheel;
+         dtCore::UniqueId actor;
+         // Same bucket, different microseconds, added out of order.
+         wheel.Add(MakeTimer("c", actor, 1900));
+         wheel.Add(MakeTimer("a", actor, 1100));
+         wheel.Add(MakeTimer("b", actor, 1500));
+         wheel.Add(MakeTimer("d", actor, 700000));
+         CPPUNIT_ASSERT_EQUAL(4U, wheel.GetSize());
+
+         std::vector<TimerWheel::TimerInfo> expired;
+         wheel.Expire(1499, expired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), expired.size());
+         CPPUNIT_ASSERT_EQUAL(std::string("a"), expired[0].name);
+
+         expired.clear();
+         wheel.Expire(900000, expired);
+         CPPUNIT_ASSERT_EQUAL(size_t(3), expired.size());
+         CPPUNIT_ASSERT_EQUAL(std::string("b"), expired[0].name);
+         CPPUNIT_ASSERT_EQUAL(std::string("c"), expired[1].name);
+         CPPUNIT_ASSERT_EQUAL(std::string("d"), expired[2].name);
+         // The original due time is kept so the late time can be computed from it.
+         CPPUNIT_ASSERT_EQUAL(dtCore::Timer_t(700000), expired[2].time);
+         CPPUNIT_ASSERT(wheel.IsEmpty());
+      }
+
+      void TestRepeat()
+      {
+         TimerWheel wheel;
+         TimerWheel::TimerInfo timer = MakeTimer("repeat", dtCore::UniqueId(), 10000);
+         timer.repeat = true;
+         timer.interval = 10000;
+         wheel.Add(timer);
+
+         // Far behind, it still fires only once per call, like the old timer set.
+         std::vector<TimerWheel::TimerInfo> expired;
+         wheel.Expire(55000, expired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), expired.size());
+         CPPUNIT_ASSERT_EQUAL(dtCore::Timer_t(10000), expired[0].time);
+
+         expired.clear();
+         wheel.Expire(55000, expired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), expired.size());
+         CPPUNIT_ASSERT_EQUAL(dtCore::Timer_t(20000), expired[0].time);
+         CPPUNIT_ASSERT_EQUAL(1U, wheel.GetSize());
+      }
+
+      void TestFarFuture()
+      {
+         TimerWheel wheel;
+         dtCore::UniqueId actor;
+         // Real clock times are microseconds since the epoch, well past what the coarsest wheel covers.
+         dtCore::Timer_t start = 1700000000000000ULL;
+         wheel.Expire(start, mExpired);
+
+         wheel.Add(MakeTimer("soon", actor, start + 5000));
+         wheel.Add(MakeTimer("minute", actor, start + 60000000ULL));
+         wheel.Add(MakeTimer("week", actor, start + 7ULL * 24 * 3600 * 1000000ULL));
+         wheel.Add(MakeTimer("year", actor, start + 365ULL * 24 * 3600 * 1000000ULL));
+
+         std::vector<TimerWheel::TimerInfo> expired;
+         wheel.Expire(start + 59999999ULL, expired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), expired.size());
+
+         expired.clear();
+         wheel.Expire(start + 8ULL * 24 * 3600 * 1000000ULL, expired);
+         CPPUNIT_ASSERT_EQUAL(size_t(2), expired.size());
+         CPPUNIT_ASSERT_EQUAL(std::string("minute"), expired[0].name);
+         CPPUNIT_ASSERT_EQUAL(std::string("week"), expired[1].name);
+
+         expired.clear();
+         wheel.Expire(start + 366ULL * 24 * 3600 * 1000000ULL, expired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), expired.size());
+         CPPUNIT_ASSERT_EQUAL(std::string("year"), expired[0].name);
+      }
+
+      void TestClockBackward()
+      {
+         TimerWheel wheel;
+         dtCore::UniqueId actor;
+         wheel.Expire(10000000, mExpired);
+         wheel.Add(MakeTimer("later", actor, 12000000));
+
+         // The simulation time can be set back.  Timers are kept and fire by comparing times as before.
+         std::vector<TimerWheel::TimerInfo> expired;
+         wheel.Expire(2000000, expired);
+         CPPUNIT_ASSERT(expired.empty());
+         wheel.Add(MakeTimer("early", actor, 2500000));
+
+         wheel.Expire(3000000, expired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), expired.size());
+         CPPUNIT_ASSERT_EQUAL(std::string("early"), expired[0].name);
+
+         expired.clear();
+         wheel.Expire(12000000, expired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), expired.size());
+         CPPUNIT_ASSERT_EQUAL(std::string("later"), expired[0].name);
+      }
+
+      void TestClear()
+      {
+         TimerWheel wheel;
+         dtCore::UniqueId actor1, actor2, noActor(false);
+         wheel.Add(MakeTimer("a", actor1, 1000));
+         wheel.Add(MakeTimer("b", actor1, 2000000));
+         wheel.Add(MakeTimer("a", actor2, 3000));
+         wheel.Add(MakeTimer("b", actor2, 4000));
+         wheel.Add(MakeTimer("a", noActor, 5000));
+
+         wheel.Clear("a", &actor2);
+         CPPUNIT_ASSERT_EQUAL(4U, wheel.GetSize());
+
+         wheel.ClearForActor(actor1);
+         CPPUNIT_ASSERT_EQUAL(2U, wheel.GetSize());
+
+         wheel.Clear("a", NULL);
+         CPPUNIT_ASSERT_EQUAL(1U, wheel.GetSize());
+
+         std::vector<TimerWheel::TimerInfo> expired;
+         wheel.Expire(10000000, expired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), expired.size());
+         CPPUNIT_ASSERT_EQUAL(std::string("b"), expired[0].name);
+         CPPUNIT_ASSERT(expired[0].aboutActor == actor2);
+
+         wheel.Add(MakeTimer("c", actor1, 11000000));
+         wheel.Clear();
+         CPPUNIT_ASSERT(wheel.IsEmpty());
+         expired.clear();
+         wheel.Expire(20000000, expired);
+         CPPUNIT_ASSERT(expired.empty());
+      }
+
+      void TestManyActorTimers()
+      {
+         const unsigned numActors = 50000;
+         std::vector<dtCore::UniqueId> actors(numActors);
+
+         TimerWheel wheel;
+         for (unsigned i = 0; i < numActors; ++i)
+         {
+            TimerWheel::TimerInfo timer = MakeTimer("update", actors[i], 0);
+            timer.repeat = true;
+            timer.interval = 100000 + (i % 1000) * 1000;
+            timer.time = timer.interval;
+            wheel.Add(timer);
+         }
+
+         osg::Timer timer;
+         osg::Timer_t start = timer.tick();
+         size_t fired = 0;
+         std::vector<TimerWheel::TimerInfo> expired;
+         for (unsigned frame = 1; frame <= 600; ++frame)
+         {
+            expired.clear();
+            wheel.Expire(frame * 16667ULL, expired);
+            fired += expired.size();
+         }
+         double expireMs = timer.delta_m(start, timer.tick());
+
+         start = timer.tick();
+         for (unsigned i = 0; i < numActors; i += 2)
+         {
+            wheel.ClearForActor(actors[i]);
+         }
+         double clearMs = timer.delta_m(start, timer.tick());
+
+         CPPUNIT_ASSERT_EQUAL(numActors / 2, wheel.GetSize());
+         CPPUNIT_ASSERT(fired > numActors * 10);
+
+         std::ostringstream ss;
+         ss << "Timer wheel with " << numActors << " repeating timers: " << fired << " fired over 600 frames in "
+            << expireMs << " ms, cleared " << numActors / 2 << " actors in " << clearMs << " ms";
+         LOG_ALWAYS(ss.str());
+      }
+
+   private:
+
+      static TimerWheel::TimerInfo MakeTimer(const std::string& name, const dtCore::UniqueId& actor, dtCore::Timer_t time)
+      {
+         TimerWheel::TimerInfo timer;
+         timer.name = name;
+         timer.aboutActor = actor;
+         timer.time = time;
+         timer.repeat = false;
+         timer.interval = 0;
+         return timer;
+      }
+
+      std::vector<TimerWheel::TimerInfo> mExpired;
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(TimerWheelTests);
+}
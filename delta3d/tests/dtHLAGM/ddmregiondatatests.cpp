@@ -29,6 +29,7 @@
 #include <prefix/unittestprefix.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <climits>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -41,6 +42,7 @@ class DDMRegionDataTests : public CPPUNIT_NS::TestFixture
    
       CPPUNIT_TEST(TestDefaults);
       CPPUNIT_TEST(TestGetSet);
+      CPPUNIT_TEST(TestChangeSinceCommit);
 
    CPPUNIT_TEST_SUITE_END();
 
@@ -85,6 +87,43 @@ class DDMRegionDataTests : public CPPUNIT_NS::TestFixture
          CheckDimensions(d, 3);
       }
    
+      void TestChangeSinceCommit()
+      {
+         dtHLAGM::DDMRegionData::DimensionValues d;
+         d.mName = "one";
+         d.mMin = 200;
+         d.mMax = 300;
+         mTestDDMRegionData->SetDimensionValue(0, d);
+
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("A region that was never committed can't be modified in place.",
+               UINT_MAX, mTestDDMRegionData->GetChangeSinceCommit());
+
+         mTestDDMRegionData->MarkCommitted();
+         CPPUNIT_ASSERT_EQUAL(0U, mTestDDMRegionData->GetChangeSinceCommit());
+
+         d.mMin = 190;
+         d.mMax = 325;
+         mTestDDMRegionData->SetDimensionValue(0, d);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("The change should be the largest move of any bound.",
+               25U, mTestDDMRegionData->GetChangeSinceCommit());
+
+         d.mName = "two";
+         mTestDDMRegionData->SetDimensionValue(0, d);
+         CPPUNIT_ASSERT_EQUAL(UINT_MAX, mTestDDMRegionData->GetChangeSinceCommit());
+
+         d.mName = "one";
+         mTestDDMRegionData->SetDimensionValue(0, d);
+         mTestDDMRegionData->SetDimensionValue(1, d);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Adding a dimension can't be done in place.",
+               UINT_MAX, mTestDDMRegionData->GetChangeSinceCommit());
+
+         mTestDDMRegionData->MarkCommitted();
+         CPPUNIT_ASSERT_EQUAL(0U, mTestDDMRegionData->GetChangeSinceCommit());
+
+         mTestDDMRegionData->ClearCommitted();
+         CPPUNIT_ASSERT_EQUAL(UINT_MAX, mTestDDMRegionData->GetChangeSinceCommit());
+      }
+
    private:
       
       void CheckDimensions(const dtHLAGM::DDMRegionData::DimensionValues d[], unsigned count)
@@ -0,0 +1,430 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/unittestprefix.h>
+
+#include <dtCore/camera.h>
+#include <dtCore/refptr.h>
+#include <dtCore/transform.h>
+
+#include <dtHLAGM/ddmcameracalculatorgeographic.h>
+#include <dtHLAGM/ddmregiondata.h>
+#include <dtHLAGM/hlacomponent.h>
+#include <dtHLAGM/rtiambassador.h>
+#include <dtHLAGM/rtiexception.h>
+#include <dtHLAGM/rtihandle.h>
+
+#include <dtUtil/datapathutils.h>
+#include <dtUtil/exception.h>
+#include <dtUtil/log.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <osg/Vec3>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+   const std::string MOCK_IMPLEMENTATION("ddmmock");
+
+   class MockHandle : public dtHLAGM::RTIHandle
+   {
+   public:
+      MockHandle() {}
+
+      bool operator==(RTIHandle& h) override
+      {
+         return &h == this;
+      }
+   protected:
+      ~MockHandle() {}
+   };
+
+   class MockRegion : public dtHLAGM::RTIRegion
+   {
+   public:
+      MockRegion(unsigned numDimensions): mNumDimensions(numDimensions) {}
+
+      unsigned mNumDimensions;
+   protected:
+      ~MockRegion() {}
+   };
+
+   /**
+    * An RTI that doesn't talk to anything, it just counts the DDM calls made on it.
+    */
+   class MockRTIAmbassador : public dtHLAGM::RTIAmbassador
+   {
+   public:
+      MockRTIAmbassador()
+      {
+         ResetCounts();
+      }
+
+      void ResetCounts()
+      {
+         mCreateRegionCalls = 0;
+         mDeleteRegionCalls = 0;
+         mSetRegionDimensionsCalls = 0;
+         mCommitRegionChangesCalls = 0;
+         mGetNumDimensionsCalls = 0;
+         mGetDimensionHandleCalls = 0;
+         mSubscribeCalls = 0;
+         mUnsubscribeCalls = 0;
+      }
+
+      unsigned GetTotalDDMCalls() const
+      {
+         return mCreateRegionCalls + mDeleteRegionCalls + mSetRegionDimensionsCalls + mCommitRegionChangesCalls
+               + mGetNumDimensionsCalls + mGetDimensionHandleCalls + mSubscribeCalls + mUnsubscribeCalls;
+      }
+
+      void Tick() override {}
+      void ConnectToRTI(dtHLAGM::RTIFederateAmbassador&, const std::string&) override {}
+      bool CreateFederationExecution(const std::string&, const std::vector<std::string>&) override { return true; }
+      void JoinFederationExecution(const std::string&, const std::string&) override {}
+      void ResignFederationExecution(const std::string&) override {}
+
+      dtCore::RefPtr<dtHLAGM::RTIObjectClassHandle> GetObjectClassForInstance(dtHLAGM::RTIObjectInstanceHandle&) override { return new MockHandle; }
+      std::string GetObjectClassName(dtHLAGM::RTIObjectClassHandle&) override { return std::string(); }
+      dtCore::RefPtr<dtHLAGM::RTIObjectClassHandle> GetObjectClassHandle(const std::string&) override { return new MockHandle; }
+      dtCore::RefPtr<dtHLAGM::RTIAttributeHandle> GetAttributeHandle(const std::string&, dtHLAGM::RTIObjectClassHandle&) override { return new MockHandle; }
+      std::string GetAttributeName(dtHLAGM::RTIAttributeHandle&, dtHLAGM::RTIObjectClassHandle&) override { return std::string(); }
+
+      void SubscribeObjectClassAttributes(dtHLAGM::RTIObjectClassHandle&, const dtHLAGM::RTIAttributeHandleSet&, dtHLAGM::RTIRegion*) override { ++mSubscribeCalls; }
+      void PublishObjectClass(dtHLAGM::RTIObjectClassHandle&, const dtHLAGM::RTIAttributeHandleSet&) override {}
+      void UnsubscribeObjectClass(dtHLAGM::RTIObjectClassHandle&, dtHLAGM::RTIRegion*) override { ++mUnsubscribeCalls; }
+
+      std::string GetInteractionClassName(dtHLAGM::RTIInteractionClassHandle&) override { return std::string(); }
+      dtCore::RefPtr<dtHLAGM::RTIInteractionClassHandle> GetInteractionClassHandle(const std::string&) override { return new MockHandle; }
+      dtCore::RefPtr<dtHLAGM::RTIParameterHandle> GetParameterHandle(const std::string&, dtHLAGM::RTIInteractionClassHandle&) override { return new MockHandle; }
+
+      void SubscribeInteractionClass(dtHLAGM::RTIInteractionClassHandle&, dtHLAGM::RTIRegion*) override { ++mSubscribeCalls; }
+      void PublishInteractionClass(dtHLAGM::RTIInteractionClassHandle&) override {}
+      void UnsubscribeInteractionClass(dtHLAGM::RTIInteractionClassHandle&, dtHLAGM::RTIRegion*) override { ++mUnsubscribeCalls; }
+
+      void ReserveObjectInstanceName(const std::string&) override {}
+      dtCore::RefPtr<dtHLAGM::RTIObjectInstanceHandle> RegisterObjectInstance(dtHLAGM::RTIObjectClassHandle&, const std::string&) override { return new MockHandle; }
+      void DeleteObjectInstance(dtHLAGM::RTIObjectInstanceHandle&) override {}
+
+      void UpdateAttributeValues(dtHLAGM::RTIObjectInstanceHandle&, dtHLAGM::RTIAttributeHandleValueMap&, const std::string&) override {}
+      void SendInteraction(dtHLAGM::RTIInteractionClassHandle&, const dtHLAGM::RTIParameterHandleValueMap&, const std::string&) override {}
+
+      dtCore::RefPtr<dtHLAGM::RTIRegion> CreateRegion(dtHLAGM::RTIDimensionHandleSet& dimensions) override
+      {
+         ++mCreateRegionCalls;
+         return new MockRegion(unsigned(dimensions.size()));
+      }
+
+      void DeleteRegion(dtHLAGM::RTIRegion&) override { ++mDeleteRegionCalls; }
+
+      void SetRegionDimensions(dtHLAGM::RTIRegion& region, const dtHLAGM::RTIDimensionVector& regionDimensions) override
+      {
+         ++mSetRegionDimensionsCalls;
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Every extent should be sent when setting the region dimensions.",
+               static_cast<MockRegion&>(region).mNumDimensions, unsigned(regionDimensions.size()));
+      }
+
+      void CommitRegionChanges(dtHLAGM::RTIRegion&) override { ++mCommitRegionChangesCalls; }
+
+      unsigned int GetNumDimensions(dtHLAGM::RTIRegion& region) override
+      {
+         ++mGetNumDimensionsCalls;
+         return static_cast<MockRegion&>(region).mNumDimensions;
+      }
+
+      std::string GetDimensionName(dtHLAGM::RTIDimensionHandle&) override { return std::string(); }
+
+      dtCore::RefPtr<dtHLAGM::RTIDimensionHandle> GetDimensionHandle(const std::string&) override
+      {
+         ++mGetDimensionHandleCalls;
+         return new MockHandle;
+      }
+
+      unsigned mCreateRegionCalls;
+      unsigned mDeleteRegionCalls;
+      unsigned mSetRegionDimensionsCalls;
+      unsigned mCommitRegionChangesCalls;
+      unsigned mGetNumDimensionsCalls;
+      unsigned mGetDimensionHandleCalls;
+      unsigned mSubscribeCalls;
+      unsigned mUnsubscribeCalls;
+
+   protected:
+      ~MockRTIAmbassador() {}
+   };
+
+   class TestDDMHLAComponent : public dtHLAGM::HLAComponent
+   {
+   public:
+      void TestUpdateDDMSubscriptions(double currentTime)
+      {
+         UpdateDDMSubscriptions(currentTime);
+      }
+   };
+}
+
+class DDMRegionUpdateTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(DDMRegionUpdateTests);
+
+      CPPUNIT_TEST(TestDefaults);
+      CPPUNIT_TEST(TestInPlaceModification);
+      CPPUNIT_TEST(TestThreshold);
+      CPPUNIT_TEST(TestRateLimit);
+      CPPUNIT_TEST(TestCameraFlight);
+
+   CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp()
+      {
+         dtHLAGM::RTIAmbassador::RegisterImplementation(MOCK_IMPLEMENTATION,
+                  dtHLAGM::RTIAmbassador::CreateFuncType(this, &DDMRegionUpdateTests::CreateMockAmbassador));
+
+         mCamera = new dtCore::Camera("DDMRegionUpdateTests");
+         mCalculator = new dtHLAGM::DDMCameraCalculatorGeographic;
+         mCalculator->SetName("Geographic");
+         mCalculator->SetCamera(mCamera.get());
+         mCalculator->SetFriendlyRegionType(dtHLAGM::DDMCalculatorGeographic::RegionCalculationType::GEOGRAPHIC_SPACE);
+         mCalculator->SetNeutralRegionType(dtHLAGM::DDMCalculatorGeographic::RegionCalculationType::GEOGRAPHIC_SPACE);
+         mCalculator->SetEnemyRegionType(dtHLAGM::DDMCalculatorGeographic::RegionCalculationType::GEOGRAPHIC_SPACE);
+         // The calculator rate limits itself by default, so turn it off to see what the component does alone.
+         mCalculator->SetMinTimeBetweenUpdates(0.0f);
+
+         mHLAComponent = new TestDDMHLAComponent;
+         mHLAComponent->GetDDMSubscriptionCalculators().AddCalculator(*mCalculator);
+         mHLAComponent->SetDDMEnabled(true);
+
+         MoveCamera(osg::Vec3(-500.0f, 500.0f, 100.0f));
+      }
+
+      void tearDown()
+      {
+         if (mHLAComponent.valid())
+         {
+            mHLAComponent->LeaveFederationExecution();
+         }
+         mHLAComponent = NULL;
+         mCalculator = NULL;
+         mCamera = NULL;
+         mMockAmbassador = NULL;
+         dtHLAGM::RTIAmbassador::UnregisterImplementation(MOCK_IMPLEMENTATION);
+      }
+
+      void TestDefaults()
+      {
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, mHLAComponent->GetDDMRegionUpdateThreshold(), 1e-12);
+         mHLAComponent->SetDDMRegionUpdateThreshold(0.01);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(0.01, mHLAComponent->GetDDMRegionUpdateThreshold(), 1e-12);
+
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, mHLAComponent->GetDDMMinTimeBetweenRegionUpdates(), 1e-12);
+         mHLAComponent->SetDDMMinTimeBetweenRegionUpdates(0.5);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, mHLAComponent->GetDDMMinTimeBetweenRegionUpdates(), 1e-12);
+
+         dtCore::RefPtr<dtHLAGM::DDMCameraCalculatorGeographic> calc = new dtHLAGM::DDMCameraCalculatorGeographic;
+         dtHLAGM::DDMRegionCalculator& baseCalc = *calc;
+         CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("The component should see the camera calculator's own minimum update time.",
+               0.25f, baseCalc.GetMinTimeBetweenUpdates(), 1e-6f);
+      }
+
+      void TestInPlaceModification()
+      {
+         Join();
+
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("One region should be created for each force.", 3U, mMockAmbassador->mCreateRegionCalls);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Dimension handles should be looked up once each.", 3U, mMockAmbassador->mGetDimensionHandleCalls);
+         mMockAmbassador->ResetCounts();
+
+         MoveCamera(osg::Vec3(2500.0f, -1500.0f, 100.0f));
+         mHLAComponent->TestUpdateDDMSubscriptions(1.0);
+
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Moving the camera should modify the regions, not recreate them.", 0U, mMockAmbassador->mCreateRegionCalls);
+         CPPUNIT_ASSERT_EQUAL(0U, mMockAmbassador->mDeleteRegionCalls);
+         CPPUNIT_ASSERT_EQUAL(0U, mMockAmbassador->mUnsubscribeCalls);
+         CPPUNIT_ASSERT_EQUAL(0U, mMockAmbassador->mGetDimensionHandleCalls);
+         CPPUNIT_ASSERT_EQUAL(0U, mMockAmbassador->mGetNumDimensionsCalls);
+         CPPUNIT_ASSERT_EQUAL(3U, mMockAmbassador->mSetRegionDimensionsCalls);
+         CPPUNIT_ASSERT_EQUAL(3U, mMockAmbassador->mCommitRegionChangesCalls);
+
+         mMockAmbassador->ResetCounts();
+         mHLAComponent->TestUpdateDDMSubscriptions(2.0);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Nothing should be sent if the camera didn't move.", 0U, mMockAmbassador->GetTotalDDMCalls());
+      }
+
+      void TestThreshold()
+      {
+         mHLAComponent->SetDDMRegionUpdateThreshold(0.001);
+         Join();
+
+         std::vector<std::vector<const dtHLAGM::DDMRegionData*> > regions;
+         mHLAComponent->GetDDMSubscriptionCalculatorRegions(regions);
+         CPPUNIT_ASSERT_EQUAL(1U, unsigned(regions.size()));
+         CPPUNIT_ASSERT_EQUAL(3U, unsigned(regions[0].size()));
+         const dtHLAGM::DDMRegionData& region = *regions[0][0];
+         // Moving along x changes the longitude extent.
+         const unsigned int startMin = region.GetDimensionValue(2)->mMin;
+
+         mMockAmbassador->ResetCounts();
+
+         // A small move is within the threshold.
+         MoveCamera(osg::Vec3(-490.0f, 500.0f, 100.0f));
+         mHLAComponent->TestUpdateDDMSubscriptions(1.0);
+         CPPUNIT_ASSERT_EQUAL(0U, mMockAmbassador->GetTotalDDMCalls());
+         CPPUNIT_ASSERT_MESSAGE("The region data should still track the camera.", region.GetDimensionValue(2)->mMin != startMin);
+         CPPUNIT_ASSERT(region.GetChangeSinceCommit() > 0U);
+
+         // Lots of small moves in the same direction add up until they cross the threshold.
+         unsigned steps = 0;
+         float x = -490.0f;
+         while (mMockAmbassador->mCommitRegionChangesCalls == 0 && steps < 100000)
+         {
+            x += 10.0f;
+            ++steps;
+            MoveCamera(osg::Vec3(x, 500.0f, 100.0f));
+            mHLAComponent->TestUpdateDDMSubscriptions(1.0 + double(steps));
+         }
+
+         CPPUNIT_ASSERT_MESSAGE("Small moves should eventually add up to a region update.", mMockAmbassador->mCommitRegionChangesCalls > 0U);
+         CPPUNIT_ASSERT_MESSAGE("A single small move shouldn't cross the threshold.", steps > 1U);
+         CPPUNIT_ASSERT_EQUAL(3U, mMockAmbassador->mCommitRegionChangesCalls);
+         CPPUNIT_ASSERT_EQUAL(0U, region.GetChangeSinceCommit());
+         CPPUNIT_ASSERT_EQUAL(0U, mMockAmbassador->mCreateRegionCalls);
+      }
+
+      void TestRateLimit()
+      {
+         mHLAComponent->SetDDMMinTimeBetweenRegionUpdates(0.5);
+         Join();
+         mMockAmbassador->ResetCounts();
+
+         MoveCamera(osg::Vec3(2500.0f, -1500.0f, 100.0f));
+         mHLAComponent->TestUpdateDDMSubscriptions(10.0);
+         CPPUNIT_ASSERT_EQUAL(3U, mMockAmbassador->mCommitRegionChangesCalls);
+
+         MoveCamera(osg::Vec3(-2500.0f, 1500.0f, 100.0f));
+         mHLAComponent->TestUpdateDDMSubscriptions(10.25);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("The update should wait for the minimum time.", 3U, mMockAmbassador->mCommitRegionChangesCalls);
+
+         mHLAComponent->TestUpdateDDMSubscriptions(10.5);
+         CPPUNIT_ASSERT_EQUAL(6U, mMockAmbassador->mCommitRegionChangesCalls);
+
+         // The calculator's own limit wins when it's larger.
+         mCalculator->SetMinTimeBetweenUpdates(2.0f);
+         MoveCamera(osg::Vec3(2500.0f, -1500.0f, 100.0f));
+         mHLAComponent->TestUpdateDDMSubscriptions(11.0);
+         CPPUNIT_ASSERT_EQUAL(9U, mMockAmbassador->mCommitRegionChangesCalls);
+         MoveCamera(osg::Vec3(-2500.0f, 1500.0f, 100.0f));
+         mHLAComponent->TestUpdateDDMSubscriptions(12.0);
+         CPPUNIT_ASSERT_EQUAL(9U, mMockAmbassador->mCommitRegionChangesCalls);
+         mHLAComponent->TestUpdateDDMSubscriptions(13.0);
+         CPPUNIT_ASSERT_EQUAL(12U, mMockAmbassador->mCommitRegionChangesCalls);
+      }
+
+      void TestCameraFlight()
+      {
+         const unsigned unlimited = FlyCamera(0.0, 0.0);
+         const unsigned threshold = FlyCamera(0.0001, 0.0);
+         const unsigned rateLimited = FlyCamera(0.0, 0.25);
+         const unsigned both = FlyCamera(0.0001, 0.25);
+
+         std::ostringstream ss;
+         ss << "RTI DDM calls for a " << FLIGHT_FRAMES << " frame camera flight: every change " << unlimited
+            << ", with threshold " << threshold << ", rate limited " << rateLimited << ", both " << both;
+         dtUtil::Log::GetInstance().LogMessage(dtUtil::Log::LOG_ALWAYS, __FUNCTION__, __LINE__, ss.str());
+
+         CPPUNIT_ASSERT_MESSAGE("Every frame should send a change without limits.", unlimited >= FLIGHT_FRAMES);
+         CPPUNIT_ASSERT_MESSAGE(ss.str(), threshold * 10U < unlimited);
+         CPPUNIT_ASSERT_MESSAGE(ss.str(), rateLimited * 10U < unlimited);
+         CPPUNIT_ASSERT_MESSAGE(ss.str(), both <= threshold && both <= rateLimited);
+      }
+
+   private:
+      static const unsigned FLIGHT_FRAMES = 1800U;
+
+      dtCore::RefPtr<dtHLAGM::RTIAmbassador> CreateMockAmbassador()
+      {
+         mMockAmbassador = new MockRTIAmbassador;
+         return mMockAmbassador.get();
+      }
+
+      void Join()
+      {
+         const std::string fom = "rpr-2.0.fed";
+         const std::string fedFile = dtUtil::FindFileInPathList(fom);
+         CPPUNIT_ASSERT_MESSAGE("Couldn't find \"" + fom +
+                                "\", make sure you install the Delta3D data package and set the DELTA_DATA environment var.",
+                                !fedFile.empty());
+         try
+         {
+            mHLAComponent->JoinFederationExecution("hla", fedFile, "delta3d", "", MOCK_IMPLEMENTATION);
+         }
+         catch (const dtUtil::Exception& ex)
+         {
+            CPPUNIT_FAIL(std::string("Error joining federation : ") + ex.ToString());
+         }
+         CPPUNIT_ASSERT(mMockAmbassador.valid());
+         CPPUNIT_ASSERT(mHLAComponent->GetRTIAmbassador() == mMockAmbassador.get());
+      }
+
+      void MoveCamera(const osg::Vec3& pos)
+      {
+         dtCore::Transform xform;
+         mCamera->GetTransform(xform, dtCore::Transformable::REL_CS);
+         xform.SetTranslation(pos);
+         mCamera->SetTransform(xform, dtCore::Transformable::REL_CS);
+      }
+
+      /// Flies the camera in a straight line at 60 hz and @return the number of RTI DDM calls made on the way.
+      unsigned FlyCamera(double threshold, double minTime)
+      {
+         mHLAComponent->LeaveFederationExecution();
+         mHLAComponent->SetDDMRegionUpdateThreshold(threshold);
+         mHLAComponent->SetDDMMinTimeBetweenRegionUpdates(minTime);
+         MoveCamera(osg::Vec3(-500.0f, 500.0f, 100.0f));
+         Join();
+         mMockAmbassador->ResetCounts();
+
+         // About 320 m/s, so the 30 second flight covers nearly 10 km.
+         const double frameTime = 1.0 / 60.0;
+         for (unsigned i = 1; i <= FLIGHT_FRAMES; ++i)
+         {
+            MoveCamera(osg::Vec3(-500.0f + 5.0f * float(i), 500.0f + 2.0f * float(i), 100.0f));
+            mHLAComponent->TestUpdateDDMSubscriptions(double(i) * frameTime);
+         }
+
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("No regions should be recreated during a flight.", 0U, mMockAmbassador->mCreateRegionCalls);
+         CPPUNIT_ASSERT_EQUAL(0U, mMockAmbassador->mDeleteRegionCalls);
+         CPPUNIT_ASSERT_EQUAL(0U, mMockAmbassador->mUnsubscribeCalls);
+         return mMockAmbassador->GetTotalDDMCalls();
+      }
+
+      dtCore::RefPtr<dtCore::Camera> mCamera;
+      dtCore::RefPtr<dtHLAGM::DDMCameraCalculatorGeographic> mCalculator;
+      dtCore::RefPtr<TestDDMHLAComponent> mHLAComponent;
+      dtCore::RefPtr<MockRTIAmbassador> mMockAmbassador;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DDMRegionUpdateTests);
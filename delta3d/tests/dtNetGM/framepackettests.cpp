@@ -0,0 +1,105 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <dtNetGM/framepacket.h>
+
+#include <string>
+#include <vector>
+
+namespace dtNetGM
+{
+   class FramePacketTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(FramePacketTests);
+         CPPUNIT_TEST(TestAddAndReadEntries);
+         CPPUNIT_TEST(TestFrameFull);
+         CPPUNIT_TEST(TestSequenceCompare);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+
+      void TestAddAndReadEntries()
+      {
+         FramePacket frame;
+         CPPUNIT_ASSERT(frame.IsEmpty());
+         CPPUNIT_ASSERT(!frame.IsSequenced());
+
+         std::vector<std::string> entries;
+         entries.push_back("first");
+         entries.push_back(std::string(200, 'x'));
+         entries.push_back("3");
+
+         for (size_t i = 0; i < entries.size(); ++i)
+         {
+            CPPUNIT_ASSERT(frame.AddEntry(entries[i].c_str(), unsigned(entries[i].size())));
+         }
+         CPPUNIT_ASSERT_EQUAL(unsigned(entries.size()), frame.GetNumEntries());
+         CPPUNIT_ASSERT_EQUAL(unsigned(5 + 200 + 1 + 3 * 2), frame.GetPayloadSize());
+
+         // Empty entries are not allowed since a size of 0 would be ambiguous.
+         CPPUNIT_ASSERT(!frame.AddEntry("", 0));
+
+         // The copy is what GNE actually writes.
+         FramePacket copy(frame);
+         unsigned offset = 0;
+         const char* data = NULL;
+         unsigned size = 0;
+         for (size_t i = 0; i < entries.size(); ++i)
+         {
+            CPPUNIT_ASSERT(copy.ReadEntry(offset, data, size));
+            CPPUNIT_ASSERT_EQUAL(entries[i], std::string(data, size));
+         }
+         CPPUNIT_ASSERT(!copy.ReadEntry(offset, data, size));
+
+         frame.Clear();
+         CPPUNIT_ASSERT(frame.IsEmpty());
+         CPPUNIT_ASSERT_EQUAL(0U, frame.GetNumEntries());
+      }
+
+      void TestFrameFull()
+      {
+         FramePacket frame;
+         std::string big(FramePacket::MAX_ENTRY_SIZE, 'b');
+         CPPUNIT_ASSERT(!frame.AddEntry(big.c_str(), unsigned(big.size()) + 1));
+         CPPUNIT_ASSERT(frame.AddEntry(big.c_str(), unsigned(big.size())));
+         CPPUNIT_ASSERT_EQUAL(unsigned(FramePacket::MAX_PAYLOAD), frame.GetPayloadSize());
+         CPPUNIT_ASSERT(!frame.AddEntry("a", 1));
+         CPPUNIT_ASSERT_EQUAL(1U, frame.GetNumEntries());
+      }
+
+      void TestSequenceCompare()
+      {
+         CPPUNIT_ASSERT(FramePacket::IsNewerSequence(1, 0));
+         CPPUNIT_ASSERT(!FramePacket::IsNewerSequence(0, 0));
+         CPPUNIT_ASSERT(!FramePacket::IsNewerSequence(0, 1));
+         CPPUNIT_ASSERT(FramePacket::IsNewerSequence(100, 50));
+         // wraps around
+         CPPUNIT_ASSERT(FramePacket::IsNewerSequence(2, 0xFFFE));
+         CPPUNIT_ASSERT(!FramePacket::IsNewerSequence(0xFFFE, 2));
+      }
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(FramePacketTests);
+}
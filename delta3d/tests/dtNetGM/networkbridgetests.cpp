@@ -0,0 +1,491 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+// Must be first because of a hawknl conflict with osg.  This is not a directly required include, but indirectly
+#include <osgDB/Serializer>
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "../dtGame/basegmtests.h"
+#include "testnetworkbridge.h"
+
+#include <dtNetGM/networkcomponent.h>
+#include <dtNetGM/framepacket.h>
+#include <dtGame/actorupdatemessage.h>
+#include <dtGame/messagefactory.h>
+#include <dtGame/messagetype.h>
+#include <dtCore/namedgroupparameter.inl>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/log.h>
+
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+
+namespace dtNetGM
+{
+   /// Keeps what it receives instead of handing it to the GM, and doesn't forward anything.
+   class SequencingTestComponent : public NetworkComponent
+   {
+   public:
+      typedef NetworkComponent::MessageBufferType MessageBufferType;
+      using NetworkComponent::AddConnection;
+      using NetworkComponent::RemoveConnection;
+      using NetworkComponent::SendNetworkMessages;
+
+      void AddMessageToInputBuffer(const dtGame::Message& message) override
+      {
+         mReceived.push_back(&message);
+      }
+
+      void ForwardMessage(const dtGame::Message& message, NetworkBridge& networkBridge) override
+      {
+      }
+
+      std::vector<dtCore::RefPtr<const dtGame::Message> > mReceived;
+
+   protected:
+      virtual ~SequencingTestComponent() {}
+   };
+
+   class NetworkBridgeTests : public dtGame::BaseGMTestFixture
+   {
+      typedef dtGame::BaseGMTestFixture BaseClass;
+
+      CPPUNIT_TEST_SUITE(NetworkBridgeTests);
+         CPPUNIT_TEST(TestUpdateBeforeCreate);
+         CPPUNIT_TEST(TestStaleValuesPerProperty);
+         CPPUNIT_TEST(TestReceivedStateIsPurged);
+         CPPUNIT_TEST(TestLossySequencedChannel);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+
+      void setUp() override
+      {
+         BaseClass::setUp();
+         mNetComp = new SequencingTestComponent;
+         mNetComp->SetCoalesceMessages(true);
+         mNetComp->SetSequencedActorUpdates(true);
+         mGM->AddComponent(*mNetComp, dtGame::GameManager::ComponentPriority::NORMAL);
+
+         mSender = new TestNetworkBridge(mNetComp.get(), "Sender");
+         mNetComp->AddConnection(mSender.get());
+         // Not a connection of the component, it just receives what the sender writes.
+         mReceiver = new TestNetworkBridge(mNetComp.get(), "Receiver");
+      }
+
+      void tearDown() override
+      {
+         mNetComp->RemoveConnection(mSender->GetMachineInfo());
+         mSender = NULL;
+         mReceiver = NULL;
+         mGM->RemoveComponent(*mNetComp);
+         mNetComp = NULL;
+         BaseClass::tearDown();
+      }
+
+      /// Partial updates that beat the create across are held, and only the newest values are released after it.
+      void TestUpdateBeforeCreate()
+      {
+         dtCore::UniqueId actorId;
+         std::vector<FramePacket> reliable, sequenced;
+
+         Send(*CreateUpdate(dtGame::MessageType::INFO_ACTOR_CREATED, actorId, 0, 100), reliable, sequenced);
+         Send(*CreateUpdate(dtGame::MessageType::INFO_ACTOR_UPDATED, actorId, 1, NO_VALUE), reliable, sequenced);
+         Send(*CreateUpdate(dtGame::MessageType::INFO_ACTOR_UPDATED, actorId, 2, 90), reliable, sequenced);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), reliable.size());
+         CPPUNIT_ASSERT_EQUAL(size_t(2), sequenced.size());
+         CPPUNIT_ASSERT(sequenced[0].IsSequenced());
+         CPPUNIT_ASSERT(!reliable[0].IsSequenced());
+
+         mReceiver->ReceiveFrame(sequenced[0]);
+         mReceiver->ReceiveFrame(sequenced[1]);
+         CPPUNIT_ASSERT_MESSAGE("Updates that arrive before the create must not be delivered yet.", mNetComp->mReceived.empty());
+         CPPUNIT_ASSERT_EQUAL(2ULL, mReceiver->GetNumUpdatesHeld());
+
+         // A late copy of the first update is older than what is held.
+         mReceiver->ReceiveFrame(sequenced[0]);
+         CPPUNIT_ASSERT(mNetComp->mReceived.empty());
+         CPPUNIT_ASSERT_EQUAL(1ULL, mReceiver->GetNumStaleUpdatesDropped());
+
+         mReceiver->ReceiveFrame(reliable[0]);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("The create comes first, then one update with the newest held values.",
+               size_t(2), mNetComp->mReceived.size());
+         CPPUNIT_ASSERT(mNetComp->mReceived[0]->GetMessageType() == dtGame::MessageType::INFO_ACTOR_CREATED);
+         CPPUNIT_ASSERT(mNetComp->mReceived[1]->GetMessageType() == dtGame::MessageType::INFO_ACTOR_UPDATED);
+         CPPUNIT_ASSERT_EQUAL(2, GetPosition(*mNetComp->mReceived[1]));
+         CPPUNIT_ASSERT_EQUAL(90, GetHealth(*mNetComp->mReceived[1]));
+
+         // Once the actor is known, updates go straight through.
+         Send(*CreateUpdate(dtGame::MessageType::INFO_ACTOR_UPDATED, actorId, 3, NO_VALUE), reliable, sequenced);
+         mReceiver->ReceiveFrame(sequenced.back());
+         CPPUNIT_ASSERT_EQUAL(size_t(3), mNetComp->mReceived.size());
+         CPPUNIT_ASSERT_EQUAL(3, GetPosition(*mNetComp->mReceived[2]));
+
+         // A delete throws away what is held for the actor.
+         dtCore::UniqueId deletedId;
+         Send(*CreateUpdate(dtGame::MessageType::INFO_ACTOR_UPDATED, deletedId, 1, NO_VALUE), reliable, sequenced);
+         mReceiver->ReceiveFrame(sequenced.back());
+         dtCore::RefPtr<dtGame::Message> deleteMessage;
+         mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_DELETED, deleteMessage);
+         deleteMessage->SetAboutActorId(deletedId);
+         Send(*deleteMessage, reliable, sequenced);
+         mReceiver->ReceiveFrame(reliable.back());
+         Send(*CreateUpdate(dtGame::MessageType::INFO_ACTOR_CREATED, deletedId, 0, 100), reliable, sequenced);
+         mReceiver->ReceiveFrame(reliable.back());
+         CPPUNIT_ASSERT_EQUAL(size_t(5), mNetComp->mReceived.size());
+         CPPUNIT_ASSERT(mNetComp->mReceived[3]->GetMessageType() == dtGame::MessageType::INFO_ACTOR_DELETED);
+         CPPUNIT_ASSERT(mNetComp->mReceived[4]->GetMessageType() == dtGame::MessageType::INFO_ACTOR_CREATED);
+      }
+
+      /// An out of order frame only loses what a newer frame already set, not updates to other actors or properties.
+      void TestStaleValuesPerProperty()
+      {
+         dtCore::UniqueId actorA, actorB;
+         std::vector<FramePacket> reliable, sequenced;
+
+         SequencingTestComponent::MessageBufferType buffer;
+         buffer.push_back(CreateUpdate(dtGame::MessageType::INFO_ACTOR_CREATED, actorA, 0, 100));
+         buffer.push_back(CreateUpdate(dtGame::MessageType::INFO_ACTOR_CREATED, actorB, 0, 100));
+         Send(buffer, reliable, sequenced);
+         mReceiver->ReceiveFrame(reliable.back());
+         CPPUNIT_ASSERT_EQUAL(size_t(2), mNetComp->mReceived.size());
+
+         // Each send flushes, so each update gets its own frame.
+         Send(*CreateUpdate(dtGame::MessageType::INFO_ACTOR_UPDATED, actorA, 5, 80), reliable, sequenced);
+         Send(*CreateUpdate(dtGame::MessageType::INFO_ACTOR_UPDATED, actorB, 5, NO_VALUE), reliable, sequenced);
+         Send(*CreateUpdate(dtGame::MessageType::INFO_ACTOR_UPDATED, actorA, 6, NO_VALUE), reliable, sequenced);
+         CPPUNIT_ASSERT_EQUAL(size_t(3), sequenced.size());
+
+         // The newest frame arrives first.
+         mReceiver->ReceiveFrame(sequenced[2]);
+         mReceiver->ReceiveFrame(sequenced[0]);
+         mReceiver->ReceiveFrame(sequenced[1]);
+
+         CPPUNIT_ASSERT_EQUAL(size_t(5), mNetComp->mReceived.size());
+         const dtGame::Message& newerA = *mNetComp->mReceived[2];
+         const dtGame::Message& lateA = *mNetComp->mReceived[3];
+         const dtGame::Message& lateB = *mNetComp->mReceived[4];
+         CPPUNIT_ASSERT_EQUAL(actorA, newerA.GetAboutActorId());
+         CPPUNIT_ASSERT_EQUAL(6, GetPosition(newerA));
+
+         // The late update to A keeps the health the newer frame didn't set, but not the position.
+         CPPUNIT_ASSERT_EQUAL(actorA, lateA.GetAboutActorId());
+         CPPUNIT_ASSERT_EQUAL(int(NO_VALUE), GetPosition(lateA));
+         CPPUNIT_ASSERT_EQUAL(80, GetHealth(lateA));
+
+         // Nothing newer has been received for B.
+         CPPUNIT_ASSERT_EQUAL(actorB, lateB.GetAboutActorId());
+         CPPUNIT_ASSERT_EQUAL(5, GetPosition(lateB));
+         CPPUNIT_ASSERT_EQUAL(0ULL, mReceiver->GetNumStaleUpdatesDropped());
+
+         // Nothing left in a late update means it is dropped.
+         mReceiver->ReceiveFrame(sequenced[0]);
+         CPPUNIT_ASSERT_EQUAL(size_t(5), mNetComp->mReceived.size());
+         CPPUNIT_ASSERT_EQUAL(1ULL, mReceiver->GetNumStaleUpdatesDropped());
+      }
+
+      /// Held updates and property sequences don't outlive the actor or the connection.
+      void TestReceivedStateIsPurged()
+      {
+         dtCore::UniqueId actorA, actorB;
+         std::vector<FramePacket> reliable, sequenced;
+
+         Send(*CreateUpdate(dtGame::MessageType::INFO_ACTOR_UPDATED, actorA, 1, NO_VALUE), reliable, sequenced);
+         Send(*CreateUpdate(dtGame::MessageType::INFO_ACTOR_UPDATED, actorB, 1, NO_VALUE), reliable, sequenced);
+         mReceiver->ReceiveFrame(sequenced[0]);
+         mReceiver->ReceiveFrame(sequenced[1]);
+         CPPUNIT_ASSERT_EQUAL(size_t(2), mReceiver->GetNumReceivedActors());
+
+         // The create for A never comes, and A is deleted locally instead of by a delete on this connection.
+         mNetComp->AddConnection(mReceiver.get());
+         dtCore::RefPtr<dtGame::Message> deleteMessage;
+         mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_DELETED, deleteMessage);
+         deleteMessage->SetAboutActorId(actorA);
+         mNetComp->ProcessMessage(*deleteMessage);
+         mNetComp->RemoveConnection(mReceiver->GetMachineInfo());
+         CPPUNIT_ASSERT_EQUAL(size_t(1), mReceiver->GetNumReceivedActors());
+
+         // What a disconnect does to the connection's state.
+         mReceiver->ClearReceivedActors();
+         CPPUNIT_ASSERT_EQUAL(size_t(0), mReceiver->GetNumReceivedActors());
+         CPPUNIT_ASSERT(mNetComp->mReceived.empty());
+      }
+
+      /**
+       * Sends actor updates through the sending component and bridge, loses and reorders the sequenced frames,
+       * delays the reliable ones so creates arrive late, and checks that the receiver never applies an older value
+       * over a newer one, never delivers an update before its create, and ends up with the newest values.
+       * Reports bandwidth and latency in ticks.
+       */
+      void TestLossySequencedChannel()
+      {
+         const unsigned numActors = 30;
+         const unsigned numTicks = 300;
+         const unsigned lossPercent = 10;
+         const unsigned reorderPercent = 10;
+         const unsigned reliableDelay = 3;
+
+         srand(42);
+
+         std::vector<dtCore::UniqueId> actorIds(numActors);
+         std::vector<FramePacket> frames;
+         std::vector<InFlight> inFlight;
+         unsigned numUpdatesQueued = 0;
+
+         SequencingTestComponent::MessageBufferType buffer;
+         for (unsigned a = 0; a < numActors; ++a)
+         {
+            buffer.push_back(CreateUpdate(dtGame::MessageType::INFO_ACTOR_CREATED, actorIds[a], -1, -1));
+         }
+         SendAndPutInFlight(buffer, 0, numTicks + 1, reliableDelay, lossPercent, reorderPercent, frames, inFlight);
+
+         ReceiverState state;
+         for (unsigned tick = 1; tick <= numTicks + 1; ++tick)
+         {
+            bool lastTick = tick == numTicks + 1;
+            for (unsigned a = 0; a < numActors; ++a)
+            {
+               if (a % 4 == 0 && !lastTick)
+               {
+                  // Replaced by the next one before the tick is over, so the sender drops it.
+                  buffer.push_back(CreateUpdate(dtGame::MessageType::INFO_ACTOR_UPDATED, actorIds[a], int(tick) - 1, NO_VALUE));
+                  ++numUpdatesQueued;
+               }
+               buffer.push_back(CreateUpdate(dtGame::MessageType::INFO_ACTOR_UPDATED, actorIds[a], int(tick), NO_VALUE));
+               ++numUpdatesQueued;
+               if (tick % 5 == 0 || lastTick)
+               {
+                  buffer.push_back(CreateUpdate(dtGame::MessageType::INFO_ACTOR_UPDATED, actorIds[a], NO_VALUE, int(tick)));
+                  ++numUpdatesQueued;
+               }
+            }
+            SendAndPutInFlight(buffer, tick, numTicks + 1, reliableDelay, lossPercent, reorderPercent, frames, inFlight);
+            Deliver(tick, frames, inFlight, state);
+         }
+
+         // Let everything still in flight arrive.
+         for (unsigned tick = numTicks + 2; !inFlight.empty(); ++tick)
+         {
+            Deliver(tick, frames, inFlight, state);
+         }
+
+         for (unsigned a = 0; a < numActors; ++a)
+         {
+            CPPUNIT_ASSERT(state.mCreated.count(actorIds[a]) == 1);
+            CPPUNIT_ASSERT_EQUAL(int(numTicks + 1), state.mPosition[actorIds[a]]);
+            CPPUNIT_ASSERT_EQUAL(int(numTicks + 1), state.mHealth[actorIds[a]]);
+         }
+
+         CPPUNIT_ASSERT(mNetComp->GetNumStaleUpdatesDropped() > 0);
+         CPPUNIT_ASSERT(mReceiver->GetNumStaleUpdatesDropped() > 0);
+         CPPUNIT_ASSERT_MESSAGE("The creates were delayed, so some updates should have been held.", mReceiver->GetNumUpdatesHeld() > 0);
+         CPPUNIT_ASSERT_MESSAGE("Out of order frames should still deliver the values nothing newer has set.", state.mNumLateDelivered > 0);
+         // Coalescing should put more than one message in a frame on average.
+         CPPUNIT_ASSERT(mSender->GetNumFramesSent() < mSender->GetNumDataStreamsSent());
+
+         double avgLatency = double(state.mTotalLatency) / double(state.mNumPositionsApplied);
+         CPPUNIT_ASSERT(avgLatency < 2.0);
+
+         std::ostringstream ss;
+         ss << "Sequenced channel with " << lossPercent << "% loss and " << reorderPercent << "% reordering: "
+            << numUpdatesQueued << " updates queued, " << mSender->GetNumDataStreamsSent() << " sent in "
+            << mSender->GetNumFramesSent() << " frames, " << mSender->GetNumBytesSent() << " bytes.  Received "
+            << mNetComp->mReceived.size() << ", " << state.mNumLateDelivered << " from late frames, stale "
+            << mReceiver->GetNumStaleUpdatesDropped() << ", held " << mReceiver->GetNumUpdatesHeld()
+            << ", average position latency " << avgLatency << " ticks.";
+         LOG_ALWAYS(ss.str());
+      }
+
+   private:
+      static const int NO_VALUE = -1000;
+
+      struct InFlight
+      {
+         size_t mFrameIndex;
+         unsigned mSentTick;
+         unsigned mArriveTick;
+      };
+
+      struct ReceiverState
+      {
+         ReceiverState() : mNumChecked(0), mNewestSequence(0), mReceivedSequenced(false)
+            , mNumLateDelivered(0), mNumPositionsApplied(0), mTotalLatency(0) {}
+
+         size_t mNumChecked;
+         unsigned mNewestSequence;
+         bool mReceivedSequenced;
+         std::set<dtCore::UniqueId> mCreated;
+         std::map<dtCore::UniqueId, int> mPosition;
+         std::map<dtCore::UniqueId, int> mHealth;
+         unsigned mNumLateDelivered;
+         unsigned mNumPositionsApplied;
+         unsigned long long mTotalLatency;
+      };
+
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> CreateUpdate(const dtGame::MessageType& type, const dtCore::UniqueId& actorId, int position, int health)
+      {
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> update;
+         mGM->GetMessageFactory().CreateMessage(type, update);
+         update->SetAboutActorId(actorId);
+         update->SetPartialUpdate(type == dtGame::MessageType::INFO_ACTOR_UPDATED);
+         if (position != NO_VALUE)
+         {
+            update->AddValue(dtUtil::RefString("Position"), position);
+         }
+         if (health != NO_VALUE)
+         {
+            update->AddValue(dtUtil::RefString("Health"), health);
+         }
+         return update;
+      }
+
+      static int GetPosition(const dtGame::Message& message)
+      {
+         return static_cast<const dtGame::ActorUpdateMessage&>(message).GetValue(dtUtil::RefString("Position"), int(NO_VALUE));
+      }
+
+      static int GetHealth(const dtGame::Message& message)
+      {
+         return static_cast<const dtGame::ActorUpdateMessage&>(message).GetValue(dtUtil::RefString("Health"), int(NO_VALUE));
+      }
+
+      void Send(const dtGame::Message& message, std::vector<FramePacket>& reliable, std::vector<FramePacket>& sequenced)
+      {
+         SequencingTestComponent::MessageBufferType buffer;
+         buffer.push_back(&message);
+         Send(buffer, reliable, sequenced);
+      }
+
+      /// Sends and clears the buffer through the real sending path, and sorts the frames written by channel.
+      void Send(SequencingTestComponent::MessageBufferType& buffer, std::vector<FramePacket>& reliable, std::vector<FramePacket>& sequenced)
+      {
+         mNetComp->SendNetworkMessages(buffer);
+         buffer.clear();
+
+         std::vector<FramePacket> frames;
+         mSender->TakeFrames(frames);
+         for (size_t i = 0; i < frames.size(); ++i)
+         {
+            (frames[i].IsSequenced() ? sequenced : reliable).push_back(frames[i]);
+         }
+      }
+
+      void SendAndPutInFlight(SequencingTestComponent::MessageBufferType& buffer, unsigned tick, unsigned lastTick,
+            unsigned reliableDelay, unsigned lossPercent, unsigned reorderPercent,
+            std::vector<FramePacket>& frames, std::vector<InFlight>& inFlight)
+      {
+         mNetComp->SendNetworkMessages(buffer);
+         buffer.clear();
+
+         size_t first = frames.size();
+         mSender->TakeFrames(frames);
+         for (size_t i = first; i < frames.size(); ++i)
+         {
+            InFlight f = { i, tick, tick + reliableDelay };
+            if (frames[i].IsSequenced())
+            {
+               // The last tick isn't lost so the final values are known.
+               if (tick != lastTick && (unsigned(rand()) % 100) < lossPercent)
+               {
+                  continue;
+               }
+               f.mArriveTick = tick + 1 + ((unsigned(rand()) % 100) < reorderPercent ? 2 : 0);
+            }
+            inFlight.push_back(f);
+         }
+      }
+
+      /// Delivers the frames that arrive this tick, in the order they arrive, and checks what comes out.
+      void Deliver(unsigned tick, const std::vector<FramePacket>& frames, std::vector<InFlight>& inFlight, ReceiverState& state)
+      {
+         for (size_t i = 0; i < inFlight.size();)
+         {
+            if (inFlight[i].mArriveTick > tick)
+            {
+               ++i;
+               continue;
+            }
+
+            const FramePacket& frame = frames[inFlight[i].mFrameIndex];
+            bool late = false;
+            if (frame.IsSequenced())
+            {
+               late = state.mReceivedSequenced && !FramePacket::IsNewerSequence(frame.GetSequence(), state.mNewestSequence);
+               if (!late)
+               {
+                  state.mNewestSequence = frame.GetSequence();
+                  state.mReceivedSequenced = true;
+               }
+            }
+
+            mReceiver->ReceiveFrame(frame);
+
+            for (; state.mNumChecked < mNetComp->mReceived.size(); ++state.mNumChecked)
+            {
+               const dtGame::Message& message = *mNetComp->mReceived[state.mNumChecked];
+               const dtCore::UniqueId& id = message.GetAboutActorId();
+               if (message.GetMessageType() == dtGame::MessageType::INFO_ACTOR_CREATED)
+               {
+                  state.mCreated.insert(id);
+                  state.mPosition[id] = -1;
+                  state.mHealth[id] = -1;
+                  continue;
+               }
+
+               CPPUNIT_ASSERT_MESSAGE("An update was delivered before the create.", state.mCreated.count(id) == 1);
+               if (late)
+               {
+                  ++state.mNumLateDelivered;
+               }
+
+               int position = GetPosition(message);
+               if (position != NO_VALUE)
+               {
+                  CPPUNIT_ASSERT_MESSAGE("An older position was applied over a newer one.", position > state.mPosition[id]);
+                  state.mPosition[id] = position;
+                  ++state.mNumPositionsApplied;
+                  state.mTotalLatency += tick - unsigned(position);
+               }
+
+               int health = GetHealth(message);
+               if (health != NO_VALUE)
+               {
+                  CPPUNIT_ASSERT_MESSAGE("An older health was applied over a newer one.", health > state.mHealth[id]);
+                  state.mHealth[id] = health;
+               }
+            }
+
+            inFlight.erase(inFlight.begin() + i);
+         }
+      }
+
+      dtCore::RefPtr<SequencingTestComponent> mNetComp;
+      dtCore::RefPtr<TestNetworkBridge> mSender;
+      dtCore::RefPtr<TestNetworkBridge> mReceiver;
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(NetworkBridgeTests);
+}
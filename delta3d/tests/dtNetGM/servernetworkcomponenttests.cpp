@@ -0,0 +1,382 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+// Must be first because of a hawknl conflict with osg.  This is not a directly required include, but indirectly
+#include <osgDB/Serializer>
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "../dtGame/basegmtests.h"
+#include "testnetworkbridge.h"
+
+#include <dtNetGM/servernetworkcomponent.h>
+#include <dtGame/actorupdatemessage.h>
+#include <dtGame/gameactorproxy.h>
+#include <dtGame/messagefactory.h>
+#include <dtGame/messagetype.h>
+#include <dtActors/engineactorregistry.h>
+#include <dtCore/transform.h>
+#include <dtCore/transformable.h>
+#include <dtCore/transformableactorproxy.h>
+#include <dtUtil/log.h>
+#include <OpenThreads/Thread>
+
+#include <sstream>
+#include <vector>
+
+namespace dtNetGM
+{
+   /// Makes the interest management calls public so the tests can drive them without a GNE connection.
+   class InterestTestComponent : public ServerNetworkComponent
+   {
+   public:
+      typedef ServerNetworkComponent::MessageBufferType MessageBufferType;
+      using ServerNetworkComponent::AddConnection;
+      using ServerNetworkComponent::RemoveConnection;
+      using ServerNetworkComponent::SendNetworkMessages;
+      using ServerNetworkComponent::ShouldSendToConnection;
+      using ServerNetworkComponent::UpdatePublishedActorPosition;
+      using ServerNetworkComponent::CreateFilteredPropertyUpdates;
+
+   protected:
+      virtual ~InterestTestComponent() {}
+   };
+
+   class ServerNetworkComponentTests : public dtGame::BaseGMTestFixture
+   {
+      typedef dtGame::BaseGMTestFixture BaseClass;
+
+      CPPUNIT_TEST_SUITE(ServerNetworkComponentTests);
+         CPPUNIT_TEST(TestShouldSendToConnection);
+         CPPUNIT_TEST(TestFilteredValuesAreCaughtUp);
+         CPPUNIT_TEST(TestViewRegion);
+         CPPUNIT_TEST(TestDisconnectRemovesRegion);
+         CPPUNIT_TEST(TestInterestBandwidth);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+
+      void setUp() override
+      {
+         BaseClass::setUp();
+         mServer = new InterestTestComponent;
+         mGM->AddComponent(*mServer, dtGame::GameManager::ComponentPriority::NORMAL);
+      }
+
+      void tearDown() override
+      {
+         for (size_t i = 0; i < mClients.size(); ++i)
+         {
+            mServer->RemoveConnection(mClients[i]->GetMachineInfo());
+         }
+         mClients.clear();
+         mGM->RemoveComponent(*mServer);
+         mServer = NULL;
+         BaseClass::tearDown();
+      }
+
+      /// Only partial updates about actors outside of a client's region are held back.
+      void TestShouldSendToConnection()
+      {
+         TestNetworkBridge& client = AddClient("Client");
+         TestNetworkBridge& other = AddClient("Other");
+         dtGame::GameActorProxy& nearActor = AddActor(osg::Vec3(10.0f, 0.0f, 0.0f));
+         dtGame::GameActorProxy& farActor = AddActor(osg::Vec3(1000.0f, 0.0f, 0.0f));
+
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> nearUpdate = CreatePartialUpdate(nearActor, dtCore::TransformableActorProxy::PROPERTY_TRANSLATION);
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> farUpdate = CreatePartialUpdate(farActor, dtCore::TransformableActorProxy::PROPERTY_TRANSLATION);
+
+         CPPUNIT_ASSERT_MESSAGE("A client without a region gets everything.", mServer->ShouldSendToConnection(*farUpdate, client));
+
+         mServer->SetClientInterestRegion(client.GetMachineInfo(), osg::Vec3(), 100.0f);
+         CPPUNIT_ASSERT(mServer->ShouldSendToConnection(*nearUpdate, client));
+         CPPUNIT_ASSERT(mServer->ShouldSendToConnection(*nearUpdate, client));
+         CPPUNIT_ASSERT_MESSAGE("The first update outside of the region is sent.", mServer->ShouldSendToConnection(*farUpdate, client));
+         CPPUNIT_ASSERT_MESSAGE("Then they are held to the reduced rate.", !mServer->ShouldSendToConnection(*farUpdate, client));
+         CPPUNIT_ASSERT(mServer->ShouldSendToConnection(*farUpdate, other));
+         CPPUNIT_ASSERT_EQUAL(1ULL, mServer->GetNumUpdatesFiltered());
+
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> fullUpdate;
+         mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, fullUpdate);
+         farActor.PopulateActorUpdate(*fullUpdate);
+         CPPUNIT_ASSERT_MESSAGE("Full updates are never filtered.", mServer->ShouldSendToConnection(*fullUpdate, client));
+
+         mServer->SetOutOfInterestUpdateInterval(0.0f);
+         dtGame::GameActorProxy& otherFarActor = AddActor(osg::Vec3(0.0f, 1000.0f, 0.0f));
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> otherFarUpdate = CreatePartialUpdate(otherFarActor, dtCore::TransformableActorProxy::PROPERTY_TRANSLATION);
+         CPPUNIT_ASSERT_MESSAGE("With no interval, updates outside of the region are only sent when the actor comes back.",
+               !mServer->ShouldSendToConnection(*otherFarUpdate, client));
+         CPPUNIT_ASSERT_EQUAL(2ULL, mServer->GetNumUpdatesFiltered());
+
+         mServer->SetClientInterestRegion(client.GetMachineInfo(), osg::Vec3(), 0.0f);
+         CPPUNIT_ASSERT(mServer->ShouldSendToConnection(*farUpdate, client));
+         CPPUNIT_ASSERT(mServer->ShouldSendToConnection(*otherFarUpdate, client));
+         CPPUNIT_ASSERT_EQUAL(2ULL, mServer->GetNumUpdatesFiltered());
+      }
+
+      /// A view direction limits the region to a cone, so actors behind the client are throttled too.
+      void TestViewRegion()
+      {
+         TestNetworkBridge& client = AddClient("Client");
+         dtGame::GameActorProxy& aheadActor = AddActor(osg::Vec3(0.0f, 50.0f, 0.0f));
+         dtGame::GameActorProxy& sideActor = AddActor(osg::Vec3(50.0f, 10.0f, 0.0f));
+         dtGame::GameActorProxy& behindActor = AddActor(osg::Vec3(0.0f, -50.0f, 0.0f));
+
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> aheadUpdate = CreatePartialUpdate(aheadActor, dtCore::TransformableActorProxy::PROPERTY_TRANSLATION);
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> sideUpdate = CreatePartialUpdate(sideActor, dtCore::TransformableActorProxy::PROPERTY_TRANSLATION);
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> behindUpdate = CreatePartialUpdate(behindActor, dtCore::TransformableActorProxy::PROPERTY_TRANSLATION);
+
+         mServer->SetOutOfInterestUpdateInterval(0.0f);
+         mServer->SetClientInterestRegion(client.GetMachineInfo(), osg::Vec3(), 100.0f, osg::Vec3(0.0f, 2.0f, 0.0f), 45.0f);
+         CPPUNIT_ASSERT(mServer->ShouldSendToConnection(*aheadUpdate, client));
+         CPPUNIT_ASSERT_MESSAGE("Outside of the cone, even though it's within the radius.", !mServer->ShouldSendToConnection(*sideUpdate, client));
+         CPPUNIT_ASSERT(!mServer->ShouldSendToConnection(*behindUpdate, client));
+
+         // Turning around brings them in, and the values they missed are caught up.
+         mServer->SetClientInterestRegion(client.GetMachineInfo(), osg::Vec3(), 100.0f, osg::Vec3(0.0f, -1.0f, 0.0f), 45.0f);
+         CPPUNIT_ASSERT(mServer->ShouldSendToConnection(*behindUpdate, client));
+         CPPUNIT_ASSERT(!mServer->ShouldSendToConnection(*aheadUpdate, client));
+
+         InterestTestComponent::MessageBufferType updates;
+         mServer->CreateFilteredPropertyUpdates(updates);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), updates.size());
+         CPPUNIT_ASSERT_EQUAL(behindActor.GetId(), updates[0]->GetAboutActorId());
+
+         // Without a direction it's the whole sphere again.
+         mServer->SetClientInterestRegion(client.GetMachineInfo(), osg::Vec3(), 100.0f);
+         CPPUNIT_ASSERT(mServer->ShouldSendToConnection(*sideUpdate, client));
+      }
+
+      /// A client that disconnects leaves nothing behind.
+      void TestDisconnectRemovesRegion()
+      {
+         TestNetworkBridge& client = AddClient("Client");
+         dtGame::GameActorProxy& farActor = AddActor(osg::Vec3(1000.0f, 0.0f, 0.0f));
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> farUpdate = CreatePartialUpdate(farActor, dtCore::TransformableActorProxy::PROPERTY_TRANSLATION);
+
+         mServer->SetOutOfInterestUpdateInterval(0.0f);
+         mServer->SetClientInterestRegion(client.GetMachineInfo(), osg::Vec3(), 100.0f);
+         CPPUNIT_ASSERT(!mServer->ShouldSendToConnection(*farUpdate, client));
+         CPPUNIT_ASSERT_EQUAL(1U, mServer->GetNumClientInterestRegions());
+
+         mServer->OnDisconnect(client);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("The region and its filtered values are dropped, not kept to be caught up.",
+               0U, mServer->GetNumClientInterestRegions());
+         InterestTestComponent::MessageBufferType updates;
+         mServer->CreateFilteredPropertyUpdates(updates);
+         CPPUNIT_ASSERT(updates.empty());
+      }
+
+      /// Values a client missed are sent to it when the actor comes back, at the reduced rate, and when the region goes away.
+      void TestFilteredValuesAreCaughtUp()
+      {
+         TestNetworkBridge& client = AddClient("Client");
+         TestNetworkBridge& other = AddClient("Other");
+         dtGame::GameActorProxy& farActor = AddActor(osg::Vec3(1000.0f, 0.0f, 0.0f));
+
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> translation = CreatePartialUpdate(farActor, dtCore::TransformableActorProxy::PROPERTY_TRANSLATION);
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> rotation = CreatePartialUpdate(farActor, dtCore::TransformableActorProxy::PROPERTY_ROTATION);
+
+         // Long enough that it never passes while the actor comes back.
+         mServer->SetOutOfInterestUpdateInterval(10.0f);
+         mServer->SetClientInterestRegion(client.GetMachineInfo(), osg::Vec3(), 100.0f);
+         CPPUNIT_ASSERT(mServer->ShouldSendToConnection(*translation, client));
+         CPPUNIT_ASSERT(!mServer->ShouldSendToConnection(*rotation, client));
+         CPPUNIT_ASSERT(!mServer->ShouldSendToConnection(*translation, client));
+
+         InterestTestComponent::MessageBufferType updates;
+         mServer->CreateFilteredPropertyUpdates(updates);
+         CPPUNIT_ASSERT(updates.empty());
+
+         MoveActor(farActor, osg::Vec3(50.0f, 0.0f, 0.0f));
+         mServer->CreateFilteredPropertyUpdates(updates);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Coming back into the region sends what was filtered out.", size_t(1), updates.size());
+         const dtGame::ActorUpdateMessage& caughtUp = static_cast<const dtGame::ActorUpdateMessage&>(*updates[0]);
+         CPPUNIT_ASSERT(caughtUp.GetMessageType() == dtGame::MessageType::INFO_ACTOR_UPDATED);
+         CPPUNIT_ASSERT(caughtUp.IsPartialUpdate());
+         CPPUNIT_ASSERT_EQUAL(farActor.GetId(), caughtUp.GetAboutActorId());
+         CPPUNIT_ASSERT(caughtUp.GetDestination() != NULL);
+         CPPUNIT_ASSERT(*caughtUp.GetDestination() == client.GetMachineInfo());
+         CPPUNIT_ASSERT(caughtUp.GetUpdateParameter(dtCore::TransformableActorProxy::PROPERTY_TRANSLATION) != NULL);
+         CPPUNIT_ASSERT(caughtUp.GetUpdateParameter(dtCore::TransformableActorProxy::PROPERTY_ROTATION) != NULL);
+
+         mServer->SendNetworkMessages(updates);
+         CPPUNIT_ASSERT(client.GetNumPacketsWritten() > 0);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Only the client that missed the values gets them.", 0U, other.GetNumPacketsWritten());
+
+         updates.clear();
+         mServer->CreateFilteredPropertyUpdates(updates);
+         CPPUNIT_ASSERT(updates.empty());
+
+         // Outside again, the missed values are sent when the interval passes.
+         MoveActor(farActor, osg::Vec3(1000.0f, 0.0f, 0.0f));
+         mServer->SetOutOfInterestUpdateInterval(0.2f);
+         OpenThreads::Thread::microSleep(250000);
+         CPPUNIT_ASSERT(mServer->ShouldSendToConnection(*rotation, client));
+         CPPUNIT_ASSERT(!mServer->ShouldSendToConnection(*translation, client));
+         mServer->CreateFilteredPropertyUpdates(updates);
+         CPPUNIT_ASSERT(updates.empty());
+
+         OpenThreads::Thread::microSleep(250000);
+         mServer->CreateFilteredPropertyUpdates(updates);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), updates.size());
+         const dtGame::ActorUpdateMessage& flushed = static_cast<const dtGame::ActorUpdateMessage&>(*updates[0]);
+         CPPUNIT_ASSERT(flushed.GetUpdateParameter(dtCore::TransformableActorProxy::PROPERTY_TRANSLATION) != NULL);
+         CPPUNIT_ASSERT_MESSAGE("Rotation was sent when the interval passed, so it isn't sent again.",
+               flushed.GetUpdateParameter(dtCore::TransformableActorProxy::PROPERTY_ROTATION) == NULL);
+
+         // Removing the region sends what it filtered out.
+         updates.clear();
+         CPPUNIT_ASSERT(!mServer->ShouldSendToConnection(*rotation, client));
+         mServer->SetClientInterestRegion(client.GetMachineInfo(), osg::Vec3(), 0.0f);
+         CPPUNIT_ASSERT(mServer->ShouldSendToConnection(*translation, client));
+         mServer->CreateFilteredPropertyUpdates(updates);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), updates.size());
+         CPPUNIT_ASSERT(static_cast<const dtGame::ActorUpdateMessage&>(*updates[0]).GetUpdateParameter(dtCore::TransformableActorProxy::PROPERTY_ROTATION) != NULL);
+         updates.clear();
+         mServer->CreateFilteredPropertyUpdates(updates);
+         CPPUNIT_ASSERT(updates.empty());
+
+         // Nothing is sent about a deleted actor.
+         mServer->SetClientInterestRegion(client.GetMachineInfo(), osg::Vec3(), 100.0f);
+         CPPUNIT_ASSERT(mServer->ShouldSendToConnection(*translation, client));
+         CPPUNIT_ASSERT(!mServer->ShouldSendToConnection(*translation, client));
+         dtCore::RefPtr<dtGame::Message> deleteMessage;
+         mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_DELETED, deleteMessage);
+         deleteMessage->SetAboutActorId(farActor.GetId());
+         mServer->UpdatePublishedActorPosition(*deleteMessage);
+         mServer->CreateFilteredPropertyUpdates(updates);
+         CPPUNIT_ASSERT(updates.empty());
+      }
+
+      /// Bytes sent to 32 clients about 5000 moving actors, with and without interest regions.
+      void TestInterestBandwidth()
+      {
+         const unsigned numClients = 32;
+         const unsigned numActorsX = 100;
+         const unsigned numActorsY = 50;
+         const unsigned numTicks = 20;
+         const float spacing = 10.0f;
+         const float radius = 50.0f;
+
+         InterestTestComponent::MessageBufferType actorUpdates;
+         for (unsigned y = 0; y < numActorsY; ++y)
+         {
+            for (unsigned x = 0; x < numActorsX; ++x)
+            {
+               dtGame::GameActorProxy& actor = AddActor(osg::Vec3(x * spacing, y * spacing, 0.0f));
+               actorUpdates.push_back(CreatePartialUpdate(actor, dtCore::TransformableActorProxy::PROPERTY_TRANSLATION).get());
+            }
+         }
+
+         for (unsigned i = 0; i < numClients; ++i)
+         {
+            std::ostringstream name;
+            name << "Client" << i;
+            AddClient(name.str()).SetKeepFrames(false);
+         }
+
+         unsigned long long bytesWithoutInterest = SendTicks(actorUpdates, numTicks);
+
+         // The clients are spread over the area covered by the actors.
+         for (unsigned i = 0; i < numClients; ++i)
+         {
+            osg::Vec3 center((i % 8) * 125.0f + 62.5f, (i / 8) * 125.0f + 62.5f, 0.0f);
+            mServer->SetClientInterestRegion(mClients[i]->GetMachineInfo(), center, radius);
+         }
+
+         unsigned long long bytesWithInterest = SendTicks(actorUpdates, numTicks);
+
+         std::ostringstream ss;
+         ss << numClients << " clients, " << actorUpdates.size() << " actors, " << numTicks << " ticks.  Without interest regions "
+            << bytesWithoutInterest << " bytes, with " << bytesWithInterest << " bytes ("
+            << (100.0 * double(bytesWithInterest) / double(bytesWithoutInterest)) << "%), "
+            << mServer->GetNumUpdatesFiltered() << " updates filtered.";
+         LOG_ALWAYS(ss.str());
+
+         CPPUNIT_ASSERT(mServer->GetNumUpdatesFiltered() > 0);
+         CPPUNIT_ASSERT_MESSAGE(ss.str(), bytesWithInterest * 3 < bytesWithoutInterest);
+      }
+
+   private:
+      TestNetworkBridge& AddClient(const std::string& name)
+      {
+         dtCore::RefPtr<TestNetworkBridge> client = new TestNetworkBridge(mServer.get(), name);
+         mServer->AddConnection(client.get());
+         mClients.push_back(client);
+         return *client;
+      }
+
+      dtGame::GameActorProxy& AddActor(const osg::Vec3& position)
+      {
+         dtCore::RefPtr<dtGame::GameActorProxy> actor;
+         mGM->CreateActor(*dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE, actor);
+         mGM->AddActor(*actor, false, false);
+         MoveActor(*actor, position);
+         return *actor;
+      }
+
+      void MoveActor(dtGame::GameActorProxy& actor, const osg::Vec3& position)
+      {
+         dtCore::Transformable* xformable = actor.GetDrawable<dtCore::Transformable>();
+         dtCore::Transform xform;
+         xformable->GetTransform(xform);
+         xform.SetTranslation(position);
+         xformable->SetTransform(xform);
+
+         dtCore::RefPtr<dtGame::Message> update;
+         mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, update);
+         update->SetAboutActorId(actor.GetId());
+         mServer->UpdatePublishedActorPosition(*update);
+      }
+
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> CreatePartialUpdate(dtGame::GameActorProxy& actor, const dtUtil::RefString& propName)
+      {
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> update;
+         mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, update);
+         std::vector<dtUtil::RefString> propNames;
+         propNames.push_back(propName);
+         actor.PopulateActorUpdate(*update, propNames);
+         update->SetPartialUpdate(true);
+         return update;
+      }
+
+      /// Sends the updates once per tick at 30 Hz, along with the catch up updates, and returns the bytes sent.
+      unsigned long long SendTicks(const InterestTestComponent::MessageBufferType& actorUpdates, unsigned numTicks)
+      {
+         unsigned long long start = mServer->GetNumBytesSentToClients();
+         for (unsigned tick = 0; tick < numTicks; ++tick)
+         {
+            InterestTestComponent::MessageBufferType buffer(actorUpdates);
+            mServer->CreateFilteredPropertyUpdates(buffer);
+            mServer->SendNetworkMessages(buffer);
+            OpenThreads::Thread::microSleep(33000);
+         }
+         return mServer->GetNumBytesSentToClients() - start;
+      }
+
+      dtCore::RefPtr<InterestTestComponent> mServer;
+      std::vector<dtCore::RefPtr<TestNetworkBridge> > mClients;
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(ServerNetworkComponentTests);
+}
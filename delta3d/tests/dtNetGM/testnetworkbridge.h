@@ -0,0 +1,100 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#ifndef TESTS_DTNETGM_TESTNETWORKBRIDGE_H_
+#define TESTS_DTNETGM_TESTNETWORKBRIDGE_H_
+
+#include <dtNetGM/networkbridge.h>
+#include <dtNetGM/framepacket.h>
+#include <dtGame/machineinfo.h>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+
+#include <string>
+#include <vector>
+
+namespace dtNetGM
+{
+   /**
+    * A NetworkBridge with no GNE connection that keeps the frames it would have written so a test
+    * can deliver them to another bridge with ReceiveFrame, in any order.
+    */
+   class TestNetworkBridge : public NetworkBridge
+   {
+   public:
+      TestNetworkBridge(NetworkComponent* networkComp, const std::string& name)
+         : NetworkBridge(networkComp)
+         , mNumPacketsWritten(0)
+         , mKeepFrames(true)
+      {
+         dtCore::RefPtr<dtGame::MachineInfo> machineInfo = new dtGame::MachineInfo(name);
+         SetMachineInfo(*machineInfo);
+         SetClientConnected(true);
+      }
+
+      /// Moves the frames written since the last call to the end of frames.
+      void TakeFrames(std::vector<FramePacket>& frames)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mWrittenMutex);
+         for (size_t i = 0; i < mFrames.size(); ++i)
+         {
+            frames.push_back(mFrames[i]);
+         }
+         mFrames.clear();
+      }
+
+      /// Turn off for tests that only count what is written, so the frames don't pile up.
+      void SetKeepFrames(bool keepFrames)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mWrittenMutex);
+         mKeepFrames = keepFrames;
+      }
+
+      unsigned GetNumPacketsWritten() const
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mWrittenMutex);
+         return mNumPacketsWritten;
+      }
+
+   protected:
+      virtual ~TestNetworkBridge() {}
+
+      bool WritePacket(const GNE::Packet& packet, bool reliable) override
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mWrittenMutex);
+         ++mNumPacketsWritten;
+         if (mKeepFrames && packet.getType() == FramePacket::ID)
+         {
+            mFrames.push_back(static_cast<const FramePacket&>(packet));
+         }
+         return true;
+      }
+
+   private:
+      mutable OpenThreads::Mutex mWrittenMutex;
+      std::vector<FramePacket> mFrames;
+      unsigned mNumPacketsWritten;
+      bool mKeepFrames;
+   };
+}
+
+#endif /* TESTS_DTNETGM_TESTNETWORKBRIDGE_H_ */
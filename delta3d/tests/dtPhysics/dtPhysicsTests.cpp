@@ -66,12 +66,14 @@
 #include <osg/Shape>
 #include <osg/ShapeDrawable>
 #include <osg/ComputeBoundsVisitor>
+#include <osg/ProxyNode>
 
 #include <pal/pal.h>
 #include <pal/palFactory.h>
 #include <pal/palActivation.h>
 
 #include <osgDB/ReadFile>
+#include <osgDB/WriteFile>
 namespace dtPhysics
 {
    class dtPhysicsTests : public BaseDTPhysicsTestFixture
@@ -104,6 +106,7 @@ namespace dtPhysics
       CPPUNIT_TEST(testComponentPerEngine);
       CPPUNIT_TEST(testCallbacksPerEngine);
       CPPUNIT_TEST(testPhysicsReaderWriter);
+      CPPUNIT_TEST(testCookedMeshCache);
       CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -116,6 +119,13 @@ namespace dtPhysics
          names.push_back(DTPHYSICS_REGISTRY);
       }
 
+      void tearDown() override
+      {
+         // A failed assert in testCookedMeshCache must not leave the cache on for the other tests.
+         dtPhysics::CookedMeshCache::SetDirectory("");
+         BaseDTPhysicsTestFixture::tearDown();
+      }
+
       void testPrimitiveType();
 
       void testGeometryMarginPerEngine();
@@ -143,6 +153,7 @@ namespace dtPhysics
       void testComponentPerEngine();
       void testCallbacksPerEngine();
       void testPhysicsReaderWriter();
+      void testCookedMeshCache();
 
       // used so we have a place to test actors
       // not called multiple times like the others.
@@ -2117,4 +2128,161 @@ namespace dtPhysics
       CPPUNIT_ASSERT(data->GetMaterialIndex(MAT_NAME_C) == 5);
       CPPUNIT_ASSERT(data->GetMaterialCount() == 3);
    }
+
+   /////////////////////////////////////////////////////////
+   static osg::Geode* CreateCookingTestBox(float size)
+   {
+      dtCore::RefPtr<osg::Vec3Array> verts = new osg::Vec3Array;
+      for (unsigned i = 0; i < 8; ++i)
+      {
+         verts->push_back(osg::Vec3(i & 1 ? size : 0.0f, i & 2 ? size : 0.0f, i & 4 ? size : 0.0f));
+      }
+
+      static const unsigned faces[] = {
+         0, 2, 1,  1, 2, 3,  4, 5, 6,  5, 7, 6,
+         0, 1, 4,  1, 5, 4,  2, 6, 3,  3, 6, 7,
+         0, 4, 2,  2, 4, 6,  1, 3, 5,  3, 7, 5 };
+      dtCore::RefPtr<osg::DrawElementsUInt> tris = new osg::DrawElementsUInt(GL_TRIANGLES, 36, faces);
+
+      osg::Geometry* geometry = new osg::Geometry;
+      geometry->setVertexArray(verts.get());
+      geometry->addPrimitiveSet(tris.get());
+
+      osg::Geode* geode = new osg::Geode;
+      geode->addDrawable(geometry);
+      return geode;
+   }
+
+   /////////////////////////////////////////////////////////
+   void dtPhysicsTests::testCookedMeshCache()
+   {
+      dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+      const std::string cacheDir("temp_dtPhysicsCookedMeshCache");
+      if (fileUtils.DirExists(cacheDir))
+      {
+         fileUtils.DirDelete(cacheDir, true);
+      }
+
+      CPPUNIT_ASSERT(!dtPhysics::CookedMeshCache::IsEnabled());
+      dtPhysics::CookedMeshCache::SetDirectory(cacheDir);
+      CPPUNIT_ASSERT(dtPhysics::CookedMeshCache::IsEnabled());
+      CPPUNIT_ASSERT_EQUAL(cacheDir, dtPhysics::CookedMeshCache::GetDirectory());
+
+      try
+      {
+         dtCore::RefPtr<osg::Geode> box = CreateCookingTestBox(2.0f);
+         const std::string key = dtPhysics::CookedMeshCache::ComputeKey(*box, false, 20.0f);
+         CPPUNIT_ASSERT_EQUAL(key, dtPhysics::CookedMeshCache::ComputeKey(*box, false, 20.0f));
+         CPPUNIT_ASSERT_MESSAGE("The cooking parameters should be part of the key",
+                  key != dtPhysics::CookedMeshCache::ComputeKey(*box, true, 20.0f));
+         CPPUNIT_ASSERT_MESSAGE("The cooking parameters should be part of the key",
+                  key != dtPhysics::CookedMeshCache::ComputeKey(*box, false, 10.0f));
+         dtCore::RefPtr<osg::Geode> sameBox = CreateCookingTestBox(2.0f);
+         CPPUNIT_ASSERT_MESSAGE("Identical geometry should have the same key",
+                  key == dtPhysics::CookedMeshCache::ComputeKey(*sameBox, false, 20.0f));
+
+         dtCore::RefPtr<osg::Group> group = new osg::Group;
+         group->addChild(box.get());
+         CPPUNIT_ASSERT_MESSAGE("An extra group doesn't change the triangles, so it shouldn't change the key",
+                  key == dtPhysics::CookedMeshCache::ComputeKey(*group, false, 20.0f));
+         // Its own box, since the description is looked up through the parents.
+         dtCore::RefPtr<osg::Group> materialGroup = new osg::Group;
+         materialGroup->addDescription("Metal");
+         materialGroup->addChild(CreateCookingTestBox(2.0f).get());
+         CPPUNIT_ASSERT_MESSAGE("The nearest description is the material, so it should change the key",
+                  key != dtPhysics::CookedMeshCache::ComputeKey(*materialGroup, false, 20.0f));
+         dtCore::RefPtr<osg::MatrixTransform> moved = new osg::MatrixTransform(osg::Matrix::translate(1.0, 0.0, 0.0));
+         moved->addChild(box.get());
+         CPPUNIT_ASSERT_MESSAGE("A transform moves the triangles, so it should change the key",
+                  key != dtPhysics::CookedMeshCache::ComputeKey(*moved, false, 20.0f));
+
+         // Cooking a node fills the cache.
+         const std::string filePath = dtPhysics::CookedMeshCache::GetFilePath(key);
+         dtCore::RefPtr<dtPhysics::VertexData> data;
+         dtPhysics::VertexData::GetOrCreateCachedDataForNode(data, box.get(), dtPhysics::VertexData::NO_CACHE_KEY, false);
+         CPPUNIT_ASSERT(fileUtils.FileExists(filePath));
+         CPPUNIT_ASSERT_EQUAL(size_t(8U), data->mVertices.size());
+         CPPUNIT_ASSERT_EQUAL(size_t(36U), data->mIndices.size());
+
+         dtCore::RefPtr<dtPhysics::VertexData> loaded = new dtPhysics::VertexData;
+         CPPUNIT_ASSERT(dtPhysics::CookedMeshCache::Load(key, *loaded));
+         CPPUNIT_ASSERT(data->mVertices == loaded->mVertices);
+         CPPUNIT_ASSERT(data->mIndices == loaded->mIndices);
+
+         // Swap in a marker entry to prove the next load comes from the cache rather than the node.
+         dtCore::RefPtr<dtPhysics::VertexData> marker = new dtPhysics::VertexData;
+         marker->mVertices.push_back(osg::Vec3(1.0f, 2.0f, 3.0f));
+         marker->mVertices.push_back(osg::Vec3(4.0f, 5.0f, 6.0f));
+         marker->mVertices.push_back(osg::Vec3(7.0f, 8.0f, 9.0f));
+         marker->mIndices.push_back(0);
+         marker->mIndices.push_back(1);
+         marker->mIndices.push_back(2);
+         CPPUNIT_ASSERT(dtPhysics::CookedMeshCache::Save(key, *marker));
+
+         dtPhysics::VertexData::GetOrCreateCachedDataForNode(data, box.get(), dtPhysics::VertexData::NO_CACHE_KEY, false);
+         CPPUNIT_ASSERT(marker->mVertices == data->mVertices);
+
+         // Changing the source geometry changes the key, so the mesh is cooked again.
+         osg::Vec3Array* verts = static_cast<osg::Vec3Array*>(box->getDrawable(0)->asGeometry()->getVertexArray());
+         (*verts)[7].z() += 1.0f;
+         const std::string changedKey = dtPhysics::CookedMeshCache::ComputeKey(*box, false, 20.0f);
+         CPPUNIT_ASSERT(key != changedKey);
+
+         dtPhysics::VertexData::GetOrCreateCachedDataForNode(data, box.get(), dtPhysics::VertexData::NO_CACHE_KEY, false);
+         CPPUNIT_ASSERT_EQUAL(size_t(8U), data->mVertices.size());
+         CPPUNIT_ASSERT(fileUtils.FileExists(dtPhysics::CookedMeshCache::GetFilePath(changedKey)));
+
+         // Files are keyed on their contents.
+         const std::string sourceFile("temp_dtPhysicsCookedMeshSource.phys");
+         CPPUNIT_ASSERT(dtPhysics::PhysicsReaderWriter::SaveTriangleDataFile(*data, sourceFile));
+         const std::string fileKey = dtPhysics::CookedMeshCache::ComputeKeyForFile(sourceFile, true, 20.0f);
+         CPPUNIT_ASSERT(!fileKey.empty());
+         CPPUNIT_ASSERT(dtPhysics::CookedMeshCache::ComputeKeyForFile("temp_dtPhysicsNoSuchFile.phys", true, 20.0f).empty());
+
+         dtCore::RefPtr<dtPhysics::VertexData> hull = new dtPhysics::VertexData;
+         CPPUNIT_ASSERT(dtPhysics::CookedMeshCache::LoadFile(sourceFile, true, *hull));
+         CPPUNIT_ASSERT(!hull->mVertices.empty());
+         CPPUNIT_ASSERT(fileUtils.FileExists(dtPhysics::CookedMeshCache::GetFilePath(fileKey)));
+
+         dtCore::RefPtr<dtPhysics::VertexData> cachedHull = new dtPhysics::VertexData;
+         CPPUNIT_ASSERT(dtPhysics::CookedMeshCache::LoadFile(sourceFile, true, *cachedHull));
+         CPPUNIT_ASSERT(hull->mVertices == cachedHull->mVertices);
+         CPPUNIT_ASSERT(hull->mIndices == cachedHull->mIndices);
+
+         fileUtils.FileDelete(sourceFile);
+
+         // A model's key covers the files it loads, not just its own bytes.
+         const std::string childFile("temp_dtPhysicsCookedMeshChild.osg");
+         const std::string parentFile("temp_dtPhysicsCookedMeshParent.osg");
+         dtCore::RefPtr<osg::Geode> childBox = CreateCookingTestBox(2.0f);
+         CPPUNIT_ASSERT(osgDB::writeNodeFile(*childBox, childFile));
+         dtCore::RefPtr<osg::ProxyNode> proxy = new osg::ProxyNode;
+         proxy->setFileName(0, childFile);
+         CPPUNIT_ASSERT(osgDB::writeNodeFile(*proxy, parentFile));
+
+         const std::string modelKey = dtPhysics::CookedMeshCache::ComputeKeyForFile(parentFile, false, 20.0f);
+         CPPUNIT_ASSERT(!modelKey.empty());
+         dtCore::RefPtr<dtPhysics::VertexData> modelData = new dtPhysics::VertexData;
+         CPPUNIT_ASSERT(dtPhysics::CookedMeshCache::LoadFile(parentFile, false, *modelData));
+         CPPUNIT_ASSERT_EQUAL(size_t(8U), modelData->mVertices.size());
+         CPPUNIT_ASSERT(fileUtils.FileExists(dtPhysics::CookedMeshCache::GetFilePath(modelKey)));
+
+         childBox = CreateCookingTestBox(3.0f);
+         CPPUNIT_ASSERT(osgDB::writeNodeFile(*childBox, childFile));
+         CPPUNIT_ASSERT_MESSAGE("Changing a referenced file should change the key of the model that loads it",
+                  modelKey != dtPhysics::CookedMeshCache::ComputeKeyForFile(parentFile, false, 20.0f));
+
+         fileUtils.FileDelete(parentFile);
+         fileUtils.FileDelete(childFile);
+      }
+      catch (const dtUtil::Exception& ex)
+      {
+         dtPhysics::CookedMeshCache::SetDirectory("");
+         CPPUNIT_FAIL(ex.ToString());
+      }
+
+      dtPhysics::CookedMeshCache::SetDirectory("");
+      CPPUNIT_ASSERT(!dtPhysics::CookedMeshCache::IsEnabled());
+      fileUtils.DirDelete(cacheDir, true);
+   }
 }
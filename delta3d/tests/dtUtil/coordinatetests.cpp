@@ -35,8 +35,13 @@
 #include <dtCore/refptr.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
 #include <osg/io_utils>
 #include <osg/Math>
+#include <osg/Timer>
 
 /**
  * @class CoordinateTests
@@ -59,6 +64,10 @@ class CoordinateTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestMGRSvsXYZ);
       CPPUNIT_TEST(TestConvertGeodeticToUTM );
       CPPUNIT_TEST(TestConvertUTMToGeodetic);
+      CPPUNIT_TEST(TestGeocentricBatchConversions);
+      CPPUNIT_TEST(TestUTMBatchConversions);
+      CPPUNIT_TEST(TestLocalTranslationBatch);
+      CPPUNIT_TEST(TestBatchPerformance);
    CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -80,6 +89,10 @@ class CoordinateTests : public CPPUNIT_NS::TestFixture
       void TestConvertGeodeticToUTM();
       void TestMGRSvsXYZ();
       void TestConvertUTMToGeodetic();
+      void TestGeocentricBatchConversions();
+      void TestUTMBatchConversions();
+      void TestLocalTranslationBatch();
+      void TestBatchPerformance();
 
    private:
 
@@ -812,3 +825,217 @@ void CoordinateTests::TestConvertUTMToGeodetic()
    CPPUNIT_ASSERT_DOUBLES_EQUAL( -45.1, osg::RadiansToDegrees(lat), epsilon );
    CPPUNIT_ASSERT_DOUBLES_EQUAL( -123.0, osg::RadiansToDegrees(lon), epsilon );
 }
+
+//////////////////////////////////////////////////////////////////////////////
+static double RandomRange(double low, double high)
+{
+   return low + (high - low) * (double(rand()) / double(RAND_MAX));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void CoordinateTests::TestGeocentricBatchConversions()
+{
+   const unsigned count = 5000;
+   std::vector<double> lat(count), lon(count), elev(count);
+   std::vector<double> x(count), y(count), z(count);
+   std::vector<double> latOut(count), lonOut(count), elevOut(count);
+
+   srand(42);
+   for (unsigned i = 0; i < count; ++i)
+   {
+      lat[i] = osg::DegreesToRadians(RandomRange(-89.0, 89.0));
+      lon[i] = osg::DegreesToRadians(RandomRange(-180.0, 180.0));
+      elev[i] = RandomRange(-500.0, 20000.0);
+   }
+
+   for (unsigned pass = 0; pass < 2; ++pass)
+   {
+      bool useThreadPool = pass == 1;
+      dtUtil::Coordinates::GeodeticToGeocentricBatch(&lat[0], &lon[0], &elev[0], &x[0], &y[0], &z[0], count, useThreadPool);
+      dtUtil::Coordinates::ConvertGeocentricToGeodeticBatch(&x[0], &y[0], &z[0], &latOut[0], &lonOut[0], &elevOut[0], count, useThreadPool);
+
+      for (unsigned i = 0; i < count; ++i)
+      {
+         double ex, ey, ez;
+         dtUtil::Coordinates::GeodeticToGeocentric(lat[i], lon[i], elev[i], ex, ey, ez);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(ex, x[i], 1e-6);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(ey, y[i], 1e-6);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(ez, z[i], 1e-6);
+
+         double ePhi, eLambda, eElev;
+         dtUtil::Coordinates::ConvertGeocentricToGeodetic(x[i], y[i], z[i], ePhi, eLambda, eElev);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(ePhi, latOut[i], 1e-12);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(eLambda, lonOut[i], 1e-12);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(eElev, elevOut[i], 1e-6);
+      }
+   }
+
+   // The output arrays are allowed to be the input arrays.
+   std::vector<double> xInPlace(x), yInPlace(y), zInPlace(z);
+   dtUtil::Coordinates::ConvertGeocentricToGeodeticBatch(&xInPlace[0], &yInPlace[0], &zInPlace[0],
+            &xInPlace[0], &yInPlace[0], &zInPlace[0], count);
+   for (unsigned i = 0; i < count; ++i)
+   {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(latOut[i], xInPlace[i], 1e-12);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(lonOut[i], yInPlace[i], 1e-12);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(elevOut[i], zInPlace[i], 1e-6);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void CoordinateTests::TestUTMBatchConversions()
+{
+   const unsigned count = 5000;
+   std::vector<double> lat(count), lon(count);
+   std::vector<double> easting(count), northing(count);
+   std::vector<double> latOut(count), lonOut(count);
+
+   srand(7);
+   const unsigned zones[] = { 1, 11, 31, 60 };
+   for (unsigned z = 0; z < 4; ++z)
+   {
+      const unsigned zone = zones[z];
+      const double centralMeridian = double(zone) * 6.0 - 183.0;
+      for (unsigned h = 0; h < 2; ++h)
+      {
+         const char hemisphere = h == 0 ? 'N' : 'S';
+         for (unsigned i = 0; i < count; ++i)
+         {
+            lat[i] = osg::DegreesToRadians(h == 0 ? RandomRange(0.0, 84.0) : RandomRange(-80.0, 0.0));
+            lon[i] = osg::DegreesToRadians(centralMeridian + RandomRange(-3.0, 3.0));
+         }
+
+         dtUtil::Coordinates::ConvertGeodeticToUTMBatch(&lat[0], &lon[0], zone, hemisphere,
+                  &easting[0], &northing[0], count, z % 2 == 1);
+         dtUtil::Coordinates::ConvertUTMToGeodeticBatch(zone, hemisphere, &easting[0], &northing[0],
+                  &latOut[0], &lonOut[0], count, z % 2 == 0);
+
+         for (unsigned i = 0; i < count; ++i)
+         {
+            double e, n;
+            dtUtil::Coordinates::ConvertGeodeticToUTM(lat[i], lon[i], zone, hemisphere, e, n);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(e, easting[i], 1e-6);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(n, northing[i], 1e-6);
+
+            double la, lo;
+            dtUtil::Coordinates::ConvertUTMToGeodetic(zone, hemisphere, easting[i], northing[i], la, lo);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(la, latOut[i], 1e-12);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(lo, lonOut[i], 1e-12);
+         }
+      }
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void CoordinateTests::TestLocalTranslationBatch()
+{
+   const unsigned count = 500;
+   std::vector<double> loc0(count), loc1(count), loc2(count);
+   std::vector<double> x(count), y(count), z(count);
+
+   converter->SetUTMZone(11);
+   converter->SetLocalOffset(osg::Vec3d(562078.225268, 3788040.632974, -32.0));
+   converter->SetFlatEarthOrigin(osg::Vec2d(34.2, -116.1));
+
+   srand(11);
+   const dtUtil::LocalCoordinateType* localTypes[] =
+   {
+      &dtUtil::LocalCoordinateType::CARTESIAN_UTM,
+      &dtUtil::LocalCoordinateType::CARTESIAN_FLAT_EARTH
+   };
+   const dtUtil::IncomingCoordinateType* incomingTypes[] =
+   {
+      &dtUtil::IncomingCoordinateType::GEOCENTRIC,
+      &dtUtil::IncomingCoordinateType::GEODETIC,
+      &dtUtil::IncomingCoordinateType::UTM
+   };
+
+   for (unsigned l = 0; l < 2; ++l)
+   {
+      for (unsigned t = 0; t < 3; ++t)
+      {
+         converter->SetLocalCoordinateType(*localTypes[l]);
+         converter->SetIncomingCoordinateType(*incomingTypes[t]);
+
+         for (unsigned i = 0; i < count; ++i)
+         {
+            double lat = RandomRange(34.0, 34.4), lon = RandomRange(-116.3, -115.9), elev = RandomRange(0.0, 2000.0);
+            if (*incomingTypes[t] == dtUtil::IncomingCoordinateType::GEOCENTRIC)
+            {
+               dtUtil::Coordinates::GeodeticToGeocentric(osg::DegreesToRadians(lat), osg::DegreesToRadians(lon), elev,
+                        loc0[i], loc1[i], loc2[i]);
+            }
+            else if (*incomingTypes[t] == dtUtil::IncomingCoordinateType::GEODETIC)
+            {
+               loc0[i] = lat;
+               loc1[i] = lon;
+               loc2[i] = elev;
+            }
+            else
+            {
+               dtUtil::Coordinates::ConvertGeodeticToUTM(osg::DegreesToRadians(lat), osg::DegreesToRadians(lon), 11, 'N',
+                        loc0[i], loc1[i]);
+               loc2[i] = elev;
+            }
+         }
+
+         converter->ConvertToLocalTranslationBatch(&loc0[0], &loc1[0], &loc2[0], &x[0], &y[0], &z[0], count, t == 0);
+
+         for (unsigned i = 0; i < count; ++i)
+         {
+            osg::Vec3 expected = converter->ConvertToLocalTranslation(osg::Vec3d(loc0[i], loc1[i], loc2[i]));
+            std::ostringstream ss;
+            ss << localTypes[l]->GetName() << " from " << incomingTypes[t]->GetName() << " expected: " << expected
+               << ", actual: " << osg::Vec3d(x[i], y[i], z[i]);
+            // the single point version rounds to floats.
+            CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(ss.str(), expected.x(), x[i], 1e-6 * std::max(1.0, std::abs(x[i])));
+            CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(ss.str(), expected.y(), y[i], 1e-6 * std::max(1.0, std::abs(y[i])));
+            CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(ss.str(), expected.z(), z[i], 1e-6 * std::max(1.0, std::abs(z[i])));
+         }
+      }
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void CoordinateTests::TestBatchPerformance()
+{
+   const unsigned count = 200000;
+   std::vector<double> loc0(count), loc1(count), loc2(count);
+   std::vector<double> x(count), y(count), z(count);
+
+   srand(3);
+   for (unsigned i = 0; i < count; ++i)
+   {
+      dtUtil::Coordinates::GeodeticToGeocentric(osg::DegreesToRadians(RandomRange(34.0, 34.4)),
+               osg::DegreesToRadians(RandomRange(-116.3, -115.9)), RandomRange(0.0, 2000.0),
+               loc0[i], loc1[i], loc2[i]);
+   }
+
+   converter->SetIncomingCoordinateType(dtUtil::IncomingCoordinateType::GEOCENTRIC);
+   converter->SetLocalCoordinateType(dtUtil::LocalCoordinateType::CARTESIAN_UTM);
+   converter->SetUTMZone(11);
+   converter->SetLocalOffset(osg::Vec3d(562078.225268, 3788040.632974, -32.0));
+
+   osg::Timer timer;
+   osg::Timer_t start = timer.tick();
+   for (unsigned i = 0; i < count; ++i)
+   {
+      converter->ConvertToLocalTranslation(osg::Vec3d(loc0[i], loc1[i], loc2[i]));
+   }
+   double scalarTime = timer.delta_s(start, timer.tick());
+
+   start = timer.tick();
+   converter->ConvertToLocalTranslationBatch(&loc0[0], &loc1[0], &loc2[0], &x[0], &y[0], &z[0], count);
+   double batchTime = timer.delta_s(start, timer.tick());
+
+   start = timer.tick();
+   converter->ConvertToLocalTranslationBatch(&loc0[0], &loc1[0], &loc2[0], &x[0], &y[0], &z[0], count, true);
+   double threadedTime = timer.delta_s(start, timer.tick());
+
+   std::ostringstream ss;
+   ss << "Geocentric to UTM local translation of " << count << " points, in points per second:"
+      << " single " << (scalarTime > 0.0 ? count / scalarTime : 0.0)
+      << ", batch " << (batchTime > 0.0 ? count / batchTime : 0.0)
+      << ", batch on the thread pool " << (threadedTime > 0.0 ? count / threadedTime : 0.0);
+   LOG_ALWAYS(ss.str());
+}
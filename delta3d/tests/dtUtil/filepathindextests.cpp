@@ -0,0 +1,281 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtUtil/filepathindex.h>
+#include <dtUtil/fileutils.h>
+#include <dtUtil/log.h>
+#include <dtUtil/stringutils.h>
+
+#include <osg/Timer>
+#include <fstream>
+#include <sstream>
+
+class FilePathIndexTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(FilePathIndexTests);
+   CPPUNIT_TEST(TestFind);
+   CPPUNIT_TEST(TestUnhandledPaths);
+   CPPUNIT_TEST(TestPicksUpChanges);
+   CPPUNIT_TEST(TestPreload);
+   CPPUNIT_TEST(TestPerformance);
+   CPPUNIT_TEST_SUITE_END();
+
+public:
+   void setUp()
+   {
+      dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+      mRoot = fileUtils.CurrentDirectory() + dtUtil::FileUtils::PATH_SEPARATOR + "FilePathIndexTest";
+      fileUtils.DirDelete(mRoot, true);
+      fileUtils.MakeDirectory(mRoot);
+      fileUtils.MakeDirectory(mRoot + "/Textures");
+      fileUtils.MakeDirectory(mRoot + "/Textures/Sub");
+      fileUtils.MakeDirectory(mRoot + "/StaticMeshes");
+      fileUtils.MakeDirectory(mRoot + "/Sounds");
+      WriteFile(mRoot + "/Textures/Grass.PNG");
+      WriteFile(mRoot + "/Textures/Sub/rock.png");
+      WriteFile(mRoot + "/StaticMeshes/tree.ive");
+   }
+
+   void tearDown()
+   {
+      dtUtil::FileUtils::GetInstance().DirDelete(mRoot, true);
+   }
+
+   void WriteFile(const std::string& path)
+   {
+      std::ofstream out(path.c_str());
+      out << "test";
+   }
+
+   void CheckFound(dtUtil::FilePathIndex& index, const std::string& relPath, const std::string& expected, dtUtil::FileType expectedType)
+   {
+      std::string path;
+      dtUtil::FileType type = dtUtil::FILE_NOT_FOUND;
+      CPPUNIT_ASSERT_MESSAGE(relPath, index.Find(relPath, path, type));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE(relPath, int(expectedType), int(type));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE(relPath, mRoot + "/" + expected, path);
+   }
+
+   void CheckNotFound(dtUtil::FilePathIndex& index, const std::string& relPath)
+   {
+      std::string path;
+      dtUtil::FileType type = dtUtil::REGULAR_FILE;
+      CPPUNIT_ASSERT_MESSAGE(relPath, index.Find(relPath, path, type));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE(relPath, int(dtUtil::FILE_NOT_FOUND), int(type));
+   }
+
+   void TestFind()
+   {
+      dtCore::RefPtr<dtUtil::FilePathIndex> index = new dtUtil::FilePathIndex(mRoot + "/");
+      CPPUNIT_ASSERT_EQUAL(mRoot, index->GetRootDirectory());
+
+      CheckFound(*index, "Textures/Grass.PNG", "Textures/Grass.PNG", dtUtil::REGULAR_FILE);
+      CheckFound(*index, "textures/grass.png", "Textures/Grass.PNG", dtUtil::REGULAR_FILE);
+      CheckFound(*index, "TEXTURES\\SUB\\Rock.png", "Textures/Sub/rock.png", dtUtil::REGULAR_FILE);
+      CheckFound(*index, "./staticmeshes//tree.ive", "StaticMeshes/tree.ive", dtUtil::REGULAR_FILE);
+      CheckFound(*index, "textures/sub", "Textures/Sub", dtUtil::DIRECTORY);
+      CheckFound(*index, "sounds/", "Sounds", dtUtil::DIRECTORY);
+
+      CheckNotFound(*index, "Textures/Dirt.png");
+      CheckNotFound(*index, "Nothing/Dirt.png");
+      CheckNotFound(*index, "Sounds/boom.wav");
+
+      // It should agree with a case insensitive search through FileUtils.
+      dtUtil::FileInfo info = dtUtil::FileUtils::GetInstance().GetFileInfo(mRoot + "/textures/sub/ROCK.png", true);
+      std::string path;
+      dtUtil::FileType type;
+      CPPUNIT_ASSERT(index->Find("textures/sub/ROCK.png", path, type));
+      CPPUNIT_ASSERT_EQUAL(info.fileName, path);
+
+      CPPUNIT_ASSERT_EQUAL(10U, index->GetNumLookups());
+      CPPUNIT_ASSERT_EQUAL(7U, index->GetNumHits());
+      // Each directory is only read once.
+      CPPUNIT_ASSERT_EQUAL(5U, index->GetNumDirectoryScans() - index->GetNumRescans());
+
+      index->ResetCounters();
+      CPPUNIT_ASSERT_EQUAL(0U, index->GetNumLookups());
+      CPPUNIT_ASSERT_EQUAL(0U, index->GetNumStatCalls());
+   }
+
+   void TestUnhandledPaths()
+   {
+      dtCore::RefPtr<dtUtil::FilePathIndex> index = new dtUtil::FilePathIndex(mRoot);
+      std::string path = "unchanged";
+      dtUtil::FileType type = dtUtil::ARCHIVE;
+
+      CPPUNIT_ASSERT(!index->Find(mRoot + "/Textures/Grass.PNG", path, type));
+      CPPUNIT_ASSERT(!index->Find("Textures/../Textures/Grass.PNG", path, type));
+      CPPUNIT_ASSERT(!index->Find("", path, type));
+      CPPUNIT_ASSERT(!index->Find("./", path, type));
+      // Going through a file is left to FileUtils, since it may be an archive.
+      CPPUNIT_ASSERT(!index->Find("StaticMeshes/tree.ive/leaf.osg", path, type));
+
+      CPPUNIT_ASSERT_EQUAL(std::string("unchanged"), path);
+      CPPUNIT_ASSERT_EQUAL(int(dtUtil::ARCHIVE), int(type));
+
+      std::vector<std::string> components;
+      CPPUNIT_ASSERT(dtUtil::FilePathIndex::NormalizePath("A\\b/./C.txt", components));
+      CPPUNIT_ASSERT_EQUAL(size_t(3), components.size());
+      CPPUNIT_ASSERT_EQUAL(std::string("a"), components[0]);
+      CPPUNIT_ASSERT_EQUAL(std::string("b"), components[1]);
+      CPPUNIT_ASSERT_EQUAL(std::string("c.txt"), components[2]);
+   }
+
+   void TestPicksUpChanges()
+   {
+      dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+      dtCore::RefPtr<dtUtil::FilePathIndex> index = new dtUtil::FilePathIndex(mRoot);
+
+      CheckNotFound(*index, "Textures/Dirt.png");
+      WriteFile(mRoot + "/Textures/Dirt.png");
+      CheckFound(*index, "textures/dirt.png", "Textures/Dirt.png", dtUtil::REGULAR_FILE);
+
+      fileUtils.FileDelete(mRoot + "/Textures/Dirt.png");
+      CheckNotFound(*index, "textures/dirt.png");
+
+      CheckFound(*index, "Textures/Sub/rock.png", "Textures/Sub/rock.png", dtUtil::REGULAR_FILE);
+      fileUtils.DirDelete(mRoot + "/Textures/Sub", true);
+      CheckNotFound(*index, "Textures/Sub/rock.png");
+      CheckNotFound(*index, "Textures/Sub");
+
+      fileUtils.MakeDirectory(mRoot + "/Textures/Sub");
+      WriteFile(mRoot + "/Textures/Sub/Rock2.png");
+      CheckFound(*index, "textures/sub/rock2.png", "Textures/Sub/Rock2.png", dtUtil::REGULAR_FILE);
+
+      // Changing one directory shouldn't lose what was read under it.
+      unsigned scans = index->GetNumDirectoryScans();
+      CheckFound(*index, "StaticMeshes/tree.ive", "StaticMeshes/tree.ive", dtUtil::REGULAR_FILE);
+      WriteFile(mRoot + "/new.txt");
+      CheckFound(*index, "NEW.txt", "new.txt", dtUtil::REGULAR_FILE);
+      CheckFound(*index, "StaticMeshes/tree.ive", "StaticMeshes/tree.ive", dtUtil::REGULAR_FILE);
+      CheckFound(*index, "Textures/Sub/Rock2.png", "Textures/Sub/Rock2.png", dtUtil::REGULAR_FILE);
+      CPPUNIT_ASSERT(index->GetNumRescans() > 0);
+      CPPUNIT_ASSERT(index->GetNumDirectoryScans() > scans);
+
+      index->Clear();
+      CheckFound(*index, "Textures/Sub/Rock2.png", "Textures/Sub/Rock2.png", dtUtil::REGULAR_FILE);
+   }
+
+   void TestPreload()
+   {
+      dtCore::RefPtr<dtUtil::FilePathIndex> index = new dtUtil::FilePathIndex(mRoot);
+      index->Preload();
+      CPPUNIT_ASSERT_EQUAL(5U, index->GetNumDirectoryScans());
+      CheckFound(*index, "Textures/Sub/rock.png", "Textures/Sub/rock.png", dtUtil::REGULAR_FILE);
+      CPPUNIT_ASSERT_EQUAL(5U, index->GetNumDirectoryScans() - index->GetNumRescans());
+
+      dtCore::RefPtr<dtUtil::FilePathIndex> missing = new dtUtil::FilePathIndex(mRoot + "/NotThere");
+      missing->Preload();
+      CheckNotFound(*missing, "Textures/Sub/rock.png");
+   }
+
+   void TestPerformance()
+   {
+      const unsigned numCategories = 20, numSubDirs = 5, numFiles = 50;
+      dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+
+      std::vector<std::string> relPaths;
+      for (unsigned c = 0; c < numCategories; ++c)
+      {
+         std::ostringstream category;
+         category << "Category" << c;
+         fileUtils.MakeDirectory(mRoot + "/" + category.str());
+         for (unsigned s = 0; s < numSubDirs; ++s)
+         {
+            std::ostringstream subDir;
+            subDir << category.str() << "/SubDir" << s;
+            fileUtils.MakeDirectory(mRoot + "/" + subDir.str());
+            for (unsigned f = 0; f < numFiles; ++f)
+            {
+               std::ostringstream file;
+               file << subDir.str() << "/Mesh_" << f << ".IVE";
+               WriteFile(mRoot + "/" + file.str());
+               std::string lower = file.str();
+               dtUtil::ToLowerCase(lower);
+               relPaths.push_back(lower);
+            }
+         }
+      }
+
+      dtCore::RefPtr<dtUtil::FilePathIndex> index = new dtUtil::FilePathIndex(mRoot);
+
+      osg::Timer_t start = osg::Timer::instance()->tick();
+      unsigned numFileUtilsFound = 0;
+      for (unsigned i = 0; i < relPaths.size(); ++i)
+      {
+         if (fileUtils.GetFileInfo(mRoot + "/" + relPaths[i], true).fileType == dtUtil::REGULAR_FILE)
+         {
+            ++numFileUtilsFound;
+         }
+      }
+      double fileUtilsMs = osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick());
+
+      start = osg::Timer::instance()->tick();
+      unsigned numIndexFound = 0;
+      std::string path;
+      dtUtil::FileType type;
+      for (unsigned i = 0; i < relPaths.size(); ++i)
+      {
+         if (index->Find(relPaths[i], path, type) && type == dtUtil::REGULAR_FILE)
+         {
+            ++numIndexFound;
+         }
+      }
+      double firstPassMs = osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick());
+      unsigned firstPassStats = index->GetNumStatCalls();
+      unsigned firstPassScans = index->GetNumDirectoryScans();
+
+      index->ResetCounters();
+      start = osg::Timer::instance()->tick();
+      for (unsigned i = 0; i < relPaths.size(); ++i)
+      {
+         if (index->Find(relPaths[i], path, type) && type == dtUtil::REGULAR_FILE)
+         {
+            ++numIndexFound;
+         }
+      }
+      double secondPassMs = osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick());
+
+      CPPUNIT_ASSERT_EQUAL(unsigned(relPaths.size()), numFileUtilsFound);
+      CPPUNIT_ASSERT_EQUAL(unsigned(relPaths.size() * 2), numIndexFound);
+      // Once everything has been read, a lookup is one stat of the directory holding the file.
+      CPPUNIT_ASSERT(index->GetNumStatCalls() >= relPaths.size());
+
+      std::ostringstream ss;
+      ss << "FilePathIndex performance, " << relPaths.size() << " files in "
+         << numCategories * numSubDirs << " directories:\n"
+         << "   FileUtils::GetFileInfo case insensitive: " << fileUtilsMs << " ms\n"
+         << "   FilePathIndex first pass: " << firstPassMs << " ms, "
+         << firstPassStats << " stat calls, " << firstPassScans << " directory reads\n"
+         << "   FilePathIndex second pass: " << secondPassMs << " ms, "
+         << index->GetNumStatCalls() << " stat calls, " << index->GetNumDirectoryScans() << " directory reads";
+      LOG_ALWAYS(ss.str());
+   }
+
+private:
+   std::string mRoot;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FilePathIndexTests);
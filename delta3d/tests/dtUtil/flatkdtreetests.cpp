@@ -0,0 +1,378 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtUtil/flatkdtree.h>
+#include <dtUtil/log.h>
+
+#include <osg/Timer>
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <sstream>
+
+class FlatKDTreeTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(FlatKDTreeTests);
+   CPPUNIT_TEST(TestInsertFind);
+   CPPUNIT_TEST(TestRemoveMove);
+   CPPUNIT_TEST(TestMatchesLinearScan);
+   CPPUNIT_TEST(TestFilters);
+   CPPUNIT_TEST(TestBatch);
+   CPPUNIT_TEST(TestPerformance);
+   CPPUNIT_TEST_SUITE_END();
+
+public:
+   typedef dtUtil::FlatKDTree<unsigned> TreeType;
+
+   struct EvenFilter
+   {
+      bool operator()(unsigned value) const { return value % 2 == 0; }
+   };
+
+   void setUp()
+   {
+      srand(42);
+   }
+
+   void tearDown()
+   {
+      mTree.Clear();
+      mPositions.clear();
+      mRemoved.clear();
+   }
+
+   void TestInsertFind()
+   {
+      unsigned result = 0;
+      CPPUNIT_ASSERT(mTree.IsEmpty());
+      CPPUNIT_ASSERT(!mTree.FindNearest(osg::Vec3(), 1000.0f, result));
+
+      mTree.Insert(osg::Vec3(1.0f, 0.0f, 0.0f), 1U);
+      mTree.Insert(osg::Vec3(5.0f, 0.0f, 0.0f), 5U);
+      CPPUNIT_ASSERT_EQUAL(size_t(2), mTree.GetSize());
+
+      CPPUNIT_ASSERT(mTree.FindNearest(osg::Vec3(), 2.0f, result));
+      CPPUNIT_ASSERT_EQUAL(1U, result);
+      CPPUNIT_ASSERT(mTree.FindNearest(osg::Vec3(4.0f, 0.0f, 0.0f), 2.0f, result));
+      CPPUNIT_ASSERT_EQUAL(5U, result);
+
+      // the nearest search includes the max distance, and a point at the query position is found at 0.
+      CPPUNIT_ASSERT(mTree.FindNearest(osg::Vec3(), 1.0f, result));
+      CPPUNIT_ASSERT(!mTree.FindNearest(osg::Vec3(), 0.5f, result));
+      CPPUNIT_ASSERT(mTree.FindNearest(osg::Vec3(1.0f, 0.0f, 0.0f), 0.0f, result));
+      CPPUNIT_ASSERT(!mTree.FindNearest(osg::Vec3(1.0f, 0.0f, 0.0f), -1.0f, result));
+
+      // the radius search does not.
+      std::vector<unsigned> found;
+      CPPUNIT_ASSERT_EQUAL(size_t(1), mTree.FindInRadius(osg::Vec3(), 5.0f, std::back_inserter(found)));
+      CPPUNIT_ASSERT_EQUAL(size_t(2), mTree.FindInRadius(osg::Vec3(), 5.01f, std::back_inserter(found)));
+      CPPUNIT_ASSERT_EQUAL(size_t(0), mTree.FindInRadius(osg::Vec3(1.0f, 0.0f, 0.0f), 0.0f, std::back_inserter(found)));
+      CPPUNIT_ASSERT_EQUAL(size_t(3), found.size());
+   }
+
+   void TestRemoveMove()
+   {
+      FillRandom(1000U, 100.0f);
+
+      unsigned result = 0;
+      CPPUNIT_ASSERT(!mTree.Remove(mPositions[10], 11U));
+      CPPUNIT_ASSERT(!mTree.Remove(mPositions[10] + osg::Vec3(0.01f, 0.0f, 0.0f), 10U));
+      CPPUNIT_ASSERT(!mTree.Remove(mPositions[10] + osg::Vec3(0.2f, 0.0f, 0.0f), 10U, 0.1f));
+      CPPUNIT_ASSERT(mTree.Remove(mPositions[10] + osg::Vec3(0.01f, 0.0f, 0.0f), 10U, 0.1f));
+      CPPUNIT_ASSERT(!mTree.Remove(mPositions[10], 10U));
+      CPPUNIT_ASSERT_EQUAL(size_t(999), mTree.GetSize());
+      CPPUNIT_ASSERT(!mTree.FindNearest(mPositions[10], 0.0f, result) || result != 10U);
+
+      osg::Vec3 farAway(1000.0f, 1000.0f, 1000.0f);
+      CPPUNIT_ASSERT(!mTree.Move(mPositions[10], farAway, 10U));
+      CPPUNIT_ASSERT(mTree.Move(mPositions[20], farAway, 20U));
+      CPPUNIT_ASSERT_EQUAL(size_t(999), mTree.GetSize());
+      CPPUNIT_ASSERT(mTree.FindNearest(osg::Vec3(999.0f, 999.0f, 999.0f), 10.0f, result));
+      CPPUNIT_ASSERT_EQUAL(20U, result);
+
+      // removing most of the points forces a compaction, which must not lose any.
+      for (unsigned i = 0; i < 1000U; ++i)
+      {
+         if (i != 10U && i != 20U && i % 10U != 0U)
+         {
+            CPPUNIT_ASSERT(mTree.Remove(mPositions[i], i));
+         }
+      }
+      CPPUNIT_ASSERT_EQUAL(size_t(99), mTree.GetSize());
+      std::vector<unsigned> found;
+      mTree.FindInRadius(osg::Vec3(), 10000.0f, std::back_inserter(found));
+      CPPUNIT_ASSERT_EQUAL(size_t(99), found.size());
+
+      mTree.Clear();
+      CPPUNIT_ASSERT(mTree.IsEmpty());
+      CPPUNIT_ASSERT(!mTree.FindNearest(farAway, 10.0f, result));
+   }
+
+   void TestMatchesLinearScan()
+   {
+      FillRandom(20000U, 1000.0f);
+
+      // interleave removes and moves so the points are spread over the insert buffer and several levels.
+      for (unsigned i = 0; i < mPositions.size(); i += 3)
+      {
+         CPPUNIT_ASSERT(mTree.Remove(mPositions[i], i));
+         mRemoved[i] = true;
+      }
+      for (unsigned i = 1; i < mPositions.size(); i += 7)
+      {
+         if (!mRemoved[i])
+         {
+            osg::Vec3 newPos = RandomPos(1000.0f);
+            CPPUNIT_ASSERT(mTree.Move(mPositions[i], newPos, i));
+            mPositions[i] = newPos;
+         }
+      }
+
+      for (unsigned q = 0; q < 200U; ++q)
+      {
+         osg::Vec3 pos = RandomPos(1000.0f);
+         float radius = float(rand() % 50 + 1);
+
+         unsigned expected = 0U;
+         float bestDist2 = 0.0f;
+         bool expectFound = LinearNearest(pos, radius, expected, bestDist2);
+
+         unsigned result = 0U;
+         CPPUNIT_ASSERT_EQUAL(expectFound, mTree.FindNearest(pos, radius, result));
+         if (expectFound)
+         {
+            // ties may pick a different point, but it must be the same distance.
+            CPPUNIT_ASSERT_EQUAL(bestDist2, (mPositions[result] - pos).length2());
+         }
+
+         std::vector<unsigned> found;
+         mTree.FindInRadius(pos, radius, std::back_inserter(found));
+         CPPUNIT_ASSERT_EQUAL(LinearCount(pos, radius), unsigned(found.size()));
+      }
+   }
+
+   void TestFilters()
+   {
+      FillRandom(5000U, 100.0f);
+
+      for (unsigned q = 0; q < 100U; ++q)
+      {
+         osg::Vec3 pos = RandomPos(100.0f);
+         unsigned result = 1U;
+         if (mTree.FindNearest(pos, 20.0f, result, EvenFilter()))
+         {
+            CPPUNIT_ASSERT_EQUAL(0U, result % 2U);
+            float dist2 = (mPositions[result] - pos).length2();
+            for (unsigned i = 0; i < mPositions.size(); i += 2)
+            {
+               CPPUNIT_ASSERT((mPositions[i] - pos).length2() >= dist2);
+            }
+         }
+
+         std::vector<unsigned> all, even;
+         mTree.FindInRadius(pos, 20.0f, std::back_inserter(all));
+         mTree.FindInRadius(pos, 20.0f, std::back_inserter(even), EvenFilter());
+         unsigned expectedEven = 0U;
+         for (unsigned i = 0; i < all.size(); ++i)
+         {
+            if (all[i] % 2U == 0U)
+            {
+               ++expectedEven;
+            }
+            else
+            {
+               CPPUNIT_ASSERT(std::find(even.begin(), even.end(), all[i]) == even.end());
+            }
+         }
+         CPPUNIT_ASSERT_EQUAL(expectedEven, unsigned(even.size()));
+      }
+   }
+
+   void TestBatch()
+   {
+      FillRandom(5000U, 1000.0f);
+
+      std::vector<osg::Vec3> queries;
+      for (unsigned i = 0; i < 500U; ++i)
+      {
+         queries.push_back(RandomPos(1000.0f));
+      }
+
+      std::vector<unsigned> results;
+      size_t numFound = mTree.FindNearestBatch(queries, 15.0f, results, ~0U);
+      CPPUNIT_ASSERT_EQUAL(queries.size(), results.size());
+
+      size_t expectedFound = 0;
+      for (unsigned i = 0; i < queries.size(); ++i)
+      {
+         unsigned single = ~0U;
+         if (mTree.FindNearest(queries[i], 15.0f, single))
+         {
+            ++expectedFound;
+         }
+         CPPUNIT_ASSERT_EQUAL(single, results[i]);
+      }
+      CPPUNIT_ASSERT_EQUAL(expectedFound, numFound);
+   }
+
+   void TestPerformance()
+   {
+      const unsigned numPoints = 200000U;
+      const unsigned numQueries = 20000U;
+      const unsigned numUpdates = 20000U;
+      const float size = 10000.0f;
+      const float radius = 50.0f;
+
+      osg::Timer* timer = osg::Timer::instance();
+
+      osg::Timer_t start = timer->tick();
+      FillRandom(numPoints, size);
+      double insertMs = timer->delta_m(start, timer->tick());
+
+      std::vector<osg::Vec3> queries;
+      for (unsigned i = 0; i < numQueries; ++i)
+      {
+         queries.push_back(RandomPos(size));
+      }
+
+      start = timer->tick();
+      for (unsigned i = 0; i < numUpdates; ++i)
+      {
+         unsigned idx = unsigned(rand()) % numPoints;
+         osg::Vec3 newPos = RandomPos(size);
+         CPPUNIT_ASSERT(mTree.Move(mPositions[idx], newPos, idx));
+         mPositions[idx] = newPos;
+      }
+      double moveMs = timer->delta_m(start, timer->tick());
+
+      unsigned result = 0U;
+      unsigned numFound = 0U;
+      start = timer->tick();
+      for (unsigned i = 0; i < numQueries; ++i)
+      {
+         numFound += mTree.FindNearest(queries[i], radius, result) ? 1U : 0U;
+      }
+      double nearestMs = timer->delta_m(start, timer->tick());
+
+      std::vector<unsigned> results;
+      start = timer->tick();
+      CPPUNIT_ASSERT_EQUAL(size_t(numFound), mTree.FindNearestBatch(queries, radius, results, ~0U));
+      double batchMs = timer->delta_m(start, timer->tick());
+
+      std::vector<unsigned> found;
+      start = timer->tick();
+      for (unsigned i = 0; i < numQueries; ++i)
+      {
+         found.clear();
+         mTree.FindInRadius(queries[i], radius, std::back_inserter(found));
+      }
+      double radiusMs = timer->delta_m(start, timer->tick());
+
+      start = timer->tick();
+      mTree.Optimize();
+      double optimizeMs = timer->delta_m(start, timer->tick());
+
+      start = timer->tick();
+      for (unsigned i = 0; i < numQueries; ++i)
+      {
+         mTree.FindNearest(queries[i], radius, result);
+      }
+      double optimizedNearestMs = timer->delta_m(start, timer->tick());
+
+      // the linear scan is what a named or typed lookup cost before, only time a few of them.
+      const unsigned numLinear = 200U;
+      float dist2 = 0.0f;
+      unsigned numLinearFound = 0U;
+      start = timer->tick();
+      for (unsigned i = 0; i < numLinear; ++i)
+      {
+         numLinearFound += LinearNearest(queries[i], radius, result, dist2) ? 1U : 0U;
+      }
+      double linearMs = timer->delta_m(start, timer->tick()) * double(numQueries) / double(numLinear);
+
+      std::ostringstream ss;
+      ss << "FlatKDTree with " << numPoints << " points: inserting took " << insertMs << "ms, "
+         << numUpdates << " moves took " << moveMs << "ms. " << numQueries << " nearest queries took "
+         << nearestMs << "ms, " << batchMs << "ms batched, " << optimizedNearestMs << "ms after a "
+         << optimizeMs << "ms Optimize, versus an estimated " << linearMs << "ms for a linear scan. "
+         << numQueries << " radius queries took " << radiusMs << "ms.";
+      LOG_ALWAYS(ss.str());
+
+      CPPUNIT_ASSERT(numLinearFound <= numLinear);
+   }
+
+private:
+   osg::Vec3 RandomPos(float size)
+   {
+      return osg::Vec3(size * float(rand()) / float(RAND_MAX), size * float(rand()) / float(RAND_MAX),
+               0.1f * size * float(rand()) / float(RAND_MAX));
+   }
+
+   void FillRandom(unsigned count, float size)
+   {
+      for (unsigned i = 0; i < count; ++i)
+      {
+         mPositions.push_back(RandomPos(size));
+         mTree.Insert(mPositions.back(), i);
+      }
+      mRemoved.assign(count, false);
+   }
+
+   bool LinearNearest(const osg::Vec3& pos, float radius, unsigned& result, float& bestDist2)
+   {
+      bool found = false;
+      bestDist2 = radius * radius;
+      for (unsigned i = 0; i < mPositions.size(); ++i)
+      {
+         float dist2 = (mPositions[i] - pos).length2();
+         if (!mRemoved[i] && (dist2 < bestDist2 || (!found && dist2 <= bestDist2)))
+         {
+            bestDist2 = dist2;
+            result = i;
+            found = true;
+         }
+      }
+      return found;
+   }
+
+   unsigned LinearCount(const osg::Vec3& pos, float radius)
+   {
+      unsigned count = 0U;
+      for (unsigned i = 0; i < mPositions.size(); ++i)
+      {
+         if (!mRemoved[i] && (mPositions[i] - pos).length2() < radius * radius)
+         {
+            ++count;
+         }
+      }
+      return count;
+   }
+
+   TreeType mTree;
+   std::vector<osg::Vec3> mPositions;
+   std::vector<bool> mRemoved;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FlatKDTreeTests);
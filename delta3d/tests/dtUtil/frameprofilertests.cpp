@@ -0,0 +1,249 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtUtil/frameprofiler.h>
+#include <dtUtil/fileutils.h>
+#include <dtUtil/log.h>
+
+#include <osg/Timer>
+#include <OpenThreads/Atomic>
+#include <OpenThreads/Thread>
+#include <sstream>
+
+namespace
+{
+   class ProfilingThread : public OpenThreads::Thread
+   {
+   public:
+      ProfilingThread(OpenThreads::Atomic& stop)
+      : mStop(stop)
+      , mNumZones(0U)
+      {
+      }
+
+      virtual void run()
+      {
+         while (unsigned(mStop) == 0U)
+         {
+            dtUtil::ScopedProfileZone zone("Worker");
+            ++mNumZones;
+         }
+      }
+
+      OpenThreads::Atomic& mStop;
+      unsigned mNumZones;
+   };
+}
+
+class FrameProfilerTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(FrameProfilerTests);
+   CPPUNIT_TEST(TestDisabledRecordsNothing);
+   CPPUNIT_TEST(TestRingBuffer);
+   CPPUNIT_TEST(TestChromeTrace);
+   CPPUNIT_TEST(TestSpikeTrace);
+   CPPUNIT_TEST(TestClearWhileRecording);
+   CPPUNIT_TEST(TestOverhead);
+   CPPUNIT_TEST_SUITE_END();
+
+public:
+   void setUp()
+   {
+      mOldEventsPerThread = dtUtil::FrameProfiler::GetEventsPerThread();
+      mOldSpikeThreshold = dtUtil::FrameProfiler::GetSpikeThresholdMs();
+      mOldSpikeDirectory = dtUtil::FrameProfiler::GetSpikeDirectory();
+      dtUtil::FrameProfiler::SetEnabled(false);
+      dtUtil::FrameProfiler::Clear();
+   }
+
+   void tearDown()
+   {
+      dtUtil::FrameProfiler::SetEnabled(false);
+      dtUtil::FrameProfiler::SetEventsPerThread(mOldEventsPerThread);
+      dtUtil::FrameProfiler::SetSpikeThresholdMs(mOldSpikeThreshold);
+      dtUtil::FrameProfiler::SetSpikeDirectory(mOldSpikeDirectory);
+      dtUtil::FrameProfiler::Clear();
+   }
+
+   void TestDisabledRecordsNothing()
+   {
+      {
+         dtUtil::ScopedProfileZone zone("Nothing");
+      }
+      dtUtil::FrameProfiler::BeginFrame();
+      CPPUNIT_ASSERT_EQUAL(0.0, dtUtil::FrameProfiler::EndFrame());
+      CPPUNIT_ASSERT_EQUAL(0U, dtUtil::FrameProfiler::GetNumEvents());
+      CPPUNIT_ASSERT_EQUAL(0U, dtUtil::FrameProfiler::GetFrameNumber());
+   }
+
+   void TestRingBuffer()
+   {
+      dtUtil::FrameProfiler::SetEventsPerThread(8U);
+      dtUtil::FrameProfiler::Clear();
+      dtUtil::FrameProfiler::SetEnabled(true);
+
+      for (unsigned i = 0; i < 20U; ++i)
+      {
+         std::ostringstream ss;
+         ss << "Zone" << i;
+         dtUtil::ScopedProfileZone zone(ss.str());
+      }
+
+      CPPUNIT_ASSERT_EQUAL(8U, dtUtil::FrameProfiler::GetNumEvents());
+
+      std::ostringstream trace;
+      dtUtil::FrameProfiler::WriteChromeTrace(trace);
+      const std::string json = trace.str();
+      CPPUNIT_ASSERT_MESSAGE("The oldest zones should have been overwritten.", json.find("\"Zone11\"") == std::string::npos);
+      CPPUNIT_ASSERT(json.find("\"Zone12\"") != std::string::npos);
+      CPPUNIT_ASSERT(json.find("\"Zone19\"") != std::string::npos);
+      // oldest first
+      CPPUNIT_ASSERT(json.find("\"Zone12\"") < json.find("\"Zone19\""));
+   }
+
+   void TestChromeTrace()
+   {
+      dtUtil::FrameProfiler::SetEnabled(true);
+
+      const std::string longName(100, 'x');
+      {
+         dtUtil::ScopedProfileZone outer("Outer \"quoted\"");
+         dtUtil::ScopedProfileZone inner(longName);
+      }
+
+      std::ostringstream trace;
+      dtUtil::FrameProfiler::WriteChromeTrace(trace);
+      const std::string json = trace.str();
+
+      CPPUNIT_ASSERT_EQUAL(size_t(0), json.find("{\"traceEvents\":["));
+      CPPUNIT_ASSERT(json.find("\"Outer \\\"quoted\\\"\"") != std::string::npos);
+      CPPUNIT_ASSERT(json.find("\"ph\":\"X\"") != std::string::npos);
+      CPPUNIT_ASSERT_MESSAGE("Long names should be truncated.",
+               json.find("\"" + longName.substr(0, dtUtil::FrameProfiler::MAX_NAME_LENGTH) + "\"") != std::string::npos);
+
+      // A range that ends before anything was recorded should write no events.
+      std::ostringstream empty;
+      dtUtil::FrameProfiler::WriteChromeTrace(empty, 1, 1);
+      CPPUNIT_ASSERT(empty.str().find("\"ph\"") == std::string::npos);
+   }
+
+   void TestSpikeTrace()
+   {
+      dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+      dtUtil::FrameProfiler::SetSpikeDirectory(fileUtils.CurrentDirectory());
+      dtUtil::FrameProfiler::SetSpikeThresholdMs(0.5);
+      dtUtil::FrameProfiler::SetEnabled(true);
+
+      // A fast frame should not be written.
+      dtUtil::FrameProfiler::BeginFrame();
+      dtUtil::FrameProfiler::EndFrame();
+      const std::string fastFile = fileUtils.CurrentDirectory() + "/frame_1.trace.json";
+      CPPUNIT_ASSERT(!fileUtils.FileExists(fastFile));
+
+      dtUtil::FrameProfiler::BeginFrame();
+      {
+         dtUtil::ScopedProfileZone zone("SlowWork");
+         osg::Timer_t start = osg::Timer::instance()->tick();
+         while (osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick()) < 2.0) {}
+      }
+      double frameMs = dtUtil::FrameProfiler::EndFrame();
+      CPPUNIT_ASSERT(frameMs >= 2.0);
+
+      const std::string spikeFile = fileUtils.CurrentDirectory() + "/frame_2.trace.json";
+      CPPUNIT_ASSERT_MESSAGE("A frame over the threshold should be written.", fileUtils.FileExists(spikeFile));
+      fileUtils.FileDelete(spikeFile);
+   }
+
+   void TestClearWhileRecording()
+   {
+      dtUtil::FrameProfiler::SetEventsPerThread(64U);
+      dtUtil::FrameProfiler::SetEnabled(true);
+
+      OpenThreads::Atomic stop;
+      ProfilingThread worker1(stop);
+      ProfilingThread worker2(stop);
+      worker1.start();
+      worker2.start();
+
+      // Change the size each time so the workers have to reallocate their buffers while recording.
+      for (unsigned i = 0; i < 500U; ++i)
+      {
+         dtUtil::FrameProfiler::SetEventsPerThread(32U + (i % 3U) * 32U);
+         dtUtil::FrameProfiler::Clear();
+         CPPUNIT_ASSERT(dtUtil::FrameProfiler::GetNumEvents() <= 2U * 96U);
+      }
+
+      stop.exchange(1U);
+      worker1.join();
+      worker2.join();
+      CPPUNIT_ASSERT(worker1.mNumZones > 0U && worker2.mNumZones > 0U);
+
+      // Nothing is recording now, so after a clear only new zones should be held.
+      dtUtil::FrameProfiler::Clear();
+      CPPUNIT_ASSERT_EQUAL(0U, dtUtil::FrameProfiler::GetNumEvents());
+      {
+         dtUtil::ScopedProfileZone zone("Main");
+      }
+      CPPUNIT_ASSERT_EQUAL(1U, dtUtil::FrameProfiler::GetNumEvents());
+   }
+
+   void TestOverhead()
+   {
+      const unsigned numZones = 1000000U;
+      dtUtil::FrameProfiler::SetEventsPerThread(65536U);
+      dtUtil::FrameProfiler::Clear();
+
+      osg::Timer* timer = osg::Timer::instance();
+
+      osg::Timer_t start = timer->tick();
+      for (unsigned i = 0; i < numZones; ++i)
+      {
+         dtUtil::ScopedProfileZone zone("Off");
+      }
+      double offMs = timer->delta_m(start, timer->tick());
+      CPPUNIT_ASSERT_EQUAL(0U, dtUtil::FrameProfiler::GetNumEvents());
+
+      dtUtil::FrameProfiler::SetEnabled(true);
+      start = timer->tick();
+      for (unsigned i = 0; i < numZones; ++i)
+      {
+         dtUtil::ScopedProfileZone zone("On");
+      }
+      double onMs = timer->delta_m(start, timer->tick());
+      CPPUNIT_ASSERT_EQUAL(65536U, dtUtil::FrameProfiler::GetNumEvents());
+
+      std::ostringstream ss;
+      ss << numZones << " profile zones took " << offMs << "ms with the profiler off and "
+         << onMs << "ms with it on (" << (onMs * 1000000.0 / double(numZones)) << "ns per zone).";
+      LOG_ALWAYS(ss.str());
+   }
+
+private:
+   unsigned mOldEventsPerThread;
+   double mOldSpikeThreshold;
+   std::string mOldSpikeDirectory;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FrameProfilerTests);
@@ -34,6 +34,9 @@
 #include <dtUtil/logobserver.h>
 #include <dtUtil/datapathutils.h>
 #include <cppunit/extensions/HelperMacros.h>
+#include <OpenThreads/Thread>
+#include <osg/Timer>
+#include <sstream>
 
 /**
  * @class LogTests
@@ -51,6 +54,9 @@ class LogTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestOutputStream);
       CPPUNIT_TEST(TestAddingCustomLogObserver);
       CPPUNIT_TEST(TestTriggeringCustomLogObserver);
+      CPPUNIT_TEST(TestAsyncOrderAndFlush);
+      CPPUNIT_TEST(TestAsyncDuplicates);
+      CPPUNIT_TEST(TestAsyncThroughput);
    CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -84,6 +90,13 @@ class LogTests : public CPPUNIT_NS::TestFixture
 
       void TestTriggeringCustomLogObserver();
 
+      void TestAsyncOrderAndFlush();
+
+      void TestAsyncDuplicates();
+
+      /// Logs from several threads at once, synchronously then async, and logs the throughput of each.
+      void TestAsyncThroughput();
+
    private:
       std::string mMsgStr;
       std::string mSource;
@@ -114,6 +127,7 @@ void LogTests::setUp()
 ///////////////////////////////////////////////////////////////////////////////
 void LogTests::tearDown()
 {
+   dtUtil::Log::SetAsyncMode(false);
    //turn of logging when done.
    mLogger = NULL;
 }
@@ -408,3 +422,192 @@ void LogTests::TestTriggeringCustomLogObserver()
 
    Log::GetInstance().RemoveObserver(*testObserver);
 }
+
+//////////////////////////////////////////////////////////////////////////
+class RecordingObserver : public dtUtil::LogObserver
+{
+public:
+   RecordingObserver(): mFlushCount(0U)
+   {
+   }
+
+   virtual void LogMessage(const LogData& logData)
+   {
+      // Stands in for the cost of writing out a line.
+      std::ostringstream ss;
+      ss << logData.time.ToString() << logData.file << logData.line << logData.msg;
+      mMessages.push_back(logData.msg);
+   }
+
+   virtual void Flush()
+   {
+      ++mFlushCount;
+   }
+
+   std::vector<std::string> mMessages;
+   unsigned mFlushCount;
+protected:
+   virtual ~RecordingObserver() {};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+void LogTests::TestAsyncOrderAndFlush()
+{
+   using namespace dtUtil;
+
+   Log& log = Log::GetInstance("AsyncLogTest");
+   log.SetOutputStreamBit(Log::TO_OBSERVER);
+   log.SetLogLevel(Log::LOG_DEBUG);
+   dtCore::RefPtr<RecordingObserver> observer = new RecordingObserver();
+   log.AddObserver(*observer);
+
+   Log::SetAsyncMode(true);
+   CPPUNIT_ASSERT(Log::GetAsyncMode());
+
+   for (unsigned i = 0; i < 100U; ++i)
+   {
+      std::ostringstream ss;
+      ss << "Message " << i;
+      log.LogMessage(Log::LOG_INFO, __FUNCTION__, __LINE__, ss.str());
+   }
+
+   // An error is written before LogMessage returns, along with everything logged before it.
+   log.LogMessage(Log::LOG_ERROR, __FUNCTION__, __LINE__, "Error");
+   CPPUNIT_ASSERT_EQUAL(size_t(101U), observer->mMessages.size());
+   CPPUNIT_ASSERT_EQUAL(std::string("Error"), observer->mMessages.back());
+
+   Log::Flush();
+
+   CPPUNIT_ASSERT_EQUAL(size_t(101U), observer->mMessages.size());
+   for (unsigned i = 0; i < 100U; ++i)
+   {
+      std::ostringstream ss;
+      ss << "Message " << i;
+      CPPUNIT_ASSERT_EQUAL(ss.str(), observer->mMessages[i]);
+   }
+   CPPUNIT_ASSERT_MESSAGE("Observers should be flushed after each batch.", observer->mFlushCount > 0U);
+
+   Log::SetAsyncMode(false);
+   CPPUNIT_ASSERT(!Log::GetAsyncMode());
+
+   // back to synchronous
+   log.LogMessage(Log::LOG_INFO, __FUNCTION__, __LINE__, "Sync");
+   CPPUNIT_ASSERT_EQUAL(std::string("Sync"), observer->mMessages.back());
+
+   log.RemoveObserver(*observer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LogTests::TestAsyncDuplicates()
+{
+   using namespace dtUtil;
+
+   Log& log = Log::GetInstance("AsyncLogTest");
+   log.SetOutputStreamBit(Log::TO_OBSERVER);
+   log.SetLogLevel(Log::LOG_DEBUG);
+   dtCore::RefPtr<RecordingObserver> observer = new RecordingObserver();
+   log.AddObserver(*observer);
+
+   const double oldWindow = Log::GetAsyncDuplicateWindow();
+   Log::SetAsyncDuplicateWindow(60.0);
+   Log::SetAsyncMode(true);
+
+   for (unsigned i = 0; i < 50U; ++i)
+   {
+      // same line every time.
+      log.LogMessage(Log::LOG_WARNING, __FUNCTION__, __LINE__, "Mapping failed");
+   }
+   log.LogMessage(Log::LOG_WARNING, __FUNCTION__, __LINE__, "Something else");
+   Log::Flush();
+
+   CPPUNIT_ASSERT_EQUAL(size_t(2U), observer->mMessages.size());
+   CPPUNIT_ASSERT_EQUAL(std::string("Mapping failed"), observer->mMessages[0]);
+   CPPUNIT_ASSERT_EQUAL(std::string("Something else"), observer->mMessages[1]);
+
+   // Stopping writes out the count of what was suppressed.
+   Log::SetAsyncMode(false);
+   CPPUNIT_ASSERT_EQUAL(size_t(3U), observer->mMessages.size());
+   CPPUNIT_ASSERT_EQUAL(std::string("(repeated 49 more time(s)) Mapping failed"), observer->mMessages[2]);
+
+   Log::SetAsyncDuplicateWindow(oldWindow);
+   log.RemoveObserver(*observer);
+}
+
+//////////////////////////////////////////////////////////////////////////
+class LoggingThread : public OpenThreads::Thread
+{
+public:
+   LoggingThread(dtUtil::Log& log, unsigned numMessages)
+   : mLog(log)
+   , mNumMessages(numMessages)
+   {
+   }
+
+   virtual void run()
+   {
+      for (unsigned i = 0; i < mNumMessages; ++i)
+      {
+         mLog.LogMessage(dtUtil::Log::LOG_INFO, "LoggingThread", i, "Logging from a worker thread");
+      }
+   }
+
+private:
+   dtUtil::Log& mLog;
+   unsigned mNumMessages;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+void LogTests::TestAsyncThroughput()
+{
+   using namespace dtUtil;
+
+   const unsigned numThreads = 4U;
+   const unsigned numMessages = 20000U;
+
+   Log& log = Log::GetInstance("AsyncLogBenchmark");
+   log.SetOutputStreamBit(Log::TO_OBSERVER);
+   log.SetLogLevel(Log::LOG_INFO);
+   dtCore::RefPtr<RecordingObserver> observer = new RecordingObserver();
+   log.AddObserver(*observer);
+
+   const unsigned oldQueueSize = Log::GetAsyncQueueSize();
+   const double oldWindow = Log::GetAsyncDuplicateWindow();
+   // Every message is on a different line, so none are suppressed, and the queues are big enough for all of them.
+   Log::SetAsyncQueueSize(numMessages);
+
+   double times[2];
+   for (unsigned pass = 0; pass < 2U; ++pass)
+   {
+      const bool async = pass == 1U;
+      observer->mMessages.clear();
+      observer->mMessages.reserve(numThreads * numMessages);
+      Log::SetAsyncMode(async);
+
+      std::vector<LoggingThread*> threads;
+      osg::Timer_t start = osg::Timer::instance()->tick();
+      for (unsigned i = 0; i < numThreads; ++i)
+      {
+         threads.push_back(new LoggingThread(log, numMessages));
+         threads.back()->startThread();
+      }
+      for (unsigned i = 0; i < numThreads; ++i)
+      {
+         threads[i]->join();
+         delete threads[i];
+      }
+      // The time the logging threads were held up, not the time to write it all out.
+      times[pass] = osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick());
+
+      Log::SetAsyncMode(false);
+      CPPUNIT_ASSERT_EQUAL(size_t(numThreads * numMessages), observer->mMessages.size());
+   }
+
+   std::ostringstream ss;
+   ss << numThreads << " threads logging " << numMessages << " messages each took " << times[0]
+      << "ms synchronously and " << times[1] << "ms async. Dropped " << Log::GetNumDroppedMessages() << ".";
+   LOG_ALWAYS(ss.str());
+
+   Log::SetAsyncQueueSize(oldQueueSize);
+   Log::SetAsyncDuplicateWindow(oldWindow);
+   log.RemoveObserver(*observer);
+}
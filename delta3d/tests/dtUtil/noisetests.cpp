@@ -0,0 +1,169 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2015, Caper Holdings, LLC
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <dtUtil/noiseutility.h>
+#include <dtUtil/log.h>
+
+#include <osg/Timer>
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace dtUtil
+{
+   class NoiseTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(NoiseTests);
+      CPPUNIT_TEST(TestNoise2Batch);
+      CPPUNIT_TEST(TestNoise3Batch);
+      CPPUNIT_TEST(TestFBMBatch);
+      CPPUNIT_TEST(TestRange);
+      CPPUNIT_TEST(TestThroughput);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+
+      void setUp() override
+      {
+         // Straddle the origin so negative lattice cells are covered too.
+         mPoints2.clear();
+         mPoints3.clear();
+         for (int i = 0; i < 250; ++i)
+         {
+            for (int j = 0; j < 250; ++j)
+            {
+               osg::Vec2f p(float(j) * 0.137f - 17.0f, float(i) * 0.0913f - 11.0f);
+               mPoints2.push_back(p);
+               mPoints3.push_back(osg::Vec3f(p.x(), p.y(), float(i % 13) * 0.29f - 1.5f));
+            }
+         }
+      }
+
+      void TestNoise2Batch()
+      {
+         Noise2f noise;
+         std::vector<float> batch(mPoints2.size());
+         noise.GetNoiseBatch(&mPoints2[0], &batch[0], unsigned(mPoints2.size()));
+
+         for (size_t i = 0; i < mPoints2.size(); ++i)
+         {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(noise.GetNoise(mPoints2[i]), batch[i], 1e-6f);
+         }
+
+         // A count that isn't a multiple of the internal block size.
+         std::vector<float> partial(37, 99.0f);
+         noise.GetNoiseBatch(&mPoints2[5], &partial[0], 37U);
+         for (size_t i = 0; i < partial.size(); ++i)
+         {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(batch[i + 5], partial[i], 1e-6f);
+         }
+      }
+
+      void TestNoise3Batch()
+      {
+         Noise3d noise;
+         std::vector<osg::Vec3d> points(mPoints3.begin(), mPoints3.end());
+         std::vector<double> batch(points.size());
+         noise.GetNoiseBatch(&points[0], &batch[0], unsigned(points.size()));
+
+         for (size_t i = 0; i < points.size(); ++i)
+         {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(noise.GetNoise(points[i]), batch[i], 1e-12);
+         }
+      }
+
+      void TestFBMBatch()
+      {
+         Fractal2f fractal;
+         std::vector<float> batch(mPoints2.size());
+         fractal.FBMBatch(&mPoints2[0], &batch[0], unsigned(mPoints2.size()), 5, 0.5f, 0.5f, 2.0f);
+
+         for (size_t i = 0; i < mPoints2.size(); ++i)
+         {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(fractal.FBM(mPoints2[i], 5, 0.5f, 0.5f, 2.0f), batch[i], 1e-5f);
+         }
+      }
+
+      void TestRange()
+      {
+         Noise2f noise2;
+         Noise3f noise3;
+         for (size_t i = 0; i < mPoints2.size(); ++i)
+         {
+            float value2 = noise2.GetNoise(mPoints2[i]);
+            float value3 = noise3.GetNoise(mPoints3[i]);
+            CPPUNIT_ASSERT(value2 >= -2.0f && value2 <= 2.0f);
+            CPPUNIT_ASSERT(value3 >= -2.0f && value3 <= 2.0f);
+         }
+
+         // Noise is zero on the lattice points.
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0f, noise2.GetNoise(osg::Vec2f(3.0f, -4.0f)), 1e-6f);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0f, noise3.GetNoise(osg::Vec3f(3.0f, -4.0f, 7.0f)), 1e-6f);
+      }
+
+      void TestThroughput()
+      {
+         Noise2f noise;
+         std::vector<float> out(mPoints2.size());
+         const unsigned count = unsigned(mPoints2.size());
+         const int passes = 20;
+
+         osg::Timer timer;
+         osg::Timer_t start = timer.tick();
+         float sum = 0.0f;
+         for (int pass = 0; pass < passes; ++pass)
+         {
+            for (unsigned i = 0; i < count; ++i)
+            {
+               sum += noise.GetNoise(mPoints2[i]);
+            }
+         }
+         double scalarSeconds = timer.delta_s(start, timer.tick());
+
+         start = timer.tick();
+         for (int pass = 0; pass < passes; ++pass)
+         {
+            noise.GetNoiseBatch(&mPoints2[0], &out[0], count);
+            sum += out[pass];
+         }
+         double batchSeconds = timer.delta_s(start, timer.tick());
+
+         double total = double(count) * passes;
+         std::ostringstream ss;
+         ss << "Noise2f throughput: scalar " << (total / scalarSeconds) / 1e6 << " M/s, batch "
+            << (total / batchSeconds) / 1e6 << " M/s (checksum " << sum << ")";
+         LOG_ALWAYS(ss.str());
+
+         CPPUNIT_ASSERT(!dtUtil::IsNAN(sum));
+      }
+
+   private:
+      std::vector<osg::Vec2f> mPoints2;
+      std::vector<osg::Vec3f> mPoints3;
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(NoiseTests);
+}
@@ -71,6 +71,22 @@ public:
    DT_DECLARE_ACCESSOR_INLINE(bool, OkayToDelete);
 };
 
+class WorkerThreadTask : public dtUtil::ThreadPoolTask
+{
+public:
+   WorkerThreadTask()
+   : mRanOnWorker(false)
+   {
+   }
+
+   virtual void operator()()
+   {
+      mRanOnWorker = dtUtil::ThreadPool::IsWorkerThread();
+   }
+
+   bool mRanOnWorker;
+};
+
 /**
  * @class ThreadPoolTests
  * @brief Unit tests for the string utils class
@@ -79,6 +95,7 @@ class ThreadPoolTests : public CPPUNIT_NS::TestFixture {
    CPPUNIT_TEST_SUITE(ThreadPoolTests);
    CPPUNIT_TEST(TestImmediateTasks);
    CPPUNIT_TEST(TestBackgroundTasksWithBlock);
+   CPPUNIT_TEST(TestIsWorkerThread);
    CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -144,6 +161,16 @@ class ThreadPoolTests : public CPPUNIT_NS::TestFixture {
       }
    }
 
+   void TestIsWorkerThread()
+   {
+      CPPUNIT_ASSERT(!dtUtil::ThreadPool::IsWorkerThread());
+
+      dtCore::RefPtr<WorkerThreadTask> task = new WorkerThreadTask;
+      dtUtil::ThreadPool::AddTask(*task, dtUtil::ThreadPool::BACKGROUND);
+      CPPUNIT_ASSERT(task->WaitUntilComplete(1000));
+      CPPUNIT_ASSERT(task->mRanOnWorker);
+   }
+
    private:
       unsigned mOldNumImmediateWorkerThreads;
 };
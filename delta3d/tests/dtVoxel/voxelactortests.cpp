@@ -44,6 +44,7 @@ namespace dtVoxel
          CPPUNIT_TEST(testVoxelActor);
          CPPUNIT_TEST(testVoxelActorRemoteUpdate);
          CPPUNIT_TEST(testVolumeUpdateMessageToFromStream);
+         CPPUNIT_TEST(testVolumeUpdateBricks);
          CPPUNIT_TEST(testVoxelColliderAABB);
 
       CPPUNIT_TEST_SUITE_END();
@@ -210,6 +211,102 @@ namespace dtVoxel
           }
        }
 
+      void testVolumeUpdateBricks()
+      {
+          try
+          {
+             dtCore::RefPtr<dtVoxel::VoxelActor> voxelActor;
+             mGM->CreateActor(*VoxelActorRegistry::VOXEL_ACTOR_TYPE, voxelActor);
+             voxelActor->SetDatabase(dtCore::ResourceDescriptor("Volumes:delta3d_island.vdb"));
+             voxelActor->CompleteLoad();
+             mGM->AddActor(*voxelActor, false, false);
+             openvdb::BoolGrid::Ptr grid = boost::dynamic_pointer_cast<openvdb::BoolGrid>(voxelActor->GetGrid(0));
+             CPPUNIT_ASSERT(grid);
+
+             dtCore::RefPtr<VolumeUpdateMessage> perVoxelMsg, brickMsg, brickResult;
+             mGM->GetMessageFactory().CreateMessage(VoxelMessageType::INFO_VOLUME_CHANGED, perVoxelMsg);
+             mGM->GetMessageFactory().CreateMessage(VoxelMessageType::INFO_VOLUME_CHANGED, brickMsg);
+             mGM->GetMessageFactory().CreateMessage(VoxelMessageType::INFO_VOLUME_CHANGED, brickResult);
+
+             // A crater, carved out of a spot, with a raised rim, crossing brick boundaries.
+             const openvdb::Coord center(3, 5, 20);
+             const int radius = 6;
+             VolumeBrickBuilder builder;
+             std::vector<openvdb::Coord> carved, raised;
+             for (int i = -radius - 1; i <= radius + 1; ++i)
+             {
+                for (int j = -radius - 1; j <= radius + 1; ++j)
+                {
+                   for (int k = -radius - 1; k <= radius + 1; ++k)
+                   {
+                      int distSqr = i * i + j * j + k * k;
+                      openvdb::Coord voxel = center + openvdb::Coord(i, j, k);
+                      osg::Vec3 idx(voxel.x(), voxel.y(), voxel.z());
+                      if (distSqr <= radius * radius)
+                      {
+                         carved.push_back(voxel);
+                         builder.SetValueOff(voxel);
+                         perVoxelMsg->AddDeactivatedIndex(idx);
+                      }
+                      else if (distSqr <= (radius + 1) * (radius + 1))
+                      {
+                         raised.push_back(voxel);
+                         builder.SetValueOn(voxel, 1.0f);
+                         perVoxelMsg->AddChangedValue<bool>(idx, true);
+                      }
+                   }
+                }
+             }
+             CPPUNIT_ASSERT(!builder.IsEmpty());
+             builder.AddTo(*brickMsg);
+             CPPUNIT_ASSERT(builder.IsEmpty());
+             CPPUNIT_ASSERT(brickMsg->GetNumBricks() > 1U);
+             CPPUNIT_ASSERT_EQUAL(size_t(0U), brickMsg->GetIndicesChanged()->GetSize());
+
+             dtUtil::DataStream perVoxelDs, brickDs;
+             perVoxelMsg->ToDataStream(perVoxelDs);
+             brickMsg->ToDataStream(brickDs);
+             std::ostringstream ss;
+             ss << "The bricks should be much smaller on the wire: " << brickDs.GetBufferSize() << " vs " << perVoxelDs.GetBufferSize();
+             CPPUNIT_ASSERT_MESSAGE(ss.str(), brickDs.GetBufferSize() * 4U < perVoxelDs.GetBufferSize());
+
+             CPPUNIT_ASSERT(brickResult->FromDataStream(brickDs));
+             CPPUNIT_ASSERT_EQUAL(brickMsg->GetNumBricks(), brickResult->GetNumBricks());
+
+             size_t numOn = 0, numOff = 0;
+             CPPUNIT_ASSERT(brickResult->ForEachBrickVoxel([&](const openvdb::Coord&, bool active, float value)
+             {
+                if (active)
+                {
+                   ++numOn;
+                   CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0f, value, 0.001f);
+                }
+                else
+                {
+                   ++numOff;
+                }
+             }));
+             CPPUNIT_ASSERT_EQUAL(raised.size(), numOn);
+             CPPUNIT_ASSERT_EQUAL(carved.size(), numOff);
+
+             voxelActor->UpdateVolume(*brickResult, false);
+
+             openvdb::BoolGrid::Accessor accessor = grid->getAccessor();
+             for (size_t i = 0; i < carved.size(); ++i)
+             {
+                CPPUNIT_ASSERT(!accessor.isValueOn(carved[i]));
+             }
+             for (size_t i = 0; i < raised.size(); ++i)
+             {
+                CPPUNIT_ASSERT(accessor.isValueOn(raised[i]));
+                CPPUNIT_ASSERT(accessor.getValue(raised[i]));
+             }
+          }
+          catch(const dtUtil::Exception& ex)
+          {
+             CPPUNIT_FAIL(ex.ToString());
+          }
+      }
 
       void testVoxelColliderAABB()
       {
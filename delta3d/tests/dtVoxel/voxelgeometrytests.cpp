@@ -20,12 +20,14 @@
 #include <dtVoxel/voxelgeometry.h>
 #include <dtVoxel/voxelactor.h>
 #include <dtVoxel/voxelactorregistry.h>
+#include <dtVoxel/voxelmessagetype.h>
 #include "../dtPhysics/basedtphysicstestfixture.h"
 #include <dtPhysics/physicsobject.h>
 #include <openvdb/openvdb.h>
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range2d.h>
 #include <dtCore/system.h>
+#include <dtUtil/mathdefines.h>
 
 namespace dtVoxel
 {
@@ -38,6 +40,7 @@ namespace dtVoxel
          CPPUNIT_TEST(testVoxelGeometry);
          CPPUNIT_TEST(testVoxelActorGeometryCreation);
          CPPUNIT_TEST(testVoxelActorGeometryCreateRemote);
+         CPPUNIT_TEST(testIncrementalCollisionRebuild);
 
       CPPUNIT_TEST_SUITE_END();
 
@@ -214,6 +217,129 @@ namespace dtVoxel
             CPPUNIT_FAIL(ex.ToString());
          }
       }
+
+      /// Calls GetBlock on every block that overlaps the box so the cache is full for it.
+      void FillCollisionCache(VoxelCollisionCache& cache, const openvdb::CoordBBox& box)
+      {
+         const int blockDim = VoxelCollisionCache::BLOCK_DIM;
+         openvdb::Coord first = VoxelCollisionCache::GetBlockOrigin(box.min());
+         openvdb::Coord last = VoxelCollisionCache::GetBlockOrigin(box.max());
+         for (int i = first.x(); i <= last.x(); i += blockDim)
+            for (int j = first.y(); j <= last.y(); j += blockDim)
+               for (int k = first.z(); k <= last.z(); k += blockDim)
+                  cache.GetBlock(openvdb::Coord(i, j, k));
+      }
+
+      void testIncrementalCollisionRebuild()
+      {
+         ChangeEngine(GetPhysicsEngineList()[0]);
+         try
+         {
+            VoxelActorPtr voxelActor;
+            mGM->CreateActor(*VoxelActorRegistry::VOXEL_ACTOR_TYPE, voxelActor);
+            voxelActor->SetDatabase(dtCore::ResourceDescriptor("Volumes:delta3d_island.vdb"));
+            voxelActor->CompleteLoad();
+
+            dtPhysics::PhysicsActCompPtr pac = new dtPhysics::PhysicsActComp;
+            voxelActor->AddComponent(*pac);
+            dtPhysics::PhysicsObjectPtr po = dtPhysics::PhysicsObject::CreateNew("TestVoxel");
+            po->SetPrimitiveType(dtPhysics::PrimitiveType::CUSTOM_CONCAVE_MESH);
+            po->SetMechanicsType(dtPhysics::MechanicsType::STATIC);
+            pac->AddPhysicsObject(*po);
+
+            mGM->AddActor(*voxelActor, false, false);
+
+            openvdb::BoolGrid::Ptr grid = boost::dynamic_pointer_cast<openvdb::BoolGrid>(voxelActor->GetGrid(0));
+            CPPUNIT_ASSERT(grid);
+            VoxelCollisionCache* incremental = voxelActor->GetCollisionCache();
+            CPPUNIT_ASSERT_MESSAGE("Creating the voxel physics should create the collision cache.", incremental != NULL);
+
+            const int maxRadius = 4;
+            const openvdb::CoordBBox editCenters(openvdb::Coord(-24, -24, -8), openvdb::Coord(24, 24, 40));
+            openvdb::CoordBBox region = editCenters;
+            region.expand(maxRadius + VoxelCollisionCache::BLOCK_DIM);
+            FillCollisionCache(*incremental, region);
+
+            const unsigned regionBlocks = incremental->GetNumCachedBlocks();
+            const unsigned builtBeforeEdits = incremental->GetNumBlocksBuilt();
+            const unsigned numEdits = 1000U;
+
+            srand(47);
+            for (unsigned edit = 0; edit < numEdits; ++edit)
+            {
+               openvdb::Coord center(dtUtil::RandRange(editCenters.min().x(), editCenters.max().x()),
+                        dtUtil::RandRange(editCenters.min().y(), editCenters.max().y()),
+                        dtUtil::RandRange(editCenters.min().z(), editCenters.max().z()));
+               int radius = dtUtil::RandRange(1, maxRadius);
+               bool carve = (edit % 2) == 0;
+
+               VolumeBrickBuilder builder;
+               for (int i = -radius; i <= radius; ++i)
+               {
+                  for (int j = -radius; j <= radius; ++j)
+                  {
+                     for (int k = -radius; k <= radius; ++k)
+                     {
+                        if (i * i + j * j + k * k > radius * radius)
+                           continue;
+                        openvdb::Coord voxel = center + openvdb::Coord(i, j, k);
+                        if (carve)
+                           builder.SetValueOff(voxel);
+                        else
+                           builder.SetValueOn(voxel, 1.0f);
+                     }
+                  }
+               }
+
+               dtCore::RefPtr<VolumeUpdateMessage> msg;
+               mGM->GetMessageFactory().CreateMessage(VoxelMessageType::INFO_VOLUME_CHANGED, msg);
+               builder.AddTo(*msg);
+               voxelActor->UpdateVolume(*msg, false);
+
+               // Rebuild what the edit dropped so a block that should have been dropped, but wasn't, stays stale.
+               openvdb::CoordBBox sphereBox(center, center);
+               sphereBox.expand(radius + VoxelCollisionCache::BLOCK_DIM);
+               FillCollisionCache(*incremental, sphereBox);
+            }
+
+            unsigned incrementalBuilds = incremental->GetNumBlocksBuilt() - builtBeforeEdits;
+            std::ostringstream ss;
+            ss << "The edits should only rebuild the blocks they touch, rebuilt " << incrementalBuilds << " blocks for " << numEdits << " edits.";
+            CPPUNIT_ASSERT_MESSAGE(ss.str(), incrementalBuilds > 0U && incrementalBuilds < numEdits * regionBlocks / 10U);
+
+            dtCore::RefPtr<VoxelCollisionCache> full = new VoxelGridCollisionCache<openvdb::BoolGrid>(grid,
+                     incremental->GetPartIdScale(), incremental->GetTesselationMode());
+            const int blockDim = VoxelCollisionCache::BLOCK_DIM;
+            openvdb::Coord first = VoxelCollisionCache::GetBlockOrigin(region.min());
+            openvdb::Coord last = VoxelCollisionCache::GetBlockOrigin(region.max());
+            size_t numTriangles = 0;
+            for (int i = first.x(); i <= last.x(); i += blockDim)
+            {
+               for (int j = first.y(); j <= last.y(); j += blockDim)
+               {
+                  for (int k = first.z(); k <= last.z(); k += blockDim)
+                  {
+                     openvdb::Coord origin(i, j, k);
+                     VoxelCollisionCache::BlockPtr incrementalBlock = incremental->GetBlock(origin);
+                     VoxelCollisionCache::BlockPtr fullBlock = full->GetBlock(origin);
+                     ss.str("");
+                     ss << "The incremental and full collision triangles should match for the block at " << origin;
+                     CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), fullBlock->mTriangles.size(), incrementalBlock->mTriangles.size());
+                     CPPUNIT_ASSERT_MESSAGE(ss.str(), fullBlock->mTriangles == incrementalBlock->mTriangles);
+                     numTriangles += fullBlock->mTriangles.size();
+                  }
+               }
+            }
+            CPPUNIT_ASSERT_MESSAGE("The edits should leave some surface to collide with.", numTriangles > 0U);
+
+            mGM->DeleteActor(*voxelActor);
+            dtCore::System::GetInstance().Step(0.016f);
+         }
+         catch (const dtUtil::Exception& ex)
+         {
+            CPPUNIT_FAIL(ex.ToString());
+         }
+      }
    };
 
 
@@ -0,0 +1,566 @@
+/* -*-c++-*-
+ * GMBenchmark - Using 'The MIT License'
+ * Copyright (C) 2015, Caper Holdings LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+///Headless benchmark of the GameManager core loop.  It runs a GameManager on a scene with no window or
+///application, times each phase, counts the allocations, and prints the results as JSON so they can be
+///compared between builds.
+/// Examples
+///     GMBenchmark
+///            runs the default sizes and prints the results.
+///     GMBenchmark --actors 5000 --messages 10000 --output results.json
+///            runs larger sizes and writes the results to a file.
+
+////////////////////////////////////////////////////////////////////////////////
+// INCLUDE DIRECTIVES
+////////////////////////////////////////////////////////////////////////////////
+// OSG
+#include <osg/ArgumentParser>
+#include <OpenThreads/Atomic>
+// DELTA3D
+#include <dtActors/engineactorregistry.h>
+#include <dtCore/scene.h>
+#include <dtCore/system.h>
+#include <dtCore/timer.h>
+#include <dtGame/actorupdatemessage.h>
+#include <dtGame/basemessages.h>
+#include <dtGame/deadreckoningcomponent.h>
+#include <dtGame/deadreckoninghelper.h>
+#include <dtGame/gameactorproxy.h>
+#include <dtGame/gamemanager.h>
+#include <dtGame/gmcomponent.h>
+#include <dtGame/messagefactory.h>
+#include <dtGame/messagetype.h>
+#include <dtUtil/datastream.h>
+#include <dtUtil/functor.h>
+#include <dtUtil/log.h>
+#include <dtUtil/mathdefines.h>
+// STL
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// ALLOCATION COUNTING
+////////////////////////////////////////////////////////////////////////////////
+// Every allocation through the global operator new is counted.  On Windows each DLL has its own CRT,
+// so there the count only covers the allocations made by code inlined into this executable.
+static OpenThreads::Atomic gAllocationCount;
+
+void* operator new(std::size_t size)
+{
+   ++gAllocationCount;
+   void* result = std::malloc(size == 0 ? 1 : size);
+   if (result == NULL)
+   {
+      throw std::bad_alloc();
+   }
+   return result;
+}
+
+void* operator new[](std::size_t size)
+{
+   return operator new(size);
+}
+
+void operator delete(void* ptr) throw()
+{
+   std::free(ptr);
+}
+
+void operator delete[](void* ptr) throw()
+{
+   std::free(ptr);
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// HELPER CLASSES
+////////////////////////////////////////////////////////////////////////////////
+struct BenchmarkConfig
+{
+   BenchmarkConfig()
+   : mActors(1000)
+   , mComponents(4)
+   , mMessages(1000)
+   , mFrames(100)
+   , mTimers(1000)
+   {
+   }
+
+   unsigned mActors;
+   unsigned mComponents;
+   unsigned mMessages;
+   unsigned mFrames;
+   unsigned mTimers;
+};
+
+struct PhaseResult
+{
+   std::string mName;
+   /// What the phase did per iteration, such as an actor or a frame.
+   unsigned mIterations;
+   /// The messages, timer firings, or bytes the phase produced, to check that it did the expected work.
+   unsigned mOperations;
+   unsigned long long mNanoseconds;
+   unsigned mAllocations;
+};
+
+/// Times a phase and counts the allocations made during it.
+class PhaseTimer
+{
+public:
+   PhaseTimer()
+   : mStart(mTimer.Tick())
+   , mStartAllocations(gAllocationCount)
+   {
+   }
+
+   PhaseResult Stop(const std::string& name, unsigned iterations, unsigned operations) const
+   {
+      dtCore::Timer_t end = mTimer.Tick();
+      unsigned allocations = unsigned(gAllocationCount) - mStartAllocations;
+
+      PhaseResult result;
+      result.mName = name;
+      result.mIterations = iterations;
+      result.mOperations = operations;
+      result.mNanoseconds = (unsigned long long)(mTimer.DeltaNano(mStart, end));
+      result.mAllocations = allocations;
+      return result;
+   }
+
+private:
+   dtCore::Timer mTimer;
+   dtCore::Timer_t mStart;
+   unsigned mStartAllocations;
+};
+
+/// A component that does nothing but count the messages of one type, so the fan out includes component dispatch.
+class BenchmarkComponent : public dtGame::GMComponent
+{
+public:
+   BenchmarkComponent(const std::string& name)
+   : dtGame::GMComponent(name)
+   , mCountedType(NULL)
+   , mCount(0)
+   {
+   }
+
+   void ProcessMessage(const dtGame::Message& message) override
+   {
+      if (&message.GetMessageType() == mCountedType)
+      {
+         ++mCount;
+      }
+   }
+
+   const dtGame::MessageType* mCountedType;
+   unsigned mCount;
+
+protected:
+   ~BenchmarkComponent() {}
+};
+
+/// The target of the invokables the benchmark registers on the actors.
+class MessageCounter
+{
+public:
+   MessageCounter() : mCount(0) {}
+
+   void OnMessage(const dtGame::Message&)
+   {
+      ++mCount;
+   }
+
+   unsigned mCount;
+};
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// BENCHMARK
+////////////////////////////////////////////////////////////////////////////////
+class GMBenchmark
+{
+public:
+   typedef std::vector<dtCore::RefPtr<dtGame::GameActorProxy> > ActorVector;
+
+   GMBenchmark(const BenchmarkConfig& config)
+   : mConfig(config)
+   {
+      dtCore::System::GetInstance().SetShutdownOnWindowClose(false);
+      dtCore::System::GetInstance().Start();
+
+      mScene = new dtCore::Scene();
+      mGM = new dtGame::GameManager(*mScene);
+
+      for (unsigned i = 0; i < mConfig.mComponents; ++i)
+      {
+         std::ostringstream name;
+         name << "BenchmarkComponent" << i;
+         dtCore::RefPtr<BenchmarkComponent> component = new BenchmarkComponent(name.str());
+         mGM->AddComponent(*component, dtGame::GameManager::ComponentPriority::NORMAL);
+         mComponents.push_back(component);
+      }
+
+      mGM->AddComponent(*new dtGame::DeadReckoningComponent(), dtGame::GameManager::ComponentPriority::NORMAL);
+
+      // Let the GM finish starting up so it isn't counted in the first phase.
+      Step(1);
+   }
+
+   ~GMBenchmark()
+   {
+      mGM->DeleteAllActors(true);
+      mGM->Shutdown();
+      mGM = NULL;
+      mScene = NULL;
+      dtCore::System::GetInstance().Stop();
+   }
+
+   void Run()
+   {
+      BenchmarkActorCreateAndDelete();
+      BenchmarkGlobalFanOut();
+      BenchmarkPerActorFanOut();
+      BenchmarkDeadReckoning();
+      BenchmarkTimers();
+      BenchmarkActorUpdateSerialization();
+   }
+
+   void WriteJSON(std::ostream& out) const
+   {
+      out << "{\n";
+      out << "  \"benchmark\": \"GMBenchmark\",\n";
+      out << "  \"config\": {\"actors\": " << mConfig.mActors
+          << ", \"components\": " << mConfig.mComponents
+          << ", \"messages\": " << mConfig.mMessages
+          << ", \"frames\": " << mConfig.mFrames
+          << ", \"timers\": " << mConfig.mTimers << "},\n";
+      out << "  \"phases\": [\n";
+      for (size_t i = 0; i < mResults.size(); ++i)
+      {
+         const PhaseResult& result = mResults[i];
+         unsigned long long perIteration = result.mIterations > 0 ? result.mNanoseconds / result.mIterations : 0ULL;
+         out << "    {\"name\": \"" << result.mName << "\""
+             << ", \"iterations\": " << result.mIterations
+             << ", \"operations\": " << result.mOperations
+             << ", \"nanoseconds\": " << result.mNanoseconds
+             << ", \"nanoseconds_per_iteration\": " << perIteration
+             << ", \"allocations\": " << result.mAllocations
+             << "}" << (i + 1 < mResults.size() ? "," : "") << "\n";
+      }
+      out << "  ]\n";
+      out << "}\n";
+   }
+
+private:
+   void Step(unsigned frames)
+   {
+      for (unsigned i = 0; i < frames; ++i)
+      {
+         dtCore::System::GetInstance().Step(0.016f);
+      }
+   }
+
+   void CreateActors(unsigned count, bool remote, ActorVector& actors)
+   {
+      actors.reserve(actors.size() + count);
+      for (unsigned i = 0; i < count; ++i)
+      {
+         dtCore::RefPtr<dtGame::GameActorProxy> actor;
+         mGM->CreateActor(*dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE, actor);
+         if (remote)
+         {
+            actor->AddComponent(*new dtGame::DeadReckoningActorComponent());
+         }
+         mGM->AddActor(*actor, remote, false);
+         actors.push_back(actor);
+      }
+   }
+
+   void DeleteActors(ActorVector& actors)
+   {
+      for (ActorVector::iterator i = actors.begin(), iend = actors.end(); i != iend; ++i)
+      {
+         mGM->DeleteActor(**i);
+      }
+      actors.clear();
+      // Actors are removed at the end of the frame.
+      Step(1);
+   }
+
+   void CountComponentMessages(const dtGame::MessageType* type)
+   {
+      for (size_t i = 0; i < mComponents.size(); ++i)
+      {
+         mComponents[i]->mCountedType = type;
+         mComponents[i]->mCount = 0;
+      }
+   }
+
+   unsigned GetComponentMessageCount() const
+   {
+      unsigned count = 0;
+      for (size_t i = 0; i < mComponents.size(); ++i)
+      {
+         count += mComponents[i]->mCount;
+      }
+      return count;
+   }
+
+   void BenchmarkActorCreateAndDelete()
+   {
+      ActorVector actors;
+      {
+         PhaseTimer timer;
+         CreateActors(mConfig.mActors, false, actors);
+         mResults.push_back(timer.Stop("actor_create", mConfig.mActors, unsigned(mGM->GetNumGameActors())));
+      }
+      {
+         PhaseTimer timer;
+         DeleteActors(actors);
+         mResults.push_back(timer.Stop("actor_delete", mConfig.mActors, mConfig.mActors - unsigned(mGM->GetNumGameActors())));
+      }
+   }
+
+   /// Sends game events that every actor gets through a global invokable.
+   void BenchmarkGlobalFanOut()
+   {
+      ActorVector actors;
+      CreateActors(mConfig.mActors, false, actors);
+      MessageCounter counter;
+      for (ActorVector::iterator i = actors.begin(), iend = actors.end(); i != iend; ++i)
+      {
+         (*i)->RegisterForMessages(dtGame::MessageType::INFO_GAME_EVENT, dtUtil::MakeFunctor(&MessageCounter::OnMessage, &counter));
+      }
+      CountComponentMessages(&dtGame::MessageType::INFO_GAME_EVENT);
+
+      PhaseTimer timer;
+      for (unsigned i = 0; i < mConfig.mMessages; ++i)
+      {
+         dtCore::RefPtr<dtGame::Message> msg = mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_GAME_EVENT);
+         mGM->SendMessage(*msg);
+      }
+      Step(1);
+      mResults.push_back(timer.Stop("message_fanout_global", mConfig.mMessages, counter.mCount + GetComponentMessageCount()));
+
+      DeleteActors(actors);
+   }
+
+   /// Sends game events about each actor in turn, which only that actor gets through its invokable.
+   void BenchmarkPerActorFanOut()
+   {
+      ActorVector actors;
+      CreateActors(mConfig.mActors, false, actors);
+      MessageCounter counter;
+      for (ActorVector::iterator i = actors.begin(), iend = actors.end(); i != iend; ++i)
+      {
+         (*i)->RegisterForMessagesAboutSelf(dtGame::MessageType::INFO_GAME_EVENT, dtUtil::MakeFunctor(&MessageCounter::OnMessage, &counter));
+      }
+      CountComponentMessages(&dtGame::MessageType::INFO_GAME_EVENT);
+
+      PhaseTimer timer;
+      for (unsigned i = 0; i < mConfig.mMessages; ++i)
+      {
+         dtCore::RefPtr<dtGame::Message> msg = mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_GAME_EVENT);
+         if (!actors.empty())
+         {
+            msg->SetAboutActorId(actors[i % actors.size()]->GetId());
+         }
+         mGM->SendMessage(*msg);
+      }
+      Step(1);
+      mResults.push_back(timer.Stop("message_fanout_per_actor", mConfig.mMessages, counter.mCount + GetComponentMessageCount()));
+
+      DeleteActors(actors);
+   }
+
+   void BenchmarkDeadReckoning()
+   {
+      ActorVector actors;
+      CreateActors(mConfig.mActors, true, actors);
+      for (unsigned i = 0; i < actors.size(); ++i)
+      {
+         dtGame::DeadReckoningActorComponent* drac = NULL;
+         actors[i]->GetComponent(drac);
+         drac->SetDeadReckoningAlgorithm(dtGame::DeadReckoningAlgorithm::VELOCITY_AND_ACCELERATION);
+         drac->SetLastKnownTranslation(osg::Vec3(float(i), 0.0f, 0.0f));
+         drac->SetLastKnownVelocity(osg::Vec3(1.0f, 2.0f, 0.0f));
+         drac->SetLastKnownAcceleration(osg::Vec3(0.0f, 0.0f, -1.0f));
+         drac->SetLastKnownAngularVelocity(osg::Vec3(0.0f, 0.0f, 0.5f));
+      }
+
+      PhaseTimer timer;
+      Step(mConfig.mFrames);
+      mResults.push_back(timer.Stop("dead_reckoning", mConfig.mFrames, mConfig.mFrames * unsigned(actors.size())));
+
+      DeleteActors(actors);
+   }
+
+   void BenchmarkTimers()
+   {
+      for (unsigned i = 0; i < mConfig.mTimers; ++i)
+      {
+         std::ostringstream name;
+         name << "BenchmarkTimer" << i;
+         // Spread the timers out so some fire each frame.
+         float interval = 0.016f * float(1 + i % 8);
+         mGM->SetTimer(name.str(), NULL, interval, true);
+      }
+      CountComponentMessages(&dtGame::MessageType::INFO_TIMER_ELAPSED);
+
+      PhaseTimer timer;
+      Step(mConfig.mFrames);
+      mResults.push_back(timer.Stop("timers", mConfig.mFrames, GetComponentMessageCount() / dtUtil::Max(1U, mConfig.mComponents)));
+
+      for (unsigned i = 0; i < mConfig.mTimers; ++i)
+      {
+         std::ostringstream name;
+         name << "BenchmarkTimer" << i;
+         mGM->ClearTimer(name.str(), NULL);
+      }
+   }
+
+   void BenchmarkActorUpdateSerialization()
+   {
+      ActorVector actors;
+      CreateActors(mConfig.mActors, false, actors);
+
+      dtUtil::DataStream stream;
+      {
+         PhaseTimer timer;
+         for (ActorVector::iterator i = actors.begin(), iend = actors.end(); i != iend; ++i)
+         {
+            dtCore::RefPtr<dtGame::ActorUpdateMessage> update;
+            mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, update);
+            (*i)->PopulateActorUpdate(*update);
+            update->ToDataStream(stream);
+         }
+         mResults.push_back(timer.Stop("actor_update_serialize", unsigned(actors.size()), stream.GetBufferSize()));
+      }
+
+      {
+         PhaseTimer timer;
+         unsigned numRead = 0;
+         for (size_t i = 0; i < actors.size(); ++i)
+         {
+            dtCore::RefPtr<dtGame::ActorUpdateMessage> update;
+            mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, update);
+            if (update->FromDataStream(stream))
+            {
+               ++numRead;
+            }
+         }
+         mResults.push_back(timer.Stop("actor_update_deserialize", unsigned(actors.size()), numRead));
+      }
+
+      DeleteActors(actors);
+   }
+
+   BenchmarkConfig mConfig;
+   dtCore::RefPtr<dtCore::Scene> mScene;
+   dtCore::RefPtr<dtGame::GameManager> mGM;
+   std::vector<dtCore::RefPtr<BenchmarkComponent> > mComponents;
+   std::vector<PhaseResult> mResults;
+};
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MAIN
+////////////////////////////////////////////////////////////////////////////////
+void usage(const std::string& progName)
+{
+   std::cout << "usage: " << progName
+             << " [--actors N] [--components N] [--messages N] [--frames N] [--timers N] [--output file.json]" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+   osg::ArgumentParser parser(&argc, argv);
+
+   if (parser.read("-h") || parser.read("--help") || parser.read("-?") || parser.read("--?"))
+   {
+      usage(parser.getApplicationName());
+      return 0;
+   }
+
+   BenchmarkConfig config;
+   parser.read("--actors", config.mActors);
+   parser.read("--components", config.mComponents);
+   parser.read("--messages", config.mMessages);
+   parser.read("--frames", config.mFrames);
+   parser.read("--timers", config.mTimers);
+
+   std::string outputFile;
+   parser.read("--output", outputFile);
+
+   parser.reportRemainingOptionsAsUnrecognized();
+   if (parser.errors())
+   {
+      parser.writeErrorMessages(std::cerr);
+      usage(parser.getApplicationName());
+      return 1;
+   }
+
+   // Logging would be timed along with everything else.
+   dtUtil::Log::SetAllLogLevels(dtUtil::Log::LOG_ERROR);
+
+   std::ostringstream results;
+   try
+   {
+      GMBenchmark benchmark(config);
+      benchmark.Run();
+      benchmark.WriteJSON(results);
+   }
+   catch (const dtUtil::Exception& ex)
+   {
+      std::cerr << ex.ToString() << std::endl;
+      return 1;
+   }
+
+   if (outputFile.empty())
+   {
+      std::cout << results.str();
+   }
+   else
+   {
+      std::ofstream out(outputFile.c_str());
+      if (!out)
+      {
+         std::cerr << "Unable to open " << outputFile << " for writing." << std::endl;
+         return 1;
+      }
+      out << results.str();
+   }
+
+   return 0;
+}
@@ -32,6 +32,7 @@
 #include <dtCore/scene.h>
 #include <dtCore/system.h>
 #include <dtGame/gamemanager.h>
+#include <dtPhysics/cookedmeshcache.h>
 #include <dtPhysics/palphysicsworld.h>
 #include <dtPhysics/physicscompiler.h>
 #include <dtPhysics/physicscomponent.h>
@@ -256,6 +257,26 @@ void CompileAndWritePhysicsFiles(osg::Node& node, dtPhysics::PhysicsCompileOptio
 }
 
 
+////////////////////////////////////////////////////////////////
+void CookRuntimeMeshCache(const std::string& filename, const std::string& cacheDirectory)
+{
+   using namespace dtPhysics;
+
+   CookedMeshCache::SetDirectory(cacheDirectory);
+
+   // Fill both entries physics objects may look for, the triangle mesh and the convex hull.
+   for (int polytope = 0; polytope < 2; ++polytope)
+   {
+      dtCore::RefPtr<VertexData> data = new VertexData;
+      if (!CookedMeshCache::LoadFile(filename, polytope == 1, *data))
+      {
+         LOG_ERROR("Could not cook the physics mesh for file: " + filename);
+         return;
+      }
+   }
+}
+
+
 osg::Node* loadFile(const std::string& filename)
 {
    dtCore::RefPtr<osgDB::ReaderWriter::Options> options = new osgDB::ReaderWriter::Options;
@@ -294,6 +315,7 @@ int main(int argc, char** argv)
    parser.getApplicationUsage()->addCommandLineOption("--filePrefix", "The prefix to use for each file saved out, the prefix will be followed directly by the material name.");
    parser.getApplicationUsage()->addCommandLineOption("--maxTianglesPerMesh", "The number of triangles we try to put into each output file: default 300000.");
    parser.getApplicationUsage()->addCommandLineOption("--maxTriangleEdgeLength", "The maximum length of a triangle edge before it subdivides the triangle.  This helps physics stability: default 20.");
+   parser.getApplicationUsage()->addCommandLineOption("--cookedMeshCacheDirectory", "Also cooks the model into this runtime mesh cache directory, which should match dtPhysics.CookedMeshCacheDirectory in the application config.");
 
    dtPhysics::PhysicsCompileOptions options;
 
@@ -376,8 +398,16 @@ int main(int argc, char** argv)
 
    parser.read("--maxTriangleEdgeLength", options.mMaxEdgeLength);
 
+   std::string cookedMeshCacheDirectory;
+   parser.read("--cookedMeshCacheDirectory", cookedMeshCacheDirectory);
+
    osg::Node* ourNode = loadFile(parser[1]);
    CompileAndWritePhysicsFiles(*ourNode, options);
 
+   if (!cookedMeshCacheDirectory.empty())
+   {
+      CookRuntimeMeshCache(parser[1], cookedMeshCacheDirectory);
+   }
+
    return 0;
 }